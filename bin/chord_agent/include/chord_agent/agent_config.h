@@ -26,9 +26,16 @@ namespace chord_agent {
         bool temporarySession;
         absl::Duration idleTimeout;
         absl::Duration registrationTimeout;
+        tu_uint32 machinePoolSize;
+        absl::Duration machinePoolMaxIdleAge;
         std::filesystem::path logFile;
         std::filesystem::path pidFile;
         std::filesystem::path endpointFile;
+        std::filesystem::path readyFifo;
+        std::filesystem::path machineLogDirectory;
+        tu_uint32 machineLogRate;
+        std::filesystem::path assemblyStoreDirectory;
+        tu_uint64 assemblyStoreSize;
     };
 
     tempo_utils::Status configure_agent(const tempo_command::CommandConfig &commandConfig, AgentConfig &agentConfig);
@@ -1,6 +1,8 @@
 #ifndef CHORD_AGENT_AGENT_SERVICE_H
 #define CHORD_AGENT_AGENT_SERVICE_H
 
+#include <atomic>
+
 #include <chord_invoke/invoke_service.grpc.pb.h>
 
 #include "agent_config.h"
@@ -27,6 +29,12 @@ namespace chord_agent {
             const chord_invoke::CreateMachineRequest *request,
             chord_invoke::CreateMachineResult *response) override;
 
+        grpc::ServerUnaryReactor *
+        CreateMachineBatch(
+            grpc::CallbackServerContext *context,
+            const chord_invoke::CreateMachineBatchRequest *request,
+            chord_invoke::CreateMachineBatchResult *response) override;
+
         grpc::ServerUnaryReactor *
         SignCertificates(
             grpc::CallbackServerContext *context,
@@ -39,6 +47,12 @@ namespace chord_agent {
             const chord_invoke::RunMachineRequest *request,
             chord_invoke::RunMachineResult *response) override;
 
+        grpc::ServerUnaryReactor *
+        RunMachineBatch(
+            grpc::CallbackServerContext *context,
+            const chord_invoke::RunMachineBatchRequest *request,
+            chord_invoke::RunMachineBatchResult *response) override;
+
         grpc::ServerUnaryReactor *
         AdvertiseEndpoints(
             grpc::CallbackServerContext *context,
@@ -51,14 +65,35 @@ namespace chord_agent {
             const chord_invoke::DeleteMachineRequest *request,
             chord_invoke::DeleteMachineResult *response) override;
 
+        grpc::ServerUnaryReactor *
+        AwaitAssignment(
+            grpc::CallbackServerContext *context,
+            const chord_invoke::AwaitAssignmentRequest *request,
+            chord_invoke::AwaitAssignmentResult *response) override;
+
+        grpc::ServerUnaryReactor *
+        GetSupervisorMetrics(
+            grpc::CallbackServerContext *context,
+            const chord_invoke::GetSupervisorMetricsRequest *request,
+            chord_invoke::GetSupervisorMetricsResult *response) override;
+
     private:
         const AgentConfig &m_agentConfig;
         uv_loop_t *m_loop;
         tu_uint64 m_uptime;
 
+        // handlers hold the lock shared, only initialize and shutdown hold it exclusively
         std::unique_ptr<absl::Mutex> m_lock;
         std::unique_ptr<MachineSupervisor> m_supervisor ABSL_GUARDED_BY(m_lock);
 
+        tempo_utils::Status spawnMachine(
+            const chord_invoke::CreateMachineRequest &request,
+            std::shared_ptr<OnSupervisorSpawn> waiter);
+
+        tempo_utils::Status bindMachine(
+            const chord_invoke::RunMachineRequest &request,
+            std::shared_ptr<OnSupervisorReady> waiter);
+
         tempo_utils::Status doCreateMachine(
             grpc::ServerUnaryReactor *reactor,
             grpc::CallbackServerContext *context,
@@ -88,6 +123,18 @@ namespace chord_agent {
             grpc::CallbackServerContext *context,
             const chord_invoke::DeleteMachineRequest *request,
             chord_invoke::DeleteMachineResult *response);
+
+        tempo_utils::Status doAwaitAssignment(
+            grpc::ServerUnaryReactor *reactor,
+            grpc::CallbackServerContext *context,
+            const chord_invoke::AwaitAssignmentRequest *request,
+            chord_invoke::AwaitAssignmentResult *response);
+
+        tempo_utils::Status doGetSupervisorMetrics(
+            grpc::ServerUnaryReactor *reactor,
+            grpc::CallbackServerContext *context,
+            const chord_invoke::GetSupervisorMetricsRequest *request,
+            chord_invoke::GetSupervisorMetricsResult *response);
     };
 
     class OnAgentSpawn : public OnSupervisorSpawn {
@@ -103,6 +150,35 @@ namespace chord_agent {
         chord_invoke::CreateMachineResult *m_result;
     };
 
+    /**
+     * Tracks the items of a batch call which have not completed yet. The call is finished when
+     * the last item completes.
+     */
+    class BatchCompletion {
+    public:
+        BatchCompletion(grpc::ServerUnaryReactor *reactor, int numItems);
+        void completeItem();
+
+    private:
+        grpc::ServerUnaryReactor *m_reactor;
+        std::atomic<int> m_remaining;
+    };
+
+    class OnAgentBatchSpawn : public OnSupervisorSpawn {
+    public:
+        OnAgentBatchSpawn(
+            std::shared_ptr<BatchCompletion> completion,
+            chord_invoke::CreateMachineItemResult *item);
+        void onComplete(
+            MachineHandle handle,
+            const chord_invoke::SignCertificatesRequest &signCertificatesRequest) override;
+        void onStatus(tempo_utils::Status status) override;
+
+    private:
+        std::shared_ptr<BatchCompletion> m_completion;
+        chord_invoke::CreateMachineItemResult *m_item;
+    };
+
     class OnAgentSign : public OnSupervisorSign {
     public:
         OnAgentSign(grpc::ServerUnaryReactor *reactor, chord_invoke::SignCertificatesResult *result);
@@ -129,6 +205,21 @@ namespace chord_agent {
         chord_invoke::RunMachineResult *m_result;
     };
 
+    class OnAgentBatchReady : public OnSupervisorReady {
+    public:
+        OnAgentBatchReady(
+            std::shared_ptr<BatchCompletion> completion,
+            chord_invoke::RunMachineItemResult *item);
+        void onComplete(
+            MachineHandle handle,
+            const chord_invoke::AdvertiseEndpointsRequest &advertiseEndpointsRequest) override;
+        void onStatus(tempo_utils::Status status) override;
+
+    private:
+        std::shared_ptr<BatchCompletion> m_completion;
+        chord_invoke::RunMachineItemResult *m_item;
+    };
+
     class OnAgentTerminate : public OnSupervisorTerminate {
     public:
         OnAgentTerminate(grpc::ServerUnaryReactor *reactor, chord_invoke::DeleteMachineResult *result);
@@ -139,6 +230,19 @@ namespace chord_agent {
         grpc::ServerUnaryReactor *m_reactor;
         chord_invoke::DeleteMachineResult *m_result;
     };
+
+    class OnAgentAssign : public OnSupervisorAssign {
+    public:
+        OnAgentAssign(grpc::ServerUnaryReactor *reactor, chord_invoke::AwaitAssignmentResult *result);
+        void onComplete(
+            MachineHandle handle,
+            const chord_invoke::AwaitAssignmentResult &awaitAssignmentResult) override;
+        void onStatus(tempo_utils::Status status) override;
+
+    private:
+        grpc::ServerUnaryReactor *m_reactor;
+        chord_invoke::AwaitAssignmentResult *m_result;
+    };
 }
 
 #endif // CHORD_AGENT_AGENT_SERVICE_H
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef CHORD_AGENT_MACHINE_LOG_WRITER_H
+#define CHORD_AGENT_MACHINE_LOG_WRITER_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <uv.h>
+
+#include <tempo_utils/integer_types.h>
+#include <tempo_utils/status.h>
+
+namespace chord_agent {
+
+    struct MachineLogWriterOptions {
+        std::filesystem::path logDirectory = {};
+        tu_uint64 maxFileBytes = 16 * 1024 * 1024;
+        int maxRotatedFiles = 3;
+        absl::Duration flushInterval = absl::Milliseconds(100);
+        tu_uint32 maxQueuedLines = 64 * 1024;
+    };
+
+    /**
+     * Writes machine output to per-machine log files on a background thread. Lines are queued by
+     * the agent loop and written in batches, so a machine which produces a lot of output never
+     * blocks the loop on file I/O. Each log file is rotated once it exceeds the maximum size, and
+     * is kept open until the machine's log is closed.
+     */
+    class MachineLogWriter {
+    public:
+        explicit MachineLogWriter(const MachineLogWriterOptions &options);
+        ~MachineLogWriter();
+
+        tempo_utils::Status initialize();
+
+        bool append(std::string_view machineName, std::vector<std::string> &&lines);
+        void closeLog(std::string_view machineName);
+
+        tu_uint64 getLinesWritten() const;
+        tu_uint64 getLinesDropped() const;
+        tu_uint32 getNumOpenFiles() const;
+
+        std::filesystem::path getLogFilePath(std::string_view machineName) const;
+
+        tempo_utils::Status shutdown();
+
+    private:
+        MachineLogWriterOptions m_options;
+        uv_thread_t m_thread;
+
+        struct LogBatch {
+            std::string machineName;
+            std::vector<std::string> lines;
+            bool close = false;
+        };
+
+        mutable absl::Mutex m_lock;
+        std::vector<LogBatch> m_pending ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_numPendingLines ABSL_GUARDED_BY(m_lock);
+        tu_uint64 m_linesWritten ABSL_GUARDED_BY(m_lock);
+        tu_uint64 m_linesDropped ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_numOpenFiles ABSL_GUARDED_BY(m_lock);
+        bool m_running ABSL_GUARDED_BY(m_lock);
+        bool m_stopping ABSL_GUARDED_BY(m_lock);
+
+        // only accessed by the writer thread
+        struct LogFile {
+            int fd;
+            tu_uint64 size;
+        };
+        absl::flat_hash_map<std::string,LogFile> m_files;
+
+        void runWriter();
+        void writeBatch(const LogBatch &batch);
+        tempo_utils::Status openLogFile(const std::string &machineName, LogFile &logFile);
+        void rotateLogFile(const std::string &machineName, LogFile &logFile);
+        void closeLogFile(const std::string &machineName);
+        void closeLogFiles();
+
+        friend void run_log_writer(void *arg);
+    };
+}
+
+#endif // CHORD_AGENT_MACHINE_LOG_WRITER_H
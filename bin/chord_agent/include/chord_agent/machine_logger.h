@@ -1,16 +1,69 @@
 #ifndef CHORD_AGENT_MACHINE_LOGGER_H
 #define CHORD_AGENT_MACHINE_LOGGER_H
 
+#include <string>
+#include <vector>
+
+#include <absl/synchronization/mutex.h>
 #include <uv.h>
 
+#include <tempo_utils/integer_types.h>
 #include <tempo_utils/status.h>
 #include <tempo_utils/url.h>
 
+#include "machine_log_writer.h"
+
 namespace chord_agent {
 
+    constexpr size_t kMachineLoggerReadBufferSize = 16 * 1024;
+    constexpr size_t kMachineLoggerMaxFreeBuffers = 4;
+
+    struct MachineLoggerOptions {
+        double linesPerSecond = 1000;
+        double burstLines = 5000;
+        size_t maxLineLength = 4096;
+    };
+
+    /**
+     * Token bucket which limits the rate of lines logged for a machine. The bucket holds up to
+     * `burst` tokens and is refilled at `ratePerSecond` tokens per second.
+     */
+    class TokenBucket {
+    public:
+        TokenBucket(double ratePerSecond, double burst);
+
+        bool tryTake(tu_uint64 nowMillis);
+
+    private:
+        double m_ratePerSecond;
+        double m_burst;
+        double m_tokens;
+        tu_uint64 m_lastRefillMillis;
+    };
+
+    /**
+     * Splits a stream of bytes into lines. Lines which are longer than the maximum line length
+     * are split into multiple lines.
+     */
+    class LineFramer {
+    public:
+        explicit LineFramer(size_t maxLineLength);
+
+        void append(std::string_view data, std::vector<std::string> &lines);
+        void flush(std::vector<std::string> &lines);
+
+    private:
+        size_t m_maxLineLength;
+        std::string m_partial;
+    };
+
     class MachineLogger {
     public:
-        MachineLogger(const std::string &machineName, uv_loop_t *loop);
+        MachineLogger(
+            const std::string &machineName,
+            uv_loop_t *loop,
+            MachineLogWriter *writer = nullptr,
+            const MachineLoggerOptions &options = {});
         ~MachineLogger();
 
         tempo_utils::Status initialize();
@@ -19,19 +72,41 @@ namespace chord_agent {
         tempo_utils::Status closeLogger(uv_stream_t *stream);
         tempo_utils::Status closeLoggerUnconditionally();
 
+        void setMachineName(std::string_view machineName);
+
         uv_stream_t *getOutput() const;
         uv_stream_t *getError() const;
 
+        tu_uint64 getLinesDropped() const;
+
     private:
-        std::string m_machineName;
         uv_loop_t *m_loop;
+        MachineLogWriter *m_writer;
+        MachineLoggerOptions m_options;
         uv_pipe_t m_out;
         uv_pipe_t m_err;
         bool m_outIsClosed;
         bool m_errIsClosed;
 
+        // the machine name changes when a pooled machine is assigned
+        mutable absl::Mutex m_lock;
+        std::string m_machineName ABSL_GUARDED_BY(m_lock);
+
+        // only accessed from the loop thread
+        std::vector<char *> m_freeBuffers;
+        LineFramer m_outFramer;
+        LineFramer m_errFramer;
+        TokenBucket m_bucket;
+        tu_uint64 m_linesDropped;
+        tu_uint64 m_pendingDropped;
+
+        char *takeBuffer();
+        void releaseBuffer(char *buffer);
+        void emitLines(std::string_view tag, std::vector<std::string> &lines, bool endOfStream = false);
+
+        friend void on_buf_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
         friend void on_pipe_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
     };
 }
 
-#endif // CHORD_AGENT_MACHINE_LOGGER_H
\ No newline at end of file
+#endif // CHORD_AGENT_MACHINE_LOGGER_H
@@ -31,6 +31,7 @@ namespace chord_agent {
         std::filesystem::path runDirectory = {};
         std::vector<std::filesystem::path> packageCacheDirectories = {};
         std::filesystem::path pemRootCABundleFile = {};
+        std::filesystem::path assemblyStoreDirectory = {};
         std::vector<chord_common::RequestedPort> requestedPorts = {};
         std::vector<std::string> mainArguments = {};
         bool enableMonitoring = false;
@@ -45,9 +46,15 @@ namespace chord_agent {
             const chord_common::TransportLocation &supervisorEndpoint,
             MachineSupervisor *supervisor,
             const MachineOptions &options = {});
+        static tempo_utils::Result<std::shared_ptr<MachineProcess>> createPooled(
+            std::string_view pooledName,
+            const chord_common::TransportLocation &supervisorEndpoint,
+            MachineSupervisor *supervisor,
+            const MachineOptions &options = {});
         virtual ~MachineProcess();
 
         std::string getMachineName() const;
+        void assign(std::string_view machineName);
 
         MachineState getState() const;
         void setState(MachineState state);
@@ -8,16 +8,22 @@
 #include <grpcpp/grpcpp.h>
 #include <uv.h>
 
+#include <chord_common/assembly_store.h>
 #include <chord_invoke/invoke_service.pb.h>
 #include <tempo_utils/process_builder.h>
 #include <tempo_utils/url.h>
 
 #include "agent_config.h"
+#include "machine_log_writer.h"
 #include "machine_logger.h"
 #include "machine_process.h"
+#include "supervisor_metrics.h"
 
 namespace chord_agent {
 
+    constexpr absl::Duration kMachinePoolCheckInterval = absl::Seconds(1);
+    constexpr absl::Duration kAssemblyStoreTrimInterval = absl::Minutes(1);
+
     // forward declarations
     class MachineSupervisor;
 
@@ -40,6 +46,15 @@ namespace chord_agent {
         virtual void onStatus(tempo_utils::Status status) = 0;
     };
 
+    class OnSupervisorAssign {
+    public:
+        virtual ~OnSupervisorAssign() = default;
+        virtual void onComplete(
+            MachineHandle handle,
+            const chord_invoke::AwaitAssignmentResult &awaitAssignmentResult) = 0;
+        virtual void onStatus(tempo_utils::Status status) = 0;
+    };
+
     class OnSupervisorSign {
     public:
         virtual ~OnSupervisorSign() = default;
@@ -67,6 +82,7 @@ namespace chord_agent {
 
     struct SpawningContext {
         std::string machineName;
+        absl::Time phaseStart;
         uv_timer_t timeout;
         std::shared_ptr<OnSupervisorSpawn> waiter;
         MachineSupervisor *supervisor;
@@ -74,6 +90,7 @@ namespace chord_agent {
 
     struct SigningContext {
         std::string machineName;
+        absl::Time phaseStart;
         uv_timer_t timeout;
         std::shared_ptr<OnSupervisorSign> waiter;
         MachineSupervisor *supervisor;
@@ -81,11 +98,19 @@ namespace chord_agent {
 
     struct ReadyContext {
         std::string machineName;
+        absl::Time phaseStart;
         uv_timer_t timeout;
         std::shared_ptr<OnSupervisorReady> waiter;
         MachineSupervisor *supervisor;
     };
 
+    struct PooledContext {
+        std::string pooledName;
+        absl::Time spawnTime;
+        absl::Time idleSince;
+        std::shared_ptr<OnSupervisorAssign> waiter;
+    };
+
     struct WaitingContext {
         std::shared_ptr<OnSupervisorTerminate> waiter;
     };
@@ -102,6 +127,9 @@ namespace chord_agent {
         bool isIdle();
 
         uv_loop_t *getLoop() const;
+        const SupervisorMetrics *getMetrics() const;
+        MachineLogWriter *getLogWriter() const;
+        MachineLoggerOptions getLoggerOptions() const;
 
         tempo_utils::Status spawnMachine(
             std::string_view machineName,
@@ -109,6 +137,10 @@ namespace chord_agent {
             const MachineOptions &options,
             std::shared_ptr<OnSupervisorSpawn> waiter);
 
+        tempo_utils::Status awaitAssignment(
+            std::string_view pooledName,
+            std::shared_ptr<OnSupervisorAssign> waiter);
+
         tempo_utils::Status requestCertificates(
             std::string_view machineName,
             const chord_invoke::SignCertificatesRequest &signCertificatesRequest,
@@ -134,6 +166,9 @@ namespace chord_agent {
         chord_common::TransportLocation m_supervisorEndpoint;
         uv_loop_t *m_loop;
         uv_timer_t m_idle;
+        uv_timer_t m_poolCheck;
+        uv_async_t m_poolRefill;
+        uv_timer_t m_storeTrim;
 
         absl::Mutex m_lock;
         absl::flat_hash_map<std::string, std::shared_ptr<MachineProcess>> m_machines;
@@ -141,8 +176,25 @@ namespace chord_agent {
         absl::flat_hash_map<std::string, std::unique_ptr<SigningContext>> m_signing;
         absl::flat_hash_map<std::string, std::unique_ptr<ReadyContext>> m_ready;
         absl::flat_hash_map<std::string, std::unique_ptr<WaitingContext>> m_waiting;
+        absl::flat_hash_map<std::string, std::unique_ptr<PooledContext>> m_pooled;
         bool m_shuttingDown;
+        SupervisorMetrics m_metrics;
+        std::unique_ptr<MachineLogWriter> m_logWriter;
+        std::shared_ptr<chord_common::AssemblyStore> m_assemblyStore;
 
+        tempo_utils::Status trackSpawning(
+            std::string_view machineName,
+            std::shared_ptr<OnSupervisorSpawn> waiter);
+        tempo_utils::Status assignPooled(
+            std::unique_ptr<PooledContext> pooled,
+            std::string_view machineName,
+            const zuri_packager::PackageSpecifier &mainPackage,
+            const MachineOptions &options,
+            std::shared_ptr<OnSupervisorSpawn> waiter);
+        std::unique_ptr<PooledContext> takeIdlePooled();
+        void fillPool();
+        void expirePool();
+        void trimStore();
         tempo_utils::Status release(std::string_view processName, tu_int64 status, int signal);
         tempo_utils::Status abandon(std::string_view processName);
         tempo_utils::Status reap(std::string_view processName);
@@ -151,6 +203,9 @@ namespace chord_agent {
         friend void on_spawning_timeout(uv_timer_t *timer);
         friend void on_signing_timeout(uv_timer_t *timer);
         friend void on_ready_timeout(uv_timer_t *timer);
+        friend void on_pool_check(uv_timer_t *timer);
+        friend void on_pool_refill(uv_async_t *async);
+        friend void on_store_trim(uv_timer_t *timer);
     };
 
     class OnInternalTerminate : public OnSupervisorTerminate {
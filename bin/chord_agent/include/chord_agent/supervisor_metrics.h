@@ -0,0 +1,70 @@
+#ifndef CHORD_AGENT_SUPERVISOR_METRICS_H
+#define CHORD_AGENT_SUPERVISOR_METRICS_H
+
+#include <array>
+#include <atomic>
+
+#include <absl/time/time.h>
+
+#include <chord_invoke/invoke_service.pb.h>
+#include <tempo_utils/integer_types.h>
+
+namespace chord_agent {
+
+    /**
+     * Latency histogram with HDR-style log-linear buckets over microseconds. Values below
+     * kSubBucketCount are counted exactly, above that each power of two is divided into
+     * kSubBucketCount / 2 linear sub-buckets, giving a relative error of at most 1/16. Recording
+     * is lock-free, so the histogram can be read concurrently with the supervisor updating it.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr int kSubBucketBits = 5;
+        static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+        static constexpr int kHalfSubBucketCount = kSubBucketCount / 2;
+        static constexpr int kMaxValueBits = 40;
+        static constexpr int kNumBuckets = kSubBucketCount
+            + (kMaxValueBits - kSubBucketBits) * kHalfSubBucketCount;
+
+        LatencyHistogram();
+
+        void record(absl::Duration latency);
+
+        tu_uint64 getCount() const;
+        tu_uint64 getSumMicros() const;
+        tu_uint64 getMinMicros() const;
+        tu_uint64 getMaxMicros() const;
+        tu_uint64 getValueAtPercentile(double percentile) const;
+
+        void toProto(chord_invoke::LatencyHistogram *histogram) const;
+
+        static int bucketIndex(tu_uint64 micros);
+        static tu_uint64 bucketUpperBound(int index);
+
+    private:
+        std::array<std::atomic<tu_uint64>, kNumBuckets> m_buckets;
+        std::atomic<tu_uint64> m_count;
+        std::atomic<tu_uint64> m_sumMicros;
+        std::atomic<tu_uint64> m_minMicros;
+        std::atomic<tu_uint64> m_maxMicros;
+    };
+
+    /**
+     * Lifecycle metrics recorded by the MachineSupervisor. Each phase histogram measures the time
+     * a machine spent waiting in the corresponding supervisor queue.
+     */
+    struct SupervisorMetrics {
+        LatencyHistogram spawningLatency;   // spawn until SignCertificates from the machine
+        LatencyHistogram signingLatency;    // SignCertificates until RunMachine from the client
+        LatencyHistogram bindingLatency;    // RunMachine until AdvertiseEndpoints from the machine
+        std::atomic<tu_uint64> spawned = 0;
+        std::atomic<tu_uint64> ready = 0;
+        std::atomic<tu_uint64> timedOut = 0;
+        std::atomic<tu_uint64> abandoned = 0;
+        std::atomic<tu_uint64> released = 0;
+
+        void toProto(chord_invoke::GetSupervisorMetricsResult *result) const;
+    };
+}
+
+#endif // CHORD_AGENT_SUPERVISOR_METRICS_H
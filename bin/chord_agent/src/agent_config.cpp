@@ -23,9 +23,16 @@ chord_agent::configure_agent(const tempo_command::CommandConfig &commandConfig,
     tempo_config::BooleanParser temporarySessionParser(false);
     tempo_config::DurationParser idleTimeoutParser(absl::Duration{});
     tempo_config::DurationParser registrationTimeoutParser(absl::Seconds(5));
+    tempo_config::IntegerParser machinePoolSizeParser(0);
+    tempo_config::DurationParser machinePoolMaxIdleAgeParser(absl::Minutes(10));
     tempo_config::PathParser logFileParser(std::filesystem::path{});
     tempo_config::PathParser pidFileParser(std::filesystem::path{});
     tempo_config::PathParser endpointFileParser(std::filesystem::path{});
+    tempo_config::PathParser readyFifoParser(std::filesystem::path{});
+    tempo_config::PathParser machineLogDirectoryParser(std::filesystem::path{});
+    tempo_config::IntegerParser machineLogRateParser(1000);
+    tempo_config::PathParser assemblyStoreDirectoryParser(std::filesystem::path("assemblies"));
+    tempo_config::IntegerParser assemblyStoreSizeParser(1024);
 
     // determine the session name
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.sessionName, sessionNameParser,
@@ -77,6 +84,20 @@ chord_agent::configure_agent(const tempo_command::CommandConfig &commandConfig,
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.registrationTimeout, registrationTimeoutParser,
         commandConfig, "registrationTimeout"));
 
+    // parse the machine pool size option
+    int machinePoolSize;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(machinePoolSize, machinePoolSizeParser,
+        commandConfig, "machinePoolSize"));
+    if (machinePoolSize < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "machine pool size must not be negative");
+    agentConfig.machinePoolSize = static_cast<tu_uint32>(machinePoolSize);
+
+    // parse the machine pool max idle age option
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.machinePoolMaxIdleAge,
+        machinePoolMaxIdleAgeParser, commandConfig, "machinePoolMaxIdleAge"));
+
     // determine the log file
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.logFile, logFileParser,
         commandConfig, "logFile"));
@@ -89,6 +110,38 @@ chord_agent::configure_agent(const tempo_command::CommandConfig &commandConfig,
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.endpointFile, endpointFileParser,
         commandConfig, "endpointFile"));
 
+    // determine the ready fifo
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.readyFifo, readyFifoParser,
+        commandConfig, "readyFifo"));
+
+    // determine the machine log directory
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.machineLogDirectory,
+        machineLogDirectoryParser, commandConfig, "machineLogDirectory"));
+
+    // parse the machine log rate option
+    int machineLogRate;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(machineLogRate, machineLogRateParser,
+        commandConfig, "machineLogRate"));
+    if (machineLogRate <= 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "machine log rate must be positive");
+    agentConfig.machineLogRate = static_cast<tu_uint32>(machineLogRate);
+
+    // determine the assembly store directory
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(agentConfig.assemblyStoreDirectory,
+        assemblyStoreDirectoryParser, commandConfig, "assemblyStoreDirectory"));
+
+    // parse the assembly store size option, zero means machines do not share an assembly store
+    int assemblyStoreSize;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(assemblyStoreSize, assemblyStoreSizeParser,
+        commandConfig, "assemblyStoreSize"));
+    if (assemblyStoreSize < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "assembly store size must not be negative");
+    agentConfig.assemblyStoreSize = static_cast<tu_uint64>(assemblyStoreSize) * 1024 * 1024;
+
     // if run directory was specified then adjust relative file paths
 
     if (!agentConfig.runDirectory.empty()) {
@@ -112,6 +165,15 @@ chord_agent::configure_agent(const tempo_command::CommandConfig &commandConfig,
         if (agentConfig.endpointFile.is_relative()) {
             agentConfig.endpointFile = runDirectory / agentConfig.endpointFile;
         }
+        if (agentConfig.readyFifo.is_relative()) {
+            agentConfig.readyFifo = runDirectory / agentConfig.readyFifo;
+        }
+        if (!agentConfig.machineLogDirectory.empty() && agentConfig.machineLogDirectory.is_relative()) {
+            agentConfig.machineLogDirectory = runDirectory / agentConfig.machineLogDirectory;
+        }
+        if (agentConfig.assemblyStoreDirectory.is_relative()) {
+            agentConfig.assemblyStoreDirectory = runDirectory / agentConfig.assemblyStoreDirectory;
+        }
     }
 
     // check for required files
@@ -30,7 +30,7 @@ chord_agent::AgentService::initialize(const chord_common::TransportLocation &sup
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "AgentService is already initialized");
     m_supervisor = std::make_unique<MachineSupervisor>(m_agentConfig, supervisorEndpoint, m_loop);
-    return {};
+    return m_supervisor->initialize();
 }
 
 tempo_utils::Status
@@ -57,22 +57,22 @@ chord_agent::AgentService::IdentifyAgent(
     return reactor;
 }
 
-tempo_utils::Status
-chord_agent::AgentService::doCreateMachine(
-    grpc::ServerUnaryReactor *reactor,
-    grpc::CallbackServerContext *context,
-    const chord_invoke::CreateMachineRequest *request,
-    chord_invoke::CreateMachineResult *response)
+/**
+ * Parse the main package and machine options from the CreateMachine request.
+ */
+static tempo_utils::Status
+parse_create_machine_request(
+    const chord_invoke::CreateMachineRequest &request,
+    zuri_packager::PackageSpecifier &mainPackage,
+    chord_agent::MachineOptions &options)
 {
-    auto &machineName = request->machine_name();
-    auto mainPackage = zuri_packager::PackageSpecifier::fromString(request->main_package());
-    MachineOptions options;
+    mainPackage = zuri_packager::PackageSpecifier::fromString(request.main_package());
 
     // build list of requested ports
-    for (const auto &requestedPort : request->requested_ports()) {
+    for (const auto &requestedPort : request.requested_ports()) {
         auto protocolUrl = tempo_utils::Url::fromString(requestedPort.protocol_url());
         if (!protocolUrl.isValid())
-            return AgentStatus::forCondition(AgentCondition::kInvalidConfiguration,
+            return chord_agent::AgentStatus::forCondition(chord_agent::AgentCondition::kInvalidConfiguration,
                 "invalid protocol url '{}'", requestedPort.protocol_url());
 
         chord_common::PortType portType;
@@ -84,7 +84,7 @@ chord_agent::AgentService::doCreateMachine(
                 portType = chord_common::PortType::OneShot;
                 break;
             default:
-                return AgentStatus::forCondition(AgentCondition::kInvalidConfiguration,
+                return chord_agent::AgentStatus::forCondition(chord_agent::AgentCondition::kInvalidConfiguration,
                     "invalid port type for protocol '{}'", protocolUrl.toString());
         }
 
@@ -100,25 +100,42 @@ chord_agent::AgentService::doCreateMachine(
                 portDirection = chord_common::PortDirection::BiDirectional;
                 break;
             default:
-                return AgentStatus::forCondition(AgentCondition::kInvalidConfiguration,
+                return chord_agent::AgentStatus::forCondition(chord_agent::AgentCondition::kInvalidConfiguration,
                     "invalid port direction for protocol '{}'", protocolUrl.toString());
         }
 
         options.requestedPorts.emplace_back(protocolUrl, portType, portDirection);
     }
 
-    options.enableMonitoring = request->requested_control();
-    options.startSuspended = request->start_suspended();
+    options.enableMonitoring = request.requested_control();
+    options.startSuspended = request.start_suspended();
 
-    // acquire mutex and ensure that the service is initialized
-    absl::MutexLock lock(m_lock.get());
+    return {};
+}
+
+/**
+ * Spawn the machine described by the CreateMachine request. If the request is valid then the
+ * waiter is always completed, either when the machine sends SignCertificates or with the error
+ * status if the machine could not be spawned.
+ */
+tempo_utils::Status
+chord_agent::AgentService::spawnMachine(
+    const chord_invoke::CreateMachineRequest &request,
+    std::shared_ptr<OnSupervisorSpawn> waiter)
+{
+    zuri_packager::PackageSpecifier mainPackage;
+    MachineOptions options;
+    TU_RETURN_IF_NOT_OK (parse_create_machine_request(request, mainPackage, options));
+
+    // acquire the lock shared, the supervisor synchronizes its own state
+    absl::ReaderMutexLock lock(m_lock.get());
     if (m_supervisor == nullptr)
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "service is not initialized");
 
     // spawn the helper process and move machine to 'spawning' queue
-    auto waiter = std::make_shared<OnAgentSpawn>(reactor, response);
-    auto spawnMachineStatus = m_supervisor->spawnMachine(machineName, mainPackage, options, waiter);
+    auto spawnMachineStatus = m_supervisor->spawnMachine(
+        request.machine_name(), mainPackage, options, waiter);
     if (spawnMachineStatus.notOk()) {
         waiter->onStatus(spawnMachineStatus);
     }
@@ -126,6 +143,17 @@ chord_agent::AgentService::doCreateMachine(
     return {};
 }
 
+tempo_utils::Status
+chord_agent::AgentService::doCreateMachine(
+    grpc::ServerUnaryReactor *reactor,
+    grpc::CallbackServerContext *context,
+    const chord_invoke::CreateMachineRequest *request,
+    chord_invoke::CreateMachineResult *response)
+{
+    auto waiter = std::make_shared<OnAgentSpawn>(reactor, response);
+    return spawnMachine(*request, waiter);
+}
+
 grpc::ServerUnaryReactor *
 chord_agent::AgentService::CreateMachine(
     grpc::CallbackServerContext *context,
@@ -170,8 +198,8 @@ chord_agent::AgentService::doSignCertificates(
         declaredPortEndpoints.insert(endpointUrl);
     }
 
-    // acquire mutex and ensure that the service is initialized
-    absl::MutexLock lock(m_lock.get());
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
     if (m_supervisor == nullptr)
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "service is not initialized");
@@ -198,26 +226,34 @@ chord_agent::AgentService::SignCertificates(
     return reactor;
 }
 
+/**
+ * Bind the signed certificates to the machine described by the RunMachine request. The waiter is
+ * completed when the machine sends AdvertiseEndpoints.
+ */
 tempo_utils::Status
-chord_agent::AgentService::doRunMachine(
-    grpc::ServerUnaryReactor *reactor,
-    grpc::CallbackServerContext *context,
-    const chord_invoke::RunMachineRequest *request,
-    chord_invoke::RunMachineResult *response)
+chord_agent::AgentService::bindMachine(
+    const chord_invoke::RunMachineRequest &request,
+    std::shared_ptr<OnSupervisorReady> waiter)
 {
-    auto &machineName = request->machine_name();
-
-    // acquire mutex and ensure that the service is initialized
-    absl::MutexLock lock(m_lock.get());
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
     if (m_supervisor == nullptr)
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "service is not initialized");
 
     // respond to SignCertificates request and move machine to 'ready' queue
-    auto waiter = std::make_shared<OnAgentReady>(reactor, response);
-    TU_RETURN_IF_NOT_OK (m_supervisor->bindCertificates(machineName, *request, waiter));
+    return m_supervisor->bindCertificates(request.machine_name(), request, waiter);
+}
 
-    return {};
+tempo_utils::Status
+chord_agent::AgentService::doRunMachine(
+    grpc::ServerUnaryReactor *reactor,
+    grpc::CallbackServerContext *context,
+    const chord_invoke::RunMachineRequest *request,
+    chord_invoke::RunMachineResult *response)
+{
+    auto waiter = std::make_shared<OnAgentReady>(reactor, response);
+    return bindMachine(*request, waiter);
 }
 
 grpc::ServerUnaryReactor *
@@ -235,6 +271,64 @@ chord_agent::AgentService::RunMachine(
     return reactor;
 }
 
+grpc::ServerUnaryReactor *
+chord_agent::AgentService::CreateMachineBatch(
+    grpc::CallbackServerContext *context,
+    const chord_invoke::CreateMachineBatchRequest *request,
+    chord_invoke::CreateMachineBatchResult *response)
+{
+    TU_LOG_INFO << "CreateMachineBatch request for " << request->machines_size() << " machines";
+    auto *reactor = context->DefaultReactor();
+    if (request->machines_size() == 0) {
+        reactor->Finish(grpc::Status::OK);
+        return reactor;
+    }
+
+    // allocate every item result up front so the waiters can complete them in any order
+    for (int i = 0; i < request->machines_size(); i++) {
+        response->add_machines();
+    }
+
+    auto completion = std::make_shared<BatchCompletion>(reactor, request->machines_size());
+    for (int i = 0; i < request->machines_size(); i++) {
+        auto waiter = std::make_shared<OnAgentBatchSpawn>(completion, response->mutable_machines(i));
+        auto status = spawnMachine(request->machines(i), waiter);
+        if (status.notOk()) {
+            waiter->onStatus(status);
+        }
+    }
+    return reactor;
+}
+
+grpc::ServerUnaryReactor *
+chord_agent::AgentService::RunMachineBatch(
+    grpc::CallbackServerContext *context,
+    const chord_invoke::RunMachineBatchRequest *request,
+    chord_invoke::RunMachineBatchResult *response)
+{
+    TU_LOG_INFO << "RunMachineBatch request for " << request->machines_size() << " machines";
+    auto *reactor = context->DefaultReactor();
+    if (request->machines_size() == 0) {
+        reactor->Finish(grpc::Status::OK);
+        return reactor;
+    }
+
+    // allocate every item result up front so the waiters can complete them in any order
+    for (int i = 0; i < request->machines_size(); i++) {
+        response->add_machines();
+    }
+
+    auto completion = std::make_shared<BatchCompletion>(reactor, request->machines_size());
+    for (int i = 0; i < request->machines_size(); i++) {
+        auto waiter = std::make_shared<OnAgentBatchReady>(completion, response->mutable_machines(i));
+        auto status = bindMachine(request->machines(i), waiter);
+        if (status.notOk()) {
+            waiter->onStatus(status);
+        }
+    }
+    return reactor;
+}
+
 tempo_utils::Status
 chord_agent::AgentService::doAdvertiseEndpoints(
     grpc::ServerUnaryReactor *reactor,
@@ -244,8 +338,8 @@ chord_agent::AgentService::doAdvertiseEndpoints(
 {
     auto &machineName = request->machine_name();
 
-    // acquire mutex and ensure that the service is initialized
-    absl::MutexLock lock(m_lock.get());
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
     if (m_supervisor == nullptr)
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "service is not initialized");
@@ -283,8 +377,8 @@ chord_agent::AgentService::doDeleteMachine(
 {
     auto &machineName = request->machine_name();
 
-    // acquire mutex and ensure that the service is initialized
-    absl::MutexLock lock(m_lock.get());
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
     if (m_supervisor == nullptr)
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "service is not initialized");
@@ -310,6 +404,77 @@ chord_agent::AgentService::DeleteMachine(
     return reactor;
 }
 
+tempo_utils::Status
+chord_agent::AgentService::doAwaitAssignment(
+    grpc::ServerUnaryReactor *reactor,
+    grpc::CallbackServerContext *context,
+    const chord_invoke::AwaitAssignmentRequest *request,
+    chord_invoke::AwaitAssignmentResult *response)
+{
+    auto &pooledName = request->pooled_name();
+
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
+    if (m_supervisor == nullptr)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "service is not initialized");
+
+    // park the pooled machine until it is assigned by a CreateMachine request
+    auto waiter = std::make_shared<OnAgentAssign>(reactor, response);
+    TU_RETURN_IF_NOT_OK (m_supervisor->awaitAssignment(pooledName, waiter));
+
+    return {};
+}
+
+grpc::ServerUnaryReactor *
+chord_agent::AgentService::AwaitAssignment(
+    grpc::CallbackServerContext *context,
+    const chord_invoke::AwaitAssignmentRequest *request,
+    chord_invoke::AwaitAssignmentResult *response)
+{
+    TU_LOG_INFO << "AwaitAssignment request: " << request->DebugString();
+    auto *reactor = context->DefaultReactor();
+    auto status = doAwaitAssignment(reactor, context, request, response);
+    if (status.notOk()) {
+        reactor->Finish(chord_common::convert_status(status));
+    }
+    return reactor;
+}
+
+tempo_utils::Status
+chord_agent::AgentService::doGetSupervisorMetrics(
+    grpc::ServerUnaryReactor *reactor,
+    grpc::CallbackServerContext *context,
+    const chord_invoke::GetSupervisorMetricsRequest *request,
+    chord_invoke::GetSupervisorMetricsResult *response)
+{
+    // acquire the lock shared and ensure that the service is initialized
+    absl::ReaderMutexLock lock(m_lock.get());
+    if (m_supervisor == nullptr)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "service is not initialized");
+
+    // the metrics are updated without the supervisor lock, so the snapshot is not atomic
+    m_supervisor->getMetrics()->toProto(response);
+    reactor->Finish(grpc::Status::OK);
+
+    return {};
+}
+
+grpc::ServerUnaryReactor *
+chord_agent::AgentService::GetSupervisorMetrics(
+    grpc::CallbackServerContext *context,
+    const chord_invoke::GetSupervisorMetricsRequest *request,
+    chord_invoke::GetSupervisorMetricsResult *response)
+{
+    auto *reactor = context->DefaultReactor();
+    auto status = doGetSupervisorMetrics(reactor, context, request, response);
+    if (status.notOk()) {
+        reactor->Finish(chord_common::convert_status(status));
+    }
+    return reactor;
+}
+
 chord_agent::OnAgentSpawn::OnAgentSpawn(grpc::ServerUnaryReactor *reactor, chord_invoke::CreateMachineResult *result)
     : m_reactor(reactor),
       m_result(result)
@@ -318,14 +483,14 @@ chord_agent::OnAgentSpawn::OnAgentSpawn(grpc::ServerUnaryReactor *reactor, chord
     TU_ASSERT (m_result != nullptr);
 }
 
-void
-chord_agent::OnAgentSpawn::onComplete(
-    MachineHandle handle,
-    const chord_invoke::SignCertificatesRequest &signCertificatesRequest)
+static void
+copy_declarations(
+    const chord_invoke::SignCertificatesRequest &signCertificatesRequest,
+    chord_invoke::CreateMachineResult *result)
 {
     // forward declared ports
     for (const auto &declaredPort : signCertificatesRequest.declared_ports()) {
-        auto *resultPort = m_result->add_declared_ports();
+        auto *resultPort = result->add_declared_ports();
         resultPort->set_protocol_url(declaredPort.protocol_url());
         resultPort->set_endpoint_index(declaredPort.endpoint_index());
         resultPort->set_port_type(declaredPort.port_type());
@@ -334,11 +499,18 @@ chord_agent::OnAgentSpawn::onComplete(
 
     // forward declared endpoints
     for (const auto &declaredEndpoint : signCertificatesRequest.declared_endpoints()) {
-        auto *resultEndpoint = m_result->add_declared_endpoints();
+        auto *resultEndpoint = result->add_declared_endpoints();
         resultEndpoint->set_endpoint_url(declaredEndpoint.endpoint_url());
         resultEndpoint->set_csr(declaredEndpoint.csr());
     }
+}
 
+void
+chord_agent::OnAgentSpawn::onComplete(
+    MachineHandle handle,
+    const chord_invoke::SignCertificatesRequest &signCertificatesRequest)
+{
+    copy_declarations(signCertificatesRequest, m_result);
     m_reactor->Finish(grpc::Status::OK);
 }
 
@@ -384,16 +556,23 @@ chord_agent::OnAgentReady::OnAgentReady(grpc::ServerUnaryReactor *reactor, chord
     TU_ASSERT (m_result != nullptr);
 }
 
-void
-chord_agent::OnAgentReady::onComplete(
-    MachineHandle handle,
-    const chord_invoke::AdvertiseEndpointsRequest &advertiseEndpointsRequest)
+static void
+copy_bound_endpoints(
+    const chord_invoke::AdvertiseEndpointsRequest &advertiseEndpointsRequest,
+    chord_invoke::RunMachineResult *result)
 {
     for (const auto &boundEndpoint : advertiseEndpointsRequest.bound_endpoints()) {
-        auto *resultEndpoint = m_result->add_bound_endpoints();
+        auto *resultEndpoint = result->add_bound_endpoints();
         resultEndpoint->set_endpoint_url(boundEndpoint.endpoint_url());
     }
+}
 
+void
+chord_agent::OnAgentReady::onComplete(
+    MachineHandle handle,
+    const chord_invoke::AdvertiseEndpointsRequest &advertiseEndpointsRequest)
+{
+    copy_bound_endpoints(advertiseEndpointsRequest, m_result);
     m_reactor->Finish(grpc::Status::OK);
 }
 
@@ -427,3 +606,106 @@ chord_agent::OnAgentTerminate::onStatus(tempo_utils::Status status)
     TU_LOG_INFO << "OnAgentTerminate failed: " << status.toString();
     m_reactor->Finish(grpc::Status(grpc::StatusCode::ABORTED, status.toString()));
 }
+
+chord_agent::OnAgentAssign::OnAgentAssign(
+    grpc::ServerUnaryReactor *reactor,
+    chord_invoke::AwaitAssignmentResult *result)
+    : m_reactor(reactor),
+      m_result(result)
+{
+    TU_ASSERT (m_reactor != nullptr);
+    TU_ASSERT (m_result != nullptr);
+}
+
+void
+chord_agent::OnAgentAssign::onComplete(
+    MachineHandle handle,
+    const chord_invoke::AwaitAssignmentResult &awaitAssignmentResult)
+{
+    *m_result = awaitAssignmentResult;
+    m_reactor->Finish(grpc::Status::OK);
+}
+
+void
+chord_agent::OnAgentAssign::onStatus(tempo_utils::Status status)
+{
+    TU_LOG_INFO << "OnAgentAssign failed: " << status.toString();
+    m_reactor->Finish(grpc::Status(grpc::StatusCode::ABORTED, status.toString()));
+}
+
+chord_agent::BatchCompletion::BatchCompletion(grpc::ServerUnaryReactor *reactor, int numItems)
+    : m_reactor(reactor),
+      m_remaining(numItems)
+{
+    TU_ASSERT (m_reactor != nullptr);
+    TU_ASSERT (numItems > 0);
+}
+
+/**
+ * Mark one item of the batch as complete. The batch call is finished once every item is complete.
+ */
+void
+chord_agent::BatchCompletion::completeItem()
+{
+    if (m_remaining.fetch_sub(1) == 1) {
+        m_reactor->Finish(grpc::Status::OK);
+    }
+}
+
+chord_agent::OnAgentBatchSpawn::OnAgentBatchSpawn(
+    std::shared_ptr<BatchCompletion> completion,
+    chord_invoke::CreateMachineItemResult *item)
+    : m_completion(std::move(completion)),
+      m_item(item)
+{
+    TU_ASSERT (m_completion != nullptr);
+    TU_ASSERT (m_item != nullptr);
+}
+
+void
+chord_agent::OnAgentBatchSpawn::onComplete(
+    MachineHandle handle,
+    const chord_invoke::SignCertificatesRequest &signCertificatesRequest)
+{
+    copy_declarations(signCertificatesRequest, m_item->mutable_result());
+    m_item->set_status_code(grpc::StatusCode::OK);
+    m_completion->completeItem();
+}
+
+void
+chord_agent::OnAgentBatchSpawn::onStatus(tempo_utils::Status status)
+{
+    TU_LOG_INFO << "OnAgentBatchSpawn failed: " << status.toString();
+    m_item->set_status_code(grpc::StatusCode::ABORTED);
+    m_item->set_status_message(status.toString());
+    m_completion->completeItem();
+}
+
+chord_agent::OnAgentBatchReady::OnAgentBatchReady(
+    std::shared_ptr<BatchCompletion> completion,
+    chord_invoke::RunMachineItemResult *item)
+    : m_completion(std::move(completion)),
+      m_item(item)
+{
+    TU_ASSERT (m_completion != nullptr);
+    TU_ASSERT (m_item != nullptr);
+}
+
+void
+chord_agent::OnAgentBatchReady::onComplete(
+    MachineHandle handle,
+    const chord_invoke::AdvertiseEndpointsRequest &advertiseEndpointsRequest)
+{
+    copy_bound_endpoints(advertiseEndpointsRequest, m_item->mutable_result());
+    m_item->set_status_code(grpc::StatusCode::OK);
+    m_completion->completeItem();
+}
+
+void
+chord_agent::OnAgentBatchReady::onStatus(tempo_utils::Status status)
+{
+    TU_LOG_INFO << "OnAgentBatchReady failed: " << status.toString();
+    m_item->set_status_code(grpc::StatusCode::ABORTED);
+    m_item->set_status_message(status.toString());
+    m_completion->completeItem();
+}
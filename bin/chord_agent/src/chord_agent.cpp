@@ -1,3 +1,7 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
 #include <vector>
 
 #include <grpcpp/server.h>
@@ -21,6 +25,36 @@
 #include "chord_agent/agent_config.h"
 #include "chord_common/common_conversions.h"
 
+/**
+ * Write the readiness report to the fifo. The report is three newline-terminated lines containing
+ * the listen endpoint, the server name, and the time the agent became ready in microseconds since
+ * the unix epoch. The report is small enough to be written atomically to the fifo.
+ */
+static tempo_utils::Status
+report_readiness(const std::filesystem::path &readyFifo, const chord_common::TransportLocation &listenLocation)
+{
+    auto report = absl::StrCat(
+        listenLocation.toString(), "\n",
+        listenLocation.getServerName(), "\n",
+        absl::ToUnixMicros(absl::Now()), "\n");
+    TU_ASSERT (report.size() <= PIPE_BUF);
+
+    // if the reader has gone away then open fails with ENXIO, which is not fatal to the agent
+    int fd = open(readyFifo.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENXIO) {
+            TU_LOG_WARN << "no reader for ready fifo " << readyFifo;
+            return {};
+        }
+        return tempo_utils::PosixStatus::last("failed to open ready fifo");
+    }
+    auto ret = write(fd, report.data(), report.size());
+    close(fd);
+    if (ret < 0)
+        return tempo_utils::PosixStatus::last("failed to write ready fifo");
+    return {};
+}
+
 static void
 on_termination_signal(uv_signal_t *handle, int signal)
 {
@@ -67,8 +101,15 @@ chord_agent::chord_agent(int argc, const char *argv[])
         {"temporarySession", {}, "agent will shutdown automatically after a period of inactivity", {}},
         {"idleTimeout", {}, "shutdown the agent after the specified amount of time has elapsed", "SECONDS"},
         {"registrationTimeout", {}, "abandon the execution if not registered after the specified amount of time has elapsed", "SECONDS"},
+        {"machinePoolSize", {}, "keep the specified number of started machines waiting to be assigned", "COUNT"},
+        {"machinePoolMaxIdleAge", {}, "replace pooled machines which have waited longer than the specified amount of time", "SECONDS"},
         {"logFile", {}, "path to log file", "FILE"},
         {"pidFile", {}, "record the agent process id in the specified pid file", "FILE"},
+        {"readyFifo", {}, "report readiness to the specified fifo once the agent is listening", "FILE"},
+        {"machineLogDirectory", {}, "write machine output to rotating log files in the specified directory", "DIR"},
+        {"machineLogRate", {}, "drop machine output exceeding the specified number of lines per second", "LINES"},
+        {"assemblyStoreDirectory", {}, "share verified assemblies between machines in the specified directory", "DIR"},
+        {"assemblyStoreSize", {}, "limit the assembly store to the specified number of megabytes", "MB"},
     };
 
     std::vector<tempo_command::Grouping> groupings = {
@@ -84,8 +125,15 @@ chord_agent::chord_agent(int argc, const char *argv[])
         {"temporarySession", {"--temporary-session"}, tempo_command::GroupingType::NO_ARGUMENT},
         {"idleTimeout", {"--idle-timeout"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"registrationTimeout", {"--registration-timeout"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"machinePoolSize", {"--machine-pool-size"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"machinePoolMaxIdleAge", {"--machine-pool-max-idle-age"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"logFile", {"--log-file"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"pidFile", {"--pid-file"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"readyFifo", {"--ready-fifo"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"machineLogDirectory", {"--machine-log-directory"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"machineLogRate", {"--machine-log-rate"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"assemblyStoreDirectory", {"--assembly-store"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"assemblyStoreSize", {"--assembly-store-size"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"help", {"-h", "--help"}, tempo_command::GroupingType::HELP_FLAG},
         {"version", {"--version"}, tempo_command::GroupingType::VERSION_FLAG},
     };
@@ -103,8 +151,15 @@ chord_agent::chord_agent(int argc, const char *argv[])
         {tempo_command::MappingType::TRUE_IF_INSTANCE, "temporarySession"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "idleTimeout"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "registrationTimeout"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "machinePoolSize"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "machinePoolMaxIdleAge"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "logFile"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "pidFile"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "readyFifo"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "machineLogDirectory"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "machineLogRate"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "assemblyStoreDirectory"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "assemblyStoreSize"},
     };
 
     std::vector<tempo_command::Mapping> argMappings = {
@@ -244,6 +299,11 @@ chord_agent::chord_agent(int argc, const char *argv[])
         TU_RETURN_IF_NOT_OK (endpointWriter.getStatus());
     }
 
+    // if ready fifo is specified, then report that the agent is listening
+    if (!agentConfig.readyFifo.empty()) {
+        TU_RETURN_IF_NOT_OK (report_readiness(agentConfig.readyFifo, listenLocation));
+    }
+
     // catch SIGTERM indicating request to cleanly shutdown
     uv_signal_t sigterm;
     uv_signal_init(&loop, &sigterm);
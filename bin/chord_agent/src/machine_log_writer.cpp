@@ -0,0 +1,327 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+
+#include <chord_agent/agent_result.h>
+#include <chord_agent/machine_log_writer.h>
+#include <tempo_utils/log_stream.h>
+#include <tempo_utils/posix_result.h>
+
+chord_agent::MachineLogWriter::MachineLogWriter(const MachineLogWriterOptions &options)
+    : m_options(options),
+      m_numPendingLines(0),
+      m_linesWritten(0),
+      m_linesDropped(0),
+      m_numOpenFiles(0),
+      m_running(false),
+      m_stopping(false)
+{
+    TU_ASSERT (!m_options.logDirectory.empty());
+    TU_ASSERT (m_options.maxRotatedFiles >= 0);
+}
+
+chord_agent::MachineLogWriter::~MachineLogWriter()
+{
+    shutdown();
+}
+
+void
+chord_agent::run_log_writer(void *arg)
+{
+    auto *writer = (MachineLogWriter *) arg;
+    writer->runWriter();
+}
+
+/**
+ * Create the log directory and start the writer thread.
+ *
+ * @return Ok status if the writer started, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_agent::MachineLogWriter::initialize()
+{
+    absl::MutexLock locker(&m_lock);
+
+    if (m_running || m_stopping)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "machine log writer is already initialized");
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_options.logDirectory, ec);
+    if (ec)
+        return AgentStatus::forCondition(AgentCondition::kInvalidConfiguration,
+            "failed to create machine log directory {}: {}", m_options.logDirectory.string(), ec.message());
+
+    auto ret = uv_thread_create(&m_thread, run_log_writer, this);
+    if (ret != 0)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "failed to create machine log writer thread: {}", uv_strerror(ret));
+    m_running = true;
+
+    return {};
+}
+
+/**
+ * Queue lines of output from the specified machine to be written to its log file. If the queue
+ * is full then the lines are dropped rather than blocking the caller.
+ *
+ * @param machineName The machine which produced the output.
+ * @param lines The lines of output, without line terminators.
+ * @return true if the lines were queued, otherwise false if the lines were dropped.
+ */
+bool
+chord_agent::MachineLogWriter::append(std::string_view machineName, std::vector<std::string> &&lines)
+{
+    if (lines.empty())
+        return true;
+
+    absl::MutexLock locker(&m_lock);
+
+    if (!m_running || m_stopping || m_numPendingLines + lines.size() > m_options.maxQueuedLines) {
+        m_linesDropped += lines.size();
+        return false;
+    }
+
+    m_numPendingLines += lines.size();
+
+    // coalesce consecutive batches from the same machine
+    if (!m_pending.empty() && m_pending.back().machineName == machineName && !m_pending.back().close) {
+        auto &pending = m_pending.back().lines;
+        pending.insert(pending.end(),
+            std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+    } else {
+        m_pending.push_back({std::string(machineName), std::move(lines)});
+    }
+
+    return true;
+}
+
+/**
+ * Close the log file for the specified machine once every line queued before the call has been
+ * written. The writer forgets the file, so a machine which has exited or has been renamed does not
+ * hold a file descriptor for the lifetime of the agent. Lines appended for the machine afterwards
+ * reopen the file.
+ *
+ * @param machineName The machine whose log file is closed.
+ */
+void
+chord_agent::MachineLogWriter::closeLog(std::string_view machineName)
+{
+    absl::MutexLock locker(&m_lock);
+    if (!m_running || m_stopping)
+        return;
+    m_pending.push_back({std::string(machineName), {}, true});
+}
+
+tu_uint64
+chord_agent::MachineLogWriter::getLinesWritten() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_linesWritten;
+}
+
+tu_uint64
+chord_agent::MachineLogWriter::getLinesDropped() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_linesDropped;
+}
+
+tu_uint32
+chord_agent::MachineLogWriter::getNumOpenFiles() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_numOpenFiles;
+}
+
+/**
+ * Get the path of the log file for the specified machine. Characters in the machine name which
+ * are not safe to use in a file name are replaced with underscores.
+ *
+ * @param machineName The machine name.
+ * @return The log file path.
+ */
+std::filesystem::path
+chord_agent::MachineLogWriter::getLogFilePath(std::string_view machineName) const
+{
+    std::string fileName(machineName);
+    for (auto &c : fileName) {
+        if (!absl::ascii_isalnum(c) && c != '-' && c != '_' && c != '.') {
+            c = '_';
+        }
+    }
+    return m_options.logDirectory / absl::StrCat(fileName, ".log");
+}
+
+void
+chord_agent::MachineLogWriter::runWriter()
+{
+    auto hasPendingOrStopping = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock) {
+        return !m_pending.empty() || m_stopping;
+    };
+
+    for (;;) {
+        std::vector<LogBatch> batches;
+        bool stopping;
+        {
+            absl::MutexLock locker(&m_lock);
+            m_lock.AwaitWithTimeout(absl::Condition(&hasPendingOrStopping), m_options.flushInterval);
+            batches.swap(m_pending);
+            m_numPendingLines = 0;
+            stopping = m_stopping;
+        }
+
+        tu_uint64 numWritten = 0;
+        for (const auto &batch : batches) {
+            if (batch.close) {
+                closeLogFile(batch.machineName);
+                continue;
+            }
+            writeBatch(batch);
+            numWritten += batch.lines.size();
+        }
+
+        {
+            absl::MutexLock locker(&m_lock);
+            m_linesWritten += numWritten;
+            m_numOpenFiles = m_files.size();
+        }
+
+        if (stopping)
+            break;
+    }
+
+    closeLogFiles();
+
+    absl::MutexLock locker(&m_lock);
+    m_numOpenFiles = 0;
+}
+
+void
+chord_agent::MachineLogWriter::writeBatch(const LogBatch &batch)
+{
+    auto entry = m_files.find(batch.machineName);
+    if (entry == m_files.cend()) {
+        LogFile logFile;
+        auto status = openLogFile(batch.machineName, logFile);
+        if (status.notOk()) {
+            TU_LOG_WARN << "failed to open log file for machine " << batch.machineName << ": " << status;
+            return;
+        }
+        entry = m_files.insert_or_assign(batch.machineName, logFile).first;
+    }
+    auto &logFile = entry->second;
+
+    // write the whole batch with a single system call
+    std::string buffer;
+    for (const auto &line : batch.lines) {
+        absl::StrAppend(&buffer, line, "\n");
+    }
+
+    std::string_view remaining(buffer);
+    while (!remaining.empty()) {
+        auto ret = write(logFile.fd, remaining.data(), remaining.size());
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            TU_LOG_WARN << "failed to write log file for machine " << batch.machineName
+                << ": " << strerror(errno);
+            return;
+        }
+        remaining.remove_prefix(ret);
+    }
+    logFile.size += buffer.size();
+
+    if (logFile.size >= m_options.maxFileBytes) {
+        rotateLogFile(batch.machineName, logFile);
+    }
+}
+
+tempo_utils::Status
+chord_agent::MachineLogWriter::openLogFile(const std::string &machineName, LogFile &logFile)
+{
+    auto logFilePath = getLogFilePath(machineName);
+    auto fd = open(logFilePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return tempo_utils::PosixStatus::last("failed to open log file");
+    auto offset = lseek(fd, 0, SEEK_END);
+    logFile.fd = fd;
+    logFile.size = offset < 0 ? 0 : offset;
+    return {};
+}
+
+/**
+ * Rotate the log file for the specified machine. The current log file becomes `<name>.log.1`,
+ * any previously rotated files are shifted up by one, and the oldest file is removed.
+ */
+void
+chord_agent::MachineLogWriter::rotateLogFile(const std::string &machineName, LogFile &logFile)
+{
+    close(logFile.fd);
+    logFile.fd = -1;
+
+    auto logFilePath = getLogFilePath(machineName);
+    std::error_code ec;
+    if (m_options.maxRotatedFiles > 0) {
+        for (int i = m_options.maxRotatedFiles - 1; i > 0; i--) {
+            auto src = absl::StrCat(logFilePath.string(), ".", i);
+            auto dst = absl::StrCat(logFilePath.string(), ".", i + 1);
+            std::filesystem::rename(src, dst, ec);
+        }
+        std::filesystem::rename(logFilePath, absl::StrCat(logFilePath.string(), ".1"), ec);
+    } else {
+        std::filesystem::remove(logFilePath, ec);
+    }
+
+    auto status = openLogFile(machineName, logFile);
+    if (status.notOk()) {
+        TU_LOG_WARN << "failed to reopen log file for machine " << machineName << ": " << status;
+        m_files.erase(machineName);
+    }
+}
+
+void
+chord_agent::MachineLogWriter::closeLogFile(const std::string &machineName)
+{
+    auto entry = m_files.find(machineName);
+    if (entry == m_files.cend())
+        return;
+    if (entry->second.fd >= 0) {
+        close(entry->second.fd);
+    }
+    m_files.erase(entry);
+}
+
+void
+chord_agent::MachineLogWriter::closeLogFiles()
+{
+    for (auto &entry : m_files) {
+        if (entry.second.fd >= 0) {
+            close(entry.second.fd);
+        }
+    }
+    m_files.clear();
+}
+
+/**
+ * Stop the writer thread once every queued line has been written.
+ *
+ * @return Ok status.
+ */
+tempo_utils::Status
+chord_agent::MachineLogWriter::shutdown()
+{
+    {
+        absl::MutexLock locker(&m_lock);
+        if (!m_running || m_stopping)
+            return {};
+        m_stopping = true;
+    }
+    uv_thread_join(&m_thread);
+    return {};
+}
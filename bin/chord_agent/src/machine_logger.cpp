@@ -1,10 +1,111 @@
 
+#include <algorithm>
+
+#include <absl/strings/str_cat.h>
+
 #include <chord_agent/machine_logger.h>
 #include <tempo_utils/log_stream.h>
 
-chord_agent::MachineLogger::MachineLogger(const std::string &machineName, uv_loop_t *loop)
-    : m_machineName(machineName),
-      m_loop(loop)
+chord_agent::TokenBucket::TokenBucket(double ratePerSecond, double burst)
+    : m_ratePerSecond(ratePerSecond),
+      m_burst(burst),
+      m_tokens(burst),
+      m_lastRefillMillis(0)
+{
+    TU_ASSERT (m_ratePerSecond > 0);
+    TU_ASSERT (m_burst >= 1);
+}
+
+/**
+ * Take a token from the bucket, refilling the bucket first based on the time elapsed since the
+ * previous refill.
+ *
+ * @param nowMillis The current time in milliseconds.
+ * @return true if a token was taken, otherwise false if the bucket is empty.
+ */
+bool
+chord_agent::TokenBucket::tryTake(tu_uint64 nowMillis)
+{
+    if (nowMillis > m_lastRefillMillis) {
+        auto elapsed = static_cast<double>(nowMillis - m_lastRefillMillis);
+        m_tokens = std::min(m_burst, m_tokens + elapsed * m_ratePerSecond / 1000.0);
+        m_lastRefillMillis = nowMillis;
+    }
+    if (m_tokens < 1.0)
+        return false;
+    m_tokens -= 1.0;
+    return true;
+}
+
+chord_agent::LineFramer::LineFramer(size_t maxLineLength)
+    : m_maxLineLength(maxLineLength)
+{
+    TU_ASSERT (m_maxLineLength > 0);
+}
+
+/**
+ * Append data to the framer and append each complete line to `lines`. Any trailing partial line
+ * is retained until more data is appended or the framer is flushed.
+ *
+ * @param data The data read from the stream.
+ * @param lines The vector which receives complete lines, without line terminators.
+ */
+void
+chord_agent::LineFramer::append(std::string_view data, std::vector<std::string> &lines)
+{
+    while (!data.empty()) {
+        auto newline = data.find('\n');
+        auto chunk = data.substr(0, newline);
+
+        // split the line if it would exceed the maximum line length
+        while (m_partial.size() + chunk.size() > m_maxLineLength) {
+            auto count = m_maxLineLength - m_partial.size();
+            m_partial.append(chunk.substr(0, count));
+            lines.push_back(std::move(m_partial));
+            m_partial.clear();
+            chunk.remove_prefix(count);
+        }
+        m_partial.append(chunk);
+
+        if (newline == std::string_view::npos)
+            break;
+        if (!m_partial.empty() && m_partial.back() == '\r') {
+            m_partial.pop_back();
+        }
+        lines.push_back(std::move(m_partial));
+        m_partial.clear();
+        data.remove_prefix(newline + 1);
+    }
+}
+
+/**
+ * Append the trailing partial line, if any, to `lines`.
+ *
+ * @param lines The vector which receives the partial line.
+ */
+void
+chord_agent::LineFramer::flush(std::vector<std::string> &lines)
+{
+    if (m_partial.empty())
+        return;
+    lines.push_back(std::move(m_partial));
+    m_partial.clear();
+}
+
+chord_agent::MachineLogger::MachineLogger(
+    const std::string &machineName,
+    uv_loop_t *loop,
+    MachineLogWriter *writer,
+    const MachineLoggerOptions &options)
+    : m_loop(loop),
+      m_writer(writer),
+      m_options(options),
+      m_machineName(machineName),
+      m_outFramer(options.maxLineLength),
+      m_errFramer(options.maxLineLength),
+      m_bucket(options.linesPerSecond, options.burstLines),
+      m_linesDropped(0),
+      m_pendingDropped(0)
 {
     TU_ASSERT (!m_machineName.empty());
     TU_ASSERT (m_loop != nullptr);
@@ -17,6 +118,9 @@ chord_agent::MachineLogger::MachineLogger(const std::string &machineName, uv_loo
 chord_agent::MachineLogger::~MachineLogger()
 {
     closeLoggerUnconditionally();
+    for (auto *buffer : m_freeBuffers) {
+        free(buffer);
+    }
 }
 
 tempo_utils::Status
@@ -51,12 +155,88 @@ chord_agent::MachineLogger::initialize()
     return {};
 }
 
-static void
-on_buf_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t *buf)
+char *
+chord_agent::MachineLogger::takeBuffer()
+{
+    if (!m_freeBuffers.empty()) {
+        auto *buffer = m_freeBuffers.back();
+        m_freeBuffers.pop_back();
+        return buffer;
+    }
+    auto *buffer = (char *) malloc(kMachineLoggerReadBufferSize);
+    TU_ASSERT (buffer != nullptr);
+    return buffer;
+}
+
+void
+chord_agent::MachineLogger::releaseBuffer(char *buffer)
+{
+    if (buffer == nullptr)
+        return;
+    if (m_freeBuffers.size() < kMachineLoggerMaxFreeBuffers) {
+        m_freeBuffers.push_back(buffer);
+    } else {
+        free(buffer);
+    }
+}
+
+void
+chord_agent::on_buf_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf)
+{
+    auto *logger = (chord_agent::MachineLogger *) handle->data;
+    buf->base = logger->takeBuffer();
+    buf->len = kMachineLoggerReadBufferSize;
+}
+
+/**
+ * Rate limit the specified lines and pass the accepted lines to the log writer. When lines have
+ * been dropped a marker line recording the number of dropped lines is emitted as soon as the
+ * rate limit admits another line, or when the end of the stream is reached.
+ */
+void
+chord_agent::MachineLogger::emitLines(std::string_view tag, std::vector<std::string> &lines, bool endOfStream)
 {
-    buf->base = (char *) malloc(suggested_size);
-    TU_ASSERT (buf->base != nullptr);
-    buf->len = suggested_size;
+    if (lines.empty() && !(endOfStream && m_pendingDropped > 0))
+        return;
+
+    auto now = uv_now(m_loop);
+    std::vector<std::string> accepted;
+    accepted.reserve(lines.size() + 1);
+    for (auto &line : lines) {
+        if (!m_bucket.tryTake(now)) {
+            m_linesDropped++;
+            m_pendingDropped++;
+            continue;
+        }
+        if (m_pendingDropped > 0) {
+            accepted.push_back(absl::StrCat("[", m_pendingDropped, " lines dropped]"));
+            m_pendingDropped = 0;
+        }
+        accepted.push_back(absl::StrCat(tag, " ", line));
+    }
+    lines.clear();
+
+    // no more lines will follow, so the marker is emitted regardless of the rate limit
+    if (endOfStream && m_pendingDropped > 0) {
+        accepted.push_back(absl::StrCat("[", m_pendingDropped, " lines dropped]"));
+        m_pendingDropped = 0;
+    }
+
+    std::string machineName;
+    {
+        absl::MutexLock locker(&m_lock);
+        machineName = m_machineName;
+    }
+
+    if (m_writer != nullptr) {
+        m_writer->append(machineName, std::move(accepted));
+        return;
+    }
+
+    // if there is no log writer then fall back to the agent log
+    for (const auto &line : accepted) {
+        TU_LOG_INFO << "machine " << machineName << " " << line;
+    }
 }
 
 void
@@ -64,12 +244,33 @@ chord_agent::on_pipe_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *bu
 {
     auto *logger = (chord_agent::MachineLogger *) stream->data;
 
+    std::string_view tag;
+    LineFramer *framer;
+    if (stream == (uv_stream_t *) &logger->m_err) {
+        tag = "ERR";
+        framer = &logger->m_errFramer;
+    } else {
+        tag = "OUT";
+        framer = &logger->m_outFramer;
+    }
+
+    std::vector<std::string> lines;
+
+    if (nread > 0) {
+        framer->append(std::string_view(buf->base, nread), lines);
+    }
+
+    // the buffer is always returned to the pool, even if the read failed
+    logger->releaseBuffer(buf->base);
+
     // empty read, nothing to do
     if (nread == 0)
         return;
 
-    // if we reached the end of the stream, then close it
+    // if we reached the end of the stream, then flush the partial line and close the stream
     if (nread == UV_EOF) {
+        framer->flush(lines);
+        logger->emitLines(tag, lines, true);
         logger->closeLogger(stream);
         return;
     }
@@ -81,16 +282,7 @@ chord_agent::on_pipe_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *bu
         return;
     }
 
-    std::string s(buf->base, nread);
-
-    // log the contents
-    if (stream == (uv_stream_t *) &logger->m_err) {
-        TU_LOG_INFO << "machine " << logger->m_machineName << " ERR ctx " << stream->data << ": " << s;
-    } else if (stream == (uv_stream_t *) &logger->m_out) {
-        TU_LOG_INFO << "machine " << logger->m_machineName << " OUT ctx " << stream->data << ": " << s;
-    } else {
-        TU_LOG_INFO << "machine " << logger->m_machineName << " UNKNOWN ctx " << stream->data << ": " << s;
-    }
+    logger->emitLines(tag, lines);
 }
 
 tempo_utils::Status
@@ -126,6 +318,12 @@ chord_agent::MachineLogger::closeLogger(uv_stream_t *stream)
         uv_close((uv_handle_t *) &m_err, nullptr);
         m_errIsClosed = true;
     }
+
+    // the machine produces no more output once both streams are closed, so release its log file
+    if (m_outIsClosed && m_errIsClosed && m_writer != nullptr) {
+        absl::MutexLock locker(&m_lock);
+        m_writer->closeLog(m_machineName);
+    }
     return {};
 }
 
@@ -138,9 +336,30 @@ chord_agent::MachineLogger::closeLoggerUnconditionally()
     if (!m_errIsClosed) {
         uv_close((uv_handle_t *) &m_err, nullptr);
     }
+    if ((!m_outIsClosed || !m_errIsClosed) && m_writer != nullptr) {
+        absl::MutexLock locker(&m_lock);
+        m_writer->closeLog(m_machineName);
+    }
+    m_outIsClosed = true;
+    m_errIsClosed = true;
     return {};
 }
 
+void
+chord_agent::MachineLogger::setMachineName(std::string_view machineName)
+{
+    TU_ASSERT (!machineName.empty());
+    absl::MutexLock locker(&m_lock);
+    if (m_machineName == machineName)
+        return;
+
+    // output is written to the log file for the new name, so release the file for the old name
+    if (m_writer != nullptr) {
+        m_writer->closeLog(m_machineName);
+    }
+    m_machineName = machineName;
+}
+
 uv_stream_t *
 chord_agent::MachineLogger::getOutput() const
 {
@@ -152,3 +371,9 @@ chord_agent::MachineLogger::getError() const
 {
     return (uv_stream_t *) &m_err;
 }
+
+tu_uint64
+chord_agent::MachineLogger::getLinesDropped() const
+{
+    return m_linesDropped;
+}
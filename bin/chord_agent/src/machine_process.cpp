@@ -22,7 +22,8 @@ chord_agent::MachineProcess::MachineProcess(
     m_lock = new absl::Mutex();
     memset(&m_process, 0, sizeof(uv_process_t));
     m_process.data = this;
-    m_logger = std::make_unique<MachineLogger>(m_machineName, m_supervisor->getLoop());
+    m_logger = std::make_unique<MachineLogger>(m_machineName, m_supervisor->getLoop(),
+        m_supervisor->getLogWriter(), m_supervisor->getLoggerOptions());
 }
 
 chord_agent::MachineProcess::~MachineProcess()
@@ -66,6 +67,11 @@ chord_agent::MachineProcess::create(
     // determine the pem root CA bundle file
     builder.appendArg("--ca-bundle", options.pemRootCABundleFile.string());
 
+    // determine the shared assembly store
+    if (!options.assemblyStoreDirectory.empty()) {
+        builder.appendArg("--assembly-store", options.assemblyStoreDirectory.string());
+    }
+
     // append start-suspended flag
     if (options.startSuspended) {
         builder.appendArg("--start-suspended");
@@ -85,6 +91,64 @@ chord_agent::MachineProcess::create(
         std::string(machineName), invoker, supervisor));
 }
 
+/**
+ * Create a pooled machine process. A pooled machine is started without a main package, and waits
+ * to be assigned a machine name, main package, and configuration by the supervisor.
+ *
+ * @param pooledName The name of the machine while it is in the pool.
+ * @param supervisorEndpoint The supervisor endpoint.
+ * @param supervisor The supervisor.
+ * @param options The machine options. The main arguments and requested ports are ignored.
+ * @return The machine process.
+ */
+tempo_utils::Result<std::shared_ptr<chord_agent::MachineProcess>>
+chord_agent::MachineProcess::createPooled(
+    std::string_view pooledName,
+    const chord_common::TransportLocation &supervisorEndpoint,
+    MachineSupervisor *supervisor,
+    const MachineOptions &options)
+{
+    TU_ASSERT (!pooledName.empty());
+    TU_ASSERT (supervisorEndpoint.isValid());
+
+    std::filesystem::path machineExecutable;
+    if (!options.machineExecutable.empty()) {
+        machineExecutable = options.machineExecutable;
+    } else {
+        machineExecutable = CHORD_MACHINE_EXECUTABLE;
+    }
+
+    tempo_utils::ProcessBuilder builder(machineExecutable);
+    builder.appendArg("-n", pooledName);
+    builder.appendArg("--supervisor-endpoint", supervisorEndpoint.toString());
+
+    // determine the run directory
+    if (!options.runDirectory.empty()) {
+        builder.appendArg("--run-directory", options.runDirectory.string());
+    }
+
+    // determine the package directories
+    for (const auto &packageDirectory : options.packageCacheDirectories) {
+        builder.appendArg("--package-directory", packageDirectory.string());
+    }
+
+    // determine the pem root CA bundle file
+    builder.appendArg("--ca-bundle", options.pemRootCABundleFile.string());
+
+    // determine the shared assembly store
+    if (!options.assemblyStoreDirectory.empty()) {
+        builder.appendArg("--assembly-store", options.assemblyStoreDirectory.string());
+    }
+
+    // the main package and configuration are received when the machine is assigned
+    builder.appendArg("--pooled");
+
+    auto invoker = builder.toInvoker();
+
+    return std::shared_ptr<MachineProcess>(new MachineProcess(
+        std::string(pooledName), invoker, supervisor));
+}
+
 /**
  * Returns the machine name.
  *
@@ -93,9 +157,24 @@ chord_agent::MachineProcess::create(
 std::string
 chord_agent::MachineProcess::getMachineName() const
 {
+    absl::MutexLock locker(m_lock);
     return m_machineName;
 }
 
+/**
+ * Assigns a new name to a pooled machine when it is handed out by the supervisor.
+ *
+ * @param machineName The machine name.
+ */
+void
+chord_agent::MachineProcess::assign(std::string_view machineName)
+{
+    TU_ASSERT (!machineName.empty());
+    absl::MutexLock locker(m_lock);
+    m_machineName = machineName;
+    m_logger->setMachineName(machineName);
+}
+
 /**
  * Returns the current state of the machine.
  *
@@ -231,15 +310,18 @@ chord_agent::MachineProcess::terminate(int signal)
 void
 chord_agent::MachineProcess::release(tu_int64 status, int signal)
 {
+    std::string machineName;
+
     // update internal state while holding the lock
     {
         absl::MutexLock locker(m_lock);
         m_state = MachineState::Exited;
         m_exitStatus = status;
         m_exitSignal = signal;
+        machineName = m_machineName;
     }
 
     // signal the supervisor to release after releasing the lock
-    auto status_ = m_supervisor->release(m_machineName, status, signal);
-    TU_LOG_WARN_IF(status_.notOk()) << "failed to release machine " << m_machineName << ": " << status_;
+    auto status_ = m_supervisor->release(machineName, status, signal);
+    TU_LOG_WARN_IF(status_.notOk()) << "failed to release machine " << machineName << ": " << status_;
 }
\ No newline at end of file
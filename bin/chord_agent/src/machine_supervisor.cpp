@@ -1,9 +1,12 @@
 
+#include <algorithm>
+
 #include <grpcpp/create_channel.h>
 #include <grpcpp/security/credentials.h>
 #include <uv.h>
 
 #include <chord_agent/machine_supervisor.h>
+#include <tempo_utils/file_utilities.h>
 #include <tempo_utils/log_stream.h>
 
 #include "chord_agent/agent_result.h"
@@ -23,6 +26,10 @@ chord_agent::MachineSupervisor::MachineSupervisor(
 
 chord_agent::MachineSupervisor::~MachineSupervisor()
 {
+    // flush any machine output which is still queued
+    if (m_logWriter != nullptr) {
+        m_logWriter->shutdown();
+    }
 }
 
 static void
@@ -35,6 +42,45 @@ on_idle_timer(uv_timer_t *timer)
     }
 }
 
+/**
+ * Async callback which is called periodically to replace pooled machines which failed to start
+ * or have been idle for too long.
+ *
+ * @param timer The pool check timer.
+ */
+void
+chord_agent::on_pool_check(uv_timer_t *timer)
+{
+    auto *supervisor = (MachineSupervisor *) timer->data;
+    supervisor->expirePool();
+}
+
+/**
+ * Async callback which is called after a pooled machine is assigned, to start a replacement.
+ *
+ * @param async The pool refill handle.
+ */
+void
+chord_agent::on_pool_refill(uv_async_t *async)
+{
+    auto *supervisor = (MachineSupervisor *) async->data;
+    absl::MutexLock locker(&supervisor->m_lock);
+    supervisor->fillPool();
+}
+
+/**
+ * Async callback which is called periodically to evict the least recently used assemblies from
+ * the assembly store.
+ *
+ * @param timer The store trim timer.
+ */
+void
+chord_agent::on_store_trim(uv_timer_t *timer)
+{
+    auto *supervisor = (MachineSupervisor *) timer->data;
+    supervisor->trimStore();
+}
+
 /**
  * Initialize the machine supervisor.
  *
@@ -45,6 +91,15 @@ chord_agent::MachineSupervisor::initialize()
 {
     absl::MutexLock locker(&m_lock);
 
+    // if a machine log directory is configured, then start the machine log writer
+    if (!m_agentConfig.machineLogDirectory.empty()) {
+        MachineLogWriterOptions logWriterOptions;
+        logWriterOptions.logDirectory = m_agentConfig.machineLogDirectory;
+        auto logWriter = std::make_unique<MachineLogWriter>(logWriterOptions);
+        TU_RETURN_IF_NOT_OK (logWriter->initialize());
+        m_logWriter = std::move(logWriter);
+    }
+
     uv_timer_init(m_loop, &m_idle);
     m_idle.data = this;
 
@@ -53,11 +108,37 @@ chord_agent::MachineSupervisor::initialize()
     if (idleTimeoutMillis > 0) {
         uv_timer_start(&m_idle, on_idle_timer, idleTimeoutMillis, 0);
     }
+
+    uv_timer_init(m_loop, &m_storeTrim);
+    m_storeTrim.data = this;
+
+    // if an assembly store is configured, then open the store and start the store trim timer. the
+    // store must be opened before the pool is filled so pooled machines are passed the store.
+    if (m_agentConfig.assemblyStoreSize > 0 && !m_agentConfig.assemblyStoreDirectory.empty()) {
+        TU_ASSIGN_OR_RETURN (m_assemblyStore, chord_common::AssemblyStore::openOrCreate(
+            m_agentConfig.assemblyStoreDirectory));
+        auto trimIntervalMillis = absl::ToInt64Milliseconds(kAssemblyStoreTrimInterval);
+        uv_timer_start(&m_storeTrim, on_store_trim, 0, trimIntervalMillis);
+    }
+
+    uv_timer_init(m_loop, &m_poolCheck);
+    m_poolCheck.data = this;
+    uv_async_init(m_loop, &m_poolRefill, on_pool_refill);
+    m_poolRefill.data = this;
+
+    // if a machine pool is configured, then start the pooled machines and the pool check timer
+    if (m_agentConfig.machinePoolSize > 0) {
+        auto checkIntervalMillis = absl::ToInt64Milliseconds(kMachinePoolCheckInterval);
+        uv_timer_start(&m_poolCheck, on_pool_check, checkIntervalMillis, checkIntervalMillis);
+        fillPool();
+    }
+
     return {};
 }
 
 /**
- * Check whether the supervisor is idle (there are no machines running or waiting).
+ * Check whether the supervisor is idle (there are no machines running or waiting). Pooled machines
+ * which have not been assigned do not prevent the supervisor from being idle.
  *
  * @return true if the supervisor is idle, otherwise false.
  */
@@ -65,7 +146,7 @@ bool
 chord_agent::MachineSupervisor::isIdle()
 {
     absl::MutexLock locker(&m_lock);
-    return m_machines.empty() && m_waiting.empty();
+    return m_machines.size() == m_pooled.size() && m_waiting.empty();
 }
 
 /**
@@ -79,6 +160,34 @@ chord_agent::MachineSupervisor::getLoop() const
     return m_loop;
 }
 
+/**
+ * Get the machine lifecycle metrics. The metrics may be read without holding the lock.
+ *
+ * @return The supervisor metrics.
+ */
+const chord_agent::SupervisorMetrics *
+chord_agent::MachineSupervisor::getMetrics() const
+{
+    return &m_metrics;
+}
+
+chord_agent::MachineLogWriter *
+chord_agent::MachineSupervisor::getLogWriter() const
+{
+    return m_logWriter.get();
+}
+
+chord_agent::MachineLoggerOptions
+chord_agent::MachineSupervisor::getLoggerOptions() const
+{
+    MachineLoggerOptions options;
+    if (m_agentConfig.machineLogRate > 0) {
+        options.linesPerSecond = m_agentConfig.machineLogRate;
+        options.burstLines = std::max<double>(options.burstLines, m_agentConfig.machineLogRate);
+    }
+    return options;
+}
+
 /**
  * Async callback which is called when we time out waiting for a SignCertificates request
  * from the machine process.
@@ -89,6 +198,7 @@ void
 chord_agent::on_spawning_timeout(uv_timer_t *timer)
 {
     auto *ctx = (SpawningContext *) timer->data;
+    ctx->supervisor->m_metrics.timedOut++;
     ctx->supervisor->abandon(ctx->machineName);
 }
 
@@ -102,6 +212,7 @@ void
 chord_agent::on_signing_timeout(uv_timer_t *timer)
 {
     auto *ctx = (SigningContext *) timer->data;
+    ctx->supervisor->m_metrics.timedOut++;
     ctx->supervisor->abandon(ctx->machineName);
 }
 
@@ -115,9 +226,322 @@ void
 chord_agent::on_ready_timeout(uv_timer_t *timer)
 {
     auto *ctx = (ReadyContext *) timer->data;
+    ctx->supervisor->m_metrics.timedOut++;
     ctx->supervisor->abandon(ctx->machineName);
 }
 
+/**
+ * Spawn pooled machines until the pool contains the configured number of machines. Must be
+ * called while holding the lock.
+ */
+void
+chord_agent::MachineSupervisor::fillPool()
+{
+    if (m_shuttingDown)
+        return;
+
+    MachineOptions options;
+    options.machineExecutable = m_agentConfig.machineExecutable;
+    options.pemRootCABundleFile = m_agentConfig.pemRootCABundleFile;
+    if (m_assemblyStore != nullptr) {
+        options.assemblyStoreDirectory = m_assemblyStore->getStoreDirectory();
+    }
+
+    while (m_pooled.size() < m_agentConfig.machinePoolSize) {
+        auto pooledName = tempo_utils::generate_name("pooled-XXXXXXXX");
+        if (m_machines.contains(pooledName))
+            continue;
+
+        auto createPooledResult = MachineProcess::createPooled(
+            pooledName, m_supervisorEndpoint, this, options);
+        if (createPooledResult.isStatus()) {
+            TU_LOG_WARN << "failed to create pooled machine: " << createPooledResult.getStatus();
+            return;
+        }
+        auto machine = createPooledResult.getResult();
+
+        auto spawnStatus = machine->spawn();
+        if (spawnStatus.notOk()) {
+            TU_LOG_WARN << "failed to spawn pooled machine: " << spawnStatus;
+            return;
+        }
+        machine->setState(MachineState::Starting);
+
+        auto pooled = std::make_unique<PooledContext>();
+        pooled->pooledName = pooledName;
+        pooled->spawnTime = absl::Now();
+        pooled->idleSince = absl::InfiniteFuture();
+
+        m_machines[pooledName] = std::move(machine);
+        m_pooled[pooledName] = std::move(pooled);
+        m_metrics.spawned++;
+
+        TU_LOG_V << "spawned pooled machine " << pooledName;
+    }
+}
+
+/**
+ * Terminate pooled machines which did not start within the registration timeout, or which have
+ * been idle longer than the maximum idle age, and start replacements.
+ */
+void
+chord_agent::MachineSupervisor::expirePool()
+{
+    absl::MutexLock locker(&m_lock);
+
+    auto now = absl::Now();
+    auto maxIdleAge = m_agentConfig.machinePoolMaxIdleAge;
+
+    std::vector<std::string> expired;
+    for (const auto &entry : m_pooled) {
+        const auto &pooled = entry.second;
+        if (pooled->waiter == nullptr) {
+            if (now - pooled->spawnTime > m_agentConfig.registrationTimeout) {
+                expired.push_back(entry.first);
+                m_metrics.timedOut++;
+            }
+        } else if (maxIdleAge > absl::ZeroDuration() && now - pooled->idleSince > maxIdleAge) {
+            expired.push_back(entry.first);
+        }
+    }
+
+    for (const auto &pooledName : expired) {
+        auto node = m_pooled.extract(pooledName);
+        auto &pooled = node.mapped();
+        if (pooled->waiter != nullptr) {
+            pooled->waiter->onStatus(AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+                "pooled machine expired"));
+        }
+
+        auto &machine = m_machines.at(pooledName);
+        auto waiting = std::make_unique<WaitingContext>();
+        waiting->waiter = std::make_shared<OnInternalTerminate>();
+        m_waiting[pooledName] = std::move(waiting);
+
+        TU_LOG_V << "expiring pooled machine " << pooledName;
+        m_metrics.abandoned++;
+
+        auto status = machine->terminate(SIGTERM);
+        TU_LOG_WARN_IF (status.notOk()) << "failed to terminate pooled machine " << pooledName << ": " << status;
+    }
+
+    fillPool();
+}
+
+/**
+ * Evict the least recently used assemblies until the assembly store fits within the configured
+ * size. The store is only modified on disk, so the lock is not required.
+ */
+void
+chord_agent::MachineSupervisor::trimStore()
+{
+    if (m_assemblyStore == nullptr)
+        return;
+
+    auto trimResult = m_assemblyStore->trim(m_agentConfig.assemblyStoreSize);
+    if (trimResult.isStatus()) {
+        TU_LOG_WARN << "failed to trim assembly store: " << trimResult.getStatus();
+        return;
+    }
+    auto stats = trimResult.getResult();
+    if (stats.evictedObjects > 0) {
+        TU_LOG_V << "evicted " << stats.evictedObjects << " assemblies (" << stats.evictedBytes
+            << " bytes) from assembly store, " << stats.storedObjects << " assemblies ("
+            << stats.storedBytes << " bytes) remaining";
+    }
+}
+
+/**
+ * Remove the pooled machine which has been idle the longest from the pool. Must be called while
+ * holding the lock.
+ *
+ * @return The pooled context, or nullptr if there is no idle pooled machine.
+ */
+std::unique_ptr<chord_agent::PooledContext>
+chord_agent::MachineSupervisor::takeIdlePooled()
+{
+    const PooledContext *oldest = nullptr;
+    for (const auto &entry : m_pooled) {
+        const auto &pooled = entry.second;
+        if (pooled->waiter == nullptr)
+            continue;
+        if (oldest == nullptr || pooled->idleSince < oldest->idleSince) {
+            oldest = pooled.get();
+        }
+    }
+    if (oldest == nullptr)
+        return {};
+    auto node = m_pooled.extract(oldest->pooledName);
+    return std::move(node.mapped());
+}
+
+/**
+ * Mark the pooled machine as idle. The waiter is completed when the machine is assigned to a
+ * CreateMachine request.
+ *
+ * @param pooledName The name of the pooled machine.
+ * @param waiter The waiter which will be completed with the machine assignment.
+ * @return Ok status if the operation completed successfully, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_agent::MachineSupervisor::awaitAssignment(
+    std::string_view pooledName,
+    std::shared_ptr<OnSupervisorAssign> waiter)
+{
+    TU_LOG_INFO << "awaitAssignment " << pooledName;
+
+    absl::MutexLock locker(&m_lock);
+
+    if (m_shuttingDown)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "supervisor is shutting down");
+
+    auto entry = m_pooled.find(pooledName);
+    if (entry == m_pooled.cend())
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "machine '{}' is not pooled", pooledName);
+    auto &pooled = entry->second;
+    if (pooled->waiter != nullptr)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "machine '{}' is already awaiting assignment", pooledName);
+
+    pooled->waiter = std::move(waiter);
+    pooled->idleSince = absl::Now();
+
+    TU_LOG_V << "pooled machine " << pooledName << " is idle";
+
+    return {};
+}
+
+static chord_invoke::PortType
+to_invoke_port_type(chord_common::PortType portType)
+{
+    switch (portType) {
+        case chord_common::PortType::OneShot:
+            return chord_invoke::OneShot;
+        case chord_common::PortType::Streaming:
+            return chord_invoke::Streaming;
+        default:
+            return chord_invoke::InvalidPortType;
+    }
+}
+
+static chord_invoke::PortDirection
+to_invoke_port_direction(chord_common::PortDirection portDirection)
+{
+    switch (portDirection) {
+        case chord_common::PortDirection::Client:
+            return chord_invoke::Client;
+        case chord_common::PortDirection::Server:
+            return chord_invoke::Server;
+        case chord_common::PortDirection::BiDirectional:
+            return chord_invoke::BiDirectional;
+        default:
+            return chord_invoke::InvalidPortDirection;
+    }
+}
+
+/**
+ * Assign an idle pooled machine to a CreateMachine request. The pooled machine is renamed, and
+ * receives its main package and configuration in response to its AwaitAssignment request. The
+ * machine then continues with certificate signing as if it was freshly spawned. Must be called
+ * while holding the lock.
+ */
+tempo_utils::Status
+chord_agent::MachineSupervisor::assignPooled(
+    std::unique_ptr<PooledContext> pooled,
+    std::string_view machineName,
+    const zuri_packager::PackageSpecifier &mainPackage,
+    const MachineOptions &options,
+    std::shared_ptr<OnSupervisorSpawn> waiter)
+{
+    // track the machine before it is renamed, so if tracking fails the pooled machine is left
+    // unchanged and is returned to the pool
+    auto status = trackSpawning(machineName, waiter);
+    if (status.notOk()) {
+        auto pooledName = pooled->pooledName;
+        m_pooled[pooledName] = std::move(pooled);
+        return status;
+    }
+
+    auto node = m_machines.extract(pooled->pooledName);
+    auto machine = std::move(node.mapped());
+    machine->assign(machineName);
+    m_machines[machineName] = std::move(machine);
+
+    // unconditionally stop the idle timer
+    auto ret = uv_timer_stop(&m_idle);
+    if (ret < 0)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "failed to stop the idle timer: {}", uv_strerror(ret));
+
+    chord_invoke::AwaitAssignmentResult assignment;
+    assignment.set_machine_name(machineName);
+    assignment.set_main_package(mainPackage.toString());
+    for (const auto &arg : options.mainArguments) {
+        assignment.add_main_arguments(arg);
+    }
+    for (const auto &requestedPort : options.requestedPorts) {
+        auto *assignedPort = assignment.add_requested_ports();
+        assignedPort->set_protocol_url(requestedPort.getUrl().toString());
+        assignedPort->set_port_type(to_invoke_port_type(requestedPort.getType()));
+        assignedPort->set_port_direction(to_invoke_port_direction(requestedPort.getDirection()));
+    }
+    assignment.set_start_suspended(options.startSuspended);
+
+    // complete the AwaitAssignment call, which passes the assignment back to the pooled machine
+    MachineHandle handle;
+    handle.machineName = machineName;
+    pooled->waiter->onComplete(handle, assignment);
+
+    TU_LOG_V << "assigned pooled machine " << pooled->pooledName << " to " << machineName;
+
+    // replace the pooled machine in the background
+    uv_async_send(&m_poolRefill);
+
+    return {};
+}
+
+/**
+ * Create a spawning context for the machine and start the timer which abandons the machine if
+ * it does not send a SignCertificates request in time. Must be called while holding the lock.
+ */
+tempo_utils::Status
+chord_agent::MachineSupervisor::trackSpawning(
+    std::string_view machineName,
+    std::shared_ptr<OnSupervisorSpawn> waiter)
+{
+    int ret;
+
+    // create the spawning context
+    auto spawning = std::make_unique<SpawningContext>();
+    spawning->machineName = machineName;
+    spawning->phaseStart = absl::Now();
+    spawning->supervisor = this;
+    spawning->waiter = waiter;
+
+    // initialize the timer
+    ret = uv_timer_init(m_loop, &spawning->timeout);
+    if (ret < 0)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "failed to initialize the spawning timer: {}", uv_strerror(ret));
+    spawning->timeout.data = spawning.get();
+
+    // start the timer
+    auto registrationTimeoutMillis = absl::ToInt64Milliseconds(m_agentConfig.registrationTimeout);
+    ret = uv_timer_start(&spawning->timeout, on_spawning_timeout, registrationTimeoutMillis, 0);
+    if (ret < 0)
+        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+            "failed to start the spawning timer: {}", uv_strerror(ret));
+
+    // track the spawning ctx
+    m_spawning[machineName] = std::move(spawning);
+
+    TU_LOG_V << "spawning machine " << machineName;
+
+    return {};
+}
+
 /**
  * Create a machine by spawning a new subprocess.
  *
@@ -147,10 +571,23 @@ chord_agent::MachineSupervisor::spawnMachine(
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "machine '{}' already exists", machineName);
 
+    // hand out an idle pooled machine if one is available
+    auto pooled = takeIdlePooled();
+    if (pooled != nullptr)
+        return assignPooled(std::move(pooled), machineName, mainPackage, options, waiter);
+
+    // pass the agent configuration and the assembly store to the machine process
+    auto machineOptions = options;
+    machineOptions.machineExecutable = m_agentConfig.machineExecutable;
+    machineOptions.pemRootCABundleFile = m_agentConfig.pemRootCABundleFile;
+    if (m_assemblyStore != nullptr) {
+        machineOptions.assemblyStoreDirectory = m_assemblyStore->getStoreDirectory();
+    }
+
     // create the machine process
     std::shared_ptr<MachineProcess> machine;
     TU_ASSIGN_OR_RETURN (machine, MachineProcess::create(
-        machineName, mainPackage, m_supervisorEndpoint, this, options));
+        machineName, mainPackage, m_supervisorEndpoint, this, machineOptions));
 
     // spawn the machine process
     TU_RETURN_IF_NOT_OK (machine->spawn());
@@ -163,38 +600,14 @@ chord_agent::MachineSupervisor::spawnMachine(
         return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
             "failed to stop the idle timer: {}", uv_strerror(ret));
 
-    // create the spawning context
-    auto spawning = std::make_unique<SpawningContext>();
-    spawning->machineName = machineName;
-    spawning->supervisor = this;
-    spawning->waiter = waiter;
-
-    // initialize the timer
-    ret = uv_timer_init(m_loop, &spawning->timeout);
-    if (ret < 0)
-        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
-            "failed to initialize the spawning timer: {}", uv_strerror(ret));
-    spawning->timeout.data = spawning.get();
-
-    // start the timer
-    auto registrationTimeoutMillis = absl::ToInt64Milliseconds(m_agentConfig.registrationTimeout);
-    ret = uv_timer_start(&spawning->timeout, on_spawning_timeout, registrationTimeoutMillis, 0);
-    if (ret < 0)
-        return AgentStatus::forCondition(AgentCondition::kAgentInvariant,
-            "failed to start the spawning timer: {}", uv_strerror(ret));
-
     // change the machine state to Starting
     machine->setState(MachineState::Starting);
 
     // add the machine process to the machines map
     m_machines[machineName] = std::move(machine);
+    m_metrics.spawned++;
 
-    // track the spawning ctx
-    m_spawning[machineName] = std::move(spawning);
-
-    TU_LOG_V << "spawning machine " << machineName;
-
-    return {};
+    return trackSpawning(machineName, waiter);
 }
 
 /**
@@ -231,6 +644,9 @@ chord_agent::MachineSupervisor::requestCertificates(
             "failed to stop spawning timer: {}", uv_strerror(ret));
     uv_close((uv_handle_t *) &spawning->timeout, nullptr);
 
+    auto now = absl::Now();
+    m_metrics.spawningLatency.record(now - spawning->phaseStart);
+
     // complete the CreateMachine call, which passes the CSRs from SignCertificates back to the client
     MachineHandle handle;
     handle.machineName = spawning->machineName;
@@ -240,6 +656,7 @@ chord_agent::MachineSupervisor::requestCertificates(
     // create a new signing context
     auto signing = std::make_unique<SigningContext>();
     signing->machineName = machineName;
+    signing->phaseStart = now;
     signing->supervisor = this;
     signing->waiter = waiter;
 
@@ -298,6 +715,9 @@ chord_agent::MachineSupervisor::bindCertificates(
             "failed to stop signing timer: {}", uv_strerror(ret));
     uv_close((uv_handle_t *) &signing->timeout, nullptr);
 
+    auto now = absl::Now();
+    m_metrics.signingLatency.record(now - signing->phaseStart);
+
     // complete the SignCertificates call, which passes the certs from RunMachine back to the machine
     MachineHandle handle;
     handle.machineName = signing->machineName;
@@ -307,6 +727,7 @@ chord_agent::MachineSupervisor::bindCertificates(
     // create a new ready context
     auto ready = std::make_unique<ReadyContext>();
     ready->machineName = machineName;
+    ready->phaseStart = now;
     ready->supervisor = this;
     ready->waiter = waiter;
 
@@ -363,6 +784,9 @@ chord_agent::MachineSupervisor::startMachine(
             "failed to stop ready timer: {}", uv_strerror(ret));
     uv_close((uv_handle_t *) &ready->timeout, nullptr);
 
+    m_metrics.bindingLatency.record(absl::Now() - ready->phaseStart);
+    m_metrics.ready++;
+
     // change the machine state to Pending
     auto &machine = m_machines.at(machineName);
     machine->setState(MachineState::Running);
@@ -494,6 +918,7 @@ chord_agent::MachineSupervisor::abandon(std::string_view machineName)
     m_waiting[machineName] = std::move(waiting);
 
     TU_LOG_V << "abandoning machine " << machineName;
+    m_metrics.abandoned++;
 
     // terminate the machine
     return machine->terminate(SIGTERM);
@@ -533,8 +958,22 @@ chord_agent::MachineSupervisor::release(std::string_view machineName, tu_int64 s
         waiting->waiter->onComplete(exitStatus);
     }
 
+    // if the machine was pooled then fail the assignment waiter and start a replacement
+    if (m_pooled.contains(machineName)) {
+        auto node = m_pooled.extract(machineName);
+        auto &pooled = node.mapped();
+        if (pooled->waiter != nullptr) {
+            pooled->waiter->onStatus(AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+                "pooled machine exited"));
+        }
+        if (!m_shuttingDown) {
+            uv_async_send(&m_poolRefill);
+        }
+    }
+
     // remove the machine
     m_machines.extract(machineName);
+    m_metrics.released++;
 
     return {};
 }
@@ -575,6 +1014,25 @@ chord_agent::MachineSupervisor::shutdown()
     TU_ASSERT (!m_shuttingDown);
     m_shuttingDown = true;
     uv_close((uv_handle_t *) &m_idle, nullptr);
+    uv_close((uv_handle_t *) &m_poolCheck, nullptr);
+    uv_close((uv_handle_t *) &m_poolRefill, nullptr);
+    uv_close((uv_handle_t *) &m_storeTrim, nullptr);
+
+    // terminate any pooled machines which were never assigned
+    for (auto &entry : m_pooled) {
+        auto &pooled = entry.second;
+        if (pooled->waiter != nullptr) {
+            pooled->waiter->onStatus(AgentStatus::forCondition(AgentCondition::kAgentInvariant,
+                "supervisor is shutting down"));
+        }
+        auto waiting = std::make_unique<WaitingContext>();
+        waiting->waiter = std::make_shared<OnInternalTerminate>();
+        m_waiting[entry.first] = std::move(waiting);
+        auto status = m_machines.at(entry.first)->terminate(SIGTERM);
+        TU_LOG_WARN_IF (status.notOk()) << "failed to terminate pooled machine " << entry.first << ": " << status;
+    }
+    m_pooled.clear();
+
     return {};
 }
 
@@ -0,0 +1,153 @@
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include <chord_agent/supervisor_metrics.h>
+#include <tempo_utils/log_stream.h>
+
+chord_agent::LatencyHistogram::LatencyHistogram()
+    : m_count(0),
+      m_sumMicros(0),
+      m_minMicros(std::numeric_limits<tu_uint64>::max()),
+      m_maxMicros(0)
+{
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Get the index of the bucket which counts the specified value. Values which are too large for
+ * the histogram are counted in the last bucket.
+ *
+ * @param micros The value in microseconds.
+ * @return The bucket index.
+ */
+int
+chord_agent::LatencyHistogram::bucketIndex(tu_uint64 micros)
+{
+    constexpr tu_uint64 kMaxValue = (tu_uint64{1} << kMaxValueBits) - 1;
+    micros = std::min(micros, kMaxValue);
+    if (micros < kSubBucketCount)
+        return static_cast<int>(micros);
+
+    // keep the top kSubBucketBits bits of the value, the leading bit is implied by the shift
+    int shift = std::bit_width(micros) - kSubBucketBits;
+    int subBucket = static_cast<int>(micros >> shift) - kHalfSubBucketCount;
+    return kSubBucketCount + (shift - 1) * kHalfSubBucketCount + subBucket;
+}
+
+/**
+ * Get the largest value which is counted by the bucket at the specified index.
+ *
+ * @param index The bucket index.
+ * @return The inclusive upper bound of the bucket in microseconds.
+ */
+tu_uint64
+chord_agent::LatencyHistogram::bucketUpperBound(int index)
+{
+    TU_ASSERT (0 <= index && index < kNumBuckets);
+    if (index < kSubBucketCount)
+        return index;
+    auto offset = index - kSubBucketCount;
+    int shift = offset / kHalfSubBucketCount + 1;
+    tu_uint64 top = offset % kHalfSubBucketCount + kHalfSubBucketCount;
+    return ((top + 1) << shift) - 1;
+}
+
+void
+chord_agent::LatencyHistogram::record(absl::Duration latency)
+{
+    auto micros = static_cast<tu_uint64>(std::max<tu_int64>(absl::ToInt64Microseconds(latency), 0));
+    m_buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    auto min = m_minMicros.load(std::memory_order_relaxed);
+    while (micros < min && !m_minMicros.compare_exchange_weak(min, micros, std::memory_order_relaxed)) {}
+    auto max = m_maxMicros.load(std::memory_order_relaxed);
+    while (micros > max && !m_maxMicros.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {}
+}
+
+tu_uint64
+chord_agent::LatencyHistogram::getCount() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+tu_uint64
+chord_agent::LatencyHistogram::getSumMicros() const
+{
+    return m_sumMicros.load(std::memory_order_relaxed);
+}
+
+tu_uint64
+chord_agent::LatencyHistogram::getMinMicros() const
+{
+    if (getCount() == 0)
+        return 0;
+    return m_minMicros.load(std::memory_order_relaxed);
+}
+
+tu_uint64
+chord_agent::LatencyHistogram::getMaxMicros() const
+{
+    return m_maxMicros.load(std::memory_order_relaxed);
+}
+
+/**
+ * Get the upper bound of the bucket containing the value at the specified percentile.
+ *
+ * @param percentile The percentile in the range [0, 100].
+ * @return The value in microseconds, or 0 if the histogram is empty.
+ */
+tu_uint64
+chord_agent::LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+    auto count = getCount();
+    if (count == 0)
+        return 0;
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    auto target = std::max<tu_uint64>(static_cast<tu_uint64>(percentile / 100.0 * count + 0.5), 1);
+
+    tu_uint64 seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min(bucketUpperBound(i), getMaxMicros());
+    }
+    return getMaxMicros();
+}
+
+void
+chord_agent::LatencyHistogram::toProto(chord_invoke::LatencyHistogram *histogram) const
+{
+    histogram->set_count(getCount());
+    histogram->set_sum_micros(getSumMicros());
+    histogram->set_min_micros(getMinMicros());
+    histogram->set_max_micros(getMaxMicros());
+
+    // only nonempty buckets are included in the snapshot
+    for (int i = 0; i < kNumBuckets; i++) {
+        auto count = m_buckets[i].load(std::memory_order_relaxed);
+        if (count == 0)
+            continue;
+        auto *bucket = histogram->add_buckets();
+        bucket->set_upper_bound_micros(bucketUpperBound(i));
+        bucket->set_count(count);
+    }
+}
+
+void
+chord_agent::SupervisorMetrics::toProto(chord_invoke::GetSupervisorMetricsResult *result) const
+{
+    result->set_spawned(spawned.load(std::memory_order_relaxed));
+    result->set_ready(ready.load(std::memory_order_relaxed));
+    result->set_timed_out(timedOut.load(std::memory_order_relaxed));
+    result->set_abandoned(abandoned.load(std::memory_order_relaxed));
+    result->set_released(released.load(std::memory_order_relaxed));
+    spawningLatency.toProto(result->mutable_spawning_latency());
+    signingLatency.toProto(result->mutable_signing_latency());
+    bindingLatency.toProto(result->mutable_binding_latency());
+}
@@ -0,0 +1,234 @@
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include <chord_agent/agent_service.h>
+#include <tempo_test/tempo_test.h>
+#include <tempo_utils/tempdir_maker.h>
+
+static void
+on_stop_loop(uv_async_t *async)
+{
+    uv_close((uv_handle_t *) async, nullptr);
+    uv_stop(async->loop);
+}
+
+/**
+ * Hosts the AgentService on a unix socket and runs the agent loop in a separate thread. The test
+ * acts as both the client and the machine, the spawned machine process is the mock process which
+ * stays alive until it is deleted.
+ */
+class AgentServiceTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> tempdir;
+    chord_agent::AgentConfig agentConfig;
+    uv_loop_t loop;
+    uv_async_t stopLoop;
+    std::unique_ptr<chord_agent::AgentService> service;
+    std::thread loopThread;
+    std::string endpoint;
+    std::unique_ptr<grpc::Server> server;
+
+    void SetUp() override {
+        setenv("MOCK_PROCESS_WAIT", "1", 1);
+        tempdir = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_RAISE_IF_NOT_OK (tempdir->getStatus());
+
+        agentConfig.sessionName = "test";
+        agentConfig.runDirectory = tempdir->getTempdir();
+        agentConfig.machineExecutable = MOCK_PROCESS_EXECUTABLE;
+        agentConfig.registrationTimeout = absl::Seconds(30);
+        agentConfig.machinePoolSize = 0;
+        agentConfig.machineLogRate = 1000;
+        agentConfig.assemblyStoreSize = 0;
+
+        uv_loop_init(&loop);
+        uv_async_init(&loop, &stopLoop, on_stop_loop);
+
+        auto supervisorEndpoint = chord_common::TransportLocation::forUnix(
+            "test", tempdir->getTempdir() / "supervisor.sock");
+        service = std::make_unique<chord_agent::AgentService>(agentConfig, &loop);
+        TU_RAISE_IF_NOT_OK (service->initialize(supervisorEndpoint));
+        loopThread = std::thread([this]() { uv_run(&loop, UV_RUN_DEFAULT); });
+
+        endpoint = absl::StrCat("unix:", (tempdir->getTempdir() / "agent.sock").string());
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(endpoint, grpc::InsecureServerCredentials());
+        builder.RegisterService(service.get());
+        server = builder.BuildAndStart();
+    }
+
+    void TearDown() override {
+        server->Shutdown();
+        TU_RAISE_IF_NOT_OK (service->shutdown());
+        uv_async_send(&stopLoop);
+        loopThread.join();
+        unsetenv("MOCK_PROCESS_WAIT");
+        std::filesystem::remove_all(tempdir->getTempdir());
+    }
+
+    std::unique_ptr<chord_invoke::InvokeService::Stub> NewStub() {
+        auto channel = grpc::CreateChannel(endpoint, grpc::InsecureChannelCredentials());
+        return chord_invoke::InvokeService::NewStub(channel);
+    }
+
+    /**
+     * Wait until the supervisor has spawned the specified number of machines, at which point
+     * the spawned machines accept SignCertificates.
+     */
+    bool waitForSpawned(chord_invoke::InvokeService::Stub *stub, tu_uint64 spawned) {
+        auto deadline = absl::Now() + agentConfig.registrationTimeout;
+        while (absl::Now() < deadline) {
+            grpc::ClientContext ctx;
+            chord_invoke::GetSupervisorMetricsRequest request;
+            chord_invoke::GetSupervisorMetricsResult result;
+            auto status = stub->GetSupervisorMetrics(&ctx, request, &result);
+            if (status.ok() && result.spawned() >= spawned)
+                return true;
+            absl::SleepFor(absl::Milliseconds(10));
+        }
+        return false;
+    }
+};
+
+TEST_F(AgentServiceTests, CreateAndRunMachineBatchWithPartialFailure)
+{
+    auto stub = NewStub();
+
+    // the second machine requests a port with an invalid protocol url
+    chord_invoke::CreateMachineBatchRequest createBatchRequest;
+    auto *createMachine0 = createBatchRequest.add_machines();
+    createMachine0->set_machine_name("m0");
+    createMachine0->set_main_package(TEST1_SPECIFIER);
+    createMachine0->set_start_suspended(true);
+    auto *createMachine1 = createBatchRequest.add_machines();
+    createMachine1->set_machine_name("m1");
+    createMachine1->set_main_package(TEST1_SPECIFIER);
+    createMachine1->add_requested_ports()->set_protocol_url("");
+
+    chord_invoke::CreateMachineBatchResult createBatchResult;
+    auto createBatch = std::async(std::launch::async, [&]() {
+        grpc::ClientContext ctx;
+        return stub->CreateMachineBatch(&ctx, createBatchRequest, &createBatchResult);
+    });
+
+    // act as machine m0 and send SignCertificates, which completes when m0 is run
+    ASSERT_TRUE (waitForSpawned(stub.get(), 1));
+    chord_invoke::SignCertificatesRequest signRequest;
+    signRequest.set_machine_name("m0");
+    auto *declaredEndpoint = signRequest.add_declared_endpoints();
+    declaredEndpoint->set_endpoint_url("unix:/path/to/m0.sock");
+    declaredEndpoint->set_csr("m0 csr");
+    auto *declaredPort = signRequest.add_declared_ports();
+    declaredPort->set_protocol_url("dev.zuri.proto:test");
+    declaredPort->set_port_type(chord_invoke::Streaming);
+    declaredPort->set_port_direction(chord_invoke::BiDirectional);
+    declaredPort->set_endpoint_index(0);
+
+    chord_invoke::SignCertificatesResult signResult;
+    auto sign = std::async(std::launch::async, [&]() {
+        grpc::ClientContext ctx;
+        return stub->SignCertificates(&ctx, signRequest, &signResult);
+    });
+
+    auto createBatchStatus = createBatch.get();
+    ASSERT_TRUE (createBatchStatus.ok()) << createBatchStatus.error_message();
+    ASSERT_EQ (2, createBatchResult.machines_size());
+
+    const auto &createItem0 = createBatchResult.machines(0);
+    ASSERT_EQ (grpc::StatusCode::OK, createItem0.status_code()) << createItem0.status_message();
+    ASSERT_EQ (1, createItem0.result().declared_endpoints_size());
+    ASSERT_EQ ("m0 csr", createItem0.result().declared_endpoints(0).csr());
+    ASSERT_EQ (1, createItem0.result().declared_ports_size());
+
+    const auto &createItem1 = createBatchResult.machines(1);
+    ASSERT_NE (grpc::StatusCode::OK, createItem1.status_code());
+    ASSERT_THAT (createItem1.status_message(), ::testing::HasSubstr("invalid protocol url"));
+
+    // run m0 and a machine which was never created
+    chord_invoke::RunMachineBatchRequest runBatchRequest;
+    auto *runMachine0 = runBatchRequest.add_machines();
+    runMachine0->set_machine_name("m0");
+    auto *signedEndpoint = runMachine0->add_signed_endpoints();
+    signedEndpoint->set_endpoint_url("unix:/path/to/m0.sock");
+    signedEndpoint->set_certificate("m0 certificate");
+    runBatchRequest.add_machines()->set_machine_name("m1");
+
+    chord_invoke::RunMachineBatchResult runBatchResult;
+    auto runBatch = std::async(std::launch::async, [&]() {
+        grpc::ClientContext ctx;
+        return stub->RunMachineBatch(&ctx, runBatchRequest, &runBatchResult);
+    });
+
+    auto signStatus = sign.get();
+    ASSERT_TRUE (signStatus.ok()) << signStatus.error_message();
+    ASSERT_EQ (1, signResult.signed_endpoints_size());
+    ASSERT_EQ ("m0 certificate", signResult.signed_endpoints(0).certificate());
+
+    // act as machine m0 and advertise the bound endpoint, which completes the run
+    {
+        grpc::ClientContext ctx;
+        chord_invoke::AdvertiseEndpointsRequest advertiseRequest;
+        chord_invoke::AdvertiseEndpointsResult advertiseResult;
+        advertiseRequest.set_machine_name("m0");
+        advertiseRequest.add_bound_endpoints()->set_endpoint_url("unix:/path/to/m0.sock");
+        auto advertiseStatus = stub->AdvertiseEndpoints(&ctx, advertiseRequest, &advertiseResult);
+        ASSERT_TRUE (advertiseStatus.ok()) << advertiseStatus.error_message();
+    }
+
+    auto runBatchStatus = runBatch.get();
+    ASSERT_TRUE (runBatchStatus.ok()) << runBatchStatus.error_message();
+    ASSERT_EQ (2, runBatchResult.machines_size());
+
+    const auto &runItem0 = runBatchResult.machines(0);
+    ASSERT_EQ (grpc::StatusCode::OK, runItem0.status_code()) << runItem0.status_message();
+    ASSERT_EQ (1, runItem0.result().bound_endpoints_size());
+    ASSERT_EQ ("unix:/path/to/m0.sock", runItem0.result().bound_endpoints(0).endpoint_url());
+
+    const auto &runItem1 = runBatchResult.machines(1);
+    ASSERT_NE (grpc::StatusCode::OK, runItem1.status_code());
+    ASSERT_THAT (runItem1.status_message(), ::testing::HasSubstr("is not signing"));
+
+    // delete m0, which completes when the machine process exits
+    {
+        grpc::ClientContext ctx;
+        chord_invoke::DeleteMachineRequest deleteRequest;
+        chord_invoke::DeleteMachineResult deleteResult;
+        deleteRequest.set_machine_name("m0");
+        auto deleteStatus = stub->DeleteMachine(&ctx, deleteRequest, &deleteResult);
+        ASSERT_TRUE (deleteStatus.ok()) << deleteStatus.error_message();
+    }
+}
+
+TEST_F(AgentServiceTests, EmptyBatchesSucceed)
+{
+    auto stub = NewStub();
+
+    {
+        grpc::ClientContext ctx;
+        chord_invoke::CreateMachineBatchRequest request;
+        chord_invoke::CreateMachineBatchResult result;
+        auto status = stub->CreateMachineBatch(&ctx, request, &result);
+        ASSERT_TRUE (status.ok()) << status.error_message();
+        ASSERT_EQ (0, result.machines_size());
+    }
+
+    {
+        grpc::ClientContext ctx;
+        chord_invoke::RunMachineBatchRequest request;
+        chord_invoke::RunMachineBatchResult result;
+        auto status = stub->RunMachineBatch(&ctx, request, &result);
+        ASSERT_TRUE (status.ok()) << status.error_message();
+        ASSERT_EQ (0, result.machines_size());
+    }
+}
@@ -0,0 +1,268 @@
+#include <fstream>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_agent/machine_log_writer.h>
+#include <chord_agent/machine_logger.h>
+#include <tempo_utils/tempdir_maker.h>
+
+TEST(MachineLogger, TokenBucketAllowsBurst)
+{
+    chord_agent::TokenBucket bucket(10, 5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE (bucket.tryTake(0)) << "token " << i;
+    }
+    ASSERT_FALSE (bucket.tryTake(0));
+}
+
+TEST(MachineLogger, TokenBucketRefillsAtRate)
+{
+    chord_agent::TokenBucket bucket(10, 5);
+    for (int i = 0; i < 5; i++) {
+        bucket.tryTake(0);
+    }
+    ASSERT_FALSE (bucket.tryTake(50));
+    ASSERT_TRUE (bucket.tryTake(100));
+    ASSERT_FALSE (bucket.tryTake(100));
+
+    // the bucket never holds more than the burst size
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE (bucket.tryTake(10000)) << "token " << i;
+    }
+    ASSERT_FALSE (bucket.tryTake(10000));
+}
+
+TEST(MachineLogger, LineFramerSplitsLines)
+{
+    chord_agent::LineFramer framer(1024);
+    std::vector<std::string> lines;
+
+    framer.append("first\nsec", lines);
+    ASSERT_THAT (lines, testing::ElementsAre("first"));
+    framer.append("ond\r\nthird", lines);
+    ASSERT_THAT (lines, testing::ElementsAre("first", "second"));
+    framer.flush(lines);
+    ASSERT_THAT (lines, testing::ElementsAre("first", "second", "third"));
+
+    lines.clear();
+    framer.flush(lines);
+    ASSERT_TRUE (lines.empty());
+}
+
+TEST(MachineLogger, LineFramerSplitsLongLines)
+{
+    chord_agent::LineFramer framer(4);
+    std::vector<std::string> lines;
+
+    framer.append("abcdefghij\nkl", lines);
+    ASSERT_THAT (lines, testing::ElementsAre("abcd", "efgh", "ij"));
+    framer.append("mnop", lines);
+    ASSERT_THAT (lines, testing::ElementsAre("abcd", "efgh", "ij", "klmn"));
+    framer.flush(lines);
+    ASSERT_THAT (lines, testing::ElementsAre("abcd", "efgh", "ij", "klmn", "op"));
+}
+
+TEST(MachineLogger, WriterFlushesLinesOnShutdown)
+{
+    tempo_utils::TempdirMaker tempdir(std::filesystem::current_path(), "tester.XXXXXXXX");
+    ASSERT_TRUE (tempdir.getStatus().isOk());
+
+    chord_agent::MachineLogWriterOptions options;
+    options.logDirectory = tempdir.getTempdir();
+    chord_agent::MachineLogWriter writer(options);
+    ASSERT_TRUE (writer.initialize().isOk());
+
+    ASSERT_TRUE (writer.append("machine1", {"OUT one", "OUT two"}));
+    ASSERT_TRUE (writer.append("machine1", {"ERR three"}));
+    ASSERT_TRUE (writer.shutdown().isOk());
+    ASSERT_EQ (3u, writer.getLinesWritten());
+
+    std::ifstream ifs(writer.getLogFilePath("machine1"));
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_THAT (lines, testing::ElementsAre("OUT one", "OUT two", "ERR three"));
+
+    // lines appended after shutdown are dropped
+    ASSERT_FALSE (writer.append("machine1", {"OUT four"}));
+    ASSERT_EQ (1u, writer.getLinesDropped());
+}
+
+TEST(MachineLogger, WriterRotatesLogFiles)
+{
+    tempo_utils::TempdirMaker tempdir(std::filesystem::current_path(), "tester.XXXXXXXX");
+    ASSERT_TRUE (tempdir.getStatus().isOk());
+
+    chord_agent::MachineLogWriterOptions options;
+    options.logDirectory = tempdir.getTempdir();
+    options.maxFileBytes = 16;
+    options.maxRotatedFiles = 2;
+    chord_agent::MachineLogWriter writer(options);
+    ASSERT_TRUE (writer.initialize().isOk());
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE (writer.append("machine/1", {std::string(20, 'a' + i)}));
+        // wait for the batch to be written so that each batch lands in its own file
+        while (writer.getLinesWritten() < static_cast<tu_uint64>(i + 1)) {
+            absl::SleepFor(absl::Milliseconds(10));
+        }
+    }
+    ASSERT_TRUE (writer.shutdown().isOk());
+
+    auto logFilePath = writer.getLogFilePath("machine/1");
+    ASSERT_EQ ("machine_1.log", logFilePath.filename().string());
+    ASSERT_TRUE (std::filesystem::exists(logFilePath.string() + ".1"));
+    ASSERT_TRUE (std::filesystem::exists(logFilePath.string() + ".2"));
+    ASSERT_FALSE (std::filesystem::exists(logFilePath.string() + ".3"));
+
+    std::ifstream ifs(logFilePath.string() + ".1");
+    std::string line;
+    std::getline(ifs, line);
+    ASSERT_EQ (std::string(20, 'd'), line);
+}
+
+static std::vector<std::string>
+read_log_lines(const std::filesystem::path &path)
+{
+    std::ifstream ifs(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST(MachineLogger, LoggerEmitsDroppedMarkerAtEndOfStream)
+{
+    tempo_utils::TempdirMaker tempdir(std::filesystem::current_path(), "tester.XXXXXXXX");
+    ASSERT_TRUE (tempdir.getStatus().isOk());
+
+    chord_agent::MachineLogWriterOptions writerOptions;
+    writerOptions.logDirectory = tempdir.getTempdir();
+    chord_agent::MachineLogWriter writer(writerOptions);
+    ASSERT_TRUE (writer.initialize().isOk());
+
+    uv_loop_t loop;
+    ASSERT_EQ (0, uv_loop_init(&loop));
+
+    // admit a single line, every following line is dropped
+    chord_agent::MachineLoggerOptions loggerOptions;
+    loggerOptions.linesPerSecond = 0.001;
+    loggerOptions.burstLines = 1;
+    auto logger = std::make_unique<chord_agent::MachineLogger>("machine1", &loop, &writer, loggerOptions);
+    ASSERT_TRUE (logger->initialize().isOk());
+
+    int out[2], err[2];
+    ASSERT_EQ (0, socketpair(AF_UNIX, SOCK_STREAM, 0, out));
+    ASSERT_EQ (0, socketpair(AF_UNIX, SOCK_STREAM, 0, err));
+    ASSERT_EQ (0, uv_pipe_open((uv_pipe_t *) logger->getOutput(), out[0]));
+    ASSERT_EQ (0, uv_pipe_open((uv_pipe_t *) logger->getError(), err[0]));
+    ASSERT_TRUE (logger->openLogger().isOk());
+
+    std::string data = "one\ntwo\nthree\n";
+    ASSERT_EQ (static_cast<ssize_t>(data.size()), write(out[1], data.data(), data.size()));
+    close(out[1]);
+    close(err[1]);
+
+    // the loop exits once both streams have reached the end and are closed
+    uv_run(&loop, UV_RUN_DEFAULT);
+    ASSERT_EQ (2u, logger->getLinesDropped());
+    logger.reset();
+    uv_run(&loop, UV_RUN_DEFAULT);
+    ASSERT_EQ (0, uv_loop_close(&loop));
+
+    ASSERT_TRUE (writer.shutdown().isOk());
+    ASSERT_THAT (read_log_lines(writer.getLogFilePath("machine1")),
+        testing::ElementsAre("OUT one", "[2 lines dropped]"));
+}
+
+TEST(MachineLogger, WriterClosesLogFileWhenLogIsClosed)
+{
+    tempo_utils::TempdirMaker tempdir(std::filesystem::current_path(), "tester.XXXXXXXX");
+    ASSERT_TRUE (tempdir.getStatus().isOk());
+
+    chord_agent::MachineLogWriterOptions options;
+    options.logDirectory = tempdir.getTempdir();
+    chord_agent::MachineLogWriter writer(options);
+    ASSERT_TRUE (writer.initialize().isOk());
+
+    ASSERT_TRUE (writer.append("machine1", {"OUT one"}));
+    ASSERT_TRUE (writer.append("machine2", {"OUT two"}));
+    while (writer.getLinesWritten() < 2) {
+        absl::SleepFor(absl::Milliseconds(10));
+    }
+    ASSERT_EQ (2u, writer.getNumOpenFiles());
+
+    // lines queued before the close are written before the file is closed
+    ASSERT_TRUE (writer.append("machine1", {"OUT three"}));
+    writer.closeLog("machine1");
+    while (writer.getNumOpenFiles() != 1) {
+        absl::SleepFor(absl::Milliseconds(10));
+    }
+    ASSERT_EQ (3u, writer.getLinesWritten());
+
+    ASSERT_TRUE (writer.shutdown().isOk());
+    ASSERT_EQ (0u, writer.getNumOpenFiles());
+    ASSERT_THAT (read_log_lines(writer.getLogFilePath("machine1")),
+        testing::ElementsAre("OUT one", "OUT three"));
+}
+
+TEST(MachineLogger, LoggerReleasesLogFileOnRenameAndEndOfStream)
+{
+    tempo_utils::TempdirMaker tempdir(std::filesystem::current_path(), "tester.XXXXXXXX");
+    ASSERT_TRUE (tempdir.getStatus().isOk());
+
+    chord_agent::MachineLogWriterOptions writerOptions;
+    writerOptions.logDirectory = tempdir.getTempdir();
+    chord_agent::MachineLogWriter writer(writerOptions);
+    ASSERT_TRUE (writer.initialize().isOk());
+
+    uv_loop_t loop;
+    ASSERT_EQ (0, uv_loop_init(&loop));
+
+    auto logger = std::make_unique<chord_agent::MachineLogger>("pooled-00000001", &loop, &writer);
+    ASSERT_TRUE (logger->initialize().isOk());
+
+    int out[2], err[2];
+    ASSERT_EQ (0, socketpair(AF_UNIX, SOCK_STREAM, 0, out));
+    ASSERT_EQ (0, socketpair(AF_UNIX, SOCK_STREAM, 0, err));
+    ASSERT_EQ (0, uv_pipe_open((uv_pipe_t *) logger->getOutput(), out[0]));
+    ASSERT_EQ (0, uv_pipe_open((uv_pipe_t *) logger->getError(), err[0]));
+    ASSERT_TRUE (logger->openLogger().isOk());
+
+    std::string pooled = "waiting\n";
+    ASSERT_EQ (static_cast<ssize_t>(pooled.size()), write(out[1], pooled.data(), pooled.size()));
+    while (writer.getLinesWritten() < 1) {
+        uv_run(&loop, UV_RUN_NOWAIT);
+        absl::SleepFor(absl::Milliseconds(10));
+    }
+    ASSERT_EQ (1u, writer.getNumOpenFiles());
+
+    // assigning the pooled machine releases the file for the pooled name
+    logger->setMachineName("machine1");
+    std::string assigned = "running\n";
+    ASSERT_EQ (static_cast<ssize_t>(assigned.size()), write(out[1], assigned.data(), assigned.size()));
+    close(out[1]);
+    close(err[1]);
+
+    // the loop exits once both streams have reached the end and are closed, which releases
+    // the file for the assigned name
+    uv_run(&loop, UV_RUN_DEFAULT);
+    while (writer.getLinesWritten() < 2 || writer.getNumOpenFiles() != 0) {
+        absl::SleepFor(absl::Milliseconds(10));
+    }
+    logger.reset();
+    uv_run(&loop, UV_RUN_DEFAULT);
+    ASSERT_EQ (0, uv_loop_close(&loop));
+
+    ASSERT_TRUE (writer.shutdown().isOk());
+    ASSERT_THAT (read_log_lines(writer.getLogFilePath("pooled-00000001")), testing::ElementsAre("OUT waiting"));
+    ASSERT_THAT (read_log_lines(writer.getLogFilePath("machine1")), testing::ElementsAre("OUT running"));
+}
@@ -1,5 +1,16 @@
+#include <cstdlib>
+#include <unistd.h>
 
+/**
+ * Exits immediately, unless MOCK_PROCESS_WAIT is set in the environment, in which case the
+ * process stays alive until it is terminated by a signal.
+ */
 int main(int argc, char *argv[])
 {
+    if (std::getenv("MOCK_PROCESS_WAIT") != nullptr) {
+        for (;;) {
+            pause();
+        }
+    }
     return 0;
-}
\ No newline at end of file
+}
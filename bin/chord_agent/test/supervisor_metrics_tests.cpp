@@ -0,0 +1,88 @@
+#include <limits>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_agent/supervisor_metrics.h>
+
+TEST(SupervisorMetrics, SmallValuesAreCountedExactly)
+{
+    for (int i = 0; i < chord_agent::LatencyHistogram::kSubBucketCount; i++) {
+        auto index = chord_agent::LatencyHistogram::bucketIndex(i);
+        ASSERT_EQ (i, index);
+        ASSERT_EQ (i, chord_agent::LatencyHistogram::bucketUpperBound(index));
+    }
+}
+
+TEST(SupervisorMetrics, BucketUpperBoundContainsValue)
+{
+    for (tu_uint64 value : {32ull, 33ull, 63ull, 64ull, 1000ull, 123456ull, 5000000ull, 1ull << 39}) {
+        auto index = chord_agent::LatencyHistogram::bucketIndex(value);
+        auto upperBound = chord_agent::LatencyHistogram::bucketUpperBound(index);
+        ASSERT_LE (value, upperBound) << "value " << value;
+        // the relative error of a bucket is at most 1/16
+        ASSERT_LE (upperBound - value, value / 16) << "value " << value;
+        if (index > 0) {
+            ASSERT_LT (chord_agent::LatencyHistogram::bucketUpperBound(index - 1), value) << "value " << value;
+        }
+    }
+}
+
+TEST(SupervisorMetrics, LargeValuesAreCountedInLastBucket)
+{
+    auto index = chord_agent::LatencyHistogram::bucketIndex(std::numeric_limits<tu_uint64>::max());
+    ASSERT_EQ (chord_agent::LatencyHistogram::kNumBuckets - 1, index);
+}
+
+TEST(SupervisorMetrics, RecordLatencies)
+{
+    chord_agent::LatencyHistogram histogram;
+    ASSERT_EQ (0, histogram.getCount());
+    ASSERT_EQ (0, histogram.getValueAtPercentile(50));
+
+    for (int i = 1; i <= 100; i++) {
+        histogram.record(absl::Milliseconds(i));
+    }
+
+    ASSERT_EQ (100, histogram.getCount());
+    ASSERT_EQ (1000, histogram.getMinMicros());
+    ASSERT_EQ (100000, histogram.getMaxMicros());
+    ASSERT_EQ (5050000, histogram.getSumMicros());
+
+    auto p50 = histogram.getValueAtPercentile(50);
+    ASSERT_LE (50000, p50);
+    ASSERT_GE (50000 + 50000 / 16, p50);
+    ASSERT_EQ (100000, histogram.getValueAtPercentile(100));
+
+    chord_invoke::LatencyHistogram proto;
+    histogram.toProto(&proto);
+    ASSERT_EQ (100, proto.count());
+    tu_uint64 total = 0;
+    for (const auto &bucket : proto.buckets()) {
+        ASSERT_LT (0, bucket.count());
+        total += bucket.count();
+    }
+    ASSERT_EQ (100, total);
+}
+
+TEST(SupervisorMetrics, SnapshotCounters)
+{
+    chord_agent::SupervisorMetrics metrics;
+    metrics.spawned += 3;
+    metrics.ready += 2;
+    metrics.timedOut++;
+    metrics.abandoned++;
+    metrics.released += 3;
+    metrics.spawningLatency.record(absl::Milliseconds(20));
+
+    chord_invoke::GetSupervisorMetricsResult result;
+    metrics.toProto(&result);
+    ASSERT_EQ (3, result.spawned());
+    ASSERT_EQ (2, result.ready());
+    ASSERT_EQ (1, result.timed_out());
+    ASSERT_EQ (1, result.abandoned());
+    ASSERT_EQ (3, result.released());
+    ASSERT_EQ (1, result.spawning_latency().count());
+    ASSERT_EQ (0, result.signing_latency().count());
+    ASSERT_EQ (0, result.binding_latency().count());
+}
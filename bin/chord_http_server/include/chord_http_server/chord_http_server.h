@@ -1,8 +1,14 @@
 #ifndef CHORD_HTTP_SERVER_CHORD_HTTP_SERVER_H
 #define CHORD_HTTP_SERVER_CHORD_HTTP_SERVER_H
 
+#include <string_view>
+
+#include <boost/asio/ip/tcp.hpp>
+
 #include <tempo_utils/status.h>
 
+tempo_utils::Status parse_listen_endpoint(std::string_view listenEndpoint, boost::asio::ip::tcp::endpoint &endpoint);
+
 tempo_utils::Status run_chord_http_server(int argc, char *argv[]);
 
 #endif // CHORD_HTTP_SERVER_CHORD_HTTP_SERVER_H
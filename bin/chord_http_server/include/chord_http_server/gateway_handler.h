@@ -0,0 +1,102 @@
+#ifndef CHORD_HTTP_SERVER_GATEWAY_HANDLER_H
+#define CHORD_HTTP_SERVER_GATEWAY_HANDLER_H
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/time/time.h>
+#include <boost/asio/steady_timer.hpp>
+#include <grpcpp/security/credentials.h>
+
+#include <chord_common/abstract_protocol_handler.h>
+#include <chord_common/gateway_protocol.h>
+#include <chord_remoting/remoting_service.grpc.pb.h>
+#include <tempo_utils/url.h>
+
+#include "http_handler.h"
+
+namespace chord_http_server {
+
+    /**
+     * A gateway target maps requests under the URL prefix onto the port identified by the
+     * protocol url on the machine listening at the endpoint url.
+     */
+    struct GatewayTarget {
+        std::string prefix = {};
+        tempo_utils::Url endpointUrl = {};
+        tempo_utils::Url protocolUrl = {};
+        std::string endpointServerName = {};
+        absl::Duration requestTimeout = absl::Seconds(30);
+    };
+
+    tempo_utils::Status parse_gateway_target(std::string_view spec, GatewayTarget &target);
+
+    /**
+     * Protocol handler which multiplexes HTTP requests over a single Communicate stream. Each
+     * request is assigned a request id which the port echoes in its response, so any number of
+     * requests may be in flight on the stream at once. A request which the port does not answer
+     * within the request timeout is failed with a gateway timeout response. A channel is
+     * attached to exactly one stream, and once detached it is never reattached.
+     */
+    class GatewayChannel
+        : public chord_common::AbstractProtocolHandler,
+          public std::enable_shared_from_this<GatewayChannel> {
+    public:
+        explicit GatewayChannel(absl::Duration requestTimeout = absl::Seconds(30));
+
+        bool isAttached() override;
+        tempo_utils::Status attach(chord_common::AbstractProtocolWriter *writer) override;
+        tempo_utils::Status send(std::string_view message) override;
+        tempo_utils::Status handle(std::string_view message) override;
+        tempo_utils::Status detach() override;
+
+        void submit(const HttpRequest &request, std::string_view target, HttpReply reply);
+
+        int numPending();
+
+    private:
+        struct PendingRequest {
+            HttpReply reply;
+            std::shared_ptr<boost::asio::steady_timer> timer;
+        };
+
+        absl::Duration m_requestTimeout;
+        absl::Mutex m_lock;
+        chord_common::AbstractProtocolWriter *m_writer ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_nextRequestId ABSL_GUARDED_BY(m_lock);
+        bool m_detached ABSL_GUARDED_BY(m_lock);
+        absl::flat_hash_map<tu_uint32,PendingRequest> m_pending ABSL_GUARDED_BY(m_lock);
+
+        void expireRequest(tu_uint32 requestId);
+    };
+
+    /**
+     * HTTP handler which forwards requests to a machine port. The Communicate stream to the
+     * port is opened when the handler is initialized so the first request does not pay for the
+     * connection, and it is reopened on demand if the machine closes it. Each stream gets its
+     * own GatewayChannel, so when an old stream finishes it only fails the requests which were
+     * sent on it.
+     */
+    class GatewayHandler : public AbstractHttpHandler {
+    public:
+        GatewayHandler(const GatewayTarget &target, std::shared_ptr<grpc::ChannelCredentials> credentials);
+
+        tempo_utils::Status initialize();
+
+        void handleRequest(const HttpRequest &request, HttpReply reply) override;
+
+        tempo_utils::Status shutdown();
+
+    private:
+        GatewayTarget m_target;
+        std::shared_ptr<grpc::ChannelCredentials> m_credentials;
+
+        absl::Mutex m_lock;
+        std::shared_ptr<grpc::Channel> m_channel ABSL_GUARDED_BY(m_lock);
+        std::unique_ptr<chord_remoting::RemotingService::StubInterface> m_stub ABSL_GUARDED_BY(m_lock);
+        std::shared_ptr<GatewayChannel> m_gatewayChannel ABSL_GUARDED_BY(m_lock);
+
+        tempo_utils::Status openStream() ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+    };
+}
+
+#endif // CHORD_HTTP_SERVER_GATEWAY_HANDLER_H
@@ -7,19 +7,35 @@
 
 #include <tempo_utils/status.h>
 
+#include "http_router.h"
+#include "http_session.h"
+
 namespace chord_http_server {
 
+    struct HttpAcceptorOptions {
+        bool reusePort = false;             // allow several acceptors to listen on the same port
+        bool strandPerConnection = true;    // required when the io_context is run by several threads
+        HttpSessionOptions sessionOptions = {};
+    };
+
     class HttpAcceptor : public std::enable_shared_from_this<HttpAcceptor> {
     public:
-        explicit HttpAcceptor(boost::asio::io_context &ioctx);
+        HttpAcceptor(
+            boost::asio::io_context &ioctx,
+            std::shared_ptr<const HttpRouter> router,
+            const HttpAcceptorOptions &options = {});
 
         tempo_utils::Status initialize(boost::asio::ip::tcp::endpoint endpoint);
 
+        boost::asio::ip::tcp::endpoint getLocalEndpoint() const;
+
         void run();
 
     private:
         boost::asio::io_context& m_ioctx;
         boost::asio::ip::tcp::acceptor m_acceptor;
+        std::shared_ptr<const HttpRouter> m_router;
+        HttpAcceptorOptions m_options;
 
         void doAccept();
         void onAccept(boost::beast::error_code ec, boost::asio::ip::tcp::socket socket);
@@ -0,0 +1,65 @@
+#ifndef CHORD_HTTP_SERVER_HTTP_HANDLER_H
+#define CHORD_HTTP_SERVER_HTTP_HANDLER_H
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/beast/http.hpp>
+
+#include <tempo_utils/integer_types.h>
+
+namespace chord_http_server {
+
+    using HttpRequest = boost::beast::http::request<boost::beast::http::string_body>;
+    using HttpResponse = boost::beast::http::response<boost::beast::http::string_body>;
+
+    // forward declarations
+    class HttpSession;
+
+    /**
+     * Completes a single request received by an HttpSession. The reply may be sent from any
+     * thread, and responses are always written in the order the requests were received even
+     * when replies to pipelined requests are sent out of order.
+     */
+    class HttpReply {
+    public:
+        HttpReply(std::shared_ptr<HttpSession> session, tu_uint64 requestId);
+
+        void send(HttpResponse &&response) const;
+        void sendError(boost::beast::http::status status, std::string_view message) const;
+
+        boost::asio::any_io_executor getExecutor() const;
+
+    private:
+        std::shared_ptr<HttpSession> m_session;
+        tu_uint64 m_requestId;
+    };
+
+    class AbstractHttpHandler {
+    public:
+        virtual ~AbstractHttpHandler() = default;
+
+        /**
+         * Handle the specified request. The handler must send exactly one response using the
+         * reply, either before returning or asynchronously.
+         *
+         * @param request The request.
+         * @param reply The reply used to send the response.
+         */
+        virtual void handleRequest(const HttpRequest &request, HttpReply reply) = 0;
+    };
+
+    /**
+     * Handler which responds to every request with a fixed body, useful for health checks.
+     */
+    class StaticHttpHandler : public AbstractHttpHandler {
+    public:
+        StaticHttpHandler(std::string_view contentType, std::string_view body);
+
+        void handleRequest(const HttpRequest &request, HttpReply reply) override;
+
+    private:
+        std::string m_contentType;
+        std::string m_body;
+    };
+}
+
+#endif // CHORD_HTTP_SERVER_HTTP_HANDLER_H
@@ -0,0 +1,40 @@
+#ifndef CHORD_HTTP_SERVER_HTTP_ROUTER_H
+#define CHORD_HTTP_SERVER_HTTP_ROUTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <tempo_utils/status.h>
+
+#include "http_handler.h"
+
+namespace chord_http_server {
+
+    /**
+     * Route table which maps path prefixes to handlers. A prefix matches a request path if the
+     * path equals the prefix or continues with a path separator after the prefix, and when
+     * several prefixes match the longest prefix wins. Routes are added before the service is
+     * started; afterwards the router is only read, so lookups do not require a lock.
+     */
+    class HttpRouter {
+    public:
+        HttpRouter();
+
+        tempo_utils::Status addRoute(std::string_view prefix, std::shared_ptr<AbstractHttpHandler> handler);
+
+        AbstractHttpHandler *findRoute(std::string_view target) const;
+        int numRoutes() const;
+
+    private:
+        struct Route {
+            std::string prefix;
+            std::shared_ptr<AbstractHttpHandler> handler;
+        };
+
+        // sorted by descending prefix length so the first match is the longest match
+        std::vector<Route> m_routes;
+    };
+}
+
+#endif // CHORD_HTTP_SERVER_HTTP_ROUTER_H
@@ -11,19 +11,47 @@
 
 namespace chord_http_server {
 
+    enum class HttpServiceMode {
+        Shared,     // worker threads share one io_context, connections are serialized by strands
+        Sharded,    // one io_context and SO_REUSEPORT acceptor per worker thread
+    };
+
+    struct HttpServiceOptions {
+        int numWorkers = 0;         // zero means one worker per core
+        HttpServiceMode mode = HttpServiceMode::Shared;
+        HttpSessionOptions sessionOptions = {};
+    };
+
     class HttpService {
     public:
-        explicit HttpService(int numWorkers);
+        HttpService(std::shared_ptr<const HttpRouter> router, const HttpServiceOptions &options = {});
 
         tempo_utils::Status initialize(boost::asio::ip::tcp::endpoint endpoint);
         tempo_utils::Status run();
         tempo_utils::Status shutdown();
 
+        int getNumWorkers() const;
+        boost::asio::ip::tcp::endpoint getLocalEndpoint() const;
+
     private:
-        boost::asio::io_context m_ioctx;
+        std::shared_ptr<const HttpRouter> m_router;
+        HttpServiceOptions m_options;
+        int m_numWorkers;
+        bool m_running;
+
+        // used in shared mode
+        std::unique_ptr<boost::asio::io_context> m_ioctx;
         std::shared_ptr<HttpAcceptor> m_acceptor;
         std::vector<uv_thread_t> m_workerThreads;
         uv_thread_t m_listenerThread;
+
+        // used in sharded mode
+        struct Shard {
+            boost::asio::io_context ioctx{1};
+            std::shared_ptr<HttpAcceptor> acceptor;
+            uv_thread_t thread;
+        };
+        std::vector<std::unique_ptr<Shard>> m_shards;
     };
 }
 
@@ -1,26 +1,76 @@
 #ifndef CHORD_HTTP_SERVER_HTTP_SESSION_H
 #define CHORD_HTTP_SERVER_HTTP_SESSION_H
 
+#include <deque>
+#include <optional>
+
+#include <absl/time/time.h>
 #include <boost/beast.hpp>
 
+#include "http_handler.h"
+#include "http_router.h"
+
 namespace chord_http_server {
 
+    struct HttpSessionOptions {
+        absl::Duration idleTimeout = absl::Seconds(60);
+        absl::Duration headerTimeout = absl::Seconds(10);
+        absl::Duration requestTimeout = absl::Seconds(30);
+        absl::Duration writeTimeout = absl::Seconds(30);
+        tu_uint32 maxHeaderBytes = 8 * 1024;
+        tu_uint64 maxBodyBytes = 1024 * 1024;
+        tu_uint32 maxPipelinedRequests = 16;
+        tu_uint32 initialBufferBytes = 4096;
+    };
+
+    /**
+     * A single HTTP/1.1 connection. Requests are routed to handlers through the router, and the
+     * connection stays open as long as the client keeps it alive. Pipelined requests are read
+     * while earlier responses are pending, up to the configured limit, and their responses are
+     * written in the order the requests were received.
+     */
     class HttpSession : public std::enable_shared_from_this<HttpSession> {
     public:
-        explicit HttpSession(boost::asio::ip::tcp::socket&& socket);
+        HttpSession(
+            boost::asio::ip::tcp::socket&& socket,
+            std::shared_ptr<const HttpRouter> router,
+            const HttpSessionOptions &options = {});
 
         void run();
 
     private:
         boost::beast::tcp_stream m_stream;
+        std::shared_ptr<const HttpRouter> m_router;
+        HttpSessionOptions m_options;
         boost::beast::flat_buffer m_buffer;
-        boost::beast::http::request<boost::beast::http::string_body> m_req;
+        std::optional<boost::beast::http::request_parser<boost::beast::http::string_body>> m_parser;
+
+        struct PendingResponse {
+            tu_uint64 requestId;
+            unsigned version;
+            bool keepAlive;
+            std::optional<HttpResponse> response;
+        };
+        std::deque<PendingResponse> m_pending;
+        tu_uint64 m_nextRequestId;
+        bool m_reading;
+        bool m_writing;
+        bool m_closing;
 
         void doRead();
-        void handleRequest(boost::beast::error_code ec, std::size_t bytes_transferred);
-        void sendResponse(boost::beast::http::message_generator&& msg);
-        void onWrite(bool keep_alive, boost::beast::error_code ec, std::size_t bytes_transferred);
+        void onIdleRead(boost::beast::error_code ec, std::size_t bytes_transferred);
+        void doReadHeader();
+        void onReadHeader(boost::beast::error_code ec, std::size_t bytes_transferred);
+        void onReadRequest(boost::beast::error_code ec, std::size_t bytes_transferred);
+        void handleReadError(boost::beast::error_code ec);
+        void dispatchRequest(HttpRequest &&request);
+        void rejectRequest(boost::beast::http::status status, std::string_view message);
+        void completeRequest(tu_uint64 requestId, HttpResponse &&response);
+        void doWrite();
+        void onWrite(boost::beast::error_code ec, std::size_t bytes_transferred);
         void doClose();
+
+        friend class HttpReply;
     };
 }
 
@@ -1,9 +1,12 @@
 #include <vector>
 
+#include <absl/strings/numbers.h>
 #include <boost/beast.hpp>
 #include <grpcpp/server.h>
 #include <uv.h>
 
+#include <chord_http_server/chord_http_server.h>
+#include <chord_http_server/gateway_handler.h>
 #include <chord_http_server/http_service.h>
 #include <tempo_command/command_help.h>
 #include <tempo_command/command_parser.h>
@@ -23,6 +26,44 @@ on_termination_signal(uv_signal_t *handle, int signal)
     uv_stop(handle->loop);
 }
 
+/**
+ * Parse a listen endpoint of the form `host:port`. An IPv6 host must be enclosed in brackets.
+ *
+ * @param listenEndpoint The listen endpoint string.
+ * @param endpoint The parsed endpoint, which is set only if parsing succeeds.
+ * @return Ok status if the endpoint was parsed, otherwise error status.
+ */
+tempo_utils::Status
+parse_listen_endpoint(std::string_view listenEndpoint, boost::asio::ip::tcp::endpoint &endpoint)
+{
+    auto sep = listenEndpoint.rfind(':');
+    if (sep == std::string_view::npos)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "invalid listen endpoint '{}'; expected HOST:PORT", listenEndpoint);
+    auto host = listenEndpoint.substr(0, sep);
+    auto port = listenEndpoint.substr(sep + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    int portNumber;
+    if (!absl::SimpleAtoi(port, &portNumber) || portNumber < 0 || portNumber > 65535)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "invalid port in listen endpoint '{}'", listenEndpoint);
+
+    boost::system::error_code ec;
+    auto address = boost::asio::ip::make_address(std::string(host), ec);
+    if (ec)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "invalid address in listen endpoint '{}': {}", listenEndpoint, ec.message());
+
+    endpoint = boost::asio::ip::tcp::endpoint(address, static_cast<unsigned short>(portNumber));
+    return {};
+}
+
 tempo_utils::Status
 run_chord_http_server(int argc, char *argv[])
 {
@@ -32,19 +73,24 @@ run_chord_http_server(int argc, char *argv[])
     uv_os_gethostname(hostname, &len);
     auto processName = absl::StrCat(getpid(), "@", hostname);
 
-    tempo_config::StringParser listenEndpointParser(std::string{});
+    tempo_config::StringParser listenEndpointParser(std::string("127.0.0.1:8080"));
     tempo_config::PathParser processRunDirectoryParser(std::filesystem::current_path());
     tempo_config::PathParser pemCertificateFileParser(std::filesystem::path{});
     tempo_config::PathParser pemPrivateKeyFileParser(std::filesystem::path{});
     tempo_config::PathParser pemRootCABundleFileParser(std::filesystem::path{});
     tempo_config::BooleanParser runInBackgroundParser(false);
     tempo_config::BooleanParser emitEndpointParser(false);
+    tempo_config::IntegerParser numWorkersParser(0);
+    tempo_config::BooleanParser shardPerCoreParser(false);
+    tempo_config::StringParser gatewayParser;
+    tempo_config::SeqTParser gatewaysParser(&gatewayParser, {});
+    tempo_config::StringParser gatewayServerNameParser(std::string{});
     //tempo_config::PathParser logFileParser(std::filesystem::path(absl::StrCat("chord-http-server.", getpid(), ".log")));
     tempo_config::PathParser logFileParser(std::filesystem::path{});
     tempo_config::PathParser pidFileParser(std::filesystem::path{});
 
     std::vector<tempo_command::Default> defaults = {
-        {"listenEndpoint", {}, "listen on the specified endpoint", "ENDPOINT"},
+        {"listenEndpoint", {}, "listen on the specified endpoint, defaults to 127.0.0.1:8080", "HOST:PORT"},
         {"processRunDirectory", processRunDirectoryParser.getDefault(),
             "listen on the specified endpoint url", "DIR"},
         {"pemCertificateFile", {}, "the certificate used by gRPC", "FILE"},
@@ -52,6 +98,10 @@ run_chord_http_server(int argc, char *argv[])
         {"pemRootCABundleFile", {}, "the root CA certificate bundle used by gRPC", "FILE"},
         {"runInBackground", {}, "run agent in the background", {}},
         {"emitEndpoint", {}, "print the endpoint url after initialization has completed", {}},
+        {"numWorkers", {}, "run the specified number of worker threads, defaults to one per core", "COUNT"},
+        {"shardPerCore", {}, "run a separate io context and acceptor on each worker thread", {}},
+        {"gateways", {}, "forward requests under PREFIX to the machine port", "PREFIX=ENDPOINT-URL,PROTOCOL-URL"},
+        {"gatewayServerName", {}, "override the server name used to verify gateway endpoints", "NAME"},
         {"logFile", {}, "path to log file", "FILE"},
         {"pidFile", {}, "record the agent process id in the specified pid file", "FILE"},
     };
@@ -63,6 +113,10 @@ run_chord_http_server(int argc, char *argv[])
         {"pemRootCABundleFile", {"--ca-bundle"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"runInBackground", {"--background"}, tempo_command::GroupingType::NO_ARGUMENT},
         {"emitEndpoint", {"--emit-endpoint"}, tempo_command::GroupingType::NO_ARGUMENT},
+        {"numWorkers", {"--num-workers"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"shardPerCore", {"--shard-per-core"}, tempo_command::GroupingType::NO_ARGUMENT},
+        {"gateways", {"--gateway"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"gatewayServerName", {"--gateway-server-name"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"logFile", {"--log-file"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"pidFile", {"--pid-file"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"help", {"-h", "--help"}, tempo_command::GroupingType::HELP_FLAG},
@@ -76,6 +130,10 @@ run_chord_http_server(int argc, char *argv[])
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "pemRootCABundleFile"},
         {tempo_command::MappingType::TRUE_IF_INSTANCE, "runInBackground"},
         {tempo_command::MappingType::TRUE_IF_INSTANCE, "emitEndpoint"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "numWorkers"},
+        {tempo_command::MappingType::TRUE_IF_INSTANCE, "shardPerCore"},
+        {tempo_command::MappingType::ANY_INSTANCES, "gateways"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "gatewayServerName"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "logFile"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "pidFile"},
     };
@@ -152,6 +210,35 @@ run_chord_http_server(int argc, char *argv[])
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(emitEndpoint, emitEndpointParser,
         commandConfig, "emitEndpoint"));
 
+    // parse the number of workers
+    int numWorkers;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(numWorkers, numWorkersParser,
+        commandConfig, "numWorkers"));
+    if (numWorkers < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "number of workers must not be negative");
+
+    // parse the shard per core flag
+    bool shardPerCore;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(shardPerCore, shardPerCoreParser,
+        commandConfig, "shardPerCore"));
+
+    // parse the gateway targets
+    std::vector<std::string> gateways;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(gateways, gatewaysParser,
+        commandConfig, "gateways"));
+    std::string gatewayServerName;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(gatewayServerName, gatewayServerNameParser,
+        commandConfig, "gatewayServerName"));
+    std::vector<chord_http_server::GatewayTarget> gatewayTargets;
+    for (const auto &gateway : gateways) {
+        chord_http_server::GatewayTarget gatewayTarget;
+        TU_RETURN_IF_NOT_OK (chord_http_server::parse_gateway_target(gateway, gatewayTarget));
+        gatewayTarget.endpointServerName = gatewayServerName;
+        gatewayTargets.push_back(std::move(gatewayTarget));
+    }
+
     // determine the log file
     std::filesystem::path logFile;
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(logFile, logFileParser,
@@ -192,8 +279,44 @@ run_chord_http_server(int argc, char *argv[])
 
     // TODO: if pid file is specified, then write the pid file
 
+    // configure the route table
+    auto router = std::make_shared<chord_http_server::HttpRouter>();
+    TU_RETURN_IF_NOT_OK (router->addRoute("/health",
+        std::make_shared<chord_http_server::StaticHttpHandler>("text/plain", "ok\n")));
+
+    // configure the gateway routes
+    std::vector<std::shared_ptr<chord_http_server::GatewayHandler>> gatewayHandlers;
+    if (!gatewayTargets.empty()) {
+        if (pemRootCABundleFile.empty())
+            return tempo_command::CommandStatus::forCondition(
+                tempo_command::CommandCondition::kInvalidConfiguration,
+                "a root CA bundle is required to verify gateway endpoints");
+        tempo_utils::FileReader rootCABundleReader(pemRootCABundleFile);
+        if (!rootCABundleReader.isValid())
+            return tempo_command::CommandStatus::forCondition(
+                tempo_command::CommandCondition::kInvalidConfiguration,
+                "failed to read root CA bundle {}", pemRootCABundleFile.string());
+        auto rootCABytes = rootCABundleReader.getBytes();
+        grpc::SslCredentialsOptions sslOptions;
+        sslOptions.pem_root_certs = std::string((const char *) rootCABytes->getData(), rootCABytes->getSize());
+        auto credentials = grpc::SslCredentials(sslOptions);
+
+        for (const auto &gatewayTarget : gatewayTargets) {
+            auto gatewayHandler = std::make_shared<chord_http_server::GatewayHandler>(gatewayTarget, credentials);
+            TU_RETURN_IF_NOT_OK (gatewayHandler->initialize());
+            TU_RETURN_IF_NOT_OK (router->addRoute(gatewayTarget.prefix, gatewayHandler));
+            gatewayHandlers.push_back(std::move(gatewayHandler));
+        }
+    }
+
+    chord_http_server::HttpServiceOptions serviceOptions;
+    serviceOptions.numWorkers = numWorkers;
+    serviceOptions.mode = shardPerCore
+        ? chord_http_server::HttpServiceMode::Sharded
+        : chord_http_server::HttpServiceMode::Shared;
+
     //
-    auto server = std::make_unique<chord_http_server::HttpService>(4);
+    auto server = std::make_unique<chord_http_server::HttpService>(router, serviceOptions);
 
     // initialize uv loop
     uv_loop_t loop;
@@ -211,8 +334,8 @@ run_chord_http_server(int argc, char *argv[])
     sigint.data = server.get();
     uv_signal_start_oneshot(&sigint, on_termination_signal, SIGINT);
 
-    auto address = boost::asio::ip::make_address("127.0.0.1");
-    boost::asio::ip::tcp::endpoint endpoint(address, 8080);
+    boost::asio::ip::tcp::endpoint endpoint;
+    TU_RETURN_IF_NOT_OK (parse_listen_endpoint(listenEndpoint, endpoint));
 
     //
     TU_RETURN_IF_NOT_OK (server->initialize(endpoint));
@@ -250,5 +373,10 @@ run_chord_http_server(int argc, char *argv[])
     // release the service
     server.reset();
 
+    // close the gateway streams
+    for (auto &gatewayHandler : gatewayHandlers) {
+        TU_LOG_WARN_IF (gatewayHandler->shutdown().notOk()) << "failed to shut down gateway";
+    }
+
     return {};
 }
\ No newline at end of file
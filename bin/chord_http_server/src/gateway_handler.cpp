@@ -0,0 +1,342 @@
+
+#include <absl/strings/str_cat.h>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <grpcpp/create_channel.h>
+
+#include <chord_http_server/gateway_handler.h>
+#include <chord_sandbox/remoting_client.h>
+#include <tempo_utils/log_stream.h>
+
+/**
+ * Parse a gateway target specification of the form `PREFIX=ENDPOINT-URL,PROTOCOL-URL`.
+ *
+ * @param spec The gateway target specification.
+ * @param target The gateway target which is filled in on success.
+ * @return Ok status if the specification is valid, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_http_server::parse_gateway_target(std::string_view spec, GatewayTarget &target)
+{
+    auto equals = spec.find('=');
+    auto comma = spec.find(',', equals == std::string_view::npos? 0 : equals);
+    if (equals == std::string_view::npos || comma == std::string_view::npos)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid gateway '{}'; expected PREFIX=ENDPOINT-URL,PROTOCOL-URL", spec);
+
+    auto prefix = spec.substr(0, equals);
+    if (prefix.empty() || prefix.front() != '/')
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid gateway prefix '{}'", prefix);
+    if (prefix.size() > 1 && prefix.back() == '/') {
+        prefix.remove_suffix(1);
+    }
+
+    auto endpointUrl = tempo_utils::Url::fromString(spec.substr(equals + 1, comma - equals - 1));
+    if (!endpointUrl.isValid())
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid endpoint url in gateway '{}'", spec);
+    auto protocolUrl = tempo_utils::Url::fromString(spec.substr(comma + 1));
+    if (!protocolUrl.isValid())
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid protocol url in gateway '{}'", spec);
+
+    target.prefix = std::string(prefix);
+    target.endpointUrl = endpointUrl;
+    target.protocolUrl = protocolUrl;
+    return {};
+}
+
+/**
+ * Cancel the request timer on the executor which owns it, since a timer may only be used from
+ * one thread at a time.
+ */
+static void
+cancel_request_timer(std::shared_ptr<boost::asio::steady_timer> timer)
+{
+    auto executor = timer->get_executor();
+    boost::asio::post(executor, [timer = std::move(timer)]() { timer->cancel(); });
+}
+
+chord_http_server::GatewayChannel::GatewayChannel(absl::Duration requestTimeout)
+    : m_requestTimeout(requestTimeout),
+      m_writer(nullptr),
+      m_nextRequestId(0),
+      m_detached(false)
+{
+}
+
+bool
+chord_http_server::GatewayChannel::isAttached()
+{
+    absl::MutexLock locker(&m_lock);
+    return m_writer != nullptr;
+}
+
+tempo_utils::Status
+chord_http_server::GatewayChannel::attach(chord_common::AbstractProtocolWriter *writer)
+{
+    absl::MutexLock locker(&m_lock);
+    if (m_writer != nullptr || m_detached)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway channel is already attached");
+    m_writer = writer;
+    return {};
+}
+
+tempo_utils::Status
+chord_http_server::GatewayChannel::send(std::string_view message)
+{
+    absl::MutexLock locker(&m_lock);
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway channel is not attached");
+    return m_writer->write(message);
+}
+
+/**
+ * Handle a response frame from the machine port by completing the request with the matching
+ * request id.
+ */
+tempo_utils::Status
+chord_http_server::GatewayChannel::handle(std::string_view message)
+{
+    chord_common::GatewayResponseFrame frame;
+    auto status = chord_common::read_gateway_response(message, frame);
+    if (status.notOk()) {
+        TU_LOG_WARN << "dropping invalid gateway response: " << status;
+        return status;
+    }
+
+    std::optional<PendingRequest> pending;
+    {
+        absl::MutexLock locker(&m_lock);
+        auto entry = m_pending.find(frame.requestId);
+        if (entry != m_pending.cend()) {
+            pending.emplace(std::move(entry->second));
+            m_pending.erase(entry);
+        }
+    }
+
+    // the request may have timed out already
+    if (!pending.has_value()) {
+        TU_LOG_WARN << "dropping gateway response for unknown request " << frame.requestId;
+        return {};
+    }
+    cancel_request_timer(std::move(pending->timer));
+
+    HttpResponse response;
+    response.result(static_cast<unsigned>(frame.statusCode));
+    if (!frame.contentType.empty()) {
+        response.set(boost::beast::http::field::content_type, frame.contentType);
+    }
+    response.body() = std::move(frame.body);
+    pending->reply.send(std::move(response));
+    return {};
+}
+
+/**
+ * Detach the channel from the stream. Any requests which are still in flight can never be
+ * answered, so they are failed with a bad gateway response.
+ */
+tempo_utils::Status
+chord_http_server::GatewayChannel::detach()
+{
+    absl::flat_hash_map<tu_uint32,PendingRequest> pending;
+    {
+        absl::MutexLock locker(&m_lock);
+        m_writer = nullptr;
+        m_detached = true;
+        pending.swap(m_pending);
+    }
+
+    for (auto &entry : pending) {
+        cancel_request_timer(std::move(entry.second.timer));
+        entry.second.reply.sendError(boost::beast::http::status::bad_gateway, "machine port closed the stream");
+    }
+    return {};
+}
+
+/**
+ * Fail the request with the specified id with a gateway timeout response, unless the port
+ * answered it in the meantime.
+ */
+void
+chord_http_server::GatewayChannel::expireRequest(tu_uint32 requestId)
+{
+    std::optional<PendingRequest> pending;
+    {
+        absl::MutexLock locker(&m_lock);
+        auto entry = m_pending.find(requestId);
+        if (entry == m_pending.cend())
+            return;
+        pending.emplace(std::move(entry->second));
+        m_pending.erase(entry);
+    }
+
+    TU_LOG_V << "gateway request " << requestId << " timed out";
+    pending->reply.sendError(boost::beast::http::status::gateway_timeout, "machine port did not respond in time");
+}
+
+void
+chord_http_server::GatewayChannel::submit(const HttpRequest &request, std::string_view target, HttpReply reply)
+{
+    chord_common::GatewayRequestFrame frame;
+    frame.method = std::string(request.method_string());
+    frame.target = std::string(target);
+    frame.contentType = std::string(request[boost::beast::http::field::content_type]);
+    frame.body = request.body();
+
+    // the timer runs on the session executor, and only holds a weak reference to the channel
+    auto timer = std::make_shared<boost::asio::steady_timer>(reply.getExecutor());
+
+    tempo_utils::Status status;
+    {
+        absl::MutexLock locker(&m_lock);
+        if (m_writer == nullptr) {
+            status = tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+                "gateway channel is not attached");
+        } else {
+            frame.requestId = m_nextRequestId++;
+            auto writeFrameResult = chord_common::write_gateway_request(frame);
+            if (writeFrameResult.isStatus()) {
+                status = writeFrameResult.getStatus();
+            } else {
+                // register the reply before writing so a fast response always finds it
+                m_pending.try_emplace(frame.requestId, PendingRequest{reply, timer});
+                status = m_writer->write(writeFrameResult.getResult());
+                if (status.notOk()) {
+                    m_pending.erase(frame.requestId);
+                }
+            }
+        }
+    }
+
+    if (status.notOk()) {
+        TU_LOG_V << "failed to forward gateway request: " << status;
+        reply.sendError(boost::beast::http::status::bad_gateway, "failed to forward request to machine port");
+        return;
+    }
+
+    // the timer is only used on its executor. if the response arrives before the timer starts
+    // then the timer finds no pending request when it expires, and does nothing.
+    auto requestId = frame.requestId;
+    boost::asio::dispatch(timer->get_executor(),
+        [timer, requestId, weak = weak_from_this(), timeout = m_requestTimeout]() {
+            timer->expires_after(absl::ToChronoMilliseconds(timeout));
+            timer->async_wait([timer, requestId, weak](boost::system::error_code ec) {
+                if (ec)
+                    return;
+                if (auto channel = weak.lock()) {
+                    channel->expireRequest(requestId);
+                }
+            });
+        });
+}
+
+int
+chord_http_server::GatewayChannel::numPending()
+{
+    absl::MutexLock locker(&m_lock);
+    return m_pending.size();
+}
+
+chord_http_server::GatewayHandler::GatewayHandler(
+    const GatewayTarget &target,
+    std::shared_ptr<grpc::ChannelCredentials> credentials)
+    : m_target(target),
+      m_credentials(std::move(credentials))
+{
+    TU_ASSERT (!m_target.prefix.empty());
+    TU_ASSERT (m_target.endpointUrl.isValid());
+    TU_ASSERT (m_target.protocolUrl.isValid());
+    TU_ASSERT (m_credentials != nullptr);
+}
+
+tempo_utils::Status
+chord_http_server::GatewayHandler::initialize()
+{
+    absl::MutexLock locker(&m_lock);
+
+    if (m_stub != nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway handler is already initialized");
+
+    grpc::ChannelArguments channelArguments;
+    if (!m_target.endpointServerName.empty()) {
+        channelArguments.SetSslTargetNameOverride(m_target.endpointServerName);
+    }
+    m_channel = grpc::CreateCustomChannel(m_target.endpointUrl.toString(), m_credentials, channelArguments);
+    m_stub = chord_remoting::RemotingService::NewStub(m_channel);
+
+    // open the stream now so it is warm when the first request arrives
+    TU_LOG_INFO << "forwarding " << m_target.prefix << " to " << m_target.protocolUrl
+        << " on endpoint " << m_target.endpointUrl;
+    return openStream();
+}
+
+tempo_utils::Status
+chord_http_server::GatewayHandler::openStream()
+{
+    if (m_stub == nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway handler is not initialized");
+
+    // if the endpoint is unreachable then a new stream would fail immediately, so fail the open
+    // and let gRPC continue reconnecting in the background
+    auto state = m_channel->GetState(true);
+    if (state == GRPC_CHANNEL_TRANSIENT_FAILURE || state == GRPC_CHANNEL_SHUTDOWN)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway endpoint {} is unreachable", m_target.endpointUrl.toString());
+
+    // each stream gets a new channel, the stream attaches itself to the channel and frees itself
+    // when it is done, detaching only its own channel
+    m_gatewayChannel = std::make_shared<GatewayChannel>(m_target.requestTimeout);
+    new chord_sandbox::ClientCommunicationStream(m_stub.get(), m_target.protocolUrl, m_gatewayChannel, true);
+    return {};
+}
+
+void
+chord_http_server::GatewayHandler::handleRequest(const HttpRequest &request, HttpReply reply)
+{
+    // strip the route prefix from the target, the port sees targets relative to the prefix
+    auto requestTarget = request.target();
+    std::string_view target(requestTarget.data(), requestTarget.size());
+    if (m_target.prefix != "/") {
+        target.remove_prefix(std::min(m_target.prefix.size(), target.size()));
+    }
+    std::string relativeTarget;
+    if (target.empty() || target.front() != '/') {
+        relativeTarget = absl::StrCat("/", target);
+        target = relativeTarget;
+    }
+
+    std::shared_ptr<GatewayChannel> gatewayChannel;
+    {
+        absl::MutexLock locker(&m_lock);
+        // reopen the stream if the machine closed it
+        if (m_gatewayChannel == nullptr || !m_gatewayChannel->isAttached()) {
+            auto status = openStream();
+            if (status.notOk()) {
+                TU_LOG_V << "failed to open gateway stream: " << status;
+                return reply.sendError(boost::beast::http::status::service_unavailable,
+                    "machine port is unavailable");
+            }
+        }
+        gatewayChannel = m_gatewayChannel;
+    }
+
+    gatewayChannel->submit(request, target, std::move(reply));
+}
+
+tempo_utils::Status
+chord_http_server::GatewayHandler::shutdown()
+{
+    absl::MutexLock locker(&m_lock);
+    if (m_stub != nullptr) {
+        TU_LOG_INFO << "shutting down gateway to " << m_target.protocolUrl;
+        m_stub.reset();
+        m_channel.reset();
+    }
+    return {};
+}
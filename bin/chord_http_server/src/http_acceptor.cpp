@@ -1,4 +1,6 @@
 
+#include <sys/socket.h>
+
 #include <boost/asio/strand.hpp>
 #include <boost/beast.hpp>
 
@@ -6,11 +8,43 @@
 #include <chord_http_server/http_session.h>
 #include <tempo_utils/log_stream.h>
 
-chord_http_server::HttpAcceptor::HttpAcceptor(boost::asio::io_context &ioctx)
+/**
+ * Socket option which sets SO_REUSEPORT, implemented against the public SettableSocketOption
+ * requirements because asio does not provide a reuse_port option.
+ */
+class ReusePortOption {
+public:
+    explicit ReusePortOption(bool enabled) : m_value(enabled ? 1 : 0) {}
+
+    template <typename Protocol>
+    int level(const Protocol &) const { return SOL_SOCKET; }
+
+    template <typename Protocol>
+    int name(const Protocol &) const { return SO_REUSEPORT; }
+
+    template <typename Protocol>
+    const void *data(const Protocol &) const { return &m_value; }
+
+    template <typename Protocol>
+    std::size_t size(const Protocol &) const { return sizeof(m_value); }
+
+private:
+    int m_value;
+};
+
+chord_http_server::HttpAcceptor::HttpAcceptor(
+    boost::asio::io_context &ioctx,
+    std::shared_ptr<const HttpRouter> router,
+    const HttpAcceptorOptions &options)
     : std::enable_shared_from_this<HttpAcceptor>(),
       m_ioctx(ioctx),
-      m_acceptor(boost::asio::make_strand(ioctx))
+      m_acceptor(options.strandPerConnection
+          ? boost::asio::any_io_executor(boost::asio::make_strand(ioctx))
+          : boost::asio::any_io_executor(ioctx.get_executor())),
+      m_router(std::move(router)),
+      m_options(options)
 {
+    TU_ASSERT (m_router != nullptr);
 }
 
 tempo_utils::Status
@@ -30,6 +64,14 @@ chord_http_server::HttpAcceptor::initialize(boost::asio::ip::tcp::endpoint endpo
         return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
             "failed to set socket option: {}", ec.message());
 
+    // enable port reuse so each shard can listen on the same endpoint
+    if (m_options.reusePort) {
+        m_acceptor.set_option(ReusePortOption(true), ec);
+        if(ec)
+            return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+                "failed to set socket option: {}", ec.message());
+    }
+
     // bind to the server address
     m_acceptor.bind(endpoint, ec);
     if(ec)
@@ -49,6 +91,13 @@ chord_http_server::HttpAcceptor::initialize(boost::asio::ip::tcp::endpoint endpo
 }
 
 
+boost::asio::ip::tcp::endpoint
+chord_http_server::HttpAcceptor::getLocalEndpoint() const
+{
+    boost::beast::error_code ec;
+    return m_acceptor.local_endpoint(ec);
+}
+
 void
 chord_http_server::HttpAcceptor::run()
 {
@@ -58,12 +107,15 @@ chord_http_server::HttpAcceptor::run()
 void
 chord_http_server::HttpAcceptor::doAccept()
 {
+    // when the io_context is run by a single thread the connection does not need a strand
+    boost::asio::any_io_executor executor = m_options.strandPerConnection
+        ? boost::asio::any_io_executor(boost::asio::make_strand(m_ioctx))
+        : boost::asio::any_io_executor(m_ioctx.get_executor());
     m_acceptor.async_accept(
-        boost::asio::make_strand(m_ioctx),
+        executor,
         boost::beast::bind_front_handler(
             &HttpAcceptor::onAccept,
             shared_from_this()));
-    TU_LOG_INFO << "async_accept";
 }
 
 void
@@ -76,10 +128,10 @@ chord_http_server::HttpAcceptor::onAccept(
         return; // To avoid infinite loop
     }
 
-    TU_LOG_INFO << "accepted connection";
+    TU_LOG_V << "accepted connection";
 
     // Create the session and run it
-    auto session = std::make_shared<HttpSession>(std::move(socket));
+    auto session = std::make_shared<HttpSession>(std::move(socket), m_router, m_options.sessionOptions);
     session->run();
 
     // Accept another connection
@@ -0,0 +1,60 @@
+
+#include <absl/strings/str_cat.h>
+
+#include <chord_http_server/http_handler.h>
+#include <chord_http_server/http_session.h>
+#include <tempo_utils/log_stream.h>
+
+chord_http_server::HttpReply::HttpReply(std::shared_ptr<HttpSession> session, tu_uint64 requestId)
+    : m_session(std::move(session)),
+      m_requestId(requestId)
+{
+    TU_ASSERT (m_session != nullptr);
+}
+
+void
+chord_http_server::HttpReply::send(HttpResponse &&response) const
+{
+    m_session->completeRequest(m_requestId, std::move(response));
+}
+
+void
+chord_http_server::HttpReply::sendError(boost::beast::http::status status, std::string_view message) const
+{
+    HttpResponse response;
+    response.result(status);
+    response.set(boost::beast::http::field::content_type, "text/plain");
+    response.body() = absl::StrCat(message, "\n");
+    send(std::move(response));
+}
+
+/**
+ * Returns the executor of the session which received the request, which handlers may use to
+ * schedule work such as timers alongside the session.
+ */
+boost::asio::any_io_executor
+chord_http_server::HttpReply::getExecutor() const
+{
+    return m_session->m_stream.get_executor();
+}
+
+chord_http_server::StaticHttpHandler::StaticHttpHandler(std::string_view contentType, std::string_view body)
+    : m_contentType(contentType),
+      m_body(body)
+{
+}
+
+void
+chord_http_server::StaticHttpHandler::handleRequest(const HttpRequest &request, HttpReply reply)
+{
+    HttpResponse response;
+    response.result(boost::beast::http::status::ok);
+    response.set(boost::beast::http::field::content_type, m_contentType);
+    // a HEAD response carries the content length of the body without the body itself
+    if (request.method() == boost::beast::http::verb::head) {
+        response.content_length(m_body.size());
+    } else {
+        response.body() = m_body;
+    }
+    reply.send(std::move(response));
+}
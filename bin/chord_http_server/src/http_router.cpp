@@ -0,0 +1,70 @@
+
+#include <algorithm>
+
+#include <chord_http_server/http_router.h>
+#include <tempo_utils/log_stream.h>
+
+chord_http_server::HttpRouter::HttpRouter()
+{
+}
+
+tempo_utils::Status
+chord_http_server::HttpRouter::addRoute(
+    std::string_view prefix,
+    std::shared_ptr<AbstractHttpHandler> handler)
+{
+    if (prefix.empty() || prefix.front() != '/')
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid route prefix '{}'", prefix);
+    if (handler == nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "invalid handler for route prefix '{}'", prefix);
+
+    // a trailing separator is not significant, except for the root prefix
+    if (prefix.size() > 1 && prefix.back() == '/') {
+        prefix.remove_suffix(1);
+    }
+
+    for (const auto &route : m_routes) {
+        if (route.prefix == prefix)
+            return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+                "route prefix '{}' is already registered", prefix);
+    }
+
+    Route route;
+    route.prefix = std::string(prefix);
+    route.handler = std::move(handler);
+    auto it = std::find_if(m_routes.begin(), m_routes.end(), [&](const Route &r) {
+        return r.prefix.size() < route.prefix.size();
+    });
+    m_routes.insert(it, std::move(route));
+
+    return {};
+}
+
+/**
+ * Find the handler for the specified request target. Any query string is ignored when matching.
+ *
+ * @param target The request target.
+ * @return The handler for the longest matching prefix, or nullptr if no prefix matches.
+ */
+chord_http_server::AbstractHttpHandler *
+chord_http_server::HttpRouter::findRoute(std::string_view target) const
+{
+    auto path = target.substr(0, target.find_first_of("?#"));
+
+    for (const auto &route : m_routes) {
+        const auto &prefix = route.prefix;
+        if (!path.starts_with(prefix))
+            continue;
+        if (path.size() == prefix.size() || prefix.back() == '/' || path[prefix.size()] == '/')
+            return route.handler.get();
+    }
+    return nullptr;
+}
+
+int
+chord_http_server::HttpRouter::numRoutes() const
+{
+    return m_routes.size();
+}
@@ -1,18 +1,74 @@
 
+#include <algorithm>
+#include <thread>
+
 #include <chord_http_server/http_service.h>
 #include <tempo_utils/log_stream.h>
 
-chord_http_server::HttpService::HttpService(int numWorkers)
-    : m_ioctx(numWorkers + 1),
-      m_workerThreads(numWorkers)
+chord_http_server::HttpService::HttpService(
+    std::shared_ptr<const HttpRouter> router,
+    const HttpServiceOptions &options)
+    : m_router(std::move(router)),
+      m_options(options),
+      m_running(false)
 {
-    m_acceptor = std::make_shared<HttpAcceptor>(m_ioctx);
+    TU_ASSERT (m_router != nullptr);
+    m_numWorkers = m_options.numWorkers;
+    if (m_numWorkers <= 0) {
+        m_numWorkers = std::max<int>(std::thread::hardware_concurrency(), 1);
+    }
 }
 
 tempo_utils::Status
 chord_http_server::HttpService::initialize(boost::asio::ip::tcp::endpoint endpoint)
 {
-    return m_acceptor->initialize(endpoint);
+    if (m_acceptor != nullptr || !m_shards.empty())
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "http service is already initialized");
+
+    if (m_options.mode == HttpServiceMode::Shared) {
+        HttpAcceptorOptions acceptorOptions;
+        acceptorOptions.sessionOptions = m_options.sessionOptions;
+        m_ioctx = std::make_unique<boost::asio::io_context>(m_numWorkers + 1);
+        m_workerThreads.resize(m_numWorkers);
+        m_acceptor = std::make_shared<HttpAcceptor>(*m_ioctx, m_router, acceptorOptions);
+        return m_acceptor->initialize(endpoint);
+    }
+
+    // each shard is run by a single thread, so connections do not need a strand
+    HttpAcceptorOptions acceptorOptions;
+    acceptorOptions.reusePort = true;
+    acceptorOptions.strandPerConnection = false;
+    acceptorOptions.sessionOptions = m_options.sessionOptions;
+
+    for (int i = 0; i < m_numWorkers; i++) {
+        auto shard = std::make_unique<Shard>();
+        shard->acceptor = std::make_shared<HttpAcceptor>(shard->ioctx, m_router, acceptorOptions);
+        TU_RETURN_IF_NOT_OK (shard->acceptor->initialize(endpoint));
+        // if an ephemeral port was requested then the remaining shards bind the same port
+        if (endpoint.port() == 0) {
+            endpoint.port(shard->acceptor->getLocalEndpoint().port());
+        }
+        m_shards.push_back(std::move(shard));
+    }
+
+    return {};
+}
+
+int
+chord_http_server::HttpService::getNumWorkers() const
+{
+    return m_numWorkers;
+}
+
+boost::asio::ip::tcp::endpoint
+chord_http_server::HttpService::getLocalEndpoint() const
+{
+    if (m_acceptor != nullptr)
+        return m_acceptor->getLocalEndpoint();
+    if (!m_shards.empty())
+        return m_shards.front()->acceptor->getLocalEndpoint();
+    return {};
 }
 
 static void
@@ -38,26 +94,61 @@ worker_thread(void *data)
 tempo_utils::Status
 chord_http_server::HttpService::run()
 {
-    TU_LOG_INFO << "starting http service";
-    // start worker threads first
-    for (int i = 0; i < m_workerThreads.size(); i++) {
-        uv_thread_create(&m_workerThreads[i], worker_thread, &m_ioctx);
+    if (m_running)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "http service is already running");
+
+    if (m_options.mode == HttpServiceMode::Shared) {
+        if (m_acceptor == nullptr)
+            return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+                "http service is not initialized");
+        TU_LOG_INFO << "starting http service with " << m_numWorkers << " workers";
+        // start worker threads first
+        for (int i = 0; i < m_workerThreads.size(); i++) {
+            uv_thread_create(&m_workerThreads[i], worker_thread, m_ioctx.get());
+        }
+        // then start listener thread to start accepting connections
+        uv_thread_create(&m_listenerThread, listener_thread, m_acceptor.get());
+    } else {
+        if (m_shards.empty())
+            return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+                "http service is not initialized");
+        TU_LOG_INFO << "starting http service with " << m_shards.size() << " shards";
+        // each shard accepts, parses and responds on its own thread
+        for (auto &shard : m_shards) {
+            uv_thread_create(&shard->thread, worker_thread, &shard->ioctx);
+        }
     }
-    // then start listener thread to start accepting connections
-    uv_thread_create(&m_listenerThread, listener_thread, m_acceptor.get());
+
+    m_running = true;
     return {};
 }
 
 tempo_utils::Status
 chord_http_server::HttpService::shutdown()
 {
+    if (!m_running)
+        return {};
+    m_running = false;
+
     TU_LOG_INFO << "stopping http service";
-    // signal io context to stop processing
-    m_ioctx.stop();
-    // this will cause threads to terminate, so we can join them
-    uv_thread_join(&m_listenerThread);
-    for (int i = 0; i < m_workerThreads.size(); i++) {
-        uv_thread_join(&m_workerThreads[i]);
+
+    if (m_options.mode == HttpServiceMode::Shared) {
+        // signal io context to stop processing
+        m_ioctx->stop();
+        // this will cause threads to terminate, so we can join them
+        uv_thread_join(&m_listenerThread);
+        for (int i = 0; i < m_workerThreads.size(); i++) {
+            uv_thread_join(&m_workerThreads[i]);
+        }
+    } else {
+        for (auto &shard : m_shards) {
+            shard->ioctx.stop();
+        }
+        for (auto &shard : m_shards) {
+            uv_thread_join(&shard->thread);
+        }
     }
+
     return {};
 }
@@ -1,17 +1,34 @@
+#include <boost/asio/dispatch.hpp>
 
 #include <chord_http_server/http_session.h>
 #include <tempo_utils/log_stream.h>
 
-chord_http_server::HttpSession::HttpSession(boost::asio::ip::tcp::socket&& socket)
+chord_http_server::HttpSession::HttpSession(
+    boost::asio::ip::tcp::socket&& socket,
+    std::shared_ptr<const HttpRouter> router,
+    const HttpSessionOptions &options)
     : std::enable_shared_from_this<HttpSession>(),
-      m_stream(std::move(socket))
+      m_stream(std::move(socket)),
+      m_router(std::move(router)),
+      m_options(options),
+      m_nextRequestId(0),
+      m_reading(false),
+      m_writing(false),
+      m_closing(false)
 {
+    TU_ASSERT (m_router != nullptr);
+    TU_ASSERT (m_options.maxPipelinedRequests > 0);
+    // the buffer is reused for every request on the connection
+    m_buffer.reserve(m_options.initialBufferBytes);
 }
 
 void
 chord_http_server::HttpSession::run()
 {
-    TU_LOG_INFO << "starting http session";
+    // disable nagle so small responses are not delayed waiting for the next request
+    boost::beast::error_code ec;
+    m_stream.socket().set_option(boost::asio::ip::tcp::no_delay(true), ec);
+
     boost::asio::dispatch(m_stream.get_executor(),
                   boost::beast::bind_front_handler(
                       &HttpSession::doRead, shared_from_this()));
@@ -20,89 +37,217 @@ chord_http_server::HttpSession::run()
 void
 chord_http_server::HttpSession::doRead()
 {
-    // otherwise the operation behavior is undefined.
-    m_req = {};
+    // stop reading if the connection is closing or too many responses are pending, reading
+    // resumes once a response has been written
+    if (m_reading || m_closing || m_pending.size() >= m_options.maxPipelinedRequests)
+        return;
+    m_reading = true;
+
+    // a new parser is required for each request
+    m_parser.emplace();
+    m_parser->header_limit(m_options.maxHeaderBytes);
+    m_parser->body_limit(m_options.maxBodyBytes);
+
+    // if a pipelined request is already buffered then parse it immediately
+    if (m_buffer.size() > 0)
+        return doReadHeader();
+
+    // otherwise wait for the client to start the next request, limited by the idle timeout
+    m_stream.expires_after(absl::ToChronoMilliseconds(m_options.idleTimeout));
+    m_stream.async_read_some(
+        m_buffer.prepare(m_options.initialBufferBytes),
+        boost::beast::bind_front_handler(
+            &HttpSession::onIdleRead, shared_from_this()));
+}
+
+void
+chord_http_server::HttpSession::onIdleRead(
+    boost::beast::error_code ec,
+    std::size_t bytes_transferred)
+{
+    if (ec)
+        return handleReadError(ec);
+    m_buffer.commit(bytes_transferred);
+    doReadHeader();
+}
+
+void
+chord_http_server::HttpSession::doReadHeader()
+{
+    // once the request has started the client must send the complete header promptly
+    m_stream.expires_after(absl::ToChronoMilliseconds(m_options.headerTimeout));
+    boost::beast::http::async_read_header(
+        m_stream, m_buffer, *m_parser, boost::beast::bind_front_handler(
+            &HttpSession::onReadHeader, shared_from_this()));
+}
+
+void
+chord_http_server::HttpSession::onReadHeader(
+    boost::beast::error_code ec,
+    std::size_t bytes_transferred)
+{
+    boost::ignore_unused(bytes_transferred);
 
-    // Set the timeout.
-    m_stream.expires_after(std::chrono::seconds(30));
+    if (ec)
+        return handleReadError(ec);
 
-    // Read a request
+    // read the body of the request
+    m_stream.expires_after(absl::ToChronoMilliseconds(m_options.requestTimeout));
     boost::beast::http::async_read(
-        m_stream, m_buffer, m_req, boost::beast::bind_front_handler(
-            &HttpSession::handleRequest, shared_from_this()));
+        m_stream, m_buffer, *m_parser, boost::beast::bind_front_handler(
+            &HttpSession::onReadRequest, shared_from_this()));
 }
 
 void
-chord_http_server::HttpSession::handleRequest(
+chord_http_server::HttpSession::onReadRequest(
     boost::beast::error_code ec,
     std::size_t bytes_transferred)
 {
     boost::ignore_unused(bytes_transferred);
 
-    // This means they closed the connection
-    if(ec == boost::beast::http::error::end_of_stream)
-        return doClose();
+    if (ec)
+        return handleReadError(ec);
 
-    if(ec) {
-        TU_LOG_ERROR << "request failed: " << ec.message();
-        return;
+    m_reading = false;
+    dispatchRequest(m_parser->release());
+    m_parser.reset();
+
+    // read the next pipelined request
+    doRead();
+}
+
+void
+chord_http_server::HttpSession::handleReadError(boost::beast::error_code ec)
+{
+    m_reading = false;
+    m_parser.reset();
+
+    namespace http = boost::beast::http;
+
+    // if the request was invalid then respond with an error and close the connection
+    if (ec == http::error::header_limit)
+        return rejectRequest(http::status::request_header_fields_too_large, "request header is too large");
+    if (ec == http::error::body_limit)
+        return rejectRequest(http::status::payload_too_large, "request body is too large");
+    if (ec.category() == http::make_error_code(http::error::bad_target).category()
+        && ec != http::error::end_of_stream && ec != http::error::partial_message)
+        return rejectRequest(http::status::bad_request, "invalid request");
+
+    // otherwise the client closed the connection or the read timed out
+    if (ec != http::error::end_of_stream && ec != boost::beast::error::timeout) {
+        TU_LOG_V << "read failed: " << ec.message();
     }
 
-    TU_LOG_INFO << "request: " << std::string(m_req.method_string())
-        << " " << std::string(m_req.target())
-        << " " << m_req.version();
-    for (const auto &field : m_req) {
-        TU_LOG_INFO << "header: " << std::string(field.name_string()) << ": " << std::string(field.value());
+    // write any pending responses before closing the connection
+    m_closing = true;
+    if (m_pending.empty()) {
+        doClose();
     }
+}
+
+void
+chord_http_server::HttpSession::dispatchRequest(HttpRequest &&request)
+{
+    auto requestId = m_nextRequestId++;
+    bool keepAlive = request.keep_alive();
+    m_pending.push_back({requestId, request.version(), keepAlive, {}});
+
+    // if the client asked to close the connection then stop reading after this request
+    if (!keepAlive) {
+        m_closing = true;
+    }
+
+    HttpReply reply(shared_from_this(), requestId);
+    auto target = request.target();
+    auto *handler = m_router->findRoute(std::string_view(target.data(), target.size()));
+    if (handler == nullptr)
+        return reply.sendError(boost::beast::http::status::not_found, "not found");
+    handler->handleRequest(request, std::move(reply));
+}
+
+void
+chord_http_server::HttpSession::rejectRequest(boost::beast::http::status status, std::string_view message)
+{
+    auto requestId = m_nextRequestId++;
+    m_pending.push_back({requestId, 11, false, {}});
+    m_closing = true;
+    HttpReply reply(shared_from_this(), requestId);
+    reply.sendError(status, message);
+}
+
+/**
+ * Complete the request with the specified id. This may be called from any thread; the response
+ * is dispatched onto the session executor before the pending response queue is touched.
+ */
+void
+chord_http_server::HttpSession::completeRequest(tu_uint64 requestId, HttpResponse &&response)
+{
+    boost::asio::dispatch(m_stream.get_executor(),
+        [self = shared_from_this(), requestId, response = std::move(response)]() mutable {
+            if (self->m_pending.empty())
+                return;
+            auto firstId = self->m_pending.front().requestId;
+            if (requestId < firstId || requestId - firstId >= self->m_pending.size())
+                return;
+            auto &pending = self->m_pending[requestId - firstId];
+            TU_ASSERT (!pending.response.has_value());
 
-    std::string body{"this is the response body.\n"};
-    boost::beast::http::response<boost::beast::http::string_body> rsp;
-    rsp.result(boost::beast::http::status::ok);
-    rsp.reason("S'all good!");
-    rsp.body() = body;
-    rsp.content_length(body.size());
-    rsp.keep_alive(false);
-    rsp.prepare_payload();
-
-    // Send the response
-    sendResponse(std::move(rsp));
+            response.version(pending.version);
+            response.keep_alive(pending.keepAlive);
+            if (!response.has_content_length() && !response.chunked()) {
+                response.prepare_payload();
+            }
+            pending.response = std::move(response);
+            self->doWrite();
+        });
 }
 
 void
-chord_http_server::HttpSession::sendResponse(boost::beast::http::message_generator&& msg)
+chord_http_server::HttpSession::doWrite()
 {
-    bool keep_alive = msg.keep_alive();
+    // responses are written strictly in request order
+    if (m_writing || m_pending.empty() || !m_pending.front().response.has_value())
+        return;
+    m_writing = true;
 
-    // Write the response
-    boost::beast::async_write(
+    // the response may be written long after the request was read, so the write gets its own
+    // deadline rather than inheriting the expiry of the last read. a pending read keeps its own
+    // deadline, as the stream only updates the timers of operations which are not pending.
+    m_stream.expires_after(absl::ToChronoMilliseconds(m_options.writeTimeout));
+    boost::beast::http::async_write(
         m_stream,
-        std::move(msg),
+        *m_pending.front().response,
         boost::beast::bind_front_handler(
-            &HttpSession::onWrite, shared_from_this(), keep_alive));
+            &HttpSession::onWrite, shared_from_this()));
 }
 
 void
 chord_http_server::HttpSession::onWrite(
-    bool keep_alive,
     boost::beast::error_code ec,
     std::size_t bytes_transferred)
 {
     boost::ignore_unused(bytes_transferred);
+    m_writing = false;
 
-    if(ec) {
-        TU_LOG_ERROR << "write failed: " << ec.message();
-        return;
+    if (ec) {
+        TU_LOG_V << "write failed: " << ec.message();
+        m_pending.clear();
+        m_closing = true;
+        return doClose();
     }
 
-    if(! keep_alive)
-    {
-        // This means we should close the connection, usually because
-        // the response indicated the "Connection: close" semantic.
+    bool keepAlive = m_pending.front().keepAlive;
+    m_pending.pop_front();
+
+    // the response indicated the "Connection: close" semantic
+    if (!keepAlive || (m_closing && m_pending.empty() && !m_reading)) {
+        m_pending.clear();
         return doClose();
     }
 
-    // Read another request
+    // resume reading if it was paused by the pipeline limit, then write the next response
     doRead();
+    doWrite();
 }
 
 void
@@ -114,4 +259,3 @@ chord_http_server::HttpSession::doClose()
 
     // At this point the connection is closed gracefully
 }
-
@@ -0,0 +1,323 @@
+#include <absl/strings/str_cat.h>
+#include <absl/time/clock.h>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include <chord_common/gateway_protocol.h>
+#include <chord_http_server/gateway_handler.h>
+#include <chord_http_server/http_router.h>
+#include <chord_http_server/http_service.h>
+#include <tempo_utils/log_stream.h>
+
+static std::string_view
+to_string_view(std::shared_ptr<const tempo_utils::ImmutableBytes> bytes)
+{
+    return std::string_view((const char *) bytes->getData(), bytes->getSize());
+}
+
+TEST(Gateway, RequestFrameRoundTrip)
+{
+    chord_common::GatewayRequestFrame frame;
+    frame.requestId = 42;
+    frame.method = "POST";
+    frame.target = "/items?limit=10";
+    frame.contentType = "application/json";
+    frame.body = std::string("{\"a\":1}\0tail", 12);
+
+    auto writeFrameResult = chord_common::write_gateway_request(frame);
+    ASSERT_TRUE (writeFrameResult.isResult());
+    auto bytes = writeFrameResult.getResult();
+
+    chord_common::GatewayRequestFrame decoded;
+    ASSERT_TRUE (chord_common::read_gateway_request(to_string_view(bytes), decoded).isOk());
+    ASSERT_EQ (42u, decoded.requestId);
+    ASSERT_EQ ("POST", decoded.method);
+    ASSERT_EQ ("/items?limit=10", decoded.target);
+    ASSERT_EQ ("application/json", decoded.contentType);
+    ASSERT_EQ (frame.body, decoded.body);
+}
+
+TEST(Gateway, ResponseFrameRoundTrip)
+{
+    chord_common::GatewayResponseFrame frame;
+    frame.requestId = 7;
+    frame.statusCode = 201;
+    frame.contentType = "text/plain";
+    frame.body = "created\n";
+
+    auto writeFrameResult = chord_common::write_gateway_response(frame);
+    ASSERT_TRUE (writeFrameResult.isResult());
+    auto bytes = writeFrameResult.getResult();
+
+    chord_common::GatewayResponseFrame decoded;
+    ASSERT_TRUE (chord_common::read_gateway_response(to_string_view(bytes), decoded).isOk());
+    ASSERT_EQ (7u, decoded.requestId);
+    ASSERT_EQ (201, decoded.statusCode);
+    ASSERT_EQ ("text/plain", decoded.contentType);
+    ASSERT_EQ ("created\n", decoded.body);
+}
+
+TEST(Gateway, TruncatedFrameIsRejected)
+{
+    chord_common::GatewayResponseFrame frame;
+    frame.requestId = 1;
+    frame.statusCode = 200;
+    frame.contentType = "text/plain";
+    auto bytes = chord_common::write_gateway_response(frame).getResult();
+    auto data = to_string_view(bytes);
+
+    chord_common::GatewayResponseFrame decoded;
+    ASSERT_FALSE (chord_common::read_gateway_response(data.substr(0, 6), decoded).isOk());
+    ASSERT_FALSE (chord_common::read_gateway_response(data.substr(0, data.size() - 1), decoded).isOk());
+}
+
+TEST(Gateway, ParseGatewayTarget)
+{
+    chord_http_server::GatewayTarget target;
+    ASSERT_TRUE (chord_http_server::parse_gateway_target(
+        "/api/=dns:///localhost:9000,dev.zuri.proto:http", target).isOk());
+    ASSERT_EQ ("/api", target.prefix);
+    ASSERT_EQ ("dns:///localhost:9000", target.endpointUrl.toString());
+    ASSERT_EQ ("dev.zuri.proto:http", target.protocolUrl.toString());
+
+    ASSERT_FALSE (chord_http_server::parse_gateway_target("/api", target).isOk());
+    ASSERT_FALSE (chord_http_server::parse_gateway_target("api=dns:///localhost:9000,dev.zuri.proto:http", target).isOk());
+    ASSERT_FALSE (chord_http_server::parse_gateway_target("/api=dns:///localhost:9000", target).isOk());
+}
+
+/**
+ * Writer which adapts the server end of a synchronous Communicate stream, so a protocol handler
+ * can be attached to it.
+ */
+class ServerStreamWriter : public chord_common::AbstractProtocolWriter {
+public:
+    explicit ServerStreamWriter(
+        grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message> *stream)
+        : m_stream(stream)
+    {
+    }
+
+    tempo_utils::Status write(std::string_view message) override {
+        chord_remoting::Message outgoing;
+        outgoing.set_version(chord_remoting::MessageVersion::Version1);
+        outgoing.set_data(std::string(message));
+        if (!m_stream->Write(outgoing))
+            return tempo_utils::GenericStatus::forCondition(
+                tempo_utils::GenericCondition::kInternalViolation, "write failure");
+        return {};
+    }
+
+    tempo_utils::Status grantCredit(tu_uint32 credit) override {
+        chord_remoting::Message grant;
+        grant.set_version(chord_remoting::MessageVersion::Version1);
+        auto *header = grant.add_headers();
+        header->set_name(chord_common::kProtocolCreditHeader);
+        header->set_value(absl::StrCat(credit));
+        if (!m_stream->Write(grant))
+            return tempo_utils::GenericStatus::forCondition(
+                tempo_utils::GenericCondition::kInternalViolation, "write failure");
+        return {};
+    }
+
+private:
+    grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message> *m_stream;
+};
+
+/**
+ * Service which serves each Communicate stream with a GatewayPortHandler, the same way a machine
+ * port serves requests forwarded by the gateway.
+ */
+class GatewayPortService : public chord_remoting::RemotingService::Service {
+public:
+    explicit GatewayPortService(chord_common::GatewayRequestCallback callback)
+        : m_callback(std::move(callback))
+    {
+    }
+
+    grpc::Status Communicate(
+        grpc::ServerContext *context,
+        grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message> *stream) override
+    {
+        stream->SendInitialMetadata();
+        ServerStreamWriter writer(stream);
+        chord_common::GatewayPortHandler handler(m_callback);
+        if (handler.attach(&writer).notOk())
+            return grpc::Status(grpc::StatusCode::INTERNAL, "failed to attach handler");
+        chord_remoting::Message message;
+        while (stream->Read(&message)) {
+            TU_LOG_WARN_IF (handler.handle(message.data()).notOk()) << "failed to handle message";
+            message.Clear();
+        }
+        handler.detach();
+        return grpc::Status::OK;
+    }
+
+private:
+    chord_common::GatewayRequestCallback m_callback;
+};
+
+TEST(Gateway, PortHandlerAnswersWithRequestId)
+{
+    class CapturingWriter : public chord_common::AbstractProtocolWriter {
+    public:
+        tempo_utils::Status write(std::string_view message) override {
+            written.emplace_back(message);
+            return {};
+        }
+        tempo_utils::Status grantCredit(tu_uint32 credit) override {
+            granted += credit;
+            return {};
+        }
+        std::vector<std::string> written;
+        tu_uint32 granted = 0;
+    };
+
+    chord_common::GatewayPortHandler handler([](const chord_common::GatewayRequestFrame &request) {
+        chord_common::GatewayResponseFrame response;
+        response.statusCode = 200;
+        response.body = request.target;
+        return response;
+    }, 4);
+
+    CapturingWriter writer;
+    ASSERT_TRUE (handler.attach(&writer).isOk());
+    ASSERT_EQ (4u, writer.granted);
+
+    chord_common::GatewayRequestFrame request;
+    request.requestId = 9;
+    request.method = "GET";
+    request.target = "/thing";
+    auto bytes = chord_common::write_gateway_request(request).getResult();
+    ASSERT_TRUE (handler.handle(to_string_view(bytes)).isOk());
+
+    ASSERT_EQ (1u, writer.written.size());
+    ASSERT_EQ (5u, writer.granted);
+    chord_common::GatewayResponseFrame response;
+    ASSERT_TRUE (chord_common::read_gateway_response(writer.written.front(), response).isOk());
+    ASSERT_EQ (9u, response.requestId);
+    ASSERT_EQ (200, response.statusCode);
+    ASSERT_EQ ("/thing", response.body);
+}
+
+TEST(Gateway, ForwardRequestsThroughCommunicateStream)
+{
+    GatewayPortService portService([](const chord_common::GatewayRequestFrame &request) {
+        chord_common::GatewayResponseFrame response;
+        response.statusCode = 201;
+        response.contentType = "text/plain";
+        response.body = absl::StrCat(request.method, " ", request.target, " ", request.body);
+        return response;
+    });
+    int grpcPort = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &grpcPort);
+    builder.RegisterService(&portService);
+    auto grpcServer = builder.BuildAndStart();
+    ASSERT_TRUE (grpcServer != nullptr);
+    ASSERT_NE (0, grpcPort);
+
+    chord_http_server::GatewayTarget target;
+    ASSERT_TRUE (chord_http_server::parse_gateway_target(
+        absl::StrCat("/api=dns:///127.0.0.1:", grpcPort, ",dev.zuri.proto:test"), target).isOk());
+    auto gatewayHandler = std::make_shared<chord_http_server::GatewayHandler>(
+        target, grpc::InsecureChannelCredentials());
+    ASSERT_TRUE (gatewayHandler->initialize().isOk());
+
+    auto router = std::make_shared<chord_http_server::HttpRouter>();
+    ASSERT_TRUE (router->addRoute(target.prefix, gatewayHandler).isOk());
+    chord_http_server::HttpServiceOptions serviceOptions;
+    serviceOptions.numWorkers = 1;
+    chord_http_server::HttpService service(router, serviceOptions);
+    ASSERT_TRUE (service.initialize({boost::asio::ip::make_address("127.0.0.1"), 0}).isOk());
+    ASSERT_TRUE (service.run().isOk());
+
+    boost::asio::io_context ioctx;
+    boost::asio::ip::tcp::socket socket(ioctx);
+    socket.connect(service.getLocalEndpoint());
+
+    // send several requests on the same connection, all multiplexed over the one stream
+    for (int i = 0; i < 3; i++) {
+        chord_http_server::HttpRequest request(boost::beast::http::verb::post,
+            absl::StrCat("/api/items/", i), 11);
+        request.set(boost::beast::http::field::host, "localhost");
+        request.set(boost::beast::http::field::content_type, "text/plain");
+        request.body() = absl::StrCat("body", i);
+        request.prepare_payload();
+        boost::beast::http::write(socket, request);
+
+        boost::beast::flat_buffer buffer;
+        chord_http_server::HttpResponse response;
+        boost::beast::http::read(socket, buffer, response);
+        ASSERT_EQ (201, response.result_int());
+        ASSERT_EQ ("text/plain", response[boost::beast::http::field::content_type]);
+        ASSERT_EQ (absl::StrCat("POST /items/", i, " body", i), response.body());
+    }
+
+    boost::system::error_code ec;
+    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    socket.close(ec);
+    ASSERT_TRUE (service.shutdown().isOk());
+    grpcServer->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+    ASSERT_TRUE (gatewayHandler->shutdown().isOk());
+}
+
+TEST(Gateway, UnansweredRequestTimesOutWithGatewayTimeout)
+{
+    // the port answers long after the gateway request timeout
+    GatewayPortService portService([](const chord_common::GatewayRequestFrame &request) {
+        absl::SleepFor(absl::Milliseconds(500));
+        chord_common::GatewayResponseFrame response;
+        response.statusCode = 200;
+        return response;
+    });
+    int grpcPort = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &grpcPort);
+    builder.RegisterService(&portService);
+    auto grpcServer = builder.BuildAndStart();
+    ASSERT_TRUE (grpcServer != nullptr);
+
+    chord_http_server::GatewayTarget target;
+    ASSERT_TRUE (chord_http_server::parse_gateway_target(
+        absl::StrCat("/api=dns:///127.0.0.1:", grpcPort, ",dev.zuri.proto:test"), target).isOk());
+    target.requestTimeout = absl::Milliseconds(100);
+    auto gatewayHandler = std::make_shared<chord_http_server::GatewayHandler>(
+        target, grpc::InsecureChannelCredentials());
+    ASSERT_TRUE (gatewayHandler->initialize().isOk());
+
+    auto router = std::make_shared<chord_http_server::HttpRouter>();
+    ASSERT_TRUE (router->addRoute(target.prefix, gatewayHandler).isOk());
+    chord_http_server::HttpServiceOptions serviceOptions;
+    serviceOptions.numWorkers = 1;
+    chord_http_server::HttpService service(router, serviceOptions);
+    ASSERT_TRUE (service.initialize({boost::asio::ip::make_address("127.0.0.1"), 0}).isOk());
+    ASSERT_TRUE (service.run().isOk());
+
+    boost::asio::io_context ioctx;
+    boost::asio::ip::tcp::socket socket(ioctx);
+    socket.connect(service.getLocalEndpoint());
+
+    chord_http_server::HttpRequest request(boost::beast::http::verb::get, "/api/slow", 11);
+    request.set(boost::beast::http::field::host, "localhost");
+    boost::beast::http::write(socket, request);
+
+    boost::beast::flat_buffer buffer;
+    chord_http_server::HttpResponse response;
+    boost::beast::http::read(socket, buffer, response);
+    ASSERT_EQ (504, response.result_int());
+
+    boost::system::error_code ec;
+    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    socket.close(ec);
+    ASSERT_TRUE (service.shutdown().isOk());
+    grpcServer->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+    ASSERT_TRUE (gatewayHandler->shutdown().isOk());
+}
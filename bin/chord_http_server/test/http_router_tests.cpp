@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_http_server/http_router.h>
+
+class NullHandler : public chord_http_server::AbstractHttpHandler {
+public:
+    void handleRequest(const chord_http_server::HttpRequest &request, chord_http_server::HttpReply reply) override {}
+};
+
+TEST(HttpRouter, FindLongestMatchingPrefix)
+{
+    chord_http_server::HttpRouter router;
+    auto root = std::make_shared<NullHandler>();
+    auto api = std::make_shared<NullHandler>();
+    auto apiV1 = std::make_shared<NullHandler>();
+    ASSERT_TRUE (router.addRoute("/", root).isOk());
+    ASSERT_TRUE (router.addRoute("/api", api).isOk());
+    ASSERT_TRUE (router.addRoute("/api/v1/", apiV1).isOk());
+    ASSERT_EQ (3, router.numRoutes());
+
+    ASSERT_EQ (root.get(), router.findRoute("/"));
+    ASSERT_EQ (root.get(), router.findRoute("/other"));
+    ASSERT_EQ (api.get(), router.findRoute("/api"));
+    ASSERT_EQ (api.get(), router.findRoute("/api/v2/thing"));
+    ASSERT_EQ (apiV1.get(), router.findRoute("/api/v1"));
+    ASSERT_EQ (apiV1.get(), router.findRoute("/api/v1/thing?query=1"));
+}
+
+TEST(HttpRouter, PrefixMatchesOnlyWholeSegments)
+{
+    chord_http_server::HttpRouter router;
+    auto health = std::make_shared<NullHandler>();
+    ASSERT_TRUE (router.addRoute("/health", health).isOk());
+
+    ASSERT_EQ (health.get(), router.findRoute("/health"));
+    ASSERT_EQ (health.get(), router.findRoute("/health?verbose"));
+    ASSERT_EQ (health.get(), router.findRoute("/health/ready"));
+    ASSERT_EQ (nullptr, router.findRoute("/healthz"));
+    ASSERT_EQ (nullptr, router.findRoute("/"));
+}
+
+TEST(HttpRouter, RejectInvalidOrDuplicateRoute)
+{
+    chord_http_server::HttpRouter router;
+    auto handler = std::make_shared<NullHandler>();
+    ASSERT_FALSE (router.addRoute("", handler).isOk());
+    ASSERT_FALSE (router.addRoute("health", handler).isOk());
+    ASSERT_FALSE (router.addRoute("/health", nullptr).isOk());
+    ASSERT_TRUE (router.addRoute("/health", handler).isOk());
+    ASSERT_FALSE (router.addRoute("/health/", handler).isOk());
+}
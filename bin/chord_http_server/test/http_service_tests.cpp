@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_http_server/chord_http_server.h>
+#include <chord_http_server/http_handler.h>
+#include <chord_http_server/http_router.h>
+#include <chord_http_server/http_service.h>
+
+namespace http = boost::beast::http;
+
+TEST(HttpService, ParseIPv4ListenEndpoint)
+{
+    boost::asio::ip::tcp::endpoint endpoint;
+    ASSERT_TRUE (parse_listen_endpoint("127.0.0.1:8080", endpoint).isOk());
+    ASSERT_EQ (boost::asio::ip::make_address("127.0.0.1"), endpoint.address());
+    ASSERT_EQ (8080, endpoint.port());
+}
+
+TEST(HttpService, ParseIPv6ListenEndpoint)
+{
+    boost::asio::ip::tcp::endpoint endpoint;
+    ASSERT_TRUE (parse_listen_endpoint("[::1]:0", endpoint).isOk());
+    ASSERT_EQ (boost::asio::ip::make_address("::1"), endpoint.address());
+    ASSERT_EQ (0, endpoint.port());
+}
+
+TEST(HttpService, ParseListenEndpointFailsWithoutPort)
+{
+    boost::asio::ip::tcp::endpoint endpoint;
+    ASSERT_TRUE (parse_listen_endpoint("127.0.0.1", endpoint).notOk());
+}
+
+TEST(HttpService, ParseListenEndpointFailsWithInvalidPort)
+{
+    boost::asio::ip::tcp::endpoint endpoint;
+    ASSERT_TRUE (parse_listen_endpoint("127.0.0.1:http", endpoint).notOk());
+    ASSERT_TRUE (parse_listen_endpoint("127.0.0.1:65536", endpoint).notOk());
+    ASSERT_TRUE (parse_listen_endpoint("127.0.0.1:-1", endpoint).notOk());
+}
+
+TEST(HttpService, ParseListenEndpointFailsWithInvalidAddress)
+{
+    boost::asio::ip::tcp::endpoint endpoint;
+    ASSERT_TRUE (parse_listen_endpoint("localhost:8080", endpoint).notOk());
+}
+
+TEST(HttpService, ShardedServiceServesEveryConnectionOnOnePort)
+{
+    auto router = std::make_shared<chord_http_server::HttpRouter>();
+    ASSERT_TRUE (router->addRoute("/health",
+        std::make_shared<chord_http_server::StaticHttpHandler>("text/plain", "ok\n")).isOk());
+
+    chord_http_server::HttpServiceOptions options;
+    options.numWorkers = 2;
+    options.mode = chord_http_server::HttpServiceMode::Sharded;
+    chord_http_server::HttpService service(router, options);
+
+    // the second shard binds the ephemeral port chosen by the first, so initialize fails unless
+    // both acceptors share the port
+    ASSERT_TRUE (service.initialize({boost::asio::ip::make_address("127.0.0.1"), 0}).isOk());
+    ASSERT_EQ (2, service.getNumWorkers());
+    auto endpoint = service.getLocalEndpoint();
+    ASSERT_NE (0, endpoint.port());
+    ASSERT_TRUE (service.run().isOk());
+
+    // the kernel spreads new connections across the shards
+    boost::asio::io_context ioctx;
+    for (int i = 0; i < 16; i++) {
+        boost::asio::ip::tcp::socket socket(ioctx);
+        socket.connect(endpoint);
+        chord_http_server::HttpRequest request(http::verb::get, "/health", 11);
+        request.set(http::field::host, "localhost");
+        request.keep_alive(false);
+        http::write(socket, request);
+
+        boost::beast::flat_buffer buffer;
+        chord_http_server::HttpResponse response;
+        http::read(socket, buffer, response);
+        ASSERT_EQ (200, response.result_int());
+        ASSERT_EQ ("ok\n", response.body());
+    }
+
+    ASSERT_TRUE (service.shutdown().isOk());
+}
@@ -0,0 +1,276 @@
+#include <optional>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <absl/strings/str_cat.h>
+#include <absl/synchronization/mutex.h>
+
+#include <chord_http_server/http_service.h>
+
+namespace http = boost::beast::http;
+
+class EchoHandler : public chord_http_server::AbstractHttpHandler {
+public:
+    void handleRequest(const chord_http_server::HttpRequest &request, chord_http_server::HttpReply reply) override {
+        chord_http_server::HttpResponse response(http::status::ok, request.version());
+        response.set(http::field::content_type, "text/plain");
+        response.body() = std::string(request.target());
+        reply.send(std::move(response));
+    }
+};
+
+/**
+ * Handler which holds every reply until the test releases it, so the test controls the order
+ * in which pipelined requests are completed.
+ */
+class DeferredHandler : public chord_http_server::AbstractHttpHandler {
+public:
+    void handleRequest(const chord_http_server::HttpRequest &request, chord_http_server::HttpReply reply) override {
+        absl::MutexLock locker(&m_lock);
+        m_deferred.emplace_back(std::string(request.target()), std::move(reply));
+    }
+
+    bool waitForRequests(size_t numRequests) {
+        auto deadline = absl::Now() + absl::Seconds(10);
+        while (absl::Now() < deadline) {
+            if (this->numRequests() >= numRequests)
+                return true;
+            absl::SleepFor(absl::Milliseconds(5));
+        }
+        return false;
+    }
+
+    size_t numRequests() {
+        absl::MutexLock locker(&m_lock);
+        return m_deferred.size();
+    }
+
+    /**
+     * Send the reply for the request with the specified index, responding with its target.
+     */
+    void release(size_t index) {
+        std::string target;
+        std::optional<chord_http_server::HttpReply> reply;
+        {
+            absl::MutexLock locker(&m_lock);
+            target = m_deferred.at(index).first;
+            reply = m_deferred.at(index).second;
+        }
+        chord_http_server::HttpResponse response(http::status::ok, 11);
+        response.body() = target;
+        reply->send(std::move(response));
+    }
+
+private:
+    absl::Mutex m_lock;
+    std::vector<std::pair<std::string, chord_http_server::HttpReply>> m_deferred ABSL_GUARDED_BY(m_lock);
+};
+
+class HttpSessionTests : public ::testing::Test {
+protected:
+    std::shared_ptr<DeferredHandler> deferred;
+    std::unique_ptr<chord_http_server::HttpService> service;
+    boost::asio::io_context ioctx;
+
+    void SetUp() override {
+        deferred = std::make_shared<DeferredHandler>();
+    }
+
+    void TearDown() override {
+        if (service != nullptr) {
+            ASSERT_TRUE (service->shutdown().isOk());
+        }
+    }
+
+    void startService(const chord_http_server::HttpSessionOptions &sessionOptions = {}) {
+        auto router = std::make_shared<chord_http_server::HttpRouter>();
+        ASSERT_TRUE (router->addRoute("/echo", std::make_shared<EchoHandler>()).isOk());
+        ASSERT_TRUE (router->addRoute("/deferred", deferred).isOk());
+        chord_http_server::HttpServiceOptions serviceOptions;
+        serviceOptions.numWorkers = 1;
+        serviceOptions.sessionOptions = sessionOptions;
+        service = std::make_unique<chord_http_server::HttpService>(router, serviceOptions);
+        ASSERT_TRUE (service->initialize({boost::asio::ip::make_address("127.0.0.1"), 0}).isOk());
+        ASSERT_TRUE (service->run().isOk());
+    }
+
+    boost::asio::ip::tcp::socket connect() {
+        boost::asio::ip::tcp::socket socket(ioctx);
+        socket.connect(service->getLocalEndpoint());
+        return socket;
+    }
+
+    static chord_http_server::HttpRequest makeRequest(const std::string &target, bool keepAlive = true) {
+        chord_http_server::HttpRequest request(http::verb::get, target, 11);
+        request.set(http::field::host, "localhost");
+        request.keep_alive(keepAlive);
+        request.prepare_payload();
+        return request;
+    }
+
+    /**
+     * Returns true if the server has closed the connection.
+     */
+    static bool isClosed(boost::asio::ip::tcp::socket &socket, boost::beast::flat_buffer &buffer) {
+        chord_http_server::HttpResponse response;
+        boost::beast::error_code ec;
+        http::read(socket, buffer, response, ec);
+        return ec == http::error::end_of_stream;
+    }
+};
+
+TEST_F(HttpSessionTests, KeepAliveServesSeveralRequestsOnOneConnection)
+{
+    startService();
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    for (int i = 0; i < 3; i++) {
+        auto target = absl::StrCat("/echo/", i);
+        http::write(socket, makeRequest(target));
+        chord_http_server::HttpResponse response;
+        http::read(socket, buffer, response);
+        ASSERT_EQ (200, response.result_int());
+        ASSERT_TRUE (response.keep_alive());
+        ASSERT_EQ (target, response.body());
+    }
+}
+
+TEST_F(HttpSessionTests, ConnectionCloseClosesAfterResponse)
+{
+    startService();
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    http::write(socket, makeRequest("/echo", /* keepAlive= */ false));
+    chord_http_server::HttpResponse response;
+    http::read(socket, buffer, response);
+    ASSERT_EQ (200, response.result_int());
+    ASSERT_FALSE (response.keep_alive());
+    ASSERT_TRUE (isClosed(socket, buffer));
+}
+
+TEST_F(HttpSessionTests, SlowResponseIsWrittenAfterRequestTimeout)
+{
+    chord_http_server::HttpSessionOptions sessionOptions;
+    sessionOptions.requestTimeout = absl::Milliseconds(100);
+    startService(sessionOptions);
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    // the handler completes after the request timeout has passed
+    http::write(socket, makeRequest("/deferred/slow", /* keepAlive= */ false));
+    ASSERT_TRUE (deferred->waitForRequests(1));
+    absl::SleepFor(absl::Milliseconds(300));
+    deferred->release(0);
+
+    chord_http_server::HttpResponse response;
+    http::read(socket, buffer, response);
+    ASSERT_EQ (200, response.result_int());
+    ASSERT_EQ ("/deferred/slow", response.body());
+    ASSERT_TRUE (isClosed(socket, buffer));
+}
+
+TEST_F(HttpSessionTests, PipelinedResponsesAreWrittenInRequestOrder)
+{
+    startService();
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    // send both requests before reading, then complete the second request first
+    http::write(socket, makeRequest("/deferred/first"));
+    http::write(socket, makeRequest("/deferred/second"));
+    ASSERT_TRUE (deferred->waitForRequests(2));
+    deferred->release(1);
+    deferred->release(0);
+
+    chord_http_server::HttpResponse first;
+    http::read(socket, buffer, first);
+    ASSERT_EQ ("/deferred/first", first.body());
+    chord_http_server::HttpResponse second;
+    http::read(socket, buffer, second);
+    ASSERT_EQ ("/deferred/second", second.body());
+}
+
+TEST_F(HttpSessionTests, ReadingPausesAtPipelineLimit)
+{
+    chord_http_server::HttpSessionOptions sessionOptions;
+    sessionOptions.maxPipelinedRequests = 2;
+    startService(sessionOptions);
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    for (int i = 0; i < 3; i++) {
+        http::write(socket, makeRequest(absl::StrCat("/deferred/", i)));
+    }
+
+    // the third request is not read while two responses are pending
+    ASSERT_TRUE (deferred->waitForRequests(2));
+    absl::SleepFor(absl::Milliseconds(100));
+    ASSERT_EQ (2, deferred->numRequests());
+
+    // writing the first response resumes reading
+    deferred->release(0);
+    ASSERT_TRUE (deferred->waitForRequests(3));
+    deferred->release(1);
+    deferred->release(2);
+
+    for (int i = 0; i < 3; i++) {
+        chord_http_server::HttpResponse response;
+        http::read(socket, buffer, response);
+        ASSERT_EQ (absl::StrCat("/deferred/", i), response.body());
+    }
+}
+
+TEST_F(HttpSessionTests, RejectOversizedHeaderWith431)
+{
+    chord_http_server::HttpSessionOptions sessionOptions;
+    sessionOptions.maxHeaderBytes = 256;
+    startService(sessionOptions);
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    auto request = makeRequest("/echo");
+    request.set("X-Padding", std::string(1024, 'x'));
+    http::write(socket, request);
+
+    chord_http_server::HttpResponse response;
+    http::read(socket, buffer, response);
+    ASSERT_EQ (431, response.result_int());
+    ASSERT_TRUE (isClosed(socket, buffer));
+}
+
+TEST_F(HttpSessionTests, RejectOversizedBodyWith413)
+{
+    chord_http_server::HttpSessionOptions sessionOptions;
+    sessionOptions.maxBodyBytes = 16;
+    startService(sessionOptions);
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    chord_http_server::HttpRequest request(http::verb::post, "/echo", 11);
+    request.set(http::field::host, "localhost");
+    request.body() = std::string(64, 'x');
+    request.prepare_payload();
+    http::write(socket, request);
+
+    chord_http_server::HttpResponse response;
+    http::read(socket, buffer, response);
+    ASSERT_EQ (413, response.result_int());
+    ASSERT_TRUE (isClosed(socket, buffer));
+}
+
+TEST_F(HttpSessionTests, RejectMalformedRequestWith400)
+{
+    startService();
+    auto socket = connect();
+    boost::beast::flat_buffer buffer;
+
+    boost::asio::write(socket, boost::asio::buffer(std::string_view("NOT AN HTTP REQUEST\r\n\r\n")));
+
+    chord_http_server::HttpResponse response;
+    http::read(socket, buffer, response);
+    ASSERT_EQ (400, response.result_int());
+    ASSERT_TRUE (isClosed(socket, buffer));
+}
@@ -1,11 +1,28 @@
 #ifndef CHORD_MACHINE_ABSTRACT_MESSAGE_SENDER_H
 #define CHORD_MACHINE_ABSTRACT_MESSAGE_SENDER_H
 
+#include <atomic>
+#include <string>
+
 namespace chord_machine {
 
+    struct AbstractMessage;
+
+    /**
+     * Intrusive link used to chain a message into a Mailbox. The link is never copied, so copying
+     * a message does not copy its position in a mailbox.
+     */
+    struct MailboxLink {
+        std::atomic<AbstractMessage *> next = nullptr;
+        MailboxLink() = default;
+        MailboxLink(const MailboxLink &) {};
+        MailboxLink& operator=(const MailboxLink &) { return *this; };
+    };
+
     struct AbstractMessage {
         virtual ~AbstractMessage() = default;
         virtual std::string toString() const { return "AbstractMessage"; };
+        MailboxLink link;
     };
 
     template<class MessageType>
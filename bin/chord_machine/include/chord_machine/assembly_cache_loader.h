@@ -0,0 +1,126 @@
+#ifndef CHORD_MACHINE_ASSEMBLY_CACHE_LOADER_H
+#define CHORD_MACHINE_ASSEMBLY_CACHE_LOADER_H
+
+#include <functional>
+#include <list>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/synchronization/mutex.h>
+
+#include <chord_common/assembly_store.h>
+#include <lyric_runtime/abstract_loader.h>
+#include <tempo_utils/integer_types.h>
+#include <zuri_packager/package_specifier.h>
+
+namespace chord_machine {
+
+    struct AssemblyCacheOptions {
+        /**
+         * Maximum total size in bytes of the cached objects. When the limit is exceeded the least
+         * recently used objects are evicted.
+         */
+        tu_uint64 maxCachedBytes = 256 * 1024 * 1024;
+        /**
+         * Maximum number of cached objects.
+         */
+        tu_uint32 maxCachedObjects = 4096;
+    };
+
+    /**
+     * Returns the stamp which identifies the archive of the specified package, or an empty option
+     * if the package has no archive.
+     */
+    using PackageStamper = std::function<
+        tempo_utils::Result<Option<std::string>>(const zuri_packager::PackageSpecifier &)>;
+
+    struct AssemblyCacheStats {
+        tu_uint64 hits = 0;
+        tu_uint64 misses = 0;
+        tu_uint64 evictions = 0;
+        tu_uint64 invalidations = 0;
+        tu_uint64 storeHits = 0;
+        tu_uint64 storeMisses = 0;
+        tu_uint32 cachedObjects = 0;
+        tu_uint64 cachedBytes = 0;
+    };
+
+    /**
+     * Loader which keeps the objects loaded by the wrapped loader in memory, so every interpreter
+     * sharing the loader parses and verifies a module at most once. Objects are immutable once
+     * loaded, so the cached objects are shared between interpreters without copying. Entries are
+     * keyed by module location, and the location includes the versioned package specifier, so a
+     * new version of a package never hits an entry from an older version. A MachineHost shares one
+     * loader between all of its machines, so a module used by many hosted machines is held in
+     * memory once, and the size of the cache bounds that memory.
+     *
+     * If an assembly store is specified then a module which is not in memory is mapped from the
+     * store before falling back to the wrapped loader, and each module loaded by the wrapped loader
+     * is published to the store, so machines sharing the store load and verify a module from its
+     * package archive at most once. If a stamper is specified then the first time a module from a
+     * package is loaded the stored modules of the package are validated against the stamp of its
+     * archive, so a reinstalled package never maps modules stored from the previous archive.
+     */
+    class AssemblyCacheLoader : public lyric_runtime::AbstractLoader {
+    public:
+        explicit AssemblyCacheLoader(
+            std::shared_ptr<lyric_runtime::AbstractLoader> loader,
+            const AssemblyCacheOptions &options = {},
+            std::shared_ptr<chord_common::AssemblyStore> store = {},
+            PackageStamper stamper = {});
+
+        tempo_utils::Result<bool> hasModule(
+            const lyric_common::ModuleLocation &location) const override;
+        tempo_utils::Result<Option<lyric_object::LyricObject>> loadModule(
+            const lyric_common::ModuleLocation &location) override;
+        tempo_utils::Result<Option<lyric_runtime::NativeInterface *>> loadPlugin(
+            const lyric_common::ModuleLocation &location,
+            const lyric_object::PluginSpecifier &specifier) override;
+
+        void invalidate(const lyric_common::ModuleLocation &location);
+        void invalidatePackage(const zuri_packager::PackageSpecifier &specifier);
+        tempo_utils::Status validatePackage(
+            const zuri_packager::PackageSpecifier &specifier,
+            std::string_view stamp);
+        void clear();
+
+        AssemblyCacheStats getStats() const;
+
+    private:
+        struct CacheEntry {
+            std::string key;
+            std::string packageKey;
+            lyric_object::LyricObject object;
+            tu_uint64 size;
+        };
+
+        std::shared_ptr<lyric_runtime::AbstractLoader> m_loader;
+        AssemblyCacheOptions m_options;
+        std::shared_ptr<chord_common::AssemblyStore> m_store;
+        PackageStamper m_stamper;
+        mutable absl::Mutex m_lock;
+        // most recently used entries are at the front of the list
+        std::list<CacheEntry> m_entries ABSL_GUARDED_BY(m_lock);
+        absl::flat_hash_map<std::string,std::list<CacheEntry>::iterator> m_index ABSL_GUARDED_BY(m_lock);
+        AssemblyCacheStats m_stats ABSL_GUARDED_BY(m_lock);
+        absl::flat_hash_set<std::string> m_validatedPackages ABSL_GUARDED_BY(m_lock);
+
+        tempo_utils::Status validateOnFirstLoad(
+            const lyric_common::ModuleLocation &location,
+            const std::string &packageKey);
+        Option<lyric_object::LyricObject> mapStored(
+            const lyric_common::ModuleLocation &location,
+            const std::string &key,
+            const std::string &packageKey);
+        void publishStored(
+            const std::string &key,
+            const std::string &packageKey,
+            const lyric_object::LyricObject &object);
+        void invalidateEntries(const std::string &packageKey) ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+        void insertEntry(std::string key, std::string packageKey, const lyric_object::LyricObject &object)
+            ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+        void eraseEntry(std::list<CacheEntry>::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+    };
+}
+
+#endif // CHORD_MACHINE_ASSEMBLY_CACHE_LOADER_H
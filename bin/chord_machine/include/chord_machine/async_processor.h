@@ -1,14 +1,14 @@
 #ifndef CHORD_MACHINE_ASYNC_PROCESSOR_H
 #define CHORD_MACHINE_ASYNC_PROCESSOR_H
 
-#include <queue>
+#include <atomic>
 
-#include <absl/synchronization/mutex.h>
 #include <uv.h>
 
 #include <tempo_utils/status.h>
 
 #include "abstract_message_sender.h"
+#include "mailbox.h"
 
 namespace chord_machine {
 
@@ -30,9 +30,8 @@ namespace chord_machine {
         void cancelProcessing();
 
     private:
-        absl::Mutex m_lock;
-        std::queue<AbstractMessage *> m_queue ABSL_GUARDED_BY(m_lock);
-        uv_async_t *m_async;
+        Mailbox m_mailbox;
+        std::atomic<uv_async_t *> m_async;
 
         friend void on_message_receive(uv_async_t *async);
     };
@@ -10,6 +10,7 @@
 #include "config_utils.h"
 #include "grpc_binder.h"
 #include "local_machine.h"
+#include "machine_host.h"
 
 namespace chord_machine {
 
@@ -26,12 +27,14 @@ namespace chord_machine {
             const std::string &machineName,
             bool startSuspended,
             std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
-            AbstractMessageSender<RunnerReply> *processor) const;
+            AbstractMessageSender<RunnerReply> *processor,
+            const InterpreterRunnerOptions &runnerOptions) const;
 
         virtual std::unique_ptr<RemotingService> createRemotingService(
             bool startSuspended,
             std::shared_ptr<LocalMachine> localMachine,
-            uv_async_t *initComplete) const;
+            uv_async_t *initComplete,
+            MachineHost *machineHost) const;
 
         virtual std::shared_ptr<grpc::ChannelInterface> createCustomChannel(
             std::string_view targetEndpoint,
@@ -46,7 +49,7 @@ namespace chord_machine {
             const lyric_common::RuntimePolicy &runtimePolicy,
             const std::filesystem::path &pemPrivateKeyFile,
             const std::filesystem::path &pemRootCABundleFile,
-            chord_remoting::RemotingService::CallbackService *remotingService) const;
+            grpc::Service *remotingService) const;
     };
 }
 
@@ -10,6 +10,8 @@
 #include <chord_common/common_conversions.h>
 #include <tempo_utils/status.h>
 #include <tempo_utils/url.h>
+#include <tempo_utils/integer_types.h>
+#include <tempo_utils/log_stream.h>
 #include <zuri_packager/package_reader.h>
 
 namespace chord_machine {
@@ -20,9 +22,17 @@ namespace chord_machine {
         chord_common::TransportLocation supervisorEndpoint;
         std::vector<std::filesystem::path> packageCacheDirectories;
         absl::flat_hash_set<tempo_utils::Url> expectedPorts;
+        absl::flat_hash_set<tempo_utils::Url> gatewayPorts;
         bool startSuspended;
+        bool pooled;
+        tu_uint32 instructionBudget;
+        tu_uint32 workerThreads;
+        tu_uint64 assemblyCacheSize;
+        std::filesystem::path assemblyStoreDirectory;
         std::filesystem::path pemRootCABundleFile;
         std::filesystem::path logFile;
+        tempo_utils::SeverityFilter logSeverityFilter;
+        bool logFlushEveryMessage;
         zuri_packager::PackageSpecifier mainPackage;
         std::vector<std::string> mainArguments;
         chord_common::TransportLocation binderEndpoint;
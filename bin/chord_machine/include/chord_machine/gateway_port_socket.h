@@ -0,0 +1,78 @@
+#ifndef CHORD_MACHINE_GATEWAY_PORT_SOCKET_H
+#define CHORD_MACHINE_GATEWAY_PORT_SOCKET_H
+
+#include <deque>
+
+#include <uv.h>
+
+#include <absl/synchronization/mutex.h>
+
+#include <chord_common/abstract_protocol_handler.h>
+#include <chord_common/gateway_protocol.h>
+#include <lyric_runtime/abstract_port_writer.h>
+#include <lyric_runtime/duplex_port.h>
+#include <tempo_utils/memory_bytes.h>
+
+#include "port_write_queue.h"
+
+namespace chord_machine {
+
+    struct GatewayPortSocketStats {
+        tu_uint64 requestsReceived = 0;
+        tu_uint64 requestsDelivered = 0;
+        tu_uint64 requestsRejected = 0;
+        tu_uint64 responsesSent = 0;
+        tu_uint64 unsolicitedWrites = 0;
+    };
+
+    /**
+     * Protocol handler which serves the port end of a gateway stream with a DuplexPort in the
+     * interpreter. The body of each request frame is delivered to the port as a message, and each
+     * message the program writes to the port answers the oldest request which has not been answered
+     * yet, so the program serves requests in the order they arrive. The gateway is granted credit
+     * for a window of requests, and the credit for a request is returned once it has been answered,
+     * which bounds the number of requests waiting in the port. Responses written while the stream
+     * is congested are parked in a PortWriteQueue and are sent once the stream is writable again.
+     */
+    class GatewayPortSocket : public chord_common::AbstractProtocolHandler, public lyric_runtime::AbstractPortWriter {
+    public:
+        GatewayPortSocket(
+            std::shared_ptr<lyric_runtime::DuplexPort> port,
+            uv_loop_t *loop,
+            tu_uint32 window = chord_common::kDefaultGatewayWindow);
+        ~GatewayPortSocket() override;
+
+        tempo_utils::Status initialize();
+
+        bool isAttached() override;
+        tempo_utils::Status attach(chord_common::AbstractProtocolWriter *writer) override;
+        tempo_utils::Status send(std::string_view message) override;
+        tempo_utils::Status handle(std::string_view message) override;
+        tempo_utils::Status detach() override;
+        void writable(bool writable) override;
+
+        tempo_utils::Status write(std::shared_ptr<tempo_utils::ImmutableBytes> payload) override;
+
+        GatewayPortSocketStats getStats() const;
+
+    private:
+        std::shared_ptr<lyric_runtime::DuplexPort> m_port;
+        uv_loop_t *m_loop;
+        tu_uint32 m_window;
+        uv_async_t *m_deliver;
+        chord_common::AbstractProtocolWriter *m_writer;
+        PortWriteQueue m_writeQueue;
+
+        mutable absl::Mutex m_lock;
+        std::vector<std::shared_ptr<const tempo_utils::MemoryBytes>> m_received ABSL_GUARDED_BY(m_lock);
+        std::deque<tu_uint32> m_unanswered ABSL_GUARDED_BY(m_lock);
+        GatewayPortSocketStats m_stats ABSL_GUARDED_BY(m_lock);
+
+        void deliverReceived();
+        tempo_utils::Status respond(std::string_view body);
+
+        friend void on_gateway_port_deliver(uv_async_t *async);
+    };
+}
+
+#endif // CHORD_MACHINE_GATEWAY_PORT_SOCKET_H
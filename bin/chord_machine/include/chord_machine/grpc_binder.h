@@ -22,7 +22,7 @@ namespace chord_machine {
             const lyric_common::RuntimePolicy &policy,
             const std::filesystem::path &pemPrivateKeyFile,
             const std::filesystem::path &pemRootCABundleFile,
-            chord_remoting::RemotingService::CallbackService *remotingService);
+            grpc::Service *remotingService);
         virtual ~GrpcBinder() = default;
 
         tempo_utils::Status initialize(const std::filesystem::path &pemCertificateFile);
@@ -34,7 +34,7 @@ namespace chord_machine {
         std::filesystem::path m_pemPrivateKeyFile;
         std::filesystem::path m_pemRootCABundleFile;
         std::shared_ptr<grpc::ServerCredentials> m_credentials;
-        chord_remoting::RemotingService::CallbackService *m_remotingService;
+        grpc::Service *m_remotingService;
         std::unique_ptr<grpc::Server> m_server;
     };
 
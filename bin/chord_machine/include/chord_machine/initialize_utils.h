@@ -7,36 +7,66 @@
 #include <uv.h>
 
 #include <chord_invoke/invoke_service.grpc.pb.h>
+#include <lyric_runtime/abstract_loader.h>
 #include <tempo_security/csr_key_pair.h>
 #include <tempo_utils/status.h>
 #include <tempo_utils/url.h>
+#include <zuri_distributor/tiered_package_cache.h>
 
 #include "chord_machine.h"
 #include "component_constructor.h"
 #include "config_utils.h"
 #include "grpc_binder.h"
+#include "assembly_cache_loader.h"
 #include "local_machine.h"
+#include "machine_host.h"
 
 namespace chord_machine {
 
+    tempo_utils::Status make_shared_loaders(
+        SharedLoaders &sharedLoaders,
+        const ChordLocalMachineConfig &chordLocalMachineConfig);
+
+    tempo_utils::Status resolve_main_location(
+        lyric_common::ModuleLocation &mainLocation,
+        std::shared_ptr<zuri_distributor::TieredPackageCache> packageCache,
+        const zuri_packager::PackageSpecifier &mainPackage);
+
+    tempo_utils::Result<Option<std::string>> stamp_package(
+        std::shared_ptr<zuri_distributor::TieredPackageCache> packageCache,
+        const zuri_packager::PackageSpecifier &specifier);
+
     tempo_utils::Status make_interpreter_state(
         std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
         const ComponentConstructor &componentConstructor,
         const ChordLocalMachineConfig &chordLocalMachineConfig);
 
+    tempo_utils::Status make_interpreter_state(
+        std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
+        const ComponentConstructor &componentConstructor,
+        const ChordLocalMachineConfig &chordLocalMachineConfig,
+        const SharedLoaders &sharedLoaders);
+
+    tempo_utils::Status make_machine_host(
+        std::shared_ptr<MachineHost> &machineHost,
+        const ChordLocalMachineConfig &chordLocalMachineConfig,
+        const SharedLoaders &sharedLoaders);
+
     tempo_utils::Status make_local_machine(
         std::shared_ptr<LocalMachine> &localMachine,
         const ComponentConstructor &componentConstructor,
         const ChordLocalMachineConfig &chordLocalMachineConfig,
         std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
-        AbstractMessageSender<RunnerReply> *processor);
+        AbstractMessageSender<RunnerReply> *processor,
+        MachineHost *machineHost = nullptr);
 
     tempo_utils::Status make_remoting_service(
         std::unique_ptr<RemotingService> &remotingService,
         const ComponentConstructor &componentConstructor,
         const ChordLocalMachineConfig &chordLocalMachineConfig,
         std::shared_ptr<LocalMachine> localMachine,
-        uv_async_t *initComplete);
+        uv_async_t *initComplete,
+        MachineHost *machineHost = nullptr);
 
     tempo_utils::Status make_custom_channel(
         std::shared_ptr<grpc::ChannelInterface> &channel,
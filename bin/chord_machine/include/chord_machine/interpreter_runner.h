@@ -3,11 +3,14 @@
 
 #include <uv.h>
 
+#include <absl/synchronization/mutex.h>
+
 #include <lyric_runtime/bytecode_interpreter.h>
 #include <tempo_utils/status.h>
 
 #include "abstract_message_sender.h"
 #include "async_queue.h"
+#include "safepoint_inspector.h"
 
 namespace chord_machine {
 
@@ -97,30 +100,59 @@ namespace chord_machine {
         FAILED,
     };
 
-    class InterpreterRunner {
+    /**
+     * Result of running the requests which are available to the runner without blocking.
+     */
+    enum class RunnerSliceResult {
+        IDLE,               // no requests are waiting and the interpreter is not running
+        YIELDED,            // the interpreter stopped at a safepoint to give up its worker
+        TERMINATED,         // the runner handled a terminate request
+    };
+
+    struct InterpreterRunnerOptions {
+        /**
+         * Number of instructions the interpreter executes between safepoints. If zero then the
+         * interpreter runs without safepoints, and requests are only handled once the interpreter
+         * stops on its own.
+         */
+        tu_uint32 instructionBudget = 0;
+    };
+
+    class InterpreterRunner : private AbstractMessageSender<RunnerRequest> {
     public:
         InterpreterRunner(
             std::unique_ptr<lyric_runtime::BytecodeInterpreter> interp,
-            AbstractMessageSender<RunnerReply> *outgoing);
+            AbstractMessageSender<RunnerReply> *outgoing,
+            std::unique_ptr<SafepointInspector> inspector = {});
 
-        AbstractMessageSender<RunnerRequest> *getIncomingSender() const;
+        AbstractMessageSender<RunnerRequest> *getIncomingSender();
         InterpreterRunnerState getState() const;
         tempo_utils::Status getStatus() const;
         lyric_runtime::InterpreterExit getExit() const;
+        SafepointStats getSafepointStats() const;
+        bool hasPendingRequests();
 
+        tempo_utils::Status initialize();
         tempo_utils::Status run();
+        RunnerSliceResult runAvailable();
 
     private:
         std::unique_ptr<lyric_runtime::BytecodeInterpreter> m_interp;
         AbstractMessageSender<RunnerReply> *m_outgoing;
+        std::unique_ptr<SafepointInspector> m_inspector;
         std::unique_ptr<AsyncQueue<RunnerRequest>> m_incoming;
+        bool m_initialized;
+        bool m_yielded;
 
         std::unique_ptr<absl::Mutex> m_lock;
         InterpreterRunnerState m_state ABSL_GUARDED_BY(m_lock);
         tempo_utils::Status m_status ABSL_GUARDED_BY(m_lock);
         lyric_runtime::InterpreterExit m_exit ABSL_GUARDED_BY(m_lock);
+        SafepointStats m_safepointStats ABSL_GUARDED_BY(m_lock);
 
-        void beforeRunInterpreter();
+        void sendMessage(RunnerRequest *message) override;
+        bool handleRequest(const RunnerRequest *request);
+        bool beforeRunInterpreter();
         void runInterpreter();
         void suspendInterpreter();
         void shutdownInterpreter();
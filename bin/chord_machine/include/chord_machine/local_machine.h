@@ -8,20 +8,32 @@
 #include <lyric_runtime/bytecode_interpreter.h>
 
 #include "interpreter_runner.h"
+#include "runner_worker_pool.h"
 
 namespace chord_machine {
 
+    /**
+     * Machine which runs an interpreter in the machine process. If no worker pool is specified
+     * then the runner gets a dedicated thread. Otherwise the runner is scheduled on the pool for
+     * a slice each time it receives a request, and gives up its worker once it is idle; while
+     * the interpreter runs it yields its worker at a safepoint whenever another runner is waiting
+     * for one.
+     */
     class LocalMachine {
     public:
         LocalMachine(
             const std::string &machineName,
             bool startSuspended,
             std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
-            AbstractMessageSender<RunnerReply> *processor);
+            AbstractMessageSender<RunnerReply> *processor,
+            const InterpreterRunnerOptions &runnerOptions = {},
+            RunnerWorkerPool *workerPool = nullptr);
         virtual ~LocalMachine();
 
         std::string getMachineName() const;
+        bool isFinished() const;
         InterpreterRunnerState getRunnerState() const;
+        SafepointStats getSafepointStats() const;
 
         tempo_utils::Status notifyInitComplete();
         tempo_utils::Status suspend();
@@ -33,7 +45,21 @@ namespace chord_machine {
         bool m_startSuspended;
         std::unique_ptr<InterpreterRunner> m_runner;
         AbstractMessageSender<RunnerRequest> *m_commandQueue;
+        RunnerWorkerPool *m_workerPool;
+        absl::Notification m_runnerDone;
         uv_thread_t m_tid;
+
+        absl::Mutex m_lock;
+        bool m_scheduled ABSL_GUARDED_BY(m_lock);
+        bool m_finished ABSL_GUARDED_BY(m_lock);
+
+        void sendRequest(RunnerRequest *request);
+        void scheduleRunner();
+        void submitSlice();
+        void runSlice();
+        void finishRunner();
+
+        friend void run_local_machine_thread(void *data);
     };
 }
 
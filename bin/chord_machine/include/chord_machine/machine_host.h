@@ -0,0 +1,118 @@
+#ifndef CHORD_MACHINE_MACHINE_HOST_H
+#define CHORD_MACHINE_MACHINE_HOST_H
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/synchronization/mutex.h>
+
+#include <chord_common/abstract_protocol_handler.h>
+#include <lyric_runtime/abstract_loader.h>
+#include <lyric_runtime/interpreter_state.h>
+#include <tempo_utils/result.h>
+#include <tempo_utils/url.h>
+#include <zuri_distributor/tiered_package_cache.h>
+#include <zuri_packager/package_specifier.h>
+
+#include "assembly_cache_loader.h"
+#include "local_machine.h"
+#include "runner_worker_pool.h"
+
+namespace chord_machine {
+
+    /**
+     * Loaders shared by every interpreter in the machine process. The loaders only read from the
+     * package caches, so they are safe to share between interpreters. The application loader
+     * is the assembly cache, which wraps the package cache loader.
+     */
+    struct SharedLoaders {
+        std::shared_ptr<lyric_runtime::AbstractLoader> systemLoader;
+        std::shared_ptr<zuri_distributor::TieredPackageCache> packageCache;
+        std::shared_ptr<AssemblyCacheLoader> assemblyCache;
+        std::shared_ptr<lyric_runtime::AbstractLoader> applicationLoader;
+    };
+
+    constexpr tu_uint32 kDefaultHostedInstructionBudget = 10000;
+
+    struct MachineHostOptions {
+        /**
+         * Number of worker threads which run the hosted interpreters.
+         */
+        tu_uint32 numWorkers = 1;
+        /**
+         * Options applied to the runner of each hosted machine. Hosted runners share workers at
+         * safepoints, so if no instruction budget is specified then kDefaultHostedInstructionBudget
+         * is used.
+         */
+        InterpreterRunnerOptions runnerOptions = {};
+    };
+
+    /**
+     * Receives the replies of the runners of machines created by the host. A hosted machine is
+     * observed through its runner state, so the replies are only logged.
+     */
+    class HostedReplyLogger : public AbstractMessageSender<RunnerReply> {
+    public:
+        void sendMessage(RunnerReply *message) override;
+    };
+
+    /**
+     * Hosts many isolated machines in a single machine process. Each hosted machine has its own
+     * interpreter state, heap and ports, but the machines share the loaders and run on a fixed
+     * pool of worker threads. Hosted machines are identified by machine name. A machine created
+     * with expected ports is started once a Communicate stream is attached to each of its ports,
+     * unless it was created suspended.
+     */
+    class MachineHost {
+    public:
+        explicit MachineHost(const SharedLoaders &loaders, const MachineHostOptions &options = {});
+        ~MachineHost();
+
+        tempo_utils::Status initialize();
+
+        tempo_utils::Result<std::shared_ptr<LocalMachine>> createMachine(
+            const std::string &machineName,
+            const zuri_packager::PackageSpecifier &mainPackage,
+            const absl::flat_hash_set<tempo_utils::Url> &expectedPorts,
+            bool startSuspended);
+        tempo_utils::Result<std::shared_ptr<LocalMachine>> adoptMachine(
+            const std::string &machineName,
+            std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
+            bool startSuspended,
+            AbstractMessageSender<RunnerReply> *processor);
+
+        bool hasMachine(std::string_view machineName) const;
+        std::shared_ptr<LocalMachine> getMachine(std::string_view machineName) const;
+        std::shared_ptr<chord_common::AbstractProtocolHandler> getProtocolHandler(
+            std::string_view machineName,
+            const tempo_utils::Url &protocolUrl) const;
+        tempo_utils::Status notifyProtocolAttached(
+            std::string_view machineName,
+            const tempo_utils::Url &protocolUrl);
+        tempo_utils::Status removeMachine(std::string_view machineName);
+        int reapMachines();
+        int numMachines() const;
+
+        const SharedLoaders &getLoaders() const;
+        RunnerWorkerPool *getWorkerPool();
+
+        tempo_utils::Status shutdown();
+
+    private:
+        struct HostedMachine {
+            std::shared_ptr<LocalMachine> machine;
+            absl::flat_hash_map<
+                tempo_utils::Url,
+                std::shared_ptr<chord_common::AbstractProtocolHandler>> handlers;
+            absl::flat_hash_set<tempo_utils::Url> requiredAtLaunch;
+        };
+
+        SharedLoaders m_loaders;
+        MachineHostOptions m_options;
+        HostedReplyLogger m_replies;
+        RunnerWorkerPool m_workerPool;
+        mutable absl::Mutex m_lock;
+        absl::flat_hash_map<std::string,std::shared_ptr<HostedMachine>> m_machines ABSL_GUARDED_BY(m_lock);
+    };
+}
+
+#endif // CHORD_MACHINE_MACHINE_HOST_H
@@ -15,6 +15,7 @@ namespace chord_machine {
     enum class MachineCondition {
         kInvalidConfiguration,
         kMachineInvariant,
+        kWriteCongested,
     };
 
 
@@ -99,6 +100,8 @@ namespace tempo_utils {
                 case chord_machine::MachineCondition::kInvalidConfiguration:
                 case chord_machine::MachineCondition::kMachineInvariant:
                     return tempo_utils::StatusCode::kInternal;
+                case chord_machine::MachineCondition::kWriteCongested:
+                    return tempo_utils::StatusCode::kResourceExhausted;
                 default:
                     return tempo_utils::StatusCode::kUnknown;
             }
@@ -110,6 +113,8 @@ namespace tempo_utils {
                     return "Invalid configuration";
                 case chord_machine::MachineCondition::kMachineInvariant:
                     return "Machine invariant";
+                case chord_machine::MachineCondition::kWriteCongested:
+                    return "Write congested";
                 default:
                     return "INVALID";
             }
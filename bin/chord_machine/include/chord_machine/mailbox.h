@@ -0,0 +1,54 @@
+#ifndef CHORD_MACHINE_MAILBOX_H
+#define CHORD_MACHINE_MAILBOX_H
+
+#include <atomic>
+
+#include <tempo_utils/integer_types.h>
+
+#include "abstract_message_sender.h"
+
+namespace chord_machine {
+
+    /**
+     * Lock-free multi-producer single-consumer queue of messages. Messages are chained through
+     * their intrusive link, so pushing a message never allocates. Any thread may push, but only
+     * one thread at a time may pop.
+     */
+    class Mailbox {
+    public:
+        Mailbox();
+
+        Mailbox(const Mailbox &other) = delete;
+        Mailbox& operator=(const Mailbox &other) = delete;
+
+        /**
+         * Push the message onto the tail of the mailbox.
+         *
+         * @param message The message to push.
+         * @return true if the mailbox was empty before the push, in which case the consumer must
+         *     be woken up.
+         */
+        bool push(AbstractMessage *message);
+
+        /**
+         * Pop the message at the head of the mailbox. Must only be called by the consumer.
+         *
+         * @return The message, or nullptr if the mailbox is empty.
+         */
+        AbstractMessage *pop();
+
+        bool isEmpty() const;
+        tu_uint32 size() const;
+
+    private:
+        // producers swap themselves into the head, the consumer pops from the tail
+        std::atomic<AbstractMessage *> m_head;
+        AbstractMessage *m_tail;
+        AbstractMessage m_stub;
+        std::atomic<tu_uint32> m_size;
+
+        void link(AbstractMessage *message);
+    };
+}
+
+#endif // CHORD_MACHINE_MAILBOX_H
@@ -1,28 +1,77 @@
 #ifndef CHORD_MACHINE_PORT_SOCKET_H
 #define CHORD_MACHINE_PORT_SOCKET_H
 
+#include <uv.h>
+
+#include <absl/synchronization/mutex.h>
+
 #include <chord_common/abstract_protocol_handler.h>
 #include <lyric_runtime/abstract_port_writer.h>
 #include <lyric_runtime/duplex_port.h>
+#include <tempo_utils/memory_bytes.h>
+
+#include "port_write_queue.h"
 
 namespace chord_machine {
 
+    constexpr tu_uint32 kDefaultPortReceiveQueueSize = 256;
+
+    struct PortSocketStats {
+        tu_uint64 messagesReceived = 0;
+        tu_uint64 bytesReceived = 0;
+        tu_uint64 messagesDelivered = 0;
+        tu_uint64 batchesDelivered = 0;
+        tu_uint64 messagesDropped = 0;
+        tu_uint64 messagesSent = 0;
+        tu_uint64 bytesSent = 0;
+    };
+
+    /**
+     * Protocol handler which connects a Communicate stream to a DuplexPort in the interpreter.
+     * Inbound messages are placed on a bounded receive queue, and are delivered to the port in
+     * a batch each time the loop wakes up. The remote end is granted one credit for each slot in
+     * the receive queue, and credits are returned as messages are delivered to the port, so a
+     * well-behaved client never overflows the queue. Messages received beyond the granted credit
+     * are dropped. Outbound messages written while the stream is congested are parked in a
+     * PortWriteQueue and are sent once the stream is writable again.
+     */
     class PortSocket : public chord_common::AbstractProtocolHandler, public lyric_runtime::AbstractPortWriter {
     public:
-        explicit PortSocket(std::shared_ptr<lyric_runtime::DuplexPort> port);
+        PortSocket(
+            std::shared_ptr<lyric_runtime::DuplexPort> port,
+            uv_loop_t *loop,
+            tu_uint32 receiveQueueSize = kDefaultPortReceiveQueueSize);
+        ~PortSocket() override;
+
+        tempo_utils::Status initialize();
 
         bool isAttached() override;
         tempo_utils::Status attach(chord_common::AbstractProtocolWriter *writer) override;
         tempo_utils::Status send(std::string_view message) override;
         tempo_utils::Status handle(std::string_view message) override;
         tempo_utils::Status detach() override;
+        void writable(bool writable) override;
 
         tempo_utils::Status write(std::shared_ptr<tempo_utils::ImmutableBytes> payload) override;
 
+        PortSocketStats getStats() const;
+
     private:
         std::shared_ptr<lyric_runtime::DuplexPort> m_port;
+        uv_loop_t *m_loop;
+        tu_uint32 m_receiveQueueSize;
+        uv_async_t *m_deliver;
         chord_common::AbstractProtocolWriter *m_writer;
+        PortWriteQueue m_writeQueue;
+
+        mutable absl::Mutex m_lock;
+        std::vector<std::shared_ptr<const tempo_utils::MemoryBytes>> m_received ABSL_GUARDED_BY(m_lock);
+        PortSocketStats m_stats ABSL_GUARDED_BY(m_lock);
+
+        void deliverReceived();
+
+        friend void on_port_deliver(uv_async_t *async);
     };
 }
 
-#endif // CHORD_MACHINE_PORT_SOCKET_H
\ No newline at end of file
+#endif // CHORD_MACHINE_PORT_SOCKET_H
@@ -0,0 +1,60 @@
+#ifndef CHORD_MACHINE_PORT_WRITE_QUEUE_H
+#define CHORD_MACHINE_PORT_WRITE_QUEUE_H
+
+#include <deque>
+
+#include <absl/synchronization/mutex.h>
+
+#include <chord_common/abstract_protocol_writer.h>
+#include <tempo_utils/immutable_bytes.h>
+
+namespace chord_machine {
+
+    constexpr tu_uint32 kDefaultPortMaxParkedBytes = 1048576;   // 1MiB
+
+    struct PortWriteQueueStats {
+        tu_uint64 messagesParked = 0;
+        tu_uint64 messagesResumed = 0;
+        tu_uint64 messagesRejected = 0;
+    };
+
+    /**
+     * Outbound queue between a port and the writer of its Communicate stream. While the writer is
+     * writable each message is written through immediately. Once a write fails with
+     * MachineCondition::kWriteCongested, messages are parked in order and are written when the
+     * writer notifies that it is writable again. The interpreter is never blocked; if the parked bytes would exceed
+     * the limit then the write fails with MachineCondition::kWriteCongested.
+     */
+    class PortWriteQueue {
+    public:
+        explicit PortWriteQueue(tu_uint32 maxParkedBytes = kDefaultPortMaxParkedBytes);
+
+        void attach(chord_common::AbstractProtocolWriter *writer);
+        void detach();
+        bool isAttached() const;
+
+        tempo_utils::Status write(std::shared_ptr<const tempo_utils::ImmutableBytes> payload);
+        tempo_utils::Status grantCredit(tu_uint32 credit);
+        void writable(bool writable);
+
+        tu_uint32 getParkedBytes() const;
+        PortWriteQueueStats getStats() const;
+
+    private:
+        tu_uint32 m_maxParkedBytes;
+
+        mutable absl::Mutex m_lock;
+        chord_common::AbstractProtocolWriter *m_writer ABSL_GUARDED_BY(m_lock);
+        bool m_writable ABSL_GUARDED_BY(m_lock);
+        std::deque<std::shared_ptr<const tempo_utils::ImmutableBytes>> m_parked ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_parkedBytes ABSL_GUARDED_BY(m_lock);
+        PortWriteQueueStats m_stats ABSL_GUARDED_BY(m_lock);
+
+        tempo_utils::Status park(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+            ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+    };
+
+    bool is_write_congested(const tempo_utils::Status &status);
+}
+
+#endif // CHORD_MACHINE_PORT_WRITE_QUEUE_H
@@ -1,6 +1,7 @@
 #ifndef CHORD_MACHINE_REMOTING_SERVICE_H
 #define CHORD_MACHINE_REMOTING_SERVICE_H
 
+#include <deque>
 #include <queue>
 
 #include <absl/container/flat_hash_map.h>
@@ -13,19 +14,50 @@
 #include <tempo_utils/url.h>
 
 #include "local_machine.h"
+#include "machine_host.h"
 
 namespace chord_machine {
 
+    constexpr tu_uint32 kCommunicateWriteHighWatermark = 1048576;   // 1MiB
+    constexpr tu_uint32 kCommunicateWriteLowWatermark = 262144;     // 256KiB
+    constexpr tu_uint32 kCommunicateWriteBatchSize = 65536;         // 64KiB
+
+    constexpr const char *kMachineNameMetadataKey = "x-chord-machine-name";
+
     class CommunicateStream;
     class MonitorStream;
 
     /**
-     * gRPC service implementing the RemotingService service definition.
+     * Base class of the RemotingService implementation. The Communicate rpc is a raw callback
+     * method, so outbound payloads are handed to gRPC as slices which reference the payload
+     * instead of being copied into a Message.
      */
-    class RemotingService : public chord_remoting::RemotingService::CallbackService {
+    using RemotingServiceBase =
+        chord_remoting::RemotingService::WithCallbackMethod_SuspendMachine<
+        chord_remoting::RemotingService::WithCallbackMethod_ResumeMachine<
+        chord_remoting::RemotingService::WithCallbackMethod_TerminateMachine<
+        chord_remoting::RemotingService::WithCallbackMethod_PlaceMachine<
+        chord_remoting::RemotingService::WithRawCallbackMethod_Communicate<
+        chord_remoting::RemotingService::WithCallbackMethod_Monitor<
+        chord_remoting::RemotingService::WithCallbackMethod_PreparePort<
+        chord_remoting::RemotingService::WithCallbackMethod_BindPort<
+        chord_remoting::RemotingService::WithCallbackMethod_ClosePort<
+        chord_remoting::RemotingService::Service>>>>>>>>>;
+
+    /**
+     * gRPC service implementing the RemotingService service definition. If the service belongs to
+     * a machine host then machines can be placed with the PlaceMachine rpc, and machine requests
+     * and Communicate streams are routed to the hosted machine named by the x-chord-machine-name
+     * metadata. Requests without the metadata go to the local machine.
+     */
+    class RemotingService : public RemotingServiceBase {
     public:
         RemotingService();
-        RemotingService(bool startSuspended, std::shared_ptr<LocalMachine> localMachine, uv_async_t *initComplete);
+        RemotingService(
+            bool startSuspended,
+            std::shared_ptr<LocalMachine> localMachine,
+            uv_async_t *initComplete,
+            MachineHost *machineHost = nullptr);
 
         grpc::ServerUnaryReactor *
         SuspendMachine(
@@ -45,9 +77,13 @@ namespace chord_machine {
             const chord_remoting::TerminateMachineRequest *request,
             chord_remoting::TerminateMachineResult *response) override;
 
-        grpc::ServerBidiReactor<
-            chord_remoting::Message,
-            chord_remoting::Message> *
+        grpc::ServerUnaryReactor *
+        PlaceMachine(
+            grpc::CallbackServerContext *context,
+            const chord_remoting::PlaceMachineRequest *request,
+            chord_remoting::PlaceMachineResult *response) override;
+
+        grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> *
         Communicate(grpc::CallbackServerContext *context) override;
 
         grpc::ServerWriteReactor<chord_remoting::MonitorEvent> *
@@ -69,17 +105,23 @@ namespace chord_machine {
     private:
         std::shared_ptr<LocalMachine> m_localMachine;
         uv_async_t *m_initComplete;
+        MachineHost *m_machineHost;
         absl::Mutex m_lock;
         absl::flat_hash_map<
             tempo_utils::Url,
             std::shared_ptr<chord_common::AbstractProtocolHandler>> m_handlers ABSL_GUARDED_BY(m_lock);
         absl::flat_hash_set<tempo_utils::Url> m_requiredAtLaunch ABSL_GUARDED_BY(m_lock);
-        absl::flat_hash_map<tempo_utils::Url,CommunicateStream *> m_communicateStreams ABSL_GUARDED_BY(m_lock);
+        absl::flat_hash_map<
+            std::pair<std::string,tempo_utils::Url>,
+            CommunicateStream *> m_communicateStreams ABSL_GUARDED_BY(m_lock);
         absl::flat_hash_set<MonitorStream *> m_monitorStreams ABSL_GUARDED_BY(m_lock);
         chord_remoting::MachineState m_cachedState ABSL_GUARDED_BY(m_lock);
 
-        CommunicateStream *allocateCommunicateStream(const tempo_utils::Url &protocolUrl);
-        void freeCommunicateStream(const tempo_utils::Url &protocolUrl);
+        tempo_utils::Result<std::shared_ptr<LocalMachine>> resolveMachine(grpc::CallbackServerContext *context);
+        CommunicateStream *allocateCommunicateStream(
+            const std::string &machineName,
+            const tempo_utils::Url &protocolUrl);
+        void freeCommunicateStream(CommunicateStream *stream);
         MonitorStream *allocateMonitorStream();
         void freeMonitorStream(MonitorStream *stream);
 
@@ -88,16 +130,25 @@ namespace chord_machine {
     };
 
     /**
-     * Reactor implementing the Communicate rpc.
+     * Reactor implementing the Communicate rpc. Outbound messages are queued by reference, and
+     * each payload is written as a slice which holds a reference to the payload, so the payload
+     * is never copied. While more messages are queued behind the current write, the write is sent
+     * with a buffer hint so gRPC coalesces consecutive messages into one transport write, up to
+     * kCommunicateWriteBatchSize bytes. Writes never block the caller. When the queued bytes rise
+     * above kCommunicateWriteHighWatermark the handler is notified that the stream is not writable,
+     * and further writes fail with MachineCondition::kWriteCongested until the queued bytes drain
+     * below kCommunicateWriteLowWatermark, at which point the handler is notified that the stream is
+     * writable again.
      */
     class CommunicateStream
-        : public grpc::ServerBidiReactor<
-            chord_remoting::Message,
-            chord_remoting::Message>,
+        : public grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer>,
           public chord_common::AbstractProtocolWriter
     {
     public:
-        CommunicateStream(const tempo_utils::Url &protocolUrl, RemotingService *remotingService);
+        CommunicateStream(
+            const std::string &machineName,
+            const tempo_utils::Url &protocolUrl,
+            RemotingService *remotingService);
         ~CommunicateStream() override;
 
         void OnReadDone(bool ok) override;
@@ -105,22 +156,38 @@ namespace chord_machine {
         void OnCancel() override;
         void OnDone() override;
         tempo_utils::Status write(std::string_view message) override;
+        tempo_utils::Status write(std::shared_ptr<const tempo_utils::ImmutableBytes> payload) override;
+        tempo_utils::Status grantCredit(tu_uint32 credit) override;
 
         tempo_utils::Status attachHandler(std::shared_ptr<chord_common::AbstractProtocolHandler> handler);
 
         struct PendingWrite {
-            chord_remoting::Message message;
-            PendingWrite *next;
+            std::shared_ptr<const tempo_utils::ImmutableBytes> payload;
+            tu_uint32 credit;
         };
 
     private:
+        std::string m_machineName;
         tempo_utils::Url m_protcolUrl;
         std::shared_ptr<chord_common::AbstractProtocolHandler> m_handler;
+        grpc::ByteBuffer m_incomingBuffer;
         chord_remoting::Message m_incoming;
         absl::Mutex m_lock;
         RemotingService *m_remotingService;
-        PendingWrite *m_head ABSL_GUARDED_BY(m_lock);
-        PendingWrite *m_tail ABSL_GUARDED_BY(m_lock);
+        std::deque<PendingWrite> m_pending ABSL_GUARDED_BY(m_lock);
+        chord_remoting::Message m_envelope ABSL_GUARDED_BY(m_lock);
+        grpc::ByteBuffer m_outgoing ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_pendingBytes ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_writeSize ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_batchBytes ABSL_GUARDED_BY(m_lock);
+        bool m_writing ABSL_GUARDED_BY(m_lock);
+        bool m_congested ABSL_GUARDED_BY(m_lock);
+        bool m_finished ABSL_GUARDED_BY(m_lock);
+
+        tempo_utils::Status enqueueWrite(std::shared_ptr<const tempo_utils::ImmutableBytes> payload);
+        void startNextWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
+
+        friend class RemotingService;
     };
 
     /**
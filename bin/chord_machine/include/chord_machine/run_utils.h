@@ -12,6 +12,7 @@
 
 #include "grpc_binder.h"
 #include "local_machine.h"
+#include "machine_host.h"
 #include "remoting_service.h"
 #include "run_protocol_socket.h"
 #include "config_utils.h"
@@ -24,7 +25,9 @@ namespace chord_machine {
         std::unique_ptr<RemotingService> remotingService;
         std::shared_ptr<grpc::ChannelInterface> customChannel;
         std::unique_ptr<chord_invoke::InvokeService::StubInterface> invokeStub;
+        SharedLoaders sharedLoaders;
         std::shared_ptr<lyric_runtime::InterpreterState> interpreterState;
+        std::shared_ptr<MachineHost> machineHost;
         std::shared_ptr<LocalMachine> localMachine;
         //std::shared_ptr<RunProtocolSocket> runSocket;
         tempo_security::CSRKeyPair csrKeyPair;
@@ -32,6 +35,10 @@ namespace chord_machine {
         std::shared_ptr<GrpcBinder> grpcBinder;
     };
 
+    tempo_utils::Status await_assignment(
+        ChordLocalMachineConfig &chordLocalMachineConfig,
+        ChordLocalMachineData &chordLocalMachineData);
+
     tempo_utils::Status sign_certificates(
         const ChordLocalMachineConfig &chordLocalMachineConfig,
         ChordLocalMachineData &chordLocalMachineData);
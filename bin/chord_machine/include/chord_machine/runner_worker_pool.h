@@ -0,0 +1,54 @@
+#ifndef CHORD_MACHINE_RUNNER_WORKER_POOL_H
+#define CHORD_MACHINE_RUNNER_WORKER_POOL_H
+
+#include <deque>
+#include <vector>
+
+#include <absl/functional/any_invocable.h>
+#include <absl/synchronization/mutex.h>
+#include <uv.h>
+
+#include <tempo_utils/integer_types.h>
+#include <tempo_utils/status.h>
+
+namespace chord_machine {
+
+    /**
+     * Fixed pool of worker threads which run interpreter runners. Each task runs on a single
+     * worker until it returns, tasks submitted while every worker is busy wait in FIFO order
+     * for the next free worker. A runner submits a task for each slice of work, so it only
+     * occupies a worker while it has requests to handle or its interpreter is running.
+     */
+    class RunnerWorkerPool {
+    public:
+        explicit RunnerWorkerPool(tu_uint32 numWorkers);
+        ~RunnerWorkerPool();
+
+        RunnerWorkerPool(const RunnerWorkerPool &other) = delete;
+        RunnerWorkerPool& operator=(const RunnerWorkerPool &other) = delete;
+
+        tempo_utils::Status initialize();
+        tempo_utils::Status submit(absl::AnyInvocable<void() &&> task);
+        tempo_utils::Status shutdown();
+
+        tu_uint32 numWorkers() const;
+        tu_uint32 numQueued() const;
+        tu_uint32 numActive() const;
+
+    private:
+        tu_uint32 m_numWorkers;
+        std::vector<uv_thread_t> m_threads;
+        mutable absl::Mutex m_lock;
+        std::deque<absl::AnyInvocable<void() &&>> m_queued ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_numActive ABSL_GUARDED_BY(m_lock);
+        bool m_running ABSL_GUARDED_BY(m_lock);
+        bool m_shutdown ABSL_GUARDED_BY(m_lock);
+
+        void runWorker();
+        bool hasWork() const ABSL_SHARED_LOCKS_REQUIRED(m_lock);
+
+        friend void run_worker_thread(void *arg);
+    };
+}
+
+#endif // CHORD_MACHINE_RUNNER_WORKER_POOL_H
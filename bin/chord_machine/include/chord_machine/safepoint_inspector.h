@@ -0,0 +1,85 @@
+#ifndef CHORD_MACHINE_SAFEPOINT_INSPECTOR_H
+#define CHORD_MACHINE_SAFEPOINT_INSPECTOR_H
+
+#include <atomic>
+
+#include <absl/functional/any_invocable.h>
+#include <absl/time/time.h>
+
+#include <lyric_runtime/abstract_inspector.h>
+#include <tempo_utils/integer_types.h>
+
+namespace chord_machine {
+
+    /**
+     * Counters describing the safepoints reached by the interpreter and the latency of the
+     * interrupts delivered at those safepoints.
+     */
+    struct SafepointStats {
+        tu_uint64 safepointsReached = 0;
+        tu_uint64 interruptsDelivered = 0;
+        tu_uint64 yields = 0;
+        absl::Duration lastInterruptLatency = absl::ZeroDuration();
+        absl::Duration maxInterruptLatency = absl::ZeroDuration();
+        absl::Duration totalInterruptLatency = absl::ZeroDuration();
+    };
+
+    /**
+     * Inspector which makes the interpreter yield cooperatively. Every `instructionBudget`
+     * instructions the interpreter reaches a safepoint, and if an interrupt has been requested
+     * then the interpreter stops with an interrupted status before executing the next
+     * instruction. If a yield check is specified then the interpreter also stops at a safepoint
+     * when no interrupt is pending but the check returns true, which lets a runner give up its
+     * worker to other runners. Interrupts may be requested from any thread, all other methods must
+     * only be called from the interpreter thread.
+     */
+    class SafepointInspector : public lyric_runtime::AbstractInspector {
+    public:
+        explicit SafepointInspector(
+            tu_uint32 instructionBudget,
+            absl::AnyInvocable<bool()> shouldYield = {});
+
+        tu_uint32 getInstructionBudget() const;
+
+        void requestInterrupt();
+        void clearInterrupt();
+        bool takeInterrupted();
+        bool takeYielded();
+        SafepointStats getStats() const;
+
+        tempo_utils::Status beforeOp(
+            const lyric_object::OpCell &op,
+            lyric_runtime::BytecodeInterpreter *interp,
+            lyric_runtime::InterpreterState *state) override;
+        tempo_utils::Status afterOp(
+            const lyric_object::OpCell &op,
+            lyric_runtime::BytecodeInterpreter *interp,
+            lyric_runtime::InterpreterState *state) override;
+        tempo_utils::Status onInterrupt(
+            const lyric_runtime::DataCell &cell,
+            lyric_runtime::BytecodeInterpreter *interp,
+            lyric_runtime::InterpreterState *state) override;
+        tempo_utils::Result<lyric_runtime::DataCell> onError(
+            const lyric_object::OpCell &op,
+            const tempo_utils::Status &status,
+            lyric_runtime::BytecodeInterpreter *interp,
+            lyric_runtime::InterpreterState *state) override;
+        tempo_utils::Result<lyric_runtime::InterpreterExit> onHalt(
+            const lyric_object::OpCell &op,
+            const lyric_runtime::DataCell &cell,
+            lyric_runtime::BytecodeInterpreter *interp,
+            lyric_runtime::InterpreterState *state) override;
+
+    private:
+        tu_uint32 m_instructionBudget;
+        tu_uint32 m_remaining;
+        absl::AnyInvocable<bool()> m_shouldYield;
+        bool m_interrupted;
+        bool m_yielded;
+        // time in microseconds since the epoch when the pending interrupt was requested, or 0
+        std::atomic<tu_int64> m_requestedAt;
+        SafepointStats m_stats;
+    };
+}
+
+#endif // CHORD_MACHINE_SAFEPOINT_INSPECTOR_H
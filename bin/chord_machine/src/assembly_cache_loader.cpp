@@ -0,0 +1,329 @@
+
+#include <chord_machine/assembly_cache_loader.h>
+#include <tempo_utils/log_stream.h>
+
+/**
+ * Returns the key of the package containing the module, which is the module location without
+ * the module path. The package key of a module in a package matches the url of the package
+ * specifier.
+ */
+static std::string
+package_key(const lyric_common::ModuleLocation &location)
+{
+    auto key = location.toString();
+    auto path = location.getPath().toString();
+    if (!path.empty() && key.ends_with(path)) {
+        key.resize(key.size() - path.size());
+    }
+    while (key.ends_with('/')) {
+        key.pop_back();
+    }
+    return key;
+}
+
+static std::string
+package_key(const zuri_packager::PackageSpecifier &specifier)
+{
+    auto key = specifier.toUrl().toString();
+    while (key.ends_with('/')) {
+        key.pop_back();
+    }
+    return key;
+}
+
+chord_machine::AssemblyCacheLoader::AssemblyCacheLoader(
+    std::shared_ptr<lyric_runtime::AbstractLoader> loader,
+    const AssemblyCacheOptions &options,
+    std::shared_ptr<chord_common::AssemblyStore> store,
+    PackageStamper stamper)
+    : m_loader(std::move(loader)),
+      m_options(options),
+      m_store(std::move(store)),
+      m_stamper(std::move(stamper))
+{
+    TU_ASSERT (m_loader != nullptr);
+}
+
+tempo_utils::Result<bool>
+chord_machine::AssemblyCacheLoader::hasModule(const lyric_common::ModuleLocation &location) const
+{
+    {
+        absl::MutexLock locker(&m_lock);
+        if (m_index.contains(location.toString()))
+            return true;
+    }
+    return m_loader->hasModule(location);
+}
+
+tempo_utils::Result<Option<lyric_object::LyricObject>>
+chord_machine::AssemblyCacheLoader::loadModule(const lyric_common::ModuleLocation &location)
+{
+    auto key = location.toString();
+
+    {
+        absl::MutexLock locker(&m_lock);
+        auto entry = m_index.find(key);
+        if (entry != m_index.cend()) {
+            // move the entry to the front of the list so it is evicted last
+            m_entries.splice(m_entries.begin(), m_entries, entry->second);
+            m_stats.hits++;
+            return Option<lyric_object::LyricObject>(entry->second->object);
+        }
+        m_stats.misses++;
+    }
+
+    auto packageKey = package_key(location);
+
+    // discard stored modules of the package if they were stored from a different archive
+    TU_RETURN_IF_NOT_OK (validateOnFirstLoad(location, packageKey));
+
+    // map the module from the store if another machine has already loaded it
+    auto objectOption = mapStored(location, key, packageKey);
+
+    // otherwise load the module without holding the lock, the wrapped loader may be slow
+    if (objectOption.isEmpty()) {
+        TU_ASSIGN_OR_RETURN (objectOption, m_loader->loadModule(location));
+        if (objectOption.isEmpty())
+            return objectOption;
+        publishStored(key, packageKey, objectOption.getValue());
+    }
+
+    absl::MutexLock locker(&m_lock);
+    // another interpreter may have loaded the same module concurrently
+    if (!m_index.contains(key)) {
+        insertEntry(std::move(key), std::move(packageKey), objectOption.getValue());
+    }
+    return objectOption;
+}
+
+tempo_utils::Result<Option<lyric_runtime::NativeInterface *>>
+chord_machine::AssemblyCacheLoader::loadPlugin(
+    const lyric_common::ModuleLocation &location,
+    const lyric_object::PluginSpecifier &specifier)
+{
+    return m_loader->loadPlugin(location, specifier);
+}
+
+/**
+ * Remove the module from the cache, and from the store if there is one.
+ *
+ * @param location The module location.
+ */
+void
+chord_machine::AssemblyCacheLoader::invalidate(const lyric_common::ModuleLocation &location)
+{
+    auto key = location.toString();
+
+    if (m_store != nullptr) {
+        auto status = m_store->invalidateObject(package_key(location), key);
+        TU_LOG_WARN_IF (status.notOk()) << "failed to invalidate stored module " << key << ": " << status;
+    }
+
+    absl::MutexLock locker(&m_lock);
+    auto entry = m_index.find(key);
+    if (entry == m_index.cend())
+        return;
+    eraseEntry(entry->second);
+    m_stats.invalidations++;
+}
+
+/**
+ * Remove all modules in the package from the cache, and from the store if there is one.
+ *
+ * @param specifier The package specifier.
+ */
+void
+chord_machine::AssemblyCacheLoader::invalidatePackage(const zuri_packager::PackageSpecifier &specifier)
+{
+    auto packageKey = package_key(specifier);
+
+    if (m_store != nullptr) {
+        auto status = m_store->invalidatePackage(packageKey);
+        TU_LOG_WARN_IF (status.notOk()) << "failed to invalidate stored package " << packageKey << ": " << status;
+    }
+
+    absl::MutexLock locker(&m_lock);
+    invalidateEntries(packageKey);
+}
+
+/**
+ * Check that the stored modules for the package were loaded from the package archive identified
+ * by the stamp. If the package archive has changed then the modules in the package are removed
+ * from the store and from the cache.
+ *
+ * @param specifier The package specifier.
+ * @param stamp Identifies the package archive.
+ * @return Ok status if the package was validated, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_machine::AssemblyCacheLoader::validatePackage(
+    const zuri_packager::PackageSpecifier &specifier,
+    std::string_view stamp)
+{
+    if (m_store == nullptr)
+        return {};
+
+    auto packageKey = package_key(specifier);
+    bool valid;
+    TU_ASSIGN_OR_RETURN (valid, m_store->validatePackage(packageKey, stamp));
+
+    absl::MutexLock locker(&m_lock);
+    if (!valid) {
+        invalidateEntries(packageKey);
+    }
+    m_validatedPackages.insert(packageKey);
+    return {};
+}
+
+/**
+ * Validate the package containing the module against the stamp of its archive, unless the package
+ * has already been validated by this loader.
+ */
+tempo_utils::Status
+chord_machine::AssemblyCacheLoader::validateOnFirstLoad(
+    const lyric_common::ModuleLocation &location,
+    const std::string &packageKey)
+{
+    if (m_store == nullptr || m_stamper == nullptr)
+        return {};
+    {
+        absl::MutexLock locker(&m_lock);
+        if (m_validatedPackages.contains(packageKey))
+            return {};
+    }
+
+    auto specifier = zuri_packager::PackageSpecifier::fromAuthority(location.getAuthority());
+    if (!specifier.isValid())
+        return {};
+
+    Option<std::string> stampOption;
+    TU_ASSIGN_OR_RETURN (stampOption, m_stamper(specifier));
+
+    // a package without an archive has nothing to validate against
+    if (stampOption.isEmpty()) {
+        absl::MutexLock locker(&m_lock);
+        m_validatedPackages.insert(packageKey);
+        return {};
+    }
+    return validatePackage(specifier, stampOption.getValue());
+}
+
+void
+chord_machine::AssemblyCacheLoader::clear()
+{
+    absl::MutexLock locker(&m_lock);
+    m_stats.invalidations += m_entries.size();
+    m_entries.clear();
+    m_index.clear();
+    m_validatedPackages.clear();
+    m_stats.cachedObjects = 0;
+    m_stats.cachedBytes = 0;
+}
+
+chord_machine::AssemblyCacheStats
+chord_machine::AssemblyCacheLoader::getStats() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_stats;
+}
+
+/**
+ * Map the module from the store. A stored object which fails verification is removed from the
+ * store so the module is loaded from the package archive and stored again.
+ */
+Option<lyric_object::LyricObject>
+chord_machine::AssemblyCacheLoader::mapStored(
+    const lyric_common::ModuleLocation &location,
+    const std::string &key,
+    const std::string &packageKey)
+{
+    if (m_store == nullptr)
+        return {};
+
+    auto mapObjectResult = m_store->mapObject(packageKey, key);
+    if (mapObjectResult.isStatus()) {
+        TU_LOG_WARN << "failed to map stored module " << key << ": " << mapObjectResult.getStatus();
+        absl::MutexLock locker(&m_lock);
+        m_stats.storeMisses++;
+        return {};
+    }
+
+    auto bytes = mapObjectResult.getResult();
+    if (bytes != nullptr) {
+        lyric_object::LyricObject object(bytes);
+        if (object.isValid()) {
+            absl::MutexLock locker(&m_lock);
+            m_stats.storeHits++;
+            return Option<lyric_object::LyricObject>(object);
+        }
+        TU_LOG_WARN << "stored module " << key << " is invalid";
+        invalidate(location);
+    }
+
+    absl::MutexLock locker(&m_lock);
+    m_stats.storeMisses++;
+    return {};
+}
+
+/**
+ * Publish the module loaded by the wrapped loader to the store. Failing to store the module is
+ * not an error, the module is loaded from the package archive again by the next machine.
+ */
+void
+chord_machine::AssemblyCacheLoader::publishStored(
+    const std::string &key,
+    const std::string &packageKey,
+    const lyric_object::LyricObject &object)
+{
+    if (m_store == nullptr)
+        return;
+    auto status = m_store->storeObject(packageKey, key, object.bytesView());
+    TU_LOG_WARN_IF (status.notOk()) << "failed to store module " << key << ": " << status;
+}
+
+void
+chord_machine::AssemblyCacheLoader::invalidateEntries(const std::string &packageKey)
+{
+    for (auto iterator = m_entries.begin(); iterator != m_entries.end();) {
+        auto curr = iterator++;
+        if (curr->packageKey == packageKey) {
+            eraseEntry(curr);
+            m_stats.invalidations++;
+        }
+    }
+}
+
+void
+chord_machine::AssemblyCacheLoader::insertEntry(
+    std::string key,
+    std::string packageKey,
+    const lyric_object::LyricObject &object)
+{
+    tu_uint64 size = object.bytesView().size();
+
+    // objects which could never fit are not cached
+    if (size > m_options.maxCachedBytes || m_options.maxCachedObjects == 0)
+        return;
+
+    // evict the least recently used entries until the new entry fits
+    while (!m_entries.empty() && (m_stats.cachedBytes + size > m_options.maxCachedBytes
+        || m_stats.cachedObjects >= m_options.maxCachedObjects)) {
+        TU_LOG_V << "evicting " << m_entries.back().key << " from assembly cache";
+        eraseEntry(std::prev(m_entries.end()));
+        m_stats.evictions++;
+    }
+
+    m_entries.push_front(CacheEntry{key, std::move(packageKey), object, size});
+    m_index[std::move(key)] = m_entries.begin();
+    m_stats.cachedObjects++;
+    m_stats.cachedBytes += size;
+}
+
+void
+chord_machine::AssemblyCacheLoader::eraseEntry(std::list<CacheEntry>::iterator entry)
+{
+    m_stats.cachedObjects--;
+    m_stats.cachedBytes -= entry->size;
+    m_index.erase(entry->key);
+    m_entries.erase(entry);
+}
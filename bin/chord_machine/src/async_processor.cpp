@@ -10,14 +10,13 @@ chord_machine::BaseAsyncProcessor::BaseAsyncProcessor()
 
 chord_machine::BaseAsyncProcessor::~BaseAsyncProcessor()
 {
-    absl::MutexLock locker(&m_lock);
-    if (m_async) {
-        uv_close((uv_handle_t *) m_async, nullptr);
-        delete m_async;
+    auto *async = m_async.load();
+    if (async) {
+        uv_close((uv_handle_t *) async, nullptr);
+        delete async;
     }
-    while (!m_queue.empty()) {
-        auto *message = m_queue.front();
-        m_queue.pop();
+    AbstractMessage *message;
+    while ((message = m_mailbox.pop()) != nullptr) {
         TU_LOG_WARN << "dropping unhandled message: " << message->toString();
         delete message;
     }
@@ -33,13 +32,14 @@ chord_machine::on_message_receive(uv_async_t *async)
 tempo_utils::Status
 chord_machine::BaseAsyncProcessor::initialize(uv_loop_t *loop)
 {
-    absl::MutexLock locker(&m_lock);
-    TU_ASSERT (m_async == nullptr);
-    m_async = new uv_async_t;
-    uv_async_init(loop, m_async, on_message_receive);
-    m_async->data = this;
-    if (!m_queue.empty()) {
-        uv_async_send(m_async);
+    TU_ASSERT (m_async.load() == nullptr);
+    auto *async = new uv_async_t;
+    uv_async_init(loop, async, on_message_receive);
+    async->data = this;
+    m_async.store(async);
+    // messages sent before the processor was initialized did not signal
+    if (!m_mailbox.isEmpty()) {
+        uv_async_send(async);
     }
     return {};
 }
@@ -47,43 +47,46 @@ chord_machine::BaseAsyncProcessor::initialize(uv_loop_t *loop)
 void
 chord_machine::BaseAsyncProcessor::sendAbstractMessage(AbstractMessage *message)
 {
-    absl::MutexLock locker(&m_lock);
-    m_queue.push(message);
+    // only signal when the mailbox goes from empty to non-empty, the processor drains any
+    // messages which arrive after that without being woken again
+    if (!m_mailbox.push(message))
+        return;
     // if processor is not yet initialized then do not send the signal
-    if (m_async != nullptr) {
-        uv_async_send(m_async);
+    auto *async = m_async.load();
+    if (async != nullptr) {
+        uv_async_send(async);
     }
 }
 
 void
 chord_machine::BaseAsyncProcessor::runUntilCancelled()
 {
-    {
-        absl::MutexLock locker(&m_lock);
-        TU_ASSERT (m_async != nullptr);
-    }
-    uv_run(m_async->loop, UV_RUN_DEFAULT);
+    auto *async = m_async.load();
+    TU_ASSERT (async != nullptr);
+    uv_run(async->loop, UV_RUN_DEFAULT);
 }
 
 void
 chord_machine::BaseAsyncProcessor::processAvailableMessages()
 {
-    std::queue<AbstractMessage *> incoming;
-
-    {
-        absl::MutexLock locker(&m_lock);
-        m_queue.swap(incoming);
+    // process only the messages which are available now, so a busy producer cannot starve the loop
+    auto numAvailable = m_mailbox.size();
+    for (tu_uint32 i = 0; i < numAvailable; i++) {
+        auto *message = m_mailbox.pop();
+        if (message == nullptr)
+            break;
+        processAbstractMessage(message);
     }
 
-    while (!incoming.empty()) {
-        auto *message = incoming.front();
-        incoming.pop();
-        processAbstractMessage(message);
+    // messages which arrived during processing did not signal, so signal for the next batch
+    auto *async = m_async.load();
+    if (!m_mailbox.isEmpty() && async != nullptr) {
+        uv_async_send(async);
     }
 }
 
 void
 chord_machine::BaseAsyncProcessor::cancelProcessing()
 {
-    uv_stop(m_async->loop);
+    uv_stop(m_async.load()->loop);
 }
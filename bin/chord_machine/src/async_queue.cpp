@@ -10,13 +10,13 @@ chord_machine::BaseAsyncQueue::BaseAsyncQueue()
 
 chord_machine::BaseAsyncQueue::~BaseAsyncQueue()
 {
-    if (m_async) {
-        uv_close((uv_handle_t *) m_async, nullptr);
-        delete m_async;
+    auto *async = m_async.load();
+    if (async) {
+        uv_close((uv_handle_t *) async, nullptr);
+        delete async;
     }
-    while (!m_queue.empty()) {
-        auto *message = m_queue.front();
-        m_queue.pop();
+    AbstractMessage *message;
+    while ((message = m_mailbox.pop()) != nullptr) {
         TU_LOG_WARN << "dropping unhandled message: " << message->toString();
         delete message;
     }
@@ -32,12 +32,13 @@ chord_machine::on_async_queue_receive(uv_async_t *async)
 tempo_utils::Status
 chord_machine::BaseAsyncQueue::initialize(uv_loop_t *loop)
 {
-    absl::MutexLock locker(&m_lock);
-    TU_ASSERT (m_async == nullptr);
-    m_async = new uv_async_t;
-    uv_async_init(loop, m_async, on_async_queue_receive);
-    if (!m_queue.empty()) {
-        uv_async_send(m_async);
+    TU_ASSERT (m_async.load() == nullptr);
+    auto *async = new uv_async_t;
+    uv_async_init(loop, async, on_async_queue_receive);
+    m_async.store(async);
+    // messages sent before the queue was initialized did not signal
+    if (!m_mailbox.isEmpty()) {
+        uv_async_send(async);
     }
     return tempo_utils::Status();
 }
@@ -45,68 +46,40 @@ chord_machine::BaseAsyncQueue::initialize(uv_loop_t *loop)
 bool
 chord_machine::BaseAsyncQueue::messagesPending()
 {
-    absl::MutexLock locker(&m_lock);
-    return !m_queue.empty();
+    return !m_mailbox.isEmpty();
 }
 
 void
 chord_machine::BaseAsyncQueue::sendAbstractMessage(AbstractMessage *message)
 {
-    absl::MutexLock locker(&m_lock);
-    m_queue.push(message);
+    // only signal when the mailbox goes from empty to non-empty, the consumer drains any
+    // messages which arrive after that without being woken again
+    if (!m_mailbox.push(message))
+        return;
     // if queue is not yet initialized then do not send the signal
-    if (m_async != nullptr) {
-        uv_async_send(m_async);
+    auto *async = m_async.load();
+    if (async != nullptr) {
+        uv_async_send(async);
     }
 }
 
 chord_machine::AbstractMessage *
 chord_machine::BaseAsyncQueue::waitForAbstractMessage()
 {
-    {
-        // grab the lock and check if there is a message already in the queue
-        absl::MutexLock locker(&m_lock);
-        if (!m_queue.empty()) {
-            // pop the message
-            auto *message = m_queue.front();
-            m_queue.pop();
-            // if there are additional messages pending then send signal
-            if (!m_queue.empty()) {
-                uv_async_send(m_async);
-            }
-            // return message immediately without blocking
-            return message;
-        }
-    }
+    // check if there is a message already in the queue and return it immediately without blocking
+    auto *message = m_mailbox.pop();
+    if (message != nullptr)
+        return message;
 
     // block on the main loop
-    uv_run(m_async->loop, UV_RUN_DEFAULT);
-
-    // grab the lock and check the queue again
-    absl::MutexLock locker(&m_lock);
-    if (m_queue.empty())
-        return nullptr;
-
-    // pop the message
-    auto *message = m_queue.front();
-    m_queue.pop();
+    uv_run(m_async.load()->loop, UV_RUN_DEFAULT);
 
-    // if there are additional messages pending then send signal
-    if (!m_queue.empty()) {
-        uv_async_send(m_async);
-    }
-
-    return message;
+    // check the queue again, this may return nullptr if the loop was stopped for another reason
+    return m_mailbox.pop();
 }
 
 chord_machine::AbstractMessage *
 chord_machine::BaseAsyncQueue::takeAvailableAbstractMessage()
 {
-    absl::MutexLock locker(&m_lock);
-    if (m_queue.empty())
-        return nullptr;
-
-    auto *message = m_queue.front();
-    m_queue.pop();
-    return message;
+    return m_mailbox.pop();
 }
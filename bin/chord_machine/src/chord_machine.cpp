@@ -97,8 +97,8 @@ chord_machine::chord_machine(int argc, const char *argv[])
 
     // initialize logging
     tempo_utils::LoggingConfiguration loggingConfig;
-    loggingConfig.severityFilter = tempo_utils::SeverityFilter::kVeryVerbose;
-    loggingConfig.flushEveryMessage = true;
+    loggingConfig.severityFilter = chordLocalMachineConfig.logSeverityFilter;
+    loggingConfig.flushEveryMessage = chordLocalMachineConfig.logFlushEveryMessage;
     if (!chordLocalMachineConfig.logFile.empty()) {
         auto logSink = std::make_unique<tempo_utils::LogFileSink>(chordLocalMachineConfig.logFile);
         tempo_utils::init_logging(loggingConfig, std::move(logSink));
@@ -142,21 +142,39 @@ chord_machine::chord_machine(int argc, const char *argv[])
         chordLocalMachineData.invokeStub, componentConstructor, chordLocalMachineConfig,
         chordLocalMachineData.customChannel));
 
+    // construct the certificate signing request. key generation is the most expensive step of
+    // startup and does not depend on the assignment, so a pooled machine does it ahead of time.
+    TU_RETURN_IF_NOT_OK (make_csr_key_pair(
+        chordLocalMachineData.csrKeyPair, componentConstructor, chordLocalMachineConfig));
+
+    // if the machine is pooled then wait until it is assigned before loading the main package
+    if (chordLocalMachineConfig.pooled) {
+        TU_RETURN_IF_NOT_OK (await_assignment(chordLocalMachineConfig, chordLocalMachineData));
+    }
+
+    // construct the loaders
+    TU_RETURN_IF_NOT_OK (make_shared_loaders(chordLocalMachineData.sharedLoaders, chordLocalMachineConfig));
+
     // construct the interpreter state
-    TU_RETURN_IF_NOT_OK (make_interpreter_state(
-        chordLocalMachineData.interpreterState, componentConstructor, chordLocalMachineConfig));
+    TU_RETURN_IF_NOT_OK (make_interpreter_state(chordLocalMachineData.interpreterState,
+        componentConstructor, chordLocalMachineConfig, chordLocalMachineData.sharedLoaders));
+
+    // if worker threads are specified then the process hosts machines on a worker pool, and
+    // further machines are placed into the process with the PlaceMachine rpc
+    if (chordLocalMachineConfig.workerThreads > 0) {
+        TU_RETURN_IF_NOT_OK (make_machine_host(chordLocalMachineData.machineHost,
+            chordLocalMachineConfig, chordLocalMachineData.sharedLoaders));
+    }
 
     // construct the local machine
     TU_RETURN_IF_NOT_OK (make_local_machine(chordLocalMachineData.localMachine,
-        componentConstructor, chordLocalMachineConfig, chordLocalMachineData.interpreterState, &processor));
+        componentConstructor, chordLocalMachineConfig, chordLocalMachineData.interpreterState, &processor,
+        chordLocalMachineData.machineHost.get()));
 
     // allocate the remoting service
     TU_RETURN_IF_NOT_OK (make_remoting_service(chordLocalMachineData.remotingService,
-        componentConstructor, chordLocalMachineConfig, chordLocalMachineData.localMachine, &initComplete));
-
-    // construct the certificate signing request
-    TU_RETURN_IF_NOT_OK (make_csr_key_pair(
-        chordLocalMachineData.csrKeyPair, componentConstructor, chordLocalMachineConfig));
+        componentConstructor, chordLocalMachineConfig, chordLocalMachineData.localMachine, &initComplete,
+        chordLocalMachineData.machineHost.get()));
 
     // construct the grpc binder
     TU_RETURN_IF_NOT_OK (make_grpc_binder(
@@ -174,9 +192,21 @@ chord_machine::chord_machine(int argc, const char *argv[])
     TU_LOG_WARN_IF (shutdownMachineStatus.notOk()) << "failed to shut down local machine: " << shutdownMachineStatus;
     chordLocalMachineData.localMachine.reset();
 
+    // shut down the machine host, which terminates any other hosted machines
+    if (chordLocalMachineData.machineHost != nullptr) {
+        TU_LOG_V << "shutting down machine host";
+        auto shutdownHostStatus = chordLocalMachineData.machineHost->shutdown();
+        TU_LOG_WARN_IF (shutdownHostStatus.notOk()) << "failed to shut down machine host: " << shutdownHostStatus;
+    }
+
     // flush any remaining RunnerReply messages
     processor.processAvailableMessages();
 
+    auto assemblyCacheStats = chordLocalMachineData.sharedLoaders.assemblyCache->getStats();
+    TU_LOG_V << "assembly cache: " << assemblyCacheStats.hits << " hits, "
+        << assemblyCacheStats.misses << " misses, " << assemblyCacheStats.evictions << " evictions, "
+        << assemblyCacheStats.storeHits << " store hits, " << assemblyCacheStats.storeMisses << " store misses";
+
     //
     uv_print_all_handles(&chordLocalMachineData.mainLoop, stderr);
 
@@ -23,23 +23,26 @@ chord_machine::ComponentConstructor::createLocalMachine(
     const std::string &machineName,
     bool startSuspended,
     std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
-    AbstractMessageSender<RunnerReply> *processor) const
+    AbstractMessageSender<RunnerReply> *processor,
+    const InterpreterRunnerOptions &runnerOptions) const
 {
     TU_ASSERT (!machineName.empty());
     TU_ASSERT (interpreterState != nullptr);
     TU_ASSERT (processor != nullptr);
-    return std::make_shared<LocalMachine>(machineName, startSuspended, interpreterState, processor);
+    return std::make_shared<LocalMachine>(
+        machineName, startSuspended, interpreterState, processor, runnerOptions);
 }
 
 std::unique_ptr<chord_machine::RemotingService>
 chord_machine::ComponentConstructor::createRemotingService(
     bool startSuspended,
     std::shared_ptr<LocalMachine> localMachine,
-    uv_async_t *initComplete) const
+    uv_async_t *initComplete,
+    MachineHost *machineHost) const
 {
     TU_ASSERT (localMachine != nullptr);
     TU_ASSERT (initComplete != nullptr);
-    return std::make_unique<RemotingService>(startSuspended, std::move(localMachine), initComplete);
+    return std::make_unique<RemotingService>(startSuspended, std::move(localMachine), initComplete, machineHost);
 }
 
 std::shared_ptr<grpc::ChannelInterface>
@@ -66,7 +69,7 @@ chord_machine::ComponentConstructor::createGrpcBinder(
     const lyric_common::RuntimePolicy &runtimePolicy,
     const std::filesystem::path &pemPrivateKeyFile,
     const std::filesystem::path &pemRootCABundleFile,
-    chord_remoting::RemotingService::CallbackService *remotingService) const
+    grpc::Service *remotingService) const
 {
     TU_ASSERT (!binderEndpoint.empty());
     TU_ASSERT (!pemPrivateKeyFile.empty());
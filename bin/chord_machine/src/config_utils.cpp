@@ -25,9 +25,17 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
     tempo_config::SeqTParser packageCacheDirectoriesParser(&packageCacheDirectoryParser, {});
     tempo_config::UrlParser expectedPortParser;
     tempo_config::SetTParser expectedPortsParser(&expectedPortParser, {});
+    tempo_config::UrlParser gatewayPortParser;
+    tempo_config::SetTParser gatewayPortsParser(&gatewayPortParser, {});
     tempo_config::BooleanParser startSuspendedParser(false);
+    tempo_config::BooleanParser pooledParser(false);
+    tempo_config::IntegerParser instructionBudgetParser(0);
+    tempo_config::IntegerParser workerThreadsParser(0);
+    tempo_config::IntegerParser assemblyCacheSizeParser(0);
+    tempo_config::PathParser assemblyStoreDirectoryParser(std::filesystem::path{});
     tempo_config::PathParser pemRootCABundleFileParser(std::filesystem::path{});
     tempo_config::PathParser logFileParser(std::filesystem::path{});
+    tempo_config::IntegerParser verboseParser(0);
     zuri_packager::PackageSpecifierParser mainPackageParser;
     tempo_config::StringParser mainArgParser;
     tempo_config::SeqTParser mainArgumentsParser(&mainArgParser);
@@ -38,9 +46,17 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
         {"supervisorEndpoint", {}, "register machine using the specified endpoint", "ENDPOINT"},
         {"packageCacheDirectories", {}, "package cache", "DIR"},
         {"expectedPorts", {}, "expected port", "PROTOCOL-URL"},
+        {"gatewayPorts", {}, "expected port which serves requests forwarded by the http gateway", "PROTOCOL-URL"},
         {"startSuspended", {}, "start machine in suspended state"},
+        {"pooled", {}, "start machine in the pool and wait for assignment"},
+        {"instructionBudget", {}, "yield at a safepoint after the specified number of instructions", "COUNT"},
+        {"workerThreads", {}, "host machines on the specified number of worker threads", "COUNT"},
+        {"assemblyCacheSize", {}, "limit the assembly cache to the specified number of megabytes", "MB"},
+        {"assemblyStoreDirectory", {}, "map and publish verified assemblies in the specified shared store", "DIR"},
         {"pemRootCABundleFile", {}, "the root CA certificate bundle used by gRPC", "FILE"},
         {"logFile", {}, "path to log file", "FILE"},
+        {"verbose", verboseParser.getDefault(),
+            "log verbose output (specify twice for even more verbose output)"},
         {"mainPackage", {}, "Main package", "SPECIFIER"},
         {"mainArgs", {}, "List of arguments to pass to the program", "ARGS"},
     };
@@ -51,9 +67,16 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
         {"runDirectory", {"--run-directory"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"packageCacheDirectories", {"-P", "--package-cache"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"expectedPorts", {"--expected-port"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"gatewayPorts", {"--gateway-port"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"startSuspended", {"--start-suspended"}, tempo_command::GroupingType::NO_ARGUMENT},
+        {"pooled", {"--pooled"}, tempo_command::GroupingType::NO_ARGUMENT},
+        {"instructionBudget", {"--instruction-budget"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"workerThreads", {"--worker-threads"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"assemblyCacheSize", {"--assembly-cache-size"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"assemblyStoreDirectory", {"--assembly-store"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"pemRootCABundleFile", {"--ca-bundle"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
         {"logFile", {"--log-file"}, tempo_command::GroupingType::SINGLE_ARGUMENT},
+        {"verbose", {"-v"}, tempo_command::GroupingType::NO_ARGUMENT},
         {"help", {"-h", "--help"}, tempo_command::GroupingType::HELP_FLAG},
         {"version", {"--version"}, tempo_command::GroupingType::VERSION_FLAG},
     };
@@ -64,13 +87,20 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "supervisorEndpoint"},
         {tempo_command::MappingType::ANY_INSTANCES, "packageCacheDirectories"},
         {tempo_command::MappingType::ANY_INSTANCES, "expectedPorts"},
+        {tempo_command::MappingType::ANY_INSTANCES, "gatewayPorts"},
         {tempo_command::MappingType::TRUE_IF_INSTANCE, "startSuspended"},
+        {tempo_command::MappingType::TRUE_IF_INSTANCE, "pooled"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "instructionBudget"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "workerThreads"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "assemblyCacheSize"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "assemblyStoreDirectory"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "pemRootCABundleFile"},
         {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "logFile"},
+        {tempo_command::MappingType::COUNT_INSTANCES, "verbose"},
     };
 
     std::vector<tempo_command::Mapping> argMappings = {
-        {tempo_command::MappingType::ONE_INSTANCE, "mainPackage"},
+        {tempo_command::MappingType::ZERO_OR_ONE_INSTANCE, "mainPackage"},
         {tempo_command::MappingType::ANY_INSTANCES, "mainArgs"},
     };
 
@@ -131,6 +161,13 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.expectedPorts,
         expectedPortsParser, commandConfig, "expectedPorts"));
 
+    // determine the gateway ports, each gateway port is also an expected port
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.gatewayPorts,
+        gatewayPortsParser, commandConfig, "gatewayPorts"));
+    for (const auto &gatewayPort : chordLocalMachineConfig.gatewayPorts) {
+        chordLocalMachineConfig.expectedPorts.insert(gatewayPort);
+    }
+
     // determine start suspended
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.startSuspended,
         startSuspendedParser, commandConfig, "startSuspended"));
@@ -143,13 +180,68 @@ chord_machine::configure(ChordLocalMachineConfig &chordLocalMachineConfig, int a
     TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.logFile,
         logFileParser, commandConfig, "logFile"));
 
-    // determine the main package
-    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.mainPackage,
-        mainPackageParser, commandConfig, "mainPackage"));
+    // determine the log severity, every message is flushed only at the most verbose level
+    int verbose;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(verbose,
+        verboseParser, commandConfig, "verbose"));
+    if (verbose == 0) {
+        chordLocalMachineConfig.logSeverityFilter = tempo_utils::SeverityFilter::kDefault;
+    } else if (verbose == 1) {
+        chordLocalMachineConfig.logSeverityFilter = tempo_utils::SeverityFilter::kVerbose;
+    } else {
+        chordLocalMachineConfig.logSeverityFilter = tempo_utils::SeverityFilter::kVeryVerbose;
+    }
+    chordLocalMachineConfig.logFlushEveryMessage = verbose > 1;
+
+    // determine whether the machine is pooled
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.pooled,
+        pooledParser, commandConfig, "pooled"));
+
+    // determine the instruction budget
+    int instructionBudget;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(instructionBudget,
+        instructionBudgetParser, commandConfig, "instructionBudget"));
+    if (instructionBudget < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "instruction budget must not be negative");
+    chordLocalMachineConfig.instructionBudget = static_cast<tu_uint32>(instructionBudget);
+
+    // determine the number of worker threads, zero means the machine is not a host
+    int workerThreads;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(workerThreads,
+        workerThreadsParser, commandConfig, "workerThreads"));
+    if (workerThreads < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "worker threads must not be negative");
+    chordLocalMachineConfig.workerThreads = static_cast<tu_uint32>(workerThreads);
 
-    // determine the main arguments
-    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.mainArguments,
-        mainArgumentsParser, commandConfig, "mainArguments"));
+    // determine the assembly cache size, zero means use the default size
+    int assemblyCacheSize;
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(assemblyCacheSize,
+        assemblyCacheSizeParser, commandConfig, "assemblyCacheSize"));
+    if (assemblyCacheSize < 0)
+        return tempo_command::CommandStatus::forCondition(
+            tempo_command::CommandCondition::kInvalidConfiguration,
+            "assembly cache size must not be negative");
+    chordLocalMachineConfig.assemblyCacheSize = static_cast<tu_uint64>(assemblyCacheSize) * 1024 * 1024;
+
+    // determine the assembly store directory, empty means the machine does not use a store
+    TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.assemblyStoreDirectory,
+        assemblyStoreDirectoryParser, commandConfig, "assemblyStoreDirectory"));
+
+    // a pooled machine receives the main package and arguments when it is assigned
+    if (!chordLocalMachineConfig.pooled) {
+
+        // determine the main package
+        TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.mainPackage,
+            mainPackageParser, commandConfig, "mainPackage"));
+
+        // determine the main arguments
+        TU_RETURN_IF_NOT_OK(tempo_command::parse_command_config(chordLocalMachineConfig.mainArguments,
+            mainArgumentsParser, commandConfig, "mainArguments"));
+    }
 
     // set the binder endpoint
     auto binderSocketPath = chordLocalMachineConfig.runDirectory / "cap.sock";
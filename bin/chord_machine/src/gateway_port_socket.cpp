@@ -0,0 +1,213 @@
+
+#include <chord_machine/gateway_port_socket.h>
+#include <tempo_utils/log_stream.h>
+
+chord_machine::GatewayPortSocket::GatewayPortSocket(
+    std::shared_ptr<lyric_runtime::DuplexPort> port,
+    uv_loop_t *loop,
+    tu_uint32 window)
+    : m_port(port),
+      m_loop(loop),
+      m_window(window),
+      m_deliver(nullptr),
+      m_writer(nullptr)
+{
+    TU_ASSERT (m_port != nullptr);
+    TU_ASSERT (m_loop != nullptr);
+    TU_ASSERT (m_window > 0);
+}
+
+chord_machine::GatewayPortSocket::~GatewayPortSocket()
+{
+    if (m_deliver != nullptr) {
+        uv_close((uv_handle_t *) m_deliver, [](uv_handle_t *handle) {
+            delete (uv_async_t *) handle;
+        });
+    }
+}
+
+void
+chord_machine::on_gateway_port_deliver(uv_async_t *async)
+{
+    auto *socket = (GatewayPortSocket *) async->data;
+    socket->deliverReceived();
+}
+
+tempo_utils::Status
+chord_machine::GatewayPortSocket::initialize()
+{
+    if (m_deliver != nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "gateway port socket is already initialized");
+
+    auto *deliver = new uv_async_t;
+    auto ret = uv_async_init(m_loop, deliver, on_gateway_port_deliver);
+    if (ret < 0) {
+        delete deliver;
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "failed to initialize async: {}", uv_strerror(ret));
+    }
+    deliver->data = this;
+    m_deliver = deliver;
+    return {};
+}
+
+bool
+chord_machine::GatewayPortSocket::isAttached()
+{
+    return m_writer != nullptr;
+}
+
+tempo_utils::Status
+chord_machine::GatewayPortSocket::attach(chord_common::AbstractProtocolWriter *writer)
+{
+    m_writer = writer;
+    m_writeQueue.attach(writer);
+    auto status = m_port->attach(this);
+    if (status.notOk())
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, status.getMessage());
+
+    // grant the gateway credit for the requests which may wait for an answer
+    tu_uint32 credit;
+    {
+        absl::MutexLock locker(&m_lock);
+        credit = m_window - m_unanswered.size();
+    }
+    return m_writer->grantCredit(credit);
+}
+
+tempo_utils::Status
+chord_machine::GatewayPortSocket::send(std::string_view message)
+{
+    return respond(message);
+}
+
+/**
+ * Decode a request frame from the gateway and queue its body for delivery to the port. A request
+ * which cannot be decoded has no request id to answer, so it is dropped, but its credit is still
+ * returned.
+ */
+tempo_utils::Status
+chord_machine::GatewayPortSocket::handle(std::string_view message)
+{
+    if (m_deliver == nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "gateway port socket is not initialized");
+
+    chord_common::GatewayRequestFrame request;
+    auto status = chord_common::read_gateway_request(message, request);
+    if (status.notOk()) {
+        {
+            absl::MutexLock locker(&m_lock);
+            m_stats.requestsRejected++;
+        }
+        if (m_writer != nullptr) {
+            TU_RETURN_IF_NOT_OK (m_writer->grantCredit(1));
+        }
+        return status;
+    }
+
+    absl::MutexLock locker(&m_lock);
+
+    m_stats.requestsReceived++;
+
+    // the gateway sent more requests than it was granted credit for
+    if (m_unanswered.size() >= m_window) {
+        m_stats.requestsRejected++;
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "gateway port window is full");
+    }
+
+    // wake up the loop when the first request of a batch is queued
+    m_unanswered.push_back(request.requestId);
+    m_received.push_back(tempo_utils::MemoryBytes::copy(request.body));
+    if (m_received.size() == 1) {
+        uv_async_send(m_deliver);
+    }
+
+    return {};
+}
+
+void
+chord_machine::GatewayPortSocket::deliverReceived()
+{
+    std::vector<std::shared_ptr<const tempo_utils::MemoryBytes>> batch;
+    {
+        absl::MutexLock locker(&m_lock);
+        batch.swap(m_received);
+        m_stats.requestsDelivered += batch.size();
+    }
+
+    for (auto &bytes : batch) {
+        m_port->receive(std::move(bytes));
+    }
+}
+
+tempo_utils::Status
+chord_machine::GatewayPortSocket::detach()
+{
+    m_writer = nullptr;
+    m_writeQueue.detach();
+
+    // requests which were not answered are failed by the gateway when the stream ends
+    {
+        absl::MutexLock locker(&m_lock);
+        m_received.clear();
+        m_unanswered.clear();
+    }
+    return m_port->detach();
+}
+
+void
+chord_machine::GatewayPortSocket::writable(bool writable)
+{
+    m_writeQueue.writable(writable);
+}
+
+tempo_utils::Status
+chord_machine::GatewayPortSocket::write(std::shared_ptr<tempo_utils::ImmutableBytes> payload)
+{
+    return respond(std::string_view((const char *) payload->getData(), payload->getSize()));
+}
+
+/**
+ * Answer the oldest unanswered request with the specified body, and return its credit to the
+ * gateway.
+ */
+tempo_utils::Status
+chord_machine::GatewayPortSocket::respond(std::string_view body)
+{
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port is not available");
+
+    chord_common::GatewayResponseFrame response;
+    {
+        absl::MutexLock locker(&m_lock);
+        if (m_unanswered.empty()) {
+            m_stats.unsolicitedWrites++;
+            return tempo_utils::GenericStatus::forCondition(
+                tempo_utils::GenericCondition::kInternalViolation, "no gateway request is waiting for an answer");
+        }
+        response.requestId = m_unanswered.front();
+        m_unanswered.pop_front();
+        m_stats.responsesSent++;
+    }
+    response.statusCode = 200;
+    response.body = std::string(body);
+
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, chord_common::write_gateway_response(response));
+    // the credit is returned even if the response is rejected, the gateway times out the request
+    auto status = m_writeQueue.write(bytes);
+    TU_RETURN_IF_NOT_OK (m_writeQueue.grantCredit(1));
+    return status;
+}
+
+chord_machine::GatewayPortSocketStats
+chord_machine::GatewayPortSocket::getStats() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_stats;
+}
@@ -10,7 +10,7 @@ chord_machine::GrpcBinder::GrpcBinder(
         const lyric_common::RuntimePolicy &policy,
         const std::filesystem::path &pemPrivateKeyFile,
         const std::filesystem::path &pemRootCABundleFile,
-        chord_remoting::RemotingService::CallbackService *remotingService)
+        grpc::Service *remotingService)
     : m_endpoint(endpoint),
       m_policy(policy),
       m_pemPrivateKeyFile(pemPrivateKeyFile),
@@ -1,4 +1,6 @@
 
+#include <absl/strings/str_cat.h>
+
 #include <chord_machine/initialize_utils.h>
 #include <chord_machine/interpreter_runner.h>
 #include <chord_invoke/invoke_service.grpc.pb.h>
@@ -16,14 +18,11 @@
 #include "chord_machine/machine_result.h"
 
 tempo_utils::Status
-chord_machine::make_interpreter_state(
-    std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
-    const ComponentConstructor &componentConstructor,
+chord_machine::make_shared_loaders(
+    SharedLoaders &sharedLoaders,
     const ChordLocalMachineConfig &chordLocalMachineConfig)
 {
-    lyric_runtime::InterpreterStateOptions interpreterOptions;
-
-    auto systemLoader = std::make_shared<lyric_bootstrap::BootstrapLoader>();
+    sharedLoaders.systemLoader = std::make_shared<lyric_bootstrap::BootstrapLoader>();
 
     // create the list of package caches with the run cache in front
     std::vector<std::shared_ptr<zuri_distributor::AbstractReadonlyPackageCache>> packageCaches;
@@ -41,14 +40,46 @@ chord_machine::make_interpreter_state(
         packageCaches.push_back(packageCache);
     }
 
-    auto tieredCache = std::make_shared<zuri_distributor::TieredPackageCache>(packageCaches);
+    sharedLoaders.packageCache = std::make_shared<zuri_distributor::TieredPackageCache>(packageCaches);
+
+    // wrap the package cache loader so each module is loaded from disk at most once
+    AssemblyCacheOptions assemblyCacheOptions;
+    if (chordLocalMachineConfig.assemblyCacheSize > 0) {
+        assemblyCacheOptions.maxCachedBytes = chordLocalMachineConfig.assemblyCacheSize;
+    }
+
+    // if the agent shares an assembly store then map modules loaded by other machines from the store
+    std::shared_ptr<chord_common::AssemblyStore> assemblyStore;
+    if (!chordLocalMachineConfig.assemblyStoreDirectory.empty()) {
+        TU_ASSIGN_OR_RETURN (assemblyStore, chord_common::AssemblyStore::openOrCreate(
+            chordLocalMachineConfig.assemblyStoreDirectory));
+    }
+
+    auto packageCacheLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(sharedLoaders.packageCache);
+    auto packageCache = sharedLoaders.packageCache;
+    auto stamper = [packageCache](const zuri_packager::PackageSpecifier &specifier) {
+        return stamp_package(packageCache, specifier);
+    };
+    sharedLoaders.assemblyCache = std::make_shared<AssemblyCacheLoader>(
+        packageCacheLoader, assemblyCacheOptions, assemblyStore, stamper);
+    sharedLoaders.applicationLoader = sharedLoaders.assemblyCache;
+    return {};
+}
+
+tempo_utils::Status
+chord_machine::resolve_main_location(
+    lyric_common::ModuleLocation &mainLocation,
+    std::shared_ptr<zuri_distributor::TieredPackageCache> packageCache,
+    const zuri_packager::PackageSpecifier &mainPackage)
+{
+    TU_ASSERT (packageCache != nullptr);
 
     // resolve the package
     Option<std::filesystem::path> mainPackagePathOption;
-    TU_ASSIGN_OR_RETURN (mainPackagePathOption, tieredCache->resolvePackage(chordLocalMachineConfig.mainPackage));
+    TU_ASSIGN_OR_RETURN (mainPackagePathOption, packageCache->resolvePackage(mainPackage));
     if (mainPackagePathOption.isEmpty())
         return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
-            "package {} not found", chordLocalMachineConfig.mainPackage.toString());
+            "package {} not found", mainPackage.toString());
     auto mainPackagePath = mainPackagePathOption.getValue();
 
     // open the package
@@ -60,29 +91,108 @@ chord_machine::make_interpreter_state(
     TU_ASSIGN_OR_RETURN (mainSpecifier, reader->readPackageSpecifier());
     lyric_common::ModuleLocation programMain;
     TU_ASSIGN_OR_RETURN (programMain, reader->readProgramMain());
-    auto mainLocation = lyric_common::ModuleLocation::fromUrl(
+    mainLocation = lyric_common::ModuleLocation::fromUrl(
         mainSpecifier.toUrl()
             .resolve(programMain.getPath()));
-    interpreterOptions.mainLocation = mainLocation;
+    return {};
+}
+
+/**
+ * Returns the stamp of the archive of the specified package. The archive is identified by its
+ * path, size and modification time, so reinstalling a package with the same specifier changes
+ * the stamp.
+ */
+tempo_utils::Result<Option<std::string>>
+chord_machine::stamp_package(
+    std::shared_ptr<zuri_distributor::TieredPackageCache> packageCache,
+    const zuri_packager::PackageSpecifier &specifier)
+{
+    TU_ASSERT (packageCache != nullptr);
+
+    Option<std::filesystem::path> packagePathOption;
+    TU_ASSIGN_OR_RETURN (packagePathOption, packageCache->resolvePackage(specifier));
+    if (packagePathOption.isEmpty())
+        return Option<std::string>();
+    auto packagePath = packagePathOption.getValue();
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(packagePath, ec);
+    if (ec)
+        return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+            "failed to stat package {}: {}", packagePath.string(), ec.message());
+    auto mtime = std::filesystem::last_write_time(packagePath, ec);
+    if (ec)
+        return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+            "failed to stat package {}: {}", packagePath.string(), ec.message());
+
+    return Option<std::string>(absl::StrCat(packagePath.string(), ":", size, ":",
+        mtime.time_since_epoch().count()));
+}
 
-    auto applicationLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(tieredCache);
+tempo_utils::Status
+chord_machine::make_interpreter_state(
+    std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
+    const ComponentConstructor &componentConstructor,
+    const ChordLocalMachineConfig &chordLocalMachineConfig)
+{
+    SharedLoaders sharedLoaders;
+    TU_RETURN_IF_NOT_OK (make_shared_loaders(sharedLoaders, chordLocalMachineConfig));
+    return make_interpreter_state(interpreterState, componentConstructor, chordLocalMachineConfig, sharedLoaders);
+}
+
+tempo_utils::Status
+chord_machine::make_interpreter_state(
+    std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
+    const ComponentConstructor &componentConstructor,
+    const ChordLocalMachineConfig &chordLocalMachineConfig,
+    const SharedLoaders &sharedLoaders)
+{
+    lyric_runtime::InterpreterStateOptions interpreterOptions;
+    TU_RETURN_IF_NOT_OK (resolve_main_location(
+        interpreterOptions.mainLocation, sharedLoaders.packageCache, chordLocalMachineConfig.mainPackage));
 
     // construct the interpreter state
     interpreterState = componentConstructor.createInterpreterState(
-        systemLoader, applicationLoader, interpreterOptions);
+        sharedLoaders.systemLoader, sharedLoaders.applicationLoader, interpreterOptions);
     return {};
 }
 
+tempo_utils::Status
+chord_machine::make_machine_host(
+    std::shared_ptr<MachineHost> &machineHost,
+    const ChordLocalMachineConfig &chordLocalMachineConfig,
+    const SharedLoaders &sharedLoaders)
+{
+    MachineHostOptions options;
+    options.numWorkers = chordLocalMachineConfig.workerThreads;
+    options.runnerOptions.instructionBudget = chordLocalMachineConfig.instructionBudget;
+
+    machineHost = std::make_shared<MachineHost>(sharedLoaders, options);
+    return machineHost->initialize();
+}
+
 tempo_utils::Status
 chord_machine::make_local_machine(
     std::shared_ptr<LocalMachine> &localMachine,
     const ComponentConstructor &componentConstructor,
     const ChordLocalMachineConfig &chordLocalMachineConfig,
     std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
-    AbstractMessageSender<RunnerReply> *processor)
+    AbstractMessageSender<RunnerReply> *processor,
+    MachineHost *machineHost)
 {
+    // if the machine process is a host then the machine runs on the host worker pool
+    if (machineHost != nullptr) {
+        TU_ASSIGN_OR_RETURN (localMachine, machineHost->adoptMachine(chordLocalMachineConfig.machineName,
+            std::move(interpreterState), chordLocalMachineConfig.startSuspended, processor));
+        return {};
+    }
+
+    InterpreterRunnerOptions runnerOptions;
+    runnerOptions.instructionBudget = chordLocalMachineConfig.instructionBudget;
+
     localMachine = componentConstructor.createLocalMachine(
-        chordLocalMachineConfig.machineName, chordLocalMachineConfig.startSuspended, interpreterState, processor);
+        chordLocalMachineConfig.machineName, chordLocalMachineConfig.startSuspended, interpreterState,
+        processor, runnerOptions);
     return {};
 }
 
@@ -92,10 +202,11 @@ chord_machine::make_remoting_service(
     const ComponentConstructor &componentConstructor,
     const ChordLocalMachineConfig &chordLocalMachineConfig,
     std::shared_ptr<LocalMachine> localMachine,
-    uv_async_t *initComplete)
+    uv_async_t *initComplete,
+    MachineHost *machineHost)
 {
     remotingService = componentConstructor.createRemotingService(
-        chordLocalMachineConfig.startSuspended, localMachine, initComplete);
+        chordLocalMachineConfig.startSuspended, localMachine, initComplete, machineHost);
     return {};
 }
 
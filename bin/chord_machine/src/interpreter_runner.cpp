@@ -3,10 +3,14 @@
 
 chord_machine::InterpreterRunner::InterpreterRunner(
     std::unique_ptr<lyric_runtime::BytecodeInterpreter> interp,
-    AbstractMessageSender<RunnerReply> *outgoing)
+    AbstractMessageSender<RunnerReply> *outgoing,
+    std::unique_ptr<SafepointInspector> inspector)
     : m_interp(std::move(interp)),
       m_outgoing(outgoing),
+      m_inspector(std::move(inspector)),
       m_incoming(std::make_unique<AsyncQueue<RunnerRequest>>()),
+      m_initialized(false),
+      m_yielded(false),
       m_lock(std::make_unique<absl::Mutex>()),
       m_state(InterpreterRunnerState::INITIAL)
 {
@@ -15,10 +19,22 @@ chord_machine::InterpreterRunner::InterpreterRunner(
 }
 
 chord_machine::AbstractMessageSender<chord_machine::RunnerRequest> *
-chord_machine::InterpreterRunner::getIncomingSender() const
+chord_machine::InterpreterRunner::getIncomingSender()
 {
-    absl::MutexLock locker(m_lock.get());
-    return m_incoming.get();
+    return this;
+}
+
+void
+chord_machine::InterpreterRunner::sendMessage(RunnerRequest *message)
+{
+    auto type = message->type;
+    m_incoming->sendMessage(message);
+
+    // suspend and terminate interrupt the interpreter at the next safepoint. the request is
+    // enqueued first so it is waiting for the runner when the interpreter stops.
+    if (m_inspector != nullptr && type != RunnerRequest::MessageType::Resume) {
+        m_inspector->requestInterrupt();
+    }
 }
 
 chord_machine::InterpreterRunnerState
@@ -42,13 +58,34 @@ chord_machine::InterpreterRunner::getExit() const
     return m_exit;
 }
 
+chord_machine::SafepointStats
+chord_machine::InterpreterRunner::getSafepointStats() const
+{
+    absl::MutexLock locker(m_lock.get());
+    return m_safepointStats;
+}
+
+bool
+chord_machine::InterpreterRunner::hasPendingRequests()
+{
+    return m_incoming->messagesPending();
+}
+
 tempo_utils::Status
-chord_machine::InterpreterRunner::run()
+chord_machine::InterpreterRunner::initialize()
 {
+    if (m_initialized)
+        return {};
     auto *state = m_interp->interpreterState();
-    auto *loop = state->mainLoop();
+    TU_RETURN_IF_NOT_OK (m_incoming->initialize(state->mainLoop()));
+    m_initialized = true;
+    return {};
+}
 
-    TU_RETURN_IF_NOT_OK (m_incoming->initialize(loop));
+tempo_utils::Status
+chord_machine::InterpreterRunner::run()
+{
+    TU_RETURN_IF_NOT_OK (initialize());
 
     for (;;) {
 
@@ -57,32 +94,85 @@ chord_machine::InterpreterRunner::run()
         if (request == nullptr)
             continue;
 
-        switch (request->type) {
+        if (!handleRequest(request.get()))
+            return m_status;
+    }
+}
 
-            case RunnerRequest::MessageType::Resume: {
-                beforeRunInterpreter();
-                runInterpreter();
-                break;
-            }
+/**
+ * Handle the requests which are waiting for the runner, and return without blocking once there
+ * are none left. If the interpreter yields at a safepoint then the runner returns YIELDED and the
+ * interpreter continues from the safepoint the next time the runner runs. The runner must be
+ * initialized first, and it must not run on more than one thread at a time.
+ *
+ * @return The result of the slice.
+ */
+chord_machine::RunnerSliceResult
+chord_machine::InterpreterRunner::runAvailable()
+{
+    TU_ASSERT (m_initialized);
 
-            case RunnerRequest::MessageType::Suspend: {
-                suspendInterpreter();
-                break;
-            }
+    for (;;) {
+        std::unique_ptr<RunnerRequest> request(m_incoming->takeAvailableMessage());
+        if (request != nullptr) {
+            if (!handleRequest(request.get()))
+                return RunnerSliceResult::TERMINATED;
+        } else if (m_yielded) {
+            // no requests are waiting, so the interpreter continues from the safepoint
+            runInterpreter();
+        } else {
+            return RunnerSliceResult::IDLE;
+        }
 
-            case RunnerRequest::MessageType::Terminate: {
-                shutdownInterpreter();
-                return m_status;
+        if (m_yielded)
+            return RunnerSliceResult::YIELDED;
+    }
+}
+
+/**
+ * Handle the request. Returns false if the request terminated the runner.
+ */
+bool
+chord_machine::InterpreterRunner::handleRequest(const RunnerRequest *request)
+{
+    switch (request->type) {
+
+        case RunnerRequest::MessageType::Resume: {
+            // interrupts requested while the interpreter was stopped belong to requests which
+            // are either handled already or still pending. the interrupt is cleared before
+            // checking for pending requests, because a request is enqueued before it requests
+            // an interrupt; a request which arrives after the check therefore leaves its
+            // interrupt set, and the interpreter stops at the next safepoint.
+            if (m_inspector != nullptr) {
+                m_inspector->clearInterrupt();
             }
+            // handle any waiting requests before running the interpreter again, so running
+            // is only reported if the interpreter actually runs
+            if (m_incoming->messagesPending())
+                return true;
+            if (!beforeRunInterpreter())
+                return true;
+            runInterpreter();
+            return true;
+        }
 
-            default:
-                TU_LOG_WARN << "ignoring unknown message " << request.get();
-                break;
+        case RunnerRequest::MessageType::Suspend: {
+            suspendInterpreter();
+            return true;
         }
+
+        case RunnerRequest::MessageType::Terminate: {
+            shutdownInterpreter();
+            return false;
+        }
+
+        default:
+            TU_LOG_WARN << "ignoring unknown message " << request->toString();
+            return true;
     }
 }
 
-void
+bool
 chord_machine::InterpreterRunner::beforeRunInterpreter()
 {
     TU_LOG_V << "beforeRunInterpreter";
@@ -100,11 +190,11 @@ chord_machine::InterpreterRunner::beforeRunInterpreter()
 
         case InterpreterRunnerState::SHUTDOWN:
             m_outgoing->sendMessage(new RunnerCompleted(m_exit.statusCode));
-            return;
+            return false;
 
         case InterpreterRunnerState::FAILED:
             m_outgoing->sendMessage(new RunnerFailure(m_status));
-            return;
+            return false;
 
         default:
             m_outgoing->sendMessage(new RunnerFailure(
@@ -112,10 +202,11 @@ chord_machine::InterpreterRunner::beforeRunInterpreter()
                     lyric_runtime::InterpreterCondition::kRuntimeInvariant,
                     "failed to run interpreter: unexpected interpreter state")));
             m_state = InterpreterRunnerState::FAILED;
-            return;
+            return false;
     }
 
     m_state = InterpreterRunnerState::RUNNING;
+    return true;
 }
 
 void
@@ -123,13 +214,32 @@ chord_machine::InterpreterRunner::runInterpreter()
 {
     TU_LOG_V << "runInterpreter";
 
+    m_yielded = false;
     auto runInterpResult = m_interp->run();
 
     absl::MutexLock locker(m_lock.get());
 
+    bool interruptedAtSafepoint = false;
+    bool yieldedAtSafepoint = false;
+    if (m_inspector != nullptr) {
+        interruptedAtSafepoint = m_inspector->takeInterrupted();
+        yieldedAtSafepoint = m_inspector->takeYielded();
+        m_safepointStats = m_inspector->getStats();
+    }
+
     if (runInterpResult.isStatus()) {
         m_status = runInterpResult.getStatus();
-        if (m_status.matchesCondition(lyric_runtime::InterpreterCondition::kInterrupted)) {
+        if (interruptedAtSafepoint) {
+            // the pending request which interrupted the interpreter determines the reply
+            TU_LOG_V << "interpreter stopped at safepoint";
+            m_status = {};
+            m_state = InterpreterRunnerState::STOPPED;
+        } else if (yieldedAtSafepoint) {
+            // the interpreter is still running, it continues when the runner runs again
+            TU_LOG_V << "interpreter yielded at safepoint";
+            m_status = {};
+            m_yielded = true;
+        } else if (m_status.matchesCondition(lyric_runtime::InterpreterCondition::kInterrupted)) {
             TU_LOG_V << "interpreter suspended";
             m_outgoing->sendMessage(new RunnerSuspended());
             m_state = InterpreterRunnerState::STOPPED;
@@ -153,6 +263,7 @@ chord_machine::InterpreterRunner::suspendInterpreter()
     TU_LOG_V << "suspendInterpreter";
 
     absl::MutexLock locker(m_lock.get());
+    m_yielded = false;
 
     switch (m_state) {
         case InterpreterRunnerState::INITIAL:
@@ -183,6 +294,7 @@ chord_machine::InterpreterRunner::shutdownInterpreter()
     TU_LOG_V << "shutdownInterpreter";
 
     absl::MutexLock locker(m_lock.get());
+    m_yielded = false;
 
     switch (m_state) {
         case InterpreterRunnerState::INITIAL:
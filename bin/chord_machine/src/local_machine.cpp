@@ -1,40 +1,72 @@
-
 #include <chord_machine/local_machine.h>
 
-static void runner_thread(void *data)
+void
+chord_machine::run_local_machine_thread(void *data)
 {
-    auto *runner = static_cast<chord_machine::InterpreterRunner *>(data);
-    TU_ASSERT (runner != nullptr);
-    auto status = runner->run();
+    auto *machine = static_cast<chord_machine::LocalMachine *>(data);
+    TU_ASSERT (machine != nullptr);
+    auto status = machine->m_runner->run();
     if (status.notOk()) {
         TU_LOG_ERROR << "local machine failed";
     } else {
         TU_LOG_V << "local machine completed";
     }
+    machine->finishRunner();
 }
 
 chord_machine::LocalMachine::LocalMachine(
     const std::string &machineName,
     bool startSuspended,
     std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
-    AbstractMessageSender<RunnerReply> *processor)
+    AbstractMessageSender<RunnerReply> *processor,
+    const InterpreterRunnerOptions &runnerOptions,
+    RunnerWorkerPool *workerPool)
     : m_machineName(machineName),
-      m_startSuspended(startSuspended)
+      m_startSuspended(startSuspended),
+      m_workerPool(workerPool),
+      m_scheduled(false),
+      m_finished(false)
 {
     TU_ASSERT (!m_machineName.empty());
     TU_ASSERT (interpreterState != nullptr);
     TU_ASSERT (processor != nullptr);
 
-    auto interp = std::make_unique<lyric_runtime::BytecodeInterpreter>(interpreterState, nullptr);
-    m_runner = std::make_unique<InterpreterRunner>(std::move(interp), processor);
+    // if an instruction budget is specified then the interpreter yields at safepoints. a runner
+    // on a worker pool also yields whenever another runner is waiting for a worker
+    std::unique_ptr<SafepointInspector> inspector;
+    if (runnerOptions.instructionBudget > 0) {
+        absl::AnyInvocable<bool()> shouldYield;
+        if (m_workerPool != nullptr) {
+            shouldYield = [workerPool = m_workerPool] { return workerPool->numQueued() > 0; };
+        }
+        inspector = std::make_unique<SafepointInspector>(runnerOptions.instructionBudget, std::move(shouldYield));
+    }
+
+    auto interp = std::make_unique<lyric_runtime::BytecodeInterpreter>(interpreterState, inspector.get());
+    m_runner = std::make_unique<InterpreterRunner>(std::move(interp), processor, std::move(inspector));
     m_commandQueue = m_runner->getIncomingSender();
-    uv_thread_create(&m_tid, runner_thread, m_runner.get());
+
+    // if there is no worker pool then the runner gets a dedicated thread
+    if (m_workerPool == nullptr) {
+        uv_thread_create(&m_tid, run_local_machine_thread, this);
+        return;
+    }
+
+    // otherwise the runner is scheduled on the pool when it receives a request
+    auto status = m_runner->initialize();
+    if (status.notOk()) {
+        TU_LOG_ERROR << "failed to initialize runner for " << m_machineName << ": " << status;
+        finishRunner();
+    }
 }
 
 chord_machine::LocalMachine::~LocalMachine()
 {
     terminate();
-    uv_thread_join(&m_tid);
+    m_runnerDone.WaitForNotification();
+    if (m_workerPool == nullptr) {
+        uv_thread_join(&m_tid);
+    }
 }
 
 std::string
@@ -43,12 +75,27 @@ chord_machine::LocalMachine::getMachineName() const
     return m_machineName;
 }
 
+/**
+ * Returns true if the runner has terminated.
+ */
+bool
+chord_machine::LocalMachine::isFinished() const
+{
+    return m_runnerDone.HasBeenNotified();
+}
+
 chord_machine::InterpreterRunnerState
 chord_machine::LocalMachine::getRunnerState() const
 {
     return m_runner->getState();
 }
 
+chord_machine::SafepointStats
+chord_machine::LocalMachine::getSafepointStats() const
+{
+    return m_runner->getSafepointStats();
+}
+
 tempo_utils::Status
 chord_machine::LocalMachine::notifyInitComplete()
 {
@@ -61,20 +108,95 @@ chord_machine::LocalMachine::notifyInitComplete()
 tempo_utils::Status
 chord_machine::LocalMachine::suspend()
 {
-    m_commandQueue->sendMessage(new SuspendRunner());
+    sendRequest(new SuspendRunner());
     return {};
 }
 
 tempo_utils::Status
 chord_machine::LocalMachine::resume()
 {
-    m_commandQueue->sendMessage(new ResumeRunner());
+    sendRequest(new ResumeRunner());
     return {};
 }
 
 tempo_utils::Status
 chord_machine::LocalMachine::terminate()
 {
-    m_commandQueue->sendMessage(new TerminateRunner());
+    sendRequest(new TerminateRunner());
     return {};
-}
\ No newline at end of file
+}
+
+void
+chord_machine::LocalMachine::sendRequest(RunnerRequest *request)
+{
+    m_commandQueue->sendMessage(request);
+    if (m_workerPool != nullptr) {
+        scheduleRunner();
+    }
+}
+
+/**
+ * Submit a slice of the runner to the worker pool, unless a slice is already scheduled. A slice
+ * which is already scheduled checks for requests when it finishes, so no request is missed.
+ */
+void
+chord_machine::LocalMachine::scheduleRunner()
+{
+    {
+        absl::MutexLock locker(&m_lock);
+        if (m_scheduled || m_finished)
+            return;
+        m_scheduled = true;
+    }
+    submitSlice();
+}
+
+void
+chord_machine::LocalMachine::submitSlice()
+{
+    auto status = m_workerPool->submit([this] { runSlice(); });
+    if (status.notOk()) {
+        TU_LOG_ERROR << "failed to schedule runner for " << m_machineName << ": " << status;
+        finishRunner();
+    }
+}
+
+void
+chord_machine::LocalMachine::runSlice()
+{
+    auto result = m_runner->runAvailable();
+
+    if (result == RunnerSliceResult::TERMINATED) {
+        TU_LOG_V << "local machine " << m_machineName << " completed";
+        finishRunner();
+        return;
+    }
+
+    // a runner which yielded goes to the back of the queue, and an idle runner gives up its
+    // worker unless a request arrived while the slice was finishing. the runner stays scheduled
+    // until the next slice is submitted, so the machine cannot finish in between
+    {
+        absl::MutexLock locker(&m_lock);
+        if (result != RunnerSliceResult::YIELDED && !m_runner->hasPendingRequests()) {
+            m_scheduled = false;
+            return;
+        }
+    }
+    submitSlice();
+}
+
+/**
+ * Mark the runner as terminated. The machine may be destroyed as soon as this returns.
+ */
+void
+chord_machine::LocalMachine::finishRunner()
+{
+    {
+        absl::MutexLock locker(&m_lock);
+        m_scheduled = false;
+        if (m_finished)
+            return;
+        m_finished = true;
+    }
+    m_runnerDone.Notify();
+}
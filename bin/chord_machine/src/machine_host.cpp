@@ -0,0 +1,269 @@
+
+#include <chord_machine/initialize_utils.h>
+#include <chord_machine/machine_host.h>
+#include <chord_machine/machine_result.h>
+#include <chord_machine/port_socket.h>
+#include <tempo_utils/log_stream.h>
+
+void
+chord_machine::HostedReplyLogger::sendMessage(RunnerReply *message)
+{
+    TU_ASSERT (message != nullptr);
+    TU_LOG_V << "hosted machine runner replied " << message->toString();
+    delete message;
+}
+
+chord_machine::MachineHost::MachineHost(const SharedLoaders &loaders, const MachineHostOptions &options)
+    : m_loaders(loaders),
+      m_options(options),
+      m_workerPool(options.numWorkers)
+{
+    TU_ASSERT (m_loaders.systemLoader != nullptr);
+    TU_ASSERT (m_loaders.packageCache != nullptr);
+    TU_ASSERT (m_loaders.applicationLoader != nullptr);
+    if (m_options.runnerOptions.instructionBudget == 0) {
+        m_options.runnerOptions.instructionBudget = kDefaultHostedInstructionBudget;
+    }
+}
+
+chord_machine::MachineHost::~MachineHost()
+{
+    auto status = shutdown();
+    TU_LOG_WARN_IF (status.notOk()) << "failed to shut down machine host: " << status;
+}
+
+tempo_utils::Status
+chord_machine::MachineHost::initialize()
+{
+    return m_workerPool.initialize();
+}
+
+/**
+ * Create a machine running the program in the main package. The machine gets its own interpreter
+ * state, so hosted machines do not share a heap. A port is registered in the interpreter for each
+ * expected port, and the socket for the port delivers inbound messages on the loop of the
+ * interpreter, so messages reach the program while it runs on a worker.
+ *
+ * @param machineName The name of the machine, which must be unique within the host.
+ * @param mainPackage The package containing the program main.
+ * @param expectedPorts The protocols of the ports the program communicates over.
+ * @param startSuspended If true then the machine is not started until it is resumed.
+ * @return The machine.
+ */
+tempo_utils::Result<std::shared_ptr<chord_machine::LocalMachine>>
+chord_machine::MachineHost::createMachine(
+    const std::string &machineName,
+    const zuri_packager::PackageSpecifier &mainPackage,
+    const absl::flat_hash_set<tempo_utils::Url> &expectedPorts,
+    bool startSuspended)
+{
+    // release machines which have finished before placing another
+    reapMachines();
+
+    if (hasMachine(machineName))
+        return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+            "machine {} is already hosted", machineName);
+
+    lyric_runtime::InterpreterStateOptions interpreterOptions;
+    TU_RETURN_IF_NOT_OK (resolve_main_location(
+        interpreterOptions.mainLocation, m_loaders.packageCache, mainPackage));
+
+    std::shared_ptr<lyric_runtime::InterpreterState> interpreterState;
+    TU_ASSIGN_OR_RETURN (interpreterState, lyric_runtime::InterpreterState::create(
+        m_loaders.systemLoader, m_loaders.applicationLoader, interpreterOptions));
+
+    auto hosted = std::make_shared<HostedMachine>();
+    auto *multiplexer = interpreterState->portMultiplexer();
+    for (const auto &expectedPort : expectedPorts) {
+        std::shared_ptr<lyric_runtime::DuplexPort> duplexPort;
+        TU_ASSIGN_OR_RETURN (duplexPort, multiplexer->registerPort(expectedPort));
+        auto socket = std::make_shared<PortSocket>(duplexPort, interpreterState->mainLoop());
+        TU_RETURN_IF_NOT_OK (socket->initialize());
+        hosted->handlers[expectedPort] = std::move(socket);
+        hosted->requiredAtLaunch.insert(expectedPort);
+    }
+
+    absl::MutexLock locker(&m_lock);
+
+    if (m_machines.contains(machineName))
+        return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+            "machine {} is already hosted", machineName);
+
+    hosted->machine = std::make_shared<LocalMachine>(machineName, startSuspended,
+        std::move(interpreterState), &m_replies, m_options.runnerOptions, &m_workerPool);
+    m_machines[machineName] = hosted;
+
+    // a machine without ports starts now, otherwise it starts once every port is attached
+    if (hosted->requiredAtLaunch.empty()) {
+        hosted->machine->notifyInitComplete();
+    }
+
+    TU_LOG_V << "created hosted machine " << machineName << " (" << (int) m_machines.size() << " hosted)";
+    return hosted->machine;
+}
+
+/**
+ * Host a machine for an interpreter state which was created by the caller. The ports of the
+ * machine and the replies of its runner are handled by the caller.
+ */
+tempo_utils::Result<std::shared_ptr<chord_machine::LocalMachine>>
+chord_machine::MachineHost::adoptMachine(
+    const std::string &machineName,
+    std::shared_ptr<lyric_runtime::InterpreterState> interpreterState,
+    bool startSuspended,
+    AbstractMessageSender<RunnerReply> *processor)
+{
+    TU_ASSERT (interpreterState != nullptr);
+    TU_ASSERT (processor != nullptr);
+
+    absl::MutexLock locker(&m_lock);
+
+    if (m_machines.contains(machineName))
+        return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+            "machine {} is already hosted", machineName);
+
+    auto hosted = std::make_shared<HostedMachine>();
+    hosted->machine = std::make_shared<LocalMachine>(machineName, startSuspended,
+        std::move(interpreterState), processor, m_options.runnerOptions, &m_workerPool);
+    m_machines[machineName] = hosted;
+
+    TU_LOG_V << "hosting machine " << machineName << " (" << (int) m_machines.size() << " hosted)";
+    return hosted->machine;
+}
+
+bool
+chord_machine::MachineHost::hasMachine(std::string_view machineName) const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_machines.contains(machineName);
+}
+
+std::shared_ptr<chord_machine::LocalMachine>
+chord_machine::MachineHost::getMachine(std::string_view machineName) const
+{
+    absl::MutexLock locker(&m_lock);
+    auto entry = m_machines.find(machineName);
+    if (entry == m_machines.cend())
+        return {};
+    return entry->second->machine;
+}
+
+std::shared_ptr<chord_common::AbstractProtocolHandler>
+chord_machine::MachineHost::getProtocolHandler(
+    std::string_view machineName,
+    const tempo_utils::Url &protocolUrl) const
+{
+    absl::MutexLock locker(&m_lock);
+    auto entry = m_machines.find(machineName);
+    if (entry == m_machines.cend())
+        return {};
+    const auto &handlers = entry->second->handlers;
+    auto handler = handlers.find(protocolUrl);
+    if (handler == handlers.cend())
+        return {};
+    return handler->second;
+}
+
+/**
+ * Notify the host that a Communicate stream is attached to the port of a hosted machine. Once
+ * every expected port of the machine is attached the machine is started.
+ */
+tempo_utils::Status
+chord_machine::MachineHost::notifyProtocolAttached(
+    std::string_view machineName,
+    const tempo_utils::Url &protocolUrl)
+{
+    std::shared_ptr<LocalMachine> machine;
+    {
+        absl::MutexLock locker(&m_lock);
+        auto entry = m_machines.find(machineName);
+        if (entry == m_machines.cend())
+            return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+                "machine {} is not hosted", machineName);
+        auto &requiredAtLaunch = entry->second->requiredAtLaunch;
+        if (!requiredAtLaunch.erase(protocolUrl) || !requiredAtLaunch.empty())
+            return {};
+        machine = entry->second->machine;
+    }
+    return machine->notifyInitComplete();
+}
+
+tempo_utils::Status
+chord_machine::MachineHost::removeMachine(std::string_view machineName)
+{
+    std::shared_ptr<HostedMachine> hosted;
+    {
+        absl::MutexLock locker(&m_lock);
+        auto entry = m_machines.find(machineName);
+        if (entry == m_machines.cend())
+            return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+                "machine {} is not hosted", machineName);
+        hosted = std::move(entry->second);
+        m_machines.erase(entry);
+    }
+    // the machine is released outside the lock because its destructor waits for the runner
+    return hosted->machine->terminate();
+}
+
+/**
+ * Release the machines whose runners have terminated.
+ *
+ * @return The number of machines released.
+ */
+int
+chord_machine::MachineHost::reapMachines()
+{
+    std::vector<std::shared_ptr<HostedMachine>> finished;
+    {
+        absl::MutexLock locker(&m_lock);
+        for (auto iterator = m_machines.begin(); iterator != m_machines.end();) {
+            if (iterator->second->machine->isFinished()) {
+                TU_LOG_V << "releasing finished machine " << iterator->first;
+                finished.push_back(std::move(iterator->second));
+                m_machines.erase(iterator++);
+            } else {
+                ++iterator;
+            }
+        }
+    }
+    return finished.size();
+}
+
+int
+chord_machine::MachineHost::numMachines() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_machines.size();
+}
+
+const chord_machine::SharedLoaders &
+chord_machine::MachineHost::getLoaders() const
+{
+    return m_loaders;
+}
+
+chord_machine::RunnerWorkerPool *
+chord_machine::MachineHost::getWorkerPool()
+{
+    return &m_workerPool;
+}
+
+tempo_utils::Status
+chord_machine::MachineHost::shutdown()
+{
+    absl::flat_hash_map<std::string,std::shared_ptr<HostedMachine>> machines;
+    {
+        absl::MutexLock locker(&m_lock);
+        machines = std::move(m_machines);
+        m_machines.clear();
+    }
+
+    // terminate every machine and wait for the runners to finish before stopping the workers
+    for (auto &entry : machines) {
+        auto status = entry.second->machine->terminate();
+        TU_LOG_WARN_IF (status.notOk()) << "failed to terminate machine " << entry.first << ": " << status;
+    }
+    machines.clear();
+
+    return m_workerPool.shutdown();
+}
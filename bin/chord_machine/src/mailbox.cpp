@@ -0,0 +1,87 @@
+
+#include <thread>
+
+#include <chord_machine/mailbox.h>
+
+chord_machine::Mailbox::Mailbox()
+    : m_head(&m_stub),
+      m_tail(&m_stub),
+      m_size(0)
+{
+}
+
+void
+chord_machine::Mailbox::link(AbstractMessage *message)
+{
+    message->link.next.store(nullptr, std::memory_order_relaxed);
+    auto *prev = m_head.exchange(message, std::memory_order_acq_rel);
+    // the message is unreachable by the consumer until the previous head is linked to it
+    prev->link.next.store(message, std::memory_order_release);
+}
+
+bool
+chord_machine::Mailbox::push(AbstractMessage *message)
+{
+    // the size is incremented before the message is linked, so a nonzero size guarantees pop
+    // will find a message once the producer finishes linking
+    auto prevSize = m_size.fetch_add(1);
+    link(message);
+    return prevSize == 0;
+}
+
+chord_machine::AbstractMessage *
+chord_machine::Mailbox::pop()
+{
+    if (m_size.load() == 0)
+        return nullptr;
+
+    for (;;) {
+        auto *tail = m_tail;
+        auto *next = tail->link.next.load(std::memory_order_acquire);
+
+        // skip over the stub
+        if (tail == &m_stub) {
+            if (next == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->link.next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            m_tail = next;
+            m_size.fetch_sub(1);
+            return tail;
+        }
+
+        // a producer has swapped in a new head but has not linked it yet
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // tail is the last message, so link the stub behind it before detaching it
+        link(&m_stub);
+        next = tail->link.next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            m_tail = next;
+            m_size.fetch_sub(1);
+            return tail;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool
+chord_machine::Mailbox::isEmpty() const
+{
+    return m_size.load() == 0;
+}
+
+tu_uint32
+chord_machine::Mailbox::size() const
+{
+    return m_size.load();
+}
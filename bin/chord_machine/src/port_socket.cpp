@@ -2,11 +2,54 @@
 #include <chord_machine/port_socket.h>
 #include <tempo_utils/memory_bytes.h>
 
-chord_machine::PortSocket::PortSocket(std::shared_ptr<lyric_runtime::DuplexPort> port)
+chord_machine::PortSocket::PortSocket(
+    std::shared_ptr<lyric_runtime::DuplexPort> port,
+    uv_loop_t *loop,
+    tu_uint32 receiveQueueSize)
     : m_port(port),
+      m_loop(loop),
+      m_receiveQueueSize(receiveQueueSize),
+      m_deliver(nullptr),
       m_writer(nullptr)
 {
     TU_ASSERT (m_port != nullptr);
+    TU_ASSERT (m_loop != nullptr);
+    TU_ASSERT (m_receiveQueueSize > 0);
+}
+
+chord_machine::PortSocket::~PortSocket()
+{
+    if (m_deliver != nullptr) {
+        uv_close((uv_handle_t *) m_deliver, [](uv_handle_t *handle) {
+            delete (uv_async_t *) handle;
+        });
+    }
+}
+
+void
+chord_machine::on_port_deliver(uv_async_t *async)
+{
+    auto *socket = (PortSocket *) async->data;
+    socket->deliverReceived();
+}
+
+tempo_utils::Status
+chord_machine::PortSocket::initialize()
+{
+    if (m_deliver != nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port socket is already initialized");
+
+    auto *deliver = new uv_async_t;
+    auto ret = uv_async_init(m_loop, deliver, on_port_deliver);
+    if (ret < 0) {
+        delete deliver;
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "failed to initialize async: {}", uv_strerror(ret));
+    }
+    deliver->data = this;
+    m_deliver = deliver;
+    return {};
 }
 
 bool
@@ -19,11 +62,19 @@ tempo_utils::Status
 chord_machine::PortSocket::attach(chord_common::AbstractProtocolWriter *writer)
 {
     m_writer = writer;
+    m_writeQueue.attach(writer);
     auto status = m_port->attach(this);
     if (status.notOk())
         return tempo_utils::GenericStatus::forCondition(
             tempo_utils::GenericCondition::kInternalViolation, status.getMessage());
-    return tempo_utils::GenericStatus::ok();
+
+    // grant the remote end credit for the free slots in the receive queue
+    tu_uint32 credit;
+    {
+        absl::MutexLock locker(&m_lock);
+        credit = m_receiveQueueSize - m_received.size();
+    }
+    return m_writer->grantCredit(credit);
 }
 
 tempo_utils::Status
@@ -32,33 +83,99 @@ chord_machine::PortSocket::send(std::string_view message)
     if (m_writer == nullptr)
         return tempo_utils::GenericStatus::forCondition(
             tempo_utils::GenericCondition::kInternalViolation, "port is not available");
-    TU_LOG_INFO << "port " << m_port->getUrl() << " sends message: " << std::string(message);
-    return m_writer->write(message);
+    {
+        absl::MutexLock locker(&m_lock);
+        m_stats.messagesSent++;
+        m_stats.bytesSent += message.size();
+    }
+    return m_writeQueue.write(tempo_utils::MemoryBytes::copy(message));
 }
 
 tempo_utils::Status
 chord_machine::PortSocket::handle(std::string_view message)
 {
-    auto bytes = tempo_utils::MemoryBytes::copy(message);
-    TU_LOG_INFO << "port " << m_port->getUrl() << " received message (" << bytes->getSize() << " bytes)";
-    TU_LOG_FATAL << "aborting"; // TODO: FIXME!
-    m_port->receive(bytes);
-    return tempo_utils::GenericStatus::ok();
+    if (m_deliver == nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port socket is not initialized");
+
+    absl::MutexLock locker(&m_lock);
+
+    m_stats.messagesReceived++;
+    m_stats.bytesReceived += message.size();
+
+    // the remote end sent more messages than it was granted credit for
+    if (m_received.size() >= m_receiveQueueSize) {
+        m_stats.messagesDropped++;
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port receive queue is full");
+    }
+
+    // wake up the loop when the first message of a batch is queued
+    m_received.push_back(tempo_utils::MemoryBytes::copy(message));
+    if (m_received.size() == 1) {
+        uv_async_send(m_deliver);
+    }
+
+    return {};
+}
+
+void
+chord_machine::PortSocket::deliverReceived()
+{
+    std::vector<std::shared_ptr<const tempo_utils::MemoryBytes>> batch;
+    {
+        absl::MutexLock locker(&m_lock);
+        batch.swap(m_received);
+        if (!batch.empty()) {
+            m_stats.messagesDelivered += batch.size();
+            m_stats.batchesDelivered++;
+        }
+    }
+    if (batch.empty())
+        return;
+
+    for (auto &bytes : batch) {
+        m_port->receive(std::move(bytes));
+    }
+
+    // return the credit for the delivered messages
+    if (m_writer != nullptr) {
+        auto status = m_writer->grantCredit(batch.size());
+        TU_LOG_WARN_IF (status.notOk()) << "failed to grant credit for port " << m_port->getUrl() << ": " << status;
+    }
 }
 
 tempo_utils::Status
 chord_machine::PortSocket::detach()
 {
     m_writer = nullptr;
+    m_writeQueue.detach();
     return m_port->detach();
 }
 
+void
+chord_machine::PortSocket::writable(bool writable)
+{
+    m_writeQueue.writable(writable);
+}
+
 tempo_utils::Status
 chord_machine::PortSocket::write(std::shared_ptr<tempo_utils::ImmutableBytes> payload)
 {
     if (m_writer == nullptr)
         return tempo_utils::GenericStatus::forCondition(
             tempo_utils::GenericCondition::kInternalViolation, "port is not available");
-    std::string_view message((const char *) payload->getData(), payload->getSize());
-    return m_writer->write(message);
-}
\ No newline at end of file
+    {
+        absl::MutexLock locker(&m_lock);
+        m_stats.messagesSent++;
+        m_stats.bytesSent += payload->getSize();
+    }
+    return m_writeQueue.write(std::shared_ptr<const tempo_utils::ImmutableBytes>(std::move(payload)));
+}
+
+chord_machine::PortSocketStats
+chord_machine::PortSocket::getStats() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_stats;
+}
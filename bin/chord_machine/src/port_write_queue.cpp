@@ -0,0 +1,156 @@
+
+#include <chord_machine/machine_result.h>
+#include <chord_machine/port_write_queue.h>
+#include <tempo_utils/log_stream.h>
+
+chord_machine::PortWriteQueue::PortWriteQueue(tu_uint32 maxParkedBytes)
+    : m_maxParkedBytes(maxParkedBytes),
+      m_writer(nullptr),
+      m_writable(true),
+      m_parkedBytes(0)
+{
+}
+
+void
+chord_machine::PortWriteQueue::attach(chord_common::AbstractProtocolWriter *writer)
+{
+    TU_ASSERT (writer != nullptr);
+    absl::MutexLock locker(&m_lock);
+    m_writer = writer;
+    m_writable = true;
+}
+
+/**
+ * Detach the writer. Parked messages are discarded, because they belong to the stream which has
+ * ended.
+ */
+void
+chord_machine::PortWriteQueue::detach()
+{
+    absl::MutexLock locker(&m_lock);
+    m_writer = nullptr;
+    m_parked.clear();
+    m_parkedBytes = 0;
+}
+
+bool
+chord_machine::PortWriteQueue::isAttached() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_writer != nullptr;
+}
+
+/**
+ * Write the payload, or park it if the writer is congested or earlier messages are still parked,
+ * so messages are always written in order.
+ *
+ * @param payload The message payload.
+ * @return Ok status if the payload was written or parked, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_machine::PortWriteQueue::write(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+{
+    absl::MutexLock locker(&m_lock);
+
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port is not available");
+
+    if (!m_writable || !m_parked.empty())
+        return park(std::move(payload));
+
+    auto status = m_writer->write(payload);
+    if (is_write_congested(status)) {
+        m_writable = false;
+        return park(std::move(payload));
+    }
+    return status;
+}
+
+/**
+ * Pass the credit grant to the writer. Credit grants are never parked, the writer does not apply
+ * backpressure to them.
+ */
+tempo_utils::Status
+chord_machine::PortWriteQueue::grantCredit(tu_uint32 credit)
+{
+    absl::MutexLock locker(&m_lock);
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "port is not available");
+    return m_writer->grantCredit(credit);
+}
+
+/**
+ * Write the parked messages in order when the writer becomes writable, until the writer is
+ * congested again. The queue starts parking when a write fails rather than when the writer
+ * notifies that it is not writable; the notification is made from within a write made by this
+ * queue, and may arrive after the writer has already drained.
+ *
+ * @param writable true if the writer is writable, otherwise false.
+ */
+void
+chord_machine::PortWriteQueue::writable(bool writable)
+{
+    if (!writable)
+        return;
+
+    absl::MutexLock locker(&m_lock);
+    m_writable = true;
+    if (m_writer == nullptr)
+        return;
+
+    while (!m_parked.empty()) {
+        auto &payload = m_parked.front();
+        auto status = m_writer->write(payload);
+        if (is_write_congested(status)) {
+            m_writable = false;
+            return;
+        }
+        TU_LOG_WARN_IF (status.notOk()) << "failed to write parked message: " << status;
+        m_parkedBytes -= payload->getSize();
+        m_parked.pop_front();
+        m_stats.messagesResumed++;
+    }
+}
+
+tu_uint32
+chord_machine::PortWriteQueue::getParkedBytes() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_parkedBytes;
+}
+
+chord_machine::PortWriteQueueStats
+chord_machine::PortWriteQueue::getStats() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_stats;
+}
+
+tempo_utils::Status
+chord_machine::PortWriteQueue::park(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+{
+    if (m_parkedBytes + payload->getSize() > m_maxParkedBytes) {
+        m_stats.messagesRejected++;
+        return MachineStatus::forCondition(MachineCondition::kWriteCongested,
+            "port write queue is full ({} bytes parked)", m_parkedBytes);
+    }
+    m_parkedBytes += payload->getSize();
+    m_parked.push_back(std::move(payload));
+    m_stats.messagesParked++;
+    return {};
+}
+
+/**
+ * Returns true if the status is a write which failed because the writer is congested. The write
+ * can be made again once the writer notifies that it is writable.
+ */
+bool
+chord_machine::is_write_congested(const tempo_utils::Status &status)
+{
+    MachineStatus machineStatus;
+    if (!status.convertTo(machineStatus))
+        return false;
+    return machineStatus.getCondition() == MachineCondition::kWriteCongested;
+}
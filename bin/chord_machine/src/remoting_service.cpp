@@ -1,19 +1,28 @@
 
+#include <absl/strings/str_cat.h>
+#include <grpcpp/support/proto_buffer_reader.h>
+
+#include <chord_machine/machine_result.h>
 #include <chord_machine/remoting_service.h>
 #include <tempo_utils/log_stream.h>
+#include <tempo_utils/memory_bytes.h>
 #include <tempo_utils/url.h>
+#include <zuri_packager/package_specifier.h>
 
 chord_machine::RemotingService::RemotingService()
-    : m_initComplete(nullptr)
+    : m_initComplete(nullptr),
+      m_machineHost(nullptr)
 {
 }
 
 chord_machine::RemotingService::RemotingService(
     bool startSuspended,
     std::shared_ptr<LocalMachine> localMachine,
-    uv_async_t *initComplete)
+    uv_async_t *initComplete,
+    MachineHost *machineHost)
     : m_localMachine(localMachine),
-      m_initComplete(initComplete)
+      m_initComplete(initComplete),
+      m_machineHost(machineHost)
 {
     TU_ASSERT (m_localMachine != nullptr);
     TU_ASSERT (m_initComplete != nullptr);
@@ -28,7 +37,15 @@ chord_machine::RemotingService::SuspendMachine(
 {
     auto *reactor = context->DefaultReactor();
 
-    auto status = m_localMachine->suspend();
+    auto resolveMachineResult = resolveMachine(context);
+    if (resolveMachineResult.isStatus()) {
+        auto status = resolveMachineResult.getStatus();
+        reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, std::string(status.getMessage())));
+        return reactor;
+    }
+    auto machine = resolveMachineResult.getResult();
+
+    auto status = machine->suspend();
     if (status.notOk()) {
         reactor->Finish(grpc::Status(grpc::StatusCode::INTERNAL, std::string(status.getMessage())));
     } else {
@@ -46,7 +63,15 @@ chord_machine::RemotingService::ResumeMachine(
 {
     auto *reactor = context->DefaultReactor();
 
-    auto status = m_localMachine->resume();
+    auto resolveMachineResult = resolveMachine(context);
+    if (resolveMachineResult.isStatus()) {
+        auto status = resolveMachineResult.getStatus();
+        reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, std::string(status.getMessage())));
+        return reactor;
+    }
+    auto machine = resolveMachineResult.getResult();
+
+    auto status = machine->resume();
     if (status.notOk()) {
         reactor->Finish(grpc::Status(grpc::StatusCode::INTERNAL, std::string(status.getMessage())));
     } else {
@@ -64,7 +89,15 @@ chord_machine::RemotingService::TerminateMachine(
 {
     auto *reactor = context->DefaultReactor();
 
-    auto status = m_localMachine->terminate();
+    auto resolveMachineResult = resolveMachine(context);
+    if (resolveMachineResult.isStatus()) {
+        auto status = resolveMachineResult.getStatus();
+        reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, std::string(status.getMessage())));
+        return reactor;
+    }
+    auto machine = resolveMachineResult.getResult();
+
+    auto status = machine->terminate();
     if (status.notOk()) {
         reactor->Finish(grpc::Status(grpc::StatusCode::INTERNAL, std::string(status.getMessage())));
     } else {
@@ -74,19 +107,98 @@ chord_machine::RemotingService::TerminateMachine(
     return reactor;
 }
 
+/**
+ * Place a machine in the machine host. The machine is started once a Communicate stream is
+ * attached to each of the requested protocols, unless it is placed suspended.
+ */
+grpc::ServerUnaryReactor *
+chord_machine::RemotingService::PlaceMachine(
+    grpc::CallbackServerContext *context,
+    const chord_remoting::PlaceMachineRequest *request,
+    chord_remoting::PlaceMachineResult *response)
+{
+    auto *reactor = context->DefaultReactor();
+
+    if (m_machineHost == nullptr) {
+        reactor->Finish(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+            "machine placement requires worker threads"));
+        return reactor;
+    }
+
+    const auto &machineName = request->machine_name();
+    if (machineName.empty() || machineName == m_localMachine->getMachineName()) {
+        reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+            absl::StrCat("invalid machine name '", machineName, "'")));
+        return reactor;
+    }
+
+    auto mainPackage = zuri_packager::PackageSpecifier::fromString(request->main_package());
+    if (!mainPackage.isValid()) {
+        reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+            absl::StrCat("invalid main package '", request->main_package(), "'")));
+        return reactor;
+    }
+
+    absl::flat_hash_set<tempo_utils::Url> expectedPorts;
+    for (const auto &protocolUri : request->protocol_urls()) {
+        auto protocolUrl = tempo_utils::Url::fromString(protocolUri);
+        if (!protocolUrl.isValid()) {
+            reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                absl::StrCat("invalid protocol url '", protocolUri, "'")));
+            return reactor;
+        }
+        expectedPorts.insert(protocolUrl);
+    }
+
+    auto createMachineResult = m_machineHost->createMachine(
+        machineName, mainPackage, expectedPorts, request->start_suspended());
+    if (createMachineResult.isStatus()) {
+        auto status = createMachineResult.getStatus();
+        auto code = status.matchesCondition(MachineCondition::kInvalidConfiguration)?
+            grpc::StatusCode::INVALID_ARGUMENT : grpc::StatusCode::INTERNAL;
+        reactor->Finish(grpc::Status(code, std::string(status.getMessage())));
+        return reactor;
+    }
+
+    TU_LOG_INFO << "placed machine " << machineName << " running " << mainPackage.toString();
+    reactor->Finish(grpc::Status::OK);
+    return reactor;
+}
+
+/**
+ * Resolve the machine named by the x-chord-machine-name metadata. If the metadata is not present
+ * then the request is for the local machine.
+ */
+tempo_utils::Result<std::shared_ptr<chord_machine::LocalMachine>>
+chord_machine::RemotingService::resolveMachine(grpc::CallbackServerContext *context)
+{
+    auto metadata = context->client_metadata();
+    auto entry = metadata.find(kMachineNameMetadataKey);
+    if (entry == metadata.cend())
+        return m_localMachine;
+
+    std::string machineName(entry->second.data(), entry->second.size());
+    if (machineName == m_localMachine->getMachineName())
+        return m_localMachine;
+    if (m_machineHost != nullptr) {
+        auto machine = m_machineHost->getMachine(machineName);
+        if (machine != nullptr)
+            return machine;
+    }
+
+    return MachineStatus::forCondition(MachineCondition::kInvalidConfiguration,
+        "unknown machine {}", machineName);
+}
+
 class FinishedCommunicateStream
-    : public grpc::ServerBidiReactor<
-        chord_remoting::Message,
-        chord_remoting::Message>
+    : public grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer>
 {
 public:
     explicit FinishedCommunicateStream(const grpc::Status &status) { Finish(status); };
     void OnDone() override {};
 };
 
-grpc::ServerBidiReactor<
-    chord_remoting::Message,
-    chord_remoting::Message> *
+grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> *
 chord_machine::RemotingService::Communicate(grpc::CallbackServerContext *context)
 {
     // get the peer identity
@@ -105,8 +217,21 @@ chord_machine::RemotingService::Communicate(grpc::CallbackServerContext *context
         }
     }
 
+    // streams for the local machine have an empty machine name
+    std::string machineName;
+    auto machineEntry = metadata.find(kMachineNameMetadataKey);
+    if (machineEntry != metadata.cend()) {
+        machineName = std::string(machineEntry->second.data(), machineEntry->second.size());
+        if (machineName == m_localMachine->getMachineName()) {
+            machineName.clear();
+        } else if (m_machineHost == nullptr) {
+            return new FinishedCommunicateStream(
+                grpc::Status(grpc::StatusCode::NOT_FOUND, absl::StrCat("unknown machine ", machineName)));
+        }
+    }
+
     TU_LOG_INFO << "peer identity is " << protocolUrl;
-    return allocateCommunicateStream(protocolUrl);
+    return allocateCommunicateStream(machineName, protocolUrl);
 }
 
 grpc::ServerWriteReactor<chord_remoting::MonitorEvent> *
@@ -174,36 +299,45 @@ chord_machine::RemotingService::notifyMachineExit(tempo_utils::StatusCode status
     }
 }
 
+/**
+ * Allocate a Communicate stream and attach it to the handler of the protocol. If the machine name
+ * is empty then the handler belongs to the local machine, otherwise the handler belongs to the
+ * hosted machine with the specified name.
+ */
 chord_machine::CommunicateStream *
-chord_machine::RemotingService::allocateCommunicateStream(const tempo_utils::Url &protocolUrl)
+chord_machine::RemotingService::allocateCommunicateStream(
+    const std::string &machineName,
+    const tempo_utils::Url &protocolUrl)
 {
     absl::MutexLock locker(&m_lock);
 
-    auto *stream = new CommunicateStream(protocolUrl, this);
+    auto *stream = new CommunicateStream(machineName, protocolUrl, this);
 
     // verify that handler exists for the specified protocol
-    if (!m_handlers.contains(protocolUrl)) {
+    std::shared_ptr<chord_common::AbstractProtocolHandler> handler;
+    if (machineName.empty()) {
+        auto entry = m_handlers.find(protocolUrl);
+        if (entry != m_handlers.cend()) {
+            handler = entry->second;
+        }
+    } else {
+        handler = m_machineHost->getProtocolHandler(machineName, protocolUrl);
+    }
+    if (handler == nullptr) {
         stream->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
             absl::StrCat("protocol ", protocolUrl.toString(), " is not allocated")));
         return stream;
     }
 
     // verify that handler is not attached
-    if (m_communicateStreams.contains(protocolUrl)) {
+    auto key = std::make_pair(machineName, protocolUrl);
+    if (m_communicateStreams.contains(key) || handler->isAttached()) {
         stream->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
             absl::StrCat("protocol ", protocolUrl.toString(), " is already attached")));
         return stream;
     }
 
-    // verify internal handler state
-    auto handler = m_handlers.at(protocolUrl);
-    if (handler->isAttached()) {
-        stream->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-            absl::StrCat("protocol ", protocolUrl.toString(), " is already attached")));
-        return stream;
-    }
-
-    m_communicateStreams[protocolUrl] = stream;
+    m_communicateStreams[key] = stream;
     auto status = stream->attachHandler(handler);
     if (status.notOk()) {
         stream->Finish(grpc::Status(grpc::StatusCode::INTERNAL,
@@ -211,26 +345,33 @@ chord_machine::RemotingService::allocateCommunicateStream(const tempo_utils::Url
         return stream;
     }
 
+    // a hosted machine is started by the host once all of its protocols are attached
+    if (!machineName.empty()) {
+        status = m_machineHost->notifyProtocolAttached(machineName, protocolUrl);
+        TU_LOG_WARN_IF (status.notOk()) << "failed to notify machine " << machineName << ": " << status;
+        return stream;
+    }
+
     // if all required protocols are attached then signal init complete
     m_requiredAtLaunch.erase(protocolUrl);
     if (m_requiredAtLaunch.empty()) {
         uv_async_send(m_initComplete);
     }
 
-    m_communicateStreams[protocolUrl] = stream;
     return stream;
 }
 
 void
-chord_machine::RemotingService::freeCommunicateStream(const tempo_utils::Url &protocolUrl)
+chord_machine::RemotingService::freeCommunicateStream(CommunicateStream *stream)
 {
-    TU_ASSERT (protocolUrl.isValid());
+    TU_ASSERT (stream != nullptr);
     absl::MutexLock locker(&m_lock);
-    auto entry = m_communicateStreams.find(protocolUrl);
-    if (entry == m_communicateStreams.cend())
-        return;
-    delete entry->second;
-    m_communicateStreams.erase(entry);
+    // a stream which was rejected is not registered, so only unregister the stream if it owns the entry
+    auto entry = m_communicateStreams.find(std::make_pair(stream->m_machineName, stream->m_protcolUrl));
+    if (entry != m_communicateStreams.cend() && entry->second == stream) {
+        m_communicateStreams.erase(entry);
+    }
+    delete stream;
 }
 
 chord_machine::MonitorStream *
@@ -251,62 +392,91 @@ chord_machine::RemotingService::freeMonitorStream(MonitorStream *stream)
     delete stream;
 }
 
-chord_machine::CommunicateStream::CommunicateStream(const tempo_utils::Url &protocolUrl, RemotingService *remotingService)
-    : m_protcolUrl(protocolUrl),
+chord_machine::CommunicateStream::CommunicateStream(
+    const std::string &machineName,
+    const tempo_utils::Url &protocolUrl,
+    RemotingService *remotingService)
+    : m_machineName(machineName),
+      m_protcolUrl(protocolUrl),
       m_remotingService(remotingService),
-      m_head(nullptr),
-      m_tail(nullptr)
+      m_pendingBytes(0),
+      m_writeSize(0),
+      m_batchBytes(0),
+      m_writing(false),
+      m_congested(false),
+      m_finished(false)
 {
     TU_ASSERT (m_protcolUrl.isValid());
     TU_ASSERT (m_remotingService != nullptr);
     TU_LOG_V << "Communicate stream started";
-    StartRead(&m_incoming);
+    StartRead(&m_incomingBuffer);
 }
 
 chord_machine::CommunicateStream::~CommunicateStream()
 {
-    if (m_handler->isAttached()) {
+    if (m_handler != nullptr && m_handler->isAttached()) {
         TU_LOG_WARN << "handler was still attached to CommunicateStream during cleanup";
         m_handler->detach();
     }
-    while (m_head != nullptr) {
-        auto *curr = m_head;
-        m_head = m_head->next;
-        delete curr;
-    }
 }
 
 void
 chord_machine::CommunicateStream::OnReadDone(bool ok)
 {
+    // a stream which was rejected has no handler, and it has already been finished
+    if (m_handler == nullptr)
+        return;
     if (!ok) {
         TU_LOG_V << "read failed";
         Finish(grpc::Status::OK);
         return;
     }
     // we don't need to hold the lock because reads are received one at a time
-    m_handler->handle(m_incoming.data());
+    grpc::ProtoBufferReader reader(&m_incomingBuffer);
+    if (m_incoming.ParseFromZeroCopyStream(&reader)) {
+        auto status = m_handler->handle(m_incoming.data());
+        if (status.notOk()) {
+            TU_LOG_V << "dropped message: " << status;
+        }
+    } else {
+        TU_LOG_V << "dropped malformed message";
+    }
     m_incoming.Clear();
-    StartRead(&m_incoming);
+    m_incomingBuffer.Clear();
+    StartRead(&m_incomingBuffer);
 }
 
 void
 chord_machine::CommunicateStream::OnWriteDone(bool ok)
 {
-    if (!ok) {
-        TU_LOG_V << "write failed";
-        return;
+    bool resumed = false;
+    {
+        absl::MutexLock locker(&m_lock);
+        m_writing = false;
+        m_pendingBytes -= m_writeSize;
+        m_writeSize = 0;
+
+        if (!ok) {
+            TU_LOG_V << "write failed";
+            // the stream will not accept more writes
+            m_finished = true;
+            return;
+        }
+
+        TU_LOG_V << "completed write (" << (int) m_pendingBytes << " bytes pending)";
+        if (!m_pending.empty()) {
+            startNextWrite();
+        }
+
+        if (m_congested && m_pendingBytes <= kCommunicateWriteLowWatermark) {
+            m_congested = false;
+            resumed = true;
+        }
     }
 
-    absl::MutexLock locker(&m_lock);
-    TU_LOG_V << "completed write for " << (void *) m_head;
-    auto *pending = m_head->next;
-    delete m_head;
-    m_head = pending;
-    if (pending) {
-        StartWrite(&pending->message);
-        TU_LOG_V << "starting write " << (void *) pending
-            << " (size is " << (int) pending->message.data().size() << ")";
+    // notify the handler without holding the lock, the handler may write from the notification
+    if (resumed) {
+        m_handler->writable(true);
     }
 }
 
@@ -314,45 +484,170 @@ void
 chord_machine::CommunicateStream::OnCancel()
 {
     TU_LOG_V << "Communicate stream cancelled";
-    Finish(grpc::Status::OK);
+    if (m_handler != nullptr) {
+        Finish(grpc::Status::OK);
+    }
 }
 
 void
 chord_machine::CommunicateStream::OnDone()
 {
     TU_LOG_V << "Communicate stream done";
-    m_handler->detach();
-    m_remotingService->freeCommunicateStream(m_protcolUrl);
+    {
+        absl::MutexLock locker(&m_lock);
+        m_finished = true;
+        m_pending.clear();
+    }
+    if (m_handler != nullptr) {
+        m_handler->detach();
+    }
+    m_remotingService->freeCommunicateStream(this);
 }
 
 tempo_utils::Status
 chord_machine::CommunicateStream::write(std::string_view message)
 {
-    auto *pending = new PendingWrite();
-    pending->message.set_version(chord_remoting::MessageVersion::Version1);
-    pending->message.set_data(std::string(message));
-    pending->next = nullptr;
+    return enqueueWrite(tempo_utils::MemoryBytes::copy(message));
+}
+
+tempo_utils::Status
+chord_machine::CommunicateStream::write(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+{
+    TU_ASSERT (payload != nullptr);
+    return enqueueWrite(std::move(payload));
+}
+
+tempo_utils::Status
+chord_machine::CommunicateStream::enqueueWrite(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+{
+    bool paused = false;
+    {
+        absl::MutexLock locker(&m_lock);
+
+        if (m_finished)
+            return tempo_utils::GenericStatus::forCondition(
+                tempo_utils::GenericCondition::kInternalViolation, "communicate stream is finished");
+
+        // if the queue is above the high watermark then fail the write rather than blocking the
+        // writer, which is usually the interpreter thread. the handler is notified once the queue
+        // drains below the low watermark
+        if (m_pendingBytes >= kCommunicateWriteHighWatermark) {
+            m_congested = true;
+            return MachineStatus::forCondition(MachineCondition::kWriteCongested,
+                "communicate stream is congested ({} bytes pending)", m_pendingBytes);
+        }
+
+        m_pendingBytes += payload->getSize();
+        m_pending.push_back({std::move(payload), 0});
+
+        // if no write is in flight then start the write, otherwise the message stays queued
+        if (!m_writing) {
+            startNextWrite();
+        }
+
+        if (!m_congested && m_pendingBytes >= kCommunicateWriteHighWatermark) {
+            m_congested = true;
+            paused = true;
+        }
+    }
+
+    // notify the handler without holding the lock
+    if (paused) {
+        m_handler->writable(false);
+    }
+
+    return {};
+}
+
+tempo_utils::Status
+chord_machine::CommunicateStream::grantCredit(tu_uint32 credit)
+{
+    if (credit == 0)
+        return {};
 
     absl::MutexLock locker(&m_lock);
 
-    if (m_head == nullptr) {
-        m_head = pending;
-        m_tail = pending;
-        // if no messages are pending then start the write
-        StartWrite(&pending->message);
-        TU_LOG_V << "starting write " << (void *) pending
-            << " (size is " << (int) pending->message.data().size() << ")";
-    } else {
-        // otherwise just enqueue the pending message
-        m_tail->next = pending;
-        m_tail = pending;
-        TU_LOG_V << "enqueuing write " << (void *) pending
-            << " (size is " << (int) pending->message.data().size() << ")";
+    if (m_finished)
+        return tempo_utils::GenericStatus::forCondition(
+            tempo_utils::GenericCondition::kInternalViolation, "communicate stream is finished");
+
+    // credit grants are never subject to backpressure, otherwise the remote end could stall
+    m_pending.push_back({{}, credit});
+    if (!m_writing) {
+        startNextWrite();
     }
 
     return {};
 }
 
+constexpr tu_uint32 kWireTypeLengthDelimited = 2;
+
+static void
+append_varint(std::string &dst, tu_uint32 value)
+{
+    while (value >= 0x80) {
+        dst.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    dst.push_back(static_cast<char>(value));
+}
+
+void
+chord_machine::CommunicateStream::startNextWrite()
+{
+    TU_ASSERT (!m_writing);
+    TU_ASSERT (!m_pending.empty());
+
+    auto pending = std::move(m_pending.front());
+    m_pending.pop_front();
+
+    // serialize the envelope without the data field
+    m_envelope.set_version(chord_remoting::MessageVersion::Version1);
+    m_envelope.clear_headers();
+    if (pending.credit > 0) {
+        auto *header = m_envelope.add_headers();
+        header->set_name(chord_common::kProtocolCreditHeader);
+        header->set_value(absl::StrCat(pending.credit));
+    }
+    std::string prefix;
+    m_envelope.SerializeToString(&prefix);
+
+    auto &payload = pending.payload;
+    m_writeSize = payload != nullptr? payload->getSize() : 0;
+    if (m_writeSize > 0) {
+        // append the key and length of the data field, then reference the payload in its own
+        // slice. the slice owns a reference to the payload which is released by gRPC once the
+        // bytes have been written, so the payload is never copied
+        append_varint(prefix, (chord_remoting::Message::kDataFieldNumber << 3) | kWireTypeLengthDelimited);
+        append_varint(prefix, m_writeSize);
+        auto *owner = new std::shared_ptr<const tempo_utils::ImmutableBytes>(std::move(payload));
+        grpc::Slice slices[2] = {
+            grpc::Slice(prefix),
+            grpc::Slice((void *) (*owner)->getData(), m_writeSize,
+                [](void *ptr) { delete static_cast<std::shared_ptr<const tempo_utils::ImmutableBytes> *>(ptr); },
+                owner),
+        };
+        m_outgoing = grpc::ByteBuffer(slices, 2);
+    } else {
+        grpc::Slice slice(prefix);
+        m_outgoing = grpc::ByteBuffer(&slice, 1);
+    }
+
+    // if more messages are queued then let gRPC buffer this write and coalesce it with the
+    // following writes, unless the batch has grown to the batch size
+    grpc::WriteOptions options;
+    m_batchBytes += m_writeSize;
+    if (!m_pending.empty() && m_batchBytes < kCommunicateWriteBatchSize) {
+        options.set_buffer_hint();
+    } else {
+        m_batchBytes = 0;
+    }
+
+    m_writing = true;
+    StartWrite(&m_outgoing, options);
+    TU_LOG_V << "starting write (size is " << (int) m_writeSize << ")";
+}
+
 tempo_utils::Status
 chord_machine::CommunicateStream::attachHandler(std::shared_ptr<chord_common::AbstractProtocolHandler> handler)
 {
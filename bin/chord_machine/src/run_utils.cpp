@@ -1,10 +1,59 @@
 
+#include <chord_machine/gateway_port_socket.h>
 #include <chord_machine/port_socket.h>
 #include <chord_machine/run_utils.h>
 #include <tempo_command/command_result.h>
 #include <tempo_utils/file_reader.h>
 #include <tempo_utils/tempfile_maker.h>
 
+tempo_utils::Status
+chord_machine::await_assignment(
+    ChordLocalMachineConfig &chordLocalMachineConfig,
+    ChordLocalMachineData &chordLocalMachineData)
+{
+    auto pooledName = chordLocalMachineConfig.machineName;
+
+    // wait until the supervisor assigns the machine, which may take arbitrarily long
+    grpc::ClientContext awaitAssignmentContext;
+    chord_invoke::AwaitAssignmentRequest awaitAssignmentRequest;
+    chord_invoke::AwaitAssignmentResult awaitAssignmentResult;
+
+    awaitAssignmentRequest.set_pooled_name(pooledName);
+
+    TU_LOG_INFO << "awaiting assignment for pooled machine " << pooledName;
+    auto awaitAssignmentStatus = chordLocalMachineData.invokeStub->AwaitAssignment(
+        &awaitAssignmentContext, awaitAssignmentRequest, &awaitAssignmentResult);
+    TU_LOG_ERROR_IF(!awaitAssignmentStatus.ok()) << "AwaitAssignment failed: "
+        << awaitAssignmentStatus.error_message();
+    if (!awaitAssignmentStatus.ok())
+        return tempo_command::CommandStatus::forCondition(tempo_command::CommandCondition::kCommandError,
+            "assignment failure: {}", awaitAssignmentStatus.error_message());
+
+    // apply the assignment to the machine config
+    auto mainPackage = zuri_packager::PackageSpecifier::fromString(awaitAssignmentResult.main_package());
+    if (!mainPackage.isValid())
+        return tempo_command::CommandStatus::forCondition(tempo_command::CommandCondition::kCommandError,
+            "invalid main package '{}'", awaitAssignmentResult.main_package());
+    chordLocalMachineConfig.machineName = awaitAssignmentResult.machine_name();
+    chordLocalMachineConfig.mainPackage = mainPackage;
+    chordLocalMachineConfig.mainArguments.clear();
+    for (const auto &mainArgument : awaitAssignmentResult.main_arguments()) {
+        chordLocalMachineConfig.mainArguments.push_back(mainArgument);
+    }
+    for (const auto &requestedPort : awaitAssignmentResult.requested_ports()) {
+        auto protocolUrl = tempo_utils::Url::fromString(requestedPort.protocol_url());
+        if (!protocolUrl.isValid())
+            return tempo_command::CommandStatus::forCondition(tempo_command::CommandCondition::kCommandError,
+                "invalid protocol url '{}'", requestedPort.protocol_url());
+        chordLocalMachineConfig.expectedPorts.insert(protocolUrl);
+    }
+    chordLocalMachineConfig.startSuspended = awaitAssignmentResult.start_suspended();
+
+    TU_LOG_INFO << "pooled machine " << pooledName << " assigned to " << chordLocalMachineConfig.machineName;
+
+    return {};
+}
+
 tempo_utils::Status
 chord_machine::sign_certificates(
     const ChordLocalMachineConfig &chordLocalMachineConfig,
@@ -87,7 +136,19 @@ chord_machine::register_protocols(
     for (const auto &expectedPort : expectedPorts) {
         std::shared_ptr<lyric_runtime::DuplexPort> duplexPort;
         TU_ASSIGN_OR_RETURN (duplexPort, multiplexer->registerPort(expectedPort));
-        auto socket = std::make_shared<PortSocket>(duplexPort);
+
+        // a gateway port answers the http requests forwarded by the gateway
+        if (chordLocalMachineConfig.gatewayPorts.contains(expectedPort)) {
+            auto socket = std::make_shared<GatewayPortSocket>(duplexPort, &chordLocalMachineData.mainLoop);
+            TU_RETURN_IF_NOT_OK (socket->initialize());
+            chordLocalMachineData.remotingService->registerProtocolHandler(expectedPort,
+                socket, /* requiredAtLaunch= */ true);
+            TU_LOG_INFO << "registered gateway port " << expectedPort;
+            continue;
+        }
+
+        auto socket = std::make_shared<PortSocket>(duplexPort, &chordLocalMachineData.mainLoop);
+        TU_RETURN_IF_NOT_OK (socket->initialize());
         chordLocalMachineData.remotingService->registerProtocolHandler(expectedPort,
             socket, /* requiredAtLaunch= */ true);
         TU_LOG_INFO << "registered expected port " << expectedPort;
@@ -0,0 +1,129 @@
+
+#include <chord_machine/machine_result.h>
+#include <chord_machine/runner_worker_pool.h>
+#include <tempo_utils/log_stream.h>
+
+chord_machine::RunnerWorkerPool::RunnerWorkerPool(tu_uint32 numWorkers)
+    : m_numWorkers(numWorkers),
+      m_numActive(0),
+      m_running(false),
+      m_shutdown(false)
+{
+    TU_ASSERT (m_numWorkers > 0);
+}
+
+chord_machine::RunnerWorkerPool::~RunnerWorkerPool()
+{
+    auto status = shutdown();
+    TU_LOG_WARN_IF (status.notOk()) << "failed to shut down worker pool: " << status;
+}
+
+void
+chord_machine::run_worker_thread(void *arg)
+{
+    auto *pool = static_cast<RunnerWorkerPool *>(arg);
+    pool->runWorker();
+}
+
+tempo_utils::Status
+chord_machine::RunnerWorkerPool::initialize()
+{
+    absl::MutexLock locker(&m_lock);
+
+    if (m_running || m_shutdown)
+        return MachineStatus::forCondition(MachineCondition::kMachineInvariant,
+            "worker pool is already initialized");
+
+    m_threads.resize(m_numWorkers);
+    for (tu_uint32 i = 0; i < m_numWorkers; i++) {
+        auto ret = uv_thread_create(&m_threads[i], run_worker_thread, this);
+        if (ret != 0) {
+            m_threads.resize(i);
+            m_shutdown = true;
+            return MachineStatus::forCondition(MachineCondition::kMachineInvariant,
+                "failed to create worker thread: {}", uv_strerror(ret));
+        }
+    }
+    m_running = true;
+
+    TU_LOG_V << "started " << (int) m_numWorkers << " runner workers";
+    return {};
+}
+
+tempo_utils::Status
+chord_machine::RunnerWorkerPool::submit(absl::AnyInvocable<void() &&> task)
+{
+    absl::MutexLock locker(&m_lock);
+    if (m_shutdown)
+        return MachineStatus::forCondition(MachineCondition::kMachineInvariant,
+            "worker pool is shut down");
+    m_queued.push_back(std::move(task));
+    return {};
+}
+
+tempo_utils::Status
+chord_machine::RunnerWorkerPool::shutdown()
+{
+    {
+        absl::MutexLock locker(&m_lock);
+        m_shutdown = true;
+    }
+
+    // workers finish the queued tasks before they exit
+    for (auto &tid : m_threads) {
+        uv_thread_join(&tid);
+    }
+    m_threads.clear();
+
+    absl::MutexLock locker(&m_lock);
+    m_running = false;
+    return {};
+}
+
+tu_uint32
+chord_machine::RunnerWorkerPool::numWorkers() const
+{
+    return m_numWorkers;
+}
+
+tu_uint32
+chord_machine::RunnerWorkerPool::numQueued() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_queued.size();
+}
+
+tu_uint32
+chord_machine::RunnerWorkerPool::numActive() const
+{
+    absl::MutexLock locker(&m_lock);
+    return m_numActive;
+}
+
+bool
+chord_machine::RunnerWorkerPool::hasWork() const
+{
+    return m_shutdown || !m_queued.empty();
+}
+
+void
+chord_machine::RunnerWorkerPool::runWorker()
+{
+    for (;;) {
+        absl::AnyInvocable<void() &&> task;
+        {
+            absl::MutexLock locker(&m_lock);
+            m_lock.Await(absl::Condition(this, &RunnerWorkerPool::hasWork));
+            if (m_queued.empty())
+                return;
+            task = std::move(m_queued.front());
+            m_queued.pop_front();
+            m_numActive++;
+        }
+
+        std::move(task)();
+
+        absl::MutexLock locker(&m_lock);
+        m_numActive--;
+    }
+}
@@ -0,0 +1,138 @@
+
+#include <chord_machine/safepoint_inspector.h>
+#include <lyric_runtime/bytecode_interpreter.h>
+
+chord_machine::SafepointInspector::SafepointInspector(
+    tu_uint32 instructionBudget,
+    absl::AnyInvocable<bool()> shouldYield)
+    : m_instructionBudget(instructionBudget),
+      m_remaining(instructionBudget),
+      m_shouldYield(std::move(shouldYield)),
+      m_interrupted(false),
+      m_yielded(false),
+      m_requestedAt(0)
+{
+    TU_ASSERT (m_instructionBudget > 0);
+}
+
+tu_uint32
+chord_machine::SafepointInspector::getInstructionBudget() const
+{
+    return m_instructionBudget;
+}
+
+void
+chord_machine::SafepointInspector::requestInterrupt()
+{
+    // if an interrupt is already pending then keep the earlier request time
+    tu_int64 expected = 0;
+    auto now = absl::ToUnixMicros(absl::Now());
+    m_requestedAt.compare_exchange_strong(expected, now);
+}
+
+void
+chord_machine::SafepointInspector::clearInterrupt()
+{
+    m_requestedAt.store(0);
+    m_interrupted = false;
+    m_yielded = false;
+}
+
+bool
+chord_machine::SafepointInspector::takeInterrupted()
+{
+    auto interrupted = m_interrupted;
+    m_interrupted = false;
+    return interrupted;
+}
+
+bool
+chord_machine::SafepointInspector::takeYielded()
+{
+    auto yielded = m_yielded;
+    m_yielded = false;
+    return yielded;
+}
+
+chord_machine::SafepointStats
+chord_machine::SafepointInspector::getStats() const
+{
+    return m_stats;
+}
+
+tempo_utils::Status
+chord_machine::SafepointInspector::beforeOp(
+    const lyric_object::OpCell &op,
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    if (--m_remaining > 0)
+        return {};
+
+    // the budget is exhausted so this instruction is a safepoint
+    m_remaining = m_instructionBudget;
+    m_stats.safepointsReached++;
+
+    auto requestedAt = m_requestedAt.exchange(0);
+    if (requestedAt == 0) {
+        if (!m_shouldYield || !m_shouldYield())
+            return {};
+        // no request is pending but another runner is waiting for a worker
+        m_stats.yields++;
+        m_yielded = true;
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kInterrupted, "yielded at safepoint");
+    }
+
+    auto latency = absl::Now() - absl::FromUnixMicros(requestedAt);
+    m_stats.interruptsDelivered++;
+    m_stats.lastInterruptLatency = latency;
+    m_stats.maxInterruptLatency = std::max(m_stats.maxInterruptLatency, latency);
+    m_stats.totalInterruptLatency += latency;
+    m_interrupted = true;
+
+    // stop before the instruction is executed, so the interpreter resumes from this instruction
+    return lyric_runtime::InterpreterStatus::forCondition(
+        lyric_runtime::InterpreterCondition::kInterrupted, "interrupted at safepoint");
+}
+
+tempo_utils::Status
+chord_machine::SafepointInspector::afterOp(
+    const lyric_object::OpCell &op,
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return {};
+}
+
+tempo_utils::Status
+chord_machine::SafepointInspector::onInterrupt(
+    const lyric_runtime::DataCell &cell,
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return {};
+}
+
+tempo_utils::Result<lyric_runtime::DataCell>
+chord_machine::SafepointInspector::onError(
+    const lyric_object::OpCell &op,
+    const tempo_utils::Status &status,
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return status;
+}
+
+tempo_utils::Result<lyric_runtime::InterpreterExit>
+chord_machine::SafepointInspector::onHalt(
+    const lyric_object::OpCell &op,
+    const lyric_runtime::DataCell &cell,
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    lyric_runtime::InterpreterExit exit;
+    exit.statusCode = tempo_utils::StatusCode::kOk;
+    exit.mainReturn = cell;
+    return exit;
+}
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstring>
+
+#include <chord_machine/assembly_cache_loader.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/tempdir_maker.h>
+#include <zuri_distributor/package_cache_loader.h>
+
+/**
+ * Loader which loads the main module for any location in the package, so the cache sees each
+ * location as a distinct module.
+ */
+class AliasLoader : public lyric_runtime::AbstractLoader {
+public:
+    AliasLoader(std::shared_ptr<lyric_runtime::AbstractLoader> loader, const lyric_common::ModuleLocation &target)
+        : m_loader(std::move(loader)), m_target(target) {}
+    tempo_utils::Result<bool> hasModule(const lyric_common::ModuleLocation &location) const override {
+        return m_loader->hasModule(m_target);
+    }
+    tempo_utils::Result<Option<lyric_object::LyricObject>> loadModule(
+        const lyric_common::ModuleLocation &location) override {
+        return m_loader->loadModule(m_target);
+    }
+    tempo_utils::Result<Option<lyric_runtime::NativeInterface *>> loadPlugin(
+        const lyric_common::ModuleLocation &location,
+        const lyric_object::PluginSpecifier &specifier) override {
+        return m_loader->loadPlugin(location, specifier);
+    }
+private:
+    std::shared_ptr<lyric_runtime::AbstractLoader> m_loader;
+    lyric_common::ModuleLocation m_target;
+};
+
+class AssemblyCacheLoaderTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> testDirectory;
+    std::shared_ptr<zuri_distributor::PackageCache> packageCache;
+    zuri_packager::PackageSpecifier specifier;
+    lyric_common::ModuleLocation mainLocation;
+
+    lyric_common::ModuleLocation aliasLocation(std::string_view path) const {
+        return lyric_common::ModuleLocation::fromUrl(
+            specifier.toUrl()
+                .resolve(tempo_utils::UrlPath::fromString(path)));
+    }
+    std::shared_ptr<chord_common::AssemblyStore> openStore() const {
+        std::shared_ptr<chord_common::AssemblyStore> store;
+        TU_ASSIGN_OR_RAISE (store, chord_common::AssemblyStore::openOrCreate(
+            testDirectory->getTempdir() / "assemblies"));
+        return store;
+    }
+
+    void SetUp() override {
+        testDirectory = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_ASSIGN_OR_RAISE (packageCache, zuri_distributor::PackageCache::openOrCreate(
+            testDirectory->getTempdir(), "pkgcache"));
+
+        std::shared_ptr<zuri_packager::PackageReader> reader;
+        TU_ASSIGN_OR_RAISE (reader, zuri_packager::PackageReader::open(TEST1_ZPK));
+        TU_RAISE_IF_STATUS (packageCache->installPackage(reader));
+
+        TU_ASSIGN_OR_RAISE (specifier, reader->readPackageSpecifier());
+        lyric_common::ModuleLocation programMain;
+        TU_ASSIGN_OR_RAISE (programMain, reader->readProgramMain());
+        mainLocation = lyric_common::ModuleLocation::fromUrl(
+            specifier.toUrl()
+                .resolve(programMain.getPath()));
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(testDirectory->getTempdir());
+    }
+};
+
+TEST_F(AssemblyCacheLoaderTests, SecondLoadHitsCache)
+{
+    auto packageCacheLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader(packageCacheLoader);
+
+    auto loadModuleResult1 = loader.loadModule(mainLocation);
+    ASSERT_THAT (loadModuleResult1, tempo_test::IsResult());
+    ASSERT_FALSE (loadModuleResult1.getResult().isEmpty());
+
+    auto loadModuleResult2 = loader.loadModule(mainLocation);
+    ASSERT_THAT (loadModuleResult2, tempo_test::IsResult());
+    ASSERT_FALSE (loadModuleResult2.getResult().isEmpty());
+
+    auto stats = loader.getStats();
+    ASSERT_EQ (1, stats.hits);
+    ASSERT_EQ (1, stats.misses);
+    ASSERT_EQ (1, stats.cachedObjects);
+    ASSERT_LT (0, stats.cachedBytes);
+}
+
+TEST_F(AssemblyCacheLoaderTests, InvalidatePackageRemovesEntries)
+{
+    auto packageCacheLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader(packageCacheLoader);
+
+    ASSERT_THAT (loader.loadModule(mainLocation), tempo_test::IsResult());
+    loader.invalidatePackage(specifier);
+    ASSERT_THAT (loader.loadModule(mainLocation), tempo_test::IsResult());
+
+    auto stats = loader.getStats();
+    ASSERT_EQ (0, stats.hits);
+    ASSERT_EQ (2, stats.misses);
+    ASSERT_EQ (1, stats.invalidations);
+    ASSERT_EQ (1, stats.cachedObjects);
+}
+
+TEST_F(AssemblyCacheLoaderTests, DoNotCacheWhenObjectLimitIsZero)
+{
+    auto packageCacheLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheOptions options;
+    options.maxCachedObjects = 0;
+    chord_machine::AssemblyCacheLoader loader(packageCacheLoader, options);
+
+    ASSERT_THAT (loader.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_THAT (loader.loadModule(mainLocation), tempo_test::IsResult());
+
+    auto stats = loader.getStats();
+    ASSERT_EQ (0, stats.hits);
+    ASSERT_EQ (2, stats.misses);
+    ASSERT_EQ (0, stats.cachedObjects);
+}
+
+TEST_F(AssemblyCacheLoaderTests, EvictLeastRecentlyUsedWhenObjectLimitIsReached)
+{
+    auto packageCacheLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    auto aliasLoader = std::make_shared<AliasLoader>(packageCacheLoader, mainLocation);
+    chord_machine::AssemblyCacheOptions options;
+    options.maxCachedObjects = 2;
+    chord_machine::AssemblyCacheLoader loader(aliasLoader, options);
+
+    auto location1 = aliasLocation("/alias1");
+    auto location2 = aliasLocation("/alias2");
+    auto location3 = aliasLocation("/alias3");
+
+    ASSERT_THAT (loader.loadModule(location1), tempo_test::IsResult());
+    ASSERT_THAT (loader.loadModule(location2), tempo_test::IsResult());
+    // touch location1 so location2 is the least recently used entry
+    ASSERT_THAT (loader.loadModule(location1), tempo_test::IsResult());
+    ASSERT_THAT (loader.loadModule(location3), tempo_test::IsResult());
+
+    auto stats = loader.getStats();
+    ASSERT_EQ (1, stats.hits);
+    ASSERT_EQ (3, stats.misses);
+    ASSERT_EQ (1, stats.evictions);
+    ASSERT_EQ (2, stats.cachedObjects);
+
+    // location1 and location3 are still cached, location2 was evicted
+    ASSERT_THAT (loader.loadModule(location1), tempo_test::IsResult());
+    ASSERT_THAT (loader.loadModule(location3), tempo_test::IsResult());
+    ASSERT_EQ (3, loader.getStats().hits);
+    ASSERT_THAT (loader.loadModule(location2), tempo_test::IsResult());
+    ASSERT_EQ (4, loader.getStats().misses);
+}
+
+TEST_F(AssemblyCacheLoaderTests, SecondMachineMapsModuleFromStore)
+{
+    auto store = openStore();
+
+    auto packageCacheLoader1 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader1(packageCacheLoader1, {}, store);
+    auto loadModuleResult1 = loader1.loadModule(mainLocation);
+    ASSERT_THAT (loadModuleResult1, tempo_test::IsResult());
+    ASSERT_FALSE (loadModuleResult1.getResult().isEmpty());
+
+    auto stats1 = loader1.getStats();
+    ASSERT_EQ (0, stats1.storeHits);
+    ASSERT_EQ (1, stats1.storeMisses);
+
+    auto packageCacheLoader2 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader2(packageCacheLoader2, {}, store);
+    auto loadModuleResult2 = loader2.loadModule(mainLocation);
+    ASSERT_THAT (loadModuleResult2, tempo_test::IsResult());
+    ASSERT_FALSE (loadModuleResult2.getResult().isEmpty());
+
+    auto stats2 = loader2.getStats();
+    ASSERT_EQ (1, stats2.storeHits);
+    ASSERT_EQ (0, stats2.storeMisses);
+
+    auto object1 = loadModuleResult1.getResult().getValue();
+    auto object2 = loadModuleResult2.getResult().getValue();
+    ASSERT_EQ (object1.bytesView().size(), object2.bytesView().size());
+    ASSERT_EQ (0, memcmp(object1.bytesView().data(), object2.bytesView().data(), object1.bytesView().size()));
+}
+
+TEST_F(AssemblyCacheLoaderTests, ChangedPackageStampInvalidatesStore)
+{
+    auto store = openStore();
+
+    auto packageCacheLoader1 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader1(packageCacheLoader1, {}, store);
+    ASSERT_THAT (loader1.validatePackage(specifier, "stamp1"), tempo_test::IsOk());
+    ASSERT_THAT (loader1.loadModule(mainLocation), tempo_test::IsResult());
+
+    // the same stamp keeps the stored module
+    auto packageCacheLoader2 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader2(packageCacheLoader2, {}, store);
+    ASSERT_THAT (loader2.validatePackage(specifier, "stamp1"), tempo_test::IsOk());
+    ASSERT_THAT (loader2.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_EQ (1, loader2.getStats().storeHits);
+
+    // a different stamp removes the package from the store and from memory
+    ASSERT_THAT (loader2.validatePackage(specifier, "stamp2"), tempo_test::IsOk());
+    ASSERT_EQ (1, loader2.getStats().invalidations);
+    ASSERT_EQ (0, loader2.getStats().cachedObjects);
+
+    auto packageCacheLoader3 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader3(packageCacheLoader3, {}, store);
+    ASSERT_THAT (loader3.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_EQ (0, loader3.getStats().storeHits);
+    ASSERT_EQ (1, loader3.getStats().storeMisses);
+}
+
+TEST_F(AssemblyCacheLoaderTests, PackageIsValidatedOnFirstLoad)
+{
+    auto store = openStore();
+
+    std::string stamp = "stamp1";
+    int numStamped = 0;
+    chord_machine::PackageStamper stamper = [&](const zuri_packager::PackageSpecifier &) {
+        numStamped++;
+        return tempo_utils::Result<Option<std::string>>(Option<std::string>(stamp));
+    };
+
+    // the package is stamped once, no matter how many of its modules are loaded
+    auto packageCacheLoader1 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    auto aliasLoader1 = std::make_shared<AliasLoader>(packageCacheLoader1, mainLocation);
+    chord_machine::AssemblyCacheLoader loader1(aliasLoader1, {}, store, stamper);
+    ASSERT_THAT (loader1.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_THAT (loader1.loadModule(aliasLocation("/alias")), tempo_test::IsResult());
+    ASSERT_EQ (1, numStamped);
+
+    // the same stamp keeps the stored modules
+    auto packageCacheLoader2 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader2(packageCacheLoader2, {}, store, stamper);
+    ASSERT_THAT (loader2.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_EQ (1, loader2.getStats().storeHits);
+    ASSERT_EQ (2, numStamped);
+
+    // a reinstalled archive changes the stamp, so the stored modules are discarded
+    stamp = "stamp2";
+    auto packageCacheLoader3 = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+    chord_machine::AssemblyCacheLoader loader3(packageCacheLoader3, {}, store, stamper);
+    ASSERT_THAT (loader3.loadModule(mainLocation), tempo_test::IsResult());
+    ASSERT_EQ (0, loader3.getStats().storeHits);
+    ASSERT_EQ (1, loader3.getStats().storeMisses);
+    ASSERT_EQ (3, numStamped);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_common/assembly_store.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/tempdir_maker.h>
+
+class AssemblyStoreTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> testDirectory;
+    std::shared_ptr<chord_common::AssemblyStore> store;
+
+    void SetUp() override {
+        testDirectory = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_ASSIGN_OR_RAISE (store, chord_common::AssemblyStore::openOrCreate(
+            testDirectory->getTempdir() / "assemblies"));
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(testDirectory->getTempdir());
+    }
+
+    static std::span<const tu_uint8> toSpan(std::string_view s) {
+        return std::span((const tu_uint8 *) s.data(), s.size());
+    }
+    std::shared_ptr<const tempo_utils::ImmutableBytes> map(std::string_view objectKey) const {
+        std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+        TU_ASSIGN_OR_RAISE (bytes, store->mapObject("pkg", objectKey));
+        return bytes;
+    }
+};
+
+TEST_F(AssemblyStoreTests, MapStoredObject)
+{
+    ASSERT_EQ (nullptr, map("/mod1"));
+
+    ASSERT_THAT (store->storeObject("pkg", "/mod1", toSpan("hello, world!")), tempo_test::IsOk());
+
+    auto bytes = map("/mod1");
+    ASSERT_NE (nullptr, bytes);
+    ASSERT_EQ ("hello, world!", bytes->getStringView());
+}
+
+TEST_F(AssemblyStoreTests, MappedObjectSurvivesInvalidation)
+{
+    ASSERT_THAT (store->storeObject("pkg", "/mod1", toSpan("hello, world!")), tempo_test::IsOk());
+    auto bytes = map("/mod1");
+    ASSERT_NE (nullptr, bytes);
+
+    ASSERT_THAT (store->invalidateObject("pkg", "/mod1"), tempo_test::IsOk());
+    ASSERT_EQ (nullptr, map("/mod1"));
+    ASSERT_EQ ("hello, world!", bytes->getStringView());
+}
+
+TEST_F(AssemblyStoreTests, ValidatePackageWithChangedStamp)
+{
+    auto validatePackageResult1 = store->validatePackage("pkg", "stamp1");
+    ASSERT_THAT (validatePackageResult1, tempo_test::IsResult());
+    ASSERT_FALSE (validatePackageResult1.getResult());
+    ASSERT_THAT (store->storeObject("pkg", "/mod1", toSpan("hello, world!")), tempo_test::IsOk());
+
+    auto validatePackageResult2 = store->validatePackage("pkg", "stamp1");
+    ASSERT_THAT (validatePackageResult2, tempo_test::IsResult());
+    ASSERT_TRUE (validatePackageResult2.getResult());
+    ASSERT_NE (nullptr, map("/mod1"));
+
+    auto validatePackageResult3 = store->validatePackage("pkg", "stamp2");
+    ASSERT_THAT (validatePackageResult3, tempo_test::IsResult());
+    ASSERT_FALSE (validatePackageResult3.getResult());
+    ASSERT_EQ (nullptr, map("/mod1"));
+}
+
+TEST_F(AssemblyStoreTests, TrimEvictsLeastRecentlyMappedObjects)
+{
+    ASSERT_THAT (store->storeObject("pkg", "/mod1", toSpan("0123456789")), tempo_test::IsOk());
+    ASSERT_THAT (store->storeObject("pkg", "/mod2", toSpan("0123456789")), tempo_test::IsOk());
+    ASSERT_THAT (store->storeObject("pkg", "/mod3", toSpan("0123456789")), tempo_test::IsOk());
+
+    // age every object file, then map mod1 so mod2 and mod3 are the least recently mapped
+    auto past = std::filesystem::file_time_type::clock::now() - std::chrono::minutes(10);
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(store->getStoreDirectory())) {
+        if (entry.is_regular_file()) {
+            std::filesystem::last_write_time(entry.path(), past);
+        }
+    }
+    ASSERT_NE (nullptr, map("/mod1"));
+
+    auto trimResult = store->trim(15);
+    ASSERT_THAT (trimResult, tempo_test::IsResult());
+    auto stats = trimResult.getResult();
+    ASSERT_EQ (1, stats.storedObjects);
+    ASSERT_EQ (10, stats.storedBytes);
+    ASSERT_EQ (2, stats.evictedObjects);
+    ASSERT_EQ (20, stats.evictedBytes);
+
+    ASSERT_NE (nullptr, map("/mod1"));
+    ASSERT_EQ (nullptr, map("/mod2"));
+    ASSERT_EQ (nullptr, map("/mod3"));
+}
@@ -95,3 +95,50 @@ TEST(AsyncProcessor, SendMessageAndReceiveMultipleMessagesAsync)
 
     uv_thread_join(&tid);
 }
+
+constexpr int kNumProducers = 4;
+constexpr int kMessagesPerProducer = 1000;
+
+static void many_messages_producer_thread(void *ptr)
+{
+    auto *processor = static_cast<chord_machine::AsyncProcessor<chord_machine::RunnerRequest> *>(ptr);
+    for (int i = 0; i < kMessagesPerProducer; i++) {
+        processor->sendMessage(new chord_machine::ResumeRunner());
+    }
+}
+
+static void coordinator_thread(void *ptr)
+{
+    auto *processor = static_cast<chord_machine::AsyncProcessor<chord_machine::RunnerRequest> *>(ptr);
+    uv_thread_t tids[kNumProducers];
+    for (auto &tid : tids) {
+        uv_thread_create(&tid, many_messages_producer_thread, processor);
+    }
+    for (auto &tid : tids) {
+        uv_thread_join(&tid);
+    }
+    processor->sendMessage(new chord_machine::TerminateRunner());
+}
+
+TEST(AsyncProcessor, SendMessagesFromMultipleProducers)
+{
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+
+    Context context;
+    chord_machine::AsyncProcessor processor(receive_messages_until_shutdown, &context);
+    processor.initialize(&loop);
+
+    uv_thread_t tid;
+    uv_thread_create(&tid, coordinator_thread, &processor);
+
+    processor.runUntilCancelled();
+
+    ASSERT_EQ (kNumProducers * kMessagesPerProducer + 1, context.messages.size());
+    for (int i = 0; i < kNumProducers * kMessagesPerProducer; i++) {
+        ASSERT_EQ (chord_machine::RunnerRequest::MessageType::Resume, context.messages.at(i)->type);
+    }
+    ASSERT_EQ (chord_machine::RunnerRequest::MessageType::Terminate, context.messages.back()->type);
+
+    uv_thread_join(&tid);
+}
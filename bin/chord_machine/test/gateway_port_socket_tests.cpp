@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_machine/gateway_port_socket.h>
+#include <lyric_bootstrap/bootstrap_loader.h>
+#include <lyric_runtime/interpreter_state.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/tempdir_maker.h>
+#include <zuri_distributor/package_cache_loader.h>
+
+/**
+ * Writer which captures the frames written to the gateway and the credit granted to it.
+ */
+class CapturingWriter : public chord_common::AbstractProtocolWriter {
+public:
+    tempo_utils::Status write(std::string_view message) override {
+        written.emplace_back(message);
+        return {};
+    }
+    tempo_utils::Status grantCredit(tu_uint32 credit) override {
+        granted += credit;
+        return {};
+    }
+    std::vector<std::string> written;
+    tu_uint32 granted = 0;
+};
+
+/**
+ * Serves a gateway stream with a port registered in the port multiplexer of an interpreter, the
+ * same way chord-machine serves a port declared with --gateway-port.
+ */
+class GatewayPortSocketTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> testDirectory;
+    uv_loop_t loop;
+    std::shared_ptr<lyric_runtime::InterpreterState> state;
+    std::shared_ptr<lyric_runtime::DuplexPort> port;
+
+    void SetUp() override {
+        testDirectory = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        ASSERT_EQ (0, uv_loop_init(&loop));
+
+        std::shared_ptr<zuri_distributor::PackageCache> packageCache;
+        TU_ASSIGN_OR_RAISE (packageCache, zuri_distributor::PackageCache::openOrCreate(
+            testDirectory->getTempdir(), "pkgcache"));
+
+        std::shared_ptr<zuri_packager::PackageReader> reader;
+        TU_ASSIGN_OR_RAISE (reader, zuri_packager::PackageReader::open(TEST1_ZPK));
+        TU_RAISE_IF_STATUS (packageCache->installPackage(reader));
+
+        zuri_packager::PackageSpecifier specifier;
+        TU_ASSIGN_OR_RAISE (specifier, reader->readPackageSpecifier());
+        lyric_common::ModuleLocation programMain;
+        TU_ASSIGN_OR_RAISE (programMain, reader->readProgramMain());
+
+        lyric_runtime::InterpreterStateOptions options;
+        options.mainLocation = lyric_common::ModuleLocation::fromUrl(
+            specifier.toUrl().resolve(programMain.getPath()));
+
+        auto systemLoader = std::make_shared<lyric_bootstrap::BootstrapLoader>();
+        auto applicationLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+        TU_ASSIGN_OR_RAISE (state, lyric_runtime::InterpreterState::create(
+            systemLoader, applicationLoader, options));
+
+        TU_ASSIGN_OR_RAISE (port, state->portMultiplexer()->registerPort(
+            tempo_utils::Url::fromString("dev.zuri.proto:gateway")));
+    }
+
+    void TearDown() override {
+        uv_run(&loop, UV_RUN_NOWAIT);
+        std::filesystem::remove_all(testDirectory->getTempdir());
+    }
+
+    static std::string request(tu_uint32 requestId, std::string_view body) {
+        chord_common::GatewayRequestFrame frame;
+        frame.requestId = requestId;
+        frame.method = "POST";
+        frame.target = "/";
+        frame.body = std::string(body);
+        auto bytes = chord_common::write_gateway_request(frame).getResult();
+        return std::string((const char *) bytes->getData(), bytes->getSize());
+    }
+
+    static std::string toString(std::shared_ptr<tempo_utils::ImmutableBytes> bytes) {
+        return std::string((const char *) bytes->getData(), bytes->getSize());
+    }
+
+    static std::shared_ptr<tempo_utils::ImmutableBytes> payload(std::string_view body) {
+        return std::const_pointer_cast<tempo_utils::MemoryBytes>(tempo_utils::MemoryBytes::copy(body));
+    }
+};
+
+TEST_F(GatewayPortSocketTests, ProgramAnswersRequestsInOrder)
+{
+    auto socket = std::make_shared<chord_machine::GatewayPortSocket>(port, &loop, 2);
+    ASSERT_THAT (socket->initialize(), tempo_test::IsOk());
+    CapturingWriter writer;
+    ASSERT_THAT (socket->attach(&writer), tempo_test::IsOk());
+    ASSERT_EQ (2u, writer.granted);
+
+    ASSERT_THAT (socket->handle(request(7, "ping")), tempo_test::IsOk());
+    ASSERT_THAT (socket->handle(request(8, "pong")), tempo_test::IsOk());
+
+    // the request bodies are delivered to the program through the port
+    uv_run(&loop, UV_RUN_NOWAIT);
+    ASSERT_TRUE (port->hasPending());
+    ASSERT_EQ ("ping", toString(port->nextPending()));
+    ASSERT_EQ ("pong", toString(port->nextPending()));
+
+    // each message the program writes answers the oldest request
+    port->send(payload("PING"));
+    port->send(payload("PONG"));
+    ASSERT_EQ (2u, writer.written.size());
+    ASSERT_EQ (4u, writer.granted);
+
+    chord_common::GatewayResponseFrame response;
+    ASSERT_THAT (chord_common::read_gateway_response(writer.written.at(0), response), tempo_test::IsOk());
+    ASSERT_EQ (7u, response.requestId);
+    ASSERT_EQ (200, response.statusCode);
+    ASSERT_EQ ("PING", response.body);
+    ASSERT_THAT (chord_common::read_gateway_response(writer.written.at(1), response), tempo_test::IsOk());
+    ASSERT_EQ (8u, response.requestId);
+    ASSERT_EQ ("PONG", response.body);
+
+    auto stats = socket->getStats();
+    ASSERT_EQ (2u, stats.requestsReceived);
+    ASSERT_EQ (2u, stats.requestsDelivered);
+    ASSERT_EQ (2u, stats.responsesSent);
+
+    ASSERT_THAT (socket->detach(), tempo_test::IsOk());
+}
+
+TEST_F(GatewayPortSocketTests, WriteWithoutRequestIsRejected)
+{
+    auto socket = std::make_shared<chord_machine::GatewayPortSocket>(port, &loop);
+    ASSERT_THAT (socket->initialize(), tempo_test::IsOk());
+    CapturingWriter writer;
+    ASSERT_THAT (socket->attach(&writer), tempo_test::IsOk());
+
+    ASSERT_TRUE (socket->write(payload("unsolicited")).notOk());
+    ASSERT_TRUE (writer.written.empty());
+    ASSERT_EQ (1u, socket->getStats().unsolicitedWrites);
+
+    ASSERT_THAT (socket->detach(), tempo_test::IsOk());
+}
+
+TEST_F(GatewayPortSocketTests, RequestBeyondWindowIsRejected)
+{
+    auto socket = std::make_shared<chord_machine::GatewayPortSocket>(port, &loop, 1);
+    ASSERT_THAT (socket->initialize(), tempo_test::IsOk());
+    CapturingWriter writer;
+    ASSERT_THAT (socket->attach(&writer), tempo_test::IsOk());
+    ASSERT_EQ (1u, writer.granted);
+
+    ASSERT_THAT (socket->handle(request(1, "first")), tempo_test::IsOk());
+    ASSERT_TRUE (socket->handle(request(2, "second")).notOk());
+    ASSERT_EQ (1u, socket->getStats().requestsRejected);
+
+    // answering the first request returns its credit
+    uv_run(&loop, UV_RUN_NOWAIT);
+    ASSERT_EQ ("first", toString(port->nextPending()));
+    port->send(payload("done"));
+    ASSERT_EQ (2u, writer.granted);
+    ASSERT_THAT (socket->handle(request(3, "third")), tempo_test::IsOk());
+
+    ASSERT_THAT (socket->detach(), tempo_test::IsOk());
+}
@@ -119,8 +119,8 @@ TEST_F(InitializeUtilsTests, MakeLocalMachine)
     bool startSuspended;
     std::shared_ptr<lyric_runtime::InterpreterState> interpreterState;
     chord_machine::AbstractMessageSender<chord_machine::RunnerReply> *processorPtr;
-    EXPECT_CALL (componentConstructor, createLocalMachine(_, _, _, _))
-        .WillOnce([&](const auto &machineUrl_, bool startSuspended_, auto &interpreterState_, auto *processorPtr_) -> auto {
+    EXPECT_CALL (componentConstructor, createLocalMachine(_, _, _, _, _))
+        .WillOnce([&](const auto &machineUrl_, bool startSuspended_, auto &interpreterState_, auto *processorPtr_, const auto &) -> auto {
             machineUrl = machineUrl_;
             startSuspended = startSuspended_;
             interpreterState = interpreterState_;
@@ -180,7 +180,7 @@ TEST_F(InitializeUtilsTests, MakeGrpcBinder)
     lyric_common::RuntimePolicy runtimePolicy;
     std::filesystem::path pemPrivateKeyFile;
     std::filesystem::path pemRootCABundleFile;
-    chord_remoting::RemotingService::CallbackService *remotingService;
+    grpc::Service *remotingService;
 
     MockComponentConstructor componentConstructor;
     EXPECT_CALL (componentConstructor, createGrpcBinder(_, _, _, _, _))
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_machine/local_machine.h>
+#include <lyric_bootstrap/bootstrap_loader.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/tempdir_maker.h>
+#include <zuri_distributor/package_cache_loader.h>
+
+/**
+ * Runs the spin program, which never completes, so the interpreter only stops when a request
+ * interrupts it at a safepoint.
+ */
+class InterpreterRunnerTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> testDirectory;
+    uv_loop_t loop;
+    chord_machine::AsyncQueue<chord_machine::RunnerReply> processor;
+    std::shared_ptr<lyric_runtime::InterpreterState> state;
+
+    void SetUp() override {
+        testDirectory = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        ASSERT_EQ (0, uv_loop_init(&loop));
+        ASSERT_THAT (processor.initialize(&loop), tempo_test::IsOk());
+
+        std::shared_ptr<zuri_distributor::PackageCache> packageCache;
+        TU_ASSIGN_OR_RAISE (packageCache, zuri_distributor::PackageCache::openOrCreate(
+            testDirectory->getTempdir(), "pkgcache"));
+
+        std::shared_ptr<zuri_packager::PackageReader> reader;
+        TU_ASSIGN_OR_RAISE (reader, zuri_packager::PackageReader::open(SPIN_ZPK));
+        TU_RAISE_IF_STATUS (packageCache->installPackage(reader));
+
+        zuri_packager::PackageSpecifier specifier;
+        TU_ASSIGN_OR_RAISE (specifier, reader->readPackageSpecifier());
+        lyric_common::ModuleLocation programMain;
+        TU_ASSIGN_OR_RAISE (programMain, reader->readProgramMain());
+
+        lyric_runtime::InterpreterStateOptions options;
+        options.mainLocation = lyric_common::ModuleLocation::fromUrl(
+            specifier.toUrl().resolve(programMain.getPath()));
+
+        auto systemLoader = std::make_shared<lyric_bootstrap::BootstrapLoader>();
+        auto applicationLoader = std::make_shared<zuri_distributor::PackageCacheLoader>(packageCache);
+        TU_ASSIGN_OR_RAISE (state, lyric_runtime::InterpreterState::create(
+            systemLoader, applicationLoader, options));
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDirectory->getTempdir());
+    }
+
+    /**
+     * Wait for the next reply which is not a Running reply, and return its type.
+     */
+    chord_machine::RunnerReply::MessageType waitForReply() {
+        for (;;) {
+            std::unique_ptr<chord_machine::RunnerReply> reply(processor.waitForMessage());
+            if (reply == nullptr)
+                continue;
+            if (reply->type != chord_machine::RunnerReply::MessageType::Running)
+                return reply->type;
+        }
+    }
+};
+
+TEST_F(InterpreterRunnerTests, SuspendInterruptsRunningInterpreter)
+{
+    chord_machine::InterpreterRunnerOptions runnerOptions;
+    runnerOptions.instructionBudget = 64;
+    auto machine = std::make_unique<chord_machine::LocalMachine>(
+        "spin", true, state, &processor, runnerOptions);
+
+    ASSERT_THAT (machine->resume(), tempo_test::IsOk());
+    std::unique_ptr<chord_machine::RunnerReply> running(processor.waitForMessage());
+    ASSERT_EQ (chord_machine::RunnerReply::MessageType::Running, running->type);
+
+    ASSERT_THAT (machine->suspend(), tempo_test::IsOk());
+    ASSERT_EQ (chord_machine::RunnerReply::MessageType::Suspended, waitForReply());
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::STOPPED, machine->getRunnerState());
+    ASSERT_LE (1, machine->getSafepointStats().interruptsDelivered);
+
+    machine.reset();
+    ASSERT_EQ (chord_machine::RunnerReply::MessageType::Cancelled, waitForReply());
+}
+
+TEST_F(InterpreterRunnerTests, SuspendArrivingDuringResumeIsNotLost)
+{
+    chord_machine::InterpreterRunnerOptions runnerOptions;
+    runnerOptions.instructionBudget = 64;
+    auto machine = std::make_unique<chord_machine::LocalMachine>(
+        "spin", true, state, &processor, runnerOptions);
+
+    // each suspend is sent while the runner is handling the preceding resume, so it arrives
+    // either before or after the runner checks for pending requests. in both cases the
+    // interpreter must stop, otherwise the spin program runs forever and no reply arrives.
+    for (int i = 0; i < 100; i++) {
+        ASSERT_THAT (machine->resume(), tempo_test::IsOk());
+        ASSERT_THAT (machine->suspend(), tempo_test::IsOk());
+        ASSERT_EQ (chord_machine::RunnerReply::MessageType::Suspended, waitForReply());
+    }
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::STOPPED, machine->getRunnerState());
+
+    machine.reset();
+    ASSERT_EQ (chord_machine::RunnerReply::MessageType::Cancelled, waitForReply());
+}
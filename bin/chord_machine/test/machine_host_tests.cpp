@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <absl/time/clock.h>
+
+#include <chord_machine/initialize_utils.h>
+#include <chord_machine/machine_host.h>
+#include <chord_machine/machine_result.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/tempdir_maker.h>
+
+/**
+ * Places the test1 program, which completes immediately, and the spin program, which never
+ * completes, in a machine host.
+ */
+class MachineHostTests : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> testDirectory;
+    chord_machine::SharedLoaders loaders;
+    zuri_packager::PackageSpecifier test1Specifier;
+    zuri_packager::PackageSpecifier spinSpecifier;
+
+    void SetUp() override {
+        testDirectory = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+
+        chord_machine::ChordLocalMachineConfig chordLocalMachineConfig;
+        chordLocalMachineConfig.runDirectory = testDirectory->getTempdir();
+        ASSERT_THAT (chord_machine::make_shared_loaders(loaders, chordLocalMachineConfig), tempo_test::IsOk());
+
+        // install the test packages into the run cache
+        std::shared_ptr<zuri_distributor::PackageCache> runCache;
+        TU_ASSIGN_OR_RAISE (runCache, zuri_distributor::PackageCache::openOrCreate(
+            testDirectory->getTempdir(), "cache"));
+
+        std::shared_ptr<zuri_packager::PackageReader> reader;
+        TU_ASSIGN_OR_RAISE (reader, zuri_packager::PackageReader::open(TEST1_ZPK));
+        TU_RAISE_IF_STATUS (runCache->installPackage(reader));
+        TU_ASSIGN_OR_RAISE (test1Specifier, reader->readPackageSpecifier());
+
+        TU_ASSIGN_OR_RAISE (reader, zuri_packager::PackageReader::open(SPIN_ZPK));
+        TU_RAISE_IF_STATUS (runCache->installPackage(reader));
+        TU_ASSIGN_OR_RAISE (spinSpecifier, reader->readPackageSpecifier());
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDirectory->getTempdir());
+    }
+
+    static bool waitForState(
+        std::shared_ptr<chord_machine::LocalMachine> machine,
+        chord_machine::InterpreterRunnerState state)
+    {
+        auto deadline = absl::Now() + absl::Seconds(10);
+        while (absl::Now() < deadline) {
+            if (machine->getRunnerState() == state)
+                return true;
+            absl::SleepFor(absl::Milliseconds(10));
+        }
+        return false;
+    }
+};
+
+TEST_F(MachineHostTests, PlacedMachineRunsToCompletion)
+{
+    chord_machine::MachineHost host(loaders);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    auto createMachineResult = host.createMachine("test1", test1Specifier, {}, false);
+    ASSERT_THAT (createMachineResult, tempo_test::IsResult());
+    auto machine = createMachineResult.getResult();
+
+    ASSERT_TRUE (waitForState(machine, chord_machine::InterpreterRunnerState::SHUTDOWN));
+    ASSERT_EQ (machine, host.getMachine("test1"));
+    ASSERT_EQ (1, host.numMachines());
+}
+
+TEST_F(MachineHostTests, DuplicateMachineNameIsRejected)
+{
+    chord_machine::MachineHost host(loaders);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    ASSERT_THAT (host.createMachine("machine", spinSpecifier, {}, true), tempo_test::IsResult());
+    auto createMachineResult = host.createMachine("machine", test1Specifier, {}, false);
+    ASSERT_TRUE (createMachineResult.isStatus());
+    ASSERT_TRUE (createMachineResult.getStatus().matchesCondition(
+        chord_machine::MachineCondition::kInvalidConfiguration));
+    ASSERT_EQ (1, host.numMachines());
+}
+
+TEST_F(MachineHostTests, SuspendedMachineDoesNotHoldWorker)
+{
+    chord_machine::MachineHostOptions options;
+    options.numWorkers = 1;
+    chord_machine::MachineHost host(loaders, options);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    std::shared_ptr<chord_machine::LocalMachine> spin;
+    TU_ASSIGN_OR_RAISE (spin, host.createMachine("spin", spinSpecifier, {}, true));
+    std::shared_ptr<chord_machine::LocalMachine> test1;
+    TU_ASSIGN_OR_RAISE (test1, host.createMachine("test1", test1Specifier, {}, false));
+
+    // the only worker is free because the suspended machine has no work
+    ASSERT_TRUE (waitForState(test1, chord_machine::InterpreterRunnerState::SHUTDOWN));
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::INITIAL, spin->getRunnerState());
+}
+
+TEST_F(MachineHostTests, RunningMachineYieldsWorker)
+{
+    chord_machine::MachineHostOptions options;
+    options.numWorkers = 1;
+    options.runnerOptions.instructionBudget = 64;
+    chord_machine::MachineHost host(loaders, options);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    std::shared_ptr<chord_machine::LocalMachine> spin;
+    TU_ASSIGN_OR_RAISE (spin, host.createMachine("spin", spinSpecifier, {}, false));
+    ASSERT_TRUE (waitForState(spin, chord_machine::InterpreterRunnerState::RUNNING));
+
+    // the spin program never completes, so test1 only runs if spin yields the only worker
+    std::shared_ptr<chord_machine::LocalMachine> test1;
+    TU_ASSIGN_OR_RAISE (test1, host.createMachine("test1", test1Specifier, {}, false));
+    ASSERT_TRUE (waitForState(test1, chord_machine::InterpreterRunnerState::SHUTDOWN));
+    ASSERT_LE (1, spin->getSafepointStats().yields);
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::RUNNING, spin->getRunnerState());
+
+    ASSERT_THAT (host.shutdown(), tempo_test::IsOk());
+    ASSERT_TRUE (spin->isFinished());
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::SHUTDOWN, spin->getRunnerState());
+}
+
+TEST_F(MachineHostTests, MachineStartsOnceExpectedPortIsAttached)
+{
+    chord_machine::MachineHost host(loaders);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    auto protocolUrl = tempo_utils::Url::fromString("dev.zuri.proto:test");
+    std::shared_ptr<chord_machine::LocalMachine> machine;
+    TU_ASSIGN_OR_RAISE (machine, host.createMachine("test1", test1Specifier, {protocolUrl}, false));
+    ASSERT_TRUE (host.getProtocolHandler("test1", protocolUrl) != nullptr);
+    ASSERT_TRUE (host.getProtocolHandler("test1", tempo_utils::Url::fromString("dev.zuri.proto:other")) == nullptr);
+
+    absl::SleepFor(absl::Milliseconds(100));
+    ASSERT_EQ (chord_machine::InterpreterRunnerState::INITIAL, machine->getRunnerState());
+
+    ASSERT_THAT (host.notifyProtocolAttached("test1", protocolUrl), tempo_test::IsOk());
+    ASSERT_TRUE (waitForState(machine, chord_machine::InterpreterRunnerState::SHUTDOWN));
+}
+
+TEST_F(MachineHostTests, FinishedMachinesAreReaped)
+{
+    chord_machine::MachineHost host(loaders);
+    ASSERT_THAT (host.initialize(), tempo_test::IsOk());
+
+    std::shared_ptr<chord_machine::LocalMachine> machine;
+    TU_ASSIGN_OR_RAISE (machine, host.createMachine("test1", test1Specifier, {}, false));
+    ASSERT_TRUE (waitForState(machine, chord_machine::InterpreterRunnerState::SHUTDOWN));
+    ASSERT_EQ (0, host.reapMachines());
+
+    ASSERT_THAT (machine->terminate(), tempo_test::IsOk());
+    auto deadline = absl::Now() + absl::Seconds(10);
+    while (!machine->isFinished() && absl::Now() < deadline) {
+        absl::SleepFor(absl::Milliseconds(10));
+    }
+    ASSERT_TRUE (machine->isFinished());
+    ASSERT_EQ (1, host.reapMachines());
+    ASSERT_EQ (0, host.numMachines());
+    ASSERT_FALSE (host.hasMachine("test1"));
+}
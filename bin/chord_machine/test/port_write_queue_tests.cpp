@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_machine/machine_result.h>
+#include <chord_machine/port_write_queue.h>
+#include <tempo_test/status_matchers.h>
+#include <tempo_utils/memory_bytes.h>
+
+/**
+ * Writer which accepts writes until it is congested, the same way a Communicate stream rejects
+ * writes above its high watermark until it drains.
+ */
+class CongestingWriter : public chord_common::AbstractProtocolWriter {
+public:
+    tempo_utils::Status write(std::string_view message) override {
+        if (congested)
+            return chord_machine::MachineStatus::forCondition(
+                chord_machine::MachineCondition::kWriteCongested, "congested");
+        written.emplace_back(message);
+        return {};
+    }
+    tempo_utils::Status grantCredit(tu_uint32 credit) override {
+        granted += credit;
+        return {};
+    }
+    bool congested = false;
+    std::vector<std::string> written;
+    tu_uint32 granted = 0;
+};
+
+static std::shared_ptr<const tempo_utils::ImmutableBytes>
+payload(std::string_view message)
+{
+    return tempo_utils::MemoryBytes::copy(message);
+}
+
+TEST(PortWriteQueue, WritesThroughWhileWritable)
+{
+    CongestingWriter writer;
+    chord_machine::PortWriteQueue queue;
+    queue.attach(&writer);
+
+    ASSERT_THAT (queue.write(payload("one")), tempo_test::IsOk());
+    ASSERT_THAT (queue.write(payload("two")), tempo_test::IsOk());
+    ASSERT_THAT (writer.written, testing::ElementsAre("one", "two"));
+    ASSERT_EQ (0, queue.getParkedBytes());
+}
+
+TEST(PortWriteQueue, ParksWritesUntilWriterIsWritable)
+{
+    CongestingWriter writer;
+    chord_machine::PortWriteQueue queue;
+    queue.attach(&writer);
+
+    ASSERT_THAT (queue.write(payload("one")), tempo_test::IsOk());
+    writer.congested = true;
+    ASSERT_THAT (queue.write(payload("two")), tempo_test::IsOk());
+    writer.congested = false;
+
+    // earlier messages are still parked, so this message is parked behind them
+    ASSERT_THAT (queue.write(payload("three")), tempo_test::IsOk());
+    ASSERT_THAT (writer.written, testing::ElementsAre("one"));
+    ASSERT_EQ (8, queue.getParkedBytes());
+
+    queue.writable(true);
+    ASSERT_THAT (writer.written, testing::ElementsAre("one", "two", "three"));
+    ASSERT_EQ (0, queue.getParkedBytes());
+
+    auto stats = queue.getStats();
+    ASSERT_EQ (2, stats.messagesParked);
+    ASSERT_EQ (2, stats.messagesResumed);
+}
+
+TEST(PortWriteQueue, StopsResumingWhenWriterIsCongestedAgain)
+{
+    CongestingWriter writer;
+    chord_machine::PortWriteQueue queue;
+    queue.attach(&writer);
+
+    writer.congested = true;
+    ASSERT_THAT (queue.write(payload("one")), tempo_test::IsOk());
+    ASSERT_THAT (queue.write(payload("two")), tempo_test::IsOk());
+
+    // the writer is still congested, so nothing is written and the order is kept
+    queue.writable(true);
+    ASSERT_TRUE (writer.written.empty());
+    ASSERT_EQ (6, queue.getParkedBytes());
+
+    writer.congested = false;
+    queue.writable(true);
+    ASSERT_THAT (writer.written, testing::ElementsAre("one", "two"));
+}
+
+TEST(PortWriteQueue, RejectsWriteWithCongestionWhenFull)
+{
+    CongestingWriter writer;
+    chord_machine::PortWriteQueue queue(4);
+    queue.attach(&writer);
+
+    writer.congested = true;
+    ASSERT_THAT (queue.write(payload("four")), tempo_test::IsOk());
+    auto status = queue.write(payload("five"));
+    ASSERT_TRUE (chord_machine::is_write_congested(status));
+    ASSERT_EQ (1, queue.getStats().messagesRejected);
+
+    // credit grants are never parked
+    ASSERT_THAT (queue.grantCredit(3), tempo_test::IsOk());
+    ASSERT_EQ (3, writer.granted);
+}
+
+TEST(PortWriteQueue, DetachDiscardsParkedWrites)
+{
+    CongestingWriter writer;
+    chord_machine::PortWriteQueue queue;
+    queue.attach(&writer);
+
+    writer.congested = true;
+    ASSERT_THAT (queue.write(payload("one")), tempo_test::IsOk());
+    queue.detach();
+    ASSERT_EQ (0, queue.getParkedBytes());
+    ASSERT_TRUE (queue.write(payload("two")).notOk());
+    ASSERT_FALSE (chord_machine::is_write_congested(queue.write(payload("two"))));
+}
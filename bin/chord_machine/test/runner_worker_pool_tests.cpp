@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <absl/synchronization/notification.h>
+
+#include <chord_machine/runner_worker_pool.h>
+#include <tempo_test/status_matchers.h>
+
+TEST(RunnerWorkerPool, RunSubmittedTasks)
+{
+    chord_machine::RunnerWorkerPool pool(2);
+    ASSERT_THAT (pool.initialize(), tempo_test::IsOk());
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 16; i++) {
+        ASSERT_THAT (pool.submit([&count] { count++; }), tempo_test::IsOk());
+    }
+
+    // shutdown waits for queued tasks to complete
+    ASSERT_THAT (pool.shutdown(), tempo_test::IsOk());
+    ASSERT_EQ (16, count.load());
+}
+
+TEST(RunnerWorkerPool, TasksWaitForFreeWorker)
+{
+    chord_machine::RunnerWorkerPool pool(1);
+    ASSERT_THAT (pool.initialize(), tempo_test::IsOk());
+
+    absl::Notification started;
+    absl::Notification release;
+    absl::Notification second;
+
+    ASSERT_THAT (pool.submit([&] { started.Notify(); release.WaitForNotification(); }), tempo_test::IsOk());
+    ASSERT_THAT (pool.submit([&] { second.Notify(); }), tempo_test::IsOk());
+
+    ASSERT_TRUE (started.WaitForNotificationWithTimeout(absl::Seconds(5)));
+    ASSERT_FALSE (second.WaitForNotificationWithTimeout(absl::Milliseconds(100)));
+    ASSERT_EQ (1, pool.numActive());
+    ASSERT_EQ (1, pool.numQueued());
+
+    release.Notify();
+    ASSERT_TRUE (second.WaitForNotificationWithTimeout(absl::Seconds(5)));
+    ASSERT_THAT (pool.shutdown(), tempo_test::IsOk());
+}
+
+TEST(RunnerWorkerPool, SubmitFailsAfterShutdown)
+{
+    chord_machine::RunnerWorkerPool pool(1);
+    ASSERT_THAT (pool.initialize(), tempo_test::IsOk());
+    ASSERT_THAT (pool.shutdown(), tempo_test::IsOk());
+    ASSERT_TRUE (pool.submit([] {}).notOk());
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_machine/safepoint_inspector.h>
+#include <lyric_runtime/bytecode_interpreter.h>
+#include <tempo_test/status_matchers.h>
+
+TEST(SafepointInspector, NoInterruptWhenNotRequested)
+{
+    chord_machine::SafepointInspector inspector(4);
+    lyric_object::OpCell op;
+
+    for (int i = 0; i < 16; i++) {
+        ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    }
+    ASSERT_FALSE (inspector.takeInterrupted());
+
+    auto stats = inspector.getStats();
+    ASSERT_EQ (4, stats.safepointsReached);
+    ASSERT_EQ (0, stats.interruptsDelivered);
+}
+
+TEST(SafepointInspector, InterruptIsDeliveredAtNextSafepoint)
+{
+    chord_machine::SafepointInspector inspector(4);
+    lyric_object::OpCell op;
+
+    ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    inspector.requestInterrupt();
+    ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+
+    auto status = inspector.beforeOp(op, nullptr, nullptr);
+    ASSERT_TRUE (status.matchesCondition(lyric_runtime::InterpreterCondition::kInterrupted));
+    ASSERT_TRUE (inspector.takeInterrupted());
+    ASSERT_FALSE (inspector.takeInterrupted());
+
+    // the interrupt is consumed, so the next safepoint does not interrupt
+    for (int i = 0; i < 4; i++) {
+        ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    }
+
+    auto stats = inspector.getStats();
+    ASSERT_EQ (2, stats.safepointsReached);
+    ASSERT_EQ (1, stats.interruptsDelivered);
+    ASSERT_LE (stats.lastInterruptLatency, stats.maxInterruptLatency);
+}
+
+TEST(SafepointInspector, ClearDiscardsPendingInterrupt)
+{
+    chord_machine::SafepointInspector inspector(1);
+    lyric_object::OpCell op;
+
+    inspector.requestInterrupt();
+    inspector.clearInterrupt();
+    ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    ASSERT_FALSE (inspector.takeInterrupted());
+}
+
+TEST(SafepointInspector, YieldsAtSafepointWhenAnotherRunnerWaits)
+{
+    bool waiting = false;
+    chord_machine::SafepointInspector inspector(2, [&waiting] { return waiting; });
+    lyric_object::OpCell op;
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    }
+
+    waiting = true;
+    ASSERT_THAT (inspector.beforeOp(op, nullptr, nullptr), tempo_test::IsOk());
+    auto status = inspector.beforeOp(op, nullptr, nullptr);
+    ASSERT_TRUE (status.matchesCondition(lyric_runtime::InterpreterCondition::kInterrupted));
+    ASSERT_TRUE (inspector.takeYielded());
+    ASSERT_FALSE (inspector.takeYielded());
+    ASSERT_FALSE (inspector.takeInterrupted());
+
+    auto stats = inspector.getStats();
+    ASSERT_EQ (1, stats.yields);
+    ASSERT_EQ (0, stats.interruptsDelivered);
+}
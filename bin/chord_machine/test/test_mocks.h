@@ -254,7 +254,8 @@ public:
             const tempo_utils::Url &machineUrl,
             bool startSuspended,
             std::shared_ptr<lyric_runtime::InterpreterState> &interpreterState,
-            chord_machine::AbstractMessageSender<chord_machine::RunnerReply> *processor),
+            chord_machine::AbstractMessageSender<chord_machine::RunnerReply> *processor,
+            const chord_machine::InterpreterRunnerOptions &runnerOptions),
         (const, override));
 
     MOCK_METHOD (
@@ -276,7 +277,8 @@ public:
         createRemotingService, (
             bool startSuspended,
             std::shared_ptr<chord_machine::LocalMachine> localMachine,
-            uv_async_t *initComplete),
+            uv_async_t *initComplete,
+            chord_machine::MachineHost *machineHost),
         (const, override));
 
     MOCK_METHOD (
@@ -286,7 +288,7 @@ public:
             const lyric_common::RuntimePolicy &runtimePolicy,
             const std::filesystem::path &pemPrivateKeyFile,
             const std::filesystem::path &pemRootCABundleFile,
-            chord_remoting::RemotingService::CallbackService *remotingService),
+            grpc::Service *remotingService),
         (const, override));
 };
 
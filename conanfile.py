@@ -14,12 +14,14 @@ class Chord(ConanFile):
         'enable_sanitizer': [True, False, None],
         'sanitizer': ['address', 'thread', 'memory', 'ub', 'leak', None],
         'enable_profiler': [True, False, None],
+        'enable_benchmarks': [True, False, None],
         }
     default_options = {
         'runtime_distribution_root': None,
         'enable_sanitizer': None,
         'sanitizer': None,
         'enable_profiler': None,
+        'enable_benchmarks': None,
         }
 
     exports = ('meta/*',)
@@ -53,6 +55,10 @@ class Chord(ConanFile):
         'uv/1.51.0@timbre',
         )
 
+    def requirements(self):
+        if self.options.enable_benchmarks:
+            self.requires('benchmark/1.9.4')
+
     def _get_meta(self, key):
         return load(self, join(self.recipe_folder, "meta", key))
 
@@ -83,6 +89,8 @@ class Chord(ConanFile):
             tc.cache_variables['SANITIZER'] = self.options.sanitizer
         if self.options.enable_profiler:
             tc.cache_variables['ENABLE_PROFILER'] = self.options.enable_profiler
+        if self.options.enable_benchmarks:
+            tc.cache_variables['ENABLE_BENCHMARKS'] = self.options.enable_benchmarks
 
         tc.generate()
         deps = CMakeDeps(self)
@@ -15,6 +15,14 @@ namespace chord_common {
         virtual tempo_utils::Status send(std::string_view message) = 0;
         virtual tempo_utils::Status handle(std::string_view message) = 0;
         virtual tempo_utils::Status detach() = 0;
+
+        /**
+         * Invoked by the writer with false when the bytes queued for writing rise above its high
+         * watermark, and with true when they subsequently drain below its low watermark. Writes
+         * made while the writer is not writable may fail, so a handler which must not lose messages
+         * holds them until the writer is writable again.
+         */
+        virtual void writable(bool) {}
     };
 }
 
@@ -3,15 +3,38 @@
 
 #include <absl/strings/string_view.h>
 
+#include <tempo_utils/immutable_bytes.h>
 #include <tempo_utils/status.h>
 
 namespace chord_common {
 
+    /**
+     * Name of the message header which carries flow control credit. A message carrying the header
+     * grants the receiver permission to send the specified number of additional messages.
+     */
+    constexpr const char *kProtocolCreditHeader = "x-chord-credit";
+
     class AbstractProtocolWriter {
     public:
         virtual ~AbstractProtocolWriter() = default;
 
         virtual tempo_utils::Status write(std::string_view message) = 0;
+
+        /**
+         * Write the message payload. Writers which can hold a reference to the payload instead of
+         * copying it should override this method, the default implementation copies the payload.
+         */
+        virtual tempo_utils::Status write(std::shared_ptr<const tempo_utils::ImmutableBytes> payload) {
+            return write(std::string_view((const char *) payload->getData(), payload->getSize()));
+        }
+
+        /**
+         * Grant the remote end credit to send the specified number of additional messages. Writers
+         * which do not support flow control ignore the grant.
+         */
+        virtual tempo_utils::Status grantCredit(tu_uint32 credit) {
+            return {};
+        }
     };
 }
 
@@ -0,0 +1,87 @@
+#ifndef CHORD_COMMON_ASSEMBLY_STORE_H
+#define CHORD_COMMON_ASSEMBLY_STORE_H
+
+#include <filesystem>
+#include <span>
+
+#include <tempo_utils/immutable_bytes.h>
+#include <tempo_utils/integer_types.h>
+#include <tempo_utils/result.h>
+
+namespace chord_common {
+
+    constexpr const char *kAssemblyStoreObjectExtension = ".lyo";
+    constexpr const char *kAssemblyStoreStampFileName = "stamp";
+
+    struct AssemblyStoreStats {
+        tu_uint32 storedObjects = 0;
+        tu_uint64 storedBytes = 0;
+        tu_uint32 evictedObjects = 0;
+        tu_uint64 evictedBytes = 0;
+    };
+
+    /**
+     * Object bytes which are backed by a read-only private mapping of a stored object file. The
+     * mapping remains valid after the file is unlinked or replaced, so a mapped object is never
+     * affected by invalidation or eviction.
+     */
+    class MappedBytes : public tempo_utils::ImmutableBytes {
+    public:
+        ~MappedBytes() override;
+
+        static tempo_utils::Result<std::shared_ptr<const MappedBytes>> map(const std::filesystem::path &path);
+
+        const tu_uint8 *getData() const override;
+        tu_uint32 getSize() const override;
+
+    private:
+        void *m_addr;
+        tu_uint32 m_size;
+
+        MappedBytes(void *addr, tu_uint32 size);
+    };
+
+    /**
+     * Directory of verified assembly objects which is shared by every machine on an agent. The agent
+     * owns the store and bounds its size, machines map stored objects instead of reading and
+     * verifying them from the package archive, and publish the objects they had to load.
+     *
+     * Objects are grouped by package key, and addressed within a package by object key. Package and
+     * object keys are hashed to form the file names, so the keys may contain any characters. Each
+     * object file is written once to a temporary file and atomically renamed into place, and is
+     * never modified afterwards, so concurrent readers and writers in separate processes do not
+     * need to coordinate. The modification time of an object file is updated each time it is
+     * mapped, and trimming the store evicts the objects with the oldest modification time first.
+     */
+    class AssemblyStore {
+    public:
+        static tempo_utils::Result<std::shared_ptr<AssemblyStore>> openOrCreate(
+            const std::filesystem::path &storeDirectory);
+
+        std::filesystem::path getStoreDirectory() const;
+
+        tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>> mapObject(
+            std::string_view packageKey,
+            std::string_view objectKey) const;
+        tempo_utils::Status storeObject(
+            std::string_view packageKey,
+            std::string_view objectKey,
+            std::span<const tu_uint8> bytes);
+
+        tempo_utils::Result<bool> validatePackage(std::string_view packageKey, std::string_view stamp);
+        tempo_utils::Status invalidateObject(std::string_view packageKey, std::string_view objectKey);
+        tempo_utils::Status invalidatePackage(std::string_view packageKey);
+
+        tempo_utils::Result<AssemblyStoreStats> trim(tu_uint64 maxStoredBytes);
+
+    private:
+        std::filesystem::path m_storeDirectory;
+
+        explicit AssemblyStore(const std::filesystem::path &storeDirectory);
+
+        std::filesystem::path packagePath(std::string_view packageKey) const;
+        std::filesystem::path objectPath(std::string_view packageKey, std::string_view objectKey) const;
+    };
+}
+
+#endif // CHORD_COMMON_ASSEMBLY_STORE_H
@@ -0,0 +1,81 @@
+#ifndef CHORD_COMMON_GATEWAY_PROTOCOL_H
+#define CHORD_COMMON_GATEWAY_PROTOCOL_H
+
+#include <functional>
+#include <string>
+
+#include <tempo_utils/immutable_bytes.h>
+#include <tempo_utils/integer_types.h>
+#include <tempo_utils/result.h>
+
+#include "abstract_protocol_handler.h"
+
+namespace chord_common {
+
+    constexpr tu_uint32 kDefaultGatewayWindow = 64;
+
+    /**
+     * A request sent by the gateway to a machine port. The frame is carried in the data of a
+     * Communicate message and is encoded as the big-endian request id, followed by the 16-bit
+     * lengths of the method, target and content type, followed by those fields and then the body.
+     */
+    struct GatewayRequestFrame {
+        tu_uint32 requestId = 0;
+        std::string method = {};
+        std::string target = {};
+        std::string contentType = {};
+        std::string body = {};
+    };
+
+    /**
+     * A response sent by a machine port to the gateway. The frame is encoded as the big-endian
+     * request id, the 16-bit status code and the 16-bit content type length, followed by the
+     * content type and then the body.
+     */
+    struct GatewayResponseFrame {
+        tu_uint32 requestId = 0;
+        tu_uint16 statusCode = 0;
+        std::string contentType = {};
+        std::string body = {};
+    };
+
+    tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>>
+    write_gateway_request(const GatewayRequestFrame &frame);
+
+    tempo_utils::Status read_gateway_request(std::string_view data, GatewayRequestFrame &frame);
+
+    tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>>
+    write_gateway_response(const GatewayResponseFrame &frame);
+
+    tempo_utils::Status read_gateway_response(std::string_view data, GatewayResponseFrame &frame);
+
+    /**
+     * Callback which serves a gateway request. The request id of the returned response is
+     * ignored, the handler always answers with the id of the request.
+     */
+    using GatewayRequestCallback = std::function<GatewayResponseFrame(const GatewayRequestFrame &)>;
+
+    /**
+     * Protocol handler for the port end of a gateway stream. Each request frame is passed to the
+     * callback and the response is written back on the same stream. The gateway is granted
+     * credit for a window of requests when the handler is attached, and the credit for each
+     * request is returned once its response has been written.
+     */
+    class GatewayPortHandler : public AbstractProtocolHandler {
+    public:
+        explicit GatewayPortHandler(GatewayRequestCallback callback, tu_uint32 window = kDefaultGatewayWindow);
+
+        bool isAttached() override;
+        tempo_utils::Status attach(AbstractProtocolWriter *writer) override;
+        tempo_utils::Status send(std::string_view message) override;
+        tempo_utils::Status handle(std::string_view message) override;
+        tempo_utils::Status detach() override;
+
+    private:
+        GatewayRequestCallback m_callback;
+        tu_uint32 m_window;
+        AbstractProtocolWriter *m_writer;
+    };
+}
+
+#endif // CHORD_COMMON_GATEWAY_PROTOCOL_H
@@ -0,0 +1,389 @@
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <chord_common/assembly_store.h>
+#include <tempo_utils/log_stream.h>
+#include <tempo_utils/posix_result.h>
+
+/**
+ * Returns the 64-bit FNV-1a hash of the key formatted as 16 hex digits. The hash must be stable
+ * across processes and builds because it names files which are shared between processes.
+ */
+static std::string
+hash_key(std::string_view key)
+{
+    tu_uint64 hash = 14695981039346656037ull;
+    for (auto c : key) {
+        hash ^= static_cast<tu_uint8>(c);
+        hash *= 1099511628211ull;
+    }
+    static const char *digits = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        hex[i] = digits[hash & 0xf];
+        hash >>= 4;
+    }
+    return hex;
+}
+
+/**
+ * Write the bytes to a temporary file in the same directory as the path and atomically rename
+ * the temporary file to the path, so readers only ever see a complete file.
+ */
+static tempo_utils::Status
+publish_file(const std::filesystem::path &path, std::span<const tu_uint8> bytes)
+{
+    auto tmpPath = path.parent_path() / ("." + path.filename().string() + ".XXXXXX");
+    auto tmpTemplate = tmpPath.string();
+    int fd = mkstemp(tmpTemplate.data());
+    if (fd < 0)
+        return tempo_utils::PosixStatus::last("failed to create temporary object file");
+
+    auto *ptr = bytes.data();
+    auto remaining = bytes.size();
+    while (remaining > 0) {
+        auto ret = write(fd, ptr, remaining);
+        if (ret < 0) {
+            auto status = tempo_utils::PosixStatus::last("failed to write temporary object file");
+            close(fd);
+            unlink(tmpTemplate.c_str());
+            return status;
+        }
+        ptr += ret;
+        remaining -= ret;
+    }
+    close(fd);
+
+    if (rename(tmpTemplate.c_str(), path.c_str()) < 0) {
+        auto status = tempo_utils::PosixStatus::last("failed to rename temporary object file");
+        unlink(tmpTemplate.c_str());
+        return status;
+    }
+    return {};
+}
+
+chord_common::MappedBytes::MappedBytes(void *addr, tu_uint32 size)
+    : m_addr(addr),
+      m_size(size)
+{
+    TU_ASSERT (m_addr != nullptr);
+}
+
+chord_common::MappedBytes::~MappedBytes()
+{
+    munmap(m_addr, m_size);
+}
+
+/**
+ * Map the file at the specified path read-only.
+ *
+ * @param path The path of the file to map.
+ * @return The mapped bytes, or nullptr if the file does not exist or is empty.
+ */
+tempo_utils::Result<std::shared_ptr<const chord_common::MappedBytes>>
+chord_common::MappedBytes::map(const std::filesystem::path &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT)
+            return std::shared_ptr<const MappedBytes>{};
+        return tempo_utils::PosixStatus::last("failed to open object file");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        auto status = tempo_utils::PosixStatus::last("failed to stat object file");
+        close(fd);
+        return status;
+    }
+    if (st.st_size == 0 || st.st_size > std::numeric_limits<tu_uint32>::max()) {
+        close(fd);
+        return std::shared_ptr<const MappedBytes>{};
+    }
+
+    auto size = static_cast<tu_uint32>(st.st_size);
+    auto *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return tempo_utils::PosixStatus::last("failed to map object file");
+
+    return std::shared_ptr<const MappedBytes>(new MappedBytes(addr, size));
+}
+
+const tu_uint8 *
+chord_common::MappedBytes::getData() const
+{
+    return static_cast<const tu_uint8 *>(m_addr);
+}
+
+tu_uint32
+chord_common::MappedBytes::getSize() const
+{
+    return m_size;
+}
+
+chord_common::AssemblyStore::AssemblyStore(const std::filesystem::path &storeDirectory)
+    : m_storeDirectory(storeDirectory)
+{
+}
+
+/**
+ * Open the assembly store in the specified directory, creating the directory if it does not exist.
+ *
+ * @param storeDirectory The store directory.
+ * @return The assembly store.
+ */
+tempo_utils::Result<std::shared_ptr<chord_common::AssemblyStore>>
+chord_common::AssemblyStore::openOrCreate(const std::filesystem::path &storeDirectory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(storeDirectory, ec);
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to create assembly store {}: {}", storeDirectory.string(), ec.message());
+    return std::shared_ptr<AssemblyStore>(new AssemblyStore(storeDirectory));
+}
+
+std::filesystem::path
+chord_common::AssemblyStore::getStoreDirectory() const
+{
+    return m_storeDirectory;
+}
+
+std::filesystem::path
+chord_common::AssemblyStore::packagePath(std::string_view packageKey) const
+{
+    return m_storeDirectory / hash_key(packageKey);
+}
+
+std::filesystem::path
+chord_common::AssemblyStore::objectPath(std::string_view packageKey, std::string_view objectKey) const
+{
+    return packagePath(packageKey) / (hash_key(objectKey) + kAssemblyStoreObjectExtension);
+}
+
+/**
+ * Map the stored object. On a hit the modification time of the object file is updated so the
+ * object is evicted last when the store is trimmed.
+ *
+ * @param packageKey The package key.
+ * @param objectKey The object key.
+ * @return The object bytes, or nullptr if the object is not stored.
+ */
+tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>>
+chord_common::AssemblyStore::mapObject(std::string_view packageKey, std::string_view objectKey) const
+{
+    auto path = objectPath(packageKey, objectKey);
+    std::shared_ptr<const MappedBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, MappedBytes::map(path));
+    if (bytes != nullptr) {
+        // failing to touch the file only affects the eviction order
+        utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    }
+    return std::shared_ptr<const tempo_utils::ImmutableBytes>(bytes);
+}
+
+/**
+ * Store the object. The caller must have verified the object bytes. If another process stores
+ * the same object concurrently then one of the identical files replaces the other.
+ *
+ * @param packageKey The package key.
+ * @param objectKey The object key.
+ * @param bytes The verified object bytes.
+ * @return Ok status if the object was stored, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_common::AssemblyStore::storeObject(
+    std::string_view packageKey,
+    std::string_view objectKey,
+    std::span<const tu_uint8> bytes)
+{
+    auto path = objectPath(packageKey, objectKey);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to create assembly store package directory: {}", ec.message());
+    return publish_file(path, bytes);
+}
+
+/**
+ * Check that the stored objects for the package were stored from the package archive identified
+ * by the stamp. If the package was stored from a different archive (for example, the package was
+ * reinstalled with the same specifier) then the package is invalidated and the new stamp is
+ * recorded.
+ *
+ * @param packageKey The package key.
+ * @param stamp Identifies the package archive.
+ * @return true if the stored objects are valid, false if the package was invalidated.
+ */
+tempo_utils::Result<bool>
+chord_common::AssemblyStore::validatePackage(std::string_view packageKey, std::string_view stamp)
+{
+    auto stampPath = packagePath(packageKey) / kAssemblyStoreStampFileName;
+
+    std::string currStamp;
+    {
+        std::ifstream in(stampPath, std::ios::binary);
+        if (in.is_open()) {
+            currStamp.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+    }
+    if (currStamp == stamp)
+        return true;
+
+    TU_LOG_V << "invalidating stored package " << packageKey;
+    TU_RETURN_IF_NOT_OK (invalidatePackage(packageKey));
+
+    std::error_code ec;
+    std::filesystem::create_directories(stampPath.parent_path(), ec);
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to create assembly store package directory: {}", ec.message());
+    TU_RETURN_IF_NOT_OK (publish_file(stampPath, std::span((const tu_uint8 *) stamp.data(), stamp.size())));
+    return false;
+}
+
+/**
+ * Remove the stored object. Processes which have already mapped the object are not affected.
+ *
+ * @param packageKey The package key.
+ * @param objectKey The object key.
+ * @return Ok status if the object was removed or was not stored, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_common::AssemblyStore::invalidateObject(std::string_view packageKey, std::string_view objectKey)
+{
+    auto path = objectPath(packageKey, objectKey);
+    if (unlink(path.c_str()) < 0 && errno != ENOENT)
+        return tempo_utils::PosixStatus::last("failed to remove object file");
+    return {};
+}
+
+/**
+ * Remove all stored objects for the package. Processes which have already mapped an object from
+ * the package are not affected.
+ *
+ * @param packageKey The package key.
+ * @return Ok status if the package was removed or was not stored, otherwise notOk status.
+ */
+tempo_utils::Status
+chord_common::AssemblyStore::invalidatePackage(std::string_view packageKey)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(packagePath(packageKey), ec);
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to remove assembly store package directory: {}", ec.message());
+    return {};
+}
+
+/**
+ * Evict the least recently mapped objects until the total size of the stored objects does not
+ * exceed the specified limit. Temporary files which were abandoned by a failed writer are removed
+ * as well, as are package directories which no longer contain any objects.
+ *
+ * @param maxStoredBytes The maximum total size of the stored objects.
+ * @return The store stats after trimming.
+ */
+tempo_utils::Result<chord_common::AssemblyStoreStats>
+chord_common::AssemblyStore::trim(tu_uint64 maxStoredBytes)
+{
+    struct StoredObject {
+        std::filesystem::path path;
+        std::filesystem::file_time_type mtime;
+        tu_uint64 size;
+    };
+
+    AssemblyStoreStats stats;
+    std::vector<StoredObject> objects;
+    std::vector<std::filesystem::path> packages;
+    auto abandonedBefore = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+
+    // iterate with increment(ec), other machines may remove entries while the store is scanned
+    std::error_code ec;
+    std::filesystem::directory_iterator packageIterator(m_storeDirectory, ec);
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to scan assembly store {}: {}", m_storeDirectory.string(), ec.message());
+
+    for (; packageIterator != std::filesystem::directory_iterator(); packageIterator.increment(ec)) {
+        std::error_code entryEc;
+        if (!packageIterator->is_directory(entryEc))
+            continue;
+        packages.push_back(packageIterator->path());
+
+        // a package which cannot be scanned is skipped, it may have been removed concurrently
+        std::filesystem::directory_iterator objectIterator(packageIterator->path(), entryEc);
+        for (; !entryEc && objectIterator != std::filesystem::directory_iterator();
+            objectIterator.increment(entryEc)) {
+            std::error_code objectEc;
+            if (!objectIterator->is_regular_file(objectEc))
+                continue;
+            const auto &path = objectIterator->path();
+            auto mtime = objectIterator->last_write_time(objectEc);
+            if (objectEc)
+                continue;
+            auto filename = path.filename().string();
+            if (filename.starts_with(".")) {
+                if (mtime < abandonedBefore) {
+                    std::filesystem::remove(path, objectEc);
+                }
+                continue;
+            }
+            if (path.extension() != kAssemblyStoreObjectExtension)
+                continue;
+            auto size = objectIterator->file_size(objectEc);
+            if (objectEc)
+                continue;
+            objects.push_back(StoredObject{path, mtime, size});
+            stats.storedObjects++;
+            stats.storedBytes += size;
+        }
+    }
+
+    // a failed increment leaves the iterator at the end, so the error is checked after the loop
+    if (ec)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "failed to scan assembly store {}: {}", m_storeDirectory.string(), ec.message());
+
+    // evict the least recently mapped objects first
+    std::sort(objects.begin(), objects.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.mtime < rhs.mtime;
+    });
+    for (auto iterator = objects.cbegin();
+        iterator != objects.cend() && stats.storedBytes > maxStoredBytes; iterator++) {
+        if (!std::filesystem::remove(iterator->path, ec))
+            continue;
+        stats.storedObjects--;
+        stats.storedBytes -= iterator->size;
+        stats.evictedObjects++;
+        stats.evictedBytes += iterator->size;
+    }
+
+    // remove package directories which contain nothing except the stamp
+    for (const auto &package : packages) {
+        ec.clear();
+        bool empty = true;
+        std::filesystem::directory_iterator iterator(package, ec);
+        for (; !ec && iterator != std::filesystem::directory_iterator(); iterator.increment(ec)) {
+            if (iterator->path().filename() != kAssemblyStoreStampFileName) {
+                empty = false;
+                break;
+            }
+        }
+        if (empty && !ec) {
+            std::filesystem::remove_all(package, ec);
+        }
+    }
+
+    return stats;
+}
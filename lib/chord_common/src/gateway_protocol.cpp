@@ -0,0 +1,178 @@
+
+#include <limits>
+
+#include <chord_common/gateway_protocol.h>
+#include <tempo_utils/big_endian.h>
+#include <tempo_utils/bytes_appender.h>
+
+static std::span<const tu_uint8>
+to_span(std::string_view s)
+{
+    return std::span((const tu_uint8 *) s.data(), s.size());
+}
+
+static bool
+fits_u16(std::string_view s)
+{
+    return s.size() <= std::numeric_limits<tu_uint16>::max();
+}
+
+/**
+ * Read a length-prefixed field from the frame. The length has already been read from the fixed
+ * size frame header.
+ */
+static bool
+read_field(const tu_uint8 *&ptr, const tu_uint8 *end, tu_uint16 length, std::string &field)
+{
+    if (end - ptr < length)
+        return false;
+    field.assign((const char *) ptr, length);
+    ptr += length;
+    return true;
+}
+
+tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>>
+chord_common::write_gateway_request(const GatewayRequestFrame &frame)
+{
+    if (!fits_u16(frame.method) || !fits_u16(frame.target) || !fits_u16(frame.contentType))
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway request field is too large");
+
+    tempo_utils::BytesAppender appender;
+    appender.appendU32(frame.requestId);
+    appender.appendU16(frame.method.size());
+    appender.appendU16(frame.target.size());
+    appender.appendU16(frame.contentType.size());
+    appender.appendBytes(to_span(frame.method));
+    appender.appendBytes(to_span(frame.target));
+    appender.appendBytes(to_span(frame.contentType));
+    appender.appendBytes(to_span(frame.body));
+    return appender.finish();
+}
+
+tempo_utils::Status
+chord_common::read_gateway_request(std::string_view data, GatewayRequestFrame &frame)
+{
+    constexpr ptrdiff_t kHeaderSize = 4 + 2 + 2 + 2;
+    auto *ptr = (const tu_uint8 *) data.data();
+    auto *end = ptr + data.size();
+    if (end - ptr < kHeaderSize)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway request frame is truncated");
+
+    frame.requestId = tempo_utils::read_u32_and_advance(ptr);
+    auto methodSize = tempo_utils::read_u16_and_advance(ptr);
+    auto targetSize = tempo_utils::read_u16_and_advance(ptr);
+    auto contentTypeSize = tempo_utils::read_u16_and_advance(ptr);
+    if (!read_field(ptr, end, methodSize, frame.method)
+        || !read_field(ptr, end, targetSize, frame.target)
+        || !read_field(ptr, end, contentTypeSize, frame.contentType))
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway request frame is truncated");
+    frame.body.assign((const char *) ptr, end - ptr);
+    return {};
+}
+
+tempo_utils::Result<std::shared_ptr<const tempo_utils::ImmutableBytes>>
+chord_common::write_gateway_response(const GatewayResponseFrame &frame)
+{
+    if (!fits_u16(frame.contentType))
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway response field is too large");
+
+    tempo_utils::BytesAppender appender;
+    appender.appendU32(frame.requestId);
+    appender.appendU16(frame.statusCode);
+    appender.appendU16(frame.contentType.size());
+    appender.appendBytes(to_span(frame.contentType));
+    appender.appendBytes(to_span(frame.body));
+    return appender.finish();
+}
+
+tempo_utils::Status
+chord_common::read_gateway_response(std::string_view data, GatewayResponseFrame &frame)
+{
+    constexpr ptrdiff_t kHeaderSize = 4 + 2 + 2;
+    auto *ptr = (const tu_uint8 *) data.data();
+    auto *end = ptr + data.size();
+    if (end - ptr < kHeaderSize)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway response frame is truncated");
+
+    frame.requestId = tempo_utils::read_u32_and_advance(ptr);
+    frame.statusCode = tempo_utils::read_u16_and_advance(ptr);
+    auto contentTypeSize = tempo_utils::read_u16_and_advance(ptr);
+    if (!read_field(ptr, end, contentTypeSize, frame.contentType))
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway response frame is truncated");
+    frame.body.assign((const char *) ptr, end - ptr);
+    return {};
+}
+
+chord_common::GatewayPortHandler::GatewayPortHandler(GatewayRequestCallback callback, tu_uint32 window)
+    : m_callback(std::move(callback)),
+      m_window(window),
+      m_writer(nullptr)
+{
+    TU_ASSERT (m_callback != nullptr);
+    TU_ASSERT (m_window > 0);
+}
+
+bool
+chord_common::GatewayPortHandler::isAttached()
+{
+    return m_writer != nullptr;
+}
+
+tempo_utils::Status
+chord_common::GatewayPortHandler::attach(AbstractProtocolWriter *writer)
+{
+    if (m_writer != nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway port handler is already attached");
+    m_writer = writer;
+    return m_writer->grantCredit(m_window);
+}
+
+tempo_utils::Status
+chord_common::GatewayPortHandler::send(std::string_view message)
+{
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway port handler is not attached");
+    return m_writer->write(message);
+}
+
+/**
+ * Serve a request frame from the gateway and write the response. A request which cannot be
+ * decoded has no request id to answer, so it is dropped, but its credit is still returned.
+ */
+tempo_utils::Status
+chord_common::GatewayPortHandler::handle(std::string_view message)
+{
+    if (m_writer == nullptr)
+        return tempo_utils::GenericStatus::forCondition(tempo_utils::GenericCondition::kInternalViolation,
+            "gateway port handler is not attached");
+
+    GatewayRequestFrame request;
+    auto status = read_gateway_request(message, request);
+    if (status.notOk()) {
+        TU_RETURN_IF_NOT_OK (m_writer->grantCredit(1));
+        return status;
+    }
+
+    auto response = m_callback(request);
+    response.requestId = request.requestId;
+
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, write_gateway_response(response));
+    TU_RETURN_IF_NOT_OK (m_writer->write(bytes));
+    return m_writer->grantCredit(1);
+}
+
+tempo_utils::Status
+chord_common::GatewayPortHandler::detach()
+{
+    m_writer = nullptr;
+    return {};
+}
@@ -0,0 +1,37 @@
+
+#include <benchmark/benchmark.h>
+
+#include <tempo_utils/log_stream.h>
+
+#include "mesh_bench_utils.h"
+
+int
+main(int argc, char **argv)
+{
+    tempo_utils::LoggingConfiguration loggingConfig;
+    loggingConfig.severityFilter = tempo_utils::SeverityFilter::kWarningsAndErrors;
+    tempo_utils::init_logging(loggingConfig);
+
+    // default to JSON output so results can be compared across runs
+    std::vector<char *> args(argv, argv + argc);
+    bool hasFormat = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view(argv[i]).starts_with("--benchmark_format")) {
+            hasFormat = true;
+        }
+    }
+    std::string jsonFormat = "--benchmark_format=json";
+    if (!hasFormat) {
+        args.push_back(jsonFormat.data());
+    }
+    int numArgs = static_cast<int>(args.size());
+
+    benchmark::Initialize(&numArgs, args.data());
+    if (benchmark::ReportUnrecognizedArguments(numArgs, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    cleanup_bench_keys();
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <chord_mesh/noise.h>
+
+#include "mesh_bench_utils.h"
+
+struct CipherPair {
+    std::shared_ptr<chord_mesh::Cipher> initiator;
+    std::shared_ptr<chord_mesh::Cipher> responder;
+};
+
+static CipherPair
+perform_handshake(const chord_mesh::CipherOptions &options = {})
+{
+    auto &keys = get_bench_keys();
+
+    std::shared_ptr<chord_mesh::Handshake> initiatorHandshake;
+    TU_ASSIGN_OR_RAISE (initiatorHandshake, chord_mesh::Handshake::forInitiator(chord_mesh::kDefaultNoiseProtocol,
+        keys.initiatorKeypair.privateKey, keys.responderKeypair.publicKey));
+
+    std::shared_ptr<chord_mesh::Handshake> responderHandshake;
+    TU_ASSIGN_OR_RAISE (responderHandshake, chord_mesh::Handshake::forResponder(chord_mesh::kDefaultNoiseProtocol,
+        keys.responderKeypair.privateKey, keys.initiatorKeypair.publicKey));
+
+    TU_RAISE_IF_NOT_OK (initiatorHandshake->start());
+    TU_RAISE_IF_NOT_OK (responderHandshake->start());
+
+    while (initiatorHandshake->getHandshakeState() == chord_mesh::HandshakeState::Waiting
+        || responderHandshake->getHandshakeState() == chord_mesh::HandshakeState::Waiting) {
+        while (initiatorHandshake->hasOutgoing()) {
+            auto outgoing = initiatorHandshake->popOutgoing();
+            TU_RAISE_IF_NOT_OK (responderHandshake->process(outgoing->getData(), outgoing->getSize()));
+        }
+        while (responderHandshake->hasOutgoing()) {
+            auto outgoing = responderHandshake->popOutgoing();
+            TU_RAISE_IF_NOT_OK (initiatorHandshake->process(outgoing->getData(), outgoing->getSize()));
+        }
+    }
+
+    CipherPair pair;
+    TU_ASSIGN_OR_RAISE (pair.initiator, initiatorHandshake->finish(options));
+    TU_ASSIGN_OR_RAISE (pair.responder, responderHandshake->finish(options));
+    return pair;
+}
+
+static void
+Handshake_NoiseKK(benchmark::State &state)
+{
+    get_bench_keys();
+
+    for (auto _ : state) {
+        auto pair = perform_handshake();
+        benchmark::DoNotOptimize(pair);
+    }
+}
+BENCHMARK(Handshake_NoiseKK)->Unit(benchmark::kMicrosecond);
+
+static void
+Cipher_Encrypt(benchmark::State &state)
+{
+    auto pair = perform_handshake();
+    auto payload = make_payload(state.range(0));
+
+    for (auto _ : state) {
+        TU_RAISE_IF_NOT_OK (pair.initiator->encryptOutput(chord_mesh::ArrayBuf::allocate(payload->getSpan())));
+        while (pair.initiator->hasOutput()) {
+            chord_mesh::free_stream_buf(pair.initiator->popOutput());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Cipher_Encrypt)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void
+Cipher_Decrypt(benchmark::State &state)
+{
+    auto pair = perform_handshake();
+    auto payload = make_payload(state.range(0));
+
+    for (auto _ : state) {
+        // encrypting is excluded from the measurement, only decrypting is timed
+        state.PauseTiming();
+        TU_RAISE_IF_NOT_OK (pair.initiator->encryptOutput(chord_mesh::ArrayBuf::allocate(payload->getSpan())));
+        std::vector<chord_mesh::StreamBuf *> frames;
+        while (pair.initiator->hasOutput()) {
+            frames.push_back(pair.initiator->popOutput());
+        }
+        state.ResumeTiming();
+
+        for (auto *frame : frames) {
+            auto span = frame->getSpan();
+            TU_RAISE_IF_NOT_OK (pair.responder->decryptInput(span.data(), span.size()));
+        }
+        while (pair.responder->hasInput()) {
+            benchmark::DoNotOptimize(pair.responder->popInput());
+        }
+
+        state.PauseTiming();
+        for (auto *frame : frames) {
+            chord_mesh::free_stream_buf(frame);
+        }
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Cipher_Decrypt)->RangeMultiplier(16)->Range(64, 1 << 20);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <chord_mesh/envelope.h>
+
+#include "mesh_bench_utils.h"
+
+static void
+EnvelopeBuilder_Unsigned(benchmark::State &state)
+{
+    auto payload = make_payload(state.range(0));
+
+    for (auto _ : state) {
+        chord_mesh::EnvelopeBuilder builder;
+        builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+        builder.setPayload(payload);
+        auto bytes = builder.toBytes().orElseThrow();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(EnvelopeBuilder_Unsigned)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void
+EnvelopeBuilder_Signed(benchmark::State &state)
+{
+    auto &keys = get_bench_keys();
+    auto payload = make_payload(state.range(0));
+
+    for (auto _ : state) {
+        chord_mesh::EnvelopeBuilder builder;
+        builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+        builder.setPayload(payload);
+        builder.setPrivateKey(keys.privateKey);
+        auto bytes = builder.toBytes().orElseThrow();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(EnvelopeBuilder_Signed)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void
+parse_envelopes(
+    benchmark::State &state,
+    std::shared_ptr<tempo_security::PrivateKey> privateKey,
+    std::shared_ptr<tempo_security::X509Certificate> certificate,
+    bool zeroCopy)
+{
+    chord_mesh::EnvelopeBuilder builder;
+    builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+    builder.setPayload(make_payload(state.range(0)));
+    builder.setPrivateKey(privateKey);
+    auto bytes = builder.toBytes().orElseThrow();
+
+    chord_mesh::EnvelopeParserOptions options;
+    options.zeroCopy = zeroCopy;
+    chord_mesh::EnvelopeParser parser(options);
+    parser.setCertificate(certificate);
+
+    for (auto _ : state) {
+        TU_RAISE_IF_NOT_OK (parser.pushBytes(bytes->getSpan()));
+        bool ready;
+        TU_RAISE_IF_NOT_OK (parser.checkReady(ready));
+        TU_ASSERT (ready);
+        chord_mesh::Envelope envelope;
+        TU_RAISE_IF_NOT_OK (parser.takeReady(envelope));
+        benchmark::DoNotOptimize(envelope);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes->getSize());
+}
+
+static void
+EnvelopeParser_Unsigned(benchmark::State &state)
+{
+    parse_envelopes(state, {}, {}, false);
+}
+BENCHMARK(EnvelopeParser_Unsigned)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void
+EnvelopeParser_UnsignedZeroCopy(benchmark::State &state)
+{
+    parse_envelopes(state, {}, {}, true);
+}
+BENCHMARK(EnvelopeParser_UnsignedZeroCopy)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+static void
+EnvelopeParser_Signed(benchmark::State &state)
+{
+    auto &keys = get_bench_keys();
+    parse_envelopes(state, keys.privateKey, keys.certificate, false);
+}
+BENCHMARK(EnvelopeParser_Signed)->RangeMultiplier(16)->Range(64, 1 << 20);
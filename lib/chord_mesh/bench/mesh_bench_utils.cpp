@@ -0,0 +1,115 @@
+
+#include <absl/strings/str_cat.h>
+
+#include <tempo_security/ed25519_private_key_generator.h>
+#include <tempo_security/generate_utils.h>
+#include <tempo_utils/file_utilities.h>
+#include <tempo_utils/tempdir_maker.h>
+
+#include "mesh_bench_utils.h"
+
+static BenchKeys *bench_keys = nullptr;
+
+static BenchKeys *
+generate_bench_keys()
+{
+    auto *keys = new BenchKeys();
+
+    tempo_utils::TempdirMaker tempdirMaker(std::filesystem::temp_directory_path(), "chord_mesh_bench.XXXXXXXX");
+    TU_RAISE_IF_NOT_OK (tempdirMaker.getStatus());
+    keys->tempdir = tempdirMaker.getTempdir();
+
+    tempo_security::Ed25519PrivateKeyGenerator keygen;
+
+    keys->caKeypair = tempo_security::GenerateUtils::generate_self_signed_ca_key_pair(
+        keygen,
+        tempo_security::DigestId::None,
+        "bench_O",
+        "bench_OU",
+        "caKeyPair",
+        1,
+        std::chrono::seconds{3600},
+        1,
+        keys->tempdir,
+        tempo_utils::generate_name("bench_ca_key_XXXXXXXX")).orElseThrow();
+    TU_ASSERT (keys->caKeypair.isValid());
+
+    keys->streamKeypair = tempo_security::GenerateUtils::generate_key_pair(
+        keys->caKeypair,
+        keygen,
+        tempo_security::DigestId::None,
+        "bench_O",
+        "bench_OU",
+        "streamKeyPair",
+        1,
+        std::chrono::seconds{3600},
+        keys->tempdir,
+        tempo_utils::generate_name("bench_stream_key_XXXXXXXX")).orElseThrow();
+    TU_ASSERT (keys->streamKeypair.isValid());
+
+    tempo_security::X509StoreOptions options;
+    TU_ASSIGN_OR_RAISE (keys->trustStore, tempo_security::X509Store::loadTrustedCerts(
+        options, {keys->caKeypair.getPemCertificateFile()}));
+
+    TU_ASSIGN_OR_RAISE (keys->privateKey, tempo_security::PrivateKey::readFile(
+        keys->streamKeypair.getPemPrivateKeyFile()));
+    TU_ASSIGN_OR_RAISE (keys->certificate, tempo_security::X509Certificate::readFile(
+        keys->streamKeypair.getPemCertificateFile()));
+
+    TU_RAISE_IF_NOT_OK (chord_mesh::generate_static_key(keys->privateKey, keys->initiatorKeypair));
+    TU_RAISE_IF_NOT_OK (chord_mesh::generate_static_key(keys->privateKey, keys->responderKeypair));
+
+    return keys;
+}
+
+const BenchKeys &
+get_bench_keys()
+{
+    if (bench_keys == nullptr) {
+        bench_keys = generate_bench_keys();
+    }
+    return *bench_keys;
+}
+
+void
+cleanup_bench_keys()
+{
+    if (bench_keys == nullptr)
+        return;
+    std::error_code ec;
+    std::filesystem::remove_all(bench_keys->tempdir, ec);
+    delete bench_keys;
+    bench_keys = nullptr;
+}
+
+std::filesystem::path
+make_socket_path(std::string_view name)
+{
+    auto &keys = get_bench_keys();
+    return keys.tempdir / tempo_utils::generate_name(absl::StrCat(name, "-XXXXXXXX.sock"));
+}
+
+tu_uint16
+make_tcp_port()
+{
+    return (random() % 5000) + 30000;
+}
+
+std::shared_ptr<const tempo_utils::ImmutableBytes>
+make_payload(size_t size)
+{
+    std::string payload(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = 'a' + (i % 26);
+    }
+    return tempo_utils::MemoryBytes::copy(payload);
+}
+
+void
+drain_loop(uv_loop_t *loop, int maxIterations)
+{
+    for (int i = 0; i < maxIterations; i++) {
+        if (uv_run(loop, UV_RUN_NOWAIT) == 0)
+            return;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CHORD_MESH_MESH_BENCH_UTILS_H
+#define CHORD_MESH_MESH_BENCH_UTILS_H
+
+#include <uv.h>
+
+#include <chord_mesh/noise.h>
+#include <tempo_security/certificate_key_pair.h>
+#include <tempo_security/private_key.h>
+#include <tempo_security/x509_certificate.h>
+#include <tempo_security/x509_store.h>
+#include <tempo_utils/immutable_bytes.h>
+
+/**
+ * Key material shared by all benchmarks. The keys are generated once on first use, because
+ * generating certificates is far slower than anything being measured.
+ */
+struct BenchKeys {
+    std::filesystem::path tempdir;
+    tempo_security::CertificateKeyPair caKeypair;
+    tempo_security::CertificateKeyPair streamKeypair;
+    std::shared_ptr<tempo_security::X509Store> trustStore;
+    std::shared_ptr<tempo_security::PrivateKey> privateKey;
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    chord_mesh::StaticKeypair initiatorKeypair;
+    chord_mesh::StaticKeypair responderKeypair;
+};
+
+const BenchKeys &get_bench_keys();
+
+void cleanup_bench_keys();
+
+std::filesystem::path make_socket_path(std::string_view name);
+
+tu_uint16 make_tcp_port();
+
+std::shared_ptr<const tempo_utils::ImmutableBytes> make_payload(size_t size);
+
+/**
+ * Run the loop on the calling thread until the predicate returns true.
+ */
+template<class Predicate>
+void run_loop_until(uv_loop_t *loop, Predicate &&done)
+{
+    while (!done()) {
+        uv_run(loop, UV_RUN_ONCE);
+    }
+}
+
+/**
+ * Run the loop without blocking until there is no more pending work, or the iteration limit is
+ * reached. Used to let handles close after a benchmark shuts down its streams.
+ */
+void drain_loop(uv_loop_t *loop, int maxIterations = 100);
+
+#endif // CHORD_MESH_MESH_BENCH_UTILS_H
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <chord_mesh/message.h>
+#include <chord_mesh/rep_protocol.h>
+#include <chord_mesh/req_protocol.h>
+#include <chord_mesh/stream_acceptor.h>
+
+#include "bench_messages.capnp.h"
+#include "mesh_bench_utils.h"
+
+using BenchRequest = chord_mesh::Message<bench_generated::Request>;
+using BenchReply = chord_mesh::Message<bench_generated::Reply>;
+using BenchReqProtocol = chord_mesh::ReqProtocol<BenchRequest,BenchReply>;
+
+namespace {
+
+    class EchoRepProtocol : public chord_mesh::AbstractRepProtocol<BenchRequest,BenchReply> {
+    public:
+        tempo_utils::Status reply(
+            chord_mesh::AbstractCloseable *closeable,
+            const BenchRequest &request,
+            BenchReply &reply) override
+        {
+            reply.getRoot().setValue(request.getRoot().getValue());
+            return {};
+        }
+        tempo_utils::Status validate(std::string_view, std::shared_ptr<tempo_security::X509Certificate>) override {
+            return {};
+        }
+        void error(const tempo_utils::Status &) override {}
+        void cleanup() override {}
+    };
+
+    class EchoRepAcceptor : public chord_mesh::RepAcceptContext<BenchRequest,BenchReply> {
+    public:
+        std::unique_ptr<chord_mesh::AbstractRepProtocol<BenchRequest,BenchReply>> make() override {
+            return std::make_unique<EchoRepProtocol>();
+        }
+        void error(const tempo_utils::Status &) override {}
+        void cleanup() override {}
+    };
+
+    struct ReqData {
+        bool ready = false;
+        int numReplies = 0;
+        tempo_utils::Status status;
+    };
+
+    class BenchReqContext : public BenchReqProtocol::AbstractContext {
+    public:
+        explicit BenchReqContext(ReqData *data) : m_data(data) {}
+        void ready(BenchReqProtocol *protocol) override { m_data->ready = true; }
+        void receive(BenchReqProtocol *protocol, const BenchReply &message) override {}
+        void error(const tempo_utils::Status &status) override { m_data->status = status; }
+        void cleanup() override {}
+    private:
+        ReqData *m_data;
+    };
+}
+
+/**
+ * Measure the rate at which requests are completed over a unix socket. Each iteration sends a
+ * window of requests and runs the loop until every reply has been received, so with a window of
+ * one this measures the request latency, and with a larger window it measures pipelined throughput.
+ */
+static void
+ReqRep_RequestRate(benchmark::State &state)
+{
+    auto &keys = get_bench_keys();
+    auto window = static_cast<int>(state.range(0));
+    auto payloadSize = state.range(1);
+
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManager manager(&loop, keys.streamKeypair, keys.trustStore, managerOps);
+
+    auto location = chord_common::TransportLocation::forUnix("", make_socket_path("reqrep"));
+
+    chord_mesh::StreamAcceptorOptions acceptorOptions;
+    acceptorOptions.allowInsecure = true;
+    std::shared_ptr<chord_mesh::StreamAcceptor> acceptor;
+    TU_ASSIGN_OR_RAISE (acceptor, chord_mesh::StreamAcceptor::create(&manager, acceptorOptions));
+    TU_RAISE_IF_NOT_OK (acceptor->listenLocation(location, std::make_unique<EchoRepAcceptor>()));
+
+    chord_mesh::StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = true;
+    std::shared_ptr<chord_mesh::StreamConnector> connector;
+    TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager, connectorOptions));
+
+    ReqData data;
+    chord_mesh::ReqProtocolOptions reqOptions;
+    reqOptions.startInsecure = true;
+    reqOptions.maxInFlight = window;
+    std::shared_ptr<BenchReqProtocol> req;
+    TU_ASSIGN_OR_RAISE (req, BenchReqProtocol::create(
+        connector, std::make_unique<BenchReqContext>(&data), reqOptions));
+    TU_RAISE_IF_NOT_OK (req->connect(location));
+
+    run_loop_until(&loop, [&] { return data.ready || data.status.notOk(); });
+    TU_RAISE_IF_NOT_OK (data.status);
+
+    auto payload = make_payload(payloadSize);
+    auto onReply = [&data](const tempo_utils::Status &status, const BenchReply &reply) {
+        if (status.notOk()) {
+            data.status = status;
+        }
+        data.numReplies++;
+    };
+
+    for (auto _ : state) {
+        auto expected = data.numReplies + window;
+        for (int i = 0; i < window; i++) {
+            BenchRequest request;
+            request.getRoot().setValue(kj::arrayPtr(payload->getData(), payload->getSize()));
+            TU_RAISE_IF_STATUS (req->send(std::move(request), onReply));
+        }
+        run_loop_until(&loop, [&] { return data.numReplies == expected || data.status.notOk(); });
+        TU_RAISE_IF_NOT_OK (data.status);
+    }
+    state.SetItemsProcessed(state.iterations() * window);
+    state.SetBytesProcessed(state.iterations() * window * payloadSize);
+
+    req->shutdown();
+    acceptor->shutdown();
+    connector->shutdown();
+    drain_loop(&loop);
+}
+BENCHMARK(ReqRep_RequestRate)
+    ->ArgNames({"window", "payload"})
+    ->ArgsProduct({{1, 16, 64}, {64, 4096}})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <chord_mesh/stream_acceptor.h>
+#include <chord_mesh/stream_connector.h>
+
+#include "mesh_bench_utils.h"
+
+namespace {
+
+    struct EchoData {
+        std::shared_ptr<chord_mesh::Stream> acceptorStream;
+        std::shared_ptr<chord_mesh::Stream> connectorStream;
+        int numReceived = 0;
+        tempo_utils::Status status;
+    };
+
+    class EchoStreamContext : public chord_mesh::AbstractStreamContext {
+    public:
+        explicit EchoStreamContext(EchoData *data) : m_data(data) {}
+        tempo_utils::Status validate(std::string_view, std::shared_ptr<tempo_security::X509Certificate>) override {
+            return {};
+        }
+        void receive(const chord_mesh::Envelope &envelope) override {
+            auto status = m_data->acceptorStream->send(
+                chord_mesh::EnvelopeVersion::Version1, envelope.getPayload());
+            if (status.notOk()) {
+                m_data->status = status;
+            }
+        }
+        void error(const tempo_utils::Status &status) override { m_data->status = status; }
+        void cleanup() override {}
+    private:
+        EchoData *m_data;
+    };
+
+    class EchoAcceptContext : public chord_mesh::AbstractAcceptContext {
+    public:
+        explicit EchoAcceptContext(EchoData *data) : m_data(data) {}
+        void accept(std::shared_ptr<chord_mesh::Stream> stream) override {
+            TU_RAISE_IF_NOT_OK (stream->start(std::make_unique<EchoStreamContext>(m_data)));
+            m_data->acceptorStream = std::move(stream);
+        }
+        void error(const tempo_utils::Status &status) override { m_data->status = status; }
+        void cleanup() override {}
+    private:
+        EchoData *m_data;
+    };
+
+    class PingStreamContext : public chord_mesh::AbstractStreamContext {
+    public:
+        explicit PingStreamContext(EchoData *data) : m_data(data) {}
+        tempo_utils::Status validate(std::string_view, std::shared_ptr<tempo_security::X509Certificate>) override {
+            return {};
+        }
+        void receive(const chord_mesh::Envelope &envelope) override {
+            m_data->numReceived++;
+        }
+        void error(const tempo_utils::Status &status) override { m_data->status = status; }
+        void cleanup() override {}
+    private:
+        EchoData *m_data;
+    };
+
+    class PingConnectContext : public chord_mesh::AbstractConnectContext {
+    public:
+        explicit PingConnectContext(EchoData *data) : m_data(data) {}
+        void connect(std::shared_ptr<chord_mesh::Stream> stream) override {
+            TU_RAISE_IF_NOT_OK (stream->start(std::make_unique<PingStreamContext>(m_data)));
+            m_data->connectorStream = std::move(stream);
+        }
+        void error(const tempo_utils::Status &status) override { m_data->status = status; }
+        void cleanup() override {}
+    private:
+        EchoData *m_data;
+    };
+}
+
+/**
+ * Measure the round-trip latency of an envelope echoed back over an insecure stream. The loop
+ * runs on the benchmark thread, so each iteration is one send followed by running the loop until
+ * the echo arrives.
+ */
+static void
+echo_round_trip(benchmark::State &state, const chord_common::TransportLocation &location)
+{
+    auto &keys = get_bench_keys();
+
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManager manager(&loop, keys.streamKeypair, keys.trustStore, managerOps);
+
+    EchoData data;
+
+    chord_mesh::StreamAcceptorOptions acceptorOptions;
+    acceptorOptions.allowInsecure = true;
+    std::shared_ptr<chord_mesh::StreamAcceptor> acceptor;
+    TU_ASSIGN_OR_RAISE (acceptor, chord_mesh::StreamAcceptor::create(&manager, acceptorOptions));
+    TU_RAISE_IF_NOT_OK (acceptor->listenLocation(location, std::make_unique<EchoAcceptContext>(&data)));
+
+    chord_mesh::StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = true;
+    std::shared_ptr<chord_mesh::StreamConnector> connector;
+    TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager, connectorOptions));
+    std::shared_ptr<chord_mesh::Connect> connect;
+    TU_ASSIGN_OR_RAISE (connect, connector->connectLocation(location, std::make_unique<PingConnectContext>(&data)));
+
+    run_loop_until(&loop, [&] {
+        return (data.connectorStream != nullptr && data.acceptorStream != nullptr) || data.status.notOk();
+    });
+    TU_RAISE_IF_NOT_OK (data.status);
+
+    auto payload = make_payload(state.range(0));
+
+    for (auto _ : state) {
+        auto expected = data.numReceived + 1;
+        TU_RAISE_IF_NOT_OK (data.connectorStream->send(chord_mesh::EnvelopeVersion::Version1, payload));
+        run_loop_until(&loop, [&] { return data.numReceived == expected || data.status.notOk(); });
+        TU_RAISE_IF_NOT_OK (data.status);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+    state.SetItemsProcessed(state.iterations());
+
+    data.connectorStream->shutdown();
+    acceptor->shutdown();
+    connector->shutdown();
+    drain_loop(&loop);
+
+    data.connectorStream.reset();
+    data.acceptorStream.reset();
+}
+
+static void
+StreamEcho_Unix(benchmark::State &state)
+{
+    auto location = chord_common::TransportLocation::forUnix("", make_socket_path("echo"));
+    echo_round_trip(state, location);
+}
+BENCHMARK(StreamEcho_Unix)->RangeMultiplier(16)->Range(64, 1 << 16)->Unit(benchmark::kMicrosecond);
+
+static void
+StreamEcho_Tcp4(benchmark::State &state)
+{
+    auto location = chord_common::TransportLocation::forTcp4("", "127.0.0.1", make_tcp_port());
+    echo_round_trip(state, location);
+}
+BENCHMARK(StreamEcho_Tcp4)->RangeMultiplier(16)->Range(64, 1 << 16)->Unit(benchmark::kMicrosecond);
@@ -7,6 +7,8 @@
 #include <tempo_utils/immutable_bytes.h>
 #include <tempo_utils/result.h>
 
+#include "ring_buffer.h"
+
 namespace chord_mesh {
 
     constexpr tu_uint32 kEnvelopeVersionStream = 0xFF;
@@ -98,9 +100,21 @@ namespace chord_mesh {
         std::shared_ptr<tempo_security::PrivateKey> m_privateKey;
     };
 
+    struct EnvelopeParserOptions {
+        /**
+         * If true then the header and payload of a parsed envelope are slices which reference the
+         * receive buffer directly, otherwise they are copied out of the receive buffer.
+         */
+        bool zeroCopy = false;
+        /**
+         * The initial size of the receive buffer. The buffer grows as needed.
+         */
+        tu_uint32 bufferSize = kDefaultRingBufferSize;
+    };
+
     class EnvelopeParser {
     public:
-        EnvelopeParser();
+        explicit EnvelopeParser(const EnvelopeParserOptions &options = {});
 
         std::shared_ptr<tempo_security::X509Certificate> getCertificate() const;
         void setCertificate(std::shared_ptr<tempo_security::X509Certificate> certificate);
@@ -116,8 +130,9 @@ namespace chord_mesh {
         void reset();
 
     private:
+        EnvelopeParserOptions m_options;
         std::shared_ptr<tempo_security::X509Certificate> m_certificate;
-        std::unique_ptr<tempo_utils::BytesAppender> m_pending;
+        RingBuffer m_pending;
         bool m_ready;
         tu_uint8 m_envelopeVersion;
         tu_uint8 m_envelopeFlags;
@@ -125,6 +140,8 @@ namespace chord_mesh {
         tu_uint16 m_headerSize;
         tu_uint32 m_payloadSize;
         tu_uint8 m_digestSize;
+
+        void resetEnvelope();
     };
 }
 
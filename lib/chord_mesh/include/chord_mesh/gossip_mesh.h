@@ -0,0 +1,208 @@
+#ifndef CHORD_MESH_GOSSIP_MESH_H
+#define CHORD_MESH_GOSSIP_MESH_H
+
+#include <deque>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/random/random.h>
+
+#include <chord_common/transport_location.h>
+
+#include "abstract_mesh_network.h"
+#include "message.h"
+#include "stream.h"
+#include "stream_acceptor.h"
+#include "stream_connector.h"
+#include "chord_mesh/generated/ensemble_messages.capnp.h"
+
+namespace chord_mesh {
+
+    constexpr tu_uint32 kDefaultGossipMeshDegree = 6;
+    constexpr tu_uint32 kDefaultGossipMeshDegreeLow = 4;
+    constexpr tu_uint32 kDefaultGossipMeshDegreeHigh = 12;
+    constexpr tu_uint32 kDefaultGossipFanout = 6;
+    constexpr tu_uint32 kDefaultGossipHistoryLength = 5;
+    constexpr tu_uint32 kDefaultGossipLength = 3;
+    constexpr absl::Duration kDefaultGossipHeartbeatInterval = absl::Seconds(1);
+    constexpr absl::Duration kDefaultGossipSeenTtl = absl::Minutes(2);
+    constexpr absl::Duration kDefaultGossipPruneBackoff = absl::Minutes(1);
+
+    using EnsembleMessage = Message<generated::EnsembleMessage>;
+
+    class AbstractGossipContext {
+    public:
+        virtual ~AbstractGossipContext() = default;
+        virtual void join(std::string_view peerId) {}
+        virtual void leave(std::string_view peerId) {}
+        virtual void receive(const EnsembleMessage &message) = 0;
+        virtual void error(const tempo_utils::Status &status) = 0;
+        virtual void cleanup() = 0;
+    };
+
+    struct GossipMeshOptions {
+        /**
+         * The target number of peers in the eager push mesh. The heartbeat grafts peers when the
+         * mesh falls below meshDegreeLow and prunes peers when it rises above meshDegreeHigh.
+         */
+        tu_uint32 meshDegree = kDefaultGossipMeshDegree;
+        tu_uint32 meshDegreeLow = kDefaultGossipMeshDegreeLow;
+        tu_uint32 meshDegreeHigh = kDefaultGossipMeshDegreeHigh;
+        /**
+         * The number of peers outside the mesh which are sent IHave gossip on each heartbeat.
+         */
+        tu_uint32 gossipFanout = kDefaultGossipFanout;
+        /**
+         * The number of heartbeats a message is kept available for IWant requests.
+         */
+        tu_uint32 historyLength = kDefaultGossipHistoryLength;
+        /**
+         * The number of most recent heartbeats whose message ids are advertised in IHave gossip.
+         */
+        tu_uint32 gossipLength = kDefaultGossipLength;
+        absl::Duration heartbeatInterval = kDefaultGossipHeartbeatInterval;
+        /**
+         * How long a message id is remembered after it is first seen. A message which is received
+         * again within the ttl is dropped as a duplicate.
+         */
+        absl::Duration seenTtl = kDefaultGossipSeenTtl;
+        /**
+         * How long a pruned peer must wait before grafting again.
+         */
+        absl::Duration pruneBackoff = kDefaultGossipPruneBackoff;
+        bool allowInsecure = false;
+    };
+
+    struct GossipStats {
+        tu_uint64 published = 0;
+        tu_uint64 delivered = 0;
+        tu_uint64 duplicates = 0;
+        tu_uint64 eagerSends = 0;
+        tu_uint64 ihaveSends = 0;
+        tu_uint64 iwantSends = 0;
+        tu_uint64 repaired = 0;
+    };
+
+    /**
+     * Disseminates ensemble messages to every node of the network. Each node eagerly pushes new
+     * messages to a bounded-degree mesh of its peers, and lazily advertises the ids of recently
+     * seen messages to a few peers outside the mesh on each heartbeat, which request any messages
+     * they are missing. The cost of a broadcast at each node is therefore bounded by the mesh
+     * degree plus the gossip fanout, rather than by the number of peers.
+     *
+     * All methods must be invoked on the loop thread of the stream manager.
+     */
+    class GossipMesh
+        : public AbstractMeshNetwork<EnsembleMessage>,
+          public std::enable_shared_from_this<GossipMesh> {
+
+        struct Private{ explicit Private() = default; };
+
+    public:
+        GossipMesh(
+            StreamManager *manager,
+            std::unique_ptr<AbstractGossipContext> &&ctx,
+            const GossipMeshOptions &options,
+            Private);
+        ~GossipMesh() override;
+
+        static tempo_utils::Result<std::shared_ptr<GossipMesh>> create(
+            StreamManager *manager,
+            std::unique_ptr<AbstractGossipContext> &&ctx,
+            const GossipMeshOptions &options = {});
+
+        tempo_utils::Status listen(const chord_common::TransportLocation &location);
+        tempo_utils::Status addPeer(const chord_common::TransportLocation &location);
+
+        tempo_utils::Status send(const EnsembleMessage &message) override;
+        tempo_utils::Status broadcast(const EnsembleMessage &message) override;
+
+        tu_uint32 numPeers() const;
+        tu_uint32 numMeshPeers() const;
+        GossipStats getStats() const;
+
+        void heartbeat();
+        void shutdown();
+
+    private:
+        struct Peer {
+            std::string id;
+            std::shared_ptr<Stream> stream;
+            bool inMesh = false;
+            bool closed = false;
+            absl::Time backoffUntil = absl::InfinitePast();
+        };
+
+        class GossipStreamContext : public AbstractStreamContext {
+        public:
+            GossipStreamContext(std::weak_ptr<GossipMesh> mesh, std::string peerId);
+            void receive(const Envelope &envelope) override;
+            tempo_utils::Status validate(
+                std::string_view protocolName,
+                std::shared_ptr<tempo_security::X509Certificate> certificate) override;
+            void error(const tempo_utils::Status &status) override;
+            void cleanup() override;
+        private:
+            std::weak_ptr<GossipMesh> m_mesh;
+            std::string m_peerId;
+        };
+
+        class GossipAcceptContext : public AbstractAcceptContext {
+        public:
+            explicit GossipAcceptContext(std::weak_ptr<GossipMesh> mesh);
+            void accept(std::shared_ptr<Stream> stream) override;
+            void error(const tempo_utils::Status &status) override;
+            void cleanup() override;
+        private:
+            std::weak_ptr<GossipMesh> m_mesh;
+        };
+
+        class GossipConnectContext : public AbstractConnectContext {
+        public:
+            explicit GossipConnectContext(std::weak_ptr<GossipMesh> mesh);
+            void connect(std::shared_ptr<Stream> stream) override;
+            void error(const tempo_utils::Status &status) override;
+            void cleanup() override;
+        private:
+            std::weak_ptr<GossipMesh> m_mesh;
+        };
+
+        StreamManager *m_manager;
+        std::unique_ptr<AbstractGossipContext> m_ctx;
+        GossipMeshOptions m_options;
+        std::shared_ptr<StreamAcceptor> m_acceptor;
+        std::shared_ptr<StreamConnector> m_connector;
+        absl::flat_hash_map<std::string,std::unique_ptr<Peer>> m_peers;
+
+        // message ids which have been seen, and the order in which they expire
+        absl::flat_hash_map<std::string,absl::Time> m_seen;
+        std::deque<std::pair<absl::Time,std::string>> m_seenExpiry;
+
+        // messages available for IWant requests, bucketed by heartbeat with the newest first
+        absl::flat_hash_map<std::string,std::shared_ptr<const tempo_utils::ImmutableBytes>> m_messages;
+        std::deque<std::vector<std::string>> m_history;
+
+        uv_timer_t *m_timer;
+        absl::BitGen m_rand;
+        GossipStats m_stats;
+        bool m_shutdown;
+
+        void attachPeer(std::shared_ptr<Stream> stream);
+        void detachPeer(std::string_view peerId);
+        void receivePeer(std::string_view peerId, const Envelope &envelope);
+        void publish(
+            std::string_view messageId,
+            std::shared_ptr<const tempo_utils::ImmutableBytes> bytes,
+            std::string_view sourceId);
+        bool markSeen(std::string_view messageId);
+        tempo_utils::Status sendGraft(Peer *peer);
+        tempo_utils::Status sendPrune(Peer *peer);
+        tempo_utils::Status sendIHave(Peer *peer, const std::vector<std::string> &messageIds);
+        tempo_utils::Status sendIWant(Peer *peer, const std::vector<std::string> &messageIds);
+        tempo_utils::Status sendBytes(Peer *peer, std::shared_ptr<const tempo_utils::ImmutableBytes> bytes);
+        void emitError(const tempo_utils::Status &status);
+
+        friend void on_gossip_heartbeat(uv_timer_t *timer);
+    };
+}
+
+#endif // CHORD_MESH_GOSSIP_MESH_H
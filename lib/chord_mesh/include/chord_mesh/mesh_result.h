@@ -15,6 +15,9 @@ namespace chord_mesh {
 
     enum class MeshCondition {
         kMeshInvariant,
+        kRequestCancelled,
+        kRequestTimeout,
+        kTooManyRequests,
     };
 
 
@@ -98,6 +101,12 @@ namespace tempo_utils {
             switch (condition) {
                 case chord_mesh::MeshCondition::kMeshInvariant:
                     return tempo_utils::StatusCode::kInternal;
+                case chord_mesh::MeshCondition::kRequestCancelled:
+                    return tempo_utils::StatusCode::kCancelled;
+                case chord_mesh::MeshCondition::kRequestTimeout:
+                    return tempo_utils::StatusCode::kDeadlineExceeded;
+                case chord_mesh::MeshCondition::kTooManyRequests:
+                    return tempo_utils::StatusCode::kResourceExhausted;
                 default:
                     return tempo_utils::StatusCode::kUnknown;
             }
@@ -107,6 +116,12 @@ namespace tempo_utils {
             switch (condition) {
                 case chord_mesh::MeshCondition::kMeshInvariant:
                     return "Mesh invariant";
+                case chord_mesh::MeshCondition::kRequestCancelled:
+                    return "Request cancelled";
+                case chord_mesh::MeshCondition::kRequestTimeout:
+                    return "Request timeout";
+                case chord_mesh::MeshCondition::kTooManyRequests:
+                    return "Too many requests";
                 default:
                     return "INVALID";
             }
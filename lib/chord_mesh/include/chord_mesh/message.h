@@ -64,6 +64,11 @@ namespace chord_mesh {
             return m_inner->getRoot<T>();
         }
 
+        void setRoot(typename T::Reader root)
+        {
+            m_inner->setRoot(root);
+        }
+
         tempo_utils::Status parse(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
         {
             auto arrayPtr = kj::arrayPtr(payload->getData(), payload->getSize());
@@ -17,6 +17,26 @@ namespace chord_mesh {
 
     constexpr const char *kDefaultNoiseProtocol = "Noise_KK_25519_ChaChaPoly_BLAKE2s";
 
+    constexpr tu_uint32 kNoiseMaxMessageSize = 65535;
+    constexpr tu_uint32 kCipherMacSize = 16;
+    constexpr tu_uint32 kCipherFrameOverhead = 2 + kCipherMacSize;
+    constexpr tu_uint32 kMaxCipherSegmentSize = kNoiseMaxMessageSize - kCipherMacSize;
+    constexpr tu_uint32 kDefaultCipherSegmentSize = 4096;
+    constexpr tu_uint32 kDefaultCipherPoolMaxFree = 64;
+
+    struct CipherOptions {
+        /**
+         * The maximum number of plaintext bytes encrypted into a single ciphertext frame. Must be
+         * greater than zero and no larger than kMaxCipherSegmentSize.
+         */
+        tu_uint32 segmentSize = kDefaultCipherSegmentSize;
+        /**
+         * The pool from which ciphertext and plaintext buffers are allocated. If not specified then
+         * the cipher allocates its own pool.
+         */
+        std::shared_ptr<StreamBufPool> pool = {};
+    };
+
     struct StaticKeypair {
         std::vector<tu_uint8> publicKey;
         std::vector<tu_uint8> privateKey;
@@ -48,7 +68,7 @@ namespace chord_mesh {
 
         tempo_utils::Status start();
         tempo_utils::Status process(const tu_uint8 *data, size_t size);
-        tempo_utils::Result<std::shared_ptr<Cipher>> finish();
+        tempo_utils::Result<std::shared_ptr<Cipher>> finish(const CipherOptions &options = {});
 
         HandshakeState getHandshakeState() const;
 
@@ -92,6 +112,8 @@ namespace chord_mesh {
     public:
         virtual ~Cipher();
 
+        tu_uint32 getSegmentSize() const;
+
         tempo_utils::Status decryptInput(const tu_uint8 *data, size_t size);
         bool hasInput() const;
         std::shared_ptr<const tempo_utils::ImmutableBytes> popInput();
@@ -103,12 +125,20 @@ namespace chord_mesh {
     private:
         NoiseCipherState *m_send;
         NoiseCipherState *m_recv;
-        std::unique_ptr<tempo_utils::BytesAppender> m_pending;
+        tu_uint32 m_segmentSize;
+        std::shared_ptr<StreamBufPool> m_pool;
         std::queue<std::shared_ptr<const tempo_utils::ImmutableBytes>> m_input;
         std::queue<StreamBuf *> m_output;
 
+        // state of the ciphertext frame currently being received
+        tu_uint8 m_frameHeader[2];
+        tu_uint32 m_frameHeaderSize;
+        tu_uint32 m_frameSize;
+        tu_uint32 m_frameFill;
+        PooledBuf *m_frame;
+
         Cipher();
-        tempo_utils::Status initialize(NoiseHandshakeState *handshake);
+        tempo_utils::Status initialize(NoiseHandshakeState *handshake, const CipherOptions &options);
         friend class Handshake;
     };
 }
@@ -71,7 +71,8 @@ namespace chord_mesh {
                 return;
             }
             auto bytes = result.getResult();
-            status = m_stream->send(envelope.getVersion(), bytes);
+            // echo the request header so the requester can correlate the reply
+            status = m_stream->send(envelope.getVersion(), envelope.getHeader(), bytes, {});
             if (status.notOk()) {
                 error(status);
             }
@@ -1,6 +1,11 @@
 #ifndef CHORD_MESH_REQ_PROTOCOL_H
 #define CHORD_MESH_REQ_PROTOCOL_H
 
+#include <functional>
+#include <set>
+
+#include <absl/container/flat_hash_map.h>
+
 #include <chord_common/transport_location.h>
 
 #include "stream.h"
@@ -8,8 +13,27 @@
 
 namespace chord_mesh {
 
+    constexpr tu_uint32 kDefaultMaxInFlightRequests = 64;
+    constexpr absl::Duration kDefaultRequestTimeout = absl::Seconds(30);
+
+    /**
+     * Size of the envelope header which carries the request id. The replier echoes the header
+     * back verbatim, which lets the requester match each reply to its request.
+     */
+    constexpr tu_uint32 kRequestHeaderSize = 4;
+
     struct ReqProtocolOptions {
         bool startInsecure = false;
+        /**
+         * The maximum number of requests which may be awaiting a reply, including requests which
+         * are queued because the stream is not yet connected.
+         */
+        tu_uint32 maxInFlight = kDefaultMaxInFlightRequests;
+        /**
+         * The deadline applied to a request if none is specified when it is sent. A request which
+         * has not received a reply by its deadline fails with kRequestTimeout.
+         */
+        absl::Duration requestTimeout = kDefaultRequestTimeout;
         void *data = nullptr;
     };
 
@@ -19,15 +43,25 @@ namespace chord_mesh {
     class ReqProtocolImpl : public std::enable_shared_from_this<ReqProtocolImpl> {
     public:
         ReqProtocolImpl(std::shared_ptr<StreamConnector> connector, const ReqProtocolOptions &options);
-        virtual ~ReqProtocolImpl() = default;
+        virtual ~ReqProtocolImpl();
 
         tempo_utils::Status connect(const chord_common::TransportLocation &location);
+        bool cancel(tu_uint32 id);
+        tu_uint32 numInFlight() const;
         void shutdown();
 
     protected:
         ReqProtocolOptions m_options;
 
+        using CompletionFunc = std::function<void(
+            const tempo_utils::Status &,
+            std::shared_ptr<const tempo_utils::ImmutableBytes>)>;
+
         tempo_utils::Result<tu_uint32> send(std::shared_ptr<const tempo_utils::ImmutableBytes> payload);
+        tempo_utils::Result<tu_uint32> send(
+            std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
+            CompletionFunc complete,
+            absl::Duration timeout);
 
         virtual void ready() = 0;
 
@@ -44,6 +78,23 @@ namespace chord_mesh {
         tu_uint32 m_currId = 0;
         std::queue<std::pair<tu_uint32,std::shared_ptr<const tempo_utils::ImmutableBytes>>> m_pending;
 
+        struct InFlight {
+            absl::Time deadline;
+            CompletionFunc complete;
+        };
+        absl::flat_hash_map<tu_uint32,InFlight> m_inflight;
+        std::set<std::pair<absl::Time,tu_uint32>> m_deadlines;
+        uv_timer_t *m_timer = nullptr;
+
+        tempo_utils::Status sendRequest(
+            tu_uint32 id,
+            std::shared_ptr<const tempo_utils::ImmutableBytes> payload);
+        void completeRequest(const Envelope &envelope);
+        void failRequest(tu_uint32 id, const tempo_utils::Status &status);
+        void failAll(const tempo_utils::Status &status);
+        void expireRequests();
+        void scheduleDeadline();
+
         class ReqConnectContext : public AbstractConnectContext {
         public:
             ReqConnectContext(std::weak_ptr<ReqProtocolImpl> impl);
@@ -73,6 +124,7 @@ namespace chord_mesh {
 
         friend class ReqConnectContext;
         friend class ReqStreamContext;
+        friend void on_request_deadline(uv_timer_t *timer);
     };
 
     /**
@@ -93,6 +145,13 @@ namespace chord_mesh {
             virtual void cleanup() = 0;
         };
 
+        /**
+         * Invoked exactly once for a request sent with a completion callback. If the status is
+         * not ok then the request failed (timed out, was cancelled, or the protocol shut down)
+         * and the reply is empty.
+         */
+        using ReplyFunc = std::function<void(const tempo_utils::Status &, const RepMessage &)>;
+
     private:
         struct Private{ explicit Private() = default; };
 
@@ -137,6 +196,50 @@ namespace chord_mesh {
             return ReqProtocolImpl::send(bytes);
         }
 
+        /**
+         * Send the request and invoke the callback when the reply is received or the request
+         * fails. The reply is not delivered to the context.
+         *
+         * @param req
+         * @param onReply
+         * @param timeout The request deadline, relative to now.
+         * @return The request id, which may be passed to cancel().
+         */
+        tempo_utils::Result<tu_uint32> send(
+            ReqMessage &&req,
+            ReplyFunc onReply,
+            absl::Duration timeout)
+        {
+            TU_ASSERT (onReply != nullptr);
+            std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+            TU_ASSIGN_OR_RETURN (bytes, req.toBytes());
+            auto complete = [onReply = std::move(onReply)](
+                const tempo_utils::Status &status,
+                std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+            {
+                RepMessage message;
+                if (status.notOk()) {
+                    onReply(status, message);
+                    return;
+                }
+                auto parseStatus = message.parse(payload);
+                onReply(parseStatus, message);
+            };
+            return ReqProtocolImpl::send(bytes, std::move(complete), timeout);
+        }
+
+        /**
+         * Send the request with the default deadline from the protocol options.
+         *
+         * @param req
+         * @param onReply
+         * @return The request id, which may be passed to cancel().
+         */
+        tempo_utils::Result<tu_uint32> send(ReqMessage &&req, ReplyFunc onReply)
+        {
+            return send(std::move(req), std::move(onReply), m_options.requestTimeout);
+        }
+
     protected:
         void ready() override {
             m_ctx->ready(this);
@@ -0,0 +1,62 @@
+#ifndef CHORD_MESH_RING_BUFFER_H
+#define CHORD_MESH_RING_BUFFER_H
+
+#include <span>
+
+#include <tempo_utils/immutable_bytes.h>
+
+namespace chord_mesh {
+
+    constexpr tu_uint32 kDefaultRingBufferSize = 16384;
+
+    /**
+     * A growable receive buffer which hands out ref-counted slices of the buffered bytes. Incoming
+     * bytes are appended at the tail, and consumed bytes are released from the head. When the tail
+     * reaches the end of the buffer the unconsumed bytes are compacted to the front of the buffer,
+     * unless there are slices still referencing the buffer, in which case the unconsumed bytes are
+     * moved to a new buffer and the old buffer is kept alive by the outstanding slices.
+     */
+    class RingBuffer {
+    public:
+        explicit RingBuffer(tu_uint32 initialCapacity = kDefaultRingBufferSize);
+
+        tu_uint32 getCapacity() const;
+        tu_uint32 getSize() const;
+        bool isEmpty() const;
+        const tu_uint8 *getData() const;
+        std::span<const tu_uint8> getSpan() const;
+
+        void append(std::span<const tu_uint8> bytes);
+        std::shared_ptr<const tempo_utils::ImmutableBytes> slice(tu_uint32 offset, tu_uint32 size) const;
+        void consume(tu_uint32 size);
+        void clear();
+
+    private:
+        struct Block {
+            std::unique_ptr<tu_uint8[]> data;
+            tu_uint32 capacity;
+            explicit Block(tu_uint32 capacity);
+        };
+
+        class SliceBytes : public tempo_utils::ImmutableBytes {
+        public:
+            SliceBytes(std::shared_ptr<const Block> block, const tu_uint8 *data, tu_uint32 size);
+            const tu_uint8 *getData() const override;
+            tu_uint32 getSize() const override;
+
+        private:
+            std::shared_ptr<const Block> m_block;
+            const tu_uint8 *m_data;
+            tu_uint32 m_size;
+        };
+
+        std::shared_ptr<Block> m_block;
+        tu_uint32 m_head;
+        tu_uint32 m_tail;
+
+        bool isShared() const;
+        void wrap(tu_uint32 required);
+    };
+}
+
+#endif // CHORD_MESH_RING_BUFFER_H
@@ -0,0 +1,134 @@
+#ifndef CHORD_MESH_SHARDED_STREAM_MANAGER_H
+#define CHORD_MESH_SHARDED_STREAM_MANAGER_H
+
+#include <atomic>
+#include <functional>
+#include <queue>
+
+#include <uv.h>
+
+#include <absl/functional/any_invocable.h>
+#include <absl/synchronization/mutex.h>
+
+#include <chord_common/transport_location.h>
+
+#include "stream_acceptor.h"
+#include "stream_connector.h"
+#include "stream_manager.h"
+
+namespace chord_mesh {
+
+    enum class ShardAssignment {
+        RoundRobin,
+        PeerHash,
+    };
+
+    struct ShardedStreamManagerOptions {
+        /**
+         * The number of loop threads. If zero then one loop thread is started per hardware thread.
+         */
+        tu_uint32 numShards = 0;
+        /**
+         * How connected streams and unix accepted streams are assigned to shards. Tcp accepted
+         * streams are assigned by the kernel, which hashes the peer address among the SO_REUSEPORT
+         * listeners.
+         */
+        ShardAssignment assignment = ShardAssignment::RoundRobin;
+        /**
+         * Options applied to the StreamManager for each shard.
+         */
+        StreamManagerOptions managerOptions = {};
+    };
+
+    /**
+     * Creates an accept context for the specified shard. Each shard gets its own context, and the
+     * context callbacks are only ever invoked on the loop thread of the shard.
+     */
+    using AcceptContextFactory = std::function<std::unique_ptr<AbstractAcceptContext>(tu_uint32)>;
+
+    /**
+     * Runs a StreamManager on each of N loop threads and assigns every accepted or connected stream
+     * to one of the shards. All handles of a stream live on its shard's loop, and all context
+     * callbacks for the stream are invoked on that loop. Tcp listeners are bound once per shard
+     * using SO_REUSEPORT. Unix listeners are bound once on the first shard, and each accepted
+     * connection is handed off to the assigned shard by file descriptor.
+     */
+    class ShardedStreamManager {
+    public:
+        ShardedStreamManager(
+            const tempo_security::CertificateKeyPair &keypair,
+            std::shared_ptr<tempo_security::X509Store> trustStore,
+            const StreamManagerOps &ops,
+            const ShardedStreamManagerOptions &options = {});
+        ~ShardedStreamManager();
+
+        tu_uint32 numShards() const;
+        StreamManager *getShard(tu_uint32 index) const;
+
+        tempo_utils::Status start();
+
+        tempo_utils::Status listenUnix(
+            std::string_view pipePath,
+            int pipeFlags,
+            AcceptContextFactory factory,
+            const StreamAcceptorOptions &options = {});
+        tempo_utils::Status listenTcp4(
+            std::string_view ipAddress,
+            tu_uint16 tcpPort,
+            AcceptContextFactory factory,
+            const StreamAcceptorOptions &options = {});
+        tempo_utils::Status listenLocation(
+            const chord_common::TransportLocation &location,
+            AcceptContextFactory factory,
+            const StreamAcceptorOptions &options = {});
+
+        tempo_utils::Status connectLocation(
+            const chord_common::TransportLocation &location,
+            std::unique_ptr<AbstractConnectContext> &&ctx,
+            const StreamConnectorOptions &options = {});
+
+        tempo_utils::Status post(tu_uint32 index, absl::AnyInvocable<void(StreamManager *)> task);
+
+        void shutdown();
+
+    private:
+        struct Shard {
+            tu_uint32 index;
+            uv_loop_t loop;
+            uv_async_t async;
+            uv_thread_t tid;
+            std::unique_ptr<StreamManager> manager;
+            absl::Mutex lock;
+            std::queue<absl::AnyInvocable<void(StreamManager *)>> tasks ABSL_GUARDED_BY(lock);
+            bool stopped ABSL_GUARDED_BY(lock);
+            std::vector<std::shared_ptr<StreamAcceptor>> acceptors;
+            std::shared_ptr<StreamConnector> secureConnector;
+            std::shared_ptr<StreamConnector> insecureConnector;
+            std::unique_ptr<AbstractAcceptContext> handoffCtx;
+            bool handoffInsecure;
+        };
+
+        tempo_security::CertificateKeyPair m_keypair;
+        std::shared_ptr<tempo_security::X509Store> m_trustStore;
+        StreamManagerOps m_ops;
+        ShardedStreamManagerOptions m_options;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        uv_pipe_t *m_handoffListener;
+        std::atomic<tu_uint32> m_nextShard;
+        bool m_running;
+        bool m_stopped;
+
+        tu_uint32 selectShard(const chord_common::TransportLocation &location);
+        tempo_utils::Status runOnShard(
+            tu_uint32 index,
+            absl::AnyInvocable<tempo_utils::Status(Shard *)> fn);
+        void adopt(Shard *shard, uv_stream_t *client);
+        void emitError(const tempo_utils::Status &status);
+
+        friend void run_shard(void *arg);
+        friend void process_shard_tasks(uv_async_t *async);
+        friend void new_handoff_connection(uv_stream_t *server, int err);
+    };
+}
+
+#endif // CHORD_MESH_SHARDED_STREAM_MANAGER_H
@@ -0,0 +1,74 @@
+#ifndef CHORD_MESH_STATIC_KEY_MANAGER_H
+#define CHORD_MESH_STATIC_KEY_MANAGER_H
+
+#include <list>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/time/time.h>
+
+#include <tempo_security/certificate_key_pair.h>
+#include <tempo_security/x509_store.h>
+
+#include "noise.h"
+
+namespace chord_mesh {
+
+    constexpr absl::Duration kDefaultStaticKeyRotationInterval = absl::Hours(1);
+    constexpr tu_uint32 kDefaultVerifiedPeerCacheSize = 1024;
+    constexpr absl::Duration kDefaultVerifiedPeerLifetime = absl::Minutes(5);
+
+    struct StaticKeyManagerOptions {
+        absl::Duration keyRotationInterval = kDefaultStaticKeyRotationInterval;
+        tu_uint32 verifiedPeerCacheSize = kDefaultVerifiedPeerCacheSize;
+        absl::Duration verifiedPeerLifetime = kDefaultVerifiedPeerLifetime;
+    };
+
+    /**
+     * Manages the local signed static key and the set of remote static keys which have already been
+     * verified. The local static key is generated once and reused by every stream until the rotation
+     * interval elapses. Remote static keys are verified against the trust store once, and the
+     * (certificate, static key) pair is remembered in a bounded LRU cache so subsequent streams from
+     * the same peer skip certificate verification and the signature check.
+     */
+    class StaticKeyManager {
+    public:
+        StaticKeyManager(
+            const tempo_security::CertificateKeyPair &keypair,
+            std::shared_ptr<tempo_security::X509Store> trustStore,
+            const StaticKeyManagerOptions &options = {});
+
+        tempo_utils::Status getLocalKey(
+            std::shared_ptr<tempo_security::X509Certificate> &certificate,
+            StaticKeypair &staticKeypair);
+        tempo_utils::Status rotateLocalKey();
+
+        tempo_utils::Status validateRemoteKey(
+            std::span<const tu_uint8> publicKey,
+            std::shared_ptr<tempo_security::X509Certificate> certificate,
+            const tempo_security::Digest &digest);
+
+        tu_uint32 numVerifiedPeers() const;
+        tu_uint64 getCacheHits() const;
+        tu_uint64 getCacheMisses() const;
+
+    private:
+        tempo_security::CertificateKeyPair m_keypair;
+        std::shared_ptr<tempo_security::X509Store> m_trustStore;
+        StaticKeyManagerOptions m_options;
+
+        std::shared_ptr<tempo_security::X509Certificate> m_certificate;
+        StaticKeypair m_localKey;
+        absl::Time m_localKeyExpiry;
+
+        struct VerifiedPeer {
+            std::string key;
+            absl::Time expiry;
+        };
+        std::list<VerifiedPeer> m_lru;
+        absl::flat_hash_map<std::string,std::list<VerifiedPeer>::iterator> m_verified;
+        tu_uint64 m_cacheHits;
+        tu_uint64 m_cacheMisses;
+    };
+}
+
+#endif // CHORD_MESH_STATIC_KEY_MANAGER_H
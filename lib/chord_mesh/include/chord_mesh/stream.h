@@ -23,6 +23,7 @@ namespace chord_mesh {
 
         bool isInitiator() const;
         bool isSecure() const;
+        bool isWritable() const;
 
         tempo_utils::UUID getId() const;
         StreamState getStreamState() const;
@@ -33,6 +34,11 @@ namespace chord_mesh {
             EnvelopeVersion version,
             std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
             absl::Time timestamp = {});
+        tempo_utils::Status send(
+            EnvelopeVersion version,
+            std::shared_ptr<const tempo_utils::ImmutableBytes> header,
+            std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
+            absl::Time timestamp);
         void shutdown() override;
         void close() override;
 
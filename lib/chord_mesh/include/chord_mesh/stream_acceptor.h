@@ -12,6 +12,11 @@ namespace chord_mesh {
 
     struct StreamAcceptorOptions {
         bool allowInsecure = false;
+        /**
+         * If true then the tcp listener sets SO_REUSEPORT, which allows listeners on several loops
+         * to bind the same address and lets the kernel distribute incoming connections among them.
+         */
+        bool reusePort = false;
     };
 
     class StreamAcceptor : public std::enable_shared_from_this<StreamAcceptor> {
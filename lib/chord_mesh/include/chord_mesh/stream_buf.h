@@ -3,6 +3,9 @@
 
 #include <uv.h>
 
+#include <memory>
+#include <vector>
+
 #include <tempo_utils/immutable_bytes.h>
 #include <tempo_utils/status.h>
 
@@ -41,6 +44,60 @@ namespace chord_mesh {
         static ArrayBuf *allocate(std::string_view str);
         static ArrayBuf *allocate(const tu_uint8 *bytes, size_t size);
     };
+
+    class StreamBufPool;
+
+    void free_pooled_buf(StreamBuf *streamBuf);
+
+    struct PooledBuf : StreamBuf {
+        explicit PooledBuf(tu_uint32 capacity);
+        std::unique_ptr<tu_uint8[]> m_data;
+        tu_uint32 m_capacity;
+        std::shared_ptr<StreamBufPool> m_pool;
+
+        tu_uint8 *getData();
+        tu_uint32 getCapacity() const;
+        void setSize(tu_uint32 size);
+    };
+
+    /**
+     * A pool of fixed size buffers which are recycled when they are freed. Buffers which are larger
+     * than the pool buffer size are allocated on demand and are not recycled. The pool is not thread
+     * safe, and must only be used from a single thread (typically the thread running the uv loop).
+     */
+    class StreamBufPool : public std::enable_shared_from_this<StreamBufPool> {
+    public:
+        StreamBufPool(tu_uint32 bufferSize, tu_uint32 maxFree);
+        ~StreamBufPool();
+
+        tu_uint32 getBufferSize() const;
+        tu_uint32 getFreeCount() const;
+
+        PooledBuf *allocate(tu_uint32 size);
+
+    private:
+        tu_uint32 m_bufferSize;
+        tu_uint32 m_maxFree;
+        std::vector<PooledBuf *> m_free;
+
+        void release(PooledBuf *pooledBuf);
+        friend void free_pooled_buf(StreamBuf *streamBuf);
+    };
+
+    /**
+     * Immutable bytes which take ownership of the specified StreamBuf, and free it when the bytes
+     * are destroyed.
+     */
+    class StreamBufBytes : public tempo_utils::ImmutableBytes {
+    public:
+        explicit StreamBufBytes(StreamBuf *streamBuf);
+        ~StreamBufBytes() override;
+        const tu_uint8 *getData() const override;
+        tu_uint32 getSize() const override;
+
+    private:
+        StreamBuf *m_streamBuf;
+    };
 }
 
 #endif // CHORD_MESH_STREAM_BUF_H
\ No newline at end of file
@@ -36,6 +36,8 @@ namespace chord_mesh {
             const chord_common::TransportLocation &endpoint,
             std::unique_ptr<AbstractConnectContext> &&ctx);
 
+        StreamManager *getManager() const;
+
         void shutdown();
 
     private:
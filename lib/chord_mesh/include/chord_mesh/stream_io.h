@@ -138,7 +138,7 @@ namespace chord_mesh {
 
         tempo_utils::Status start(AbstractStreamBufWriter *writer);
         tempo_utils::Status process(std::span<const tu_uint8> data, AbstractStreamBufWriter *writer, bool &finished);
-        tempo_utils::Result<std::shared_ptr<Cipher>> finish();
+        tempo_utils::Result<std::shared_ptr<Cipher>> finish(const CipherOptions &options);
 
         std::unique_ptr<Pending>&& takePending();
 
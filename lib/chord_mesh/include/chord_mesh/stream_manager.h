@@ -8,9 +8,14 @@
 #include <tempo_utils/uuid.h>
 
 #include "envelope.h"
+#include "noise.h"
+#include "static_key_manager.h"
 
 namespace chord_mesh {
 
+    constexpr tu_uint32 kDefaultWriteHighWatermark = 1048576;   // 1MiB
+    constexpr tu_uint32 kDefaultWriteLowWatermark = 262144;     // 256KiB
+
     class Stream;
     class StreamManager;
     class StreamSession;
@@ -61,6 +66,11 @@ namespace chord_mesh {
         virtual tempo_utils::Status validate(std::string_view, std::shared_ptr<tempo_security::X509Certificate>) = 0;
         virtual void error(const tempo_utils::Status &) = 0;
         virtual void cleanup() = 0;
+        /**
+         * Invoked with false when the bytes queued for writing on the stream rise above the high
+         * watermark, and with true when they subsequently drain below the low watermark.
+         */
+        virtual void writable(bool) {}
     };
 
     struct ConnectHandle {
@@ -138,7 +148,9 @@ namespace chord_mesh {
         tempo_utils::Status negotiate(std::string_view protocolName);
         tempo_utils::Status validate(std::string_view protocolName, std::shared_ptr<tempo_security::X509Certificate> certificate);
         tempo_utils::Status send(std::shared_ptr<const tempo_utils::ImmutableBytes> bytes);
+        bool isWritable() const;
         void receive(const Envelope &envelope);
+        void writable(bool writable);
         void error(const tempo_utils::Status &status);
         void shutdown();
         void close();
@@ -158,6 +170,13 @@ namespace chord_mesh {
 
     struct StreamManagerOptions {
         std::string protocolName = {};
+        tu_uint32 writeHighWatermark = kDefaultWriteHighWatermark;
+        tu_uint32 writeLowWatermark = kDefaultWriteLowWatermark;
+        tu_uint32 cipherSegmentSize = kDefaultCipherSegmentSize;
+        tu_uint32 cipherPoolMaxFree = kDefaultCipherPoolMaxFree;
+        absl::Duration staticKeyRotationInterval = kDefaultStaticKeyRotationInterval;
+        tu_uint32 verifiedPeerCacheSize = kDefaultVerifiedPeerCacheSize;
+        absl::Duration verifiedPeerLifetime = kDefaultVerifiedPeerLifetime;
         void *data = nullptr;
     };
 
@@ -173,8 +192,12 @@ namespace chord_mesh {
         uv_loop_t *getLoop() const;
         std::shared_ptr<tempo_security::X509Store> getTrustStore() const;
         tempo_security::CertificateKeyPair getKeypair() const;
+        StaticKeyManager *getStaticKeyManager() const;
 
         std::string getProtocolName() const;
+        tu_uint32 getWriteHighWatermark() const;
+        tu_uint32 getWriteLowWatermark() const;
+        CipherOptions getCipherOptions() const;
 
         ConnectHandle *allocateConnectHandle(
             uv_connect_t *connect,
@@ -196,6 +219,8 @@ namespace chord_mesh {
         std::shared_ptr<tempo_security::X509Store> m_trustStore;
         StreamManagerOps m_ops;
         StreamManagerOptions m_options;
+        std::shared_ptr<StreamBufPool> m_bufPool;
+        std::unique_ptr<StaticKeyManager> m_staticKeys;
 
         ConnectHandle *m_connects;
         AcceptHandle *m_accepts;
@@ -1,16 +1,24 @@
 #ifndef CHORD_MESH_STREAM_SESSION_H
 #define CHORD_MESH_STREAM_SESSION_H
 
+#include <deque>
+
 #include "stream_buf.h"
 #include "stream_io.h"
 
 namespace chord_mesh {
 
+    constexpr int kMaxWriteBufs = 64;
+
     struct StreamHandle;
 
     class StreamSession : public AbstractStreamBufWriter {
     public:
         StreamSession(StreamHandle *handle, bool initiator, bool insecure);
+        ~StreamSession() override;
+
+        bool isWritable() const;
+        size_t getQueuedBytes() const;
 
         tempo_utils::Status start();
         tempo_utils::Status negotiate(std::string_view protocolName);
@@ -25,7 +33,19 @@ namespace chord_mesh {
         bool m_insecure;
         std::unique_ptr<StreamIO> m_io;
 
+        // write queue state. at most one uv_write is in flight at a time, and any bufs written while
+        // it is in flight are queued and then coalesced into the next uv_write.
+        uv_write_t m_req;
+        bool m_writing;
+        bool m_writable;
+        std::deque<StreamBuf *> m_queued;
+        std::vector<StreamBuf *> m_inflight;
+        std::vector<uv_buf_t> m_bufs;
+        size_t m_queuedBytes;
+
         tempo_utils::Status processStreamMessage(const Envelope &envelope);
+        tempo_utils::Status flush();
+        void discardQueued();
 
         friend void allocate_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
         friend void perform_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
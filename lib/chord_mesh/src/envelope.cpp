@@ -300,9 +300,11 @@ chord_mesh::EnvelopeBuilder::reset()
     m_payload = {};
 }
 
-chord_mesh::EnvelopeParser::EnvelopeParser()
+chord_mesh::EnvelopeParser::EnvelopeParser(const EnvelopeParserOptions &options)
+    : m_options(options),
+      m_pending(options.bufferSize)
 {
-    reset();
+    resetEnvelope();
 }
 
 std::shared_ptr<tempo_security::X509Certificate>
@@ -320,7 +322,7 @@ chord_mesh::EnvelopeParser::setCertificate(std::shared_ptr<tempo_security::X509C
 tempo_utils::Status
 chord_mesh::EnvelopeParser::pushBytes(std::span<const tu_uint8> bytes)
 {
-    m_pending->appendBytes(bytes);
+    m_pending.append(bytes);
     return {};
 }
 
@@ -336,9 +338,9 @@ chord_mesh::EnvelopeParser::checkReady(bool &ready)
 
     // get the envelope version if we have read enough input
     if (m_envelopeVersion == 0) {
-        if (m_pending->getSize() < 2)
+        if (m_pending.getSize() < 2)
             return {};
-        auto *ptr = m_pending->getData();
+        auto *ptr = m_pending.getData();
         m_envelopeVersion = tempo_utils::read_u8_and_advance(ptr);
     }
 
@@ -354,9 +356,9 @@ chord_mesh::EnvelopeParser::checkReady(bool &ready)
 
     // get the envelope version and payload size if we have read enough input
     if (m_payloadSize == 0) {
-        if (m_pending->getSize() < 12)
+        if (m_pending.getSize() < 12)
             return {};
-        auto *ptr = m_pending->getData() + 1;
+        auto *ptr = m_pending.getData() + 1;
         m_envelopeFlags = tempo_utils::read_u8_and_advance(ptr);
         m_timestamp = tempo_utils::read_u32_and_advance(ptr);
         m_headerSize = tempo_utils::read_u16_and_advance(ptr);
@@ -374,16 +376,16 @@ chord_mesh::EnvelopeParser::checkReady(bool &ready)
             "cannot verify signed envelope");
 
     // we haven't read enough input to parse the header and payload
-    if (m_pending->getSize() < 12 + m_headerSize + m_payloadSize)
+    if (m_pending.getSize() < 12 + m_headerSize + m_payloadSize)
         return {};
 
     if (verificationRequired) {
 
         // get the digest size if we have read enough input
         if (m_digestSize == 0) {
-            if (m_pending->getSize() < 12 + m_headerSize + m_payloadSize + 1)
+            if (m_pending.getSize() < 12 + m_headerSize + m_payloadSize + 1)
                 return {};
-            auto *ptr = m_pending->getData() + 12 + m_headerSize + m_payloadSize;
+            auto *ptr = m_pending.getData() + 12 + m_headerSize + m_payloadSize;
             m_digestSize = tempo_utils::read_u8_and_advance(ptr);
             if (m_digestSize == 0)
                 return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
@@ -391,7 +393,7 @@ chord_mesh::EnvelopeParser::checkReady(bool &ready)
         }
 
         // we haven't read enough input to parse the digest
-        if (m_pending->getSize() < 12 + m_headerSize + m_payloadSize + 1 + m_digestSize)
+        if (m_pending.getSize() < 12 + m_headerSize + m_payloadSize + 1 + m_digestSize)
             return {};
     }
 
@@ -407,9 +409,6 @@ chord_mesh::EnvelopeParser::takeReady(Envelope &ready)
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
             "no ready envelope available");
 
-    // finish the appender
-    auto pending = m_pending->finish()->toSlice();
-
     // copy parser state before reset
     auto trailerSize = m_digestSize > 0? m_digestSize + 1 : 0;
     auto envelopeSize = 12 + m_headerSize + m_payloadSize + trailerSize;
@@ -422,27 +421,33 @@ chord_mesh::EnvelopeParser::takeReady(Envelope &ready)
     bool verificationRequired = envelopeFlags & kEnvelopeSignedFlag;
 
     // reset parser state
-    reset();
-
-    // if there is additional data then add it to the appender
-    auto remainder = pending.slice(envelopeSize, pending.getSize() - envelopeSize);
-    if (!remainder.isEmpty()) {
-        m_pending->appendBytes(remainder.sliceView());
+    resetEnvelope();
+
+    // in zero copy mode the header and payload are slices which reference the receive buffer. the
+    // slices keep the underlying buffer alive until the envelope is released.
+    std::shared_ptr<const tempo_utils::ImmutableBytes> headerSlice;
+    std::shared_ptr<const tempo_utils::ImmutableBytes> payloadSlice;
+    if (m_options.zeroCopy) {
+        if (headerSize > 0) {
+            headerSlice = m_pending.slice(12, headerSize);
+        }
+        payloadSlice = m_pending.slice(12 + headerSize, payloadSize);
     }
 
+    // consume the envelope, any additional data remains in the buffer. the pending span remains
+    // valid until the next call to pushBytes.
+    auto pending = m_pending.getSpan().subspan(0, envelopeSize);
+    m_pending.consume(envelopeSize);
+
     // construct the envelope
     Envelope envelope(envelopeVersion, envelopeFlags, timestamp);
-    auto headerBytes = pending.slice(12, headerSize).sliceView();
-    auto payloadBytes = pending.slice(12 + headerSize, payloadSize).sliceView();
+    auto headerBytes = pending.subspan(12, headerSize);
+    auto payloadBytes = pending.subspan(12 + headerSize, payloadSize);
 
     // verify the signature against the public key
     if (verificationRequired) {
-        auto verifyBytes = pending
-            .slice(0, 12 + headerSize + payloadSize)
-            .sliceView();
-        auto digestBytes = pending
-            .slice(12 + headerSize + payloadSize + 1, digestSize)
-            .sliceView();
+        auto verifyBytes = pending.subspan(0, 12 + headerSize + payloadSize);
+        auto digestBytes = pending.subspan(12 + headerSize + payloadSize + 1, digestSize);
         tempo_security::Digest digest(digestBytes);
         bool verified;
         TU_ASSIGN_OR_RETURN (verified, tempo_security::DigestUtils::verify_signed_message_digest(
@@ -453,9 +458,14 @@ chord_mesh::EnvelopeParser::takeReady(Envelope &ready)
         envelope.setDigest(digest);
     }
 
-    envelope.setPayload(tempo_utils::MemoryBytes::copy(payloadBytes));
-    if (!headerBytes.empty()) {
-        envelope.setHeader(tempo_utils::MemoryBytes::copy(headerBytes));
+    if (m_options.zeroCopy) {
+        envelope.setPayload(std::move(payloadSlice));
+        envelope.setHeader(std::move(headerSlice));
+    } else {
+        envelope.setPayload(tempo_utils::MemoryBytes::copy(payloadBytes));
+        if (!headerBytes.empty()) {
+            envelope.setHeader(tempo_utils::MemoryBytes::copy(headerBytes));
+        }
     }
 
     ready = envelope;
@@ -466,13 +476,13 @@ chord_mesh::EnvelopeParser::takeReady(Envelope &ready)
 bool
 chord_mesh::EnvelopeParser::hasPending() const
 {
-    return m_pending->getSize() > 0;
+    return !m_pending.isEmpty();
 }
 
 std::shared_ptr<const tempo_utils::MemoryBytes>
 chord_mesh::EnvelopeParser::popPending()
 {
-    auto pending = m_pending->finish();
+    auto pending = tempo_utils::MemoryBytes::copy(m_pending.getSpan());
     reset();
     return pending;
 }
@@ -480,7 +490,13 @@ chord_mesh::EnvelopeParser::popPending()
 void
 chord_mesh::EnvelopeParser::reset()
 {
-    m_pending = std::make_unique<tempo_utils::BytesAppender>();
+    m_pending.clear();
+    resetEnvelope();
+}
+
+void
+chord_mesh::EnvelopeParser::resetEnvelope()
+{
     m_ready = false;
     m_envelopeVersion = 0;
     m_envelopeFlags = 0;
@@ -488,4 +504,4 @@ chord_mesh::EnvelopeParser::reset()
     m_headerSize = 0;
     m_payloadSize = 0;
     m_digestSize = 0;
-}
\ No newline at end of file
+}
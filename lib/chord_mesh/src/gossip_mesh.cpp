@@ -0,0 +1,653 @@
+
+#include <algorithm>
+
+#include <chord_mesh/gossip_mesh.h>
+#include <chord_mesh/mesh_result.h>
+#include <tempo_utils/memory_bytes.h>
+
+chord_mesh::GossipMesh::GossipMesh(
+    StreamManager *manager,
+    std::unique_ptr<AbstractGossipContext> &&ctx,
+    const GossipMeshOptions &options,
+    Private)
+    : m_manager(manager),
+      m_ctx(std::move(ctx)),
+      m_options(options),
+      m_timer(nullptr),
+      m_shutdown(false)
+{
+    TU_ASSERT (m_manager != nullptr);
+    TU_ASSERT (m_ctx != nullptr);
+    TU_ASSERT (m_options.meshDegreeLow <= m_options.meshDegree);
+    TU_ASSERT (m_options.meshDegree <= m_options.meshDegreeHigh);
+    TU_ASSERT (m_options.gossipLength <= m_options.historyLength);
+    m_history.emplace_front();
+}
+
+chord_mesh::GossipMesh::~GossipMesh()
+{
+    shutdown();
+    // the timer handle is freed by the loop once it is closed
+    if (m_timer != nullptr) {
+        m_timer->data = nullptr;
+        uv_close((uv_handle_t *) m_timer, [](uv_handle_t *handle) {
+            delete (uv_timer_t *) handle;
+        });
+    }
+    m_ctx->cleanup();
+}
+
+void
+chord_mesh::on_gossip_heartbeat(uv_timer_t *timer)
+{
+    auto *mesh = (GossipMesh *) timer->data;
+    if (mesh != nullptr) {
+        mesh->heartbeat();
+    }
+}
+
+tempo_utils::Result<std::shared_ptr<chord_mesh::GossipMesh>>
+chord_mesh::GossipMesh::create(
+    StreamManager *manager,
+    std::unique_ptr<AbstractGossipContext> &&ctx,
+    const GossipMeshOptions &options)
+{
+    auto mesh = std::make_shared<GossipMesh>(manager, std::move(ctx), options, Private{});
+
+    StreamAcceptorOptions acceptorOptions;
+    acceptorOptions.allowInsecure = options.allowInsecure;
+    TU_ASSIGN_OR_RETURN (mesh->m_acceptor, StreamAcceptor::create(manager, acceptorOptions));
+
+    StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = options.allowInsecure;
+    TU_ASSIGN_OR_RETURN (mesh->m_connector, StreamConnector::create(manager, connectorOptions));
+
+    auto *timer = new uv_timer_t;
+    uv_timer_init(manager->getLoop(), timer);
+    timer->data = mesh.get();
+    mesh->m_timer = timer;
+
+    auto intervalMillis = std::max<tu_int64>(absl::ToInt64Milliseconds(options.heartbeatInterval), 1);
+    uv_timer_start(timer, on_gossip_heartbeat, intervalMillis, intervalMillis);
+
+    return mesh;
+}
+
+chord_mesh::GossipMesh::GossipStreamContext::GossipStreamContext(
+    std::weak_ptr<GossipMesh> mesh,
+    std::string peerId)
+    : m_mesh(std::move(mesh)),
+      m_peerId(std::move(peerId))
+{
+}
+
+void
+chord_mesh::GossipMesh::GossipStreamContext::receive(const Envelope &envelope)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->receivePeer(m_peerId, envelope);
+    }
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::GossipStreamContext::validate(
+    std::string_view protocolName,
+    std::shared_ptr<tempo_security::X509Certificate> certificate)
+{
+    return {};
+}
+
+void
+chord_mesh::GossipMesh::GossipStreamContext::error(const tempo_utils::Status &status)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->emitError(status);
+        mesh->detachPeer(m_peerId);
+    }
+}
+
+void
+chord_mesh::GossipMesh::GossipStreamContext::cleanup()
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->detachPeer(m_peerId);
+    }
+}
+
+chord_mesh::GossipMesh::GossipAcceptContext::GossipAcceptContext(std::weak_ptr<GossipMesh> mesh)
+    : m_mesh(std::move(mesh))
+{
+}
+
+void
+chord_mesh::GossipMesh::GossipAcceptContext::accept(std::shared_ptr<Stream> stream)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->attachPeer(std::move(stream));
+    } else {
+        stream->shutdown();
+    }
+}
+
+void
+chord_mesh::GossipMesh::GossipAcceptContext::error(const tempo_utils::Status &status)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->emitError(status);
+    }
+}
+
+void
+chord_mesh::GossipMesh::GossipAcceptContext::cleanup()
+{
+}
+
+chord_mesh::GossipMesh::GossipConnectContext::GossipConnectContext(std::weak_ptr<GossipMesh> mesh)
+    : m_mesh(std::move(mesh))
+{
+}
+
+void
+chord_mesh::GossipMesh::GossipConnectContext::connect(std::shared_ptr<Stream> stream)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->attachPeer(std::move(stream));
+    } else {
+        stream->shutdown();
+    }
+}
+
+void
+chord_mesh::GossipMesh::GossipConnectContext::error(const tempo_utils::Status &status)
+{
+    auto mesh = m_mesh.lock();
+    if (mesh != nullptr) {
+        mesh->emitError(status);
+    }
+}
+
+void
+chord_mesh::GossipMesh::GossipConnectContext::cleanup()
+{
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::listen(const chord_common::TransportLocation &location)
+{
+    if (m_shutdown)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "gossip mesh is shut down");
+    auto ctx = std::make_unique<GossipAcceptContext>(weak_from_this());
+    return m_acceptor->listenLocation(location, std::move(ctx));
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::addPeer(const chord_common::TransportLocation &location)
+{
+    if (m_shutdown)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "gossip mesh is shut down");
+    auto ctx = std::make_unique<GossipConnectContext>(weak_from_this());
+    // the connect handle is released when the connect completes
+    std::shared_ptr<Connect> connect;
+    TU_ASSIGN_OR_RETURN (connect, m_connector->connectLocation(location, std::move(ctx)));
+    return {};
+}
+
+void
+chord_mesh::GossipMesh::attachPeer(std::shared_ptr<Stream> stream)
+{
+    if (m_shutdown) {
+        stream->shutdown();
+        return;
+    }
+
+    auto peerId = stream->getId().toString();
+    auto ctx = std::make_unique<GossipStreamContext>(weak_from_this(), peerId);
+    auto status = stream->start(std::move(ctx));
+    if (status.notOk()) {
+        emitError(status);
+        return;
+    }
+
+    auto peer = std::make_unique<Peer>();
+    peer->id = peerId;
+    peer->stream = std::move(stream);
+    auto *peerPtr = peer.get();
+    m_peers[peerId] = std::move(peer);
+
+    m_ctx->join(peerId);
+
+    // graft the new peer if the mesh is below its target degree
+    if (numMeshPeers() < m_options.meshDegree) {
+        peerPtr->inMesh = true;
+        status = sendGraft(peerPtr);
+        if (status.notOk()) {
+            emitError(status);
+        }
+    }
+}
+
+void
+chord_mesh::GossipMesh::detachPeer(std::string_view peerId)
+{
+    auto entry = m_peers.find(peerId);
+    if (entry == m_peers.cend())
+        return;
+    auto &peer = entry->second;
+    if (peer->closed)
+        return;
+
+    // the peer is only marked closed here, as this may be invoked from within a stream callback.
+    // closed peers are removed on the next heartbeat.
+    peer->closed = true;
+    peer->inMesh = false;
+    peer->stream->close();
+    m_ctx->leave(peerId);
+}
+
+tu_uint32
+chord_mesh::GossipMesh::numPeers() const
+{
+    tu_uint32 numPeers = 0;
+    for (const auto &entry : m_peers) {
+        if (!entry.second->closed) {
+            numPeers++;
+        }
+    }
+    return numPeers;
+}
+
+tu_uint32
+chord_mesh::GossipMesh::numMeshPeers() const
+{
+    tu_uint32 numMeshPeers = 0;
+    for (const auto &entry : m_peers) {
+        if (entry.second->inMesh) {
+            numMeshPeers++;
+        }
+    }
+    return numMeshPeers;
+}
+
+chord_mesh::GossipStats
+chord_mesh::GossipMesh::getStats() const
+{
+    return m_stats;
+}
+
+bool
+chord_mesh::GossipMesh::markSeen(std::string_view messageId)
+{
+    if (m_seen.contains(messageId))
+        return false;
+    auto expiry = absl::Now() + m_options.seenTtl;
+    m_seen[messageId] = expiry;
+    m_seenExpiry.emplace_back(expiry, std::string(messageId));
+    return true;
+}
+
+void
+chord_mesh::GossipMesh::publish(
+    std::string_view messageId,
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes,
+    std::string_view sourceId)
+{
+    // remember the message so it can be served to peers which request it after seeing an IHave
+    std::string id(messageId);
+    m_messages[id] = bytes;
+    m_history.front().push_back(id);
+
+    // eagerly push the message to the mesh, except back to the peer it was received from
+    for (auto &entry : m_peers) {
+        auto &peer = entry.second;
+        if (!peer->inMesh || peer->id == sourceId)
+            continue;
+        auto status = sendBytes(peer.get(), bytes);
+        if (status.notOk()) {
+            emitError(status);
+            continue;
+        }
+        m_stats.eagerSends++;
+    }
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::send(const EnsembleMessage &message)
+{
+    if (m_shutdown)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "gossip mesh is shut down");
+
+    // a message without an id is delivered to direct peers only and is not relayed
+    EnsembleMessage copy;
+    copy.setRoot(message.getRoot());
+    copy.getRoot().setMessageId("");
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, copy.toBytes());
+
+    for (auto &entry : m_peers) {
+        auto &peer = entry.second;
+        if (peer->closed)
+            continue;
+        // a failing peer must not prevent delivery to the remaining peers
+        auto status = sendBytes(peer.get(), bytes);
+        if (status.notOk()) {
+            emitError(status);
+        }
+    }
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::broadcast(const EnsembleMessage &message)
+{
+    if (m_shutdown)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "gossip mesh is shut down");
+
+    auto messageId = tempo_utils::UUID::randomUUID().toString();
+
+    EnsembleMessage copy;
+    copy.setRoot(message.getRoot());
+    copy.getRoot().setMessageId(messageId);
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, copy.toBytes());
+
+    markSeen(messageId);
+    publish(messageId, bytes, {});
+    m_stats.published++;
+
+    return {};
+}
+
+void
+chord_mesh::GossipMesh::receivePeer(std::string_view peerId, const Envelope &envelope)
+{
+    auto entry = m_peers.find(peerId);
+    if (entry == m_peers.cend() || entry->second->closed)
+        return;
+    auto *peer = entry->second.get();
+
+    auto payload = envelope.getPayload();
+    EnsembleMessage message;
+    auto status = message.parse(payload);
+    if (status.notOk()) {
+        emitError(status);
+        return;
+    }
+    const auto &reader = message;
+    auto root = reader.getRoot();
+    auto now = absl::Now();
+
+    switch (root.getMessage().which()) {
+
+        case generated::EnsembleMessage::Message::GOSSIP_GRAFT: {
+            if (peer->inMesh)
+                break;
+            if (numMeshPeers() < m_options.meshDegreeHigh && peer->backoffUntil <= now) {
+                peer->inMesh = true;
+            } else {
+                status = sendPrune(peer);
+            }
+            break;
+        }
+
+        case generated::EnsembleMessage::Message::GOSSIP_PRUNE: {
+            auto prune = root.getMessage().getGossipPrune();
+            peer->inMesh = false;
+            peer->backoffUntil = now + absl::Milliseconds(prune.getBackoffMillis());
+            break;
+        }
+
+        case generated::EnsembleMessage::Message::GOSSIP_I_HAVE: {
+            std::vector<std::string> wanted;
+            for (auto messageId : root.getMessage().getGossipIHave().getMessageIds()) {
+                std::string_view id(messageId.cStr(), messageId.size());
+                if (!m_seen.contains(id)) {
+                    wanted.emplace_back(id);
+                }
+            }
+            if (!wanted.empty()) {
+                status = sendIWant(peer, wanted);
+            }
+            break;
+        }
+
+        case generated::EnsembleMessage::Message::GOSSIP_I_WANT: {
+            for (auto messageId : root.getMessage().getGossipIWant().getMessageIds()) {
+                std::string_view id(messageId.cStr(), messageId.size());
+                auto cached = m_messages.find(id);
+                if (cached == m_messages.cend())
+                    continue;
+                status = sendBytes(peer, cached->second);
+                if (status.notOk())
+                    break;
+            }
+            break;
+        }
+
+        default: {
+            std::string messageId = root.getMessageId();
+            // a message without an id was sent to direct peers only and is not relayed
+            if (messageId.empty()) {
+                m_stats.delivered++;
+                m_ctx->receive(message);
+                break;
+            }
+            if (!markSeen(messageId)) {
+                m_stats.duplicates++;
+                break;
+            }
+            if (!peer->inMesh) {
+                m_stats.repaired++;
+            }
+
+            // copy the payload so the cached message does not pin the receive buffer
+            auto bytes = tempo_utils::MemoryBytes::copy(
+                std::span(payload->getData(), payload->getSize()));
+            publish(messageId, bytes, peerId);
+            m_stats.delivered++;
+            m_ctx->receive(message);
+            break;
+        }
+    }
+
+    if (status.notOk()) {
+        emitError(status);
+    }
+}
+
+void
+chord_mesh::GossipMesh::heartbeat()
+{
+    if (m_shutdown)
+        return;
+    auto now = absl::Now();
+
+    // remove peers which were closed since the last heartbeat
+    for (auto it = m_peers.begin(); it != m_peers.end();) {
+        if (it->second->closed) {
+            m_peers.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+
+    std::vector<Peer *> meshPeers;
+    std::vector<Peer *> otherPeers;
+    for (auto &entry : m_peers) {
+        auto *peer = entry.second.get();
+        if (peer->inMesh) {
+            meshPeers.push_back(peer);
+        } else {
+            otherPeers.push_back(peer);
+        }
+    }
+
+    // graft peers if the mesh is too small, or prune peers if the mesh is too large
+    if (meshPeers.size() < m_options.meshDegreeLow) {
+        std::shuffle(otherPeers.begin(), otherPeers.end(), m_rand);
+        for (auto *peer : otherPeers) {
+            if (meshPeers.size() >= m_options.meshDegree)
+                break;
+            if (now < peer->backoffUntil)
+                continue;
+            peer->inMesh = true;
+            meshPeers.push_back(peer);
+            auto status = sendGraft(peer);
+            if (status.notOk()) {
+                emitError(status);
+            }
+        }
+    } else if (meshPeers.size() > m_options.meshDegreeHigh) {
+        std::shuffle(meshPeers.begin(), meshPeers.end(), m_rand);
+        while (meshPeers.size() > m_options.meshDegree) {
+            auto *peer = meshPeers.back();
+            meshPeers.pop_back();
+            peer->inMesh = false;
+            peer->backoffUntil = now + m_options.pruneBackoff;
+            auto status = sendPrune(peer);
+            if (status.notOk()) {
+                emitError(status);
+            }
+        }
+    }
+
+    // advertise recently seen messages to a random subset of the peers outside the mesh
+    std::vector<std::string> recent;
+    for (tu_uint32 i = 0; i < m_options.gossipLength && i < m_history.size(); i++) {
+        const auto &window = m_history.at(i);
+        recent.insert(recent.end(), window.cbegin(), window.cend());
+    }
+    if (!recent.empty()) {
+        otherPeers.clear();
+        for (auto &entry : m_peers) {
+            if (!entry.second->inMesh) {
+                otherPeers.push_back(entry.second.get());
+            }
+        }
+        std::shuffle(otherPeers.begin(), otherPeers.end(), m_rand);
+        if (otherPeers.size() > m_options.gossipFanout) {
+            otherPeers.resize(m_options.gossipFanout);
+        }
+        for (auto *peer : otherPeers) {
+            auto status = sendIHave(peer, recent);
+            if (status.notOk()) {
+                emitError(status);
+            }
+        }
+    }
+
+    // shift the message history, dropping messages from the oldest window
+    m_history.emplace_front();
+    while (m_history.size() > std::max<tu_uint32>(m_options.historyLength, 1)) {
+        for (const auto &messageId : m_history.back()) {
+            m_messages.erase(messageId);
+        }
+        m_history.pop_back();
+    }
+
+    // forget seen message ids once their ttl expires
+    while (!m_seenExpiry.empty() && m_seenExpiry.front().first <= now) {
+        m_seen.erase(m_seenExpiry.front().second);
+        m_seenExpiry.pop_front();
+    }
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::sendGraft(Peer *peer)
+{
+    EnsembleMessage message;
+    message.getRoot().getMessage().initGossipGraft();
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, message.toBytes());
+    return sendBytes(peer, bytes);
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::sendPrune(Peer *peer)
+{
+    EnsembleMessage message;
+    auto prune = message.getRoot().getMessage().initGossipPrune();
+    prune.setBackoffMillis(absl::ToInt64Milliseconds(m_options.pruneBackoff));
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, message.toBytes());
+    return sendBytes(peer, bytes);
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::sendIHave(Peer *peer, const std::vector<std::string> &messageIds)
+{
+    EnsembleMessage message;
+    auto ihave = message.getRoot().getMessage().initGossipIHave();
+    auto ids = ihave.initMessageIds(messageIds.size());
+    for (tu_uint32 i = 0; i < messageIds.size(); i++) {
+        ids.set(i, messageIds.at(i).c_str());
+    }
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, message.toBytes());
+    TU_RETURN_IF_NOT_OK (sendBytes(peer, bytes));
+    m_stats.ihaveSends++;
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::sendIWant(Peer *peer, const std::vector<std::string> &messageIds)
+{
+    EnsembleMessage message;
+    auto iwant = message.getRoot().getMessage().initGossipIWant();
+    auto ids = iwant.initMessageIds(messageIds.size());
+    for (tu_uint32 i = 0; i < messageIds.size(); i++) {
+        ids.set(i, messageIds.at(i).c_str());
+    }
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RETURN (bytes, message.toBytes());
+    TU_RETURN_IF_NOT_OK (sendBytes(peer, bytes));
+    m_stats.iwantSends++;
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::GossipMesh::sendBytes(Peer *peer, std::shared_ptr<const tempo_utils::ImmutableBytes> bytes)
+{
+    return peer->stream->send(EnvelopeVersion::Version1, std::move(bytes));
+}
+
+void
+chord_mesh::GossipMesh::emitError(const tempo_utils::Status &status)
+{
+    m_ctx->error(status);
+}
+
+void
+chord_mesh::GossipMesh::shutdown()
+{
+    if (m_shutdown)
+        return;
+    m_shutdown = true;
+
+    if (m_timer != nullptr) {
+        uv_timer_stop(m_timer);
+    }
+    if (m_acceptor != nullptr) {
+        m_acceptor->shutdown();
+    }
+    if (m_connector != nullptr) {
+        m_connector->shutdown();
+    }
+    for (auto &entry : m_peers) {
+        auto &peer = entry.second;
+        if (!peer->closed) {
+            peer->closed = true;
+            peer->inMesh = false;
+            peer->stream->shutdown();
+        }
+    }
+}
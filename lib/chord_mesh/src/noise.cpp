@@ -219,13 +219,13 @@ chord_mesh::Handshake::process(const tu_uint8 *data, size_t size)
 }
 
 tempo_utils::Result<std::shared_ptr<chord_mesh::Cipher>>
-chord_mesh::Handshake::finish()
+chord_mesh::Handshake::finish(const CipherOptions &options)
 {
     if (m_state != HandshakeState::Split)
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
             "invalid handshake state");
     auto cipher = std::shared_ptr<Cipher>(new Cipher());
-    TU_RETURN_IF_NOT_OK (cipher->initialize(m_handshake));
+    TU_RETURN_IF_NOT_OK (cipher->initialize(m_handshake, options));
     return cipher;
 }
 
@@ -254,7 +254,12 @@ chord_mesh::Handshake::popOutgoing()
 chord_mesh::Cipher::Cipher()
     : m_send(nullptr),
       m_recv(nullptr),
-      m_pending(std::make_unique<tempo_utils::BytesAppender>())
+      m_segmentSize(0),
+      m_frameHeader{},
+      m_frameHeaderSize(0),
+      m_frameSize(0),
+      m_frameFill(0),
+      m_frame(nullptr)
 {
 }
 
@@ -266,6 +271,9 @@ chord_mesh::Cipher::~Cipher()
     if (m_recv != nullptr) {
         noise_cipherstate_free(m_recv);
     }
+    if (m_frame != nullptr) {
+        free_stream_buf(m_frame);
+    }
     while (!m_output.empty()) {
         auto *streamBuf = m_output.front();
         m_output.pop();
@@ -274,43 +282,77 @@ chord_mesh::Cipher::~Cipher()
 }
 
 tempo_utils::Status
-chord_mesh::Cipher::initialize(NoiseHandshakeState *handshake)
+chord_mesh::Cipher::initialize(NoiseHandshakeState *handshake, const CipherOptions &options)
 {
+    if (options.segmentSize == 0 || options.segmentSize > kMaxCipherSegmentSize)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "invalid cipher segment size {}", options.segmentSize);
+    m_segmentSize = options.segmentSize;
+
+    // buffers are sized to hold a full frame, so the framing overhead is reserved up front
+    m_pool = options.pool;
+    if (m_pool == nullptr) {
+        m_pool = std::make_shared<StreamBufPool>(
+            m_segmentSize + kCipherFrameOverhead, kDefaultCipherPoolMaxFree);
+    }
+
     auto ret = noise_handshakestate_split(handshake, &m_send, &m_recv);
     if (ret != NOISE_ERROR_NONE)
         return noise_error_to_status(ret);
     return {};
 }
 
+tu_uint32
+chord_mesh::Cipher::getSegmentSize() const
+{
+    return m_segmentSize;
+}
+
 tempo_utils::Status
 chord_mesh::Cipher::decryptInput(const tu_uint8 *data, size_t size)
 {
-    m_pending->appendBytes(std::span(data, size));
-
-    for (;;) {
-        auto pendingSize = m_pending->getSize();
-        if (pendingSize < 2)
-            break;
-        auto *ptr = m_pending->getData();
-        tu_uint16 messageSize = tempo_utils::read_u16_and_advance(ptr);
-        if (pendingSize < messageSize + 2)
-            break;
-
-        auto pending = m_pending->finish()->toSlice();
-        m_pending = std::make_unique<tempo_utils::BytesAppender>();
-
-        auto message = pending.slice(2, messageSize);
-        auto remainder = pending.slice(messageSize + 2, pending.getSize() - (messageSize + 2));
-        m_pending->appendBytes(remainder.getSpan());
+    while (size > 0) {
+
+        // read the ciphertext size if we have not read the frame header yet
+        if (m_frame == nullptr) {
+            m_frameHeader[m_frameHeaderSize++] = *data++;
+            size--;
+            if (m_frameHeaderSize < 2)
+                continue;
+            const tu_uint8 *ptr = m_frameHeader;
+            m_frameSize = tempo_utils::read_u16_and_advance(ptr);
+            m_frameHeaderSize = 0;
+            if (m_frameSize < kCipherMacSize)
+                return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                    "invalid ciphertext frame size {}", m_frameSize);
+            m_frame = m_pool->allocate(m_frameSize);
+            m_frameFill = 0;
+            continue;
+        }
 
+        // copy ciphertext into the frame buffer
+        auto count = std::min<size_t>(size, m_frameSize - m_frameFill);
+        memcpy(m_frame->getData() + m_frameFill, data, count);
+        m_frameFill += count;
+        data += count;
+        size -= count;
+        if (m_frameFill < m_frameSize)
+            continue;
+
+        // decrypt the frame in place
+        auto *frame = m_frame;
+        m_frame = nullptr;
         NoiseBuffer buffer;
-        noise_buffer_set_input(buffer, (tu_uint8 *) message.getData(), message.getSize());
+        noise_buffer_set_inout(buffer, frame->getData(), m_frameSize, frame->getCapacity());
         auto ret = noise_cipherstate_decrypt(m_recv, &buffer);
-        if (ret != NOISE_ERROR_NONE)
+        if (ret != NOISE_ERROR_NONE) {
+            free_stream_buf(frame);
             return noise_error_to_status(ret);
+        }
 
-        auto input = tempo_utils::MemoryBytes::copy(std::span(buffer.data, buffer.size));
-        m_input.push(std::move(input));
+        // the plaintext is handed out as a view over the frame buffer
+        frame->setSize(buffer.size);
+        m_input.push(std::make_shared<StreamBufBytes>(frame));
     }
 
     return {};
@@ -332,9 +374,6 @@ chord_mesh::Cipher::popInput()
     return input;
 }
 
-constexpr int kBufMaxSize = 8192;
-constexpr int kBufSegSize = 4096;
-
 tempo_utils::Status
 chord_mesh::Cipher::encryptOutput(StreamBuf *streamBuf)
 {
@@ -344,25 +383,27 @@ chord_mesh::Cipher::encryptOutput(StreamBuf *streamBuf)
 
     auto *base = streamBuf->buf.base;
     auto size = streamBuf->buf.len;
-    int index = 0;
-    tu_uint8 buf[kBufMaxSize];
+    size_t index = 0;
 
     while (index < size) {
         auto remaining = size - index;
-        int count = remaining > kBufSegSize? kBufSegSize : remaining;
-        memcpy(buf + 2, base + index, count);
+        tu_uint32 count = remaining > m_segmentSize? m_segmentSize : remaining;
+
+        // encrypt directly into a pooled buffer which has room for the size prefix and the mac
+        auto *outputBuf = m_pool->allocate(count + kCipherFrameOverhead);
+        output.push(outputBuf);
+        auto *data = outputBuf->getData();
+        memcpy(data + 2, base + index, count);
         index += count;
 
-        noise_buffer_set_inout(buffer, buf + 2, count, kBufMaxSize - 2);
+        noise_buffer_set_inout(buffer, data + 2, count, outputBuf->getCapacity() - 2);
         ret = noise_cipherstate_encrypt(m_send, &buffer);
         if (ret != NOISE_ERROR_NONE)
             goto err;
 
         // write the ciphertext size
-        tempo_utils::write_u16(buffer.size, buf);
-
-        auto *outputBuf = ArrayBuf::allocate(buf, buffer.size + 2);
-        output.push(outputBuf);
+        tempo_utils::write_u16(buffer.size, data);
+        outputBuf->setSize(buffer.size + 2);
     }
 
     free_stream_buf(streamBuf);     // we free the streamBuf once we are sure encrypt will not fail
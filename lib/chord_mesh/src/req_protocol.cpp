@@ -1,5 +1,10 @@
 
+#include <algorithm>
+
+#include <chord_mesh/mesh_result.h>
 #include <chord_mesh/req_protocol.h>
+#include <tempo_utils/big_endian.h>
+#include <tempo_utils/bytes_appender.h>
 
 chord_mesh::ReqProtocolImpl::ReqProtocolImpl(
     std::shared_ptr<StreamConnector> connector,
@@ -8,6 +13,38 @@ chord_mesh::ReqProtocolImpl::ReqProtocolImpl(
       m_connector(std::move(connector))
 {
     TU_ASSERT (m_connector != nullptr);
+    TU_ASSERT (m_options.maxInFlight > 0);
+}
+
+chord_mesh::ReqProtocolImpl::~ReqProtocolImpl()
+{
+    // the timer handle is freed by the loop once it is closed
+    if (m_timer != nullptr) {
+        uv_timer_stop(m_timer);
+        m_timer->data = nullptr;
+        uv_close((uv_handle_t *) m_timer, [](uv_handle_t *handle) {
+            delete (uv_timer_t *) handle;
+        });
+    }
+}
+
+static std::shared_ptr<const tempo_utils::ImmutableBytes>
+write_request_header(tu_uint32 id)
+{
+    tempo_utils::BytesAppender appender;
+    appender.appendU32(id);
+    return appender.finish();
+}
+
+static bool
+read_request_header(const chord_mesh::Envelope &envelope, tu_uint32 &id)
+{
+    auto header = envelope.getHeader();
+    if (header == nullptr || header->getSize() != chord_mesh::kRequestHeaderSize)
+        return false;
+    const tu_uint8 *ptr = header->getData();
+    id = tempo_utils::read_u32_and_advance(ptr);
+    return true;
 }
 
 chord_mesh::ReqProtocolImpl::ReqStreamContext::ReqStreamContext(std::weak_ptr<ReqProtocolImpl> impl)
@@ -28,7 +65,7 @@ chord_mesh::ReqProtocolImpl::ReqStreamContext::receive(const Envelope &message)
 {
     auto impl = m_impl.lock();
     if (impl != nullptr) {
-        impl->receive(0, message.getPayload());
+        impl->completeRequest(message);
     }
 }
 
@@ -63,17 +100,20 @@ chord_mesh::ReqProtocolImpl::ReqConnectContext::connect(std::shared_ptr<Stream>
             return;
         }
 
+        impl->m_stream = std::move(stream);
+
         while (!impl->m_pending.empty()) {
             auto pending = impl->m_pending.front();
-            status = stream->send(EnvelopeVersion::Version1, pending.second);
             impl->m_pending.pop();
+            // skip requests which were cancelled or expired before the stream connected
+            if (!impl->m_inflight.contains(pending.first))
+                continue;
+            status = impl->sendRequest(pending.first, pending.second);
             if (status.notOk()) {
-                impl->emitError(status);
-                return;
+                impl->failRequest(pending.first, status);
             }
         }
 
-        impl->m_stream = std::move(stream);
         impl->ready();
 
     } else {
@@ -106,15 +146,182 @@ chord_mesh::ReqProtocolImpl::connect(const chord_common::TransportLocation &loca
 tempo_utils::Result<tu_uint32>
 chord_mesh::ReqProtocolImpl::send(std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
 {
+    return send(std::move(payload), {}, m_options.requestTimeout);
+}
+
+tempo_utils::Result<tu_uint32>
+chord_mesh::ReqProtocolImpl::send(
+    std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
+    CompletionFunc complete,
+    absl::Duration timeout)
+{
+    if (m_inflight.size() >= m_options.maxInFlight)
+        return MeshStatus::forCondition(MeshCondition::kTooManyRequests,
+            "exceeded maximum of {} requests in flight", m_options.maxInFlight);
+
+    // skip ids which are still in flight after the counter wraps around
     auto id = m_currId++;
+    while (m_inflight.contains(id)) {
+        id = m_currId++;
+    }
+
     if (m_stream != nullptr) {
-        TU_RETURN_IF_NOT_OK (m_stream->send(EnvelopeVersion::Version1, payload, absl::Now()));
+        TU_RETURN_IF_NOT_OK (sendRequest(id, payload));
     } else {
         m_pending.emplace(id, payload);
     }
+
+    InFlight inflight;
+    inflight.deadline = absl::Now() + timeout;
+    inflight.complete = std::move(complete);
+    m_inflight[id] = std::move(inflight);
+    if (timeout != absl::InfiniteDuration()) {
+        m_deadlines.emplace(m_inflight[id].deadline, id);
+        scheduleDeadline();
+    }
+
     return id;
 }
 
+tempo_utils::Status
+chord_mesh::ReqProtocolImpl::sendRequest(
+    tu_uint32 id,
+    std::shared_ptr<const tempo_utils::ImmutableBytes> payload)
+{
+    auto header = write_request_header(id);
+    return m_stream->send(EnvelopeVersion::Version1, header, payload, absl::Now());
+}
+
+bool
+chord_mesh::ReqProtocolImpl::cancel(tu_uint32 id)
+{
+    if (!m_inflight.contains(id))
+        return false;
+    failRequest(id, MeshStatus::forCondition(MeshCondition::kRequestCancelled,
+        "request {} was cancelled", id));
+    return true;
+}
+
+tu_uint32
+chord_mesh::ReqProtocolImpl::numInFlight() const
+{
+    return m_inflight.size();
+}
+
+void
+chord_mesh::ReqProtocolImpl::completeRequest(const Envelope &envelope)
+{
+    tu_uint32 id;
+    if (!read_request_header(envelope, id)) {
+        emitError(MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "reply is missing the request id"));
+        return;
+    }
+
+    // a reply for a request which expired or was cancelled is dropped
+    auto entry = m_inflight.find(id);
+    if (entry == m_inflight.cend()) {
+        TU_LOG_V << "dropping reply for unknown request " << id;
+        return;
+    }
+    auto inflight = std::move(entry->second);
+    m_inflight.erase(entry);
+    if (m_deadlines.erase({inflight.deadline, id}) > 0) {
+        scheduleDeadline();
+    }
+
+    if (inflight.complete) {
+        inflight.complete({}, envelope.getPayload());
+        return;
+    }
+    auto status = receive(id, envelope.getPayload());
+    if (status.notOk()) {
+        emitError(status);
+    }
+}
+
+void
+chord_mesh::ReqProtocolImpl::failRequest(tu_uint32 id, const tempo_utils::Status &status)
+{
+    auto entry = m_inflight.find(id);
+    if (entry == m_inflight.cend())
+        return;
+    auto inflight = std::move(entry->second);
+    m_inflight.erase(entry);
+    if (m_deadlines.erase({inflight.deadline, id}) > 0) {
+        scheduleDeadline();
+    }
+
+    if (inflight.complete) {
+        inflight.complete(status, {});
+    } else {
+        emitError(status);
+    }
+}
+
+void
+chord_mesh::ReqProtocolImpl::failAll(const tempo_utils::Status &status)
+{
+    auto inflight = std::move(m_inflight);
+    m_inflight.clear();
+    m_deadlines.clear();
+    if (m_timer != nullptr) {
+        uv_timer_stop(m_timer);
+    }
+    for (auto &entry : inflight) {
+        if (entry.second.complete) {
+            entry.second.complete(status, {});
+        }
+    }
+}
+
+void
+chord_mesh::on_request_deadline(uv_timer_t *timer)
+{
+    auto *impl = (ReqProtocolImpl *) timer->data;
+    if (impl != nullptr) {
+        impl->expireRequests();
+    }
+}
+
+void
+chord_mesh::ReqProtocolImpl::expireRequests()
+{
+    auto now = absl::Now();
+
+    // collect the expired ids first, as a completion callback may send or cancel requests
+    std::vector<tu_uint32> expired;
+    for (auto it = m_deadlines.cbegin(); it != m_deadlines.cend() && it->first <= now; it++) {
+        expired.push_back(it->second);
+    }
+    for (auto id : expired) {
+        failRequest(id, MeshStatus::forCondition(MeshCondition::kRequestTimeout,
+            "request {} timed out", id));
+    }
+
+    scheduleDeadline();
+}
+
+void
+chord_mesh::ReqProtocolImpl::scheduleDeadline()
+{
+    if (m_timer == nullptr) {
+        if (m_deadlines.empty())
+            return;
+        m_timer = new uv_timer_t;
+        uv_timer_init(m_connector->getManager()->getLoop(), m_timer);
+        m_timer->data = this;
+    }
+
+    // a single timer is armed for the earliest deadline
+    uv_timer_stop(m_timer);
+    if (m_deadlines.empty())
+        return;
+    auto remaining = m_deadlines.cbegin()->first - absl::Now();
+    auto timeoutMillis = absl::ToInt64Milliseconds(absl::Ceil(remaining, absl::Milliseconds(1)));
+    uv_timer_start(m_timer, on_request_deadline, std::max<tu_int64>(timeoutMillis, 0), 0);
+}
+
 void
 chord_mesh::ReqProtocolImpl::emitError(const tempo_utils::Status &status)
 {
@@ -124,8 +331,10 @@ chord_mesh::ReqProtocolImpl::emitError(const tempo_utils::Status &status)
 void
 chord_mesh::ReqProtocolImpl::shutdown()
 {
+    failAll(MeshStatus::forCondition(MeshCondition::kRequestCancelled,
+        "request protocol was shut down"));
     if (m_stream != nullptr) {
         m_stream->shutdown();
         m_stream.reset();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,147 @@
+#include <cstring>
+
+#include <chord_mesh/ring_buffer.h>
+#include <tempo_utils/log_stream.h>
+
+chord_mesh::RingBuffer::Block::Block(tu_uint32 capacity)
+    : data(std::make_unique_for_overwrite<tu_uint8[]>(capacity)),
+      capacity(capacity)
+{
+}
+
+chord_mesh::RingBuffer::SliceBytes::SliceBytes(
+    std::shared_ptr<const Block> block,
+    const tu_uint8 *data,
+    tu_uint32 size)
+    : m_block(std::move(block)),
+      m_data(data),
+      m_size(size)
+{
+    TU_ASSERT (m_block != nullptr);
+}
+
+const tu_uint8 *
+chord_mesh::RingBuffer::SliceBytes::getData() const
+{
+    return m_data;
+}
+
+tu_uint32
+chord_mesh::RingBuffer::SliceBytes::getSize() const
+{
+    return m_size;
+}
+
+chord_mesh::RingBuffer::RingBuffer(tu_uint32 initialCapacity)
+    : m_block(std::make_shared<Block>(initialCapacity > 0? initialCapacity : kDefaultRingBufferSize)),
+      m_head(0),
+      m_tail(0)
+{
+}
+
+tu_uint32
+chord_mesh::RingBuffer::getCapacity() const
+{
+    return m_block->capacity;
+}
+
+tu_uint32
+chord_mesh::RingBuffer::getSize() const
+{
+    return m_tail - m_head;
+}
+
+bool
+chord_mesh::RingBuffer::isEmpty() const
+{
+    return m_tail == m_head;
+}
+
+const tu_uint8 *
+chord_mesh::RingBuffer::getData() const
+{
+    return m_block->data.get() + m_head;
+}
+
+std::span<const tu_uint8>
+chord_mesh::RingBuffer::getSpan() const
+{
+    return std::span(getData(), getSize());
+}
+
+bool
+chord_mesh::RingBuffer::isShared() const
+{
+    return m_block.use_count() > 1;
+}
+
+void
+chord_mesh::RingBuffer::wrap(tu_uint32 required)
+{
+    auto size = getSize();
+    auto capacity = m_block->capacity;
+
+    // if nothing references the block and the unconsumed bytes plus the required bytes fit, then
+    // compact the unconsumed bytes to the front of the block
+    if (!isShared() && size + required <= capacity) {
+        if (size > 0) {
+            memmove(m_block->data.get(), m_block->data.get() + m_head, size);
+        }
+        m_head = 0;
+        m_tail = size;
+        return;
+    }
+
+    // otherwise allocate a new block, growing it if necessary. slices into the old block remain
+    // valid because they hold a reference to it.
+    while (capacity < size + required) {
+        capacity *= 2;
+    }
+    auto block = std::make_shared<Block>(capacity);
+    if (size > 0) {
+        memcpy(block->data.get(), m_block->data.get() + m_head, size);
+    }
+    m_block = std::move(block);
+    m_head = 0;
+    m_tail = size;
+}
+
+void
+chord_mesh::RingBuffer::append(std::span<const tu_uint8> bytes)
+{
+    if (bytes.empty())
+        return;
+    auto required = static_cast<tu_uint32>(bytes.size());
+    if (m_block->capacity - m_tail < required) {
+        wrap(required);
+    }
+    memcpy(m_block->data.get() + m_tail, bytes.data(), required);
+    m_tail += required;
+}
+
+std::shared_ptr<const tempo_utils::ImmutableBytes>
+chord_mesh::RingBuffer::slice(tu_uint32 offset, tu_uint32 size) const
+{
+    TU_ASSERT (offset + size <= getSize());
+    return std::make_shared<SliceBytes>(m_block, getData() + offset, size);
+}
+
+void
+chord_mesh::RingBuffer::consume(tu_uint32 size)
+{
+    TU_ASSERT (size <= getSize());
+    m_head += size;
+
+    // if the buffer is drained and unreferenced then rewind to the front of the block for free.
+    // a referenced block is never rewound, as that would overwrite bytes visible to a slice.
+    if (m_head == m_tail && !isShared()) {
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+void
+chord_mesh::RingBuffer::clear()
+{
+    consume(getSize());
+}
@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
+#include <absl/hash/hash.h>
+#include <absl/synchronization/notification.h>
+
+#include <chord_mesh/mesh_result.h>
+#include <chord_mesh/sharded_stream_manager.h>
+#include <chord_mesh/stream.h>
+
+chord_mesh::ShardedStreamManager::ShardedStreamManager(
+    const tempo_security::CertificateKeyPair &keypair,
+    std::shared_ptr<tempo_security::X509Store> trustStore,
+    const StreamManagerOps &ops,
+    const ShardedStreamManagerOptions &options)
+    : m_keypair(keypair),
+      m_trustStore(std::move(trustStore)),
+      m_ops(ops),
+      m_options(options),
+      m_handoffListener(nullptr),
+      m_nextShard(0),
+      m_running(false),
+      m_stopped(false)
+{
+    TU_ASSERT (m_keypair.isValid());
+    TU_ASSERT (m_trustStore != nullptr);
+
+    auto numShards = m_options.numShards;
+    if (numShards == 0) {
+        numShards = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (tu_uint32 i = 0; i < numShards; i++) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        uv_loop_init(&shard->loop);
+        uv_async_init(&shard->loop, &shard->async, process_shard_tasks);
+        shard->async.data = shard.get();
+        shard->manager = std::make_unique<StreamManager>(
+            &shard->loop, m_keypair, m_trustStore, m_ops, m_options.managerOptions);
+        shard->handoffInsecure = false;
+        shard->stopped = false;
+        m_shards.push_back(std::move(shard));
+    }
+}
+
+chord_mesh::ShardedStreamManager::~ShardedStreamManager()
+{
+    shutdown();
+    for (auto &shard : m_shards) {
+        shard->manager.reset();
+        auto ret = uv_loop_close(&shard->loop);
+        if (ret != 0) {
+            TU_LOG_WARN << "failed to close loop for shard " << shard->index << ": " << uv_strerror(ret);
+        }
+    }
+}
+
+tu_uint32
+chord_mesh::ShardedStreamManager::numShards() const
+{
+    return m_shards.size();
+}
+
+chord_mesh::StreamManager *
+chord_mesh::ShardedStreamManager::getShard(tu_uint32 index) const
+{
+    if (m_shards.size() <= index)
+        return nullptr;
+    return m_shards.at(index)->manager.get();
+}
+
+void
+chord_mesh::run_shard(void *arg)
+{
+    auto *shard = (ShardedStreamManager::Shard *) arg;
+    uv_run(&shard->loop, UV_RUN_DEFAULT);
+}
+
+void
+chord_mesh::process_shard_tasks(uv_async_t *async)
+{
+    auto *shard = (ShardedStreamManager::Shard *) async->data;
+
+    // take the queued tasks while holding the lock, then run them unlocked
+    std::queue<absl::AnyInvocable<void(StreamManager *)>> tasks;
+    {
+        absl::MutexLock locker(&shard->lock);
+        tasks.swap(shard->tasks);
+    }
+    while (!tasks.empty()) {
+        tasks.front()(shard->manager.get());
+        tasks.pop();
+    }
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::start()
+{
+    if (m_running)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "sharded stream manager is already running");
+    if (m_stopped)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "sharded stream manager is shut down");
+
+    for (auto &shard : m_shards) {
+        auto ret = uv_thread_create(&shard->tid, run_shard, shard.get());
+        if (ret != 0)
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "failed to start shard {}: {}", shard->index, uv_strerror(ret));
+    }
+    m_running = true;
+
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::post(tu_uint32 index, absl::AnyInvocable<void(StreamManager *)> task)
+{
+    if (m_shards.size() <= index)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "invalid shard index {}", index);
+    auto *shard = m_shards.at(index).get();
+    {
+        absl::MutexLock locker(&shard->lock);
+        if (shard->stopped)
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "shard {} is shut down", index);
+        shard->tasks.push(std::move(task));
+    }
+    uv_async_send(&shard->async);
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::runOnShard(
+    tu_uint32 index,
+    absl::AnyInvocable<tempo_utils::Status(Shard *)> fn)
+{
+    auto *shard = m_shards.at(index).get();
+
+    // if the loop threads are not running then it is safe to touch the shard directly
+    if (!m_running)
+        return fn(shard);
+
+    // otherwise run fn on the shard loop and wait for the result. this must not be called from
+    // a shard loop thread, as the wait would deadlock.
+    tempo_utils::Status status;
+    absl::Notification done;
+    TU_RETURN_IF_NOT_OK (post(index, [&](StreamManager *) {
+        status = fn(shard);
+        done.Notify();
+    }));
+    done.WaitForNotification();
+    return status;
+}
+
+tu_uint32
+chord_mesh::ShardedStreamManager::selectShard(const chord_common::TransportLocation &location)
+{
+    switch (m_options.assignment) {
+        case ShardAssignment::PeerHash:
+            return absl::Hash<std::string>{}(location.toString()) % m_shards.size();
+        case ShardAssignment::RoundRobin:
+        default:
+            return m_nextShard.fetch_add(1) % m_shards.size();
+    }
+}
+
+void
+chord_mesh::ShardedStreamManager::adopt(Shard *shard, uv_stream_t *client)
+{
+    if (shard->handoffCtx == nullptr) {
+        uv_close((uv_handle_t *) client, [](uv_handle_t *handle) { std::free(handle); });
+        return;
+    }
+
+    auto *handle = shard->manager->allocateStreamHandle(client, /* initiator= */ false, shard->handoffInsecure);
+    if (handle == nullptr) {
+        uv_close((uv_handle_t *) client, [](uv_handle_t *handle) { std::free(handle); });
+        return;
+    }
+    auto stream = std::make_shared<Stream>(handle);
+    shard->handoffCtx->accept(stream);
+}
+
+void
+chord_mesh::new_handoff_connection(uv_stream_t *server, int err)
+{
+    auto *sharded = (ShardedStreamManager *) server->data;
+
+    if (err < 0) {
+        sharded->emitError(
+            MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "failed to accept connection: {}", uv_strerror(err)));
+        return;
+    }
+
+    int ret;
+
+    auto *pipe = (uv_pipe_t *) std::malloc(sizeof(uv_pipe_t));
+    memset(pipe, 0, sizeof(uv_pipe_t));
+
+    ret = uv_pipe_init(server->loop, pipe, false);
+    if (ret != 0) {
+        std::free(pipe);
+        sharded->emitError(
+            MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "uv_pipe_init error: {}", uv_strerror(ret)));
+        return;
+    }
+
+    ret = uv_accept(server, (uv_stream_t *) pipe);
+    if (ret != 0) {
+        uv_close((uv_handle_t *) pipe, [](uv_handle_t *handle) { std::free(handle); });
+        sharded->emitError(
+            MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "uv_accept error: {}", uv_strerror(ret)));
+        return;
+    }
+
+    // unix connections are always assigned round-robin, as there is no peer address to hash
+    auto index = sharded->m_nextShard.fetch_add(1) % sharded->m_shards.size();
+    auto *shard = sharded->m_shards.at(index).get();
+
+    // the listener lives on the first shard, so a connection assigned to it is adopted directly
+    if (index == 0) {
+        sharded->adopt(shard, (uv_stream_t *) pipe);
+        return;
+    }
+
+    // otherwise duplicate the descriptor, release the handle on this loop, and reopen the
+    // descriptor on the loop of the assigned shard
+    uv_os_fd_t fd;
+    uv_fileno((uv_handle_t *) pipe, &fd);
+    auto handoff = dup(fd);
+    uv_close((uv_handle_t *) pipe, [](uv_handle_t *handle) { std::free(handle); });
+    if (handoff < 0) {
+        sharded->emitError(
+            MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "failed to hand off connection: {}", strerror(errno)));
+        return;
+    }
+
+    auto status = sharded->post(index, [sharded, shard, handoff](StreamManager *manager) {
+        auto *client = (uv_pipe_t *) std::malloc(sizeof(uv_pipe_t));
+        memset(client, 0, sizeof(uv_pipe_t));
+
+        auto ret = uv_pipe_init(manager->getLoop(), client, false);
+        if (ret != 0) {
+            std::free(client);
+            close(handoff);
+            sharded->emitError(
+                MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                    "uv_pipe_init error: {}", uv_strerror(ret)));
+            return;
+        }
+        ret = uv_pipe_open(client, handoff);
+        if (ret != 0) {
+            uv_close((uv_handle_t *) client, [](uv_handle_t *handle) { std::free(handle); });
+            close(handoff);
+            sharded->emitError(
+                MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                    "uv_pipe_open error: {}", uv_strerror(ret)));
+            return;
+        }
+
+        sharded->adopt(shard, (uv_stream_t *) client);
+    });
+
+    // if the shard has stopped then the task was never queued, so the descriptor must be closed here
+    if (status.notOk()) {
+        close(handoff);
+        sharded->emitError(status);
+    }
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::listenUnix(
+    std::string_view pipePath,
+    int pipeFlags,
+    AcceptContextFactory factory,
+    const StreamAcceptorOptions &options)
+{
+    TU_ASSERT (factory != nullptr);
+    if (m_handoffListener != nullptr)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "sharded stream manager is already listening on a unix socket");
+
+    // each shard gets its own accept context for the streams handed off to it
+    for (tu_uint32 i = 0; i < m_shards.size(); i++) {
+        TU_RETURN_IF_NOT_OK (runOnShard(i, [&](Shard *shard) -> tempo_utils::Status {
+            shard->handoffCtx = factory(shard->index);
+            shard->handoffInsecure = options.allowInsecure;
+            return {};
+        }));
+    }
+
+    // the listener is bound on the first shard only
+    return runOnShard(0, [&](Shard *shard) -> tempo_utils::Status {
+        int ret;
+
+        auto *pipe = (uv_pipe_t *) std::malloc(sizeof(uv_pipe_t));
+        memset(pipe, 0, sizeof(uv_pipe_t));
+
+        ret = uv_pipe_init(&shard->loop, pipe, false);
+        if (ret != 0) {
+            std::free(pipe);
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "uv_pipe_init failed: {}", uv_strerror(ret));
+        }
+
+        ret = uv_pipe_bind2(pipe, pipePath.data(), pipePath.size(), pipeFlags);
+        if (ret != 0) {
+            uv_close((uv_handle_t *) pipe, [](uv_handle_t *handle) { std::free(handle); });
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "uv_pipe_bind2 failed: {}", uv_strerror(ret));
+        }
+
+        pipe->data = this;
+        ret = uv_listen((uv_stream_t *) pipe, 64, new_handoff_connection);
+        if (ret != 0) {
+            uv_close((uv_handle_t *) pipe, [](uv_handle_t *handle) { std::free(handle); });
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "uv_listen failed: {}", uv_strerror(ret));
+        }
+
+        m_handoffListener = pipe;
+        return {};
+    });
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::listenTcp4(
+    std::string_view ipAddress,
+    tu_uint16 tcpPort,
+    AcceptContextFactory factory,
+    const StreamAcceptorOptions &options)
+{
+    TU_ASSERT (factory != nullptr);
+
+    // an ephemeral port would bind each shard to a different port
+    if (tcpPort == 0 && m_shards.size() > 1)
+        return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+            "sharded tcp listener requires an explicit port");
+
+    StreamAcceptorOptions acceptorOptions = options;
+    acceptorOptions.reusePort = true;
+
+    for (tu_uint32 i = 0; i < m_shards.size(); i++) {
+        TU_RETURN_IF_NOT_OK (runOnShard(i, [&](Shard *shard) -> tempo_utils::Status {
+            std::shared_ptr<StreamAcceptor> acceptor;
+            TU_ASSIGN_OR_RETURN (acceptor, StreamAcceptor::create(shard->manager.get(), acceptorOptions));
+            TU_RETURN_IF_NOT_OK (acceptor->listenTcp4(ipAddress, tcpPort, factory(shard->index)));
+            shard->acceptors.push_back(std::move(acceptor));
+            return {};
+        }));
+    }
+
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::listenLocation(
+    const chord_common::TransportLocation &location,
+    AcceptContextFactory factory,
+    const StreamAcceptorOptions &options)
+{
+    switch (location.getType()) {
+        case chord_common::TransportType::Unix:
+            return listenUnix(location.getUnixPath().c_str(), 0, std::move(factory), options);
+        case chord_common::TransportType::Tcp4:
+            return listenTcp4(location.getTcp4Address(), location.getTcp4Port(), std::move(factory), options);
+        default:
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "invalid listener location");
+    }
+}
+
+tempo_utils::Status
+chord_mesh::ShardedStreamManager::connectLocation(
+    const chord_common::TransportLocation &location,
+    std::unique_ptr<AbstractConnectContext> &&ctx,
+    const StreamConnectorOptions &options)
+{
+    TU_ASSERT (ctx != nullptr);
+    auto index = selectShard(location);
+    auto *shard = m_shards.at(index).get();
+
+    return post(index, [this, shard, location, options, ctx = std::move(ctx)](StreamManager *manager) mutable {
+        auto &connector = options.startInsecure? shard->insecureConnector : shard->secureConnector;
+        if (connector == nullptr) {
+            auto createConnectorResult = StreamConnector::create(manager, options);
+            if (createConnectorResult.isStatus()) {
+                emitError(createConnectorResult.getStatus());
+                return;
+            }
+            connector = createConnectorResult.getResult();
+        }
+        // the connect handle is released when the connect completes
+        auto connectResult = connector->connectLocation(location, std::move(ctx));
+        if (connectResult.isStatus()) {
+            emitError(connectResult.getStatus());
+        }
+    });
+}
+
+void
+chord_mesh::ShardedStreamManager::shutdown()
+{
+    if (m_stopped)
+        return;
+    m_stopped = true;
+
+    for (tu_uint32 i = 0; i < m_shards.size(); i++) {
+        runOnShard(i, [this](Shard *shard) -> tempo_utils::Status {
+            for (auto &acceptor : shard->acceptors) {
+                acceptor->shutdown();
+            }
+            shard->acceptors.clear();
+            shard->secureConnector.reset();
+            shard->insecureConnector.reset();
+            if (shard->index == 0 && m_handoffListener != nullptr) {
+                uv_close((uv_handle_t *) m_handoffListener, [](uv_handle_t *handle) { std::free(handle); });
+                m_handoffListener = nullptr;
+            }
+            if (shard->handoffCtx != nullptr) {
+                shard->handoffCtx->cleanup();
+                shard->handoffCtx.reset();
+            }
+            shard->manager->shutdown();
+            {
+                absl::MutexLock locker(&shard->lock);
+                shard->stopped = true;
+            }
+            uv_close((uv_handle_t *) &shard->async, nullptr);
+            uv_stop(&shard->loop);
+            return {};
+        });
+    }
+
+    if (m_running) {
+        for (auto &shard : m_shards) {
+            uv_thread_join(&shard->tid);
+        }
+        m_running = false;
+    }
+
+    // run each loop once more on this thread so pending close callbacks are invoked
+    for (auto &shard : m_shards) {
+        uv_run(&shard->loop, UV_RUN_NOWAIT);
+    }
+}
+
+void
+chord_mesh::ShardedStreamManager::emitError(const tempo_utils::Status &status)
+{
+    if (m_ops.error != nullptr) {
+        m_ops.error(status, m_options.managerOptions.data);
+    }
+}
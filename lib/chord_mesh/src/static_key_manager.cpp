@@ -0,0 +1,112 @@
+#include <chord_mesh/mesh_result.h>
+#include <chord_mesh/static_key_manager.h>
+
+chord_mesh::StaticKeyManager::StaticKeyManager(
+    const tempo_security::CertificateKeyPair &keypair,
+    std::shared_ptr<tempo_security::X509Store> trustStore,
+    const StaticKeyManagerOptions &options)
+    : m_keypair(keypair),
+      m_trustStore(std::move(trustStore)),
+      m_options(options),
+      m_localKeyExpiry(absl::InfinitePast()),
+      m_cacheHits(0),
+      m_cacheMisses(0)
+{
+    TU_ASSERT (m_keypair.isValid());
+    TU_ASSERT (m_trustStore != nullptr);
+}
+
+tempo_utils::Status
+chord_mesh::StaticKeyManager::getLocalKey(
+    std::shared_ptr<tempo_security::X509Certificate> &certificate,
+    StaticKeypair &staticKeypair)
+{
+    if (m_certificate == nullptr || m_localKeyExpiry <= absl::Now()) {
+        TU_RETURN_IF_NOT_OK (rotateLocalKey());
+    }
+    certificate = m_certificate;
+    staticKeypair = m_localKey;
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::StaticKeyManager::rotateLocalKey()
+{
+    // the certificate and private key are reread on rotation so renewed files on disk are picked up
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    TU_ASSIGN_OR_RETURN (certificate, tempo_security::X509Certificate::readFile(m_keypair.getPemCertificateFile()));
+    std::shared_ptr<tempo_security::PrivateKey> privateKey;
+    TU_ASSIGN_OR_RETURN (privateKey, tempo_security::PrivateKey::readFile(m_keypair.getPemPrivateKeyFile()));
+
+    // generate the noise keypair and sign it using the private key
+    StaticKeypair localKey;
+    TU_RETURN_IF_NOT_OK (generate_static_key(privateKey, localKey));
+
+    m_certificate = std::move(certificate);
+    m_localKey = std::move(localKey);
+    m_localKeyExpiry = absl::Now() + m_options.keyRotationInterval;
+
+    TU_LOG_V << "rotated local static key, next rotation at " << absl::FormatTime(m_localKeyExpiry);
+
+    return {};
+}
+
+tempo_utils::Status
+chord_mesh::StaticKeyManager::validateRemoteKey(
+    std::span<const tu_uint8> publicKey,
+    std::shared_ptr<tempo_security::X509Certificate> certificate,
+    const tempo_security::Digest &digest)
+{
+    TU_ASSERT (certificate != nullptr);
+    auto now = absl::Now();
+
+    // the cache key is the full certificate and public key, so a hit implies an exact match
+    auto key = certificate->toPem();
+    key.append((const char *) publicKey.data(), publicKey.size());
+
+    auto entry = m_verified.find(key);
+    if (entry != m_verified.cend()) {
+        auto it = entry->second;
+        if (now < it->expiry) {
+            m_lru.splice(m_lru.begin(), m_lru, it);
+            m_cacheHits++;
+            return {};
+        }
+        m_verified.erase(entry);
+        m_lru.erase(it);
+    }
+    m_cacheMisses++;
+
+    TU_RETURN_IF_NOT_OK (validate_static_key(publicKey, certificate, m_trustStore, digest));
+
+    if (m_options.verifiedPeerCacheSize == 0)
+        return {};
+
+    // evict the least recently used peer if the cache is full
+    if (m_lru.size() >= m_options.verifiedPeerCacheSize) {
+        m_verified.erase(m_lru.back().key);
+        m_lru.pop_back();
+    }
+    m_lru.push_front(VerifiedPeer{key, now + m_options.verifiedPeerLifetime});
+    m_verified[key] = m_lru.begin();
+
+    return {};
+}
+
+tu_uint32
+chord_mesh::StaticKeyManager::numVerifiedPeers() const
+{
+    return m_lru.size();
+}
+
+tu_uint64
+chord_mesh::StaticKeyManager::getCacheHits() const
+{
+    return m_cacheHits;
+}
+
+tu_uint64
+chord_mesh::StaticKeyManager::getCacheMisses() const
+{
+    return m_cacheMisses;
+}
@@ -29,6 +29,12 @@ chord_mesh::Stream::isSecure() const
     return !m_handle->insecure;
 }
 
+bool
+chord_mesh::Stream::isWritable() const
+{
+    return m_handle->isWritable();
+}
+
 tempo_utils::UUID
 chord_mesh::Stream::getId() const
 {
@@ -58,12 +64,23 @@ chord_mesh::Stream::send(
     EnvelopeVersion version,
     std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
     absl::Time timestamp)
+{
+    return send(version, {}, std::move(payload), timestamp);
+}
+
+tempo_utils::Status
+chord_mesh::Stream::send(
+    EnvelopeVersion version,
+    std::shared_ptr<const tempo_utils::ImmutableBytes> header,
+    std::shared_ptr<const tempo_utils::ImmutableBytes> payload,
+    absl::Time timestamp)
 {
     if (m_handle->state == StreamState::Closed)
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
             "stream is closed");
     EnvelopeBuilder builder;
     builder.setVersion(version);
+    TU_RETURN_IF_NOT_OK (builder.setHeader(std::move(header)));
     builder.setPayload(std::move(payload));
     builder.setTimestamp(timestamp);
     std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
@@ -1,4 +1,6 @@
 
+#include <sys/socket.h>
+
 #include <chord_mesh/mesh_result.h>
 #include <chord_mesh/stream.h>
 #include <chord_mesh/stream_acceptor.h>
@@ -186,11 +188,24 @@ chord_mesh::StreamAcceptor::listenTcp4(
     auto *tcp = (uv_tcp_t *) std::malloc(sizeof(uv_tcp_t));
     memset(tcp, 0, sizeof(uv_tcp_t));
 
-    ret = uv_tcp_init(loop, tcp);
+    // the socket is created eagerly so that socket options can be set before binding
+    ret = uv_tcp_init_ex(loop, tcp, AF_INET);
     if (ret != 0) {
         std::free(tcp);
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
-            "uv_tcp_init failed: {}", uv_strerror(ret));
+            "uv_tcp_init_ex failed: {}", uv_strerror(ret));
+    }
+
+    if (m_options.reusePort) {
+        uv_os_fd_t fd;
+        uv_fileno((uv_handle_t *) tcp, &fd);
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            auto err = errno;
+            uv_close((uv_handle_t *) tcp, [](uv_handle_t *handle) { std::free(handle); });
+            return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
+                "failed to set SO_REUSEPORT: {}", strerror(err));
+        }
     }
 
     ret = uv_tcp_bind(tcp, (const sockaddr *) &addr, 0);
@@ -1,5 +1,6 @@
 
 #include <chord_mesh/stream_buf.h>
+#include <tempo_utils/log_stream.h>
 
 std::span<const tu_uint8>
 chord_mesh::StreamBuf::getSpan() const
@@ -94,3 +95,126 @@ chord_mesh::ArrayBuf::allocate(std::string_view str)
 {
     return allocate((const tu_uint8 *) str.data(), str.size());
 }
+
+chord_mesh::PooledBuf::PooledBuf(tu_uint32 capacity)
+    : m_data(std::make_unique_for_overwrite<tu_uint8[]>(capacity)),
+      m_capacity(capacity)
+{
+    buf = uv_buf_init((char *) m_data.get(), m_capacity);
+}
+
+tu_uint8 *
+chord_mesh::PooledBuf::getData()
+{
+    return m_data.get();
+}
+
+tu_uint32
+chord_mesh::PooledBuf::getCapacity() const
+{
+    return m_capacity;
+}
+
+void
+chord_mesh::PooledBuf::setSize(tu_uint32 size)
+{
+    TU_ASSERT (size <= m_capacity);
+    buf.len = size;
+}
+
+void
+chord_mesh::free_pooled_buf(StreamBuf *streamBuf)
+{
+    auto *pooledBuf = static_cast<PooledBuf *>(streamBuf);
+    auto pool = std::move(pooledBuf->m_pool);
+    if (pool != nullptr) {
+        pool->release(pooledBuf);
+    } else {
+        delete pooledBuf;
+    }
+}
+
+chord_mesh::StreamBufPool::StreamBufPool(tu_uint32 bufferSize, tu_uint32 maxFree)
+    : m_bufferSize(bufferSize),
+      m_maxFree(maxFree)
+{
+    TU_ASSERT (m_bufferSize > 0);
+    m_free.reserve(m_maxFree);
+}
+
+chord_mesh::StreamBufPool::~StreamBufPool()
+{
+    for (auto *pooledBuf : m_free) {
+        delete pooledBuf;
+    }
+}
+
+tu_uint32
+chord_mesh::StreamBufPool::getBufferSize() const
+{
+    return m_bufferSize;
+}
+
+tu_uint32
+chord_mesh::StreamBufPool::getFreeCount() const
+{
+    return m_free.size();
+}
+
+chord_mesh::PooledBuf *
+chord_mesh::StreamBufPool::allocate(tu_uint32 size)
+{
+    PooledBuf *pooledBuf;
+
+    if (size > m_bufferSize) {
+        // oversized buffers are never recycled so they don't hold a reference to the pool
+        pooledBuf = new PooledBuf(size);
+    } else {
+        if (!m_free.empty()) {
+            pooledBuf = m_free.back();
+            m_free.pop_back();
+        } else {
+            pooledBuf = new PooledBuf(m_bufferSize);
+        }
+        pooledBuf->m_pool = shared_from_this();
+    }
+
+    pooledBuf->free = free_pooled_buf;
+    pooledBuf->setSize(size);
+    return pooledBuf;
+}
+
+void
+chord_mesh::StreamBufPool::release(PooledBuf *pooledBuf)
+{
+    // the buffer does not hold a reference to the pool while it is on the free list
+    TU_ASSERT (pooledBuf->m_pool == nullptr);
+    if (m_free.size() < m_maxFree) {
+        m_free.push_back(pooledBuf);
+    } else {
+        delete pooledBuf;
+    }
+}
+
+chord_mesh::StreamBufBytes::StreamBufBytes(StreamBuf *streamBuf)
+    : m_streamBuf(streamBuf)
+{
+    TU_ASSERT (m_streamBuf != nullptr);
+}
+
+chord_mesh::StreamBufBytes::~StreamBufBytes()
+{
+    free_stream_buf(m_streamBuf);
+}
+
+const tu_uint8 *
+chord_mesh::StreamBufBytes::getData() const
+{
+    return (const tu_uint8 *) m_streamBuf->buf.base;
+}
+
+tu_uint32
+chord_mesh::StreamBufBytes::getSize() const
+{
+    return m_streamBuf->buf.len;
+}
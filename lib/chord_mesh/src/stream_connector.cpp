@@ -191,6 +191,12 @@ chord_mesh::StreamConnector::connectLocation(
     }
 }
 
+chord_mesh::StreamManager *
+chord_mesh::StreamConnector::getManager() const
+{
+    return m_manager;
+}
+
 void
 chord_mesh::StreamConnector::shutdown()
 {
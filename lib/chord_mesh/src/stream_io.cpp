@@ -113,8 +113,19 @@ chord_mesh::InitialStreamBehavior::takePending()
     return std::move(m_pending);
 }
 
+// data envelopes are parsed in zero copy mode, so payloads delivered to the stream context
+// reference the receive buffer directly
+static chord_mesh::EnvelopeParserOptions
+data_parser_options()
+{
+    chord_mesh::EnvelopeParserOptions options;
+    options.zeroCopy = true;
+    return options;
+}
+
 chord_mesh::InsecureStreamBehavior::InsecureStreamBehavior(bool secure)
     : m_secure(secure),
+      m_parser(data_parser_options()),
       m_pending(std::make_unique<Pending>())
 {
 }
@@ -400,10 +411,10 @@ chord_mesh::HandshakingStreamBehavior::process(
 }
 
 tempo_utils::Result<std::shared_ptr<chord_mesh::Cipher>>
-chord_mesh::HandshakingStreamBehavior::finish()
+chord_mesh::HandshakingStreamBehavior::finish(const CipherOptions &options)
 {
     std::shared_ptr<Cipher> cipher;
-    TU_ASSIGN_OR_RETURN (cipher, m_handshake->finish());
+    TU_ASSIGN_OR_RETURN (cipher, m_handshake->finish(options));
 
     if (m_parser.hasPending()) {
         auto pending = m_parser.popPending();
@@ -455,7 +466,8 @@ chord_mesh::SecureStreamBehavior::SecureStreamBehavior(
     std::shared_ptr<Cipher> cipher,
     std::unique_ptr<Pending> &&pending)
     : m_cipher(std::move(cipher)),
-      m_pending(std::move(pending))
+      m_pending(std::move(pending)),
+      m_parser(data_parser_options())
 {
     TU_ASSERT (m_cipher != nullptr);
 }
@@ -612,8 +624,8 @@ chord_mesh::StreamIO::negotiateRemote(
     const tempo_security::Digest &digest)
 {
     // validate the public key is signed by a trusted certificate
-    auto trustStore = m_manager->getTrustStore();
-    TU_RETURN_IF_NOT_OK (validate_static_key(remotePublicKey, certificate, trustStore, digest));
+    auto *staticKeys = m_manager->getStaticKeyManager();
+    TU_RETURN_IF_NOT_OK (staticKeys->validateRemoteKey(remotePublicKey, certificate, digest));
 
     switch (m_state) {
 
@@ -742,7 +754,7 @@ chord_mesh::StreamIO::processHandshake(std::span<const tu_uint8> data, bool &fin
         return {};
 
     std::shared_ptr<Cipher> cipher;
-    TU_ASSIGN_OR_RETURN (cipher, handshaking->finish());
+    TU_ASSIGN_OR_RETURN (cipher, handshaking->finish(m_manager->getCipherOptions()));
 
     auto secure = std::make_unique<SecureStreamBehavior>(cipher, std::move(pending));
     TU_RETURN_IF_NOT_OK (secure->start(m_writer));
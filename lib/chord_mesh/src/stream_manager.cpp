@@ -15,6 +15,8 @@ chord_mesh::StreamManager::StreamManager(
       m_trustStore(std::move(trustStore)),
       m_ops(ops),
       m_options(options),
+      m_bufPool(std::make_shared<StreamBufPool>(
+          options.cipherSegmentSize + kCipherFrameOverhead, options.cipherPoolMaxFree)),
       m_connects(nullptr),
       m_accepts(nullptr),
       m_streams(nullptr),
@@ -23,6 +25,13 @@ chord_mesh::StreamManager::StreamManager(
     TU_ASSERT (m_loop != nullptr);
     TU_ASSERT (m_keypair.isValid());
     TU_ASSERT (m_trustStore != nullptr);
+    TU_ASSERT (m_options.writeLowWatermark <= m_options.writeHighWatermark);
+
+    StaticKeyManagerOptions staticKeyOptions;
+    staticKeyOptions.keyRotationInterval = m_options.staticKeyRotationInterval;
+    staticKeyOptions.verifiedPeerCacheSize = m_options.verifiedPeerCacheSize;
+    staticKeyOptions.verifiedPeerLifetime = m_options.verifiedPeerLifetime;
+    m_staticKeys = std::make_unique<StaticKeyManager>(m_keypair, m_trustStore, staticKeyOptions);
 }
 
 uv_loop_t *
@@ -43,6 +52,12 @@ chord_mesh::StreamManager::getKeypair() const
     return m_keypair;
 }
 
+chord_mesh::StaticKeyManager *
+chord_mesh::StreamManager::getStaticKeyManager() const
+{
+    return m_staticKeys.get();
+}
+
 std::string
 chord_mesh::StreamManager::getProtocolName() const
 {
@@ -51,6 +66,27 @@ chord_mesh::StreamManager::getProtocolName() const
     return kDefaultNoiseProtocol;
 }
 
+tu_uint32
+chord_mesh::StreamManager::getWriteHighWatermark() const
+{
+    return m_options.writeHighWatermark;
+}
+
+tu_uint32
+chord_mesh::StreamManager::getWriteLowWatermark() const
+{
+    return m_options.writeLowWatermark;
+}
+
+chord_mesh::CipherOptions
+chord_mesh::StreamManager::getCipherOptions() const
+{
+    CipherOptions options;
+    options.segmentSize = m_options.cipherSegmentSize;
+    options.pool = m_bufPool;
+    return options;
+}
+
 chord_mesh::ConnectHandle *
 chord_mesh::StreamManager::allocateConnectHandle(
     uv_connect_t *connect,
@@ -559,6 +595,12 @@ chord_mesh::StreamHandle::send(std::shared_ptr<const tempo_utils::ImmutableBytes
     return session->write(std::move(bytes));
 }
 
+bool
+chord_mesh::StreamHandle::isWritable() const
+{
+    return session->isWritable();
+}
+
 void
 chord_mesh::StreamHandle::receive(const Envelope &envelope)
 {
@@ -566,6 +608,14 @@ chord_mesh::StreamHandle::receive(const Envelope &envelope)
     ctx->receive(envelope);
 }
 
+void
+chord_mesh::StreamHandle::writable(bool writable)
+{
+    if (ctx != nullptr) {
+        ctx->writable(writable);
+    }
+}
+
 void
 chord_mesh::StreamHandle::error(const tempo_utils::Status &status)
 {
@@ -9,10 +9,36 @@ chord_mesh::StreamSession::StreamSession(
     bool initiator,
     bool insecure)
     : m_handle(handle),
-      m_insecure(insecure)
+      m_insecure(insecure),
+      m_req{},
+      m_writing(false),
+      m_writable(true),
+      m_queuedBytes(0)
 {
     TU_ASSERT (m_handle != nullptr);
     m_io = std::make_unique<StreamIO>(initiator, m_handle->manager, this);
+    m_inflight.reserve(kMaxWriteBufs);
+    m_bufs.reserve(kMaxWriteBufs);
+}
+
+chord_mesh::StreamSession::~StreamSession()
+{
+    for (auto *streamBuf : m_inflight) {
+        free_stream_buf(streamBuf);
+    }
+    discardQueued();
+}
+
+bool
+chord_mesh::StreamSession::isWritable() const
+{
+    return m_writable;
+}
+
+size_t
+chord_mesh::StreamSession::getQueuedBytes() const
+{
+    return m_queuedBytes;
 }
 
 void
@@ -75,17 +101,12 @@ chord_mesh::StreamSession::negotiate(std::string_view protocolName)
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
             "invalid stream state");
 
-    auto *manager = m_handle->manager;
-    auto keypair = manager->getKeypair();
+    auto *staticKeys = m_handle->manager->getStaticKeyManager();
 
+    // get the signed noise keypair, which is shared by all streams until it is rotated
     std::shared_ptr<tempo_security::X509Certificate> certificate;
-    TU_ASSIGN_OR_RETURN (certificate, tempo_security::X509Certificate::readFile(keypair.getPemCertificateFile()));
-    std::shared_ptr<tempo_security::PrivateKey> privateKey;
-    TU_ASSIGN_OR_RETURN (privateKey, tempo_security::PrivateKey::readFile(keypair.getPemPrivateKeyFile()));
-
-    // generate the noise keypair and sign it using the private key
     StaticKeypair localKeypair;
-    TU_RETURN_IF_NOT_OK (generate_static_key(privateKey, localKeypair));
+    TU_RETURN_IF_NOT_OK (staticKeys->getLocalKey(certificate, localKeypair));
 
     // perform the local handshake
     TU_RETURN_IF_NOT_OK (m_io->negotiateLocal(protocolName, certificate, localKeypair));
@@ -195,35 +216,109 @@ chord_mesh::StreamSession::write(std::shared_ptr<const tempo_utils::ImmutableByt
 void
 chord_mesh::write_completed(uv_write_t *req, int err)
 {
-    auto *streamBuf = (StreamBuf *) req->data;
     auto *handle = (StreamHandle *) req->handle->data;
+    auto *session = handle->session.get();
+    TU_ASSERT (req == &session->m_req);
 
-    // we are done with req and streamBuf
-    std::free(req);
-    free_stream_buf(streamBuf);
+    // we are done with the in-flight bufs
+    for (auto *streamBuf : session->m_inflight) {
+        session->m_queuedBytes -= streamBuf->buf.len;
+        free_stream_buf(streamBuf);
+    }
+    session->m_inflight.clear();
+    session->m_writing = false;
 
     if (err < 0) {
+        session->discardQueued();
         handle->error(
             MeshStatus::forCondition(MeshCondition::kMeshInvariant,
                 "perform_write error: {}", uv_strerror(err)));
+        return;
     }
 
-    // TODO: signal write completion to StreamIO
+    // write any bufs which were queued while the write was in flight
+    if (!session->m_queued.empty()) {
+        auto status = session->flush();
+        if (status.notOk()) {
+            session->discardQueued();
+            handle->error(status);
+            return;
+        }
+    }
+
+    // signal the stream is writable if the queue has drained below the low watermark
+    auto lowWatermark = handle->manager->getWriteLowWatermark();
+    if (!session->m_writable && session->m_queuedBytes <= lowWatermark) {
+        session->m_writable = true;
+        handle->writable(true);
+    }
 }
 
 tempo_utils::Status
-chord_mesh::StreamSession::write(StreamBuf *streamBuf)
+chord_mesh::StreamSession::flush()
 {
-    // construct write req which will be freed in write_completed callback
-    auto *req = (uv_write_t *) std::malloc(sizeof(uv_write_t));
-    memset(req, 0, sizeof(uv_write_t));
-    req->data = streamBuf;
+    TU_ASSERT (!m_writing);
+
+    // coalesce queued bufs into a single write
+    m_bufs.clear();
+    while (!m_queued.empty() && m_inflight.size() < kMaxWriteBufs) {
+        auto *streamBuf = m_queued.front();
+        m_queued.pop_front();
+        m_inflight.push_back(streamBuf);
+        m_bufs.push_back(streamBuf->buf);
+    }
 
-    auto ret = uv_write(req, m_handle->stream, &streamBuf->buf, 1, write_completed);
+    memset(&m_req, 0, sizeof(uv_write_t));
+    auto ret = uv_write(&m_req, m_handle->stream, m_bufs.data(), m_bufs.size(), write_completed);
     if (ret != 0) {
-        std::free(req); // we free req but leave streamBuf untouched
+        // return the bufs to the front of the queue in their original order
+        for (auto it = m_inflight.rbegin(); it != m_inflight.rend(); it++) {
+            m_queued.push_front(*it);
+        }
+        m_inflight.clear();
         return MeshStatus::forCondition(MeshCondition::kMeshInvariant,
             "write error: {}", uv_strerror(ret));
     }
+
+    m_writing = true;
+    return {};
+}
+
+void
+chord_mesh::StreamSession::discardQueued()
+{
+    while (!m_queued.empty()) {
+        auto *streamBuf = m_queued.front();
+        m_queued.pop_front();
+        m_queuedBytes -= streamBuf->buf.len;
+        free_stream_buf(streamBuf);
+    }
+}
+
+tempo_utils::Status
+chord_mesh::StreamSession::write(StreamBuf *streamBuf)
+{
+    m_queued.push_back(streamBuf);
+    m_queuedBytes += streamBuf->buf.len;
+
+    // if no write is in flight then the queue held no other bufs, so write immediately
+    if (!m_writing) {
+        auto status = flush();
+        if (status.notOk()) {
+            // we remove streamBuf from the queue but leave it untouched
+            TU_ASSERT (m_queued.size() == 1);
+            m_queued.pop_back();
+            m_queuedBytes -= streamBuf->buf.len;
+            return status;
+        }
+    }
+
+    // signal the stream is not writable if the queue has grown above the high watermark
+    auto highWatermark = m_handle->manager->getWriteHighWatermark();
+    if (m_writable && m_queuedBytes > highWatermark) {
+        m_writable = false;
+        m_handle->writable(false);
+    }
+
     return {};
 }
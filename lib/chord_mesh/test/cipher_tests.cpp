@@ -66,6 +66,9 @@ protected:
         TU_ASSIGN_OR_RAISE (trustStore, tempo_security::X509Store::loadTrustedCerts(
             options, {caKeypair.getPemCertificateFile()}));
 
+        performHandshake({});
+    }
+    void performHandshake(const chord_mesh::CipherOptions &options) {
         std::shared_ptr<chord_mesh::Handshake> initiatorHandshake;
         TU_ASSIGN_OR_RAISE (initiatorHandshake, chord_mesh::Handshake::create("Noise_KK_25519_ChaChaPoly_BLAKE2s",
             true, initiatorKeypair.privateKey, responderKeypair.publicKey));
@@ -92,10 +95,10 @@ protected:
         }
 
         TU_ASSERT (initiatorHandshake->getHandshakeState() == chord_mesh::HandshakeState::Split);
-        TU_ASSIGN_OR_RAISE (initiator, initiatorHandshake->finish());
+        TU_ASSIGN_OR_RAISE (initiator, initiatorHandshake->finish(options));
 
         TU_ASSERT (responderHandshake->getHandshakeState() == chord_mesh::HandshakeState::Split);
-        TU_ASSIGN_OR_RAISE (responder, responderHandshake->finish());
+        TU_ASSIGN_OR_RAISE (responder, responderHandshake->finish(options));
     }
     void TearDown() override {
         BaseMeshFixture::TearDown();
@@ -123,3 +126,78 @@ TEST_F(Cipher, SendAndReceive)
     auto input = responder->popInput();
     ASSERT_EQ (message, input->getStringView());
 }
+
+TEST_F(Cipher, SendAndReceiveMultipleSegments)
+{
+    std::string message(10000, 'x');
+    for (int i = 0; i < message.size(); i++) {
+        message[i] = 'a' + (i % 26);
+    }
+
+    auto *outputBuf = chord_mesh::ArrayBuf::allocate(message);
+    ASSERT_THAT (initiator->encryptOutput(outputBuf), tempo_test::IsOk());
+
+    // concatenate the ciphertext frames
+    std::vector<tu_uint8> ciphertext;
+    int numFrames = 0;
+    while (initiator->hasOutput()) {
+        auto *output = initiator->popOutput();
+        auto span = output->getSpan();
+        ciphertext.insert(ciphertext.end(), span.begin(), span.end());
+        chord_mesh::free_stream_buf(output);
+        numFrames++;
+    }
+    ASSERT_EQ (3, numFrames);
+
+    // feed the ciphertext to the responder in chunks which do not align with the frames
+    std::span<const tu_uint8> remaining(ciphertext);
+    while (!remaining.empty()) {
+        auto chunk = remaining.subspan(0, std::min<size_t>(7, remaining.size()));
+        ASSERT_THAT (responder->decryptInput(chunk.data(), chunk.size()), tempo_test::IsOk());
+        remaining = remaining.subspan(chunk.size());
+    }
+
+    std::string plaintext;
+    while (responder->hasInput()) {
+        auto input = responder->popInput();
+        plaintext.append(input->getStringView());
+    }
+    ASSERT_EQ (message, plaintext);
+}
+
+TEST_F(Cipher, SendAndReceiveLargeFrame)
+{
+    auto pool = std::make_shared<chord_mesh::StreamBufPool>(
+        chord_mesh::kMaxCipherSegmentSize + chord_mesh::kCipherFrameOverhead, 4);
+    chord_mesh::CipherOptions options;
+    options.segmentSize = chord_mesh::kMaxCipherSegmentSize;
+    options.pool = pool;
+    performHandshake(options);
+
+    std::string message(60000, 'x');
+
+    auto *outputBuf = chord_mesh::ArrayBuf::allocate(message);
+    ASSERT_THAT (initiator->encryptOutput(outputBuf), tempo_test::IsOk());
+    ASSERT_TRUE (initiator->hasOutput());
+    auto *output = initiator->popOutput();
+    ASSERT_FALSE (initiator->hasOutput());
+
+    auto inputSpan = output->getSpan();
+    ASSERT_THAT (responder->decryptInput(inputSpan.data(), inputSpan.size()), tempo_test::IsOk());
+    chord_mesh::free_stream_buf(output);
+
+    ASSERT_TRUE (responder->hasInput());
+    auto input = responder->popInput();
+    ASSERT_EQ (message, input->getStringView());
+    input.reset();
+
+    // both the ciphertext and plaintext buffers have been returned to the pool
+    ASSERT_EQ (2, pool->getFreeCount());
+}
+
+TEST_F(Cipher, RejectSegmentSizeLargerThanNoiseLimit)
+{
+    chord_mesh::CipherOptions options;
+    options.segmentSize = chord_mesh::kMaxCipherSegmentSize + 1;
+    ASSERT_ANY_THROW (performHandshake(options));
+}
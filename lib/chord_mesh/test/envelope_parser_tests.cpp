@@ -113,3 +113,120 @@ TEST_F(EnvelopeParser, ParseSignedEnvelope)
     auto digest = envelope.getDigest();
     ASSERT_TRUE (digest.isValid());
 }
+
+static std::shared_ptr<const tempo_utils::ImmutableBytes>
+build_envelope(std::string_view payload)
+{
+    chord_mesh::EnvelopeBuilder builder;
+    builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+    builder.setPayload(tempo_utils::MemoryBytes::copy(payload));
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RAISE (bytes, builder.toBytes());
+    return bytes;
+}
+
+TEST_F(EnvelopeParser, ParseZeroCopyEnvelopes)
+{
+    auto first = build_envelope("first envelope");
+    auto second = build_envelope("second envelope");
+
+    chord_mesh::EnvelopeParserOptions options;
+    options.zeroCopy = true;
+    chord_mesh::EnvelopeParser parser(options);
+    ASSERT_THAT (parser.pushBytes(first->getSpan()), tempo_test::IsOk());
+    ASSERT_THAT (parser.pushBytes(second->getSpan()), tempo_test::IsOk());
+
+    bool ready;
+    chord_mesh::Envelope envelope1;
+    ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+    ASSERT_TRUE (ready);
+    ASSERT_THAT (parser.takeReady(envelope1), tempo_test::IsOk());
+
+    chord_mesh::Envelope envelope2;
+    ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+    ASSERT_TRUE (ready);
+    ASSERT_THAT (parser.takeReady(envelope2), tempo_test::IsOk());
+
+    ASSERT_EQ ("first envelope", envelope1.getPayload()->getStringView());
+    ASSERT_EQ ("second envelope", envelope2.getPayload()->getStringView());
+    ASSERT_FALSE (parser.hasPending());
+}
+
+TEST_F(EnvelopeParser, ParseEnvelopeSpanningWrapPoint)
+{
+    auto first = build_envelope("first envelope");
+    auto second = build_envelope("second envelope");
+    auto firstSpan = first->getSpan();
+    auto secondSpan = second->getSpan();
+
+    // size the buffer so the second envelope cannot fit after the first envelope
+    chord_mesh::EnvelopeParserOptions options;
+    options.zeroCopy = true;
+    options.bufferSize = firstSpan.size() + 4;
+    chord_mesh::EnvelopeParser parser(options);
+
+    // push the first envelope plus the start of the second envelope
+    std::vector<tu_uint8> input(firstSpan.begin(), firstSpan.end());
+    input.insert(input.end(), secondSpan.begin(), secondSpan.begin() + 4);
+    ASSERT_THAT (parser.pushBytes(input), tempo_test::IsOk());
+
+    bool ready;
+    chord_mesh::Envelope envelope1;
+    ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+    ASSERT_TRUE (ready);
+    ASSERT_THAT (parser.takeReady(envelope1), tempo_test::IsOk());
+    ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+    ASSERT_FALSE (ready);
+
+    // push the rest of the second envelope, which wraps the buffer while envelope1 is referencing it
+    ASSERT_THAT (parser.pushBytes(secondSpan.subspan(4)), tempo_test::IsOk());
+
+    chord_mesh::Envelope envelope2;
+    ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+    ASSERT_TRUE (ready);
+    ASSERT_THAT (parser.takeReady(envelope2), tempo_test::IsOk());
+
+    ASSERT_EQ ("first envelope", envelope1.getPayload()->getStringView());
+    ASSERT_EQ ("second envelope", envelope2.getPayload()->getStringView());
+    ASSERT_FALSE (parser.hasPending());
+}
+
+TEST_F(EnvelopeParser, ParseSignedEnvelopeSpanningWrapPoint)
+{
+    auto keyPair = getKeyPair();
+    std::shared_ptr<tempo_security::PrivateKey> privateKey;
+    TU_ASSIGN_OR_RAISE (privateKey, tempo_security::PrivateKey::readFile(keyPair.getPemPrivateKeyFile()));
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    TU_ASSIGN_OR_RAISE (certificate, tempo_security::X509Certificate::readFile(keyPair.getPemCertificateFile()));
+
+    chord_mesh::EnvelopeBuilder builder;
+    builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+    builder.setPayload(tempo_utils::MemoryBytes::copy("hello, world!"));
+    builder.setPrivateKey(privateKey);
+    std::shared_ptr<const tempo_utils::ImmutableBytes> bytes;
+    TU_ASSIGN_OR_RAISE (bytes, builder.toBytes());
+    auto span = bytes->getSpan();
+
+    chord_mesh::EnvelopeParserOptions options;
+    options.zeroCopy = true;
+    options.bufferSize = span.size();
+    chord_mesh::EnvelopeParser parser(options);
+    parser.setCertificate(certificate);
+
+    // push each envelope in two parts, so the head of the buffer advances past the wrap point
+    bool ready;
+    for (int i = 0; i < 3; i++) {
+        auto split = span.size() / 2 + i;
+        ASSERT_THAT (parser.pushBytes(span.subspan(0, split)), tempo_test::IsOk());
+        ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+        ASSERT_FALSE (ready);
+        ASSERT_THAT (parser.pushBytes(span.subspan(split)), tempo_test::IsOk());
+        ASSERT_THAT (parser.checkReady(ready), tempo_test::IsOk());
+        ASSERT_TRUE (ready);
+
+        chord_mesh::Envelope envelope;
+        ASSERT_THAT (parser.takeReady(envelope), tempo_test::IsOk());
+        ASSERT_EQ ("hello, world!", envelope.getPayload()->getStringView());
+        ASSERT_TRUE (envelope.getDigest().isValid());
+    }
+}
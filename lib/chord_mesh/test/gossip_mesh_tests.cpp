@@ -0,0 +1,255 @@
+#include <absl/strings/str_cat.h>
+#include <absl/synchronization/notification.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_mesh/gossip_mesh.h>
+#include <tempo_security/ed25519_private_key_generator.h>
+#include <tempo_security/generate_utils.h>
+#include <tempo_test/tempo_test.h>
+#include <tempo_utils/file_utilities.h>
+#include <tempo_utils/tempdir_maker.h>
+
+#include "base_mesh_fixture.h"
+
+class GossipMesh : public BaseMeshFixture {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> tempdir;
+    tempo_security::CertificateKeyPair caKeypair;
+    tempo_security::CertificateKeyPair streamKeypair;
+    std::shared_ptr<tempo_security::X509Store> trustStore;
+
+    void SetUp() override {
+        BaseMeshFixture::SetUp();
+        tempdir = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_RAISE_IF_NOT_OK (tempdir->getStatus());
+
+        tempo_security::Ed25519PrivateKeyGenerator keygen;
+
+        caKeypair = tempo_security::GenerateUtils::generate_self_signed_ca_key_pair(
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "caKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            1,
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_ca_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (caKeypair.isValid());
+
+        streamKeypair = tempo_security::GenerateUtils::generate_key_pair(
+            caKeypair,
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "streamKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_stream_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (streamKeypair.isValid());
+
+        tempo_security::X509StoreOptions options;
+        TU_ASSIGN_OR_RAISE (trustStore, tempo_security::X509Store::loadTrustedCerts(
+            options, {caKeypair.getPemCertificateFile()}));
+    }
+    void TearDown() override {
+        BaseMeshFixture::TearDown();
+        std::filesystem::remove_all(tempdir->getTempdir());
+    }
+};
+
+struct GossipData {
+    uv_async_t async;
+    std::vector<std::shared_ptr<chord_mesh::GossipMesh>> meshes;
+    absl::Mutex lock;
+    int numJoined ABSL_GUARDED_BY(lock) = 0;
+    std::vector<std::vector<std::string>> received ABSL_GUARDED_BY(lock);
+    int numReceived ABSL_GUARDED_BY(lock) = 0;
+    int expectedJoined = 0;
+    int expectedReceived = 0;
+    absl::Notification notifyJoined;
+    absl::Notification notifyReceived;
+};
+
+class TestGossipContext : public chord_mesh::AbstractGossipContext {
+public:
+    TestGossipContext(GossipData *data, int index) : m_data(data), m_index(index) {}
+    void join(std::string_view peerId) override {
+        absl::MutexLock locker(&m_data->lock);
+        if (++m_data->numJoined == m_data->expectedJoined) {
+            m_data->notifyJoined.Notify();
+        }
+    }
+    void receive(const chord_mesh::EnsembleMessage &message) override {
+        auto root = message.getRoot();
+        absl::MutexLock locker(&m_data->lock);
+        m_data->received[m_index].emplace_back(root.getMessage().getNodeJoined().getEndpoint());
+        if (++m_data->numReceived == m_data->expectedReceived) {
+            m_data->notifyReceived.Notify();
+        }
+    }
+    void error(const tempo_utils::Status &status) override { TU_RAISE_IF_NOT_OK (status); }
+    void cleanup() override {}
+private:
+    GossipData *m_data;
+    int m_index;
+};
+
+static void
+broadcast_from_first_node(uv_async_t *async)
+{
+    auto *data = (GossipData *) async->data;
+    chord_mesh::EnsembleMessage message;
+    message.getRoot().getMessage().initNodeJoined().setEndpoint("hello");
+    TU_RAISE_IF_NOT_OK (data->meshes.front()->broadcast(message));
+}
+
+TEST_F(GossipMesh, BroadcastReachesEveryNodeOnce)
+{
+    auto testerDirectory = tempdir->getTempdir();
+    auto *loop = getUVLoop();
+    int ret;
+
+    constexpr int kNumNodes = 8;
+
+    GossipData data;
+    data.received.resize(kNumNodes);
+    // each node connects to two peers, and each connection joins a peer at both ends
+    data.expectedJoined = kNumNodes * 2 * 2;
+    data.expectedReceived = kNumNodes - 1;
+
+    chord_mesh::StreamManagerOps managerOps;
+    std::vector<std::unique_ptr<chord_mesh::StreamManager>> managers;
+    std::vector<chord_common::TransportLocation> locations;
+
+    chord_mesh::GossipMeshOptions options;
+    options.allowInsecure = true;
+
+    for (int i = 0; i < kNumNodes; i++) {
+        auto manager = std::make_unique<chord_mesh::StreamManager>(loop, streamKeypair, trustStore, managerOps);
+        auto ctx = std::make_unique<TestGossipContext>(&data, i);
+        auto createMeshResult = chord_mesh::GossipMesh::create(manager.get(), std::move(ctx), options);
+        ASSERT_THAT (createMeshResult, tempo_test::IsResult()) << "failed to create mesh";
+        auto mesh = createMeshResult.getResult();
+
+        auto socketPath = testerDirectory / absl::StrCat("node", i, ".sock");
+        auto location = chord_common::TransportLocation::forUnix("", socketPath);
+        ASSERT_THAT (mesh->listen(location), tempo_test::IsOk()) << "mesh listen error";
+
+        managers.push_back(std::move(manager));
+        locations.push_back(location);
+        data.meshes.push_back(mesh);
+    }
+
+    for (int i = 0; i < kNumNodes; i++) {
+        auto &mesh = data.meshes.at(i);
+        ASSERT_THAT (mesh->addPeer(locations.at((i + 1) % kNumNodes)), tempo_test::IsOk());
+        ASSERT_THAT (mesh->addPeer(locations.at((i + 3) % kNumNodes)), tempo_test::IsOk());
+    }
+
+    data.async.data = &data;
+    uv_async_init(loop, &data.async, broadcast_from_first_node);
+
+    ASSERT_THAT (startUVThread(), tempo_test::IsOk()) << "failed to start UV thread";
+
+    ASSERT_TRUE (data.notifyJoined.WaitForNotificationWithTimeout(absl::Seconds(5))) << "timeout waiting for peers to join";
+
+    ret = uv_async_send(&data.async);
+    ASSERT_EQ (0, ret) << "uv_async_send() error: " << uv_strerror(ret);
+
+    ASSERT_TRUE (data.notifyReceived.WaitForNotificationWithTimeout(absl::Seconds(5))) << "timeout waiting for broadcast";
+
+    ASSERT_THAT (stopUVThread(), tempo_test::IsOk()) << "failed to stop UV thread";
+
+    absl::MutexLock locker(&data.lock);
+    ASSERT_TRUE (data.received.at(0).empty());
+    for (int i = 1; i < kNumNodes; i++) {
+        ASSERT_THAT (data.received.at(i), ::testing::ElementsAre("hello")) << "node " << i;
+    }
+
+    auto stats = data.meshes.front()->getStats();
+    ASSERT_EQ (1, stats.published);
+    ASSERT_EQ (4, stats.eagerSends);
+
+    for (auto &mesh : data.meshes) {
+        mesh->shutdown();
+    }
+}
+
+TEST_F(GossipMesh, RepairMissingMessagesWithGossip)
+{
+    auto testerDirectory = tempdir->getTempdir();
+    auto *loop = getUVLoop();
+    int ret;
+
+    constexpr int kNumNodes = 4;
+
+    GossipData data;
+    data.received.resize(kNumNodes);
+    data.expectedJoined = (kNumNodes - 1) * 2;
+    data.expectedReceived = kNumNodes - 1;
+
+    chord_mesh::StreamManagerOps managerOps;
+    std::vector<std::unique_ptr<chord_mesh::StreamManager>> managers;
+    std::vector<chord_common::TransportLocation> locations;
+
+    // with an empty mesh every message must be pulled by peers after they see an IHave
+    chord_mesh::GossipMeshOptions options;
+    options.meshDegree = 0;
+    options.meshDegreeLow = 0;
+    options.meshDegreeHigh = 0;
+    options.heartbeatInterval = absl::Milliseconds(50);
+    options.allowInsecure = true;
+
+    for (int i = 0; i < kNumNodes; i++) {
+        auto manager = std::make_unique<chord_mesh::StreamManager>(loop, streamKeypair, trustStore, managerOps);
+        auto ctx = std::make_unique<TestGossipContext>(&data, i);
+        auto createMeshResult = chord_mesh::GossipMesh::create(manager.get(), std::move(ctx), options);
+        ASSERT_THAT (createMeshResult, tempo_test::IsResult()) << "failed to create mesh";
+        auto mesh = createMeshResult.getResult();
+
+        auto socketPath = testerDirectory / absl::StrCat("node", i, ".sock");
+        auto location = chord_common::TransportLocation::forUnix("", socketPath);
+        ASSERT_THAT (mesh->listen(location), tempo_test::IsOk()) << "mesh listen error";
+
+        managers.push_back(std::move(manager));
+        locations.push_back(location);
+        data.meshes.push_back(mesh);
+    }
+
+    // connect the nodes in a line so each message must be relayed through every node
+    for (int i = 0; i < kNumNodes - 1; i++) {
+        ASSERT_THAT (data.meshes.at(i)->addPeer(locations.at(i + 1)), tempo_test::IsOk());
+    }
+
+    data.async.data = &data;
+    uv_async_init(loop, &data.async, broadcast_from_first_node);
+
+    ASSERT_THAT (startUVThread(), tempo_test::IsOk()) << "failed to start UV thread";
+
+    ASSERT_TRUE (data.notifyJoined.WaitForNotificationWithTimeout(absl::Seconds(5))) << "timeout waiting for peers to join";
+
+    ret = uv_async_send(&data.async);
+    ASSERT_EQ (0, ret) << "uv_async_send() error: " << uv_strerror(ret);
+
+    ASSERT_TRUE (data.notifyReceived.WaitForNotificationWithTimeout(absl::Seconds(5))) << "timeout waiting for broadcast";
+
+    ASSERT_THAT (stopUVThread(), tempo_test::IsOk()) << "failed to stop UV thread";
+
+    absl::MutexLock locker(&data.lock);
+    for (int i = 1; i < kNumNodes; i++) {
+        ASSERT_THAT (data.received.at(i), ::testing::ElementsAre("hello")) << "node " << i;
+        auto stats = data.meshes.at(i)->getStats();
+        ASSERT_EQ (1, stats.repaired) << "node " << i;
+        ASSERT_LE (1, stats.iwantSends) << "node " << i;
+    }
+    for (auto &mesh : data.meshes) {
+        ASSERT_EQ (0, mesh->getStats().eagerSends);
+        mesh->shutdown();
+    }
+}
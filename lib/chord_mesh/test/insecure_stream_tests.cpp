@@ -208,3 +208,134 @@ TEST_F(InsecureStream, ReadAndWriteStream)
         ASSERT_EQ ("pong!", envelope.getPayload()->getStringView());
     }
 }
+
+TEST_F(InsecureStream, SignalWritableAtWatermarks)
+{
+    std::string ipAddress = "127.0.0.1";
+    tu_uint16 tcpPort = (random() % 5000) + 25000;
+
+    auto *loop = getUVLoop();
+    int ret;
+
+    // set the watermarks so any queued write crosses the high watermark
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManagerOptions managerOptions;
+    managerOptions.writeHighWatermark = 1;
+    managerOptions.writeLowWatermark = 0;
+    chord_mesh::StreamManager manager(loop, streamKeypair, trustStore, managerOps, managerOptions);
+
+    chord_mesh::StreamAcceptorOptions acceptorOptions;
+    acceptorOptions.allowInsecure = true;
+    auto createAcceptorResult = chord_mesh::StreamAcceptor::create(&manager, acceptorOptions);
+    ASSERT_THAT (createAcceptorResult, tempo_test::IsResult()) << "failed to create acceptor";
+    auto acceptor = createAcceptorResult.getResult();
+
+    struct Data {
+        uv_async_t async;
+        std::string ipAddress;
+        tu_uint16 tcpPort;
+        std::shared_ptr<chord_mesh::StreamConnector> connector;
+        std::shared_ptr<chord_mesh::Stream> acceptorStream;
+        std::shared_ptr<chord_mesh::Stream> connectorStream;
+        std::vector<bool> connectorWritable;
+        absl::Notification notifyComplete;
+    } data;
+
+    class AcceptorStreamContext : public chord_mesh::AbstractStreamContext {
+    public:
+        AcceptorStreamContext(Data *data): m_data(data) {}
+        tempo_utils::Status validate(std::string_view,std::shared_ptr<tempo_security::X509Certificate>) override {
+            return {};
+        }
+        void receive(const chord_mesh::Envelope &envelope) override {
+            auto &stream = m_data->acceptorStream;
+            TU_RAISE_IF_NOT_OK (stream->send(
+                chord_mesh::EnvelopeVersion::Version1, tempo_utils::MemoryBytes::copy("pong!")));
+        }
+        void error(const tempo_utils::Status &status) override { TU_RAISE_IF_NOT_OK (status); }
+        void cleanup() override {}
+    private:
+        Data *m_data;
+    };
+
+    class AcceptContext : public chord_mesh::AbstractAcceptContext {
+    public:
+        AcceptContext(Data *data): m_data(data) {}
+        void accept(std::shared_ptr<chord_mesh::Stream> stream) override {
+            auto ctx = std::make_unique<AcceptorStreamContext>(m_data);
+            TU_RAISE_IF_NOT_OK (stream->start(std::move(ctx)));
+            m_data->acceptorStream = std::move(stream);
+        }
+        void error(const tempo_utils::Status &status) override { TU_RAISE_IF_NOT_OK(status); }
+        void cleanup() override {}
+    private:
+        Data *m_data;
+    };
+
+    auto ctx = std::make_unique<AcceptContext>(&data);
+    ASSERT_THAT (acceptor->listenTcp4(ipAddress, tcpPort, std::move(ctx)), tempo_test::IsOk()) << "acceptor listen error";
+
+    class InitiatorStreamContext : public chord_mesh::AbstractStreamContext {
+    public:
+        InitiatorStreamContext(Data *data): m_data(data) {}
+        tempo_utils::Status validate(std::string_view,std::shared_ptr<tempo_security::X509Certificate>) override {
+            return {};
+        }
+        void receive(const chord_mesh::Envelope &envelope) override {
+            m_data->connectorStream->shutdown();
+            m_data->notifyComplete.Notify();
+        }
+        void writable(bool writable) override {
+            m_data->connectorWritable.push_back(writable);
+        }
+        void error(const tempo_utils::Status &status) override { TU_RAISE_IF_NOT_OK (status); }
+        void cleanup() override {}
+    private:
+        Data *m_data;
+    };
+
+    class ConnectContext : public chord_mesh::AbstractConnectContext {
+    public:
+        ConnectContext(Data *data) : m_data(data) {};
+        void connect(std::shared_ptr<chord_mesh::Stream> stream) override {
+            auto ctx = std::make_unique<InitiatorStreamContext>(m_data);
+            TU_RAISE_IF_NOT_OK (stream->start(std::move(ctx)));
+            TU_RAISE_IF_NOT_OK (stream->send(
+                chord_mesh::EnvelopeVersion::Version1, tempo_utils::MemoryBytes::copy("ping!")));
+            TU_ASSERT (!stream->isWritable());
+            m_data->connectorStream = std::move(stream);
+        }
+        void error(const tempo_utils::Status &status) override { TU_RAISE_IF_NOT_OK (status); }
+        void cleanup() override {}
+    private:
+        Data *m_data;
+    };
+
+    chord_mesh::StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = true;
+    auto createConnectorResult = chord_mesh::StreamConnector::create(&manager, connectorOptions);
+    ASSERT_THAT (createConnectorResult, tempo_test::IsResult());
+
+    data.connector = createConnectorResult.getResult();;
+    data.ipAddress = ipAddress;
+    data.tcpPort = tcpPort;
+    data.async.data = &data;
+
+    uv_async_init(loop, &data.async, [](uv_async_t *async) {
+        auto *data = (Data *) async->data;
+        auto ctx = std::make_unique<ConnectContext>(data);
+        TU_RAISE_IF_STATUS (data->connector->connectTcp4(data->ipAddress, data->tcpPort, std::move(ctx)));
+    });
+
+    ASSERT_THAT (startUVThread(), tempo_test::IsOk()) << "failed to start UV thread";
+
+    ret = uv_async_send(&data.async);
+    ASSERT_EQ (0, ret) << "uv_async_send() error: " << uv_strerror(ret);
+
+    ASSERT_TRUE (data.notifyComplete.WaitForNotificationWithTimeout(absl::Seconds(5))) << "timeout waiting for notification";
+
+    ASSERT_THAT (stopUVThread(), tempo_test::IsOk()) << "failed to stop UV thread";
+    acceptor->shutdown();
+
+    ASSERT_THAT (data.connectorWritable, testing::ElementsAre(false, true));
+}
@@ -4,6 +4,10 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/notification.h>
+
+#include <chord_mesh/mesh_result.h>
 #include <chord_mesh/stream_connector.h>
 #include <tempo_security/ed25519_private_key_generator.h>
 #include <tempo_security/generate_utils.h>
@@ -16,6 +20,54 @@
 #include "chord_mesh/req_protocol.h"
 #include "test_messages.capnp.h"
 
+using TestRequest = chord_mesh::Message<test_generated::Request>;
+using TestReply = chord_mesh::Message<test_generated::Reply>;
+using TestReqProtocol = chord_mesh::ReqProtocol<TestRequest,TestReply>;
+
+static bool
+read_envelopes(int fd, size_t count, std::vector<chord_mesh::Envelope> &envelopes)
+{
+    chord_mesh::EnvelopeParser parser;
+    tu_uint8 buffer[128];
+    while (envelopes.size() < count) {
+        auto ret = read(fd, buffer, 128);
+        if (ret <= 0)
+            return false;
+        if (parser.pushBytes(std::span(buffer, ret)).notOk())
+            return false;
+        bool ready;
+        while (parser.checkReady(ready).isOk() && ready) {
+            chord_mesh::Envelope envelope;
+            if (parser.takeReady(envelope).notOk())
+                return false;
+            envelopes.push_back(envelope);
+        }
+    }
+    return true;
+}
+
+static bool
+write_reply(int fd, const chord_mesh::Envelope &request)
+{
+    TestRequest req;
+    if (req.parse(request.getPayload()).notOk())
+        return false;
+    TestReply rep;
+    std::string value = req.getRoot().getValue().cStr();
+    rep.getRoot().setValue(value);
+    auto payloadResult = rep.toBytes();
+    if (payloadResult.isStatus())
+        return false;
+    chord_mesh::EnvelopeBuilder builder;
+    builder.setVersion(chord_mesh::EnvelopeVersion::Version1);
+    builder.setHeader(request.getHeader());
+    builder.setPayload(payloadResult.getResult());
+    auto envelopeResult = builder.toBytes();
+    if (envelopeResult.isStatus())
+        return false;
+    return write_entire_buffer(fd, envelopeResult.getResult()->getSpan());
+}
+
 class ReqProtocol : public BaseMeshFixture {
 protected:
     std::unique_ptr<tempo_utils::TempdirMaker> tempdir;
@@ -96,10 +148,6 @@ TEST_F(ReqProtocol, ReadAndWaitForReqProtocolClose)
     std::shared_ptr<chord_mesh::StreamConnector> connector;
     TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager, connectorOptions));
 
-    using TestRequest = chord_mesh::Message<test_generated::Request>;
-    using TestReply = chord_mesh::Message<test_generated::Reply>;
-    using TestReqProtocol = chord_mesh::ReqProtocol<TestRequest,TestReply>;
-
     class TestReqContext : public TestReqProtocol::AbstractContext {
     public:
         void ready(TestReqProtocol *protocol) override {
@@ -164,3 +212,253 @@ TEST_F(ReqProtocol, ReadAndWaitForReqProtocolClose)
 
     stopUVThread();
 }
+
+TEST_F(ReqProtocol, CorrelateRepliesReceivedOutOfOrder)
+{
+    auto testerDirectory = tempdir->getTempdir();
+    auto socketPath = testerDirectory / "test.sock";
+
+    auto *loop = getUVLoop();
+    int ret;
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    auto listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE (0, listenfd) << "socket() error: " << strerror(errno);
+    ret = bind(listenfd, (sockaddr *) &addr, sizeof(addr));
+    ASSERT_EQ (0, ret) << "bind() error: " << strerror(errno);
+    ret = listen(listenfd, 5);
+    ASSERT_EQ (0, ret) << "listen() error: " << strerror(errno);
+    uv_sleep(250);
+
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManager manager(loop, streamKeypair, trustStore, managerOps);
+
+    chord_mesh::StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = true;
+    std::shared_ptr<chord_mesh::StreamConnector> connector;
+    TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager, connectorOptions));
+
+    struct Replies {
+        absl::flat_hash_map<tu_uint32,std::string> sent;
+        absl::flat_hash_map<tu_uint32,std::string> received;
+        absl::Notification done;
+    } replies;
+
+    class TestReqContext : public TestReqProtocol::AbstractContext {
+    public:
+        explicit TestReqContext(Replies *replies) : m_replies(replies) {}
+        void ready(TestReqProtocol *protocol) override {
+            for (const auto *value : {"one", "two"}) {
+                auto id = std::make_shared<tu_uint32>(0);
+                TestRequest msg;
+                msg.getRoot().setValue(value);
+                auto result = protocol->send(std::move(msg),
+                    [this, id](const tempo_utils::Status &status, const TestReply &reply) {
+                        TU_RAISE_IF_NOT_OK (status);
+                        m_replies->received[*id] = reply.getRoot().getValue().cStr();
+                        if (m_replies->received.size() == 2) {
+                            m_replies->done.Notify();
+                        }
+                    });
+                *id = result.orElseThrow();
+                m_replies->sent[*id] = value;
+            }
+        }
+        void receive(TestReqProtocol *protocol, const TestReply &message) override {}
+        void error(const tempo_utils::Status &status) override {
+            TU_CONSOLE_ERR << "req error: " << status;
+        };
+        void cleanup() override {};
+    private:
+        Replies *m_replies;
+    };
+
+    auto createReqResult = TestReqProtocol::create(connector, std::make_unique<TestReqContext>(&replies));
+    ASSERT_THAT (createReqResult, tempo_test::IsResult());
+
+    struct Data {
+        std::shared_ptr<TestReqProtocol> req;
+        chord_common::TransportLocation endpoint;
+        uv_async_t async;
+    } data;
+
+    data.req = createReqResult.getResult();
+    data.endpoint = chord_common::TransportLocation::forUnix("", socketPath);
+    data.async.data = &data;
+
+    uv_async_init(loop, &data.async, [](uv_async_t *async) {
+        auto *data = (Data *) async->data;
+        data->req->connect(data->endpoint);
+    });
+
+    ASSERT_THAT (startUVThread(), tempo_test::IsOk());
+
+    ret = uv_async_send(&data.async);
+    ASSERT_EQ (0, ret) << "uv_async_send() error: " << uv_strerror(ret);
+
+    socklen_t socklen;
+    auto connfd = accept(listenfd, (sockaddr *) &addr, &socklen);
+    ASSERT_LE (0, connfd) << "accept() error: " << strerror(errno);
+
+    std::vector<chord_mesh::Envelope> requests;
+    ASSERT_TRUE (read_envelopes(connfd, 2, requests));
+    ASSERT_EQ (chord_mesh::kRequestHeaderSize, requests.at(0).getHeader()->getSize());
+
+    // reply to the requests in reverse order
+    ASSERT_TRUE (write_reply(connfd, requests.at(1)));
+    ASSERT_TRUE (write_reply(connfd, requests.at(0)));
+
+    ASSERT_TRUE (replies.done.WaitForNotificationWithTimeout(absl::Seconds(5)));
+    ASSERT_EQ (replies.sent, replies.received);
+
+    stopUVThread();
+    close(connfd);
+    close(listenfd);
+}
+
+TEST_F(ReqProtocol, ExpireRequestWithoutReply)
+{
+    auto testerDirectory = tempdir->getTempdir();
+    auto socketPath = testerDirectory / "test.sock";
+
+    auto *loop = getUVLoop();
+    int ret;
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    auto listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE (0, listenfd) << "socket() error: " << strerror(errno);
+    ret = bind(listenfd, (sockaddr *) &addr, sizeof(addr));
+    ASSERT_EQ (0, ret) << "bind() error: " << strerror(errno);
+    ret = listen(listenfd, 5);
+    ASSERT_EQ (0, ret) << "listen() error: " << strerror(errno);
+    uv_sleep(250);
+
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManager manager(loop, streamKeypair, trustStore, managerOps);
+
+    chord_mesh::StreamConnectorOptions connectorOptions;
+    connectorOptions.startInsecure = true;
+    std::shared_ptr<chord_mesh::StreamConnector> connector;
+    TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager, connectorOptions));
+
+    struct Outcome {
+        tempo_utils::Status status;
+        tu_uint32 numInFlight = 0;
+        absl::Notification done;
+    } outcome;
+
+    class TestReqContext : public TestReqProtocol::AbstractContext {
+    public:
+        explicit TestReqContext(Outcome *outcome) : m_outcome(outcome) {}
+        void ready(TestReqProtocol *protocol) override {
+            TestRequest msg;
+            msg.getRoot().setValue("hello, world!");
+            protocol->send(std::move(msg),
+                [this, protocol](const tempo_utils::Status &status, const TestReply &reply) {
+                    m_outcome->status = status;
+                    m_outcome->numInFlight = protocol->numInFlight();
+                    m_outcome->done.Notify();
+                }, absl::Milliseconds(100)).orElseThrow();
+        }
+        void receive(TestReqProtocol *protocol, const TestReply &message) override {}
+        void error(const tempo_utils::Status &status) override {}
+        void cleanup() override {};
+    private:
+        Outcome *m_outcome;
+    };
+
+    auto createReqResult = TestReqProtocol::create(connector, std::make_unique<TestReqContext>(&outcome));
+    ASSERT_THAT (createReqResult, tempo_test::IsResult());
+
+    struct Data {
+        std::shared_ptr<TestReqProtocol> req;
+        chord_common::TransportLocation endpoint;
+        uv_async_t async;
+    } data;
+
+    data.req = createReqResult.getResult();
+    data.endpoint = chord_common::TransportLocation::forUnix("", socketPath);
+    data.async.data = &data;
+
+    uv_async_init(loop, &data.async, [](uv_async_t *async) {
+        auto *data = (Data *) async->data;
+        data->req->connect(data->endpoint);
+    });
+
+    ASSERT_THAT (startUVThread(), tempo_test::IsOk());
+
+    ret = uv_async_send(&data.async);
+    ASSERT_EQ (0, ret) << "uv_async_send() error: " << uv_strerror(ret);
+
+    socklen_t socklen;
+    auto connfd = accept(listenfd, (sockaddr *) &addr, &socklen);
+    ASSERT_LE (0, connfd) << "accept() error: " << strerror(errno);
+
+    // read the request but never reply
+    std::vector<chord_mesh::Envelope> requests;
+    ASSERT_TRUE (read_envelopes(connfd, 1, requests));
+
+    ASSERT_TRUE (outcome.done.WaitForNotificationWithTimeout(absl::Seconds(5)));
+    ASSERT_EQ (tempo_utils::StatusCode::kDeadlineExceeded, outcome.status.getStatusCode());
+    ASSERT_EQ (0, outcome.numInFlight);
+
+    stopUVThread();
+    close(connfd);
+    close(listenfd);
+}
+
+TEST_F(ReqProtocol, LimitAndCancelRequestsInFlight)
+{
+    auto *loop = getUVLoop();
+
+    chord_mesh::StreamManagerOps managerOps;
+    chord_mesh::StreamManager manager(loop, streamKeypair, trustStore, managerOps);
+
+    std::shared_ptr<chord_mesh::StreamConnector> connector;
+    TU_ASSIGN_OR_RAISE (connector, chord_mesh::StreamConnector::create(&manager));
+
+    class TestReqContext : public TestReqProtocol::AbstractContext {
+    public:
+        void ready(TestReqProtocol *protocol) override {}
+        void receive(TestReqProtocol *protocol, const TestReply &message) override {}
+        void error(const tempo_utils::Status &status) override {}
+        void cleanup() override {};
+    };
+
+    chord_mesh::ReqProtocolOptions options;
+    options.maxInFlight = 1;
+    std::shared_ptr<TestReqProtocol> req;
+    TU_ASSIGN_OR_RAISE (req, TestReqProtocol::create(connector, std::make_unique<TestReqContext>(), options));
+
+    // requests are queued until the protocol is connected, and count toward the limit
+    std::vector<tempo_utils::Status> completed;
+    auto onReply = [&](const tempo_utils::Status &status, const TestReply &reply) {
+        completed.push_back(status);
+    };
+
+    auto sendResult1 = req->send(TestRequest{}, onReply);
+    ASSERT_THAT (sendResult1, tempo_test::IsResult());
+    ASSERT_EQ (1, req->numInFlight());
+
+    auto sendResult2 = req->send(TestRequest{}, onReply);
+    ASSERT_TRUE (sendResult2.isStatus());
+    ASSERT_EQ (tempo_utils::StatusCode::kResourceExhausted, sendResult2.getStatus().getStatusCode());
+
+    ASSERT_TRUE (req->cancel(sendResult1.getResult()));
+    ASSERT_FALSE (req->cancel(sendResult1.getResult()));
+    ASSERT_EQ (0, req->numInFlight());
+    ASSERT_EQ (1, completed.size());
+    ASSERT_EQ (tempo_utils::StatusCode::kCancelled, completed.front().getStatusCode());
+
+    auto sendResult3 = req->send(TestRequest{}, onReply);
+    ASSERT_THAT (sendResult3, tempo_test::IsResult());
+    ASSERT_NE (sendResult1.getResult(), sendResult3.getResult());
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_mesh/ring_buffer.h>
+#include <tempo_test/tempo_test.h>
+
+class RingBuffer : public ::testing::Test {};
+
+static std::span<const tu_uint8>
+to_span(std::string_view str)
+{
+    return std::span((const tu_uint8 *) str.data(), str.size());
+}
+
+TEST_F(RingBuffer, AppendAndConsume)
+{
+    chord_mesh::RingBuffer ring(16);
+    ring.append(to_span("hello, "));
+    ring.append(to_span("world!"));
+    ASSERT_EQ (13, ring.getSize());
+
+    std::string_view contents((const char *) ring.getData(), ring.getSize());
+    ASSERT_EQ ("hello, world!", contents);
+
+    ring.consume(7);
+    ASSERT_EQ (6, ring.getSize());
+    std::string_view remaining((const char *) ring.getData(), ring.getSize());
+    ASSERT_EQ ("world!", remaining);
+
+    ring.clear();
+    ASSERT_TRUE (ring.isEmpty());
+}
+
+TEST_F(RingBuffer, CompactWhenTailWrapsAndUnreferenced)
+{
+    chord_mesh::RingBuffer ring(16);
+    ring.append(to_span("0123456789"));
+    ring.consume(8);
+    ring.append(to_span("abcdefghij"));
+
+    ASSERT_EQ (16, ring.getCapacity());
+    std::string_view contents((const char *) ring.getData(), ring.getSize());
+    ASSERT_EQ ("89abcdefghij", contents);
+}
+
+TEST_F(RingBuffer, SliceRemainsValidWhenTailWraps)
+{
+    chord_mesh::RingBuffer ring(16);
+    ring.append(to_span("0123456789"));
+    auto slice = ring.slice(2, 4);
+    ring.consume(8);
+    ring.append(to_span("abcdefghij"));
+
+    ASSERT_EQ ("2345", slice->getStringView());
+    std::string_view contents((const char *) ring.getData(), ring.getSize());
+    ASSERT_EQ ("89abcdefghij", contents);
+}
+
+TEST_F(RingBuffer, GrowWhenCapacityExceeded)
+{
+    chord_mesh::RingBuffer ring(4);
+    ring.append(to_span("0123456789"));
+    ASSERT_LE (10, ring.getCapacity());
+
+    std::string_view contents((const char *) ring.getData(), ring.getSize());
+    ASSERT_EQ ("0123456789", contents);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <absl/synchronization/notification.h>
+
+#include <chord_mesh/sharded_stream_manager.h>
+#include <tempo_security/ed25519_private_key_generator.h>
+#include <tempo_security/generate_utils.h>
+#include <tempo_test/tempo_test.h>
+#include <tempo_utils/file_utilities.h>
+#include <tempo_utils/tempdir_maker.h>
+
+class ShardedStreamManager : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> tempdir;
+    tempo_security::CertificateKeyPair caKeypair;
+    tempo_security::CertificateKeyPair streamKeypair;
+    std::shared_ptr<tempo_security::X509Store> trustStore;
+
+    void SetUp() override {
+        tempdir = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_RAISE_IF_NOT_OK (tempdir->getStatus());
+
+        tempo_security::Ed25519PrivateKeyGenerator keygen;
+
+        caKeypair = tempo_security::GenerateUtils::generate_self_signed_ca_key_pair(
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "caKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            1,
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_ca_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (caKeypair.isValid());
+
+        streamKeypair = tempo_security::GenerateUtils::generate_key_pair(
+            caKeypair,
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "streamKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_stream_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (streamKeypair.isValid());
+
+        tempo_security::X509StoreOptions options;
+        TU_ASSIGN_OR_RAISE (trustStore, tempo_security::X509Store::loadTrustedCerts(
+            options, {caKeypair.getPemCertificateFile()}));
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(tempdir->getTempdir());
+    }
+};
+
+struct AcceptedStreams {
+    absl::Mutex lock;
+    std::vector<tu_uint32> shards ABSL_GUARDED_BY(lock);
+    std::vector<std::shared_ptr<chord_mesh::Stream>> streams ABSL_GUARDED_BY(lock);
+    absl::Notification done;
+    size_t expected = 0;
+};
+
+class TestAcceptContext : public chord_mesh::AbstractAcceptContext {
+public:
+    TestAcceptContext(tu_uint32 shard, AcceptedStreams *accepted)
+        : m_shard(shard), m_accepted(accepted) {}
+    void accept(std::shared_ptr<chord_mesh::Stream> stream) override {
+        absl::MutexLock locker(&m_accepted->lock);
+        m_accepted->shards.push_back(m_shard);
+        m_accepted->streams.push_back(std::move(stream));
+        if (m_accepted->shards.size() == m_accepted->expected) {
+            m_accepted->done.Notify();
+        }
+    }
+    void error(const tempo_utils::Status &status) override {}
+    void cleanup() override {}
+private:
+    tu_uint32 m_shard;
+    AcceptedStreams *m_accepted;
+};
+
+TEST_F(ShardedStreamManager, HandOffUnixConnectionsRoundRobin)
+{
+    auto socketPath = tempdir->getTempdir() / "test.sock";
+
+    chord_mesh::StreamManagerOps ops;
+    chord_mesh::ShardedStreamManagerOptions options;
+    options.numShards = 2;
+    chord_mesh::ShardedStreamManager sharded(streamKeypair, trustStore, ops, options);
+    ASSERT_EQ (2, sharded.numShards());
+
+    AcceptedStreams accepted;
+    accepted.expected = 4;
+    auto factory = [&](tu_uint32 shard) -> std::unique_ptr<chord_mesh::AbstractAcceptContext> {
+        return std::make_unique<TestAcceptContext>(shard, &accepted);
+    };
+    ASSERT_THAT (sharded.listenUnix(socketPath.c_str(), 0, factory), tempo_test::IsOk());
+    ASSERT_THAT (sharded.start(), tempo_test::IsOk());
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    std::vector<int> fds;
+    for (int i = 0; i < 4; i++) {
+        auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        ASSERT_LE (0, fd) << "socket() error: " << strerror(errno);
+        ASSERT_EQ (0, connect(fd, (sockaddr *) &addr, sizeof(addr))) << "connect() error: " << strerror(errno);
+        fds.push_back(fd);
+    }
+
+    ASSERT_TRUE (accepted.done.WaitForNotificationWithTimeout(absl::Seconds(5)));
+    {
+        absl::MutexLock locker(&accepted.lock);
+        ASSERT_THAT (accepted.shards, testing::UnorderedElementsAre(0, 0, 1, 1));
+    }
+
+    // release the streams on their owning shards before shutting down
+    for (tu_uint32 i = 0; i < sharded.numShards(); i++) {
+        absl::Notification released;
+        ASSERT_THAT (sharded.post(i, [&](chord_mesh::StreamManager *manager) {
+            absl::MutexLock locker(&accepted.lock);
+            for (tu_uint32 j = 0; j < accepted.streams.size(); j++) {
+                if (accepted.shards.at(j) == i) {
+                    accepted.streams.at(j).reset();
+                }
+            }
+            released.Notify();
+        }), tempo_test::IsOk());
+        released.WaitForNotification();
+    }
+
+    sharded.shutdown();
+    for (auto fd : fds) {
+        close(fd);
+    }
+}
+
+TEST_F(ShardedStreamManager, PostRunsOnOwningShard)
+{
+    chord_mesh::StreamManagerOps ops;
+    chord_mesh::ShardedStreamManagerOptions options;
+    options.numShards = 3;
+    chord_mesh::ShardedStreamManager sharded(streamKeypair, trustStore, ops, options);
+    ASSERT_THAT (sharded.start(), tempo_test::IsOk());
+
+    for (tu_uint32 i = 0; i < sharded.numShards(); i++) {
+        chord_mesh::StreamManager *ran = nullptr;
+        absl::Notification done;
+        ASSERT_THAT (sharded.post(i, [&](chord_mesh::StreamManager *manager) {
+            ran = manager;
+            done.Notify();
+        }), tempo_test::IsOk());
+        done.WaitForNotification();
+        ASSERT_EQ (sharded.getShard(i), ran);
+    }
+
+    sharded.shutdown();
+    ASSERT_FALSE (sharded.post(0, [](chord_mesh::StreamManager *) {}).isOk());
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_mesh/static_key_manager.h>
+#include <tempo_security/ed25519_private_key_generator.h>
+#include <tempo_security/generate_utils.h>
+#include <tempo_test/tempo_test.h>
+#include <tempo_utils/file_utilities.h>
+#include <tempo_utils/tempdir_maker.h>
+
+class StaticKeyManager : public ::testing::Test {
+protected:
+    std::unique_ptr<tempo_utils::TempdirMaker> tempdir;
+    tempo_security::CertificateKeyPair caKeypair;
+    tempo_security::CertificateKeyPair streamKeypair;
+    std::shared_ptr<tempo_security::X509Store> trustStore;
+
+    void SetUp() override {
+        tempdir = std::make_unique<tempo_utils::TempdirMaker>(
+            std::filesystem::current_path(), "tester.XXXXXXXX");
+        TU_RAISE_IF_NOT_OK (tempdir->getStatus());
+
+        tempo_security::Ed25519PrivateKeyGenerator keygen;
+
+        caKeypair = tempo_security::GenerateUtils::generate_self_signed_ca_key_pair(
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "caKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            1,
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_ca_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (caKeypair.isValid());
+
+        streamKeypair = tempo_security::GenerateUtils::generate_key_pair(
+            caKeypair,
+            keygen,
+            tempo_security::DigestId::None,
+            "test_O",
+            "test_OU",
+            "streamKeyPair",
+            1,
+            std::chrono::seconds{3600},
+            tempdir->getTempdir(),
+            tempo_utils::generate_name("test_stream_key_XXXXXXXX")).orElseThrow();
+        TU_ASSERT (streamKeypair.isValid());
+
+        tempo_security::X509StoreOptions options;
+        TU_ASSIGN_OR_RAISE (trustStore, tempo_security::X509Store::loadTrustedCerts(
+            options, {caKeypair.getPemCertificateFile()}));
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(tempdir->getTempdir());
+    }
+};
+
+TEST_F(StaticKeyManager, ReuseLocalKeyUntilRotation)
+{
+    chord_mesh::StaticKeyManager staticKeys(streamKeypair, trustStore);
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate1;
+    chord_mesh::StaticKeypair localKey1;
+    ASSERT_THAT (staticKeys.getLocalKey(certificate1, localKey1), tempo_test::IsOk());
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate2;
+    chord_mesh::StaticKeypair localKey2;
+    ASSERT_THAT (staticKeys.getLocalKey(certificate2, localKey2), tempo_test::IsOk());
+
+    ASSERT_EQ (certificate1, certificate2);
+    ASSERT_EQ (localKey1.publicKey, localKey2.publicKey);
+
+    ASSERT_THAT (staticKeys.rotateLocalKey(), tempo_test::IsOk());
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate3;
+    chord_mesh::StaticKeypair localKey3;
+    ASSERT_THAT (staticKeys.getLocalKey(certificate3, localKey3), tempo_test::IsOk());
+    ASSERT_NE (localKey1.publicKey, localKey3.publicKey);
+}
+
+TEST_F(StaticKeyManager, RotateLocalKeyWhenIntervalElapses)
+{
+    chord_mesh::StaticKeyManagerOptions options;
+    options.keyRotationInterval = absl::ZeroDuration();
+    chord_mesh::StaticKeyManager staticKeys(streamKeypair, trustStore, options);
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    chord_mesh::StaticKeypair localKey1;
+    ASSERT_THAT (staticKeys.getLocalKey(certificate, localKey1), tempo_test::IsOk());
+    chord_mesh::StaticKeypair localKey2;
+    ASSERT_THAT (staticKeys.getLocalKey(certificate, localKey2), tempo_test::IsOk());
+
+    ASSERT_NE (localKey1.publicKey, localKey2.publicKey);
+}
+
+TEST_F(StaticKeyManager, ValidateRemoteKeyOnceThenHitCache)
+{
+    chord_mesh::StaticKeyManager local(streamKeypair, trustStore);
+    chord_mesh::StaticKeyManager remote(streamKeypair, trustStore);
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    chord_mesh::StaticKeypair remoteKey;
+    ASSERT_THAT (remote.getLocalKey(certificate, remoteKey), tempo_test::IsOk());
+
+    ASSERT_THAT (local.validateRemoteKey(remoteKey.publicKey, certificate, remoteKey.digest), tempo_test::IsOk());
+    ASSERT_EQ (0, local.getCacheHits());
+    ASSERT_EQ (1, local.getCacheMisses());
+    ASSERT_EQ (1, local.numVerifiedPeers());
+
+    ASSERT_THAT (local.validateRemoteKey(remoteKey.publicKey, certificate, remoteKey.digest), tempo_test::IsOk());
+    ASSERT_EQ (1, local.getCacheHits());
+    ASSERT_EQ (1, local.getCacheMisses());
+    ASSERT_EQ (1, local.numVerifiedPeers());
+}
+
+TEST_F(StaticKeyManager, DoNotCacheInvalidRemoteKey)
+{
+    chord_mesh::StaticKeyManager local(streamKeypair, trustStore);
+    chord_mesh::StaticKeyManager remote(streamKeypair, trustStore);
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    chord_mesh::StaticKeypair remoteKey;
+    ASSERT_THAT (remote.getLocalKey(certificate, remoteKey), tempo_test::IsOk());
+
+    auto publicKey = remoteKey.publicKey;
+    publicKey[0] ^= 0xff;
+    ASSERT_FALSE (local.validateRemoteKey(publicKey, certificate, remoteKey.digest).isOk());
+    ASSERT_EQ (0, local.numVerifiedPeers());
+}
+
+TEST_F(StaticKeyManager, EvictLeastRecentlyVerifiedPeer)
+{
+    chord_mesh::StaticKeyManagerOptions options;
+    options.verifiedPeerCacheSize = 1;
+    chord_mesh::StaticKeyManager local(streamKeypair, trustStore, options);
+    chord_mesh::StaticKeyManager remote(streamKeypair, trustStore);
+
+    std::shared_ptr<tempo_security::X509Certificate> certificate;
+    chord_mesh::StaticKeypair remoteKey1;
+    ASSERT_THAT (remote.getLocalKey(certificate, remoteKey1), tempo_test::IsOk());
+    ASSERT_THAT (remote.rotateLocalKey(), tempo_test::IsOk());
+    chord_mesh::StaticKeypair remoteKey2;
+    ASSERT_THAT (remote.getLocalKey(certificate, remoteKey2), tempo_test::IsOk());
+
+    ASSERT_THAT (local.validateRemoteKey(remoteKey1.publicKey, certificate, remoteKey1.digest), tempo_test::IsOk());
+    ASSERT_THAT (local.validateRemoteKey(remoteKey2.publicKey, certificate, remoteKey2.digest), tempo_test::IsOk());
+    ASSERT_EQ (1, local.numVerifiedPeers());
+
+    // the first key was evicted so it must be verified again
+    ASSERT_THAT (local.validateRemoteKey(remoteKey1.publicKey, certificate, remoteKey1.digest), tempo_test::IsOk());
+    ASSERT_EQ (0, local.getCacheHits());
+    ASSERT_EQ (3, local.getCacheMisses());
+}
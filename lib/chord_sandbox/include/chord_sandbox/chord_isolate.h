@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <vector>
 
+#include <absl/functional/any_invocable.h>
+#include <absl/synchronization/mutex.h>
 #include <grpcpp/channel.h>
 
 #include <chord_common/abstract_certificate_signer.h>
@@ -30,13 +32,33 @@ namespace chord_sandbox {
         std::shared_ptr<chord_common::AbstractProtocolHandler> handler;
     };
 
+    /**
+     * Maximum number of launch workers of an isolate, which are shared by launchAsync and
+     * launchBatch.
+     */
+    constexpr int kDefaultLaunchConcurrency = 16;
+
+    /**
+     * The parameters of a single machine launch.
+     */
+    struct LaunchRequest {
+        std::string name;
+        tempo_utils::Url mainLocation;
+        tempo_config::ConfigMap configMap;
+        std::vector<RequestedPortAndHandler> plugs = {};
+        bool startSuspended = false;
+    };
+
+    typedef tempo_utils::Result<std::shared_ptr<RemoteMachine>> LaunchResult;
+    typedef absl::AnyInvocable<void(LaunchResult) &&> LaunchCallback;
+
     /**
      *
      */
     class ChordIsolate {
 
     public:
-        virtual ~ChordIsolate() = default;
+        virtual ~ChordIsolate();
 
         static tempo_utils::Result<std::shared_ptr<ChordIsolate>> spawn(
             std::string_view sessionName,
@@ -58,6 +80,12 @@ namespace chord_sandbox {
             std::shared_ptr<chord_common::AbstractCertificateSigner> certificateSigner,
             absl::Duration connectTimeout);
 
+        /**
+         * The time from spawning the agent until the agent reported that it was listening. Zero
+         * if the isolate connected to an existing session.
+         */
+        absl::Duration getStartupLatency() const;
+
         tempo_utils::Result<std::shared_ptr<RemoteMachine>> launch(
             std::string_view name,
             const tempo_utils::Url &mainLocation,
@@ -65,6 +93,31 @@ namespace chord_sandbox {
             const std::vector<RequestedPortAndHandler> &plugs = {},
             bool startSuspended = false);
 
+        /**
+         * Launch a machine without blocking the caller. The launch runs on a launch worker and
+         * the callback is invoked on the worker thread once the launch completes. At most
+         * kDefaultLaunchConcurrency launches run at the same time. If the isolate shuts down
+         * before the launch starts then the callback receives an error status.
+         *
+         * @param request The launch parameters.
+         * @param callback The callback which receives the launch result.
+         * @return Ok status if the launch was queued, otherwise error status.
+         */
+        tempo_utils::Status launchAsync(LaunchRequest request, LaunchCallback callback);
+
+        /**
+         * Launch a batch of machines using one CreateMachineBatch and one RunMachineBatch call,
+         * signing the endpoint certificates on the calling thread and the launch workers, using
+         * at most `maxConcurrency` threads. Blocks until every launch in the batch has completed.
+         *
+         * @param requests The launch parameters for each machine.
+         * @param maxConcurrency The maximum number of threads which sign certificates.
+         * @return The launch result for each request, in the same order as the requests.
+         */
+        std::vector<LaunchResult> launchBatch(
+            const std::vector<LaunchRequest> &requests,
+            int maxConcurrency = kDefaultLaunchConcurrency);
+
         tempo_utils::Status shutdown();
 
     private:
@@ -76,7 +129,17 @@ namespace chord_sandbox {
         struct SandboxPriv;
         std::unique_ptr<SandboxPriv> m_priv;
 
-        absl::flat_hash_map<tempo_utils::Url,std::shared_ptr<RemoteMachine>> m_machines;
+        absl::Mutex m_lock;
+        absl::flat_hash_map<tempo_utils::Url,std::shared_ptr<RemoteMachine>> m_machines ABSL_GUARDED_BY(m_lock);
+
+        tempo_utils::Result<std::shared_ptr<RemoteMachine>> attachMachine(
+            std::string_view name,
+            const tempo_utils::Url &mainLocation,
+            const tempo_utils::Url &machineUrl,
+            const tempo_utils::Url &controlUrl,
+            const std::string &controlNameOverride,
+            std::shared_ptr<GrpcConnector> connector,
+            bool startSuspended);
 
         static tempo_utils::Result<std::shared_ptr<ChordIsolate>> spawn(
             const std::filesystem::path &sessionDirectory,
@@ -0,0 +1,53 @@
+#ifndef CHORD_SANDBOX_INTERNAL_LAUNCH_EXECUTOR_H
+#define CHORD_SANDBOX_INTERNAL_LAUNCH_EXECUTOR_H
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <absl/functional/any_invocable.h>
+#include <absl/synchronization/mutex.h>
+#include <uv.h>
+
+#include <tempo_utils/status.h>
+
+namespace chord_sandbox::internal {
+
+    /**
+     * A task which is run by the launch executor. The task is invoked with ok status when it runs
+     * on a worker, or with error status if the executor shut down before the task started.
+     */
+    typedef absl::AnyInvocable<void(tempo_utils::Status) &&> LaunchTask;
+
+    /**
+     * Bounded set of worker threads which runs every launch task of an isolate. Workers are
+     * started on demand when every worker is busy, up to the maximum number of workers, and are
+     * stopped when the executor shuts down.
+     */
+    class LaunchExecutor {
+    public:
+        explicit LaunchExecutor(int maxWorkers);
+        ~LaunchExecutor();
+
+        int getMaxWorkers() const;
+
+        tempo_utils::Status submit(LaunchTask task);
+        void runBounded(size_t numItems, int maxConcurrency, std::function<void(size_t)> fn);
+        void shutdown();
+
+    private:
+        int m_maxWorkers;
+        absl::Mutex m_lock;
+        std::deque<LaunchTask> m_pending ABSL_GUARDED_BY(m_lock);
+        std::vector<uv_thread_t> m_workers ABSL_GUARDED_BY(m_lock);
+        int m_numIdle ABSL_GUARDED_BY(m_lock);
+        bool m_stopping ABSL_GUARDED_BY(m_lock);
+
+        bool hasWork() const ABSL_SHARED_LOCKS_REQUIRED(m_lock);
+        void runWorker();
+
+        friend void run_launch_executor_worker(void *arg);
+    };
+}
+
+#endif // CHORD_SANDBOX_INTERNAL_LAUNCH_EXECUTOR_H
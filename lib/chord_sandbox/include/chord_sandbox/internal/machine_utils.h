@@ -1,11 +1,24 @@
 #ifndef CHORD_SANDBOX_INTERNAL_MACHINE_UTILS_H
 #define CHORD_SANDBOX_INTERNAL_MACHINE_UTILS_H
 
+#include <absl/synchronization/notification.h>
+
 #include <chord_common/abstract_certificate_signer.h>
 #include <chord_sandbox/chord_isolate.h>
 
 namespace chord_sandbox::internal {
 
+    /**
+     * The parameters for creating a single machine.
+     */
+    struct CreateMachineParams {
+        std::string name;
+        tempo_utils::Url executionUrl;
+        tempo_config::ConfigMap configMap;
+        absl::flat_hash_set<chord_common::RequestedPort> requestedPorts;
+        bool startSuspended = false;
+    };
+
     /**
      * The result from calling create_machine.
      */
@@ -20,6 +33,18 @@ namespace chord_sandbox::internal {
             std::string> endpointCsrs;              /**< Map of endpoint url to certificate signing request. */
     };
 
+    /**
+     * The result from calling sign_endpoints.
+     */
+    struct SignEndpointsResult {
+        absl::flat_hash_map<
+            tempo_utils::Url,
+            std::string> endpointCertificates;      /**< Map of endpoint url to pem certificate. */
+        absl::flat_hash_map<
+            tempo_utils::Url,
+            std::string> endpointNameOverrides;     /**< Map of endpoint url to certificate common name. */
+    };
+
     /**
      * The result from calling run_machine.
      */
@@ -29,6 +54,52 @@ namespace chord_sandbox::internal {
             std::string> endpointNameOverrides;
     };
 
+    /**
+     * A RunMachine call which is in flight. The caller may do other work until it calls wait().
+     * If the call is destroyed before it completes then the call is cancelled.
+     */
+    class RunMachineCall {
+    public:
+        RunMachineCall(const tempo_utils::Url &machineUrl, const SignEndpointsResult &signEndpointsResult);
+        ~RunMachineCall();
+
+        void start(chord_invoke::InvokeService::StubInterface *stub);
+        tempo_utils::Status wait();
+
+    private:
+        tempo_utils::Url m_machineUrl;
+        grpc::ClientContext m_context;
+        chord_invoke::RunMachineRequest m_request;
+        chord_invoke::RunMachineResult m_result;
+        grpc::Status m_status;
+        bool m_started;
+        absl::Notification m_done;
+    };
+
+    /**
+     * A RunMachineBatch call which is in flight. Each machine in the batch succeeds or fails
+     * independently. If the call is destroyed before it completes then the call is cancelled.
+     */
+    class RunMachineBatchCall {
+    public:
+        RunMachineBatchCall();
+        ~RunMachineBatchCall();
+
+        int addMachine(const tempo_utils::Url &machineUrl, const SignEndpointsResult &signEndpointsResult);
+        int numMachines() const;
+
+        void start(chord_invoke::InvokeService::StubInterface *stub);
+        tempo_utils::Result<std::vector<tempo_utils::Status>> wait();
+
+    private:
+        grpc::ClientContext m_context;
+        chord_invoke::RunMachineBatchRequest m_request;
+        chord_invoke::RunMachineBatchResult m_result;
+        grpc::Status m_status;
+        bool m_started;
+        absl::Notification m_done;
+    };
+
     tempo_utils::Result<CreateMachineResult> create_machine(
         chord_invoke::InvokeService::StubInterface *stub,
         std::string_view name,
@@ -37,6 +108,20 @@ namespace chord_sandbox::internal {
         const absl::flat_hash_set<chord_common::RequestedPort> &requestedPorts,
         bool startSuspended);
 
+    tempo_utils::Result<std::vector<tempo_utils::Result<CreateMachineResult>>> create_machine_batch(
+        chord_invoke::InvokeService::StubInterface *stub,
+        const std::vector<CreateMachineParams> &batch);
+
+    tempo_utils::Result<SignEndpointsResult> sign_endpoints(
+        const absl::flat_hash_map<tempo_utils::Url,std::string> &endpointCsrs,
+        std::shared_ptr<chord_common::AbstractCertificateSigner> certificateSigner,
+        absl::Duration requestedValidityPeriod);
+
+    tempo_utils::Result<std::unique_ptr<RunMachineCall>> start_run_machine(
+        chord_invoke::InvokeService::StubInterface *stub,
+        const tempo_utils::Url &machineUrl,
+        const SignEndpointsResult &signEndpointsResult);
+
     tempo_utils::Result<RunMachineResult> run_machine(
         chord_invoke::InvokeService::StubInterface *stub,
         const tempo_utils::Url &machineUrl,
@@ -14,9 +14,19 @@ namespace chord_sandbox::internal {
         std::filesystem::path pemPrivateKeyFile;
     };
 
+    /**
+     * The readiness report sent by the agent once it is listening.
+     */
+    struct SessionReadiness {
+        chord_common::TransportLocation endpoint;
+        std::string serverName;
+        absl::Time readyTime;
+    };
+
     struct SpawnSessionResult {
         std::shared_ptr<tempo_utils::ProcessRunner> process;
         chord_common::TransportLocation endpoint;
+        absl::Duration startupLatency;
     };
 
     struct LoadSessionResult {
@@ -41,6 +51,10 @@ namespace chord_sandbox::internal {
 
     tempo_utils::Result<LoadSessionResult> load_session(const std::filesystem::path &sessionDirectory);
 
+    tempo_utils::Result<SessionReadiness> parse_session_readiness(std::string_view report);
+
+    tempo_utils::Result<SessionReadiness> wait_for_session_readiness(int readyFd, absl::Duration timeout);
+
     tempo_utils::Result<chord_common::TransportLocation> load_session_endpoint(
         const std::filesystem::path &sessionDirectory,
         absl::Duration timeout);
@@ -10,6 +10,12 @@
 
 namespace chord_sandbox {
 
+    /**
+     * Reactor implementing the client end of the Communicate rpc. The stream starts without
+     * credit, and holds writes in the queue until the server has granted credit to send them,
+     * so the server receive queue is never overrun, even by writes made immediately after the
+     * stream is started.
+     */
     class ClientCommunicationStream
         : public grpc::ClientBidiReactor<
             chord_remoting::Message,
@@ -45,6 +51,11 @@ namespace chord_sandbox {
         absl::Mutex m_lock;
         PendingWrite *m_head ABSL_GUARDED_BY(m_lock);
         PendingWrite *m_tail ABSL_GUARDED_BY(m_lock);
+        bool m_writing ABSL_GUARDED_BY(m_lock);
+        tu_uint32 m_credit ABSL_GUARDED_BY(m_lock);
+
+        bool receiveCredit(const chord_remoting::Message &message);
+        void startNextWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(m_lock);
     };
 
     class RemotingClient {
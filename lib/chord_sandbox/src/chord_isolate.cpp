@@ -1,10 +1,13 @@
 #include <sys/wait.h>
 
+
 #include <absl/container/flat_hash_map.h>
 #include <absl/strings/ascii.h>
 #include <grpcpp/create_channel.h>
+#include <uv.h>
 
 #include <chord_invoke/invoke_service.grpc.pb.h>
+#include <chord_sandbox/internal/launch_executor.h>
 #include <chord_sandbox/internal/machine_utils.h>
 #include <chord_sandbox/internal/session_utils.h>
 #include <chord_sandbox/local_certificate_signer.h>
@@ -17,6 +20,8 @@
 
 struct chord_sandbox::ChordIsolate::SandboxPriv {
     std::unique_ptr<chord_invoke::InvokeService::Stub> stub;
+    absl::Duration startupLatency;
+    internal::LaunchExecutor executor{kDefaultLaunchConcurrency};
 };
 
 #include <chord_sandbox/chord_isolate.h>
@@ -155,6 +160,7 @@ chord_sandbox::ChordIsolate::spawn(
     auto channel = grpc::CreateCustomChannel(target, credentials, channelArguments);
     auto priv = std::make_unique<SandboxPriv>();
     priv->stub = chord_invoke::InvokeService::NewStub(channel);
+    priv->startupLatency = spawnSessionResult.startupLatency;
 
     // verify that the agent is running
     grpc::ClientContext context;
@@ -192,86 +198,159 @@ chord_sandbox::ChordIsolate::ChordIsolate(
     TU_ASSERT (m_priv != nullptr);
 }
 
-tempo_utils::Result<std::shared_ptr<chord_sandbox::RemoteMachine>>
-chord_sandbox::ChordIsolate::launch(
-    std::string_view name,
-    const tempo_utils::Url &mainLocation,
-    const tempo_config::ConfigMap &configMap,
-    const std::vector<RequestedPortAndHandler> &plugs,
-    bool startSuspended)
+chord_sandbox::ChordIsolate::~ChordIsolate()
 {
-    TU_ASSERT (!name.empty());
-    TU_ASSERT (mainLocation.isValid());
+    if (m_priv != nullptr) {
+        m_priv->executor.shutdown();
+    }
+}
 
-    absl::flat_hash_set<chord_common::RequestedPort> requestedPortsSet;
-    absl::flat_hash_map<tempo_utils::Url,std::shared_ptr<chord_common::AbstractProtocolHandler>> plugHandlersMap;
+absl::Duration
+chord_sandbox::ChordIsolate::getStartupLatency() const
+{
+    if (m_priv == nullptr)
+        return {};
+    return m_priv->startupLatency;
+}
 
-    // extract requested port and plug handler from plugs list
+typedef absl::flat_hash_map<
+    tempo_utils::Url,
+    std::shared_ptr<chord_common::AbstractProtocolHandler>> PlugHandlersMap;
+
+/**
+ * Extract the requested port and plug handler from each plug in the plugs list.
+ */
+static tempo_utils::Status
+collect_plugs(
+    const std::vector<chord_sandbox::RequestedPortAndHandler> &plugs,
+    absl::flat_hash_set<chord_common::RequestedPort> &requestedPortsSet,
+    PlugHandlersMap &plugHandlersMap)
+{
     for (const auto &plug : plugs) {
         const auto &requestedPort = plug.requestedPort;
         const auto protocolUrl = requestedPort.getUrl();
         if (plug.handler == nullptr)
-            return SandboxStatus::forCondition( SandboxCondition::kInvalidConfiguration,
+            return chord_sandbox::SandboxStatus::forCondition(
+                chord_sandbox::SandboxCondition::kInvalidConfiguration,
                 "requested port {} has invalid handler", protocolUrl.toString());
         if (plugHandlersMap.contains(protocolUrl))
-            return SandboxStatus::forCondition( SandboxCondition::kInvalidConfiguration,
+            return chord_sandbox::SandboxStatus::forCondition(
+                chord_sandbox::SandboxCondition::kInvalidConfiguration,
                 "requested port {} was already specified", protocolUrl.toString());
         plugHandlersMap[protocolUrl] = plug.handler;
         requestedPortsSet.insert(requestedPort);
     }
+    return {};
+}
 
-    // call CreateMachine on the agent endpoint
-    internal::CreateMachineResult createMachineResult;
-    TU_ASSIGN_OR_RETURN (createMachineResult, internal::create_machine(m_priv->stub.get(),
-        name, mainLocation, configMap, requestedPortsSet, /* startSuspended= */ true));
-
-    // call RunMachine on the agent endpoint
-    internal::RunMachineResult runMachineResult;
-    TU_ASSIGN_OR_RETURN (runMachineResult, internal::run_machine(m_priv->stub.get(),
-        createMachineResult.machineUrl, createMachineResult.protocolEndpoints,
-        createMachineResult.endpointCsrs, m_certificateSigner, absl::Hours(4)));
-
-    // create the connector
-    auto connector = std::make_shared<GrpcConnector>(
-        createMachineResult.machineUrl, lyric_common::RuntimePolicy());
+static std::string
+get_name_override(
+    const chord_sandbox::internal::SignEndpointsResult &signEndpointsResult,
+    const tempo_utils::Url &endpointUrl)
+{
+    auto entry = signEndpointsResult.endpointNameOverrides.find(endpointUrl);
+    if (entry == signEndpointsResult.endpointNameOverrides.cend())
+        return {};
+    return entry->second;
+}
 
-    // register plugs with the connector
+/**
+ * Register the plug handler for each protocol declared by the machine with the connector.
+ */
+static tempo_utils::Status
+register_plugs(
+    chord_sandbox::GrpcConnector *connector,
+    const chord_sandbox::internal::CreateMachineResult &createMachineResult,
+    const chord_sandbox::internal::SignEndpointsResult &signEndpointsResult,
+    const PlugHandlersMap &plugHandlersMap,
+    const std::filesystem::path &pemRootCABundleFile)
+{
     for (const auto &entry : createMachineResult.protocolEndpoints) {
         auto protocolUrl = entry.first;
         TU_ASSERT (protocolUrl.isValid());
 
-        if (!plugHandlersMap.contains(protocolUrl))
-            return SandboxStatus::forCondition(SandboxCondition::kInvalidPort,
+        auto plugHandler = plugHandlersMap.find(protocolUrl);
+        if (plugHandler == plugHandlersMap.cend())
+            return chord_sandbox::SandboxStatus::forCondition(chord_sandbox::SandboxCondition::kInvalidPort,
                 "no registered plug for protocol {}", protocolUrl.toString());
-        auto &handler = plugHandlersMap.at(protocolUrl);
 
-        // get the endpoint name override
         auto &endpointUrl = entry.second;
-        std::string nameOverride;
-        if (runMachineResult.endpointNameOverrides.contains(endpointUrl)) {
-            nameOverride = runMachineResult.endpointNameOverrides.at(endpointUrl);
-        }
+        auto nameOverride = get_name_override(signEndpointsResult, endpointUrl);
 
-        TU_RETURN_IF_NOT_OK (connector->registerProtocolHandler(protocolUrl, handler, endpointUrl,
-            m_pemRootCABundleFile, nameOverride));
+        TU_RETURN_IF_NOT_OK (connector->registerProtocolHandler(protocolUrl, plugHandler->second,
+            endpointUrl, pemRootCABundleFile, nameOverride));
         TU_LOG_INFO << "registering handler for protocol " << protocolUrl << " using endpoint " << endpointUrl;
     }
+    return {};
+}
 
-    // get the control name override
-    auto &controlUrl = createMachineResult.controlUrl;
-    std::string nameOverride;
-    if (runMachineResult.endpointNameOverrides.contains(controlUrl)) {
-        nameOverride = runMachineResult.endpointNameOverrides.at(controlUrl);
-    }
+tempo_utils::Result<std::shared_ptr<chord_sandbox::RemoteMachine>>
+chord_sandbox::ChordIsolate::launch(
+    std::string_view name,
+    const tempo_utils::Url &mainLocation,
+    const tempo_config::ConfigMap &configMap,
+    const std::vector<RequestedPortAndHandler> &plugs,
+    bool startSuspended)
+{
+    TU_ASSERT (!name.empty());
+    TU_ASSERT (mainLocation.isValid());
+
+    absl::flat_hash_set<chord_common::RequestedPort> requestedPortsSet;
+    PlugHandlersMap plugHandlersMap;
+    TU_RETURN_IF_NOT_OK (collect_plugs(plugs, requestedPortsSet, plugHandlersMap));
+
+    // call CreateMachine on the agent endpoint
+    internal::CreateMachineResult createMachineResult;
+    TU_ASSIGN_OR_RETURN (createMachineResult, internal::create_machine(m_priv->stub.get(),
+        name, mainLocation, configMap, requestedPortsSet, /* startSuspended= */ true));
+
+    // sign the endpoint certificates, which determines the name override for each endpoint
+    internal::SignEndpointsResult signEndpointsResult;
+    TU_ASSIGN_OR_RETURN (signEndpointsResult, internal::sign_endpoints(
+        createMachineResult.endpointCsrs, m_certificateSigner, absl::Hours(4)));
+
+    // start RunMachine on the agent endpoint, and register the plugs while the call is in flight
+    std::unique_ptr<internal::RunMachineCall> runMachineCall;
+    TU_ASSIGN_OR_RETURN (runMachineCall, internal::start_run_machine(m_priv->stub.get(),
+        createMachineResult.machineUrl, signEndpointsResult));
+
+    // create the connector and register plugs with the connector
+    auto connector = std::make_shared<GrpcConnector>(
+        createMachineResult.machineUrl, lyric_common::RuntimePolicy());
+    TU_RETURN_IF_NOT_OK (register_plugs(connector.get(), createMachineResult, signEndpointsResult,
+        plugHandlersMap, m_pemRootCABundleFile));
+
+    // the endpoints are not bound until RunMachine completes
+    TU_RETURN_IF_NOT_OK (runMachineCall->wait());
+
+    return attachMachine(name, mainLocation, createMachineResult.machineUrl, createMachineResult.controlUrl,
+        get_name_override(signEndpointsResult, createMachineResult.controlUrl), connector, startSuspended);
+}
 
+/**
+ * Connect to the control endpoint of a machine whose endpoints are bound, and track the remote
+ * machine. The machine was started suspended, so if startSuspended is false then the machine is
+ * resumed.
+ */
+tempo_utils::Result<std::shared_ptr<chord_sandbox::RemoteMachine>>
+chord_sandbox::ChordIsolate::attachMachine(
+    std::string_view name,
+    const tempo_utils::Url &mainLocation,
+    const tempo_utils::Url &machineUrl,
+    const tempo_utils::Url &controlUrl,
+    const std::string &controlNameOverride,
+    std::shared_ptr<GrpcConnector> connector,
+    bool startSuspended)
+{
     // connect to the control and remoting endpoints
-    TU_RETURN_IF_NOT_OK (connector->connect(createMachineResult.controlUrl,
-        m_pemRootCABundleFile, nameOverride));
+    TU_RETURN_IF_NOT_OK (connector->connect(controlUrl, m_pemRootCABundleFile, controlNameOverride));
 
     // create the remote machine
-    auto &machineUrl = createMachineResult.machineUrl;
     auto machine = std::make_shared<RemoteMachine>(name, mainLocation, machineUrl, connector);
-    m_machines[machineUrl] = machine;
+    {
+        absl::MutexLock locker(&m_lock);
+        m_machines[machineUrl] = machine;
+    }
 
     // the remote machine is suspended, so if startSuspended is false then resume the machine
     if (!startSuspended) {
@@ -281,12 +360,176 @@ chord_sandbox::ChordIsolate::launch(
     return machine;
 }
 
+tempo_utils::Status
+chord_sandbox::ChordIsolate::launchAsync(LaunchRequest request, LaunchCallback callback)
+{
+    TU_ASSERT (!request.name.empty());
+    TU_ASSERT (request.mainLocation.isValid());
+
+    if (m_priv == nullptr)
+        return SandboxStatus::forCondition(
+            SandboxCondition::kSandboxInvariant, "sandbox is not initialized");
+
+    return m_priv->executor.submit(
+        [this, request = std::move(request), callback = std::move(callback)](tempo_utils::Status status) mutable {
+            if (status.notOk()) {
+                std::move(callback)(status);
+                return;
+            }
+            auto launchResult = launch(request.name, request.mainLocation, request.configMap,
+                request.plugs, request.startSuspended);
+            std::move(callback)(std::move(launchResult));
+        });
+}
+
+/**
+ * The state of a single machine in a launch batch.
+ */
+struct BatchItem {
+    PlugHandlersMap plugHandlersMap;
+    chord_sandbox::internal::CreateMachineResult createMachineResult;
+    chord_sandbox::internal::SignEndpointsResult signEndpointsResult;
+    std::shared_ptr<chord_sandbox::GrpcConnector> connector;
+    bool isSigned = false;
+    int runIndex = -1;
+};
+
+/**
+ * Launch a batch of machines. The machines are created with a single CreateMachineBatch call and
+ * run with a single RunMachineBatch call, so the agent round trips do not grow with the size of
+ * the batch. The endpoint certificates are signed concurrently, using at most `maxConcurrency`
+ * threads. Each machine succeeds or fails independently.
+ */
+std::vector<chord_sandbox::LaunchResult>
+chord_sandbox::ChordIsolate::launchBatch(const std::vector<LaunchRequest> &requests, int maxConcurrency)
+{
+    TU_ASSERT (maxConcurrency > 0);
+
+    std::vector<LaunchResult> results(requests.size(),
+        SandboxStatus::forCondition(SandboxCondition::kSandboxInvariant, "machine was not launched"));
+    if (requests.empty())
+        return results;
+
+    std::vector<BatchItem> items(requests.size());
+    std::vector<internal::CreateMachineParams> createBatch;
+    std::vector<size_t> created;
+
+    // validate the plugs of each request and build the CreateMachineBatch parameters
+    for (size_t i = 0; i < requests.size(); i++) {
+        const auto &request = requests.at(i);
+        TU_ASSERT (!request.name.empty());
+        TU_ASSERT (request.mainLocation.isValid());
+        internal::CreateMachineParams params;
+        auto status = collect_plugs(request.plugs, params.requestedPorts, items[i].plugHandlersMap);
+        if (status.notOk()) {
+            results[i] = status;
+            continue;
+        }
+        params.name = request.name;
+        params.executionUrl = request.mainLocation;
+        params.configMap = request.configMap;
+        params.startSuspended = true;
+        createBatch.push_back(std::move(params));
+        created.push_back(i);
+    }
+    if (created.empty())
+        return results;
+
+    // call CreateMachineBatch on the agent endpoint
+    auto createMachineBatchResult = internal::create_machine_batch(m_priv->stub.get(), createBatch);
+    if (createMachineBatchResult.isStatus()) {
+        for (auto index : created) {
+            results[index] = createMachineBatchResult.getStatus();
+        }
+        return results;
+    }
+    auto createMachineResults = createMachineBatchResult.getResult();
+
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < created.size(); i++) {
+        auto index = created.at(i);
+        auto &createMachineResult = createMachineResults.at(i);
+        if (createMachineResult.isStatus()) {
+            results[index] = createMachineResult.getStatus();
+            continue;
+        }
+        items[index].createMachineResult = createMachineResult.getResult();
+        pending.push_back(index);
+    }
+
+    // sign the endpoint certificates on the launch executor, sharing the workers with launchAsync
+    m_priv->executor.runBounded(pending.size(), maxConcurrency, [&](size_t next) {
+        auto index = pending.at(next);
+        auto &item = items[index];
+        auto signEndpointsResult = internal::sign_endpoints(
+            item.createMachineResult.endpointCsrs, m_certificateSigner, absl::Hours(4));
+        if (signEndpointsResult.isStatus()) {
+            results[index] = signEndpointsResult.getStatus();
+        } else {
+            item.signEndpointsResult = signEndpointsResult.getResult();
+            item.isSigned = true;
+        }
+    });
+
+    // register the plugs for each signed machine, machines which fail are not run
+    internal::RunMachineBatchCall runMachineBatchCall;
+    std::vector<size_t> running;
+    for (auto index : pending) {
+        auto &item = items[index];
+        if (!item.isSigned)
+            continue;
+        item.connector = std::make_shared<GrpcConnector>(
+            item.createMachineResult.machineUrl, lyric_common::RuntimePolicy());
+        auto status = register_plugs(item.connector.get(), item.createMachineResult,
+            item.signEndpointsResult, item.plugHandlersMap, m_pemRootCABundleFile);
+        if (status.notOk()) {
+            results[index] = status;
+            continue;
+        }
+        item.runIndex = runMachineBatchCall.addMachine(
+            item.createMachineResult.machineUrl, item.signEndpointsResult);
+        running.push_back(index);
+    }
+    if (running.empty())
+        return results;
+
+    // call RunMachineBatch on the agent endpoint, the endpoints are not bound until it completes
+    runMachineBatchCall.start(m_priv->stub.get());
+    auto runMachineBatchResult = runMachineBatchCall.wait();
+    if (runMachineBatchResult.isStatus()) {
+        for (auto index : running) {
+            results[index] = runMachineBatchResult.getStatus();
+        }
+        return results;
+    }
+    auto runMachineStatuses = runMachineBatchResult.getResult();
+
+    // attach each running machine
+    for (auto index : running) {
+        auto &item = items[index];
+        const auto &request = requests.at(index);
+        auto &status = runMachineStatuses.at(item.runIndex);
+        if (status.notOk()) {
+            results[index] = status;
+            continue;
+        }
+        const auto &createMachineResult = item.createMachineResult;
+        results[index] = attachMachine(request.name, request.mainLocation,
+            createMachineResult.machineUrl, createMachineResult.controlUrl,
+            get_name_override(item.signEndpointsResult, createMachineResult.controlUrl),
+            item.connector, request.startSuspended);
+    }
+
+    return results;
+}
+
 tempo_utils::Status
 chord_sandbox::ChordIsolate::shutdown()
 {
     if (m_priv == nullptr)
         return SandboxStatus::forCondition(
             SandboxCondition::kSandboxInvariant, "sandbox is not initialized");
+    m_priv->executor.shutdown();
     m_priv.reset();
     m_channel.reset();
     return {};
@@ -0,0 +1,186 @@
+#include <atomic>
+
+#include <chord_sandbox/internal/launch_executor.h>
+#include <chord_sandbox/sandbox_result.h>
+#include <tempo_utils/log_stream.h>
+
+chord_sandbox::internal::LaunchExecutor::LaunchExecutor(int maxWorkers)
+    : m_maxWorkers(maxWorkers),
+      m_numIdle(0),
+      m_stopping(false)
+{
+    TU_ASSERT (m_maxWorkers > 0);
+}
+
+chord_sandbox::internal::LaunchExecutor::~LaunchExecutor()
+{
+    shutdown();
+}
+
+int
+chord_sandbox::internal::LaunchExecutor::getMaxWorkers() const
+{
+    return m_maxWorkers;
+}
+
+bool
+chord_sandbox::internal::LaunchExecutor::hasWork() const
+{
+    return m_stopping || !m_pending.empty();
+}
+
+void
+chord_sandbox::internal::run_launch_executor_worker(void *arg)
+{
+    auto *executor = static_cast<LaunchExecutor *>(arg);
+    executor->runWorker();
+}
+
+void
+chord_sandbox::internal::LaunchExecutor::runWorker()
+{
+    for (;;) {
+        LaunchTask task;
+        {
+            absl::MutexLock locker(&m_lock);
+            m_numIdle++;
+            m_lock.Await(absl::Condition(this, &LaunchExecutor::hasWork));
+            m_numIdle--;
+            if (m_stopping)
+                return;
+            task = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        std::move(task)(tempo_utils::Status{});
+    }
+}
+
+/**
+ * Queue the task to run on a worker. If every worker is busy and the maximum number of workers
+ * has not been reached then another worker is started.
+ *
+ * @param task The task.
+ * @return Ok status if the task was queued, otherwise error status.
+ */
+tempo_utils::Status
+chord_sandbox::internal::LaunchExecutor::submit(LaunchTask task)
+{
+    absl::MutexLock locker(&m_lock);
+
+    if (m_stopping)
+        return SandboxStatus::forCondition(
+            SandboxCondition::kSandboxInvariant, "sandbox is shutting down");
+
+    m_pending.push_back(std::move(task));
+
+    int numWaiting = m_pending.size();
+    if (numWaiting > m_numIdle && m_workers.size() < m_maxWorkers) {
+        uv_thread_t tid;
+        auto ret = uv_thread_create(&tid, run_launch_executor_worker, this);
+        if (ret == 0) {
+            m_workers.push_back(tid);
+        } else if (m_workers.empty()) {
+            m_pending.pop_back();
+            return SandboxStatus::forCondition(SandboxCondition::kSandboxInvariant,
+                "failed to create launch worker: {}", uv_strerror(ret));
+        }
+    }
+
+    return {};
+}
+
+/**
+ * The shared state of a runBounded call. Tasks which start after every item has been claimed
+ * find no work and return, so the state is shared with the tasks rather than owned by the caller.
+ */
+struct BoundedRun {
+    std::function<void(size_t)> fn;
+    size_t numItems;
+    std::atomic<size_t> next;
+    absl::Mutex lock;
+    size_t completed ABSL_GUARDED_BY(lock);
+
+    bool isComplete() const ABSL_SHARED_LOCKS_REQUIRED(lock) {
+        return completed == numItems;
+    }
+
+    void runItems() {
+        for (;;) {
+            auto index = next.fetch_add(1);
+            if (numItems <= index)
+                return;
+            fn(index);
+            absl::MutexLock locker(&lock);
+            completed++;
+        }
+    }
+};
+
+/**
+ * Invoke `fn` for each index in [0, numItems), using the calling thread and at most
+ * `maxConcurrency - 1` executor workers. The calling thread claims items too, so the run makes
+ * progress even when every worker is busy. Blocks until `fn` has returned for every index.
+ *
+ * @param numItems The number of items.
+ * @param maxConcurrency The maximum number of threads which invoke `fn` at the same time.
+ * @param fn The function which is invoked with the index of each item.
+ */
+void
+chord_sandbox::internal::LaunchExecutor::runBounded(
+    size_t numItems,
+    int maxConcurrency,
+    std::function<void(size_t)> fn)
+{
+    TU_ASSERT (maxConcurrency > 0);
+    if (numItems == 0)
+        return;
+
+    auto run = std::make_shared<BoundedRun>();
+    run->fn = std::move(fn);
+    run->numItems = numItems;
+    run->next.store(0);
+    run->completed = 0;
+
+    int numTasks = std::min<size_t>(maxConcurrency, numItems) - 1;
+    for (int i = 0; i < numTasks; i++) {
+        auto status = submit([run](tempo_utils::Status status) {
+            if (status.isOk()) {
+                run->runItems();
+            }
+        });
+        if (status.notOk())
+            break;
+    }
+
+    run->runItems();
+
+    absl::MutexLock locker(&run->lock);
+    run->lock.Await(absl::Condition(run.get(), &BoundedRun::isComplete));
+}
+
+/**
+ * Stop the workers once they finish their current task, and fail any tasks which never started.
+ */
+void
+chord_sandbox::internal::LaunchExecutor::shutdown()
+{
+    std::vector<uv_thread_t> workers;
+    std::deque<LaunchTask> pending;
+    {
+        absl::MutexLock locker(&m_lock);
+        m_stopping = true;
+        workers = std::move(m_workers);
+        m_workers.clear();
+        pending = std::move(m_pending);
+        m_pending.clear();
+    }
+
+    for (auto &tid : workers) {
+        uv_thread_join(&tid);
+    }
+
+    for (auto &task : pending) {
+        std::move(task)(SandboxStatus::forCondition(
+            SandboxCondition::kSandboxInvariant, "sandbox was shut down before launch"));
+    }
+}
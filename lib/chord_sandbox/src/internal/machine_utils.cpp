@@ -7,31 +7,25 @@
 #include <tempo_security/certificate_key_pair.h>
 #include <tempo_security/x509_certificate_signing_request.h>
 
-tempo_utils::Result<chord_sandbox::internal::CreateMachineResult>
-chord_sandbox::internal::create_machine(
-    chord_invoke::InvokeService::StubInterface *stub,
-    std::string_view name,
-    const tempo_utils::Url &executionUrl,
-    const tempo_config::ConfigMap &configMap,
-    const absl::flat_hash_set<chord_common::RequestedPort> &requestedPorts,
-    bool startSuspended)
+/**
+ * Build the CreateMachine request for a single machine.
+ */
+static tempo_utils::Status
+build_create_machine_request(
+    const chord_sandbox::internal::CreateMachineParams &params,
+    chord_invoke::CreateMachineRequest &createMachineRequest)
 {
-    grpc::ClientContext createMachineContext;
-    chord_invoke::CreateMachineRequest createMachineRequest;
-    chord_invoke::CreateMachineResult createMachineResult;
-    CreateMachineResult result;
-
     // set the name of the machine
-    createMachineRequest.set_name(name);
+    createMachineRequest.set_name(params.name);
 
     // set the execution uri to the main location
-    createMachineRequest.set_execution_url(executionUrl.toString());
+    createMachineRequest.set_execution_url(params.executionUrl.toString());
 
     // set flag indicating whether to start the remote machine in suspended state
-    createMachineRequest.set_start_suspended(startSuspended);
+    createMachineRequest.set_start_suspended(params.startSuspended);
 
     // add a requested port for each given port parameter
-    for (const auto &requestedPort : requestedPorts) {
+    for (const auto &requestedPort : params.requestedPorts) {
         auto protocolUrl = requestedPort.getUrl();
         auto *requestedPortPtr = createMachineRequest.add_requested_ports();
         requestedPortPtr->set_protocol_url(protocolUrl.toString());
@@ -43,8 +37,8 @@ chord_sandbox::internal::create_machine(
                 requestedPortPtr->set_port_type(chord_invoke::Streaming);
                 break;
             default:
-                return SandboxStatus::forCondition(
-                    SandboxCondition::kInvalidConfiguration, "invalid port type");
+                return chord_sandbox::SandboxStatus::forCondition(
+                    chord_sandbox::SandboxCondition::kInvalidConfiguration, "invalid port type");
         }
         switch (requestedPort.getDirection()) {
             case chord_common::PortDirection::Client:
@@ -57,48 +51,55 @@ chord_sandbox::internal::create_machine(
                 requestedPortPtr->set_port_direction(chord_invoke::BiDirectional);
                 break;
             default:
-                return SandboxStatus::forCondition(
-                    SandboxCondition::kInvalidConfiguration, "invalid port direction");
+                return chord_sandbox::SandboxStatus::forCondition(
+                    chord_sandbox::SandboxCondition::kInvalidConfiguration, "invalid port direction");
         }
     }
 
     // set the config hash from the serialized config map
     std::string config;
-    tempo_config::write_config_string(configMap, config);
+    tempo_config::write_config_string(params.configMap, config);
     createMachineRequest.set_config_hash(config);
 
-    // call CreateMachine on the sandbox-agent
-    auto status = stub->CreateMachine(&createMachineContext, createMachineRequest, &createMachineResult);
-    if (!status.ok())
-        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
-            "CreateMachine failed: {}", status.error_message());
+    return {};
+}
+
+/**
+ * Parse the CreateMachine result for a single machine.
+ */
+static tempo_utils::Result<chord_sandbox::internal::CreateMachineResult>
+parse_create_machine_result(const chord_invoke::CreateMachineResult &createMachineResult)
+{
+    chord_sandbox::internal::CreateMachineResult result;
+
     TU_LOG_INFO << "created machine " << createMachineResult.machine_url();
 
     // copy the machine url into result
     result.machineUrl = tempo_utils::Url::fromString(createMachineResult.machine_url());
 
     // copy the control url into result if one was returned
+    auto &declaredEndpoints = createMachineResult.declared_endpoints();
     if (createMachineResult.control_endpoint_index() >= 0) {
-        auto &declaredEndpoint = createMachineResult.declared_endpoints(
-            createMachineResult.control_endpoint_index());
+        if (declaredEndpoints.size() <= createMachineResult.control_endpoint_index())
+            return chord_sandbox::SandboxStatus::forCondition(
+                chord_sandbox::SandboxCondition::kInvalidConfiguration, "invalid control endpoint index");
+        auto &declaredEndpoint = declaredEndpoints.at(createMachineResult.control_endpoint_index());
         result.controlUrl = tempo_utils::Url::fromString(declaredEndpoint.endpoint_url());
     }
 
-    auto &declaredEndpoints = createMachineResult.declared_endpoints();
-
     // build the map of protocol url to endpoint url
     for (const auto &declaredPort : createMachineResult.declared_ports()) {
         auto protocolUrl = tempo_utils::Url::fromString(declaredPort.protocol_url());
         if (declaredEndpoints.size() <= declaredPort.endpoint_index())
-            return SandboxStatus::forCondition(
-                SandboxCondition::kInvalidConfiguration, "invalid endpoint index");
+            return chord_sandbox::SandboxStatus::forCondition(
+                chord_sandbox::SandboxCondition::kInvalidConfiguration, "invalid endpoint index");
         auto &declaredEndpoint = declaredEndpoints.at(declaredPort.endpoint_index());
         auto endpointUrl = tempo_utils::Url::fromString(declaredEndpoint.endpoint_url());
         result.protocolEndpoints[protocolUrl] = endpointUrl;
     }
 
     // build the map of endpoint url to CSR
-    for (const auto &declaredEndpoint : createMachineResult.declared_endpoints()) {
+    for (const auto &declaredEndpoint : declaredEndpoints) {
         auto endpointUrl = tempo_utils::Url::fromString(declaredEndpoint.endpoint_url());
         result.endpointCsrs[endpointUrl] = declaredEndpoint.csr();
     }
@@ -106,6 +107,289 @@ chord_sandbox::internal::create_machine(
     return result;
 }
 
+tempo_utils::Result<chord_sandbox::internal::CreateMachineResult>
+chord_sandbox::internal::create_machine(
+    chord_invoke::InvokeService::StubInterface *stub,
+    std::string_view name,
+    const tempo_utils::Url &executionUrl,
+    const tempo_config::ConfigMap &configMap,
+    const absl::flat_hash_set<chord_common::RequestedPort> &requestedPorts,
+    bool startSuspended)
+{
+    grpc::ClientContext createMachineContext;
+    chord_invoke::CreateMachineRequest createMachineRequest;
+    chord_invoke::CreateMachineResult createMachineResult;
+
+    CreateMachineParams params;
+    params.name = name;
+    params.executionUrl = executionUrl;
+    params.configMap = configMap;
+    params.requestedPorts = requestedPorts;
+    params.startSuspended = startSuspended;
+    TU_RETURN_IF_NOT_OK (build_create_machine_request(params, createMachineRequest));
+
+    // call CreateMachine on the sandbox-agent
+    auto status = stub->CreateMachine(&createMachineContext, createMachineRequest, &createMachineResult);
+    if (!status.ok())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "CreateMachine failed: {}", status.error_message());
+
+    return parse_create_machine_result(createMachineResult);
+}
+
+/**
+ * Create a batch of machines using a single CreateMachineBatch call. The call completes once every
+ * machine in the batch has either declared its endpoints or failed to spawn.
+ *
+ * @param stub The agent stub.
+ * @param batch The parameters for each machine.
+ * @return The result for each machine in the same order as the parameters, or error status if
+ *     the call failed.
+ */
+tempo_utils::Result<std::vector<tempo_utils::Result<chord_sandbox::internal::CreateMachineResult>>>
+chord_sandbox::internal::create_machine_batch(
+    chord_invoke::InvokeService::StubInterface *stub,
+    const std::vector<CreateMachineParams> &batch)
+{
+    grpc::ClientContext createMachineBatchContext;
+    chord_invoke::CreateMachineBatchRequest createMachineBatchRequest;
+    chord_invoke::CreateMachineBatchResult createMachineBatchResult;
+
+    for (const auto &params : batch) {
+        TU_RETURN_IF_NOT_OK (build_create_machine_request(params, *createMachineBatchRequest.add_machines()));
+    }
+
+    // call CreateMachineBatch on the sandbox-agent
+    auto status = stub->CreateMachineBatch(&createMachineBatchContext,
+        createMachineBatchRequest, &createMachineBatchResult);
+    if (!status.ok())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "CreateMachineBatch failed: {}", status.error_message());
+    if (createMachineBatchResult.machines_size() != batch.size())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "CreateMachineBatch failed: expected {} results but received {}",
+            batch.size(), createMachineBatchResult.machines_size());
+
+    std::vector<tempo_utils::Result<CreateMachineResult>> results;
+    for (const auto &item : createMachineBatchResult.machines()) {
+        if (item.status_code() != grpc::StatusCode::OK) {
+            results.push_back(SandboxStatus::forCondition(SandboxCondition::kAgentError,
+                "CreateMachine failed: {}", item.status_message()));
+        } else {
+            results.push_back(parse_create_machine_result(item.result()));
+        }
+    }
+
+    return results;
+}
+
+tempo_utils::Result<chord_sandbox::internal::SignEndpointsResult>
+chord_sandbox::internal::sign_endpoints(
+    const absl::flat_hash_map<tempo_utils::Url,std::string> &endpointCsrs,
+    std::shared_ptr<chord_common::AbstractCertificateSigner> certificateSigner,
+    absl::Duration requestedValidityPeriod)
+{
+    SignEndpointsResult result;
+
+    // sign the csr for each endpoint
+    for (const auto &entry : endpointCsrs) {
+        std::string pemCertificateBytes;
+        TU_ASSIGN_OR_RETURN (pemCertificateBytes, certificateSigner->signEndpoint(
+            entry.first, entry.second, requestedValidityPeriod));
+
+        std::shared_ptr<tempo_security::X509Certificate> cert;
+        TU_ASSIGN_OR_RETURN (cert, tempo_security::X509Certificate::fromString(pemCertificateBytes));
+        result.endpointNameOverrides[entry.first] = cert->getCommonName();
+        result.endpointCertificates[entry.first] = std::move(pemCertificateBytes);
+    }
+
+    return result;
+}
+
+/**
+ * Build the RunMachine request which passes the signed certificates to a single machine.
+ */
+static void
+build_run_machine_request(
+    const tempo_utils::Url &machineUrl,
+    const chord_sandbox::internal::SignEndpointsResult &signEndpointsResult,
+    chord_invoke::RunMachineRequest &runMachineRequest)
+{
+    // set the machine uri returned from CreateMachine
+    runMachineRequest.set_machine_url(machineUrl.toString());
+
+    // add the signed certificate for each endpoint
+    for (const auto &entry : signEndpointsResult.endpointCertificates) {
+        auto *signedEndpoint = runMachineRequest.add_signed_endpoints();
+        signedEndpoint->set_endpoint_url(entry.first.toString());
+        signedEndpoint->set_certificate(entry.second);
+    }
+}
+
+/**
+ * Ensure the machine bound every endpoint which was signed.
+ */
+static tempo_utils::Status
+check_bound_endpoints(
+    const chord_invoke::RunMachineRequest &runMachineRequest,
+    const chord_invoke::RunMachineResult &runMachineResult)
+{
+    // build set of bound endpoint urls
+    absl::flat_hash_set<std::string> boundEndpoints;
+    for (const auto &boundEndpoint : runMachineResult.bound_endpoints()) {
+        boundEndpoints.insert(boundEndpoint.endpoint_url());
+    }
+
+    // ensure every endpoint is bound
+    for (const auto &signedEndpoint : runMachineRequest.signed_endpoints()) {
+        if (!boundEndpoints.contains(signedEndpoint.endpoint_url()))
+            return chord_sandbox::SandboxStatus::forCondition(chord_sandbox::SandboxCondition::kAgentError,
+                "RunMachine failed: endpoint {} was not bound", signedEndpoint.endpoint_url());
+    }
+
+    return {};
+}
+
+chord_sandbox::internal::RunMachineCall::RunMachineCall(
+    const tempo_utils::Url &machineUrl,
+    const SignEndpointsResult &signEndpointsResult)
+    : m_machineUrl(machineUrl),
+      m_started(false)
+{
+    TU_ASSERT (m_machineUrl.isValid());
+
+    build_run_machine_request(m_machineUrl, signEndpointsResult, m_request);
+}
+
+chord_sandbox::internal::RunMachineCall::~RunMachineCall()
+{
+    // the callback references this call, so wait for it before the call is freed
+    if (m_started && !m_done.HasBeenNotified()) {
+        m_context.TryCancel();
+        m_done.WaitForNotification();
+    }
+}
+
+void
+chord_sandbox::internal::RunMachineCall::start(chord_invoke::InvokeService::StubInterface *stub)
+{
+    TU_ASSERT (stub != nullptr);
+    TU_ASSERT (!m_started);
+    m_started = true;
+    stub->async()->RunMachine(&m_context, &m_request, &m_result, [this](grpc::Status status) {
+        m_status = std::move(status);
+        m_done.Notify();
+    });
+}
+
+tempo_utils::Status
+chord_sandbox::internal::RunMachineCall::wait()
+{
+    m_done.WaitForNotification();
+
+    if (!m_status.ok())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "RunMachine failed: {}", m_status.error_message());
+
+    TU_LOG_INFO << "started machine " << m_machineUrl;
+
+    return check_bound_endpoints(m_request, m_result);
+}
+
+chord_sandbox::internal::RunMachineBatchCall::RunMachineBatchCall()
+    : m_started(false)
+{
+}
+
+chord_sandbox::internal::RunMachineBatchCall::~RunMachineBatchCall()
+{
+    // the callback references this call, so wait for it before the call is freed
+    if (m_started && !m_done.HasBeenNotified()) {
+        m_context.TryCancel();
+        m_done.WaitForNotification();
+    }
+}
+
+/**
+ * Add a machine to the batch. Machines must be added before the call is started.
+ *
+ * @return The index of the machine in the batch.
+ */
+int
+chord_sandbox::internal::RunMachineBatchCall::addMachine(
+    const tempo_utils::Url &machineUrl,
+    const SignEndpointsResult &signEndpointsResult)
+{
+    TU_ASSERT (machineUrl.isValid());
+    TU_ASSERT (!m_started);
+    build_run_machine_request(machineUrl, signEndpointsResult, *m_request.add_machines());
+    return m_request.machines_size() - 1;
+}
+
+int
+chord_sandbox::internal::RunMachineBatchCall::numMachines() const
+{
+    return m_request.machines_size();
+}
+
+void
+chord_sandbox::internal::RunMachineBatchCall::start(chord_invoke::InvokeService::StubInterface *stub)
+{
+    TU_ASSERT (stub != nullptr);
+    TU_ASSERT (!m_started);
+    m_started = true;
+    stub->async()->RunMachineBatch(&m_context, &m_request, &m_result, [this](grpc::Status status) {
+        m_status = std::move(status);
+        m_done.Notify();
+    });
+}
+
+/**
+ * Wait for the RunMachineBatch call to complete.
+ *
+ * @return The status for each machine in the order the machines were added, or error status if
+ *     the call failed.
+ */
+tempo_utils::Result<std::vector<tempo_utils::Status>>
+chord_sandbox::internal::RunMachineBatchCall::wait()
+{
+    m_done.WaitForNotification();
+
+    if (!m_status.ok())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "RunMachineBatch failed: {}", m_status.error_message());
+    if (m_result.machines_size() != m_request.machines_size())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "RunMachineBatch failed: expected {} results but received {}",
+            m_request.machines_size(), m_result.machines_size());
+
+    std::vector<tempo_utils::Status> statuses;
+    for (int i = 0; i < m_result.machines_size(); i++) {
+        const auto &item = m_result.machines(i);
+        const auto &runMachineRequest = m_request.machines(i);
+        if (item.status_code() != grpc::StatusCode::OK) {
+            statuses.push_back(SandboxStatus::forCondition(SandboxCondition::kAgentError,
+                "RunMachine failed: {}", item.status_message()));
+            continue;
+        }
+        TU_LOG_INFO << "started machine " << runMachineRequest.machine_url();
+        statuses.push_back(check_bound_endpoints(runMachineRequest, item.result()));
+    }
+
+    return statuses;
+}
+
+tempo_utils::Result<std::unique_ptr<chord_sandbox::internal::RunMachineCall>>
+chord_sandbox::internal::start_run_machine(
+    chord_invoke::InvokeService::StubInterface *stub,
+    const tempo_utils::Url &machineUrl,
+    const SignEndpointsResult &signEndpointsResult)
+{
+    auto call = std::make_unique<RunMachineCall>(machineUrl, signEndpointsResult);
+    call->start(stub);
+    return call;
+}
+
 tempo_utils::Result<chord_sandbox::internal::RunMachineResult>
 chord_sandbox::internal::run_machine(
         chord_invoke::InvokeService::StubInterface *stub,
@@ -124,20 +408,15 @@ chord_sandbox::internal::run_machine(
     runMachineRequest.set_machine_url(machineUrl.toString());
 
     // sign the csr for each endpoint
-    for (const auto &entry : endpointCsrs) {
-
+    SignEndpointsResult signEndpointsResult;
+    TU_ASSIGN_OR_RETURN (signEndpointsResult, sign_endpoints(
+        endpointCsrs, certificateSigner, requestedValidityPeriod));
+    for (const auto &entry : signEndpointsResult.endpointCertificates) {
         auto *signedEndpoint = runMachineRequest.add_signed_endpoints();
         signedEndpoint->set_endpoint_url(entry.first.toString());
-
-        std::string pemCertificateBytes;
-        TU_ASSIGN_OR_RETURN (pemCertificateBytes, certificateSigner->signEndpoint(
-            entry.first, entry.second, requestedValidityPeriod));
-        signedEndpoint->set_certificate(pemCertificateBytes);
-
-        std::shared_ptr<tempo_security::X509Certificate> cert;
-        TU_ASSIGN_OR_RETURN (cert, tempo_security::X509Certificate::fromString(pemCertificateBytes));
-        result.endpointNameOverrides[entry.first] = cert->getCommonName();
+        signedEndpoint->set_certificate(entry.second);
     }
+    result.endpointNameOverrides = std::move(signEndpointsResult.endpointNameOverrides);
 
     // call RunMachine on the sandbox-agent
     auto status = stub->RunMachine(&runMachineContext, runMachineRequest, &runMachineResult);
@@ -162,4 +441,4 @@ chord_sandbox::internal::run_machine(
     }
 
     return result;
-}
\ No newline at end of file
+}
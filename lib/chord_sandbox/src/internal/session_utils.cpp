@@ -1,7 +1,18 @@
 
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <numbers>
 
 #include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
 
 #include <chord_sandbox/internal/session_utils.h>
 #include <tempo_security/ecc_private_key_generator.h>
@@ -110,6 +121,20 @@ chord_sandbox::internal::spawn_session(
     auto pidFile = sessionDirectory / "pid";
     builder.appendArg("--pid-file", pidFile.c_str());
 
+    // create the ready fifo and open the read end before spawning, so the agent can report
+    // readiness as soon as it is listening. if the fifo can't be created then fall back to
+    // polling for the endpoint file.
+    auto readyFifo = sessionDirectory / "ready";
+    int readyFd = -1;
+    if (mkfifo(readyFifo.c_str(), 0600) == 0) {
+        readyFd = open(readyFifo.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    }
+    if (readyFd >= 0) {
+        builder.appendArg("--ready-fifo", readyFifo.c_str());
+    } else {
+        TU_LOG_WARN << "failed to create ready fifo " << readyFifo << ", polling for endpoint";
+    }
+
     auto idleTimeoutInSeconds = absl::ToInt64Seconds(idleTimeout);
     if (idleTimeoutInSeconds > 0) {
         builder.appendArg("--idle-timeout", absl::StrCat(idleTimeoutInSeconds));
@@ -123,11 +148,33 @@ chord_sandbox::internal::spawn_session(
     auto invoker = builder.toInvoker();
     TU_LOG_INFO << "invoking " << invoker.toString();
 
+    auto spawnTime = absl::Now();
     spawnSessionResult.process = std::make_shared<tempo_utils::ProcessRunner>(invoker, sessionDirectory);
-    TU_RETURN_IF_NOT_OK (spawnSessionResult.process->getStatus());
+    auto status = spawnSessionResult.process->getStatus();
+
+    if (readyFd < 0) {
+        TU_RETURN_IF_NOT_OK (status);
+        TU_ASSIGN_OR_RETURN (spawnSessionResult.endpoint, load_session_endpoint(
+            sessionDirectory, absl::Seconds(15)));
+        spawnSessionResult.startupLatency = absl::Now() - spawnTime;
+    } else {
+        std::error_code ec;
+        if (status.notOk()) {
+            close(readyFd);
+            std::filesystem::remove(readyFifo, ec);
+            return status;
+        }
+        auto readinessResult = wait_for_session_readiness(readyFd, absl::Seconds(15));
+        close(readyFd);
+        std::filesystem::remove(readyFifo, ec);
+        SessionReadiness readiness;
+        TU_ASSIGN_OR_RETURN (readiness, readinessResult);
+        spawnSessionResult.endpoint = readiness.endpoint;
+        spawnSessionResult.startupLatency = readiness.readyTime - spawnTime;
+    }
 
-    TU_ASSIGN_OR_RETURN (spawnSessionResult.endpoint, load_session_endpoint(
-        sessionDirectory, absl::Seconds(15)));
+    TU_LOG_INFO << "agent " << sessionName << " became ready after "
+        << absl::FormatDuration(spawnSessionResult.startupLatency);
 
     return spawnSessionResult;
 }
@@ -160,6 +207,72 @@ chord_sandbox::internal::load_session(const std::filesystem::path &sessionDirect
     return loadSessionResult;
 }
 
+tempo_utils::Result<chord_sandbox::internal::SessionReadiness>
+chord_sandbox::internal::parse_session_readiness(std::string_view report)
+{
+    std::vector<std::string_view> lines = absl::StrSplit(absl::StripSuffix(report, "\n"), '\n');
+    if (lines.size() != 3)
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "invalid readiness report from agent");
+
+    SessionReadiness readiness;
+    readiness.endpoint = chord_common::TransportLocation::fromString(lines.at(0));
+    if (!readiness.endpoint.isValid())
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "invalid endpoint '{}' in readiness report", lines.at(0));
+    readiness.serverName = std::string(lines.at(1));
+
+    tu_int64 readyMicros;
+    if (!absl::SimpleAtoi(lines.at(2), &readyMicros))
+        return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+            "invalid ready time '{}' in readiness report", lines.at(2));
+    readiness.readyTime = absl::FromUnixMicros(readyMicros);
+
+    return readiness;
+}
+
+tempo_utils::Result<chord_sandbox::internal::SessionReadiness>
+chord_sandbox::internal::wait_for_session_readiness(int readyFd, absl::Duration timeout)
+{
+    auto deadline = absl::Now() + timeout;
+    std::string report;
+    char buf[PIPE_BUF];
+
+    // the report is complete once the third line is terminated
+    while (std::count(report.begin(), report.end(), '\n') < 3) {
+        auto millisRemaining = absl::ToInt64Milliseconds(deadline - absl::Now());
+        if (millisRemaining <= 0)
+            return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+                "timed out waiting for agent to become ready");
+
+        struct pollfd pfd = {readyFd, POLLIN, 0};
+        auto ret = poll(&pfd, 1, static_cast<int>(millisRemaining));
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return SandboxStatus::forCondition(SandboxCondition::kSandboxInvariant,
+                "failed to poll ready fifo: {}", strerror(errno));
+        }
+        if (ret == 0)
+            continue;
+
+        auto nread = read(readyFd, buf, sizeof(buf));
+        if (nread < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            return SandboxStatus::forCondition(SandboxCondition::kSandboxInvariant,
+                "failed to read ready fifo: {}", strerror(errno));
+        }
+        // the agent closed the fifo without sending a complete report
+        if (nread == 0)
+            return SandboxStatus::forCondition(SandboxCondition::kAgentError,
+                "agent exited before becoming ready");
+        report.append(buf, nread);
+    }
+
+    return parse_session_readiness(report);
+}
+
 tempo_utils::Result<chord_common::TransportLocation>
 chord_sandbox::internal::load_session_endpoint(const std::filesystem::path &sessionDirectory, absl::Duration timeout)
 {
@@ -167,6 +280,14 @@ chord_sandbox::internal::load_session_endpoint(const std::filesystem::path &sess
     int iteration = 1;
     tempo_utils::Status status;
 
+    // the endpoint file may already exist, so check before sleeping
+    tempo_utils::FileReader initialReader(sessionDirectory / "endpoint");
+    if (initialReader.isValid()) {
+        auto endpointBytes = initialReader.getBytes();
+        auto endpoint = std::string_view((const char *) endpointBytes->getData(), endpointBytes->getSize());
+        return chord_common::TransportLocation::fromString(endpoint);
+    }
+
     do {
         auto sleepMillis = absl::Milliseconds(iteration * 10 * std::numbers::e);
         absl::SleepFor(sleepMillis);
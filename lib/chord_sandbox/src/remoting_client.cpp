@@ -1,4 +1,5 @@
 
+#include <absl/strings/numbers.h>
 #include <grpcpp/create_channel.h>
 
 #include <chord_sandbox/remoting_client.h>
@@ -66,7 +67,9 @@ chord_sandbox::ClientCommunicationStream::ClientCommunicationStream(
       m_handler(handler),
       m_freeWhenDone(freeWhenDone),
       m_head(nullptr),
-      m_tail(nullptr)
+      m_tail(nullptr),
+      m_writing(false),
+      m_credit(0)
 {
     TU_ASSERT (stub != nullptr);
     TU_ASSERT (m_protocolUrl.isValid());
@@ -105,7 +108,10 @@ chord_sandbox::ClientCommunicationStream::OnReadDone(bool ok)
         TU_LOG_VV << "read failed";
         return;
     }
-    m_handler->handle(m_incoming.data());
+    // messages which only carry credit are not passed to the handler
+    if (!receiveCredit(m_incoming) || !m_incoming.data().empty()) {
+        m_handler->handle(m_incoming.data());
+    }
     m_incoming.Clear();
     StartRead(&m_incoming);
 }
@@ -121,9 +127,53 @@ chord_sandbox::ClientCommunicationStream::OnWriteDone(bool ok)
     auto *pending = m_head->next;
     delete m_head;
     m_head = pending;
-    if (pending) {
-        StartWrite(&pending->message);
+    if (m_head == nullptr) {
+        m_tail = nullptr;
+    }
+    m_writing = false;
+    startNextWrite();
+}
+
+bool
+chord_sandbox::ClientCommunicationStream::receiveCredit(const chord_remoting::Message &message)
+{
+    // apply any credit granted in the message headers, and resume writing if stalled on credit
+    tu_uint32 credit = 0;
+    bool hasCredit = false;
+    for (const auto &header : message.headers()) {
+        if (header.name() != chord_common::kProtocolCreditHeader)
+            continue;
+        tu_uint32 value;
+        if (!absl::SimpleAtoi(header.value(), &value)) {
+            TU_LOG_WARN << "ignoring invalid credit '" << header.value() << "'";
+            continue;
+        }
+        credit += value;
+        hasCredit = true;
+    }
+    if (!hasCredit)
+        return false;
+
+    absl::MutexLock locker(&m_lock);
+    m_credit += credit;
+    if (!m_writing) {
+        startNextWrite();
     }
+    return true;
+}
+
+void
+chord_sandbox::ClientCommunicationStream::startNextWrite()
+{
+    if (m_head == nullptr)
+        return;
+    // wait until the server has granted credit, the stream starts without credit so nothing is
+    // sent before the first grant
+    if (m_credit == 0)
+        return;
+    m_credit--;
+    m_writing = true;
+    StartWrite(&m_head->message);
 }
 
 void
@@ -150,13 +200,15 @@ chord_sandbox::ClientCommunicationStream::write(std::string_view message)
     if (m_head == nullptr) {
         m_head = pending;
         m_tail = pending;
-        // if no messages are pending then start the write
-        StartWrite(&pending->message);
     } else {
-        // otherwise just enqueue the pending message
         m_tail->next = pending;
         m_tail = pending;
     }
 
+    // if no write is in flight then start the write, otherwise the message stays queued
+    if (!m_writing) {
+        startNextWrite();
+    }
+
     return {};
 }
\ No newline at end of file
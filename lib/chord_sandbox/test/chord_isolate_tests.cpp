@@ -1,4 +1,6 @@
+#include <absl/synchronization/notification.h>
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
 #include <chord_sandbox/chord_isolate.h>
 #include <chord_test/chord_sandbox_tester.h>
@@ -11,6 +13,7 @@
 #include <tempo_utils/tempdir_maker.h>
 
 #include "chord_sandbox/local_certificate_signer.h"
+#include "chord_sandbox/run_protocol_plug.h"
 
 class ChordIsolate : public ::testing::Test {
 protected:
@@ -81,3 +84,79 @@ TEST_F(ChordIsolate, SpawnRemoteMachine)
     ASSERT_THAT (result, tempo_test::ContainsResult(
         RunMachine(tempo_utils::StatusCode::kOk)));
 }
+
+static chord_sandbox::RequestedPortAndHandler
+make_plug(std::string_view protocolUrl, std::shared_ptr<chord_common::AbstractProtocolHandler> handler)
+{
+    chord_common::RequestedPort requestedPort(tempo_utils::Url::fromString(protocolUrl),
+        chord_common::PortType::Streaming, chord_common::PortDirection::BiDirectional);
+    return {requestedPort, std::move(handler)};
+}
+
+TEST_F(ChordIsolate, LaunchBatchFailsEachInvalidRequestIndependently)
+{
+    auto testerDirectory = tempdir->getTempdir();
+
+    auto spawnIsolateResult = chord_sandbox::ChordIsolate::spawn(
+        "test", testerDirectory, agentPath, pemRootCABundleFile, certificateSigner,
+        idleTimeout, registrationTimeout);
+    ASSERT_THAT (spawnIsolateResult, tempo_test::IsResult());
+    auto isolate = spawnIsolateResult.getResult();
+
+    auto handler = std::make_shared<chord_sandbox::RunProtocolPlug>(nullptr, nullptr);
+    auto mainLocation = tempo_utils::Url::fromString("/main");
+
+    // the first request has a plug without a handler, the second requests the same port twice
+    std::vector<chord_sandbox::LaunchRequest> requests(2);
+    requests[0].name = "m0";
+    requests[0].mainLocation = mainLocation;
+    requests[0].plugs.push_back(make_plug(chord_sandbox::kRunProtocolUri, nullptr));
+    requests[1].name = "m1";
+    requests[1].mainLocation = mainLocation;
+    requests[1].plugs.push_back(make_plug(chord_sandbox::kRunProtocolUri, handler));
+    requests[1].plugs.push_back(make_plug(chord_sandbox::kRunProtocolUri, handler));
+
+    auto results = isolate->launchBatch(requests, 2);
+    ASSERT_EQ (2, results.size());
+    ASSERT_TRUE (results[0].isStatus());
+    ASSERT_THAT (results[0].getStatus().toString(), ::testing::HasSubstr("invalid handler"));
+    ASSERT_TRUE (results[1].isStatus());
+    ASSERT_THAT (results[1].getStatus().toString(), ::testing::HasSubstr("already specified"));
+
+    ASSERT_THAT (isolate->shutdown(), tempo_test::IsOk());
+}
+
+TEST_F(ChordIsolate, LaunchAsyncDeliversResultToCallback)
+{
+    auto testerDirectory = tempdir->getTempdir();
+
+    auto spawnIsolateResult = chord_sandbox::ChordIsolate::spawn(
+        "test", testerDirectory, agentPath, pemRootCABundleFile, certificateSigner,
+        idleTimeout, registrationTimeout);
+    ASSERT_THAT (spawnIsolateResult, tempo_test::IsResult());
+    auto isolate = spawnIsolateResult.getResult();
+
+    chord_sandbox::LaunchRequest request;
+    request.name = "m0";
+    request.mainLocation = tempo_utils::Url::fromString("/main");
+    request.plugs.push_back(make_plug(chord_sandbox::kRunProtocolUri, nullptr));
+
+    absl::Notification done;
+    tempo_utils::Status launchStatus;
+    ASSERT_THAT (isolate->launchAsync(std::move(request), [&](chord_sandbox::LaunchResult result) {
+        if (result.isStatus()) {
+            launchStatus = result.getStatus();
+        }
+        done.Notify();
+    }), tempo_test::IsOk());
+
+    ASSERT_TRUE (done.WaitForNotificationWithTimeout(absl::Seconds(30)));
+    ASSERT_THAT (launchStatus.toString(), ::testing::HasSubstr("invalid handler"));
+
+    // launches are rejected once the isolate has shut down
+    ASSERT_THAT (isolate->shutdown(), tempo_test::IsOk());
+    chord_sandbox::LaunchRequest rejected;
+    rejected.name = "m1";
+    rejected.mainLocation = tempo_utils::Url::fromString("/main");
+    ASSERT_TRUE (isolate->launchAsync(std::move(rejected), [](chord_sandbox::LaunchResult) {}).notOk());
+}
@@ -1,3 +1,6 @@
+#include <thread>
+
+#include <absl/synchronization/mutex.h>
 #include <absl/synchronization/notification.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -11,6 +14,7 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/client_callback.h>
 
+#include <chord_common/abstract_protocol_writer.h>
 #include <chord_remoting/remoting_service_mock.grpc.pb.h>
 #include <chord_sandbox/chord_isolate.h>
 #include <chord_sandbox/remoting_client.h>
@@ -98,6 +102,16 @@ EchoRemotingService::Communicate(
 {
     TU_LOG_INFO << "starting Communicate";
     stream->SendInitialMetadata();
+
+    // grant credit for the single message which is echoed
+    chord_remoting::Message grant;
+    grant.set_version(chord_remoting::MessageVersion::Version1);
+    auto *header = grant.add_headers();
+    header->set_name(chord_common::kProtocolCreditHeader);
+    header->set_value("1");
+    if (!stream->Write(grant))
+        return grpc::Status(grpc::StatusCode::INTERNAL, "write failure");
+
     chord_remoting::Message message;
     if (!stream->Read(&message))
         return grpc::Status(grpc::StatusCode::INTERNAL, "read failure");
@@ -107,6 +121,126 @@ EchoRemotingService::Communicate(
     return grpc::Status::OK;
 }
 
+/**
+ * Service which behaves like a port socket with a bounded receive queue. The client is granted
+ * credit for the queue size, and messages are "delivered" periodically from a separate thread,
+ * which returns their credit. Messages received without credit are counted as dropped.
+ */
+class CreditRemotingService : public chord_remoting::RemotingService::Service {
+public:
+    CreditRemotingService(tu_uint32 queueSize, tu_uint32 expected);
+    grpc::Status Communicate(
+        grpc::ServerContext *context,
+        grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message> *stream) override;
+    bool waitForCompletion();
+    tu_uint32 getReceived();
+    tu_uint32 getDropped();
+
+private:
+    tu_uint32 m_queueSize;
+    tu_uint32 m_expected;
+    absl::Mutex m_lock;
+    tu_uint32 m_credit = 0;
+    tu_uint32 m_queued = 0;
+    tu_uint32 m_received = 0;
+    tu_uint32 m_dropped = 0;
+    bool m_done = false;
+    absl::Notification m_completed;
+};
+
+CreditRemotingService::CreditRemotingService(tu_uint32 queueSize, tu_uint32 expected)
+    : m_queueSize(queueSize),
+      m_expected(expected)
+{
+}
+
+static bool
+write_credit(
+    grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message> *stream,
+    tu_uint32 credit)
+{
+    chord_remoting::Message grant;
+    grant.set_version(chord_remoting::MessageVersion::Version1);
+    auto *header = grant.add_headers();
+    header->set_name(chord_common::kProtocolCreditHeader);
+    header->set_value(absl::StrCat(credit));
+    return stream->Write(grant);
+}
+
+grpc::Status
+CreditRemotingService::Communicate(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<chord_remoting::Message, chord_remoting::Message>* stream)
+{
+    stream->SendInitialMetadata();
+    {
+        absl::MutexLock locker(&m_lock);
+        m_credit = m_queueSize;
+    }
+    if (!write_credit(stream, m_queueSize))
+        return grpc::Status(grpc::StatusCode::INTERNAL, "write failure");
+
+    // deliver queued messages and return their credit, well after the messages were received
+    std::thread deliverer([this, stream]() {
+        for (;;) {
+            absl::SleepFor(absl::Milliseconds(20));
+            tu_uint32 delivered;
+            {
+                absl::MutexLock locker(&m_lock);
+                if (m_done)
+                    return;
+                delivered = m_queued;
+                m_queued = 0;
+                m_credit += delivered;
+            }
+            if (delivered > 0 && !write_credit(stream, delivered))
+                return;
+        }
+    });
+
+    chord_remoting::Message message;
+    while (stream->Read(&message)) {
+        absl::MutexLock locker(&m_lock);
+        m_received++;
+        if (m_credit == 0) {
+            m_dropped++;
+        } else {
+            m_credit--;
+            m_queued++;
+        }
+        if (m_received == m_expected)
+            break;
+    }
+
+    {
+        absl::MutexLock locker(&m_lock);
+        m_done = true;
+    }
+    deliverer.join();
+    m_completed.Notify();
+    return grpc::Status::OK;
+}
+
+bool
+CreditRemotingService::waitForCompletion()
+{
+    return m_completed.WaitForNotificationWithTimeout(absl::Milliseconds(5000));
+}
+
+tu_uint32
+CreditRemotingService::getReceived()
+{
+    absl::MutexLock locker(&m_lock);
+    return m_received;
+}
+
+tu_uint32
+CreditRemotingService::getDropped()
+{
+    absl::MutexLock locker(&m_lock);
+    return m_dropped;
+}
+
 class ClientCommunicationStream : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -150,4 +284,38 @@ TEST_F(ClientCommunicationStream, SendAndReceiveMessage)
     ASSERT_EQ ("hello world", message);
     ASSERT_THAT (handler->detach(), tempo_test::IsOk());
     stub.reset();
-}
\ No newline at end of file
+}
+TEST(ClientCommunicationStreamFlowControl, WritesBeforeFirstGrantAreNotDropped)
+{
+    auto sockpath = tempo_utils::generate_name("sock.XXXXXXXX");
+    auto endpoint = absl::StrCat("unix:", sockpath.string());
+
+    // send three times the queue size immediately after the stream is started
+    CreditRemotingService service(4, 12);
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(endpoint, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+
+    auto channel = grpc::CreateChannel(endpoint, grpc::InsecureChannelCredentials());
+    auto stub = chord_remoting::RemotingService::NewStub(channel);
+
+    auto protocolUrl = tempo_utils::Url::fromString("dev.zuri.proto:null");
+    auto handler = std::make_shared<EchoHandler>();
+    {
+        chord_sandbox::ClientCommunicationStream stream(stub.get(), protocolUrl, handler, false);
+        for (int i = 0; i < 12; i++) {
+            ASSERT_THAT (handler->send(absl::StrCat("message ", i)), tempo_test::IsOk());
+        }
+
+        ASSERT_TRUE (service.waitForCompletion());
+        ASSERT_EQ (12u, service.getReceived());
+        ASSERT_EQ (0u, service.getDropped());
+        ASSERT_THAT (handler->detach(), tempo_test::IsOk());
+    }
+
+    server->Shutdown();
+    if (exists(sockpath)) {
+        TU_ASSERT (remove(sockpath));
+    }
+}
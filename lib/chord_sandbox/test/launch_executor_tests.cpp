@@ -0,0 +1,99 @@
+#include <atomic>
+#include <thread>
+
+#include <absl/synchronization/blocking_counter.h>
+#include <absl/synchronization/notification.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chord_sandbox/internal/launch_executor.h>
+#include <tempo_test/tempo_test.h>
+
+TEST(LaunchExecutor, SubmittedTasksRunOnWorkers)
+{
+    chord_sandbox::internal::LaunchExecutor executor(4);
+
+    absl::BlockingCounter remaining(10);
+    std::atomic<int> numOk(0);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_THAT (executor.submit([&](tempo_utils::Status status) {
+            if (status.isOk()) {
+                numOk++;
+            }
+            remaining.DecrementCount();
+        }), tempo_test::IsOk());
+    }
+
+    remaining.Wait();
+    ASSERT_EQ (10, numOk.load());
+}
+
+TEST(LaunchExecutor, RunBoundedNeverExceedsMaxConcurrency)
+{
+    chord_sandbox::internal::LaunchExecutor executor(8);
+
+    std::atomic<int> active(0);
+    std::atomic<int> maxActive(0);
+    std::vector<std::atomic<int>> visited(32);
+    executor.runBounded(visited.size(), 3, [&](size_t index) {
+        auto curr = ++active;
+        auto prev = maxActive.load();
+        while (prev < curr && !maxActive.compare_exchange_weak(prev, curr)) {}
+        absl::SleepFor(absl::Milliseconds(2));
+        visited[index]++;
+        active--;
+    });
+
+    ASSERT_LE (maxActive.load(), 3);
+    for (const auto &count : visited) {
+        ASSERT_EQ (1, count.load());
+    }
+}
+
+TEST(LaunchExecutor, RunBoundedCompletesWhenEveryWorkerIsBusy)
+{
+    chord_sandbox::internal::LaunchExecutor executor(1);
+
+    absl::Notification started;
+    absl::Notification release;
+    ASSERT_THAT (executor.submit([&](tempo_utils::Status status) {
+        started.Notify();
+        release.WaitForNotification();
+    }), tempo_test::IsOk());
+    started.WaitForNotification();
+
+    // the only worker is busy, so the calling thread runs every item
+    std::atomic<int> numItems(0);
+    executor.runBounded(4, 4, [&](size_t index) { numItems++; });
+    ASSERT_EQ (4, numItems.load());
+
+    release.Notify();
+}
+
+TEST(LaunchExecutor, ShutdownFailsTasksWhichNeverStarted)
+{
+    chord_sandbox::internal::LaunchExecutor executor(1);
+
+    absl::Notification started;
+    absl::Notification release;
+    ASSERT_THAT (executor.submit([&](tempo_utils::Status status) {
+        started.Notify();
+        release.WaitForNotification();
+    }), tempo_test::IsOk());
+    started.WaitForNotification();
+
+    tempo_utils::Status pendingStatus;
+    ASSERT_THAT (executor.submit([&](tempo_utils::Status status) {
+        pendingStatus = status;
+    }), tempo_test::IsOk());
+
+    // shutdown waits for the running task, so release it once the executor is stopping
+    std::thread stopper([&]() { executor.shutdown(); });
+    while (executor.submit([](tempo_utils::Status) {}).isOk()) {
+        absl::SleepFor(absl::Milliseconds(1));
+    }
+    release.Notify();
+    stopper.join();
+
+    ASSERT_TRUE (pendingStatus.notOk());
+}
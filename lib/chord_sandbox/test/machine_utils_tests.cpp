@@ -152,4 +152,51 @@ TEST(MachineUtils, RunMachineSucceeds)
         options, {}, caKeyPair.getPemCertificateFile()));
 
     ASSERT_THAT (x509Store->verifyCertificate(certificate), tempo_test::IsOk());
-}
\ No newline at end of file
+}
+TEST(MachineUtils, CreateMachineBatchReturnsResultForEachMachine)
+{
+    auto executionUrl = tempo_utils::Url::fromString("/module");
+
+    std::vector<chord_sandbox::internal::CreateMachineParams> batch(2);
+    batch[0].name = "foo";
+    batch[0].executionUrl = executionUrl;
+    batch[1].name = "bar";
+    batch[1].executionUrl = executionUrl;
+
+    chord_invoke::MockInvokeServiceStub stub;
+    chord_invoke::CreateMachineBatchRequest createMachineBatchRequest;
+    chord_invoke::CreateMachineBatchResult createMachineBatchResult;
+
+    auto *fooItem = createMachineBatchResult.add_machines();
+    fooItem->set_status_code(grpc::StatusCode::OK);
+    fooItem->mutable_result()->set_machine_url("dev.zuri.machine:foo");
+    fooItem->mutable_result()->set_control_endpoint_index(0);
+    auto *controlEndpoint = fooItem->mutable_result()->add_declared_endpoints();
+    controlEndpoint->set_endpoint_url("unix:/path/to/sock");
+    controlEndpoint->set_csr("pem certificate");
+    auto *barItem = createMachineBatchResult.add_machines();
+    barItem->set_status_code(grpc::StatusCode::ABORTED);
+    barItem->set_status_message("failed to spawn bar");
+
+    EXPECT_CALL(stub, CreateMachineBatch(_,_,_))
+        .Times(1)
+        .WillOnce(DoAll(
+            SaveArg<1>(&createMachineBatchRequest),
+            SetArgPointee<2>(createMachineBatchResult),
+            Return(grpc::Status::OK)));
+
+    std::vector<tempo_utils::Result<chord_sandbox::internal::CreateMachineResult>> results;
+    TU_ASSIGN_OR_RAISE (results, chord_sandbox::internal::create_machine_batch(&stub, batch));
+
+    ASSERT_EQ (2, createMachineBatchRequest.machines_size());
+    ASSERT_EQ ("foo", createMachineBatchRequest.machines(0).name());
+    ASSERT_EQ ("bar", createMachineBatchRequest.machines(1).name());
+    ASSERT_FALSE (createMachineBatchRequest.machines(0).start_suspended());
+
+    ASSERT_EQ (2, results.size());
+    ASSERT_THAT (results[0], tempo_test::IsResult());
+    auto fooResult = results[0].getResult();
+    ASSERT_EQ (tempo_utils::Url::fromString("dev.zuri.machine:foo"), fooResult.machineUrl);
+    ASSERT_EQ (tempo_utils::Url::fromString("unix:/path/to/sock"), fooResult.controlUrl);
+    ASSERT_TRUE (results[1].isStatus());
+}
@@ -1,7 +1,10 @@
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <chord_sandbox/internal/session_utils.h>
+#include <tempo_test/tempo_test.h>
 
 TEST(SpawnUtils, SpawnTemporaryAgent)
 {
@@ -34,4 +37,46 @@ TEST(SpawnUtils, SpawnTemporaryAgent)
     // ASSERT_EQ (runDirectory, process->getRunDirectory());
     // ASSERT_EQ (childOutput, process->getChildOutput());
     // ASSERT_EQ (exitStatus, process->getExitStatus());
-}
\ No newline at end of file
+}
+
+TEST(SpawnUtils, ParseSessionReadiness)
+{
+    auto endpoint = chord_common::TransportLocation::forUnix("agent.chord.alt", "/run/agent.sock");
+    auto report = absl::StrCat(endpoint.toString(), "\n", "agent.chord.alt", "\n", 1700000000000000, "\n");
+
+    auto parseReadinessResult = chord_sandbox::internal::parse_session_readiness(report);
+    ASSERT_THAT (parseReadinessResult, tempo_test::IsResult());
+    auto readiness = parseReadinessResult.getResult();
+    ASSERT_EQ (endpoint, readiness.endpoint);
+    ASSERT_EQ ("agent.chord.alt", readiness.serverName);
+    ASSERT_EQ (absl::FromUnixMicros(1700000000000000), readiness.readyTime);
+
+    ASSERT_TRUE (chord_sandbox::internal::parse_session_readiness("invalid\n").isStatus());
+}
+
+TEST(SpawnUtils, WaitForSessionReadinessReturnsWhenReportIsWritten)
+{
+    int fds[2];
+    ASSERT_EQ (0, pipe(fds));
+
+    auto endpoint = chord_common::TransportLocation::forUnix("agent.chord.alt", "/run/agent.sock");
+    auto report = absl::StrCat(endpoint.toString(), "\n", "agent.chord.alt", "\n", absl::ToUnixMicros(absl::Now()), "\n");
+    ASSERT_EQ (report.size(), static_cast<size_t>(write(fds[1], report.data(), report.size())));
+    close(fds[1]);
+
+    auto waitResult = chord_sandbox::internal::wait_for_session_readiness(fds[0], absl::Seconds(5));
+    close(fds[0]);
+    ASSERT_THAT (waitResult, tempo_test::IsResult());
+    ASSERT_EQ (endpoint, waitResult.getResult().endpoint);
+}
+
+TEST(SpawnUtils, WaitForSessionReadinessFailsWhenAgentExits)
+{
+    int fds[2];
+    ASSERT_EQ (0, pipe(fds));
+    close(fds[1]);
+
+    auto waitResult = chord_sandbox::internal::wait_for_session_readiness(fds[0], absl::Seconds(5));
+    close(fds[0]);
+    ASSERT_TRUE (waitResult.isStatus());
+}
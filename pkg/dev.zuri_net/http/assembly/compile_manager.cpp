@@ -13,6 +13,61 @@
 
 #include "compile_manager.h"
 
+/**
+ * Declare a Manager method which makes a request and returns a Future[Response]. If entityType
+ * is valid then the method takes the request entity and its content type after the url.
+ */
+static tempo_utils::Status
+declare_request_method(
+    lyric_compiler::ModuleEntry &moduleEntry,
+    lyric_assembler::ClassSymbol *ManagerClass,
+    const std::string &methodName,
+    NetHttpTrap trap,
+    const lyric_common::TypeDef &UrlType,
+    const lyric_common::TypeDef &entityType,
+    const lyric_common::TypeDef &contentTypeType,
+    const lyric_common::TypeDef &FutureOfResponseType)
+{
+    auto *symbolCache = moduleEntry.getState()->symbolCache();
+
+    lyric_assembler::CallSymbol *callSymbol;
+    TU_ASSIGN_OR_RETURN (callSymbol, ManagerClass->declareMethod(
+        methodName, lyric_object::AccessType::Public));
+    lyric_assembler::PackBuilder packBuilder;
+    TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("url", "", UrlType, false));
+    if (entityType.isValid()) {
+        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("entity", "", entityType, false));
+        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("contentType", "", contentTypeType, false));
+    }
+    lyric_assembler::ParameterPack parameterPack;
+    TU_ASSIGN_OR_RETURN (parameterPack, packBuilder.toParameterPack());
+    lyric_assembler::ProcHandle *procHandle;
+    TU_ASSIGN_OR_RETURN (procHandle, callSymbol->defineCall(parameterPack, FutureOfResponseType));
+    auto *codeBuilder = procHandle->procCode();
+
+    // construct the future and assign it to a local
+    moduleEntry.compileBlock(R"(
+        val fut: Future[Response] = Future[Response]{}
+    )", procHandle->procBlock());
+
+    // push fut onto the top of the stack
+    lyric_assembler::DataReference var;
+    TU_ASSIGN_OR_RETURN (var, procHandle->procBlock()->resolveReference("fut"));
+    auto *sym = symbolCache->getOrImportSymbol(var.symbolUrl).orElseThrow();
+    TU_ASSERT (sym != nullptr);
+    TU_ASSERT (sym->getSymbolType() == lyric_assembler::SymbolType::LOCAL);
+    auto *fut = cast_symbol_to_local(sym);
+    codeBuilder->loadLocal(fut->getOffset());
+
+    // call trap
+    codeBuilder->trap(static_cast<tu_uint32>(trap));
+
+    // fut is still on the stack, return it
+    codeBuilder->writeOpcode(lyric_object::Opcode::OP_RETURN);
+
+    return {};
+}
+
 tempo_utils::Status
 build_net_http_Manager(
     lyric_compiler::ModuleEntry &moduleEntry,
@@ -47,7 +102,10 @@ build_net_http_Manager(
     auto *ManagerClass = cast_symbol_to_class(
         symbolCache->getOrImportSymbol(declareManagerClassResult.getResult()).orElseThrow());
 
+    auto IntType = fundamentalCache->getFundamentalType(lyric_assembler::FundamentalSymbol::Int);
     auto UrlType = fundamentalCache->getFundamentalType(lyric_assembler::FundamentalSymbol::Url);
+    auto BytesType = fundamentalCache->getFundamentalType(lyric_assembler::FundamentalSymbol::Bytes);
+    auto StringType = fundamentalCache->getFundamentalType(lyric_assembler::FundamentalSymbol::String);
     auto ResponseType = lyric_common::TypeDef::forConcrete(lyric_common::SymbolUrl::fromString("#Response"));
 
     lyric_assembler::TypeHandle *futureOfResponseHandle;
@@ -68,35 +126,30 @@ build_net_http_Manager(
     {
         lyric_assembler::CallSymbol *callSymbol;
         TU_ASSIGN_OR_RETURN (callSymbol, ManagerClass->declareMethod(
-            "Get", lyric_object::AccessType::Public));
+            "SetConnectionLimits", lyric_object::AccessType::Public));
         lyric_assembler::PackBuilder packBuilder;
-        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("url", "", UrlType, false));
+        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("maxHostConnections", "", IntType, false));
+        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("maxTotalConnections", "", IntType, false));
         lyric_assembler::ParameterPack parameterPack;
         TU_ASSIGN_OR_RETURN (parameterPack, packBuilder.toParameterPack());
         lyric_assembler::ProcHandle *procHandle;
-        TU_ASSIGN_OR_RETURN (procHandle, callSymbol->defineCall(parameterPack, FutureOfResponseType));
+        TU_ASSIGN_OR_RETURN (procHandle, callSymbol->defineCall(parameterPack, lyric_common::TypeDef::noReturn()));
         auto *codeBuilder = procHandle->procCode();
-
-        // construct the future and assign it to a local
-        moduleEntry.compileBlock(R"(
-            val fut: Future[Response] = Future[Response]{}
-        )", procHandle->procBlock());
-
-        // push fut onto the top of the stack
-        lyric_assembler::DataReference var;
-        TU_ASSIGN_OR_RETURN (var, procHandle->procBlock()->resolveReference("fut"));
-        auto *sym = symbolCache->getOrImportSymbol(var.symbolUrl).orElseThrow();
-        TU_ASSERT (sym != nullptr);
-        TU_ASSERT (sym->getSymbolType() == lyric_assembler::SymbolType::LOCAL);
-        auto *fut = cast_symbol_to_local(sym);
-        codeBuilder->loadLocal(fut->getOffset());
-
-        // call trap
-        codeBuilder->trap(static_cast<tu_uint32>(NetHttpTrap::MANAGER_GET));
-
-        // fut is still on the stack, return it
+        codeBuilder->trap(static_cast<tu_uint32>(NetHttpTrap::MANAGER_SET_CONNECTION_LIMITS));
         codeBuilder->writeOpcode(lyric_object::Opcode::OP_RETURN);
     }
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Get",
+        NetHttpTrap::MANAGER_GET, UrlType, {}, {}, FutureOfResponseType));
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Head",
+        NetHttpTrap::MANAGER_HEAD, UrlType, {}, {}, FutureOfResponseType));
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Delete",
+        NetHttpTrap::MANAGER_DELETE, UrlType, {}, {}, FutureOfResponseType));
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Post",
+        NetHttpTrap::MANAGER_POST, UrlType, BytesType, StringType, FutureOfResponseType));
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Put",
+        NetHttpTrap::MANAGER_PUT, UrlType, BytesType, StringType, FutureOfResponseType));
+    TU_RETURN_IF_NOT_OK (declare_request_method(moduleEntry, ManagerClass, "Patch",
+        NetHttpTrap::MANAGER_PATCH, UrlType, BytesType, StringType, FutureOfResponseType));
 
     return {};
 }
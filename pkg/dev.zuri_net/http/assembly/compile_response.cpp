@@ -29,6 +29,7 @@ build_net_http_Response(
         defstruct Response {
             val StatusCode: Int
             val Entity: String = ""
+            val headers: String = ""
         }
     )", block));
 
@@ -39,6 +40,7 @@ build_net_http_Response(
         lyric_assembler::PackBuilder packBuilder;
         packBuilder.appendListParameter("code", "", IntType, false);
         packBuilder.appendListParameter("entity", "", StringType, false);
+        packBuilder.appendListParameter("headers", "", StringType, false);
         lyric_assembler::ParameterPack parameterPack;
         TU_ASSIGN_OR_RETURN (parameterPack, packBuilder.toParameterPack());
         lyric_assembler::ProcHandle *procHandle;
@@ -55,9 +57,27 @@ build_net_http_Response(
         TU_RETURN_IF_NOT_OK (ctorReifier.reifyNextArgument(IntType));
         TU_RETURN_IF_NOT_OK (codeBuilder->loadArgument(lyric_assembler::ArgumentOffset(1)));
         TU_RETURN_IF_NOT_OK (ctorReifier.reifyNextArgument(StringType));
+        TU_RETURN_IF_NOT_OK (codeBuilder->loadArgument(lyric_assembler::ArgumentOffset(2)));
+        TU_RETURN_IF_NOT_OK (ctorReifier.reifyNextArgument(StringType));
         TU_RETURN_IF_STATUS (invoker.invokeNew(createBlock, ctorReifier, 0));
         codeBuilder->writeOpcode(lyric_object::Opcode::OP_RETURN);
     }
+    {
+        // the header block is parsed by the trap when a header is requested, so responses whose
+        // headers are never read are not parsed at all
+        lyric_assembler::CallSymbol *callSymbol;
+        TU_ASSIGN_OR_RETURN (callSymbol, ResponseStruct->declareMethod(
+            "Header", lyric_object::AccessType::Public));
+        lyric_assembler::PackBuilder packBuilder;
+        TU_RETURN_IF_NOT_OK (packBuilder.appendListParameter("name", "", StringType, false));
+        lyric_assembler::ParameterPack parameterPack;
+        TU_ASSIGN_OR_RETURN (parameterPack, packBuilder.toParameterPack());
+        lyric_assembler::ProcHandle *procHandle;
+        TU_ASSIGN_OR_RETURN (procHandle, callSymbol->defineCall(parameterPack, StringType));
+        auto *codeBuilder = procHandle->procCode();
+        codeBuilder->trap(static_cast<tu_uint32>(NetHttpTrap::RESPONSE_HEADER));
+        codeBuilder->writeOpcode(lyric_object::Opcode::OP_RETURN);
+    }
 
     return {};
 }
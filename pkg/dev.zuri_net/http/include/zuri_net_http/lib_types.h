@@ -6,7 +6,14 @@
 enum class NetHttpTrap : uint32_t {
     MANAGER_ALLOC,
     MANAGER_CTOR,
+    MANAGER_SET_CONNECTION_LIMITS,
     MANAGER_GET,
+    MANAGER_HEAD,
+    MANAGER_DELETE,
+    MANAGER_POST,
+    MANAGER_PUT,
+    MANAGER_PATCH,
+    RESPONSE_HEADER,
     LAST_,
 };
 
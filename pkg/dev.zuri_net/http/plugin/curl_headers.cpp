@@ -209,5 +209,16 @@ CurlHeaders::fromString(std::string_view bytes)
         curr = line;
     }
 
+    // add the last header
+    if (!curr.empty()) {
+        int index = curr.find_first_of(':');
+        if (index == std::string::npos)
+            return lyric_runtime::InterpreterStatus::forCondition(
+                lyric_runtime::InterpreterCondition::kRuntimeInvariant, "invalid header");
+        auto name = normalize_header_name(curr.substr(0, index));
+        auto value = normalize_header_value(curr.substr(index + 1));
+        headers.emplace(name, value);
+    }
+
     return CurlHeaders(headers);
 }
@@ -1,6 +1,29 @@
 
+#include <algorithm>
+#include <cstring>
+
 #include "curl_utils.h"
 
+const char *
+http_method_to_string(HttpMethod method)
+{
+    switch (method) {
+        case HttpMethod::Get:
+            return "GET";
+        case HttpMethod::Head:
+            return "HEAD";
+        case HttpMethod::Post:
+            return "POST";
+        case HttpMethod::Put:
+            return "PUT";
+        case HttpMethod::Patch:
+            return "PATCH";
+        case HttpMethod::Delete:
+            return "DELETE";
+    }
+    TU_UNREACHABLE();
+}
+
 /**
  * when signaled by curl this callback gets invoked as soon as it has received header data.
  * the header callback is called once for each header and only complete header lines are passed
@@ -23,6 +46,55 @@ headers_write_cb(char *buffer, size_t size, size_t nmemb, void *_request)
     return realsize;
 }
 
+/**
+ * when signaled by curl this callback copies the next part of the request entity into the
+ * upload buffer. the entity is read directly from the Bytes instance which was passed to the
+ * request, so no intermediate copy of the entity is made.
+ *
+ * @param buffer
+ * @param size
+ * @param nitems
+ * @param _request
+ * @return
+ */
+size_t
+entity_read_cb(char *buffer, size_t size, size_t nitems, void *_request)
+{
+    Request *request = (Request *) _request;
+    TU_ASSERT (request->requestEntity != nullptr);
+
+    size_t entitySize = request->requestEntity->getBytesSize();
+    size_t count = std::min(size * nitems, entitySize - request->requestOffset);
+    if (count > 0) {
+        memcpy(buffer, request->requestEntity->getBytesData() + request->requestOffset, count);
+        request->requestOffset += count;
+    }
+    TU_LOG_INFO << "sent entity data (" << (int) count << " bytes)";
+    return count;
+}
+
+/**
+ * when signaled by curl this callback rewinds the request entity, which is necessary when the
+ * request is resent, for example after a redirect or when a reused connection was closed by
+ * the server.
+ *
+ * @param _request
+ * @param offset
+ * @param origin
+ * @return
+ */
+int
+entity_seek_cb(void *_request, curl_off_t offset, int origin)
+{
+    Request *request = (Request *) _request;
+    TU_ASSERT (request->requestEntity != nullptr);
+
+    if (origin != SEEK_SET || offset < 0 || offset > request->requestEntity->getBytesSize())
+        return CURL_SEEKFUNC_CANTSEEK;
+    request->requestOffset = offset;
+    return CURL_SEEKFUNC_OK;
+}
+
 /**
  * when signaled by curl this callback gets called as soon as there is data received that
  * needs to be saved.
@@ -44,6 +116,50 @@ entity_write_cb(char *buffer, size_t size, size_t nmemb, void *_request)
     return realsize;
 }
 
+/**
+ * take an easy handle from the idle pool of the manager, or create a new easy handle if the pool
+ * is empty. new handles are attached to the share handle of the manager so that every request
+ * uses the same DNS, TLS session and connection caches.
+ *
+ * @param priv
+ * @return the easy handle, or nullptr if a new handle could not be created.
+ */
+CURL *
+acquire_easy_handle(ManagerPrivate *priv)
+{
+    if (!priv->idle.empty()) {
+        auto *easy = priv->idle.back();
+        priv->idle.pop_back();
+        return easy;
+    }
+
+    auto *easy = curl_easy_init();
+    if (easy == nullptr)
+        return nullptr;
+    curl_easy_setopt(easy, CURLOPT_SHARE, priv->share);
+    return easy;
+}
+
+/**
+ * return an easy handle which is no longer attached to the multi handle to the idle pool of the
+ * manager. the handle options are reset so an idle handle holds no references to the completed
+ * request, while the share handle and any live connections are kept. if the pool is full then
+ * the handle is cleaned up instead.
+ *
+ * @param priv
+ * @param easy
+ */
+void
+release_easy_handle(ManagerPrivate *priv, CURL *easy)
+{
+    if (priv->idle.size() >= kMaxIdleEasyHandles) {
+        curl_easy_cleanup(easy);
+        return;
+    }
+    curl_easy_reset(easy);
+    priv->idle.push_back(easy);
+}
+
 static void
 remove_completed(ManagerPrivate *priv)
 {
@@ -59,14 +175,20 @@ remove_completed(ManagerPrivate *priv)
             request->curlCode = msg->data.result;
             if (request->curlCode == CURLE_OK) {
                 curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &request->responseCode);
-                uv_async_send(request->notifyCompleted);
             } else {
                 TU_LOG_V << "curl easy handle failure: " << curl_easy_strerror(request->curlCode);
-                uv_async_send(request->notifyCompleted);
             }
 
+            // msg is not valid after the handle is removed, so the result must be read first.
+            // once the request is no longer inflight its entity does not need to be reachable.
             curl_multi_remove_handle(priv->multi, easy);
-            curl_easy_cleanup(easy);
+            priv->inflight.erase(request->id);
+            curl_slist_free_all(request->requestHeaders);
+            request->requestHeaders = nullptr;
+            request->easy = nullptr;
+            release_easy_handle(priv, easy);
+
+            uv_async_send(request->notifyCompleted);
         }
     }
 }
@@ -6,6 +6,9 @@
 #include <curl/curl.h>
 #include <uv.h>
 
+#include <vector>
+
+#include <lyric_runtime/bytes_ref.h>
 #include <lyric_runtime/data_cell.h>
 #include <tempo_utils/bytes_appender.h>
 #include <tempo_utils/immutable_bytes.h>
@@ -17,12 +20,25 @@
 class ManagerRef;
 struct ManagerPrivate;
 
+enum class HttpMethod {
+    Get,
+    Head,
+    Post,
+    Put,
+    Patch,
+    Delete,
+};
+
+const char *http_method_to_string(HttpMethod method);
+
 struct Request {
     CURL *easy;
     tempo_utils::UUID id;
+    HttpMethod method;
     tempo_utils::Url url;
     curl_slist *requestHeaders;
-    std::shared_ptr<tempo_utils::ImmutableBytes> requestEntity;
+    lyric_runtime::BytesRef *requestEntity;
+    size_t requestOffset;
     uv_async_t *notifyCompleted;
     CURLcode curlCode;
     long responseCode;
@@ -31,10 +47,24 @@ struct Request {
     ManagerPrivate *priv;
 };
 
+/**
+ * the maximum number of idle easy handles kept by a manager for reuse.
+ */
+constexpr std::size_t kMaxIdleEasyHandles = 16;
+
+/**
+ * the default limit on concurrent connections to a single host. the total number of connections
+ * is not limited by default.
+ */
+constexpr long kDefaultMaxHostConnections = 6;
+constexpr long kDefaultMaxTotalConnections = 0;
+
 struct ManagerPrivate {
     CURLM *multi;
+    CURLSH *share;
     uv_loop_t *loop;
     uv_timer_t timer;
+    std::vector<CURL *> idle;
     absl::flat_hash_map<tempo_utils::UUID, Request *> inflight;
     ManagerRef *manager;
     PluginData *pluginData;
@@ -50,8 +80,16 @@ struct SocketPrivate {
 
 size_t headers_write_cb(char *buffer, size_t size, size_t nmemb, void *_request);
 
+size_t entity_read_cb(char *buffer, size_t size, size_t nitems, void *_request);
+
+int entity_seek_cb(void *_request, curl_off_t offset, int origin);
+
 size_t entity_write_cb(char *buffer, size_t size, size_t nmemb, void *_request);
 
+CURL *acquire_easy_handle(ManagerPrivate *priv);
+
+void release_easy_handle(ManagerPrivate *priv, CURL *easy);
+
 int update_timeout_cb(CURLM *multi, long timeoutMs, void *_priv);
 
 int socket_notify_cb(CURL *easy, curl_socket_t socket, int action, void *_priv, void *_sock);
@@ -24,12 +24,24 @@ ManagerRef::ManagerRef(
     // initialize private data
     m_priv.multi = curl_multi_init();
 
+    // share the DNS, TLS session and connection caches between all requests made by the manager,
+    // so repeated requests to the same host reuse warm connections. the share handle is only used
+    // from the uv loop thread so no lock callbacks are required.
+    m_priv.share = curl_share_init();
+    curl_share_setopt(m_priv.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_priv.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(m_priv.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
     // set curl callbacks
     curl_multi_setopt(m_priv.multi, CURLMOPT_SOCKETFUNCTION, socket_notify_cb);
     curl_multi_setopt(m_priv.multi, CURLMOPT_SOCKETDATA, &m_priv);
     curl_multi_setopt(m_priv.multi, CURLMOPT_TIMERFUNCTION, update_timeout_cb);
     curl_multi_setopt(m_priv.multi, CURLMOPT_TIMERDATA, &m_priv);
 
+    // set default connection limits
+    curl_multi_setopt(m_priv.multi, CURLMOPT_MAX_HOST_CONNECTIONS, kDefaultMaxHostConnections);
+    curl_multi_setopt(m_priv.multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, kDefaultMaxTotalConnections);
+
     uv_timer_init(m_priv.loop, &m_priv.timer);
     m_priv.timer.data = &m_priv;
 
@@ -66,22 +78,85 @@ ManagerRef::finalize()
 //    uv_close((uv_handle_t *) &m_priv.notifyPending, nullptr);
     uv_close((uv_handle_t *) &m_priv.timer, nullptr);
 
-    // FIXME: cleanup inflight requests
+    // detach and clean up the easy handles of inflight requests. the requests themselves are
+    // owned by their promises and are freed when the promise is released.
+    for (auto &entry : m_priv.inflight) {
+        auto *request = entry.second;
+        curl_multi_remove_handle(m_priv.multi, request->easy);
+        curl_easy_cleanup(request->easy);
+        request->easy = nullptr;
+        curl_slist_free_all(request->requestHeaders);
+        request->requestHeaders = nullptr;
+        request->requestEntity = nullptr;
+    }
+    m_priv.inflight.clear();
+
     curl_multi_cleanup(m_priv.multi);
 
+    // the share handle can only be cleaned up once no easy handle is attached to it
+    for (auto *easy : m_priv.idle) {
+        curl_easy_cleanup(easy);
+    }
+    m_priv.idle.clear();
+    auto shcode = curl_share_cleanup(m_priv.share);
+    if (shcode != CURLSHE_OK) {
+        TU_LOG_ERROR << "curl_share_cleanup failed: " << curl_share_strerror(shcode);
+    }
+
 //    for (auto &request : m_priv.pending) {
 //        delete request;
 //    }
 }
 
+/**
+ * Set the connection limits of the manager. Requests which would exceed a limit are queued by
+ * curl until a connection becomes available.
+ *
+ * @param maxHostConnections The maximum number of connections to a single host, or 0 for no limit.
+ * @param maxTotalConnections The maximum number of connections in total, or 0 for no limit.
+ * @return Ok status if the limits were set, otherwise a status describing the failure.
+ */
+tempo_utils::Status
+ManagerRef::setConnectionLimits(long maxHostConnections, long maxTotalConnections)
+{
+    if (maxHostConnections < 0 || maxTotalConnections < 0)
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kRuntimeInvariant,
+            "invalid connection limits; limits must not be negative");
+
+    auto curlcode = curl_multi_setopt(m_priv.multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxHostConnections);
+    if (curlcode == CURLM_OK) {
+        curlcode = curl_multi_setopt(m_priv.multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, maxTotalConnections);
+    }
+    if (curlcode != CURLM_OK)
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kRuntimeInvariant,
+            "failed to set connection limits: {}", curl_multi_strerror(curlcode));
+
+    return {};
+}
+
 void
 ManagerRef::setMembersReachable()
 {
+    // request entities are read directly from the Bytes instance while the request is inflight
+    for (auto &entry : m_priv.inflight) {
+        auto *request = entry.second;
+        if (request->requestEntity != nullptr) {
+            request->requestEntity->setReachable();
+        }
+    }
 }
 
 void
 ManagerRef::clearMembersReachable()
 {
+    for (auto &entry : m_priv.inflight) {
+        auto *request = entry.second;
+        if (request->requestEntity != nullptr) {
+            request->requestEntity->clearReachable();
+        }
+    }
 }
 
 static void
@@ -89,13 +164,6 @@ on_async_complete(lyric_runtime::Promise *promise)
 {
     auto *request = static_cast<Request *>(promise->getData());
     TU_LOG_INFO << "request " << request->id.toString() << " responded with status " << (int) request->responseCode;
-    auto headersBytes = request->responseHeaders.finish();
-    CurlHeaders headers;
-    TU_ASSIGN_OR_RAISE (headers, CurlHeaders::fromString(
-        std::string_view((const char *) headersBytes->getData(), headersBytes->getSize())));
-    for (auto it = headers.headersBegin(); it != headers.headersEnd(); it++) {
-        TU_LOG_INFO << "response header: " << it->first << " = " << it->second;
-    }
 }
 
 static void
@@ -115,11 +183,17 @@ on_resolve_response(
     auto entity = request->responseEntity.finish();
     auto entityView = std::string_view((const char *) entity->getData(), entity->getSize());
 
+    // the header block is passed to the Response unparsed, and is only parsed when a header is
+    // read using Response.Header
+    auto headers = request->responseHeaders.finish();
+    auto headersView = std::string_view((const char *) headers->getData(), headers->getSize());
+
     auto responseCreateDescriptor = request->priv->pluginData->responseCreateDescriptor;
 
     auto arg0 = lyric_runtime::DataCell((tu_int64) request->responseCode);
     auto arg1 = heapManager->allocateString(entityView);
-    std::vector<lyric_runtime::DataCell> args{arg0, arg1};
+    auto arg2 = heapManager->allocateString(headersView);
+    std::vector<lyric_runtime::DataCell> args{arg0, arg1, arg2};
 
     tempo_utils::Status status;
     if (!subroutineManager->callStatic(responseCreateDescriptor, args, currentCoro, status)) {
@@ -143,24 +217,78 @@ free_request(void *data)
     delete request;
 }
 
+/**
+ * Make an http request. The request is added to the curl multi handle immediately, and the
+ * returned promise is completed with a Response once the request has completed.
+ *
+ * @param state The interpreter state.
+ * @param method The request method.
+ * @param httpUrl The request url.
+ * @param requestHeaders The request headers.
+ * @param requestEntity The request entity, or nullptr if the request has no entity. The entity
+ *   is read in place and must stay reachable until the request completes.
+ * @return The promise, or a status describing the failure.
+ */
 tempo_utils::Result<std::shared_ptr<lyric_runtime::Promise>>
-ManagerRef::makeGetRequest(
+ManagerRef::makeRequest(
     lyric_runtime::InterpreterState *state,
+    HttpMethod method,
     const tempo_utils::Url &httpUrl,
-    const CurlHeaders &requestHeaders)
+    const CurlHeaders &requestHeaders,
+    lyric_runtime::BytesRef *requestEntity)
 {
+    // reuse an idle easy handle if one is available
+    auto *easy = acquire_easy_handle(&m_priv);
+    if (easy == nullptr)
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kRuntimeInvariant,
+            "failed to create http request: curl_easy_init failed");
+
     auto *request = new Request();
-    request->easy = curl_easy_init();
+    request->easy = easy;
     request->id = tempo_utils::UUID::randomUUID();
+    request->method = method;
     request->url = httpUrl;
     request->requestHeaders = nullptr;
+    request->requestEntity = requestEntity;
+    request->requestOffset = 0;
     request->priv = &m_priv;
 
     // set private pointer
     curl_easy_setopt(request->easy, CURLOPT_PRIVATE, request);
 
-    // set GET method
-    curl_easy_setopt(request->easy, CURLOPT_HTTPGET, 1L);
+    // set request method
+    switch (method) {
+        case HttpMethod::Get:
+            curl_easy_setopt(request->easy, CURLOPT_HTTPGET, 1L);
+            break;
+        case HttpMethod::Head:
+            curl_easy_setopt(request->easy, CURLOPT_NOBODY, 1L);
+            break;
+        case HttpMethod::Post:
+            break;
+        case HttpMethod::Put:
+        case HttpMethod::Patch:
+        case HttpMethod::Delete:
+            curl_easy_setopt(request->easy, CURLOPT_CUSTOMREQUEST, http_method_to_string(method));
+            break;
+    }
+
+    // set request entity if specified. the entity is sent using POST semantics for every method,
+    // with the method name overridden above, so curl sends a Content-Length header instead of
+    // chunking the entity.
+    if (requestEntity != nullptr) {
+        curl_easy_setopt(request->easy, CURLOPT_POST, 1L);
+        curl_easy_setopt(request->easy, CURLOPT_POSTFIELDSIZE_LARGE,
+            (curl_off_t) requestEntity->getBytesSize());
+        curl_easy_setopt(request->easy, CURLOPT_READFUNCTION, entity_read_cb);
+        curl_easy_setopt(request->easy, CURLOPT_READDATA, request);
+        curl_easy_setopt(request->easy, CURLOPT_SEEKFUNCTION, entity_seek_cb);
+        curl_easy_setopt(request->easy, CURLOPT_SEEKDATA, request);
+    } else if (method == HttpMethod::Post) {
+        curl_easy_setopt(request->easy, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) 0);
+        curl_easy_setopt(request->easy, CURLOPT_POSTFIELDS, "");
+    }
 
     // set curl callbacks
     curl_easy_setopt(request->easy, CURLOPT_HEADERFUNCTION, headers_write_cb);
@@ -185,13 +313,17 @@ ManagerRef::makeGetRequest(
     auto curlcode = curl_multi_add_handle(m_priv.multi, request->easy);
     if (curlcode != CURLM_OK) {
         TU_LOG_ERROR << "curl_multi_add_handle failed: " << curl_multi_strerror(curlcode);
-        curl_easy_cleanup(request->easy);
+        curl_slist_free_all(request->requestHeaders);
+        release_easy_handle(&m_priv, request->easy);
         delete request;
         return lyric_runtime::InterpreterStatus::forCondition(
             lyric_runtime::InterpreterCondition::kRuntimeInvariant,
             "failed to create http request: {}", curl_multi_strerror(curlcode));
     }
 
+    // track the request so its entity stays reachable while the request is inflight
+    m_priv.inflight[request->id] = request;
+
     // create the promise which will be resolved when the request completes
     lyric_runtime::PromiseOptions options;
     options.adapt = on_resolve_response;
@@ -203,7 +335,8 @@ ManagerRef::makeGetRequest(
     auto *scheduler = state->systemScheduler();
     scheduler->registerAsync(&request->notifyCompleted, promise);
 
-    TU_LOG_INFO << "GET " << httpUrl << " (request " << request->id.toString() << ")";
+    TU_LOG_INFO << http_method_to_string(method) << " " << httpUrl
+        << " (request " << request->id.toString() << ")";
 
     return promise;
 }
@@ -264,7 +397,7 @@ manager_ctor(
 }
 
 tempo_utils::Status
-manager_get(
+manager_set_connection_limits(
     lyric_runtime::BytecodeInterpreter *interp,
     lyric_runtime::InterpreterState *state)
 {
@@ -277,7 +410,36 @@ manager_get(
     auto *manager = static_cast<ManagerRef *>(receiver.data.ref);
     TU_ASSERT (manager != nullptr);
 
-    TU_ASSERT (frame.numArguments() == 1);
+    TU_ASSERT (frame.numArguments() == 2);
+    const auto &arg0 = frame.getArgument(0);
+    TU_ASSERT (arg0.type == lyric_runtime::DataCellType::I64);
+    const auto &arg1 = frame.getArgument(1);
+    TU_ASSERT (arg1.type == lyric_runtime::DataCellType::I64);
+
+    return manager->setConnectionLimits(arg0.data.i64, arg1.data.i64);
+}
+
+/**
+ * Shared implementation of the request traps. The url is the first argument, and if the method
+ * has an entity then the entity Bytes and the content type String are the second and third
+ * arguments. The Future which is returned to the caller is the first local.
+ */
+static tempo_utils::Status
+make_request(
+    HttpMethod method,
+    bool hasEntity,
+    lyric_runtime::InterpreterState *state)
+{
+    auto *currentCoro = state->currentCoro();
+
+    auto &frame = currentCoro->peekCall();
+
+    auto receiver = frame.getReceiver();
+    TU_ASSERT(receiver.type == lyric_runtime::DataCellType::REF);
+    auto *manager = static_cast<ManagerRef *>(receiver.data.ref);
+    TU_ASSERT (manager != nullptr);
+
+    TU_ASSERT (frame.numArguments() == (hasEntity? 3 : 1));
     const auto &arg0 = frame.getArgument(0);
     TU_ASSERT (arg0.type == lyric_runtime::DataCellType::URL);
 
@@ -292,9 +454,75 @@ manager_get(
             lyric_runtime::InterpreterCondition::kRuntimeInvariant, "failed to load http url");
     TU_ASSERT (httpUrl.isValid());
 
+    CurlHeaders requestHeaders;
+    lyric_runtime::BytesRef *requestEntity = nullptr;
+    if (hasEntity) {
+        const auto &arg1 = frame.getArgument(1);
+        TU_ASSERT (arg1.type == lyric_runtime::DataCellType::BYTES);
+        requestEntity = static_cast<lyric_runtime::BytesRef *>(arg1.data.ref);
+
+        const auto &arg2 = frame.getArgument(2);
+        TU_ASSERT (arg2.type == lyric_runtime::DataCellType::STRING);
+        std::string contentType;
+        if (!arg2.data.ref->utf8Value(contentType))
+            return lyric_runtime::InterpreterStatus::forCondition(
+                lyric_runtime::InterpreterCondition::kRuntimeInvariant, "failed to load content type");
+        if (!contentType.empty()) {
+            requestHeaders.setHeader("Content-Type", contentType);
+        }
+    }
+
     std::shared_ptr<lyric_runtime::Promise> promise;
-    TU_ASSIGN_OR_RETURN (promise, manager->makeGetRequest(state, httpUrl));
+    TU_ASSIGN_OR_RETURN (promise, manager->makeRequest(state, method, httpUrl, requestHeaders, requestEntity));
     fut->prepareFuture(promise);
 
     return lyric_runtime::InterpreterStatus::ok();
 }
+
+tempo_utils::Status
+manager_get(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Get, false, state);
+}
+
+tempo_utils::Status
+manager_head(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Head, false, state);
+}
+
+tempo_utils::Status
+manager_delete(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Delete, false, state);
+}
+
+tempo_utils::Status
+manager_post(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Post, true, state);
+}
+
+tempo_utils::Status
+manager_put(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Put, true, state);
+}
+
+tempo_utils::Status
+manager_patch(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    return make_request(HttpMethod::Patch, true, state);
+}
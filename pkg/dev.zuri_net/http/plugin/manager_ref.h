@@ -28,10 +28,14 @@ public:
     std::string toString() const override;
     void finalize() override;
 
-    tempo_utils::Result<std::shared_ptr<lyric_runtime::Promise>> makeGetRequest(
+    tempo_utils::Status setConnectionLimits(long maxHostConnections, long maxTotalConnections);
+
+    tempo_utils::Result<std::shared_ptr<lyric_runtime::Promise>> makeRequest(
         lyric_runtime::InterpreterState *state,
+        HttpMethod method,
         const tempo_utils::Url &httpUrl,
-        const CurlHeaders &requestHeaders = {});
+        const CurlHeaders &requestHeaders = {},
+        lyric_runtime::BytesRef *requestEntity = nullptr);
 
 protected:
     void setMembersReachable() override;
@@ -50,8 +54,32 @@ tempo_utils::Status manager_ctor(
     lyric_runtime::BytecodeInterpreter *interp,
     lyric_runtime::InterpreterState *state);
 
+tempo_utils::Status manager_set_connection_limits(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
 tempo_utils::Status manager_get(
     lyric_runtime::BytecodeInterpreter *interp,
     lyric_runtime::InterpreterState *state);
 
+tempo_utils::Status manager_head(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
+tempo_utils::Status manager_delete(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
+tempo_utils::Status manager_post(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
+tempo_utils::Status manager_put(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
+tempo_utils::Status manager_patch(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
 #endif // ZURI_NET_HTTP_MANAGER_REF_H
@@ -3,6 +3,7 @@
 
 #include "manager_ref.h"
 #include "plugin.h"
+#include "response_traps.h"
 
 lyric_runtime::NativeFunc
 NetHttpPlugin::getTrap(uint32_t index) const
@@ -15,8 +16,22 @@ NetHttpPlugin::getTrap(uint32_t index) const
             return manager_alloc;
         case NetHttpTrap::MANAGER_CTOR:
             return manager_ctor;
+        case NetHttpTrap::MANAGER_SET_CONNECTION_LIMITS:
+            return manager_set_connection_limits;
         case NetHttpTrap::MANAGER_GET:
             return manager_get;
+        case NetHttpTrap::MANAGER_HEAD:
+            return manager_head;
+        case NetHttpTrap::MANAGER_DELETE:
+            return manager_delete;
+        case NetHttpTrap::MANAGER_POST:
+            return manager_post;
+        case NetHttpTrap::MANAGER_PUT:
+            return manager_put;
+        case NetHttpTrap::MANAGER_PATCH:
+            return manager_patch;
+        case NetHttpTrap::RESPONSE_HEADER:
+            return response_header;
         case NetHttpTrap::LAST_:
             break;
     }
@@ -5,6 +5,7 @@
 
 struct PluginData {
     lyric_runtime::DataCell responseCreateDescriptor;
+    lyric_runtime::DataCell responseHeadersField;
 };
 
 class NetHttpPlugin : public lyric_runtime::NativeInterface {
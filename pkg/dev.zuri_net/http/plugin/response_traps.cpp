@@ -0,0 +1,93 @@
+
+#include <lyric_runtime/bytecode_interpreter.h>
+#include <lyric_runtime/interpreter_state.h>
+#include <tempo_utils/log_stream.h>
+
+#include "curl_headers.h"
+#include "plugin.h"
+#include "response_traps.h"
+
+static lyric_runtime::DataCell
+find_response_headers_field(
+    lyric_runtime::BytecodeSegment *segment,
+    lyric_runtime::SegmentManager *segmentManager)
+{
+    auto object = segment->getObject().getObject();
+    auto symbol = object.findSymbol(lyric_common::SymbolPath({"Response", "headers"}));
+    TU_ASSERT (symbol.isValid());
+
+    lyric_runtime::InterpreterStatus status;
+    auto descriptor = segmentManager->resolveDescriptor(segment,
+        symbol.getLinkageSection(), symbol.getLinkageIndex(), status);
+    TU_ASSERT (descriptor.type == lyric_runtime::DataCellType::FIELD);
+    return descriptor;
+}
+
+/**
+ * Returns the header block of the final response. When curl follows a redirect or receives an
+ * interim response such as 100 Continue, the header block of each response is appended in turn.
+ */
+static std::string_view
+final_response_headers(std::string_view headers)
+{
+    // ignore the empty line which terminates the final header block
+    auto end = headers.find_last_not_of("\r\n");
+    if (end == std::string_view::npos)
+        return headers;
+    auto index = headers.rfind("\nHTTP/", end);
+    if (index == std::string_view::npos)
+        return headers;
+    return headers.substr(index + 1);
+}
+
+/**
+ * Returns the first value of the named header, or the empty string if the response does not
+ * contain the header. The header block is parsed on each call, so responses whose headers are
+ * never read are never parsed.
+ */
+tempo_utils::Status
+response_header(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state)
+{
+    auto *currentCoro = state->currentCoro();
+
+    auto &frame = currentCoro->peekCall();
+
+    auto receiver = frame.getReceiver();
+    TU_ASSERT(receiver.type == lyric_runtime::DataCellType::REF);
+
+    TU_ASSERT (frame.numArguments() == 1);
+    const auto &arg0 = frame.getArgument(0);
+    TU_ASSERT (arg0.type == lyric_runtime::DataCellType::STRING);
+    std::string name;
+    if (!arg0.data.ref->utf8Value(name))
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kRuntimeInvariant, "failed to load header name");
+
+    auto *segmentManager = state->segmentManager();
+    auto *callSegment = segmentManager->getSegment(frame.getCallSegment());
+    auto *data = (PluginData *) callSegment->getData();
+    if (!data->responseHeadersField.isValid()) {
+        data->responseHeadersField = find_response_headers_field(callSegment, segmentManager);
+    }
+
+    auto headersCell = receiver.data.ref->getField(data->responseHeadersField);
+    TU_ASSERT (headersCell.type == lyric_runtime::DataCellType::STRING);
+    std::string headers;
+    if (!headersCell.data.ref->utf8Value(headers))
+        return lyric_runtime::InterpreterStatus::forCondition(
+            lyric_runtime::InterpreterCondition::kRuntimeInvariant, "failed to load response headers");
+
+    CurlHeaders responseHeaders;
+    TU_ASSIGN_OR_RETURN (responseHeaders, CurlHeaders::fromString(final_response_headers(headers)));
+
+    std::string value;
+    auto valueOption = responseHeaders.getFirstHeaderValue(name);
+    if (!valueOption.isEmpty()) {
+        value = valueOption.getValue();
+    }
+    currentCoro->pushData(state->heapManager()->allocateString(value));
+
+    return lyric_runtime::InterpreterStatus::ok();
+}
@@ -0,0 +1,11 @@
+#ifndef ZURI_NET_HTTP_RESPONSE_TRAPS_H
+#define ZURI_NET_HTTP_RESPONSE_TRAPS_H
+
+#include <lyric_runtime/bytecode_interpreter.h>
+#include <lyric_runtime/interpreter_state.h>
+
+tempo_utils::Status response_header(
+    lyric_runtime::BytecodeInterpreter *interp,
+    lyric_runtime::InterpreterState *state);
+
+#endif // ZURI_NET_HTTP_RESPONSE_TRAPS_H
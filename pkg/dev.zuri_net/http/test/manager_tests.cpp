@@ -1,3 +1,14 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_cat.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -6,6 +17,180 @@
 #include <tempo_test/tempo_test.h>
 #include <tempo_config/workspace_config.h>
 
+/**
+ * Minimal http server on the loopback interface which serves the specified number of requests,
+ * responding to each with a fixed response. Connections are kept open between requests unless
+ * the client closes them, so the number of accepted connections shows whether they were reused.
+ */
+class LoopbackServer {
+public:
+    std::vector<std::string> requestHeads;
+    std::vector<std::string> requestBodies;
+    int numConnections = 0;
+
+    explicit LoopbackServer(std::string_view response, int numRequests = 1)
+        : m_response(response),
+          m_numRequests(numRequests)
+    {
+        m_listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(m_listener, (sockaddr *) &addr, sizeof(addr));
+        listen(m_listener, 4);
+        socklen_t len = sizeof(addr);
+        getsockname(m_listener, (sockaddr *) &addr, &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this]() { serve(); });
+    }
+
+    ~LoopbackServer() {
+        stop();
+        close(m_listener);
+    }
+
+    std::string getUrl(std::string_view path) const {
+        return absl::StrCat("http://127.0.0.1:", m_port, path);
+    }
+
+    /**
+     * Wait for the requests to be served. If a connection is still expected then stop listening.
+     */
+    void stop() {
+        shutdown(m_listener, SHUT_RDWR);
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    std::string m_response;
+    int m_numRequests;
+    int m_listener;
+    int m_port;
+    std::thread m_thread;
+
+    void serve() {
+        while (requestHeads.size() < m_numRequests) {
+            int conn = accept(m_listener, nullptr, nullptr);
+            if (conn < 0)
+                return;
+            numConnections++;
+            std::string data;
+            while (requestHeads.size() < m_numRequests && readRequest(conn, data)) {
+                write(conn, m_response.data(), m_response.size());
+            }
+            close(conn);
+        }
+    }
+
+    bool readRequest(int conn, std::string &data) {
+        char buffer[4096];
+        size_t headEnd;
+        while ((headEnd = data.find("\r\n\r\n")) == std::string::npos) {
+            auto nread = read(conn, buffer, sizeof(buffer));
+            if (nread <= 0)
+                return false;
+            data.append(buffer, nread);
+        }
+
+        auto head = data.substr(0, headEnd);
+        size_t contentLength = 0;
+        auto lowerHead = absl::AsciiStrToLower(head);
+        auto index = lowerHead.find("\r\ncontent-length:");
+        if (index != std::string::npos) {
+            auto value = lowerHead.substr(index + 17, lowerHead.find("\r\n", index + 2) - index - 17);
+            absl::SimpleAtoi(absl::StripAsciiWhitespace(value), &contentLength);
+        }
+
+        auto bodyStart = headEnd + 4;
+        while (data.size() - bodyStart < contentLength) {
+            auto nread = read(conn, buffer, sizeof(buffer));
+            if (nread <= 0)
+                return false;
+            data.append(buffer, nread);
+        }
+
+        requestHeads.push_back(head);
+        requestBodies.push_back(data.substr(bodyStart, contentLength));
+        data.erase(0, bodyStart + contentLength);
+        return true;
+    }
+};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(m_listener, (sockaddr *) &addr, sizeof(addr));
+        listen(m_listener, 1);
+        socklen_t len = sizeof(addr);
+        getsockname(m_listener, (sockaddr *) &addr, &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this]() { serveOne(); });
+    }
+
+    ~LoopbackServer() {
+        stop();
+        close(m_listener);
+    }
+
+    std::string getUrl(std::string_view path) const {
+        return absl::StrCat("http://127.0.0.1:", m_port, path);
+    }
+
+    /**
+     * Wait for the request to be served. If no connection was accepted then stop listening.
+     */
+    void stop() {
+        shutdown(m_listener, SHUT_RDWR);
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    int m_listener;
+    int m_port;
+    std::string m_response;
+    std::thread m_thread;
+
+    void serveOne() {
+        int conn = accept(m_listener, nullptr, nullptr);
+        if (conn < 0)
+            return;
+        std::string data;
+        char buffer[4096];
+        size_t headEnd = std::string::npos;
+        size_t contentLength = 0;
+        for (;;) {
+            if (headEnd == std::string::npos) {
+                headEnd = data.find("\r\n\r\n");
+                if (headEnd != std::string::npos) {
+                    requestHead = data.substr(0, headEnd);
+                    auto lowerHead = absl::AsciiStrToLower(requestHead);
+                    auto index = lowerHead.find("\r\ncontent-length:");
+                    if (index != std::string::npos) {
+                        auto value = lowerHead.substr(index + 17, lowerHead.find("\r\n", index + 2) - index - 17);
+                        absl::SimpleAtoi(absl::StripAsciiWhitespace(value), &contentLength);
+                    }
+                    headEnd += 4;
+                }
+            }
+            if (headEnd != std::string::npos && data.size() - headEnd >= contentLength)
+                break;
+            auto nread = read(conn, buffer, sizeof(buffer));
+            if (nread <= 0)
+                break;
+            data.append(buffer, nread);
+        }
+        if (headEnd != std::string::npos) {
+            requestBody = data.substr(headEnd, contentLength);
+        }
+        write(conn, m_response.data(), m_response.size());
+        close(conn);
+    }
+};
+
 class NetHttpManager : public ::testing::Test {
 protected:
     lyric_test::TesterOptions testerOptions;
@@ -36,3 +221,86 @@ TEST_F(NetHttpManager, EvaluateGet)
 
     ASSERT_THAT (result, tempo_test::ContainsResult(RunModule(DataCellInt(200))));
 }
+
+TEST_F(NetHttpManager, EvaluateRepeatedGetReusesConnection)
+{
+    LoopbackServer server("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok", 2);
+
+    auto result = lyric_test::LyricTester::runSingleModule(absl::StrCat(R"(
+        import from "//std/system" ...
+        import from "//net/http" ...
+        val manager: Manager = Manager{}
+        manager.SetConnectionLimits(1, 1)
+        val fut1: Future[Response] = manager.Get(`)", server.getUrl("/first"), R"(`)
+        Await(fut1)
+        val fut2: Future[Response] = manager.Get(`)", server.getUrl("/second"), R"(`)
+        match Await(fut2) {
+            case resp: Response     resp.StatusCode
+            else                    nil
+        }
+    )"), testerOptions);
+    server.stop();
+
+    ASSERT_THAT (result, tempo_test::ContainsResult(RunModule(DataCellInt(200))));
+    ASSERT_EQ (2, server.requestHeads.size());
+    ASSERT_EQ (1, server.numConnections);
+}
+
+TEST_F(NetHttpManager, EvaluateHead)
+{
+    auto result = lyric_test::LyricTester::runSingleModule(R"(
+        import from "//std/system" ...
+        import from "//net/http" ...
+        val manager: Manager = Manager{}
+        val fut: Future[Response] = manager.Head(`http://neverssl.com/`)
+        match Await(fut) {
+            case resp: Response     resp.StatusCode
+            else                    nil
+        }
+    )", testerOptions);
+
+    ASSERT_THAT (result, tempo_test::ContainsResult(RunModule(DataCellInt(200))));
+}
+
+TEST_F(NetHttpManager, EvaluatePostSendsEntity)
+{
+    LoopbackServer server("HTTP/1.1 201 Created\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+
+    auto result = lyric_test::LyricTester::runSingleModule(absl::StrCat(R"(
+        import from "//std/system" ...
+        import from "//net/http" ...
+        val manager: Manager = Manager{}
+        val fut: Future[Response] = manager.Post(`)", server.getUrl("/items"), R"(`,
+            "hello, world".ToBytes(), "text/plain")
+        match Await(fut) {
+            case resp: Response     resp.StatusCode
+            else                    nil
+        }
+    )"), testerOptions);
+    server.stop();
+
+    ASSERT_THAT (result, tempo_test::ContainsResult(RunModule(DataCellInt(201))));
+    ASSERT_THAT (server.requestHeads.at(0), ::testing::StartsWith("POST /items HTTP/1.1\r\n"));
+    ASSERT_THAT (absl::AsciiStrToLower(server.requestHeads.at(0)), ::testing::HasSubstr("content-type: text/plain"));
+    ASSERT_EQ ("hello, world", server.requestBodies.at(0));
+}
+
+TEST_F(NetHttpManager, EvaluateResponseHeader)
+{
+    LoopbackServer server("HTTP/1.1 200 OK\r\nContent-Length: 0\r\nX-Request-Id: abc123\r\n"
+        "Connection: close\r\n\r\n");
+
+    auto result = lyric_test::LyricTester::runSingleModule(absl::StrCat(R"(
+        import from "//std/system" ...
+        import from "//net/http" ...
+        val manager: Manager = Manager{}
+        val fut: Future[Response] = manager.Get(`)", server.getUrl("/"), R"(`)
+        match Await(fut) {
+            case resp: Response     resp.Header("x-request-id")
+            else                    nil
+        }
+    )"), testerOptions);
+    server.stop();
+
+    ASSERT_THAT (result, tempo_test::ContainsResult(RunModule(DataCellString("abc123"))));
+}